@@ -0,0 +1,242 @@
+#include "admission_controller.h"
+#include <cstring>
+
+AdmissionController admissionController;
+
+namespace {
+
+uint8_t* allocateFrame(size_t size) {
+    return (uint8_t*)(psramFound() ? ps_malloc(size) : malloc(size));
+}
+
+const char* priorityName(int priority) {
+    return priority == PRIORITY_MANUAL ? "manual" : "auto";
+}
+
+} // namespace
+
+AdmissionController::AdmissionController() {
+    lock = nullptr;
+    for (int p = 0; p < PRIORITY_CLASSES; p++) {
+        buckets[p].tokens = burstSize(p);
+        buckets[p].lastRefill = 0;
+    }
+    queueCount = 0;
+    memset(queue, 0, sizeof(queue));
+    memset(stats, 0, sizeof(stats));
+}
+
+bool AdmissionController::begin() {
+    if (!lock) lock = xSemaphoreCreateMutex();
+    if (!lock) {
+        Serial.println("Failed to create admission lock");
+        return false;
+    }
+    return true;
+}
+
+unsigned long AdmissionController::tokenInterval(int priority) {
+    return priority == PRIORITY_MANUAL ? ADMISSION_MANUAL_INTERVAL : ADMISSION_AUTO_INTERVAL;
+}
+
+float AdmissionController::burstSize(int priority) {
+    return priority == PRIORITY_MANUAL ? ADMISSION_MANUAL_BURST : ADMISSION_AUTO_BURST;
+}
+
+void AdmissionController::refill(int priority, unsigned long now) {
+    TokenBucket& bucket = buckets[priority];
+    // A caller on another task may have read the clock just before the last refill
+    if ((long)(now - bucket.lastRefill) <= 0) return;
+    unsigned long elapsed = now - bucket.lastRefill;
+    bucket.lastRefill = now;
+    bucket.tokens = min(burstSize(priority), bucket.tokens + (float)elapsed / tokenInterval(priority));
+}
+
+void AdmissionController::removeQueued(int index) {
+    // Shift down to keep arrival order
+    for (int i = index; i < queueCount - 1; i++) queue[i] = queue[i + 1];
+    queueCount--;
+}
+
+// Frees the frame and pyramid of a request leaving the queue unserved
+void AdmissionController::dropQueued(int index) {
+    free(queue[index].imageData);
+    cameraManager.releasePyramid(queue[index].pyramid);
+    removeQueued(index);
+}
+
+void AdmissionController::expire(unsigned long now) {
+    for (int i = queueCount - 1; i >= 0; i--) {
+        if (now - queue[i].enqueued <= ADMISSION_MAX_WAIT) continue;
+        Serial.printf("Dropping %s request queued for %lu ms\n", priorityName(queue[i].priority), now - queue[i].enqueued);
+        stats[queue[i].priority].expired++;
+        dropQueued(i);
+    }
+}
+
+bool AdmissionController::admit(RequestPriority priority, unsigned long now) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool admitted = admitLocked(priority, now);
+    xSemaphoreGive(lock);
+    return admitted;
+}
+
+bool AdmissionController::admitLocked(RequestPriority priority, unsigned long now) {
+    for (int i = 0; i < queueCount; i++) {
+        if (queue[i].priority <= priority) return false;  // Would overtake a waiting request
+    }
+    refill(priority, now);
+    if (buckets[priority].tokens < 1) return false;
+    buckets[priority].tokens -= 1;
+    stats[priority].admitted++;
+    return true;
+}
+
+bool AdmissionController::hasToken(RequestPriority priority, unsigned long now) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    refill(priority, now);
+    bool ready = buckets[priority].tokens >= 1;
+    xSemaphoreGive(lock);
+    return ready;
+}
+
+AdmissionDecision AdmissionController::enqueue(RequestPriority priority, OperationMode mode, const uint8_t* imageData,
+                                               size_t imageSize, FramePyramid* pyramid, unsigned long now) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    AdmissionDecision decision = enqueueLocked(priority, mode, imageData, imageSize, pyramid, now);
+    xSemaphoreGive(lock);
+    return decision;
+}
+
+AdmissionDecision AdmissionController::enqueueLocked(RequestPriority priority, OperationMode mode,
+                                                     const uint8_t* imageData, size_t imageSize,
+                                                     FramePyramid* pyramid, unsigned long now) {
+    expire(now);
+    AdmissionStats& classStats = stats[priority];
+
+    // Same class and mode: the newer frame replaces the queued one, keeping its place
+    for (int i = 0; i < queueCount; i++) {
+        if (queue[i].priority != priority || queue[i].mode != mode) continue;
+        uint8_t* copy = allocateFrame(imageSize);
+        if (!copy) {
+            classStats.rejected++;
+            return ADMISSION_REJECTED;
+        }
+        memcpy(copy, imageData, imageSize);
+        free(queue[i].imageData);
+        cameraManager.releasePyramid(queue[i].pyramid);
+        queue[i].imageData = copy;
+        queue[i].imageSize = imageSize;
+        queue[i].pyramid = cameraManager.retainPyramid(pyramid);
+        classStats.coalesced++;
+        return ADMISSION_QUEUED;
+    }
+
+    if (queueCount == ADMISSION_QUEUE_DEPTH) {
+        // Full: push out the oldest request of the least urgent class below this one, if any
+        int victim = -1;
+        for (int i = 0; i < queueCount; i++) {
+            if (queue[i].priority > priority && (victim < 0 || queue[i].priority > queue[victim].priority)) {
+                victim = i;
+            }
+        }
+        if (victim < 0) {
+            classStats.rejected++;
+            return ADMISSION_REJECTED;
+        }
+        stats[queue[victim].priority].rejected++;
+        dropQueued(victim);
+    }
+
+    uint8_t* copy = allocateFrame(imageSize);
+    if (!copy) {
+        classStats.rejected++;
+        return ADMISSION_REJECTED;
+    }
+    memcpy(copy, imageData, imageSize);
+    QueuedRequest& request = queue[queueCount++];
+    request.imageData = copy;
+    request.imageSize = imageSize;
+    request.pyramid = cameraManager.retainPyramid(pyramid);
+    request.priority = priority;
+    request.mode = mode;
+    request.enqueued = now;
+    classStats.queued++;
+    return ADMISSION_QUEUED;
+}
+
+bool AdmissionController::next(unsigned long now, QueuedRequest* request) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool found = nextLocked(now, request);
+    xSemaphoreGive(lock);
+    return found;
+}
+
+bool AdmissionController::nextLocked(unsigned long now, QueuedRequest* request) {
+    expire(now);
+    for (int p = 0; p < PRIORITY_CLASSES; p++) {
+        // Oldest request of the class, if its bucket has a token
+        int index = -1;
+        for (int i = 0; i < queueCount && index < 0; i++) {
+            if (queue[i].priority == p) index = i;
+        }
+        if (index < 0) continue;
+        refill(p, now);
+        if (buckets[p].tokens < 1) continue;
+
+        buckets[p].tokens -= 1;
+        *request = queue[index];
+        removeQueued(index);
+        unsigned long wait = now - request->enqueued;
+        AdmissionStats& classStats = stats[p];
+        classStats.served++;
+        classStats.totalWaitMillis += wait;
+        classStats.lastWaitMillis = wait;
+        if (wait > classStats.maxWaitMillis) classStats.maxWaitMillis = wait;
+        return true;
+    }
+    return false;
+}
+
+bool AdmissionController::hasReady(unsigned long now) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    bool ready = false;
+    for (int i = 0; i < queueCount && !ready; i++) {
+        refill(queue[i].priority, now);
+        ready = buckets[queue[i].priority].tokens >= 1;
+    }
+    xSemaphoreGive(lock);
+    return ready;
+}
+
+int AdmissionController::queuedCount() {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int count = queueCount;
+    xSemaphoreGive(lock);
+    return count;
+}
+
+void AdmissionController::clear() {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    while (queueCount > 0) dropQueued(queueCount - 1);
+    xSemaphoreGive(lock);
+}
+
+AdmissionStats AdmissionController::getStats(RequestPriority priority) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    AdmissionStats snapshot = stats[priority];
+    xSemaphoreGive(lock);
+    return snapshot;
+}
+
+void AdmissionController::logStats() {
+    for (int p = 0; p < PRIORITY_CLASSES; p++) {
+        const AdmissionStats s = getStats((RequestPriority)p);
+        if (s.admitted == 0 && s.queued == 0 && s.rejected == 0) continue;
+        unsigned long avgWait = s.served > 0 ? (unsigned long)(s.totalWaitMillis / s.served) : 0;
+        Serial.printf("Admission %s: %u admitted, %u queued (%u merged), %u served from queue, %u rejected, %u expired; "
+                      "queue wait avg %lu ms, max %lu ms, last %lu ms\n",
+                      priorityName(p), s.admitted, s.queued, s.coalesced, s.served, s.rejected, s.expired,
+                      avgWait, s.maxWaitMillis, s.lastWaitMillis);
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "intel_glasses_config.h"
+#include "camera_manager.h"
+
+// Priority classes, each with its own token bucket; lower values are served first
+enum RequestPriority {
+    PRIORITY_MANUAL,          // Button or voice capture
+    PRIORITY_AUTO,            // Periodic auto-capture
+    PRIORITY_CLASSES
+};
+
+enum AdmissionDecision {
+    ADMISSION_ADMITTED,       // Token taken, process now
+    ADMISSION_QUEUED,         // Queued, or merged into a queued request
+    ADMISSION_REJECTED        // Queue full of requests at least as urgent
+};
+
+struct TokenBucket {
+    float tokens;
+    unsigned long lastRefill;
+};
+
+// A frame waiting for a token, with its own copy of the image
+struct QueuedRequest {
+    uint8_t* imageData;
+    size_t imageSize;
+    FramePyramid* pyramid;    // Held reference in auto mode, so the levels survive the wait
+    uint8_t priority;         // RequestPriority
+    OperationMode mode;       // Mode when it was captured
+    unsigned long enqueued;   // First request of a merged burst
+};
+
+struct AdmissionStats {
+    uint32_t admitted;        // Processed without waiting
+    uint32_t queued;
+    uint32_t coalesced;       // Merged into a queued request of the same mode
+    uint32_t served;          // Processed from the queue
+    uint32_t rejected;        // Queue full, or pushed out by a more urgent request
+    uint32_t expired;         // Waited longer than ADMISSION_MAX_WAIT
+    uint64_t totalWaitMillis; // Queue wait of the served requests
+    unsigned long maxWaitMillis;
+    unsigned long lastWaitMillis;
+};
+
+// Rate limit for cloud requests. Each priority class has a token bucket that
+// refills at one token per interval up to its burst size, and every processed
+// frame takes a token. A frame that finds no token (or the processor busy) is
+// copied into a small queue instead of failing. A newer frame of the same
+// class and mode replaces the queued one, so a burst of captures becomes one
+// request for the latest frame. Queued frames are served most urgent class
+// first as tokens come in. A rejected or expired frame is counted here, not as
+// a network failure. The main loop and the pipeline upload stage both call it,
+// so every public method holds the lock.
+class AdmissionController {
+private:
+    SemaphoreHandle_t lock;
+    TokenBucket buckets[PRIORITY_CLASSES];
+    QueuedRequest queue[ADMISSION_QUEUE_DEPTH];
+    int queueCount;
+    AdmissionStats stats[PRIORITY_CLASSES];
+
+    static unsigned long tokenInterval(int priority);
+    static float burstSize(int priority);
+    void refill(int priority, unsigned long now);
+    void removeQueued(int index);
+    void dropQueued(int index);
+    void expire(unsigned long now);
+    bool admitLocked(RequestPriority priority, unsigned long now);
+    AdmissionDecision enqueueLocked(RequestPriority priority, OperationMode mode, const uint8_t* imageData,
+                                    size_t imageSize, FramePyramid* pyramid, unsigned long now);
+    bool nextLocked(unsigned long now, QueuedRequest* request);
+
+public:
+    AdmissionController();
+    bool begin();
+
+    // Takes a token when one is free and nothing as urgent is queued ahead
+    bool admit(RequestPriority priority, unsigned long now);
+    bool hasToken(RequestPriority priority, unsigned long now);
+
+    // Copies the frame into the queue and takes a reference to its pyramid, if
+    // any; ADMISSION_QUEUED or ADMISSION_REJECTED
+    AdmissionDecision enqueue(RequestPriority priority, OperationMode mode, const uint8_t* imageData,
+                              size_t imageSize, FramePyramid* pyramid, unsigned long now);
+
+    // Most urgent queued request whose class has a token; the caller frees
+    // request->imageData and releases request->pyramid. Takes the token and
+    // records the wait.
+    bool next(unsigned long now, QueuedRequest* request);
+    bool hasReady(unsigned long now);
+    int queuedCount();
+    void clear();
+
+    // Statistics
+    AdmissionStats getStats(RequestPriority priority);
+    void logStats();
+};
+
+// Global admission controller instance
+extern AdmissionController admissionController;
+
+#endif // ADMISSION_CONTROLLER_H
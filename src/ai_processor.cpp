@@ -1,41 +1,103 @@
 #include "ai_processor.h"
 #include <ArduinoJson.h>
+#include "ocr_preprocessor.h"
+#include "text_detector.h"
+#include "sign_prefilter.h"
+#include "hazard_classifier.h"
+#include "keyword_matcher.h"
+#include "clip_cache.h"
 
 AIProcessor aiProcessor;
 
 AIProcessor::AIProcessor() {
     currentMode = MODE_HAZARD_DETECTION;  // Start with hazard detection as default
+    requestMode = currentMode;
     isProcessing = false;
-    lastProcessTime = 0;
+    requestLock = nullptr;
+    lastAdmission = ADMISSION_ADMITTED;
     consecutiveFailures = 0;
+    lastBarcode[0] = '\0';
+    lastBarcodeTime = 0;
+    lastColours = -1;
+    lastColourTime = 0;
+    cascadeFrame = nullptr;
+    cascadeFrameSize = 0;
+    cascadeDepth = 0;
+    memset(&cascadeStats, 0, sizeof(cascadeStats));
+    croppedView = false;
     
-    // Initialize feedback pins
-    pinMode(STATUS_LED_PIN, OUTPUT);
-    pinMode(HAZARD_LED_PIN, OUTPUT);
-    pinMode(PROCESSING_LED_PIN, OUTPUT);
-    pinMode(BUZZER_PIN, OUTPUT);
-    pinMode(VIBRATION_PIN, OUTPUT);
-    
-    // Turn off all LEDs initially
-    updateStatusLEDs(false, false, false);
+    // Feedback pins are set up by feedbackEngine.begin()
 }
 
-bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize) {
-    if (isProcessing) {
-        Serial.println("Already processing an image, skipping...");
+bool AIProcessor::begin() {
+    if (!requestLock) requestLock = xSemaphoreCreateMutex();
+    if (!requestLock) {
+        Serial.println("Failed to create request lock");
         return false;
     }
-    
-    if (millis() - lastProcessTime < 1000) { // Prevent rapid fire processing
+    return admissionController.begin();
+}
+
+bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid,
+                               RequestPriority priority, const String* encodedImage) {
+    // Over the request rate, or busy with another frame: queue it rather than fail
+    OperationMode mode = currentMode;
+    unsigned long now = millis();
+    bool locked = xSemaphoreTake(requestLock, 0) == pdTRUE;
+    if (!locked || !admissionController.admit(priority, now)) {
+        if (locked) xSemaphoreGive(requestLock);
+        lastAdmission = admissionController.enqueue(priority, mode, imageData, imageSize, pyramid, now);
+        Serial.printf("%s, request %s\n", locked ? "Request rate reached" : "Already processing an image",
+                      lastAdmission == ADMISSION_QUEUED ? "queued" : "rejected");
         return false;
     }
+    lastAdmission = ADMISSION_ADMITTED;
+    bool success = runRequest(imageData, imageSize, pyramid, mode, encodedImage);
+    xSemaphoreGive(requestLock);
+    return success;
+}
+
+bool AIProcessor::processQueued() {
+    if (xSemaphoreTake(requestLock, 0) != pdTRUE) {
+        return false;
+    }
+    QueuedRequest request;
+    if (!admissionController.next(millis(), &request)) {
+        xSemaphoreGive(requestLock);
+        return false;
+    }
+    Serial.printf("Processing queued request after %lu ms\n", millis() - request.enqueued);
     
+    // In the mode it was captured in, with the pyramid levels of an auto-mode frame
+    bool success = runRequest(request.imageData, request.imageSize, request.pyramid, request.mode, nullptr);
+    xSemaphoreGive(requestLock);
+    free(request.imageData);
+    cameraManager.releasePyramid(request.pyramid);
+    return success;
+}
+
+bool AIProcessor::hasQueuedRequest() {
+    return !isProcessing && admissionController.hasReady(millis());
+}
+
+AdmissionDecision AIProcessor::getLastAdmission() {
+    return lastAdmission;
+}
+
+// Called with requestLock held
+bool AIProcessor::runRequest(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid, OperationMode mode,
+                             const String* encodedImage) {
     isProcessing = true;
+    requestMode = mode;
+    gsmModule.setPreEncodedImage(imageData, encodedImage);
     updateStatusLEDs(true, false, false);
+    cascadeFrame = imageData;
+    cascadeFrameSize = imageSize;
+    cascadeDepth = 0;
     
     bool success = false;
     
-    switch (currentMode) {
+    switch (mode) {
         case MODE_HAZARD_DETECTION:
             success = processHazardDetection(imageData, imageSize);
             break;
@@ -48,8 +110,14 @@ bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize) {
         case MODE_OCR:
             success = processOCR(imageData, imageSize);
             break;
+        case MODE_BARCODE:
+            success = processBarcode(imageData, imageSize);
+            break;
+        case MODE_COLOUR:
+            success = processColour(imageData, imageSize);
+            break;
         case MODE_AUTO_ALL:
-            success = processAutoMode(imageData, imageSize);
+            success = processAutoMode(imageData, imageSize, pyramid);
             break;
     }
     
@@ -62,8 +130,9 @@ bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize) {
         }
     }
     
-    lastProcessTime = millis();
+    gsmModule.setPreEncodedImage(nullptr, nullptr);
     isProcessing = false;
+    cascadeFrame = nullptr;
     updateStatusLEDs(false, false, success);
     
     return success;
@@ -72,10 +141,70 @@ bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize) {
 bool AIProcessor::processHazardDetection(uint8_t* imageData, size_t imageSize) {
     Serial.println("Processing hazard detection...");
     
+#if ENABLE_HAZARD_CLASSIFIER
+    // Local first stage: confident clear frames stay on the device, confident
+    // hazards are announced now and confirmed or cancelled by the cloud
+    HazardPrediction prediction;
+    bool audit = false;
+    bool earlyAlert = false;
+    bool earlyAnnounced = false;
+    if (hazardClassifier.classify(imageData, imageSize, &prediction)) {
+        Serial.printf("Local hazard probability %.2f (%lu us)\n", prediction.probability, prediction.micros);
+        bool skip = hazardClassifier.shouldSkipUpload(prediction, &audit);
+        earlyAlert = !skip && hazardClassifier.shouldAlertEarly(prediction);
+        
+        // Once per hazard in view, like cloud alerts, not on every frame
+        earlyAnnounced = earlyAlert;
+#if ENABLE_ALERT_TRACKING
+        AlertObservation local = {ALERT_SOURCE_LOCAL, 0, DIRECTION_NONE, -1, 0, prediction.probability};
+        AlertDecision early = alertTracker.update(ALERT_SOURCE_LOCAL, earlyAlert ? &local : nullptr, millis());
+        earlyAnnounced = early != ALERT_SILENT;
+#endif
+        if (skip) {
+            // Nothing in view as far as the trackers are concerned either
+            APIResponse clear = APIResponse();
+#if ENABLE_ALERT_TRACKING
+            alertTracker.update(ALERT_SOURCE_HAZARD, nullptr, millis());
+#endif
+            trackRegions(clear, REGION_HAZARD);
+            updateStatusLEDs(false, false, true);
+            return true;
+        }
+        if (earlyAnnounced) {
+            updateStatusLEDs(false, true, false);
+            audioManager.playHazardAlert("possible obstacle", "");
+            provideHapticFeedback(3);
+        }
+    }
+#endif
+    
     APIResponse response = gsmModule.callHazardDetection(imageData, imageSize);
     
     if (response.success) {
+#if ENABLE_HAZARD_CLASSIFIER
+        bool cloudHazard = isHazardDetected(response);
+        if (audit) {
+            hazardClassifier.recordAudit(cloudHazard);
+        }
+        if (earlyAlert) {
+            hazardClassifier.recordEarlyAlert(cloudHazard);
+        }
+        if (earlyAnnounced && !cloudHazard) {
+            Serial.println("Cloud found no hazard, cancelling local alert");
+#if ENABLE_ALERT_TRACKING
+            alertTracker.update(ALERT_SOURCE_HAZARD, nullptr, millis());
+#endif
+            trackRegions(response, CASCADE_TEXT | CASCADE_SIGN | REGION_HAZARD);
+            updateStatusLEDs(false, false, true);
+            audioManager.playLocalMP3("area_clear.mp3", AUDIO_HAZARD, true);
+            return true;
+        }
+        handleHazardResponse(response, earlyAnnounced);
+#else
         handleHazardResponse(response);
+#endif
+        trackRegions(response, CASCADE_TEXT | CASCADE_SIGN | REGION_HAZARD);
+        runCascades(response, CASCADE_FROM_HAZARD);
         return true;
     } else {
         Serial.println("Hazard detection failed: " + response.error);
@@ -90,6 +219,8 @@ bool AIProcessor::processVisualCaption(uint8_t* imageData, size_t imageSize) {
     
     if (response.success) {
         handleVisualCaptionResponse(response);
+        trackRegions(response, CASCADE_TEXT | CASCADE_SIGN);
+        runCascades(response, CASCADE_FROM_CAPTION);
         return true;
     } else {
         Serial.println("Visual caption failed: " + response.error);
@@ -104,6 +235,8 @@ bool AIProcessor::processSignDetection(uint8_t* imageData, size_t imageSize) {
     
     if (response.success) {
         handleSignDetectionResponse(response);
+        trackRegions(response, CASCADE_TEXT | CASCADE_SIGN);
+        runCascades(response, CASCADE_FROM_SIGN);
         return true;
     } else {
         Serial.println("Sign detection failed: " + response.error);
@@ -114,7 +247,20 @@ bool AIProcessor::processSignDetection(uint8_t* imageData, size_t imageSize) {
 bool AIProcessor::processOCR(uint8_t* imageData, size_t imageSize) {
     Serial.println("Processing OCR...");
     
-    APIResponse response = gsmModule.callOCR(imageData, imageSize);
+    APIResponse response;
+#if ENABLE_OCR_BILEVEL
+    // Send a deskewed bilevel G4 TIFF instead of the colour JPEG; fall back to the JPEG on failure
+    uint8_t* tiff = nullptr;
+    size_t tiffSize = 0;
+    if (ocrPreprocessor.process(imageData, imageSize, &tiff, &tiffSize)) {
+        response = gsmModule.callOCR(tiff, tiffSize, OCR_FORMAT_TIFF_G4);
+        free(tiff);
+    } else {
+        response = gsmModule.callOCR(imageData, imageSize);
+    }
+#else
+    response = gsmModule.callOCR(imageData, imageSize);
+#endif
     
     if (response.success) {
         handleOCRResponse(response);
@@ -125,26 +271,402 @@ bool AIProcessor::processOCR(uint8_t* imageData, size_t imageSize) {
     }
 }
 
-bool AIProcessor::processAutoMode(uint8_t* imageData, size_t imageSize) {
+bool AIProcessor::processAutoMode(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid) {
     Serial.println("Processing auto mode (all features)...");
     
-    // In auto mode, we prioritize hazard detection first
-    bool hazardSuccess = processHazardDetection(imageData, imageSize);
-    delay(500); // Small delay between API calls
+    // Smaller tasks read reduced levels of the same frame; without a pyramid all use the full frame
+    PyramidImage hazardImage = { imageData, imageSize, 0, 0 };
+    PyramidImage captionImage = { imageData, imageSize, 0, 0 };
+    PyramidImage thumbnail = { imageData, imageSize, 0, 0 };
+    JpegScale thumbnailScale = JPEG_SCALE_EIGHTH;
+    if (pyramid) {
+        cameraManager.getPyramidLevel(pyramid, PYRAMID_HAZARD, &hazardImage);
+        cameraManager.getPyramidLevel(pyramid, PYRAMID_CAPTION, &captionImage);
+        if (cameraManager.getPyramidLevel(pyramid, PYRAMID_THUMBNAIL, &thumbnail)) {
+            thumbnailScale = JPEG_SCALE_QUARTER;  // About 40x30 from the 160 px level
+        }
+    }
+    
+    // Sign and OCR uploads only when sign colours or text are in view
+    bool signsInView = true;
+    bool textInView = true;
+#if ENABLE_SIGN_PREFILTER
+    SignCandidates signs;
+    bool filtered = signPrefilter.detect(imageData, imageSize, &signs);
+    if (filtered && signs.count == 0) {
+        Serial.println("No sign colours in view, skipping sign upload");
+        signPrefilter.recordSkippedUpload();
+        signsInView = false;
+    }
+#endif
+#if ENABLE_TEXT_GATING
+    TextDetection text;
+    bool detected = textDetector.detect(imageData, imageSize, &text);
+    if (detected && !text.hasText) {
+        Serial.println("No text in view, skipping OCR upload");
+        textDetector.recordSkippedUpload();
+        textInView = false;
+    }
+#endif
+    
+    bool success = false;
+#if ENABLE_TASK_SCHEDULER
+    // Hazard on every frame, then the triggered tasks within the frame budget
+    taskScheduler.beginFrame(millis());
+    taskScheduler.setTriggered(MODE_VISUAL_CAPTION, taskScheduler.sceneChanged(thumbnail.data, thumbnail.size, thumbnailScale));
+    taskScheduler.setTriggered(MODE_SIGN_DETECTION, signsInView);
+    taskScheduler.setTriggered(MODE_OCR, textInView);
+    int task;
+    while ((task = taskScheduler.nextTask()) >= 0) {
+#else
+    bool triggered[] = { true, true, signsInView, textInView };
+    for (int task = MODE_HAZARD_DETECTION; task <= MODE_OCR; task++) {
+        if (!triggered[task]) continue;
+#endif
+        bool taskSuccess = false;
+#if ENABLE_TASK_SCHEDULER
+        unsigned long taskStart = millis();
+#endif
+        
+        switch (task) {
+            case MODE_HAZARD_DETECTION:
+                taskSuccess = processHazardDetection((uint8_t*)hazardImage.data, hazardImage.size);
+                break;
+                
+            case MODE_VISUAL_CAPTION:
+                taskSuccess = processVisualCaption((uint8_t*)captionImage.data, captionImage.size);
+                break;
+                
+            case MODE_SIGN_DETECTION: {
+                // Only the sign regions of the full frame, or the caption level if that is smaller
+                uint8_t* crop = nullptr;
+                size_t cropSize = 0;
+#if ENABLE_SIGN_PREFILTER
+                if (filtered && signPrefilter.cropToRegions(imageData, imageSize, signs, &crop, &cropSize) &&
+                    cropSize < captionImage.size) {
+                    Serial.printf("Sign detection on %d region(s): %u bytes\n", signs.count, (unsigned)cropSize);
+                    signPrefilter.recordUpload(captionImage.size, cropSize);
+                    croppedView = true;
+                    taskSuccess = processSignDetection(crop, cropSize);
+                    croppedView = false;
+                } else {
+                    signPrefilter.recordUpload(captionImage.size, captionImage.size);
+                    taskSuccess = processSignDetection((uint8_t*)captionImage.data, captionImage.size);
+                }
+#else
+                taskSuccess = processSignDetection((uint8_t*)captionImage.data, captionImage.size);
+#endif
+                if (crop) free(crop);
+                break;
+            }
+            
+            case MODE_OCR: {
+                // Only the region around the text
+                uint8_t* crop = nullptr;
+                size_t cropSize = 0;
+#if ENABLE_TEXT_GATING
+                if (detected && textDetector.cropToText(imageData, imageSize, text, &crop, &cropSize)) {
+                    Serial.printf("OCR on %d text region(s): %u of %u bytes\n",
+                                  text.boxCount, (unsigned)cropSize, (unsigned)imageSize);
+                    textDetector.recordUpload(imageSize, cropSize);
+                    taskSuccess = processOCR(crop, cropSize);
+                } else {
+                    textDetector.recordUpload(imageSize, imageSize);
+                    taskSuccess = processOCR(imageData, imageSize);
+                }
+#else
+                taskSuccess = processOCR(imageData, imageSize);
+#endif
+                if (crop) free(crop);
+                break;
+            }
+        }
+        
+#if ENABLE_TASK_SCHEDULER
+        taskScheduler.recordRun(task, millis() - taskStart, taskSuccess);
+#endif
+        success = success || taskSuccess;
+    }
+    
+    return success;
+}
+
+bool AIProcessor::processBarcode(uint8_t* imageData, size_t imageSize) {
+    Serial.println("Processing barcode scan...");
+    
+    // Decoded on the device; a frame without a code is not a failure
+    BarcodeResult result;
+    bool found = barcodeDecoder.decodeJpeg(imageData, imageSize, &result);
+    handleBarcodeResult(found, result, !cameraManager.isAutoCaptureEnabled());
+    return true;
+}
+
+bool AIProcessor::scanBarcode(bool manual) {
+    if (xSemaphoreTake(requestLock, 0) != pdTRUE) {
+        Serial.println("Already processing an image, skipping...");
+        return false;
+    }
+    
+    isProcessing = true;
+    updateStatusLEDs(true, false, false);
+    
+    JpegPlane luma;
+    bool captured = cameraManager.captureGrayscale(&luma);
+    if (captured) {
+        BarcodeResult result;
+        bool found = barcodeDecoder.decode(luma.data, luma.width, luma.height, luma.stride, &result);
+        free(luma.data);
+        Serial.printf("Barcode scan of %dx%d: %s (%lu us)\n", luma.width, luma.height,
+                      BarcodeDecoder::formatName(result.format), barcodeDecoder.getStats().lastMicros);
+        handleBarcodeResult(found, result, manual);
+    }
+    
+    isProcessing = false;
+    xSemaphoreGive(requestLock);
+    updateStatusLEDs(false, false, captured);
+    return captured;
+}
+
+bool AIProcessor::processColour(uint8_t* imageData, size_t imageSize) {
+    Serial.println("Processing colour identification...");
+    
+    ColourResult result;
+    if (!colourIdentifier.identify(imageData, imageSize, &result)) {
+        Serial.println("Colour identification failed");
+        return false;
+    }
+    handleColourResult(result, !cameraManager.isAutoCaptureEnabled());
+    return true;
+}
+
+bool AIProcessor::scanColour(bool manual) {
+    if (xSemaphoreTake(requestLock, 0) != pdTRUE) {
+        Serial.println("Already processing an image, skipping...");
+        return false;
+    }
+    
+    isProcessing = true;
+    updateStatusLEDs(true, false, false);
     
-    bool captionSuccess = processVisualCaption(imageData, imageSize);
-    delay(500);
+    camera_fb_t* fb = cameraManager.captureImage();
+    ColourResult result;
+    bool success = fb && colourIdentifier.identify(fb->buf, fb->len, &result);
+    cameraManager.releaseFrameBuffer(fb);
+    if (success) {
+        handleColourResult(result, manual);
+    } else {
+        Serial.println("Colour identification failed");
+    }
     
-    bool signSuccess = processSignDetection(imageData, imageSize);
-    delay(500);
+    isProcessing = false;
+    xSemaphoreGive(requestLock);
+    updateStatusLEDs(false, false, success);
+    return success;
+}
+
+void AIProcessor::runCascades(const APIResponse& response, int allowed) {
+#if ENABLE_CASCADES
+    // Auto mode already runs every request on the frame
+    if (!cascadeFrame || cascadeDepth >= CASCADE_MAX_DEPTH || requestMode == MODE_AUTO_ALL) {
+        return;
+    }
+    
+    // Kinds with a reported region, else whatever the text of the response mentions
+    int wanted = 0;
+    for (int i = 0; i < response.regionCount; i++) {
+        wanted |= response.regions[i].kind;
+    }
+    // Structured responses list every region, free text is checked for mentions
+    KeywordMatches matches;
+    if (!response.structured && keywordMatcher.classify(response.result, &matches)) {
+        if (matches.categories & KEYWORD_SIGN) wanted |= CASCADE_SIGN;
+        if (matches.categories & KEYWORD_TEXT) wanted |= CASCADE_TEXT;
+    }
+    wanted &= allowed;
     
-    bool ocrSuccess = processOCR(imageData, imageSize);
+#if ENABLE_OBJECT_TRACKING
+    // Skip kinds whose boxes are all objects read before
+    for (int kind = CASCADE_TEXT; kind <= CASCADE_SIGN; kind <<= 1) {
+        if (!(wanted & kind)) continue;
+        int boxes = 0;
+        bool needed = false;
+        for (int i = 0; i < response.regionCount; i++) {
+            if (response.regions[i].kind != kind) continue;
+            boxes++;
+            needed = needed || objectTracker.needsFollowUp(response.regions[i]);
+        }
+        if (boxes > 0 && !needed) {
+            Serial.printf("Cascade: %s already read for the tracked object(s), skipping\n", kind == CASCADE_TEXT ? "text" : "sign");
+            objectTracker.recordSkippedFollowUp();
+            wanted &= ~kind;
+        }
+    }
+#endif
     
-    return hazardSuccess || captionSuccess || signSuccess || ocrSuccess;
+    if ((wanted & CASCADE_SIGN) && runFollowUp(CASCADE_SIGN, response)) {
+        markRegionsQueried(response, CASCADE_SIGN);
+    }
+    if ((wanted & CASCADE_TEXT) && runFollowUp(CASCADE_TEXT, response)) {
+        markRegionsQueried(response, CASCADE_TEXT);
+    }
+#endif
+}
+
+void AIProcessor::markRegionsQueried(const APIResponse& response, int kind) {
+#if ENABLE_OBJECT_TRACKING
+    for (int i = 0; i < response.regionCount; i++) {
+        if (response.regions[i].kind == kind) objectTracker.markQueried(response.regions[i]);
+    }
+#endif
+}
+
+void AIProcessor::trackRegions(const APIResponse& response, int kinds) {
+#if ENABLE_OBJECT_TRACKING
+    // Boxes of follow-ups and of auto-mode crops are relative to the crop
+    if (cascadeDepth > 0 || croppedView) return;
+    
+    unsigned long now = millis();
+    for (int kind = CASCADE_TEXT; kind <= REGION_HAZARD; kind <<= 1) {
+        if (!(kinds & kind)) continue;
+        ResponseRegion boxes[API_MAX_REGIONS];
+        uint16_t ids[API_MAX_REGIONS];
+        int count = 0;
+        for (int i = 0; i < response.regionCount; i++) {
+            if (response.regions[i].kind == kind) boxes[count++] = response.regions[i];
+        }
+        objectTracker.update(kind, boxes, count, now, ids);
+        
+        if (kind != REGION_HAZARD) continue;
+        for (int i = 0; i < count; i++) {
+            TrackedObject* track = objectTracker.findById(ids[i]);
+            if (!track) continue;
+            ObjectMotion m = objectTracker.motion(*track);
+            if (m.timeToContact > 0 || m.timeToExit > 0) {
+                Serial.printf("Object #%u: contact in %.1f s, leaves view in %.1f s (0 = not expected)\n",
+                              track->id, m.timeToContact, m.timeToExit);
+            }
+        }
+    }
+    
+    // Boxes growing steadily are coming closer; the cloud's distance, when
+    // given, is already handled by the alert tracker
+    if (!(kinds & REGION_HAZARD) || (response.structured && response.details.distance > 0)) return;
+    while (TrackedObject* track = objectTracker.nextApproaching(now)) {
+        float centre = track->x.position;
+        const char* direction = centre < 0.33 ? "left" : (centre > 0.67 ? "right" : "front");
+        Serial.printf("Object #%u approaching from the %s\n", track->id, direction);
+        audioManager.playHazardAlert("approaching object", direction);
+        provideHapticFeedback(2);
+    }
+#endif
+}
+
+bool AIProcessor::runFollowUp(int kind, const APIResponse& response) {
+    const char* name = kind == CASCADE_TEXT ? "OCR" : "sign";
+    unsigned long startTime = millis();
+    
+    uint8_t* crop = nullptr;
+    size_t cropSize = 0;
+    if (!cropForFollowUp(kind, response, &crop, &cropSize)) {
+        Serial.printf("Cascade: no %s region to crop, skipping follow-up\n", name);
+        cascadeStats.skipped++;
+        return false;
+    }
+    Serial.printf("Cascade: %s follow-up on a %u of %u byte crop\n", name, (unsigned)cropSize, (unsigned)cascadeFrameSize);
+    
+    // Nested follow-ups crop from this crop, whose coordinates the next response uses
+    const uint8_t* frame = cascadeFrame;
+    size_t frameSize = cascadeFrameSize;
+    cascadeStats.bytesFrame += frameSize;
+    cascadeStats.bytesSent += cropSize;
+    cascadeFrame = crop;
+    cascadeFrameSize = cropSize;
+    cascadeDepth++;
+    bool success;
+    if (kind == CASCADE_TEXT) {
+        cascadeStats.textRequests++;
+        success = processOCR(crop, cropSize);
+    } else {
+        cascadeStats.signRequests++;
+        success = processSignDetection(crop, cropSize);
+    }
+    cascadeDepth--;
+    cascadeFrame = frame;
+    cascadeFrameSize = frameSize;
+    free(crop);
+    
+    unsigned long elapsed = millis() - startTime;
+    if (!success) cascadeStats.failures++;
+    cascadeStats.totalMillis += elapsed;
+    cascadeStats.lastMillis = elapsed;
+    Serial.printf("Cascade: %s follow-up %s in %lu ms\n", name, success ? "done" : "failed", elapsed);
+    return success;
+}
+
+bool AIProcessor::cropForFollowUp(int kind, const APIResponse& response, uint8_t** crop, size_t* cropSize) {
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(cascadeFrame, cascadeFrameSize, &info)) {
+        return false;
+    }
+    
+    // Union of the reported boxes of this kind
+    float left = 1, top = 1, right = 0, bottom = 0;
+    for (int i = 0; i < response.regionCount; i++) {
+        const ResponseRegion& region = response.regions[i];
+        if (region.kind != kind || region.width <= 0 || region.height <= 0) continue;
+        left = min(left, region.x);
+        top = min(top, region.y);
+        right = max(right, region.x + region.width);
+        bottom = max(bottom, region.y + region.height);
+    }
+    if (right > left && bottom > top) {
+        int x0 = max(0, (int)((left - CASCADE_CROP_MARGIN) * info.width));
+        int y0 = max(0, (int)((top - CASCADE_CROP_MARGIN) * info.height));
+        int x1 = min((int)info.width, (int)((right + CASCADE_CROP_MARGIN) * info.width + 0.5f));
+        int y1 = min((int)info.height, (int)((bottom + CASCADE_CROP_MARGIN) * info.height + 0.5f));
+        if (x1 <= x0 || y1 <= y0) return false;
+        
+        JpegTranscodeOptions options;
+        options.crop = true;
+        options.cropRect = { (uint16_t)x0, (uint16_t)y0, (uint16_t)(x1 - x0), (uint16_t)(y1 - y0) };
+        options.scale = JPEG_SCALE_FULL;
+        options.quantScale = 1.0;
+        options.optimizeHuffman = false;
+        options.timeLimitMicros = 0;
+        return jpegTranscoder.transcode(cascadeFrame, cascadeFrameSize, options, crop, cropSize);
+    }
+    
+    // No box: find the region on the device
+    if (kind == CASCADE_TEXT) {
+        TextDetection text;
+        return textDetector.detect(cascadeFrame, cascadeFrameSize, &text) && text.hasText &&
+               textDetector.cropToText(cascadeFrame, cascadeFrameSize, text, crop, cropSize);
+    }
+    SignCandidates signs;
+    return signPrefilter.detect(cascadeFrame, cascadeFrameSize, &signs) && signs.count > 0 &&
+           signPrefilter.cropToRegions(cascadeFrame, cascadeFrameSize, signs, crop, cropSize);
+}
+
+CascadeStats AIProcessor::getCascadeStats() {
+    return cascadeStats;
+}
+
+void AIProcessor::logCascadeStats() {
+    uint32_t requests = cascadeStats.textRequests + cascadeStats.signRequests;
+    if (requests == 0 && cascadeStats.skipped == 0) return;
+    unsigned long avgMillis = requests > 0 ? (unsigned long)(cascadeStats.totalMillis / requests) : 0;
+    float sentPercent = cascadeStats.bytesFrame > 0 ? 100.0 * cascadeStats.bytesSent / cascadeStats.bytesFrame : 0;
+    Serial.printf("Cascades: %u OCR, %u sign follow-ups (%u failed, %u without a region), avg %lu ms, crops %.0f%% of frame bytes\n",
+                  cascadeStats.textRequests, cascadeStats.signRequests, cascadeStats.failures, cascadeStats.skipped,
+                  avgMillis, sentPercent);
 }
 
 void AIProcessor::setOperationMode(OperationMode mode) {
+    // Not while a request is using the sensor or the mode
+    xSemaphoreTake(requestLock, portMAX_DELAY);
     currentMode = mode;
+    cameraManager.applyCaptureProfile(mode);
+    xSemaphoreGive(requestLock);
     Serial.println("Mode changed to: " + getCurrentModeString());
     provideAudioFeedback("Mode: " + getCurrentModeString(), false);
 }
@@ -165,12 +687,32 @@ bool AIProcessor::getProcessingStatus() {
     return isProcessing;
 }
 
+bool AIProcessor::canAcceptImage(RequestPriority priority) {
+    return !isProcessing && admissionController.hasToken(priority, millis());
+}
+
+bool AIProcessor::uploadsFrame(OperationMode mode, bool hasPyramid) {
+    switch (mode) {
+        case MODE_AUTO_ALL:
+            return !hasPyramid;
+        case MODE_OCR:
+            return !ENABLE_OCR_BILEVEL;
+        case MODE_BARCODE:
+        case MODE_COLOUR:
+            return false;
+        default:
+            return true;
+    }
+}
+
 String AIProcessor::getCurrentModeString() {
     switch (currentMode) {
         case MODE_HAZARD_DETECTION: return "Hazard Detection";
         case MODE_VISUAL_CAPTION: return "Visual Caption";
         case MODE_SIGN_DETECTION: return "Sign Detection";
         case MODE_OCR: return "Text Recognition";
+        case MODE_BARCODE: return "Barcode Scanning";
+        case MODE_COLOUR: return "Colour Identification";
         case MODE_AUTO_ALL: return "Auto All Features";
         default: return "Unknown";
     }
@@ -184,27 +726,42 @@ void AIProcessor::resetFailureCount() {
     consecutiveFailures = 0;
 }
 
-void AIProcessor::handleHazardResponse(const APIResponse& response) {
+void AIProcessor::handleHazardResponse(const APIResponse& response, bool announced) {
     Serial.println("Hazard Detection Result: " + response.result);
     Serial.printf("Confidence: %.2f%%\n", response.confidence * 100);
     
-    bool isHazard = isHazardDetected(response.result);
+    int direction;
+    bool isHazard = isHazardDetected(response, &direction);
+    if (isHazard && response.structured && response.details.distance > 0) {
+        Serial.printf("Hazard type %d at %.1f m\n", response.details.hazardType, response.details.distance);
+    }
+    
+    AlertDecision decision = isHazard ? ALERT_NEW : ALERT_SILENT;
+#if ENABLE_ALERT_TRACKING
+    AlertObservation observation;
+    if (isHazard) {
+        describeDetection(response, ALERT_SOURCE_HAZARD, direction, &observation);
+    }
+    decision = alertTracker.update(ALERT_SOURCE_HAZARD, isHazard ? &observation : nullptr, millis());
+    if (isHazard && announced) {
+        // Confirms the early warning: quiet now, and on later frames until it changes
+        alertTracker.markAnnounced(observation, millis());
+    }
+#endif
+    if (announced) {
+        decision = ALERT_SILENT;
+    }
     
-    if (isHazard && isHighConfidence(response.confidence)) {
+    if (isHazard && decision == ALERT_SILENT) {
+        // Announced already and no closer, or not confirmed yet
+        Serial.println("Hazard not announced (unchanged or unconfirmed)");
+        updateStatusLEDs(false, true, true);
+    } else if (isHazard && isHighConfidence(response.confidence)) {
         // High priority hazard alert
         updateStatusLEDs(false, true, true);
         
-        // Extract direction if available from the result
-        String direction = "";
-        String lowerResult = response.result;
-        lowerResult.toLowerCase();
-        if (lowerResult.indexOf("right") >= 0) direction = "right";
-        else if (lowerResult.indexOf("left") >= 0) direction = "left";
-        else if (lowerResult.indexOf("front") >= 0) direction = "front";
-        else if (lowerResult.indexOf("behind") >= 0) direction = "behind";
-        
-        // Play local hazard audio with direction
-        audioManager.playHazardAlert(response.result, direction);
+        // Play local hazard audio with direction, if the result gives one
+        audioManager.playHazardAlert(response.result, KeywordMatcher::directionName(direction));
         provideHapticFeedback(3); // Strong vibration pattern
         
     } else if (isHazard) {
@@ -215,7 +772,7 @@ void AIProcessor::handleHazardResponse(const APIResponse& response) {
     } else {
         // No hazard detected
         updateStatusLEDs(false, false, true);
-        if (currentMode == MODE_HAZARD_DETECTION) {
+        if (requestMode == MODE_HAZARD_DETECTION) {
             audioManager.playLocalMP3("area_clear.mp3", AUDIO_HAZARD, false);
         }
     }
@@ -229,9 +786,8 @@ void AIProcessor::handleVisualCaptionResponse(const APIResponse& response) {
         updateStatusLEDs(false, false, true);
         
         // Check if cloud provided audio
-        if (response.hasAudio && response.audioUrl.length() > 0) {
+        if (playResponseAudio(response, AUDIO_CAPTION, false)) {
             Serial.println("Playing cloud audio for visual caption");
-            audioManager.playCloudAudio(response.audioUrl, AUDIO_CAPTION, false);
         } else {
             // Fallback to text-based audio feedback
             String caption = formatResultForSpeech(response.result);
@@ -246,13 +802,26 @@ void AIProcessor::handleSignDetectionResponse(const APIResponse& response) {
     Serial.println("Sign Detection Result: " + response.result);
     Serial.printf("Confidence: %.2f%%\n", response.confidence * 100);
     
-    if (response.result.length() > 0 && isHighConfidence(response.confidence)) {
+    bool found = response.result.length() > 0 && isHighConfidence(response.confidence);
+    AlertDecision decision = found ? ALERT_NEW : ALERT_SILENT;
+#if ENABLE_ALERT_TRACKING
+    AlertObservation observation;
+    if (found) {
+        describeDetection(response, ALERT_SOURCE_SIGN, DIRECTION_NONE, &observation);
+    }
+    decision = alertTracker.update(ALERT_SOURCE_SIGN, found ? &observation : nullptr, millis());
+#endif
+    
+    if (found && decision == ALERT_SILENT) {
+        // Same sign as last time
+        Serial.println("Sign already announced");
+        updateStatusLEDs(false, false, true);
+    } else if (found) {
         updateStatusLEDs(false, false, true);
         
         // Check if cloud provided audio
-        if (response.hasAudio && response.audioUrl.length() > 0) {
+        if (playResponseAudio(response, AUDIO_SIGN, false)) {
             Serial.println("Playing cloud audio for sign detection");
-            audioManager.playCloudAudio(response.audioUrl, AUDIO_SIGN, false);
         } else {
             // Fallback to local audio
             String sign = formatResultForSpeech(response.result);
@@ -260,14 +829,13 @@ void AIProcessor::handleSignDetectionResponse(const APIResponse& response) {
         }
         
         // Check if it's a warning sign
-        if (response.result.indexOf("warning") >= 0 || 
-            response.result.indexOf("danger") >= 0 || 
-            response.result.indexOf("caution") >= 0 ||
-            response.result.indexOf("stop") >= 0) {
+        KeywordMatches matches;
+        keywordMatcher.classify(response.result, &matches);
+        if (matches.categories & KEYWORD_WARNING) {
             provideHapticFeedback(2); // Medium vibration for warning signs
         }
     } else {
-        if (currentMode == MODE_SIGN_DETECTION) {
+        if (requestMode == MODE_SIGN_DETECTION) {
             audioManager.playLocalMP3("no_signs.mp3", AUDIO_SIGN, false);
         }
     }
@@ -281,21 +849,116 @@ void AIProcessor::handleOCRResponse(const APIResponse& response) {
         updateStatusLEDs(false, false, true);
         
         // Check if cloud provided audio
-        if (response.hasAudio && response.audioUrl.length() > 0) {
+        if (playResponseAudio(response, AUDIO_OCR, false)) {
             Serial.println("Playing cloud audio for OCR text");
-            audioManager.playCloudAudio(response.audioUrl, AUDIO_OCR, false);
         } else {
             // Fallback to text-based audio feedback
             String text = formatResultForSpeech(response.result);
             provideAudioFeedback("Text found: " + text, false);
         }
     } else {
-        if (currentMode == MODE_OCR) {
+        if (requestMode == MODE_OCR) {
             audioManager.playLocalMP3("no_text.mp3", AUDIO_OCR, false);
         }
     }
 }
 
+void AIProcessor::handleBarcodeResult(bool found, const BarcodeResult& result, bool manual) {
+    if (!found) {
+        // Continuous scanning stays quiet until a code comes into view
+        if (manual) {
+            Serial.println("No code found");
+            audioManager.playLocalMP3("barcode_none.mp3", AUDIO_CAPTION, false);
+        }
+        return;
+    }
+    
+    Serial.printf("%s: %s\n", BarcodeDecoder::formatName(result.format), result.text);
+    bool repeated = strcmp(result.text, lastBarcode) == 0 && millis() - lastBarcodeTime < BARCODE_REPEAT_INTERVAL;
+    strcpy(lastBarcode, result.text);
+    lastBarcodeTime = millis();
+    if (repeated && !manual) {
+        return;
+    }
+    
+    // Prerecorded clips: the format, then the letters and digits of the payload
+    // one by one, e.g. "barcode_ean13.mp3,digit_4.mp3,..."; other characters are skipped
+    String clips;
+    switch (result.format) {
+        case BARCODE_QR: clips = "barcode_qr.mp3"; break;
+        case BARCODE_EAN13: clips = "barcode_ean13.mp3"; break;
+        case BARCODE_UPCA: clips = "barcode_upca.mp3"; break;
+        default: clips = "barcode_ean8.mp3"; break;
+    }
+    int spoken = 0;
+    bool more = false;
+    for (int i = 0; i < result.length; i++) {
+        char c = tolower((unsigned char)result.text[i]);
+        if (!isalnum((unsigned char)c)) continue;
+        if (spoken == BARCODE_SPEAK_MAX) {
+            more = true;
+            break;
+        }
+        clips += isdigit((unsigned char)c) ? ",digit_" : ",letter_";
+        clips += c;
+        clips += ".mp3";
+        spoken++;
+    }
+    if (more) {
+        clips += ",barcode_more.mp3";
+    }
+    audioManager.playLocalSequence(clips, AUDIO_CAPTION, false);
+}
+
+void AIProcessor::handleColourResult(const ColourResult& result, bool manual) {
+    int names = 0;
+    for (int i = 0; i < result.count; i++) {
+        const DominantColour& colour = result.colours[i];
+        Serial.printf("Colour: %s %.0f%% (%d, %d, %d)\n", ColourIdentifier::colourName(colour.name),
+                      colour.share * 100, colour.r, colour.g, colour.b);
+        names = names * 32 + colour.name + 1;
+    }
+    Serial.printf("Colour identification took %lu us\n", result.micros);
+    
+    // Continuous scanning only speaks when the colours change
+    bool repeated = names == lastColours && millis() - lastColourTime < COLOUR_REPEAT_INTERVAL;
+    lastColours = names;
+    lastColourTime = millis();
+    if (repeated && !manual) {
+        return;
+    }
+    
+    // Prerecorded clip per colour name, e.g. "colour_light_blue.mp3"
+    for (int i = 0; i < result.count; i++) {
+        if (i > 0) {
+            audioManager.playLocalMP3("colour_and.mp3", AUDIO_CAPTION, false);
+        }
+        String clip = String("colour_") + ColourIdentifier::colourName(result.colours[i].name) + ".mp3";
+        clip.replace(' ', '_');
+        audioManager.playLocalMP3(clip, AUDIO_CAPTION, false);
+    }
+}
+
+bool AIProcessor::playResponseAudio(const APIResponse& response, AudioCategory category, bool priority) {
+    if (!response.hasAudio) return false;
+    
+    // A clip heard before plays from flash instead of the link
+    uint64_t cacheKey = 0;
+#if ENABLE_CLIP_CACHE
+    cacheKey = ClipCache::keyFor(response.result, CLOUD_TTS_VOICE, response.audioFormat);
+#endif
+    
+    // Audio sent inline is already on its way; a URL costs another request
+    if (response.audioInline) {
+        gsmModule.playInlineAudio(category, priority, cacheKey);
+    } else if (response.audioUrl.length() > 0) {
+        audioManager.playCloudAudio(response.audioUrl, category, priority, cacheKey);
+    } else {
+        return false;
+    }
+    return true;
+}
+
 void AIProcessor::provideAudioFeedback(const String& message, bool isHazard) {
     // This is now primarily used for system messages and fallbacks
     // Most content audio comes from the cloud
@@ -306,7 +969,7 @@ void AIProcessor::provideAudioFeedback(const String& message, bool isHazard) {
         audioManager.playHazardAlert("general", "");
     } else {
         // Play simple confirmation tone
-        playTone(800, 150);
+        feedbackEngine.playTone(800, 150);
     }
     
     // TODO: Could implement local TTS as fallback if needed
@@ -314,13 +977,13 @@ void AIProcessor::provideAudioFeedback(const String& message, bool isHazard) {
 
 void AIProcessor::provideCloudAudioFeedback(const APIResponse& response) {
     // Play audio received from cloud API
-    if (response.hasAudio && response.audioUrl.length() > 0) {
-        Serial.println("Playing cloud audio: " + response.audioUrl);
+    if (response.hasAudio && (response.audioInline || response.audioUrl.length() > 0)) {
+        Serial.println("Playing cloud audio: " + (response.audioInline ? String("inline") : response.audioUrl));
         
         AudioCategory category = AUDIO_CAPTION; // Default
         
-        // Determine audio category based on current mode
-        switch (currentMode) {
+        // Determine audio category based on the mode of the request
+        switch (requestMode) {
             case MODE_HAZARD_DETECTION:
                 category = AUDIO_HAZARD;
                 break;
@@ -339,7 +1002,7 @@ void AIProcessor::provideCloudAudioFeedback(const APIResponse& response) {
         }
         
         bool priority = (category == AUDIO_HAZARD); // Hazards are high priority
-        audioManager.playCloudAudio(response.audioUrl, category, priority);
+        playResponseAudio(response, category, priority);
     } else {
         // Fallback to text-based feedback
         provideAudioFeedback(response.result, false);
@@ -347,75 +1010,90 @@ void AIProcessor::provideCloudAudioFeedback(const APIResponse& response) {
 }
 
 void AIProcessor::provideHapticFeedback(int pattern) {
+    // Played by the feedback task; returns at once
     switch (pattern) {
         case 1: // Light vibration
-            vibrate(200, 1);
+            feedbackEngine.play(FEEDBACK_HAPTIC_LIGHT);
             break;
         case 2: // Medium vibration
-            vibrate(400, 2);
+            feedbackEngine.play(FEEDBACK_HAPTIC_MEDIUM);
             break;
         case 3: // Strong vibration pattern
-            for (int i = 0; i < 3; i++) {
-                vibrate(300, 1);
-                delay(200);
-            }
+            feedbackEngine.play(FEEDBACK_HAPTIC_STRONG);
+            break;
+        case 4: // Collision warning: rapid short pulses
+            feedbackEngine.play(FEEDBACK_HAPTIC_COLLISION);
             break;
         default:
-            vibrate(100, 1);
+            feedbackEngine.play(FEEDBACK_HAPTIC_TAP);
             break;
     }
 }
 
 void AIProcessor::updateStatusLEDs(bool processing, bool hazard, bool success) {
-    digitalWrite(PROCESSING_LED_PIN, processing ? HIGH : LOW);
-    digitalWrite(HAZARD_LED_PIN, hazard ? HIGH : LOW);
+    uint8_t levels = 0;
+    if (processing) levels |= FEEDBACK_PROCESSING_LED;
+    if (hazard) levels |= FEEDBACK_HAZARD_LED;
     
     if (processing) {
         // Blinking status LED during processing
-        digitalWrite(STATUS_LED_PIN, (millis() / 250) % 2);
-    } else {
-        digitalWrite(STATUS_LED_PIN, success ? HIGH : LOW);
+        if ((millis() / 250) % 2) levels |= FEEDBACK_STATUS_LED;
+    } else if (success) {
+        levels |= FEEDBACK_STATUS_LED;
     }
+    feedbackEngine.setBaseline(levels, FEEDBACK_STATUS_LED | FEEDBACK_HAZARD_LED | FEEDBACK_PROCESSING_LED);
 }
 
-void AIProcessor::playTone(int frequency, int duration) {
-    // Simple tone generation using PWM
-    ledcSetup(0, frequency, 8);
-    ledcAttachPin(BUZZER_PIN, 0);
-    ledcWrite(0, 128);
-    delay(duration);
-    ledcWrite(0, 0);
-    ledcDetachPin(BUZZER_PIN);
+bool AIProcessor::isHighConfidence(float confidence) {
+    return confidence >= 0.7; // 70% confidence threshold
 }
 
-void AIProcessor::vibrate(int duration, int pattern) {
-    for (int i = 0; i < pattern; i++) {
-        digitalWrite(VIBRATION_PIN, HIGH);
-        delay(duration / pattern);
-        digitalWrite(VIBRATION_PIN, LOW);
-        if (i < pattern - 1) {
-            delay(100); // Short pause between pulses
-        }
+bool AIProcessor::isHazardDetected(const APIResponse& response, int* direction) {
+    // Structured responses say so; free text is checked for hazard keywords
+    if (response.structured) {
+        if (direction) *direction = response.details.direction;
+        return response.details.hazardType != HAZARD_NONE;
     }
+    KeywordMatches matches;
+    bool found = keywordMatcher.classify(response.result, &matches);
+    if (direction) *direction = matches.direction;
+    return found && (matches.categories & KEYWORD_HAZARD);
 }
 
-bool AIProcessor::isHighConfidence(float confidence) {
-    return confidence >= 0.7; // 70% confidence threshold
-}
-
-bool AIProcessor::isHazardDetected(const String& result) {
-    // Check for hazard keywords in the result
-    String lowerResult = result;
-    lowerResult.toLowerCase();
+void AIProcessor::describeDetection(const APIResponse& response, uint8_t source, int direction,
+                                    AlertObservation* observation) {
+    observation->source = source;
+    observation->direction = direction;
+    observation->distance = response.structured ? response.details.distance : 0;
+    observation->confidence = response.confidence;
+    
+    // Kind of hazard from the enum or the first hazard keyword; a sign by its
+    // wording, ignoring case, spaces and punctuation
+    if (source == ALERT_SOURCE_HAZARD && response.structured) {
+        observation->type = response.details.hazardType;
+    } else if (source == ALERT_SOURCE_HAZARD) {
+        KeywordMatches matches;
+        keywordMatcher.classify(response.result, &matches);
+        observation->type = matches.hazard + 1;
+    } else {
+        uint32_t hash = 2166136261UL;  // FNV-1a
+        for (unsigned int i = 0; i < response.result.length(); i++) {
+            char c = response.result[i];
+            if (!isalnum((unsigned char)c)) continue;
+            hash = (hash ^ (uint8_t)tolower((unsigned char)c)) * 16777619UL;
+        }
+        observation->type = hash;
+    }
     
-    return (lowerResult.indexOf("hazard") >= 0 ||
-            lowerResult.indexOf("danger") >= 0 ||
-            lowerResult.indexOf("warning") >= 0 ||
-            lowerResult.indexOf("obstacle") >= 0 ||
-            lowerResult.indexOf("fire") >= 0 ||
-            lowerResult.indexOf("caution") >= 0 ||
-            lowerResult.indexOf("risk") >= 0 ||
-            lowerResult.indexOf("unsafe") >= 0);
+    // Horizontal position from the first box of the matching kind
+    uint8_t kind = source == ALERT_SOURCE_HAZARD ? REGION_HAZARD : CASCADE_SIGN;
+    observation->position = -1;
+    for (int i = 0; i < response.regionCount; i++) {
+        if (response.regions[i].kind == kind) {
+            observation->position = response.regions[i].x + response.regions[i].width / 2;
+            break;
+        }
+    }
 }
 
 String AIProcessor::formatResultForSpeech(const String& result) {
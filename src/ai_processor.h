@@ -2,27 +2,76 @@
 #define AI_PROCESSOR_H
 
 #include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "intel_glasses_config.h"
 #include "gsm_module.h"
 #include "audio_manager.h"
+#include "camera_manager.h"
+#include "barcode_decoder.h"
+#include "colour_identifier.h"
+#include "alert_tracker.h"
+#include "object_tracker.h"
+#include "task_scheduler.h"
+#include "admission_controller.h"
+#include "feedback_engine.h"
+
+// Follow-up requests triggered by first-stage responses
+struct CascadeStats {
+    uint32_t textRequests;    // OCR follow-ups sent
+    uint32_t signRequests;    // Sign follow-ups sent
+    uint32_t failures;        // Follow-ups without a usable response
+    uint32_t skipped;         // Follow-ups wanted but no region to crop was found
+    uint64_t bytesFrame;      // Size of the frames the crops were taken from
+    uint64_t bytesSent;       // Size of the crops uploaded
+    uint64_t totalMillis;     // Crop, upload and response time of all follow-ups
+    unsigned long lastMillis;
+};
 
 class AIProcessor {
 private:
     OperationMode currentMode;
-    bool isProcessing;
-    unsigned long lastProcessTime;
+    OperationMode requestMode;           // Mode of the request in progress, fixed until it ends
+    std::atomic<bool> isProcessing;
+    // One request at a time: the main loop and the pipeline upload stage both
+    // send frames, and a mode change waits for the request in progress
+    SemaphoreHandle_t requestLock;
+    AdmissionDecision lastAdmission;     // Of the last processImage() call
     int consecutiveFailures;
     
+    // Last announced barcode, to stay quiet while the same code stays in view
+    char lastBarcode[BARCODE_MAX_TEXT + 1];
+    unsigned long lastBarcodeTime;
+    int lastColours;                      // Last announced colour names, five bits each
+    unsigned long lastColourTime;
+    
+    // Frame being processed, cropped by follow-up requests; valid only inside processImage()
+    const uint8_t* cascadeFrame;
+    size_t cascadeFrameSize;
+    int cascadeDepth;
+    CascadeStats cascadeStats;
+    
+    // Set while a crop of the frame is processed, whose boxes are not tracked
+    bool croppedView;
+    
 public:
     AIProcessor();
+    bool begin();
     
-    // Core processing methods
-    bool processImage(uint8_t* imageData, size_t imageSize);
+    // Core processing methods; encodedImage is the frame already in Base64, if any
+    bool processImage(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid = nullptr,
+                      RequestPriority priority = PRIORITY_AUTO, const String* encodedImage = nullptr);
+    bool processQueued();                 // Next queued frame whose class has a token
     bool processHazardDetection(uint8_t* imageData, size_t imageSize);
     bool processVisualCaption(uint8_t* imageData, size_t imageSize);
     bool processSignDetection(uint8_t* imageData, size_t imageSize);
     bool processOCR(uint8_t* imageData, size_t imageSize);
-    bool processAutoMode(uint8_t* imageData, size_t imageSize);
+    bool processAutoMode(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid);
+    bool processBarcode(uint8_t* imageData, size_t imageSize);
+    bool scanBarcode(bool manual);        // Grayscale capture decoded on the device, no upload
+    bool processColour(uint8_t* imageData, size_t imageSize);
+    bool scanColour(bool manual);         // Dominant colours at the centre of a capture, no upload
     
     // Mode management
     void setOperationMode(OperationMode mode);
@@ -31,10 +80,18 @@ public:
     
     // Status methods
     bool getProcessingStatus();
+    bool canAcceptImage(RequestPriority priority = PRIORITY_AUTO);
+    bool uploadsFrame(OperationMode mode, bool hasPyramid); // False when only levels, crops or a TIFF of it are sent
+    bool hasQueuedRequest();
+    AdmissionDecision getLastAdmission(); // Queued or rejected when processImage() returned false without a request
     String getCurrentModeString();
     int getConsecutiveFailures();
     void resetFailureCount();
     
+    // Cascaded requests
+    CascadeStats getCascadeStats();
+    void logCascadeStats();
+    
     // Feedback methods
     void provideAudioFeedback(const String& message, bool isHazard = false);
     void provideCloudAudioFeedback(const APIResponse& response);
@@ -42,17 +99,31 @@ public:
     void updateStatusLEDs(bool processing, bool hazard, bool success);
     
 private:
-    void handleHazardResponse(const APIResponse& response);
+    bool runRequest(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid, OperationMode mode,
+                    const String* encodedImage);
+    
+    // announced: the hazard was already announced for this frame, by the local early warning
+    void handleHazardResponse(const APIResponse& response, bool announced = false);
     void handleVisualCaptionResponse(const APIResponse& response);
     void handleSignDetectionResponse(const APIResponse& response);
     void handleOCRResponse(const APIResponse& response);
+    void handleBarcodeResult(bool found, const BarcodeResult& result, bool manual);
+    void handleColourResult(const ColourResult& result, bool manual);
+    // Inline audio or audio_url; false when the response has neither
+    bool playResponseAudio(const APIResponse& response, AudioCategory category, bool priority);
+    
+    void describeDetection(const APIResponse& response, uint8_t source, int direction,
+                           AlertObservation* observation);
+    void trackRegions(const APIResponse& response, int kinds);
+    void markRegionsQueried(const APIResponse& response, int kind);
+    void runCascades(const APIResponse& response, int allowed);
+    bool runFollowUp(int kind, const APIResponse& response);
+    bool cropForFollowUp(int kind, const APIResponse& response, uint8_t** crop, size_t* cropSize);
     
     void speakText(const String& text);
-    void playTone(int frequency, int duration);
-    void vibrate(int duration, int pattern = 1);
     
     bool isHighConfidence(float confidence);
-    bool isHazardDetected(const String& result);
+    bool isHazardDetected(const APIResponse& response, int* direction = nullptr);
     String formatResultForSpeech(const String& result);
 };
 
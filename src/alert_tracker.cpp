@@ -0,0 +1,134 @@
+#include "alert_tracker.h"
+#include <cstring>
+
+AlertTracker alertTracker;
+
+AlertTracker::AlertTracker() {
+    reset();
+}
+
+void AlertTracker::reset() {
+    trackCount = 0;
+    memset(tracks, 0, sizeof(tracks));
+    memset(&stats, 0, sizeof(stats));
+}
+
+int AlertTracker::findTrack(const AlertObservation& observation) {
+    for (int i = 0; i < trackCount; i++) {
+        const AlertObservation& last = tracks[i].last;
+        if (last.source != observation.source || last.type != observation.type ||
+            last.direction != observation.direction) {
+            continue;
+        }
+        if (last.position >= 0 && observation.position >= 0 &&
+            fabsf(last.position - observation.position) > ALERT_POSITION_TOLERANCE) {
+            continue;
+        }
+        return i;
+    }
+    return -1;
+}
+
+void AlertTracker::removeTrack(int index) {
+    tracks[index] = tracks[--trackCount];
+}
+
+AlertDecision AlertTracker::update(uint8_t source, const AlertObservation* observation, unsigned long now) {
+    // Forget tracks not seen for too long, whatever their source
+    for (int i = trackCount - 1; i >= 0; i--) {
+        if (now - tracks[i].lastSeen > ALERT_TRACK_TIMEOUT) removeTrack(i);
+    }
+
+    // Every other track of this source missed a frame
+    int match = observation ? findTrack(*observation) : -1;
+    for (int i = trackCount - 1; i >= 0; i--) {
+        if (i == match || tracks[i].last.source != source) continue;
+        if (++tracks[i].misses >= ALERT_CLEAR_FRAMES) {
+            removeTrack(i);
+            if (match == trackCount) match = i;  // The match was moved into the freed slot
+        }
+    }
+    if (!observation) return ALERT_SILENT;
+    stats.observations++;
+
+    if (match < 0) {
+        if (trackCount == ALERT_MAX_TRACKS) {
+            // Full: forget the track seen least recently
+            int oldest = 0;
+            for (int i = 1; i < trackCount; i++) {
+                if (tracks[i].lastSeen < tracks[oldest].lastSeen) oldest = i;
+            }
+            removeTrack(oldest);
+        }
+        match = trackCount++;
+        memset(&tracks[match], 0, sizeof(AlertTrack));
+    }
+
+    AlertTrack& track = tracks[match];
+    track.last = *observation;
+    track.score = track.score * ALERT_SCORE_DECAY + observation->confidence;
+    track.misses = 0;
+    track.lastSeen = now;
+    bool high = observation->confidence >= ALERT_HIGH_CONFIDENCE;
+
+    AlertDecision decision = ALERT_SILENT;
+    if (!track.active) {
+        if (track.score >= ALERT_FIRE_SCORE) {
+            decision = ALERT_NEW;
+        } else {
+            stats.pending++;
+        }
+    } else if (now - track.lastAnnounced >= ALERT_ESCALATE_COOLDOWN) {
+        bool closer = observation->distance > 0 && track.announcedDistance > 0 &&
+                      observation->distance <= track.announcedDistance * ALERT_ESCALATE_RATIO;
+        bool surer = high && !track.announcedHigh;
+        const unsigned long reminder = ALERT_REMINDER_INTERVAL;
+        if (closer || surer) {
+            decision = ALERT_ESCALATE;
+        } else if (reminder > 0 && now - track.lastAnnounced >= reminder) {
+            decision = ALERT_NEW;
+        }
+    }
+
+    if (decision == ALERT_SILENT) {
+        if (track.active) stats.suppressed++;
+        return decision;
+    }
+    if (decision == ALERT_NEW) {
+        stats.announced++;
+    } else {
+        stats.escalated++;
+    }
+    announce(track, *observation, now);
+    return decision;
+}
+
+void AlertTracker::announce(AlertTrack& track, const AlertObservation& observation, unsigned long now) {
+    track.active = true;
+    track.lastAnnounced = now;
+    track.announcedHigh = track.announcedHigh || observation.confidence >= ALERT_HIGH_CONFIDENCE;
+    if (observation.distance > 0) track.announcedDistance = observation.distance;
+}
+
+void AlertTracker::markAnnounced(const AlertObservation& observation, unsigned long now) {
+    int index = findTrack(observation);
+    if (index >= 0) announce(tracks[index], observation, now);
+}
+
+int AlertTracker::activeTracks() {
+    int count = 0;
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].active) count++;
+    }
+    return count;
+}
+
+AlertTrackerStats AlertTracker::getStats() {
+    return stats;
+}
+
+void AlertTracker::logStats() {
+    if (stats.observations == 0) return;
+    Serial.printf("Alerts: %u detections, %u announced, %u escalated, %u repeats suppressed, %u below threshold, %d active\n",
+                  stats.observations, stats.announced, stats.escalated, stats.suppressed, stats.pending, activeTracks());
+}
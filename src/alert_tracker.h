@@ -0,0 +1,88 @@
+#ifndef ALERT_TRACKER_H
+#define ALERT_TRACKER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+enum AlertSource {
+    ALERT_SOURCE_HAZARD,
+    ALERT_SOURCE_SIGN,
+    ALERT_SOURCE_LOCAL        // Early warning of the on-device hazard classifier
+};
+
+enum AlertDecision {
+    ALERT_SILENT,             // Not confirmed yet, or nothing changed since it was announced
+    ALERT_NEW,                // First announcement of this detection
+    ALERT_ESCALATE            // Announced before, now closer or more certain
+};
+
+// One detection from one response
+struct AlertObservation {
+    uint8_t source;           // AlertSource
+    uint32_t type;            // HazardType, keyword index or text hash; same value = same kind of thing
+    uint8_t direction;        // KeywordDirection
+    float position;           // Horizontal centre as a fraction of the frame, -1 when unknown
+    float distance;           // Metres, 0 when unknown
+    float confidence;
+};
+
+struct AlertTrack {
+    AlertObservation last;
+    float score;              // Confidence accumulated over sightings
+    float announcedDistance;  // Distance when last announced, 0 when unknown
+    bool active;              // Announced and not cleared yet
+    bool announcedHigh;       // Announced at high confidence
+    uint8_t misses;           // Consecutive frames of its source without it
+    unsigned long lastSeen;
+    unsigned long lastAnnounced;
+};
+
+struct AlertTrackerStats {
+    uint32_t observations;
+    uint32_t announced;       // New alerts
+    uint32_t escalated;
+    uint32_t suppressed;      // Repeats kept quiet
+    uint32_t pending;         // Sightings below the score needed to alert
+};
+
+// Memory of recent hazard and sign detections, so one hazard is announced once
+// rather than on every capture. A detection is tracked by source, type and
+// direction (and horizontal position when known). It alerts once its score,
+// the decayed sum of its confidences, reaches ALERT_FIRE_SCORE; after that it
+// is quiet until it comes closer or turns high-confidence. A track is only
+// cleared after ALERT_CLEAR_FRAMES frames without it, so a single missed frame
+// does not cause a re-announcement. Times are passed in, which keeps the
+// tracker deterministic for replaying recorded response sequences.
+class AlertTracker {
+private:
+    AlertTrack tracks[ALERT_MAX_TRACKS];
+    int trackCount;
+    AlertTrackerStats stats;
+
+    int findTrack(const AlertObservation& observation);
+    void removeTrack(int index);
+    void announce(AlertTrack& track, const AlertObservation& observation, unsigned long now);
+
+public:
+    AlertTracker();
+
+    // One frame of `source`; `observation` is nullptr when it found nothing.
+    // Every other track of that source counts the frame as a miss.
+    AlertDecision update(uint8_t source, const AlertObservation* observation, unsigned long now);
+
+    // Records the track just updated with `observation` as announced, for a
+    // detection already announced another way (the local early warning)
+    void markAnnounced(const AlertObservation& observation, unsigned long now);
+
+    void reset();
+    int activeTracks();
+
+    // Statistics
+    AlertTrackerStats getStats();
+    void logStats();
+};
+
+// Global alert tracker instance
+extern AlertTracker alertTracker;
+
+#endif // ALERT_TRACKER_H
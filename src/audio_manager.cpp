@@ -1,80 +1,1052 @@
 #include "audio_manager.h"
+#include <HTTPClient.h>
+#include <LittleFS.h>
+#include <cmath>
+#include <cstring>
 
 // Global audio manager instance
 AudioManager audioManager;
 
-// Simplified audio manager implementation for compilation
-// TODO: Implement full audio functionality when library is properly configured
+// Task configuration
+static const uint32_t PLAYBACK_TASK_STACK = 6144;
 
-AudioManager::AudioManager() {
+// How long the playback task sleeps with nothing queued, and how long one
+// write waits for ring space before checking for an interruption
+static const uint32_t PLAYBACK_IDLE_WAIT_MS = 1000;
+static const uint32_t WRITE_WAIT_MS = 50;
+
+// Tones: peak level, fade at each end against clicks, and the gap between beeps
+static const float TONE_AMPLITUDE = 12000.0f;
+static const int TONE_FADE_MS = 5;
+static const int TONE_GAP_MS = 80;
+
+// Bytes read from a clip at a time; a multiple of every WAV frame size
+static const size_t READ_BLOCK = 512;
+
+// Streams: ring space needed before decoding a frame (an 8 kHz frame becomes
+// 1152 samples), the poll period while waiting for the link, and how long
+// after the first byte the stream's own rate is trusted over the learned one
+static const size_t STREAM_FRAME_ROOM = 1152 + AUDIO_CHUNK_SAMPLES;
+static const uint32_t STREAM_POLL_MS = 5;
+static const unsigned long STREAM_RATE_WINDOW_MS = 200;
+
+namespace {
+
+uint16_t readLe16(const uint8_t* p) {
+    return p[0] | (p[1] << 8);
+}
+
+uint32_t readLe32(const uint8_t* p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// A clip in memory or in a file, read front to back
+struct ClipReader {
+    const uint8_t* data;
+    size_t size;
+    size_t position;
+    File* file;
+
+    size_t read(uint8_t* out, size_t count) {
+        if (file) return file->read(out, count);
+        count = min(count, size - position);
+        memcpy(out, data + position, count);
+        position += count;
+        return count;
+    }
+
+    bool skip(size_t count) {
+        if (file) return file->seek(file->position() + count);
+        if (count > size - position) return false;
+        position += count;
+        return true;
+    }
+};
+
+const char* categoryName(AudioCategory category) {
+    switch (category) {
+        case AUDIO_SYSTEM: return "system";
+        case AUDIO_HAZARD: return "hazard";
+        case AUDIO_CAPTION: return "caption";
+        case AUDIO_OCR: return "ocr";
+        case AUDIO_SIGN: return "sign";
+        case AUDIO_STATUS: return "status";
+        case AUDIO_ERROR: return "error";
+    }
+    return "unknown";
+}
+
+AudioPlayback makePlayback(AudioType type, AudioCategory category, bool priority) {
+    AudioPlayback playback;
+    playback.type = type;
+    playback.category = category;
+    playback.audioData = nullptr;
+    playback.stream = nullptr;
+    playback.cacheKey = 0;
+    playback.dataSize = 0;
+    playback.isPlaying = false;
+    playback.priority = priority;
+    playback.startTime = 0;
+    playback.volume = 100;
+    playback.toneFrequency = 0;
+    playback.toneMillis = 0;
+    playback.toneCount = 0;
+    return playback;
+}
+
+} // namespace
+
+AudioManager::AudioManager() : abortPlayback(false), paused(false) {
     isInitialized = false;
-    globalVolume = 50; // Default volume
     isPlaying = false;
+    hasFilesystem = false;
     muteState = false;
-    queueHead = 0;
-    queueTail = 0;
+    globalVolume = 50; // Default volume
+    taskHandle = nullptr;
+    queueLock = nullptr;
+    currentPlayback = makePlayback(AUDIO_SIMPLE_TONE, AUDIO_SYSTEM, false);
+    lastPriority = false;
     queueCount = 0;
+    chunkCount = 0;
+    clipVolume = 100;
+    firstWritten = false;
+    startResampling(AUDIO_SAMPLE_RATE);
+    downlinkBytesPerSecond = 0;
+    downlinkGapMillis = 0;
+    memset(&streamStats, 0, sizeof(streamStats));
+    memset(&stats, 0, sizeof(stats));
 }
 
 AudioManager::~AudioManager() {
-    // Cleanup resources
+    deinitialize();
 }
 
 bool AudioManager::initialize() {
-    Serial.println("Initializing simplified audio manager...");
+    if (isInitialized) return true;
+    Serial.println("Initializing audio manager...");
+
+    if (!queueLock) queueLock = xSemaphoreCreateMutex();
+    if (!queueLock) {
+        Serial.println("Audio manager: out of memory");
+        return false;
+    }
+
+    hasFilesystem = LittleFS.begin(false);
+    if (!hasFilesystem) {
+        Serial.println("Audio manager: filesystem unavailable, clips fall back to tones");
+    }
+#if ENABLE_CLIP_CACHE
+    if (hasFilesystem) clipCache.begin(LittleFS);
+#endif
+
+    if (!setupI2SAudio()) return false;
+    audioOutput.setVolume(muteState ? 0 : globalVolume);
+
     isInitialized = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(playbackTask, "audio_play", PLAYBACK_TASK_STACK,
+                                            this, AUDIO_PLAYBACK_PRIORITY, &taskHandle, AUDIO_OUTPUT_CORE);
+    if (ok != pdPASS) {
+        Serial.println("Audio manager: failed to create playback task");
+        isInitialized = false;
+        taskHandle = nullptr;
+        audioOutput.end();
+        return false;
+    }
+
+    if (hasFilesystem) loadLocalAudioFiles();
     return true;
 }
 
-bool AudioManager::playLocalMP3(const String& filename, AudioCategory category, bool priority) {
-    Serial.printf("Playing local MP3: %s (category: %d, priority: %s)\n", 
-                  filename.c_str(), category, priority ? "true" : "false");
-    currentPlayback.category = category;
-    isPlaying = true;
-    
-    // TODO: Implement actual MP3 playback
-    delay(100); // Simulate playback delay
-    isPlaying = false;
+void AudioManager::deinitialize() {
+    if (isInitialized) {
+        isInitialized = false;
+        abortPlayback.store(true);
+        if (taskHandle) xTaskNotifyGive(taskHandle);
+
+        // The task stops at its next chunk and deletes itself
+        unsigned long start = millis();
+        while (taskHandle && millis() - start < 1000) {
+            delay(10);
+        }
+        clearQueue();
+        audioOutput.end();
+        clipCache.end();
+    }
+}
+
+bool AudioManager::setupI2SAudio() {
+    return audioOutput.begin();
+}
+
+void AudioManager::playbackTask(void* param) {
+    AudioManager* manager = (AudioManager*)param;
+    manager->runLoop();
+    manager->taskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void AudioManager::runLoop() {
+    while (isInitialized) {
+        if (!playAudioFromQueue()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(PLAYBACK_IDLE_WAIT_MS));
+        }
+    }
+}
+
+bool AudioManager::playAudioFromQueue() {
+    AudioPlayback playback;
+    if (!getNextFromQueue(&playback)) return false;
+
+    // Priority audio should not wait behind the tail of an ordinary clip
+    if (playback.priority && !lastPriority && audioOutput.isDraining()) {
+        audioOutput.flush();
+    }
+    lastPriority = playback.priority;
+
+    Serial.printf("Audio: playing %s clip %s\n", categoryName(playback.category),
+                  playback.type == AUDIO_CLOUD_STREAM ? playback.url.c_str() : playback.filename.c_str());
+    chunkCount = 0;
+    clipVolume = playback.volume;
+    firstWritten = false;
+    audioOutput.startStream();
+
+    bool completed;
+    switch (playback.type) {
+        case AUDIO_LOCAL_MP3:
+            completed = playFile(playback);
+            break;
+        case AUDIO_CLOUD_STREAM:
+        case AUDIO_RESPONSE_STREAM:
+            completed = playCloudClip(playback);
+            break;
+        case AUDIO_MEMORY_DATA:
+            completed = playWav(playback.audioData, playback.dataSize, nullptr);
+            // Same admission to the clip cache as a streamed clip, already whole
+            if (playback.cacheKey != 0 && clipCache.beginCapture(playback.cacheKey, playback.dataSize)) {
+                clipCache.capture(playback.audioData, playback.dataSize);
+                clipCache.endCapture(true);
+            }
+            break;
+        default:
+            completed = playToneSamples(playback.toneFrequency, playback.toneMillis, playback.toneCount);
+            break;
+    }
+    if (completed) completed = flushChunk();
+
+    audioOutput.endStream();
+    releasePlayback(playback);
+    handleAudioFinished(completed);
     return true;
 }
 
-bool AudioManager::playCloudAudio(const String& url, AudioCategory category, bool priority) {
-    Serial.printf("Playing cloud audio: %s (category: %d, priority: %s)\n", 
-                  url.c_str(), category, priority ? "true" : "false");
-    currentPlayback.category = category;
-    isPlaying = true;
-    
-    // TODO: Implement cloud audio streaming
-    delay(100); // Simulate playback delay
+void AudioManager::handleAudioFinished(bool completed) {
+    if (!completed) audioOutput.flush();
+
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    if (completed) {
+        stats.played++;
+    } else {
+        stats.interrupted++;
+    }
     isPlaying = false;
+    currentPlayback.isPlaying = false;
+    xSemaphoreGive(queueLock);
+}
+
+bool AudioManager::emit(int16_t sample) {
+    if (clipVolume < 100) sample = (int32_t)sample * clipVolume / 100;
+    chunk[chunkCount++] = sample;
+    if (chunkCount < AUDIO_CHUNK_SAMPLES) return true;
+    return flushChunk();
+}
+
+bool AudioManager::flushChunk() {
+    size_t written = 0;
+    while (written < chunkCount) {
+        if (abortPlayback.load() || !isInitialized || !audioOutput.isActive()) {
+            chunkCount = 0;
+            return false;
+        }
+        written += audioOutput.write(chunk + written, chunkCount - written, WRITE_WAIT_MS);
+    }
+    chunkCount = 0;
+
+    if (!firstWritten) {
+        firstWritten = true;
+        xSemaphoreTake(queueLock, portMAX_DELAY);
+        unsigned long wait = millis() - currentPlayback.startTime;
+        if (wait > stats.maxQueueMillis) stats.maxQueueMillis = wait;
+        xSemaphoreGive(queueLock);
+    }
     return true;
 }
 
-void AudioManager::playSystemAudio(const String& audioKey) {
-    Serial.printf("Playing system audio: %s\n", audioKey.c_str());
-    currentPlayback.category = AUDIO_SYSTEM;
-    isPlaying = true;
-    
-    // TODO: Implement system audio playback
-    delay(50); // Simulate system sound
-    isPlaying = false;
+void AudioManager::startResampling(uint32_t rate) {
+    clipRate = rate;
+    resamplePosition = 0;
+    resamplePrevious = 0;
+    resamplePrimed = false;
+}
+
+bool AudioManager::emitResampled(int16_t sample) {
+    if (clipRate == AUDIO_SAMPLE_RATE) return emit(sample);
+    if (!resamplePrimed) {
+        resamplePrevious = sample;
+        resamplePrimed = true;
+        return true;
+    }
+
+    // Linear interpolation; the position is exact, so there is no drift
+    int32_t delta = sample - resamplePrevious;
+    while (resamplePosition < AUDIO_SAMPLE_RATE) {
+        if (!emit(resamplePrevious + (int32_t)((int64_t)delta * resamplePosition / AUDIO_SAMPLE_RATE))) return false;
+        resamplePosition += clipRate;
+    }
+    resamplePosition -= AUDIO_SAMPLE_RATE;
+    resamplePrevious = sample;
+    return true;
+}
+
+bool AudioManager::emitFrames(const int16_t* pcm, int frames, int channels) {
+    for (int i = 0; i < frames; i++) {
+        int32_t sum = pcm[i * channels];
+        if (channels == 2) sum = (sum + pcm[i * 2 + 1]) / 2;
+        if (!emitResampled(sum)) return false;
+    }
+    return true;
+}
+
+bool AudioManager::playFile(const AudioPlayback& playback) {
+    // A sequence plays its clips into one stream; a missing clip ends it with one fallback tone
+    int start = 0;
+    while (true) {
+        int comma = playback.filename.indexOf(',', start);
+        String filename = comma < 0 ? playback.filename.substring(start) : playback.filename.substring(start, comma);
+
+        // Prefer a WAV of the same name; it needs no decoding
+        String path = getAudioFilePath(filename);
+        if (path.endsWith(".mp3")) {
+            String wavPath = path.substring(0, path.length() - 4) + ".wav";
+            if (hasFilesystem && LittleFS.exists(wavPath)) path = wavPath;
+        }
+
+        if (!hasFilesystem || !LittleFS.exists(path)) {
+            Serial.printf("Audio: no playable clip for %s\n", filename.c_str());
+            return playFallbackTone(playback.category);
+        }
+
+        File file = LittleFS.open(path, FILE_READ);
+        if (!file) return playFallbackTone(playback.category);
+        bool completed = path.endsWith(".mp3") ? playMp3(nullptr, 0, &file) : playWav(nullptr, 0, &file);
+        file.close();
+        if (!completed || comma < 0) return completed;
+        start = comma + 1;
+    }
+}
+
+bool AudioManager::playWav(const uint8_t* data, size_t size, File* file) {
+    ClipReader reader = { data, size, 0, file };
+    uint8_t block[READ_BLOCK];
+    Mp3FrameHeader mp3Header;
+
+    uint32_t rate = AUDIO_SAMPLE_RATE;
+    int channels = 1;
+    int bits = 16;
+    uint32_t dataBytes = 0;
+
+    size_t got = reader.read(block, 12);
+    if (!file && got >= 3 && (memcmp(block, "ID3", 3) == 0 || Mp3StreamDecoder::parseHeader(block, &mp3Header))) {
+        return playMp3(data, size, nullptr);
+    }
+    if (got == 12 && memcmp(block, "RIFF", 4) == 0 && memcmp(block + 8, "WAVE", 4) == 0) {
+        // Walk the chunks up to "data", taking the format from "fmt "
+        bool haveFormat = false;
+        bool haveData = false;
+        while (!haveData && reader.read(block, 8) == 8) {
+            uint32_t length = readLe32(block + 4);
+            if (memcmp(block, "data", 4) == 0) {
+                dataBytes = length;
+                haveData = true;
+                break;
+            }
+            if (memcmp(block, "fmt ", 4) == 0 && length >= 16) {
+                if (reader.read(block, 16) != 16) break;
+                uint16_t format = readLe16(block);
+                channels = readLe16(block + 2);
+                rate = readLe32(block + 4);
+                bits = readLe16(block + 14);
+                haveFormat = (format == 1 || format == 0xFFFE);
+                length -= 16;
+            }
+            if (!reader.skip(length + (length & 1))) break;
+        }
+        if (!haveData) {
+            Serial.println("Audio: WAV without data");
+            return playFallbackTone(currentPlayback.category);
+        }
+        if (!haveFormat || channels < 1 || channels > 2 || (bits != 8 && bits != 16) ||
+            rate < 4000 || rate > 48000) {
+            Serial.printf("Audio: unsupported WAV (%d channels, %d bits, %u Hz)\n", channels, bits, rate);
+            return playFallbackTone(currentPlayback.category);
+        }
+    } else if (file) {
+        Serial.println("Audio: not a WAV file");
+        return playFallbackTone(currentPlayback.category);
+    } else {
+        // Raw 16-bit mono PCM at the output rate
+        reader.position = 0;
+        dataBytes = size;
+    }
+
+    startResampling(rate);
+    int frameBytes = channels * bits / 8;
+    size_t blockBytes = READ_BLOCK - READ_BLOCK % frameBytes;
+
+    while (dataBytes > 0) {
+        size_t want = min((size_t)dataBytes, blockBytes);
+        got = reader.read(block, want);
+        got -= got % frameBytes;
+        if (got == 0) break;
+        dataBytes -= got;
+
+        for (size_t i = 0; i < got; i += frameBytes) {
+            // Downmix to mono
+            int32_t sum = 0;
+            for (int c = 0; c < channels; c++) {
+                const uint8_t* p = block + i + c * (bits / 8);
+                sum += bits == 16 ? (int16_t)readLe16(p) : ((int)p[0] - 128) << 8;
+            }
+            if (!emitResampled(sum / channels)) return false;
+        }
+    }
+    return true;
+}
+
+bool AudioManager::playToneSamples(int frequency, int duration, int count) {
+    int samples = duration * AUDIO_SAMPLE_RATE / 1000;
+    int fade = min(TONE_FADE_MS * AUDIO_SAMPLE_RATE / 1000, samples / 2);
+    int gap = TONE_GAP_MS * AUDIO_SAMPLE_RATE / 1000;
+    float phaseStep = 2.0f * (float)M_PI * frequency / AUDIO_SAMPLE_RATE;
+
+    for (int beep = 0; beep < count; beep++) {
+        if (beep > 0) {
+            for (int i = 0; i < gap; i++) {
+                if (!emit(0)) return false;
+            }
+        }
+        float phase = 0;
+        for (int i = 0; i < samples; i++) {
+            float level = TONE_AMPLITUDE;
+            if (i < fade) level = level * i / fade;
+            else if (i >= samples - fade) level = level * (samples - i) / fade;
+            if (!emit((int16_t)(level * sinf(phase)))) return false;
+            phase += phaseStep;
+            if (phase > 2.0f * (float)M_PI) phase -= 2.0f * (float)M_PI;
+        }
+    }
+    return true;
+}
+
+bool AudioManager::playFallbackTone(AudioCategory category) {
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    stats.fallbacks++;
+    xSemaphoreGive(queueLock);
+
+    switch (category) {
+        case AUDIO_HAZARD: return playToneSamples(1200, 100, 3);
+        case AUDIO_ERROR: return playToneSamples(300, 300, 1);
+        default: return playToneSamples(880, 120, 1);
+    }
+}
+
+bool AudioManager::playMp3(const uint8_t* data, size_t size, File* file) {
+    if (!mp3Decoder.begin()) {
+        Serial.println("Audio: no memory for the MP3 decoder");
+        return playFallbackTone(currentPlayback.category);
+    }
+    ClipReader reader = { data, size, 0, file };
+    uint8_t block[READ_BLOCK];
+    bool eof = false;
+    bool completed = true;
+
+    while (true) {
+        if (!eof && mp3Decoder.space() >= sizeof(block)) {
+            size_t got = reader.read(block, sizeof(block));
+            mp3Decoder.feed(block, got);
+            if (got < sizeof(block)) {
+                eof = true;
+                mp3Decoder.finish();
+            }
+        }
+        int frames = mp3Decoder.decodeFrame();
+        if (frames > 0) {
+            if (mp3Decoder.framesDecoded() == 1) startResampling(mp3Decoder.getFormat().sampleRate);
+            if (!emitFrames(mp3Decoder.samples(), frames, mp3Decoder.getFormat().channels)) {
+                completed = false;
+                break;
+            }
+        } else if (eof) {
+            break;
+        }
+    }
+
+    uint32_t decoded = mp3Decoder.framesDecoded();
+    mp3Decoder.end();
+    if (completed && decoded == 0) {
+        Serial.println("Audio: no MP3 frames in clip");
+        return playFallbackTone(currentPlayback.category);
+    }
+    return completed;
+}
+
+uint32_t AudioManager::streamPrebufferMillis(uint32_t bitrate, float linkBytesPerSecond, long remainingBytes,
+                                             unsigned long gapMillis) {
+    // With the link at least as fast as the audio, only its stalls need
+    // covering, with the same margin as its rate. Otherwise the buffer must
+    // also make up the shortfall over the rest of the clip: the last byte has
+    // to arrive before it is due to play.
+    uint32_t jitter = max((uint32_t)AUDIO_STREAM_MIN_PREBUFFER, (uint32_t)(gapMillis / AUDIO_STREAM_LINK_MARGIN));
+    float audioBytesPerSecond = bitrate / 8.0f;
+    float usable = linkBytesPerSecond * AUDIO_STREAM_LINK_MARGIN;
+    if (usable >= audioBytesPerSecond) return jitter;
+
+    float remainingMillis = remainingBytes >= 0 ? remainingBytes * 1000.0f / audioBytesPerSecond
+                                                : AUDIO_STREAM_ASSUMED_LENGTH;
+    float needed = remainingMillis * (audioBytesPerSecond / usable - 1);
+    return max(jitter, (uint32_t)needed);
+}
+
+bool AudioManager::playCloudClip(AudioPlayback& playback) {
+    // A clip heard before plays from flash, without touching the network
+    File file;
+    if (playback.cacheKey != 0 && clipCache.open(playback.cacheKey, &file)) {
+        bool completed = playMp3(nullptr, 0, &file);
+        file.close();
+        return completed;
+    }
+    if (playback.type == AUDIO_RESPONSE_STREAM) {
+        return streamMp3(*playback.stream, playback.dataSize, playback.startTime, playback.cacheKey);
+    }
+    return downloadAndPlayCloudAudio(playback.url, playback.cacheKey);
+}
+
+bool AudioManager::downloadAndPlayCloudAudio(const String& audioUrl, uint64_t cacheKey) {
+    unsigned long requestStart = millis();
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    streamStats.requests++;
+    xSemaphoreGive(queueLock);
+
+    HTTPClient http;
+    http.begin(audioUrl);
+    http.setTimeout(AUDIO_STREAM_STALL_TIMEOUT);
+    int code = http.GET();
+    if (code != 200) {
+        Serial.printf("Audio: stream request failed (%d)\n", code);
+        http.end();
+        xSemaphoreTake(queueLock, portMAX_DELAY);
+        streamStats.failed++;
+        xSemaphoreGive(queueLock);
+        return playFallbackTone(currentPlayback.category);
+    }
+    // -1 when the server does not say
+    return streamMp3(http, http.getSize(), requestStart, cacheKey);
+}
+
+bool AudioManager::streamMp3(HTTPClient& http, long length, unsigned long requestStart, uint64_t cacheKey) {
+    AudioOutputStats outputBefore = audioOutput.getStats();
+    if (!mp3Decoder.begin()) {
+        Serial.println("Audio: no memory for the MP3 decoder");
+        http.end();
+        return playFallbackTone(currentPlayback.category);
+    }
+    Client* stream = http.getStreamPtr();
+
+    uint8_t block[READ_BLOCK];
+    size_t received = 0;
+    size_t firstRead = 0;
+    unsigned long firstByte = 0;
+    unsigned long lastByte = millis();
+    unsigned long longestGap = 0;
+    uint32_t underrunsSeen = outputBefore.underruns;
+    uint32_t prebuffer = UINT32_MAX;    // Until the link rate is known
+    uint32_t prebuffered = 0;
+    uint32_t rebuffers = 0;
+    bool eof = false;
+    bool stalled = false;
+    bool playing = false;
+    bool completed = true;
+    bool capturing = cacheKey != 0 && clipCache.beginCapture(cacheKey, length);
+
+    while (true) {
+        if (abortPlayback.load() || !isInitialized) {
+            completed = false;
+            break;
+        }
+        bool busy = false;
+
+        // Take whatever the link has delivered
+        if (!eof) {
+            int available = stream ? stream->available() : 0;
+            size_t want = min((size_t)max(available, 0), min(mp3Decoder.space(), sizeof(block)));
+            if (want > 0) {
+                int got = stream->read(block, want);
+                if (got > 0) {
+                    mp3Decoder.feed(block, got);
+                    if (capturing) clipCache.capture(block, got);
+                    received += got;
+                    unsigned long now = millis();
+                    if (firstByte == 0) {
+                        firstByte = now;
+                        firstRead = got;
+                    } else if (now - lastByte > longestGap) {
+                        longestGap = now - lastByte;
+                    }
+                    lastByte = now;
+                    busy = true;
+                }
+            }
+            if ((length >= 0 && received >= (size_t)length) || (available <= 0 && !http.connected())) {
+                eof = true;
+            } else if (millis() - lastByte > AUDIO_STREAM_STALL_TIMEOUT) {
+                Serial.println("Audio: stream stalled");
+                eof = true;
+                stalled = true;
+            }
+            if (eof) mp3Decoder.finish();
+        }
+
+        // Hold playback until the buffer covers what the link cannot keep up with
+        if (!playing) {
+            if (mp3Decoder.readFormat()) {
+                // The first read returns whatever piled up during the request,
+                // so it says nothing about the rate
+                unsigned long elapsed = millis() - firstByte;
+                float rate = elapsed >= STREAM_RATE_WINDOW_MS ? (received - firstRead) * 1000.0f / elapsed
+                                                              : downlinkBytesPerSecond;
+                long remaining = length >= 0 ? length - (long)received : -1;
+                if (rate > 0) {
+                    prebuffer = streamPrebufferMillis(mp3Decoder.getFormat().bitrate, rate, remaining,
+                                                      max(longestGap, downlinkGapMillis));
+                }
+            }
+            playing = eof || mp3Decoder.space() < sizeof(block) ||
+                      (mp3Decoder.readFormat() && mp3Decoder.bufferedMillis() >= prebuffer);
+            if (playing && prebuffered == 0) prebuffered = mp3Decoder.bufferedMillis();
+        }
+
+        // Decode while the ring has room for a whole frame
+        if (playing && audioOutput.freeSamples() >= STREAM_FRAME_ROOM) {
+            int frames = mp3Decoder.decodeFrame();
+            if (frames > 0) {
+                if (mp3Decoder.framesDecoded() == 1) startResampling(mp3Decoder.getFormat().sampleRate);
+                if (!emitFrames(mp3Decoder.samples(), frames, mp3Decoder.getFormat().channels) || !flushChunk()) {
+                    completed = false;
+                    break;
+                }
+                busy = true;
+            } else if (eof) {
+                break;
+            } else if (audioOutput.getStats().underruns != underrunsSeen) {
+                // The output ran dry: refill the buffer rather than stutter
+                underrunsSeen = audioOutput.getStats().underruns;
+                playing = false;
+                rebuffers++;
+            }
+        }
+        if (!busy) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(STREAM_POLL_MS));
+    }
+    http.end();
+    // Written while the tail still plays from the ring
+    if (capturing) clipCache.endCapture(completed && eof && !stalled && (length < 0 || received == (size_t)length));
+
+    uint32_t decoded = mp3Decoder.framesDecoded();
+    mp3Decoder.end();
+    if (lastByte > firstByte && firstByte > 0 && eof) {
+        float rate = received * 1000.0f / (lastByte - firstByte);
+        downlinkBytesPerSecond = downlinkBytesPerSecond > 0 ? downlinkBytesPerSecond * 0.7f + rate * 0.3f : rate;
+        // Stalls are remembered at their worst and forgotten slowly
+        downlinkGapMillis = max(longestGap, downlinkGapMillis * 7 / 10);
+    }
+    if (decoded == 0) {
+        if (!completed) return false;
+        Serial.println("Audio: no MP3 frames in stream");
+        xSemaphoreTake(queueLock, portMAX_DELAY);
+        streamStats.failed++;
+        xSemaphoreGive(queueLock);
+        return playFallbackTone(currentPlayback.category);
+    }
+
+    // Output stats tell when the first samples reached the DMA; counted from
+    // requestStart (the GET, or the queueing of audio that followed a result)
+    AudioOutputStats outputAfter = audioOutput.getStats();
+    unsigned long firstAudio = outputAfter.streams > outputBefore.streams
+                             ? outputAfter.lastFirstSamplesMillis - requestStart : 0;
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    streamStats.streams++;
+    streamStats.bytes += received;
+    streamStats.rebuffers += rebuffers;
+    streamStats.underruns += outputAfter.underruns - outputBefore.underruns;
+    streamStats.totalFirstAudioMillis += firstAudio;
+    streamStats.lastFirstAudioMillis = firstAudio;
+    if (firstAudio > streamStats.maxFirstAudioMillis) streamStats.maxFirstAudioMillis = firstAudio;
+    streamStats.totalDownloadMillis += lastByte - requestStart;
+    streamStats.totalPrebufferMillis += prebuffered;
+    xSemaphoreGive(queueLock);
+
+    Serial.printf("Audio: streamed %u bytes, first audio after %lu ms (download took %lu ms), %u ms buffered first, %u rebuffers\n",
+                  (unsigned)received, firstAudio, lastByte - requestStart, prebuffered, rebuffers);
+    return completed;
+}
+
+bool AudioManager::playLocalMP3(const String& filename, AudioCategory category, bool priority) {
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, category, priority);
+    playback.filename = filename;
+    return addToQueue(playback);
+}
+
+bool AudioManager::playLocalSequence(const String& filenames, AudioCategory category, bool priority) {
+    return playLocalMP3(filenames, category, priority);
+}
+
+bool AudioManager::loadLocalAudioFiles() {
+    if (!hasFilesystem) return false;
+    listAvailableAudioFiles();
+    return true;
+}
+
+bool AudioManager::playCloudAudio(const String& audioUrl, AudioCategory category, bool priority, uint64_t cacheKey) {
+    AudioPlayback playback = makePlayback(AUDIO_CLOUD_STREAM, category, priority);
+    playback.url = audioUrl;
+    playback.cacheKey = cacheKey;
+    return addToQueue(playback);
+}
+
+bool AudioManager::playAudioData(uint8_t* audioData, size_t dataSize, AudioCategory category, bool priority,
+                                 uint64_t cacheKey) {
+    if (!audioData || dataSize == 0) return false;
+    AudioPlayback playback = makePlayback(AUDIO_MEMORY_DATA, category, priority);
+    playback.audioData = audioData;
+    playback.dataSize = dataSize;
+    playback.cacheKey = cacheKey;
+    return addToQueue(playback);
+}
+
+bool AudioManager::playAudioStream(HTTPClient* stream, size_t size, AudioCategory category, bool priority,
+                                   uint64_t cacheKey) {
+    if (!stream) return false;
+    AudioPlayback playback = makePlayback(AUDIO_RESPONSE_STREAM, category, priority);
+    playback.stream = stream;
+    playback.dataSize = size;
+    playback.cacheKey = cacheKey;
+    if (!isInitialized) {
+        releasePlayback(playback);
+        return false;
+    }
+    // A dropped clip's connection is closed there
+    return addToQueue(playback);
+}
+
+bool AudioManager::playTone(int frequency, int duration, int count, AudioCategory category, bool priority) {
+    AudioPlayback playback = makePlayback(AUDIO_SIMPLE_TONE, category, priority);
+    playback.toneFrequency = frequency;
+    playback.toneMillis = duration;
+    playback.toneCount = count;
+    return addToQueue(playback);
+}
+
+void AudioManager::playSystemAudio(const String& audioName) {
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, AUDIO_SYSTEM, false);
+    playback.filename = audioName + ".wav";
+    addToQueue(playback);
 }
 
 void AudioManager::playHazardAlert(const String& hazardType, const String& direction) {
-    Serial.printf("Playing hazard alert: %s (direction: %s)\n", 
-                  hazardType.c_str(), direction.c_str());
-    currentPlayback.category = AUDIO_HAZARD;
+    Serial.printf("Playing hazard alert: %s (direction: %s)\n", hazardType.c_str(), direction.c_str());
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, AUDIO_HAZARD, true);
+    playback.filename = getHazardAudioFile(hazardType, direction);
+    addToQueue(playback);
+}
+
+void AudioManager::playModeChangeConfirmation(const String& modeName) {
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, AUDIO_SYSTEM, false);
+    playback.filename = getModeAudioFile(modeName);
+    addToQueue(playback);
+}
+
+void AudioManager::playSystemStatus(const String& statusMessage) {
+    Serial.printf("Status: %s\n", statusMessage.c_str());
+    playTone(660, 80, 2, AUDIO_STATUS);
+}
+
+void AudioManager::playErrorSound(const String& errorType) {
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, AUDIO_ERROR, false);
+    playback.filename = "error_" + errorType + ".wav";
+    if (!checkLocalAudioFile(playback.filename)) playback.filename = "error.wav";
+    addToQueue(playback);
+}
+
+void AudioManager::playSuccessSound() {
+    playTone(1320, 80, 1, AUDIO_SYSTEM);
+}
+
+void AudioManager::playProcessingSound() {
+    AudioPlayback playback = makePlayback(AUDIO_LOCAL_MP3, AUDIO_SYSTEM, false);
+    playback.filename = "processing.wav";
+    addToQueue(playback);
+}
+
+void AudioManager::update() {
+    // Playback runs on its own task; nothing to poll
+}
+
+void AudioManager::stopCurrentAudio() {
+    if (!isInitialized) return;
+    abortPlayback.store(true);
+    audioOutput.flush();
+}
+
+void AudioManager::stopAllAudio() {
+    clearQueue();
+    stopCurrentAudio();
+}
+
+void AudioManager::pauseAudio() {
+    paused.store(true);
+    audioOutput.setPaused(true);
+}
+
+void AudioManager::resumeAudio() {
+    paused.store(false);
+    audioOutput.setPaused(false);
+}
+
+void AudioManager::setGlobalVolume(int volume) {
+    globalVolume = constrain(volume, 0, 100);
+    if (!muteState) audioOutput.setVolume(globalVolume);
+}
+
+void AudioManager::setMute(bool mute) {
+    muteState = mute;
+    audioOutput.setVolume(mute ? 0 : globalVolume);
+}
+
+int AudioManager::getGlobalVolume() {
+    return globalVolume;
+}
+
+bool AudioManager::isMuted() {
+    return muteState;
+}
+
+bool AudioManager::queueAudio(const AudioPlayback& playback) {
+    return addToQueue(playback);
+}
+
+bool AudioManager::addToQueue(const AudioPlayback& playback) {
+    if (!isInitialized) return false;
+
+    AudioPlayback entry = playback;
+    entry.isPlaying = false;
+    entry.startTime = millis();
+    if (playback.audioData) {
+        // The queue keeps its own copy, so the caller's buffer can go
+        entry.audioData = (uint8_t*)(psramFound() ? ps_malloc(playback.dataSize) : malloc(playback.dataSize));
+        if (!entry.audioData) {
+            Serial.println("Audio: no memory for clip");
+            return false;
+        }
+        memcpy(entry.audioData, playback.audioData, playback.dataSize);
+    }
+
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    if (queueCount == AUDIO_QUEUE_SIZE) {
+        // Full: a priority clip pushes out the newest ordinary one
+        int victim = -1;
+        if (entry.priority) {
+            for (int i = queueCount - 1; i >= 0 && victim < 0; i--) {
+                if (!audioQueue[i].priority) victim = i;
+            }
+        }
+        if (victim < 0) {
+            stats.dropped++;
+            xSemaphoreGive(queueLock);
+            Serial.printf("Audio: queue full, dropping %s clip\n", categoryName(entry.category));
+            releasePlayback(entry);
+            return false;
+        }
+        releasePlayback(audioQueue[victim]);
+        for (int i = victim; i < queueCount - 1; i++) audioQueue[i] = audioQueue[i + 1];
+        queueCount--;
+        stats.dropped++;
+    }
+
+    // Priority clips go ahead of all ordinary ones
+    int index = queueCount;
+    if (entry.priority) {
+        index = 0;
+        while (index < queueCount && audioQueue[index].priority) index++;
+    }
+    for (int i = queueCount; i > index; i--) audioQueue[i] = audioQueue[i - 1];
+    audioQueue[index] = entry;
+    queueCount++;
+    stats.queued++;
+
+    if (entry.priority && isPlaying && !currentPlayback.priority) {
+        abortPlayback.store(true);
+    }
+    xSemaphoreGive(queueLock);
+
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+    return true;
+}
+
+bool AudioManager::getNextFromQueue(AudioPlayback* playback) {
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    if (queueCount == 0) {
+        xSemaphoreGive(queueLock);
+        return false;
+    }
+    *playback = audioQueue[0];
+    audioQueue[0].audioData = nullptr;  // Ownership moves to the caller
+    audioQueue[0].stream = nullptr;
+    removeFromQueue();
+
+    // Becomes the current clip; a stop from here on applies to it
+    playback->isPlaying = true;
+    currentPlayback = *playback;
+    currentPlayback.audioData = nullptr;
+    currentPlayback.stream = nullptr;
     isPlaying = true;
-    
-    // TODO: Implement hazard alert audio
-    delay(200); // Simulate alert sound
-    isPlaying = false;
+    abortPlayback.store(false);
+    xSemaphoreGive(queueLock);
+    return true;
+}
+
+void AudioManager::removeFromQueue() {
+    // Caller holds queueLock
+    if (queueCount == 0) return;
+    releasePlayback(audioQueue[0]);
+    for (int i = 0; i < queueCount - 1; i++) audioQueue[i] = audioQueue[i + 1];
+    queueCount--;
+    audioQueue[queueCount] = makePlayback(AUDIO_SIMPLE_TONE, AUDIO_SYSTEM, false);
+}
+
+void AudioManager::releasePlayback(AudioPlayback& playback) {
+    free(playback.audioData);
+    playback.audioData = nullptr;
+    if (playback.stream) {
+        playback.stream->end();
+        delete playback.stream;
+        playback.stream = nullptr;
+    }
+    playback.dataSize = 0;
+}
+
+void AudioManager::clearQueue() {
+    if (!queueLock) return;
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    while (queueCount > 0) removeFromQueue();
+    xSemaphoreGive(queueLock);
+}
+
+bool AudioManager::hasQueuedAudio() {
+    return queueCount > 0;
 }
 
 bool AudioManager::isCurrentlyPlaying() {
-    return isPlaying;
+    return isPlaying || audioOutput.bufferedSamples() > 0;
 }
 
 AudioCategory AudioManager::getCurrentCategory() {
     return currentPlayback.category;
-}
\ No newline at end of file
+}
+
+String AudioManager::getCurrentAudioInfo() {
+    if (!isInitialized) return "Audio off";
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    String info = "Idle";
+    if (isPlaying) {
+        info = String(categoryName(currentPlayback.category)) + ": ";
+        info += currentPlayback.type == AUDIO_CLOUD_STREAM ? currentPlayback.url : currentPlayback.filename;
+        info += " (" + String(millis() - currentPlayback.startTime) + " ms since queued)";
+    }
+    info += ", " + String(queueCount) + " queued";
+    xSemaphoreGive(queueLock);
+    return info;
+}
+
+bool AudioManager::checkLocalAudioFile(const String& filename) {
+    return hasFilesystem && LittleFS.exists(getAudioFilePath(filename));
+}
+
+void AudioManager::listAvailableAudioFiles() {
+    File dir = LittleFS.open(AUDIO_DIR);
+    if (!dir || !dir.isDirectory()) {
+        Serial.println("Audio: no " AUDIO_DIR " directory");
+        return;
+    }
+    int count = 0;
+    for (File file = dir.openNextFile(); file; file = dir.openNextFile()) {
+        Serial.printf("  %s (%u bytes)\n", file.name(), (unsigned)file.size());
+        count++;
+    }
+    Serial.printf("Audio: %d clips in " AUDIO_DIR "\n", count);
+}
+
+String AudioManager::getAudioFilePath(const String& filename) {
+    return filename.startsWith("/") ? filename : String(AUDIO_DIR) + filename;
+}
+
+String AudioManager::getHazardAudioFile(const String& hazardType, const String& direction) {
+    String type = hazardType;
+    type.toLowerCase();
+    if (type.indexOf("stair") >= 0) return "hazard_stairs.wav";
+    if (type.indexOf("hole") >= 0 || type.indexOf("gap") >= 0) return "hazard_hole.wav";
+    if (direction == "left" || direction == "right" || direction == "front") {
+        return "hazard_" + direction + ".wav";
+    }
+    return "hazard_general.wav";
+}
+
+String AudioManager::getModeAudioFile(const String& modeName) {
+    String name = modeName;
+    name.toLowerCase();
+    name.replace(" ", "_");
+    return name.endsWith("_mode") ? name + ".wav" : name + "_mode.wav";
+}
+
+AudioManagerStats AudioManager::getStats() {
+    AudioManagerStats snapshot;
+    if (!queueLock) return stats;
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    snapshot = stats;
+    xSemaphoreGive(queueLock);
+    return snapshot;
+}
+
+AudioStreamStats AudioManager::getStreamStats() {
+    AudioStreamStats snapshot;
+    if (!queueLock) return streamStats;
+    xSemaphoreTake(queueLock, portMAX_DELAY);
+    snapshot = streamStats;
+    xSemaphoreGive(queueLock);
+    return snapshot;
+}
+
+void AudioManager::logStats() {
+    AudioManagerStats s = getStats();
+    if (s.queued == 0) return;
+    Serial.printf("Audio: %u clips queued, %u played, %u interrupted, %u dropped, %u tone fallbacks, "
+                  "max queue-to-output wait %lu ms\n",
+                  s.queued, s.played, s.interrupted, s.dropped, s.fallbacks, s.maxQueueMillis);
+
+    AudioStreamStats st = getStreamStats();
+    if (st.streams == 0 && st.failed == 0) return;
+    unsigned long avgFirst = st.streams > 0 ? (unsigned long)(st.totalFirstAudioMillis / st.streams) : 0;
+    unsigned long avgDownload = st.streams > 0 ? (unsigned long)(st.totalDownloadMillis / st.streams) : 0;
+    unsigned long avgPrebuffer = st.streams > 0 ? (unsigned long)(st.totalPrebufferMillis / st.streams) : 0;
+    Serial.printf("Audio streams: %u played (%u fetched by URL), %u failed, %llu bytes, downlink %.0f bytes/s; first audio avg %lu ms "
+                  "(last %lu, max %lu) vs %lu ms to download; %lu ms buffered first, %u rebuffers, %u underruns\n",
+                  st.streams, st.requests, st.failed, (unsigned long long)st.bytes, downlinkBytesPerSecond, avgFirst,
+                  st.lastFirstAudioMillis, st.maxFirstAudioMillis, avgDownload, avgPrebuffer, st.rebuffers, st.underruns);
+}
@@ -2,18 +2,25 @@
 #define AUDIO_MANAGER_H
 
 #include <Arduino.h>
+#include <FS.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "intel_glasses_config.h"
+#include "audio_output.h"
+#include "mp3_stream.h"
+#include "clip_cache.h"
 
-// ESP32 native audio support using I2S
-// Will use ESP32's built-in I2S capabilities for audio output
-#include "driver/i2s.h"
-#include "esp_system.h"
+class HTTPClient;
 
 // Audio file types
 enum AudioType {
-    AUDIO_LOCAL_MP3,      // Local MP3 files stored in SPIFFS/SD
+    AUDIO_LOCAL_MP3,      // Local clips on LittleFS (WAV or MP3)
     AUDIO_CLOUD_STREAM,   // Audio stream from cloud API
-    AUDIO_SIMPLE_TONE     // Simple buzzer tones
+    AUDIO_SIMPLE_TONE,    // Synthesized beeps
+    AUDIO_MEMORY_DATA,    // WAV or raw 16-bit PCM already in memory
+    AUDIO_RESPONSE_STREAM // MP3 following an API result on the same connection
 };
 
 // Audio feedback categories
@@ -31,56 +38,122 @@ enum AudioCategory {
 struct AudioPlayback {
     AudioType type;
     AudioCategory category;
-    String filename;      // For local MP3 files
+    String filename;      // For local files
     String url;          // For cloud audio streams
-    uint8_t* audioData;  // For in-memory audio data
+    uint8_t* audioData;  // For in-memory audio data; owned by the queue once queued
+    HTTPClient* stream;  // For audio following an API result; owned by the queue once queued
+    uint64_t cacheKey;   // clipCache key of cloud audio, 0 when not cacheable
     size_t dataSize;     // Size of audio data
     bool isPlaying;
     bool priority;       // High priority audio interrupts lower priority
-    unsigned long startTime;
+    unsigned long startTime; // When queued
     int volume;          // 0-100
+    uint16_t toneFrequency; // For tones (Hz)
+    uint16_t toneMillis;
+    uint8_t toneCount;      // Beeps, 80 ms apart
 };
 
+struct AudioManagerStats {
+    uint32_t queued;
+    uint32_t played;          // Clips played to the end
+    uint32_t interrupted;     // Cut short by priority audio or a stop
+    uint32_t dropped;         // Queue full
+    uint32_t fallbacks;       // Clips missing or undecodable, played as a tone
+    unsigned long maxQueueMillis; // Longest wait from queueing to the first sample written
+};
+
+struct AudioStreamStats {
+    uint32_t requests;            // Audio URLs fetched
+    uint32_t streams;             // Cloud clips that played
+    uint32_t failed;              // Request failed or nothing decodable came
+    uint64_t bytes;
+    uint32_t rebuffers;           // Playback waited for the jitter buffer to refill
+    uint32_t underruns;           // Output underruns during streams
+    uint64_t totalFirstAudioMillis; // Request to first samples at the DMA
+    unsigned long lastFirstAudioMillis;
+    unsigned long maxFirstAudioMillis;
+    uint64_t totalDownloadMillis; // Request to last byte, when fetch-then-play would have started
+    uint64_t totalPrebufferMillis; // Audio buffered before playback started
+};
+
+// Playback front end. Every play call only queues the clip and returns; a
+// playback task pinned to AUDIO_OUTPUT_CORE takes clips off the queue, decodes
+// them (WAV, MP3, raw PCM or synthesized tones), resamples to AUDIO_SAMPLE_RATE
+// and writes the PCM into audioOutput's ring. Cloud audio is decoded as it
+// downloads; playback starts once the jitter buffer holds enough for the
+// measured link rate and stalls to keep up with the rest of the clip. Cloud
+// clips with a cache key play from clipCache when heard before.
+// Priority clips go to the head of the queue and cut a non-priority clip short.
 class AudioManager {
 private:
-    // Simplified implementation - will be replaced with full audio support later
-    bool isInitialized;
-    bool isPlaying;
+    volatile bool isInitialized;
+    volatile bool isPlaying;
+    bool hasFilesystem;
     bool muteState;
     int globalVolume;
-    
+    TaskHandle_t taskHandle;
+    SemaphoreHandle_t queueLock;      // Guards the queue, currentPlayback and stats
+    std::atomic<bool> abortPlayback;  // Stop the clip being played
+    std::atomic<bool> paused;
+
     // Current playback
     AudioPlayback currentPlayback;
-    
-    // Audio queue for managing multiple audio requests
-    static const int AUDIO_QUEUE_SIZE = 5;
+    bool lastPriority;                // Priority of the clip played last
+
+    // Audio queue for managing multiple audio requests; priority clips first,
+    // then arrival order
     AudioPlayback audioQueue[AUDIO_QUEUE_SIZE];
-    int queueHead;
-    int queueTail;
     int queueCount;
-    
-    // I2S audio output pins
-    int i2s_bclk_pin;
-    int i2s_lrc_pin;
-    int i2s_dout_pin;
-    
+
+    // Decoded samples waiting to be written
+    int16_t chunk[AUDIO_CHUNK_SAMPLES];
+    size_t chunkCount;
+    int clipVolume;
+    bool firstWritten;
+
+    // Linear resampling of the clip to AUDIO_SAMPLE_RATE. The position is the
+    // output time past the previous input sample, in 1/AUDIO_SAMPLE_RATE of an
+    // input sample.
+    uint32_t clipRate;
+    uint32_t resamplePosition;
+    int16_t resamplePrevious;
+    bool resamplePrimed;
+
+    // MP3 decoding and cloud streaming
+    Mp3StreamDecoder mp3Decoder;
+    float downlinkBytesPerSecond;     // Learned from past streams, 0 until the first
+    unsigned long downlinkGapMillis;  // Longest recent wait between reads
+    AudioStreamStats streamStats;
+
+    AudioManagerStats stats;
+
 public:
     AudioManager();
     ~AudioManager();
-    
+
     // Initialization and configuration
     bool initialize();
     void deinitialize();
     bool setupI2SAudio();
-    
-    // Local MP3 file playback
+
+    // Local file playback
     bool playLocalMP3(const String& filename, AudioCategory category, bool priority = false);
+    // Comma-separated clips ("digit_4.mp3,digit_2.mp3") played back to back as one queue entry
+    bool playLocalSequence(const String& filenames, AudioCategory category, bool priority = false);
     bool loadLocalAudioFiles();
-    
-    // Cloud audio stream playback
-    bool playCloudAudio(const String& audioUrl, AudioCategory category, bool priority = false);
-    bool playAudioData(uint8_t* audioData, size_t dataSize, AudioCategory category, bool priority = false);
-    
+
+    // Cloud audio stream playback; with a cacheKey (ClipCache::keyFor) a clip
+    // heard before plays from flash instead
+    bool playCloudAudio(const String& audioUrl, AudioCategory category, bool priority = false, uint64_t cacheKey = 0);
+    // Copies the data, so the caller may free it on return
+    // cacheKey: clipCache key when the data is a cloud clip worth keeping, as for streams
+    bool playAudioData(uint8_t* audioData, size_t dataSize, AudioCategory category, bool priority = false,
+                       uint64_t cacheKey = 0);
+    // Takes the connection, read up to its audio, and closes it once played
+    bool playAudioStream(HTTPClient* stream, size_t size, AudioCategory category, bool priority = false,
+                         uint64_t cacheKey = 0);
+    bool playTone(int frequency, int duration, int count, AudioCategory category, bool priority = false);
+
     // System audio feedback
     void playSystemAudio(const String& audioName);  // Generic system audio method
     void playHazardAlert(const String& hazardType, const String& direction = "");
@@ -89,49 +162,71 @@ public:
     void playErrorSound(const String& errorType);
     void playSuccessSound();
     void playProcessingSound();
-    
+
     // Playback control
     void update();
     void stopCurrentAudio();
     void stopAllAudio();
     void pauseAudio();
     void resumeAudio();
-    
+
     // Volume and settings
     void setGlobalVolume(int volume);     // 0-100
     void setMute(bool mute);
     int getGlobalVolume();
     bool isMuted();
-    
+
     // Queue management
     bool queueAudio(const AudioPlayback& playback);
     void clearQueue();
     bool hasQueuedAudio();
-    
+
     // Status
     bool isCurrentlyPlaying();
     AudioCategory getCurrentCategory();
     String getCurrentAudioInfo();
-    
+
     // Audio file management
     bool checkLocalAudioFile(const String& filename);
     void listAvailableAudioFiles();
-    
+
+    // Statistics
+    AudioManagerStats getStats();
+    AudioStreamStats getStreamStats();
+    void logStats();
+
 private:
+    static void playbackTask(void* param);
+    void runLoop();
     bool playAudioFromQueue();
     bool addToQueue(const AudioPlayback& playback);
-    AudioPlayback getNextFromQueue();
+    bool getNextFromQueue(AudioPlayback* playback);
     void removeFromQueue();
-    
+    void releasePlayback(AudioPlayback& playback);
+
     String getAudioFilePath(const String& filename);
-    String getHazardAudioFile(const String& hazardType);
+    String getHazardAudioFile(const String& hazardType, const String& direction);
     String getModeAudioFile(const String& modeName);
-    
-    bool downloadAndPlayCloudAudio(const String& audioUrl);
-    void handleAudioFinished();
-    
-    // Audio processing callbacks
-    static void audioEndCallback(void* userData);
+
+    // Decoders; false when the clip was cut short
+    bool playFile(const AudioPlayback& playback);
+    bool playWav(const uint8_t* data, size_t size, File* file);
+    bool playMp3(const uint8_t* data, size_t size, File* file);
+    bool playToneSamples(int frequency, int duration, int count);
+    bool playFallbackTone(AudioCategory category);
+    bool playCloudClip(AudioPlayback& playback);
+    bool downloadAndPlayCloudAudio(const String& audioUrl, uint64_t cacheKey);
+    bool streamMp3(HTTPClient& http, long length, unsigned long requestStart, uint64_t cacheKey);
+    uint32_t streamPrebufferMillis(uint32_t bitrate, float linkBytesPerSecond, long remainingBytes,
+                                   unsigned long gapMillis);
+
+    // Queue samples for audioOutput; false once the clip should stop
+    void startResampling(uint32_t rate);
+    bool emitFrames(const int16_t* pcm, int frames, int channels);
+    bool emitResampled(int16_t sample);
+    bool emit(int16_t sample);
+    bool flushChunk();
+    void handleAudioFinished(bool completed);
 };
 
 // Global audio manager instance
@@ -0,0 +1,367 @@
+#include "audio_output.h"
+#include "driver/i2s.h"
+#include <cstring>
+
+AudioOutput audioOutput;
+
+// Task configuration
+static const uint32_t OUTPUT_TASK_STACK = 3072;
+
+// Producer wait for ring space, and how long an interruption waits for the flush
+static const uint32_t SPACE_WAIT_MS = 10;
+static const uint32_t FLUSH_WAIT_MS = 100;
+
+PcmRingBuffer::PcmRingBuffer() : samples(nullptr), capacity(0), head(0), tail(0) {
+}
+
+PcmRingBuffer::~PcmRingBuffer() {
+    release();
+}
+
+bool PcmRingBuffer::allocate(uint32_t capacitySamples) {
+    if ((capacitySamples & (capacitySamples - 1)) != 0) return false;
+    release();
+    // Internal RAM: the output task reads it every few milliseconds
+    samples = (int16_t*)malloc(capacitySamples * sizeof(int16_t));
+    if (!samples) return false;
+    capacity = capacitySamples;
+    head.store(0);
+    tail.store(0);
+    return true;
+}
+
+void PcmRingBuffer::release() {
+    free(samples);
+    samples = nullptr;
+    capacity = 0;
+}
+
+size_t PcmRingBuffer::write(const int16_t* data, size_t count) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    uint32_t t = tail.load(std::memory_order_acquire);
+    count = min(count, (size_t)(capacity - (h - t)));
+    size_t first = min(count, (size_t)(capacity - (h & (capacity - 1))));
+    memcpy(samples + (h & (capacity - 1)), data, first * sizeof(int16_t));
+    memcpy(samples, data + first, (count - first) * sizeof(int16_t));
+    head.store(h + count, std::memory_order_release);
+    return count;
+}
+
+size_t PcmRingBuffer::space() {
+    return capacity - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+}
+
+size_t PcmRingBuffer::read(int16_t* data, size_t count) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    count = min(count, (size_t)(h - t));
+    size_t first = min(count, (size_t)(capacity - (t & (capacity - 1))));
+    memcpy(data, samples + (t & (capacity - 1)), first * sizeof(int16_t));
+    memcpy(data + first, samples, (count - first) * sizeof(int16_t));
+    tail.store(t + count, std::memory_order_release);
+    return count;
+}
+
+size_t PcmRingBuffer::available() {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+}
+
+void PcmRingBuffer::discard() {
+    tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+AudioOutput::AudioOutput() : streaming(false), paused(false), flushRequested(false),
+                             firstSamplesPending(false), volume(100), streamStartMicros(0) {
+    isRunning = false;
+    taskHandle = nullptr;
+    producerHandle = nullptr;
+    statsLock = portMUX_INITIALIZER_UNLOCKED;
+    memset(&stats, 0, sizeof(stats));
+#ifdef AUDIO_HOST_SINK
+    sink = nullptr;
+    sinkSamples = 0;
+    sinkStart = 0;
+#endif
+}
+
+AudioOutput::~AudioOutput() {
+    end();
+}
+
+bool AudioOutput::begin() {
+    if (isRunning) return true;
+
+    if (!ring.allocate(AUDIO_RING_SAMPLES)) {
+        Serial.println("Audio output: out of memory");
+        return false;
+    }
+
+#ifdef AUDIO_HOST_SINK
+    sink = fopen(AUDIO_HOST_SINK, "wb");
+    if (!sink) {
+        Serial.println("Audio output: cannot open the PCM sink");
+        ring.release();
+        return false;
+    }
+    sinkSamples = 0;
+    sinkStart = 0;
+#else
+    i2s_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = I2S_MODE_MASTER | I2S_MODE_TX;
+    config.sample_rate = AUDIO_SAMPLE_RATE;
+    config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    config.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    config.dma_buf_count = AUDIO_DMA_BUFFERS;
+    config.dma_buf_len = AUDIO_DMA_FRAMES;
+    config.use_apll = false;
+    config.tx_desc_auto_clear = true;   // Zeros, not the last buffer again, when nothing is written
+
+    i2s_pin_config_t pins;
+    memset(&pins, 0, sizeof(pins));
+    pins.mck_io_num = I2S_PIN_NO_CHANGE;
+    pins.bck_io_num = AUDIO_I2S_BCLK_PIN;
+    pins.ws_io_num = AUDIO_I2S_LRC_PIN;
+    pins.data_out_num = AUDIO_I2S_DOUT_PIN;
+    pins.data_in_num = I2S_PIN_NO_CHANGE;
+
+    if (i2s_driver_install(AUDIO_I2S_PORT, &config, 0, NULL) != ESP_OK) {
+        Serial.println("Audio output: I2S driver install failed");
+        ring.release();
+        return false;
+    }
+    if (i2s_set_pin(AUDIO_I2S_PORT, &pins) != ESP_OK) {
+        Serial.println("Audio output: I2S pin setup failed");
+        i2s_driver_uninstall(AUDIO_I2S_PORT);
+        ring.release();
+        return false;
+    }
+    i2s_zero_dma_buffer(AUDIO_I2S_PORT);
+#endif
+
+    isRunning = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(outputTask, "audio_out", OUTPUT_TASK_STACK,
+                                            this, AUDIO_OUTPUT_PRIORITY, &taskHandle, AUDIO_OUTPUT_CORE);
+    if (ok != pdPASS) {
+        Serial.println("Audio output: failed to create task");
+        isRunning = false;
+        taskHandle = nullptr;
+        end();
+        return false;
+    }
+
+    Serial.printf("Audio output started: %d Hz, %d x %d sample DMA buffers, %d sample ring\n",
+                  AUDIO_SAMPLE_RATE, AUDIO_DMA_BUFFERS, AUDIO_DMA_FRAMES, AUDIO_RING_SAMPLES);
+    return true;
+}
+
+void AudioOutput::end() {
+    if (isRunning) {
+        isRunning = false;
+        if (taskHandle) xTaskNotifyGive(taskHandle);
+
+        // The task notices the flag within one DMA buffer and deletes itself
+        unsigned long start = millis();
+        while (taskHandle && millis() - start < 1000) {
+            delay(10);
+        }
+    }
+#ifdef AUDIO_HOST_SINK
+    if (sink) {
+        fclose(sink);
+        sink = nullptr;
+    }
+#else
+    i2s_driver_uninstall(AUDIO_I2S_PORT);
+#endif
+    ring.release();
+}
+
+bool AudioOutput::isActive() {
+    return isRunning;
+}
+
+void AudioOutput::outputTask(void* param) {
+    AudioOutput* output = (AudioOutput*)param;
+    output->runLoop();
+    output->taskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void AudioOutput::runLoop() {
+    int16_t chunk[AUDIO_DMA_FRAMES];
+    uint32_t playedUntil = micros();  // When the samples handed to the DMA run out
+    bool dry = false;
+
+    while (isRunning) {
+        if (flushRequested.load()) {
+            ring.discard();
+#ifndef AUDIO_HOST_SINK
+            i2s_zero_dma_buffer(AUDIO_I2S_PORT);
+#endif
+            playedUntil = micros();
+            flushRequested.store(false);
+        }
+        if (paused.load()) {
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(20));
+            continue;
+        }
+
+        size_t count = ring.read(chunk, AUDIO_DMA_FRAMES);
+        if (count > 0 && producerHandle) xTaskNotifyGive(producerHandle);
+
+        uint32_t now = micros();
+        if (count == 0) {
+            // An underrun once the DMA has played everything in the middle of a
+            // stream; it repeats zeros until samples come
+            if (streaming.load() && !firstSamplesPending.load() && !dry && (int32_t)(now - playedUntil) > 0) {
+                dry = true;
+                portENTER_CRITICAL(&statsLock);
+                stats.underruns++;
+                portEXIT_CRITICAL(&statsLock);
+            }
+            ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2));
+            continue;
+        }
+
+        if ((int32_t)(now - playedUntil) > 0) {
+            if (dry) {
+                portENTER_CRITICAL(&statsLock);
+                stats.underrunSamples += (uint64_t)(now - playedUntil) * AUDIO_SAMPLE_RATE / 1000000;
+                portEXIT_CRITICAL(&statsLock);
+            }
+            playedUntil = now;
+        }
+        dry = false;
+        playedUntil += (uint64_t)count * 1000000 / AUDIO_SAMPLE_RATE;
+
+        if (firstSamplesPending.exchange(false)) {
+            unsigned long startMicros = now - streamStartMicros.load();
+            unsigned long firstSamplesMillis = millis();
+            portENTER_CRITICAL(&statsLock);
+            stats.streams++;
+            stats.totalStartMicros += startMicros;
+            stats.lastStartMicros = startMicros;
+            stats.lastFirstSamplesMillis = firstSamplesMillis;
+            portEXIT_CRITICAL(&statsLock);
+        }
+
+        int level = volume.load();
+        if (level < 100) {
+            for (size_t i = 0; i < count; i++) chunk[i] = (int32_t)chunk[i] * level / 100;
+        }
+        writeToDevice(chunk, count);
+
+        portENTER_CRITICAL(&statsLock);
+        stats.samplesPlayed += count;
+        portEXIT_CRITICAL(&statsLock);
+    }
+}
+
+bool AudioOutput::writeToDevice(const int16_t* data, size_t count) {
+#ifdef AUDIO_HOST_SINK
+    // Paced like the DMA: blocks while more than its buffers' worth is ahead of real time
+    fwrite(data, sizeof(int16_t), count, sink);
+    fflush(sink);
+    uint64_t now = micros();
+    uint64_t playedUntil = sinkStart + sinkSamples * 1000000ULL / AUDIO_SAMPLE_RATE;
+    if (playedUntil < now) {
+        // Ran dry: playback restarts now
+        sinkStart = now;
+        sinkSamples = 0;
+    }
+    sinkSamples += count;
+    const uint64_t dmaMicros = (uint64_t)AUDIO_DMA_BUFFERS * AUDIO_DMA_FRAMES * 1000000ULL / AUDIO_SAMPLE_RATE;
+    while (isRunning && sinkStart + sinkSamples * 1000000ULL / AUDIO_SAMPLE_RATE > micros() + dmaMicros) {
+        delay(1);
+    }
+    return true;
+#else
+    size_t written = 0;
+    return i2s_write(AUDIO_I2S_PORT, data, count * sizeof(int16_t), &written, portMAX_DELAY) == ESP_OK;
+#endif
+}
+
+void AudioOutput::startStream() {
+    producerHandle = xTaskGetCurrentTaskHandle();
+    streamStartMicros.store(micros());
+    firstSamplesPending.store(true);
+    streaming.store(true);
+}
+
+size_t AudioOutput::write(const int16_t* data, size_t count, uint32_t timeoutMs) {
+    if (!isRunning) return 0;
+    size_t written = 0;
+    unsigned long start = millis();
+    while (written < count) {
+        written += ring.write(data + written, count - written);
+        if (taskHandle) xTaskNotifyGive(taskHandle);
+        if (written == count || millis() - start >= timeoutMs) break;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(SPACE_WAIT_MS));
+    }
+
+    uint32_t fill = ring.available();
+    portENTER_CRITICAL(&statsLock);
+    if (fill > stats.maxFill) stats.maxFill = fill;
+    portEXIT_CRITICAL(&statsLock);
+    return written;
+}
+
+void AudioOutput::endStream() {
+    streaming.store(false);
+    // A clip short enough to sit whole in the ring still gets its start timed
+    if (ring.available() == 0) firstSamplesPending.store(false);
+}
+
+void AudioOutput::flush() {
+    if (!isRunning) return;
+    flushRequested.store(true);
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+
+    // Only the consumer may move the tail, so wait for it to take the request
+    unsigned long start = millis();
+    while (flushRequested.load() && millis() - start < FLUSH_WAIT_MS) {
+        delay(1);
+    }
+}
+
+bool AudioOutput::isDraining() {
+    return !streaming.load() && ring.available() > 0;
+}
+
+void AudioOutput::setPaused(bool pause) {
+    paused.store(pause);
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+void AudioOutput::setVolume(int level) {
+    volume.store(constrain(level, 0, 100));
+}
+
+size_t AudioOutput::bufferedSamples() {
+    return ring.available();
+}
+
+size_t AudioOutput::freeSamples() {
+    return ring.space();
+}
+
+AudioOutputStats AudioOutput::getStats() {
+    AudioOutputStats snapshot;
+    portENTER_CRITICAL(&statsLock);
+    snapshot = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return snapshot;
+}
+
+void AudioOutput::logStats() {
+    AudioOutputStats s = getStats();
+    if (s.streams == 0) return;
+    unsigned long avgStart = (unsigned long)(s.totalStartMicros / s.streams);
+    Serial.printf("Audio output: %u streams, %.1f s played, %u underruns (%.0f ms silence), max %u samples buffered, "
+                  "start latency avg %lu us, last %lu us\n",
+                  s.streams, s.samplesPlayed / (float)AUDIO_SAMPLE_RATE, s.underruns,
+                  s.underrunSamples * 1000.0f / AUDIO_SAMPLE_RATE, s.maxFill, avgStart, s.lastStartMicros);
+}
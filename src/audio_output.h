@@ -0,0 +1,112 @@
+#ifndef AUDIO_OUTPUT_H
+#define AUDIO_OUTPUT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "intel_glasses_config.h"
+
+// Single-producer, single-consumer ring of 16-bit samples. The producer only
+// moves `head` and the consumer only moves `tail`, so neither side takes a
+// lock; the release/acquire pair on each index publishes the samples.
+// Capacity is a power of two and the indices run freely.
+class PcmRingBuffer {
+private:
+    int16_t* samples;
+    uint32_t capacity;
+    std::atomic<uint32_t> head;   // Next sample written
+    std::atomic<uint32_t> tail;   // Next sample read
+
+public:
+    PcmRingBuffer();
+    ~PcmRingBuffer();
+
+    bool allocate(uint32_t capacitySamples);
+    void release();
+
+    // Producer side
+    size_t write(const int16_t* data, size_t count);
+    size_t space();
+
+    // Consumer side
+    size_t read(int16_t* data, size_t count);
+    size_t available();
+    void discard();               // Drop everything written so far
+};
+
+struct AudioOutputStats {
+    uint32_t streams;             // Streams that reached the DMA
+    uint64_t samplesPlayed;
+    uint32_t underruns;           // Times the DMA ran dry in the middle of a stream
+    uint64_t underrunSamples;     // Silence inserted for them
+    uint32_t maxFill;             // Most samples buffered at once
+    uint64_t totalStartMicros;    // startStream() to its first samples at the DMA
+    unsigned long lastStartMicros;
+    unsigned long lastFirstSamplesMillis; // millis() when the latest stream's first samples went out
+};
+
+// I2S output with a playback ring in front of it. The producer (the audio
+// manager's playback task) writes PCM between startStream() and endStream().
+// The output task moves it into the I2S DMA buffers one DMA buffer at a time.
+// If both the ring and the DMA buffers run dry in the middle of a stream, the
+// DMA plays zeros and that counts as an underrun. Between streams it plays
+// zeros the same way. With AUDIO_HOST_SINK defined (host builds), the
+// PCM goes to that file instead, paced in real time.
+class AudioOutput {
+private:
+    volatile bool isRunning;
+    TaskHandle_t taskHandle;
+    TaskHandle_t producerHandle;   // Woken when space frees up
+    PcmRingBuffer ring;
+
+    std::atomic<bool> streaming;
+    std::atomic<bool> paused;
+    std::atomic<bool> flushRequested;
+    std::atomic<bool> firstSamplesPending;
+    std::atomic<int> volume;       // 0-100
+    std::atomic<uint32_t> streamStartMicros;
+
+    AudioOutputStats stats;
+    portMUX_TYPE statsLock;
+
+#ifdef AUDIO_HOST_SINK
+    FILE* sink;
+    uint64_t sinkSamples;
+    unsigned long sinkStart;
+#endif
+
+    static void outputTask(void* param);
+    void runLoop();
+    bool writeToDevice(const int16_t* data, size_t count);
+
+public:
+    AudioOutput();
+    ~AudioOutput();
+
+    bool begin();
+    void end();
+    bool isActive();
+
+    // Producer side: write() blocks until the samples fit or timeoutMs passes
+    // and returns how many were taken
+    void startStream();
+    size_t write(const int16_t* data, size_t count, uint32_t timeoutMs);
+    void endStream();
+    void flush();                  // Drop buffered samples, e.g. for an interruption
+    bool isDraining();             // Samples of a finished stream still buffered
+
+    void setPaused(bool pause);
+    void setVolume(int level);
+    size_t bufferedSamples();
+    size_t freeSamples();          // Room in the ring, for producers that must not block
+
+    // Statistics
+    AudioOutputStats getStats();
+    void logStats();
+};
+
+// Global audio output instance
+extern AudioOutput audioOutput;
+
+#endif // AUDIO_OUTPUT_H
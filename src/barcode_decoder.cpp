@@ -0,0 +1,1343 @@
+#include "barcode_decoder.h"
+#include "jpeg_transcoder.h"
+#include <cstring>
+#include <cmath>
+
+BarcodeDecoder barcodeDecoder;
+
+namespace {
+
+// ===================
+// QR code tables
+// ===================
+
+// Error correction blocks of one version and level: `shortBlocks` blocks with
+// `shortData` data codewords followed by `longBlocks` with one more, each with `ecc` check codewords
+struct QrBlockLayout {
+    uint8_t ecc;
+    uint8_t shortBlocks;
+    uint8_t shortData;
+    uint8_t longBlocks;
+};
+
+// Block layout per version, levels L, M, Q, H
+const QrBlockLayout QR_BLOCKS[40][4] = {
+    { { 7, 1, 19, 0 }, { 10, 1, 16, 0 }, { 13, 1, 13, 0 }, { 17, 1, 9, 0 } },  // 1
+    { { 10, 1, 34, 0 }, { 16, 1, 28, 0 }, { 22, 1, 22, 0 }, { 28, 1, 16, 0 } },  // 2
+    { { 15, 1, 55, 0 }, { 26, 1, 44, 0 }, { 18, 2, 17, 0 }, { 22, 2, 13, 0 } },  // 3
+    { { 20, 1, 80, 0 }, { 18, 2, 32, 0 }, { 26, 2, 24, 0 }, { 16, 4, 9, 0 } },  // 4
+    { { 26, 1, 108, 0 }, { 24, 2, 43, 0 }, { 18, 2, 15, 2 }, { 22, 2, 11, 2 } },  // 5
+    { { 18, 2, 68, 0 }, { 16, 4, 27, 0 }, { 24, 4, 19, 0 }, { 28, 4, 15, 0 } },  // 6
+    { { 20, 2, 78, 0 }, { 18, 4, 31, 0 }, { 18, 2, 14, 4 }, { 26, 4, 13, 1 } },  // 7
+    { { 24, 2, 97, 0 }, { 22, 2, 38, 2 }, { 22, 4, 18, 2 }, { 26, 4, 14, 2 } },  // 8
+    { { 30, 2, 116, 0 }, { 22, 3, 36, 2 }, { 20, 4, 16, 4 }, { 24, 4, 12, 4 } },  // 9
+    { { 18, 2, 68, 2 }, { 26, 4, 43, 1 }, { 24, 6, 19, 2 }, { 28, 6, 15, 2 } },  // 10
+    { { 20, 4, 81, 0 }, { 30, 1, 50, 4 }, { 28, 4, 22, 4 }, { 24, 3, 12, 8 } },  // 11
+    { { 24, 2, 92, 2 }, { 22, 6, 36, 2 }, { 26, 4, 20, 6 }, { 28, 7, 14, 4 } },  // 12
+    { { 26, 4, 107, 0 }, { 22, 8, 37, 1 }, { 24, 8, 20, 4 }, { 22, 12, 11, 4 } },  // 13
+    { { 30, 3, 115, 1 }, { 24, 4, 40, 5 }, { 20, 11, 16, 5 }, { 24, 11, 12, 5 } },  // 14
+    { { 22, 5, 87, 1 }, { 24, 5, 41, 5 }, { 30, 5, 24, 7 }, { 24, 11, 12, 7 } },  // 15
+    { { 24, 5, 98, 1 }, { 28, 7, 45, 3 }, { 24, 15, 19, 2 }, { 30, 3, 15, 13 } },  // 16
+    { { 28, 1, 107, 5 }, { 28, 10, 46, 1 }, { 28, 1, 22, 15 }, { 28, 2, 14, 17 } },  // 17
+    { { 30, 5, 120, 1 }, { 26, 9, 43, 4 }, { 28, 17, 22, 1 }, { 28, 2, 14, 19 } },  // 18
+    { { 28, 3, 113, 4 }, { 26, 3, 44, 11 }, { 26, 17, 21, 4 }, { 26, 9, 13, 16 } },  // 19
+    { { 28, 3, 107, 5 }, { 26, 3, 41, 13 }, { 30, 15, 24, 5 }, { 28, 15, 15, 10 } },  // 20
+    { { 28, 4, 116, 4 }, { 26, 17, 42, 0 }, { 28, 17, 22, 6 }, { 30, 19, 16, 6 } },  // 21
+    { { 28, 2, 111, 7 }, { 28, 17, 46, 0 }, { 30, 7, 24, 16 }, { 24, 34, 13, 0 } },  // 22
+    { { 30, 4, 121, 5 }, { 28, 4, 47, 14 }, { 30, 11, 24, 14 }, { 30, 16, 15, 14 } },  // 23
+    { { 30, 6, 117, 4 }, { 28, 6, 45, 14 }, { 30, 11, 24, 16 }, { 30, 30, 16, 2 } },  // 24
+    { { 26, 8, 106, 4 }, { 28, 8, 47, 13 }, { 30, 7, 24, 22 }, { 30, 22, 15, 13 } },  // 25
+    { { 28, 10, 114, 2 }, { 28, 19, 46, 4 }, { 28, 28, 22, 6 }, { 30, 33, 16, 4 } },  // 26
+    { { 30, 8, 122, 4 }, { 28, 22, 45, 3 }, { 30, 8, 23, 26 }, { 30, 12, 15, 28 } },  // 27
+    { { 30, 3, 117, 10 }, { 28, 3, 45, 23 }, { 30, 4, 24, 31 }, { 30, 11, 15, 31 } },  // 28
+    { { 30, 7, 116, 7 }, { 28, 21, 45, 7 }, { 30, 1, 23, 37 }, { 30, 19, 15, 26 } },  // 29
+    { { 30, 5, 115, 10 }, { 28, 19, 47, 10 }, { 30, 15, 24, 25 }, { 30, 23, 15, 25 } },  // 30
+    { { 30, 13, 115, 3 }, { 28, 2, 46, 29 }, { 30, 42, 24, 1 }, { 30, 23, 15, 28 } },  // 31
+    { { 30, 17, 115, 0 }, { 28, 10, 46, 23 }, { 30, 10, 24, 35 }, { 30, 19, 15, 35 } },  // 32
+    { { 30, 17, 115, 1 }, { 28, 14, 46, 21 }, { 30, 29, 24, 19 }, { 30, 11, 15, 46 } },  // 33
+    { { 30, 13, 115, 6 }, { 28, 14, 46, 23 }, { 30, 44, 24, 7 }, { 30, 59, 16, 1 } },  // 34
+    { { 30, 12, 121, 7 }, { 28, 12, 47, 26 }, { 30, 39, 24, 14 }, { 30, 22, 15, 41 } },  // 35
+    { { 30, 6, 121, 14 }, { 28, 6, 47, 34 }, { 30, 46, 24, 10 }, { 30, 2, 15, 64 } },  // 36
+    { { 30, 17, 122, 4 }, { 28, 29, 46, 14 }, { 30, 49, 24, 10 }, { 30, 24, 15, 46 } },  // 37
+    { { 30, 4, 122, 18 }, { 28, 13, 46, 32 }, { 30, 48, 24, 14 }, { 30, 42, 15, 32 } },  // 38
+    { { 30, 20, 117, 4 }, { 28, 40, 47, 7 }, { 30, 43, 24, 22 }, { 30, 10, 15, 67 } },  // 39
+    { { 30, 19, 118, 6 }, { 28, 18, 47, 31 }, { 30, 34, 24, 34 }, { 30, 20, 15, 61 } },  // 40
+};
+
+
+const uint8_t QR_ALIGNMENT[40][8] = {
+    { 0, 0, 0, 0, 0, 0, 0, 0 },
+    { 6, 18, 0, 0, 0, 0, 0, 0 },
+    { 6, 22, 0, 0, 0, 0, 0, 0 },
+    { 6, 26, 0, 0, 0, 0, 0, 0 },
+    { 6, 30, 0, 0, 0, 0, 0, 0 },
+    { 6, 34, 0, 0, 0, 0, 0, 0 },
+    { 6, 22, 38, 0, 0, 0, 0, 0 },
+    { 6, 24, 42, 0, 0, 0, 0, 0 },
+    { 6, 26, 46, 0, 0, 0, 0, 0 },
+    { 6, 28, 50, 0, 0, 0, 0, 0 },
+    { 6, 30, 54, 0, 0, 0, 0, 0 },
+    { 6, 32, 58, 0, 0, 0, 0, 0 },
+    { 6, 34, 62, 0, 0, 0, 0, 0 },
+    { 6, 26, 46, 66, 0, 0, 0, 0 },
+    { 6, 26, 48, 70, 0, 0, 0, 0 },
+    { 6, 26, 50, 74, 0, 0, 0, 0 },
+    { 6, 30, 54, 78, 0, 0, 0, 0 },
+    { 6, 30, 56, 82, 0, 0, 0, 0 },
+    { 6, 30, 58, 86, 0, 0, 0, 0 },
+    { 6, 34, 62, 90, 0, 0, 0, 0 },
+    { 6, 28, 50, 72, 94, 0, 0, 0 },
+    { 6, 26, 50, 74, 98, 0, 0, 0 },
+    { 6, 30, 54, 78, 102, 0, 0, 0 },
+    { 6, 28, 54, 80, 106, 0, 0, 0 },
+    { 6, 32, 58, 84, 110, 0, 0, 0 },
+    { 6, 30, 58, 86, 114, 0, 0, 0 },
+    { 6, 34, 62, 90, 118, 0, 0, 0 },
+    { 6, 26, 50, 74, 98, 122, 0, 0 },
+    { 6, 30, 54, 78, 102, 126, 0, 0 },
+    { 6, 26, 52, 78, 104, 130, 0, 0 },
+    { 6, 30, 56, 82, 108, 134, 0, 0 },
+    { 6, 34, 60, 86, 112, 138, 0, 0 },
+    { 6, 30, 58, 86, 114, 142, 0, 0 },
+    { 6, 34, 62, 90, 118, 146, 0, 0 },
+    { 6, 30, 54, 78, 102, 126, 150, 0 },
+    { 6, 24, 50, 76, 102, 128, 154, 0 },
+    { 6, 28, 54, 80, 106, 132, 158, 0 },
+    { 6, 32, 58, 84, 110, 136, 162, 0 },
+    { 6, 26, 54, 82, 110, 138, 166, 0 },
+    { 6, 30, 58, 86, 114, 142, 170, 0 },
+};
+
+// Format information level bits (M, L, H, Q) to table column (L, M, Q, H)
+const int QR_LEVEL_INDEX[4] = { 1, 0, 3, 2 };
+const char QR_LEVEL_NAME[4] = { 'M', 'L', 'H', 'Q' };
+
+const char QR_ALPHANUMERIC[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ $%*+-./:";
+
+const int QR_MAX_ECC = 30;
+const int QR_MAX_BLOCK = 153;
+const int QR_MAX_CODEWORDS = 3706;
+
+// ===================
+// GF(256) and Reed-Solomon
+// ===================
+
+struct Galois {
+    uint8_t exp[512];
+    uint8_t log[256];
+
+    Galois() {
+        int x = 1;
+        for (int i = 0; i < 255; i++) {
+            exp[i] = x;
+            log[x] = i;
+            x <<= 1;
+            if (x & 0x100) x ^= 0x11d;
+        }
+        for (int i = 255; i < 512; i++) {
+            exp[i] = exp[i - 255];
+        }
+        log[0] = 0;
+    }
+
+    uint8_t mul(uint8_t a, uint8_t b) const {
+        return (a && b) ? exp[log[a] + log[b]] : 0;
+    }
+    uint8_t div(uint8_t a, uint8_t b) const {
+        return a ? exp[log[a] + 255 - log[b]] : 0;
+    }
+};
+
+const Galois gf;
+
+// Correct one block in place (data followed by `ecc` check codewords).
+// Returns the number of corrected codewords, -1 when uncorrectable.
+int correctBlock(uint8_t* block, int length, int ecc) {
+    uint8_t syndromes[QR_MAX_ECC];
+    bool clean = true;
+    for (int i = 0; i < ecc; i++) {
+        uint8_t s = 0;
+        for (int j = 0; j < length; j++) {
+            s = gf.mul(s, gf.exp[i]) ^ block[j];
+        }
+        syndromes[i] = s;
+        if (s) clean = false;
+    }
+    if (clean) return 0;
+
+    // Berlekamp-Massey for the error locator
+    uint8_t locator[QR_MAX_ECC + 1] = { 1 };
+    uint8_t previous[QR_MAX_ECC + 1] = { 1 };
+    uint8_t scratch[QR_MAX_ECC + 1];
+    int errors = 0;
+    int shift = 1;
+    uint8_t lastDiscrepancy = 1;
+    for (int k = 0; k < ecc; k++) {
+        uint8_t d = syndromes[k];
+        for (int i = 1; i <= errors; i++) {
+            d ^= gf.mul(locator[i], syndromes[k - i]);
+        }
+        if (d == 0) {
+            shift++;
+            continue;
+        }
+        uint8_t scale = gf.div(d, lastDiscrepancy);
+        memcpy(scratch, locator, sizeof(locator));
+        for (int i = 0; i + shift <= ecc; i++) {
+            locator[i + shift] ^= gf.mul(scale, previous[i]);
+        }
+        if (2 * errors <= k) {
+            errors = k + 1 - errors;
+            memcpy(previous, scratch, sizeof(previous));
+            lastDiscrepancy = d;
+            shift = 1;
+        } else {
+            shift++;
+        }
+    }
+    if (errors == 0 || 2 * errors > ecc) return -1;
+
+    // Evaluator: syndromes * locator mod x^ecc
+    uint8_t evaluator[QR_MAX_ECC];
+    for (int i = 0; i < ecc; i++) {
+        uint8_t v = 0;
+        for (int j = 0; j <= i && j <= errors; j++) {
+            v ^= gf.mul(syndromes[i - j], locator[j]);
+        }
+        evaluator[i] = v;
+    }
+
+    // Chien search over the codeword positions, Forney for the magnitudes
+    int found = 0;
+    for (int power = 0; power < length; power++) {
+        uint8_t inverse = gf.exp[(255 - power) % 255];   // X^-1 for an error at x^power
+        uint8_t value = 0;
+        uint8_t term = 1;
+        for (int i = 0; i <= errors; i++) {
+            value ^= gf.mul(locator[i], term);
+            term = gf.mul(term, inverse);
+        }
+        if (value != 0) continue;
+
+        uint8_t numerator = 0;
+        term = 1;
+        for (int i = 0; i < ecc; i++) {
+            numerator ^= gf.mul(evaluator[i], term);
+            term = gf.mul(term, inverse);
+        }
+        // Formal derivative keeps the odd terms
+        uint8_t denominator = 0;
+        uint8_t inverseSquared = gf.mul(inverse, inverse);
+        term = 1;
+        for (int i = 1; i <= errors; i += 2) {
+            denominator ^= gf.mul(locator[i], term);
+            term = gf.mul(term, inverseSquared);
+        }
+        if (denominator == 0) return -1;
+        block[length - 1 - power] ^= gf.mul(gf.exp[power], gf.div(numerator, denominator));
+        found++;
+    }
+    return found == errors ? errors : -1;
+}
+
+// ===================
+// QR function patterns and format
+// ===================
+
+int hammingDistance(uint32_t a, uint32_t b) {
+    uint32_t x = a ^ b;
+    int count = 0;
+    while (x) {
+        x &= x - 1;
+        count++;
+    }
+    return count;
+}
+
+// BCH remainder of `data` shifted past the check bits
+uint32_t bchRemainder(uint32_t data, uint32_t generator, int checkBits) {
+    uint32_t value = data << checkBits;
+    int generatorDegree = 31 - __builtin_clz(generator);
+    for (int bit = 31; bit >= generatorDegree; bit--) {
+        if (value & (1u << bit)) {
+            value ^= generator << (bit - generatorDegree);
+        }
+    }
+    return value;
+}
+
+// Nearest valid format word (5 data bits), -1 when more than 3 bits off
+int decodeFormatBits(uint32_t raw) {
+    raw ^= 0x5412;
+    int best = -1;
+    int bestDistance = 4;
+    for (uint32_t data = 0; data < 32; data++) {
+        uint32_t codeword = (data << 10) | bchRemainder(data, 0x537, 10);
+        int distance = hammingDistance(raw, codeword);
+        if (distance < bestDistance) {
+            bestDistance = distance;
+            best = data;
+        }
+    }
+    return best;
+}
+
+inline bool module(const uint8_t* modules, int size, int row, int column) {
+    return modules[row * size + column] != 0;
+}
+
+int readFormat(const uint8_t* modules, int size) {
+    // Around the top-left finder
+    static const uint8_t xs[15] = { 8, 8, 8, 8, 8, 8, 8, 8, 7, 5, 4, 3, 2, 1, 0 };
+    static const uint8_t ys[15] = { 0, 1, 2, 3, 4, 5, 7, 8, 8, 8, 8, 8, 8, 8, 8 };
+    uint32_t first = 0;
+    for (int i = 14; i >= 0; i--) {
+        first = (first << 1) | module(modules, size, ys[i], xs[i]);
+    }
+    int format = decodeFormatBits(first);
+    if (format >= 0) return format;
+
+    // Split copy under the top-right and beside the bottom-left finders
+    uint32_t second = 0;
+    for (int i = 0; i < 7; i++) {
+        second = (second << 1) | module(modules, size, size - 1 - i, 8);
+    }
+    for (int i = 0; i < 8; i++) {
+        second = (second << 1) | module(modules, size, 8, size - 8 + i);
+    }
+    return decodeFormatBits(second);
+}
+
+// Marks finder, separator, format, timing, alignment and version modules
+void markFunctionModules(uint8_t* reserved, int size, int version) {
+    memset(reserved, 0, size * size);
+    auto fill = [&](int row, int column, int height, int width) {
+        for (int r = row; r < row + height; r++) {
+            for (int c = column; c < column + width; c++) {
+                reserved[r * size + c] = 1;
+            }
+        }
+    };
+    fill(0, 0, 9, 9);
+    fill(0, size - 8, 9, 8);
+    fill(size - 8, 0, 8, 9);
+    fill(6, 0, 1, size);
+    fill(0, 6, size, 1);
+
+    const uint8_t* centres = QR_ALIGNMENT[version - 1];
+    for (int i = 0; centres[i]; i++) {
+        for (int j = 0; centres[j]; j++) {
+            int row = centres[i];
+            int column = centres[j];
+            // Skip the three that would overlap finder patterns
+            if ((row < 9 && column < 9) || (row < 9 && column > size - 10) || (row > size - 10 && column < 9)) {
+                continue;
+            }
+            fill(row - 2, column - 2, 5, 5);
+        }
+    }
+    if (version >= 7) {
+        fill(0, size - 11, 6, 3);
+        fill(size - 11, 0, 3, 6);
+    }
+}
+
+bool maskBit(int mask, int row, int column) {
+    switch (mask) {
+        case 0: return (row + column) % 2 == 0;
+        case 1: return row % 2 == 0;
+        case 2: return column % 3 == 0;
+        case 3: return (row + column) % 3 == 0;
+        case 4: return (row / 2 + column / 3) % 2 == 0;
+        case 5: return (row * column) % 2 + (row * column) % 3 == 0;
+        case 6: return ((row * column) % 2 + (row * column) % 3) % 2 == 0;
+        default: return ((row + column) % 2 + (row * column) % 3) % 2 == 0;
+    }
+}
+
+// ===================
+// QR payload
+// ===================
+
+struct PayloadReader {
+    const uint8_t* data;
+    int bits;
+    int position;
+
+    int remaining() { return bits - position; }
+    uint32_t read(int count) {
+        uint32_t value = 0;
+        for (int i = 0; i < count; i++) {
+            value = (value << 1) | ((data[position >> 3] >> (7 - (position & 7))) & 1);
+            position++;
+        }
+        return value;
+    }
+};
+
+void appendChar(BarcodeResult* result, char c) {
+    if (result->length < BARCODE_MAX_TEXT) {
+        result->text[result->length++] = c;
+    }
+}
+
+bool decodePayload(const uint8_t* data, int length, int version, BarcodeResult* result) {
+    PayloadReader reader = { data, length * 8, 0 };
+    int sizeClass = version < 10 ? 0 : (version < 27 ? 1 : 2);
+    static const uint8_t countBits[4][3] = {
+        { 10, 12, 14 },   // Numeric
+        { 9, 11, 13 },    // Alphanumeric
+        { 8, 16, 16 },    // Byte
+        { 8, 10, 12 }     // Kanji
+    };
+
+    while (reader.remaining() >= 4) {
+        int mode = reader.read(4);
+        if (mode == 0) break;   // Terminator
+
+        if (mode == 7) {
+            // ECI designator: the payload is passed through unchanged
+            int first = reader.read(8);
+            if ((first & 0xc0) == 0x80) reader.read(8);
+            else if ((first & 0xe0) == 0xc0) reader.read(16);
+            continue;
+        }
+        if (mode == 3) {
+            reader.read(16);    // Structured append header
+            continue;
+        }
+        if (mode == 5) continue;               // FNC1, first position
+        if (mode == 9) {
+            reader.read(8);                     // FNC1, second position
+            continue;
+        }
+
+        int kind;
+        switch (mode) {
+            case 1: kind = 0; break;
+            case 2: kind = 1; break;
+            case 4: kind = 2; break;
+            case 8: kind = 3; break;
+            default: return false;
+        }
+        int bitsForCount = countBits[kind][sizeClass];
+        if (reader.remaining() < bitsForCount) return false;
+        int count = reader.read(bitsForCount);
+
+        if (kind == 0) {
+            while (count >= 3) {
+                if (reader.remaining() < 10) return false;
+                int v = reader.read(10);
+                if (v > 999) return false;
+                appendChar(result, '0' + v / 100);
+                appendChar(result, '0' + v / 10 % 10);
+                appendChar(result, '0' + v % 10);
+                count -= 3;
+            }
+            if (count == 2) {
+                if (reader.remaining() < 7) return false;
+                int v = reader.read(7);
+                if (v > 99) return false;
+                appendChar(result, '0' + v / 10);
+                appendChar(result, '0' + v % 10);
+            } else if (count == 1) {
+                if (reader.remaining() < 4) return false;
+                int v = reader.read(4);
+                if (v > 9) return false;
+                appendChar(result, '0' + v);
+            }
+        } else if (kind == 1) {
+            while (count >= 2) {
+                if (reader.remaining() < 11) return false;
+                int v = reader.read(11);
+                if (v >= 45 * 45) return false;
+                appendChar(result, QR_ALPHANUMERIC[v / 45]);
+                appendChar(result, QR_ALPHANUMERIC[v % 45]);
+                count -= 2;
+            }
+            if (count == 1) {
+                if (reader.remaining() < 6) return false;
+                int v = reader.read(6);
+                if (v >= 45) return false;
+                appendChar(result, QR_ALPHANUMERIC[v]);
+            }
+        } else if (kind == 2) {
+            if (reader.remaining() < count * 8) return false;
+            for (int i = 0; i < count; i++) {
+                appendChar(result, (char)reader.read(8));
+            }
+        } else {
+            // Kanji back to Shift JIS bytes
+            if (reader.remaining() < count * 13) return false;
+            for (int i = 0; i < count; i++) {
+                int v = reader.read(13);
+                int sjis = ((v / 0xc0) << 8) | (v % 0xc0);
+                sjis += sjis < 0x1f00 ? 0x8140 : 0xc140;
+                appendChar(result, (char)(sjis >> 8));
+                appendChar(result, (char)(sjis & 0xff));
+            }
+        }
+    }
+    result->text[result->length] = '\0';
+    return result->length > 0;
+}
+
+// ===================
+// QR location
+// ===================
+
+struct FinderCandidate {
+    float x;
+    float y;
+    float moduleSize;
+    int count;                // Scanlines that found it
+};
+
+const int MAX_FINDER_CANDIDATES = 64;
+
+// Offsets in modules tried on the estimated bottom-right corner, nearest first
+const int8_t QR_CORNER_NUDGE[][2] = {
+    { 0, 0 }, { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 },
+    { 2, 0 }, { 0, 2 }, { -2, 0 }, { 0, -2 }, { 2, 1 }, { 1, 2 }, { -2, -1 }, { -1, -2 },
+    { 2, -1 }, { -1, 2 }, { -2, 1 }, { 1, -2 }, { 2, 2 }, { -2, -2 }, { 2, -2 }, { -2, 2 }
+};
+const int QR_CORNER_NUDGES = sizeof(QR_CORNER_NUDGE) / sizeof(QR_CORNER_NUDGE[0]);
+
+// Run lengths in 1:1:3:1:1 proportion
+bool finderRatio(const int* counts) {
+    int total = 0;
+    for (int i = 0; i < 5; i++) {
+        if (counts[i] == 0) return false;
+        total += counts[i];
+    }
+    if (total < 7) return false;
+    float unit = total / 7.0f;
+    float tolerance = unit * 0.6f;
+    return fabsf(unit - counts[0]) < tolerance && fabsf(unit - counts[1]) < tolerance &&
+           fabsf(3 * unit - counts[2]) < 3 * tolerance &&
+           fabsf(unit - counts[3]) < tolerance && fabsf(unit - counts[4]) < tolerance;
+}
+
+// Re-measure a finder pattern along the line through (x, y) in direction (dx, dy).
+// Returns the centre coordinate along that line, or -1; `total` receives the pattern length.
+float crossCheckFinder(const uint8_t* binary, int width, int height, int x, int y, int dx, int dy,
+                       int maxCount, int* total) {
+    auto dark = [&](int i) -> int {
+        int px = x + i * dx;
+        int py = y + i * dy;
+        if (px < 0 || py < 0 || px >= width || py >= height) return -1;
+        return binary[py * width + px];
+    };
+    int counts[5] = { 0, 0, 0, 0, 0 };
+    int i = 0;
+    while (dark(i) == 1) { counts[2]++; i--; }
+    while (dark(i) == 0 && counts[1] <= maxCount) { counts[1]++; i--; }
+    if (dark(i) != 1 || counts[1] > maxCount) return -1;
+    while (dark(i) == 1 && counts[0] <= maxCount) { counts[0]++; i--; }
+    if (counts[0] > maxCount) return -1;
+
+    i = 1;
+    while (dark(i) == 1) { counts[2]++; i++; }
+    int darkEnd = i;
+    while (dark(i) == 0 && counts[3] <= maxCount) { counts[3]++; i++; }
+    if (dark(i) != 1 || counts[3] > maxCount) return -1;
+    while (dark(i) == 1 && counts[4] <= maxCount) { counts[4]++; i++; }
+    if (counts[4] > maxCount || !finderRatio(counts)) return -1;
+
+    *total = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+    float offset = darkEnd - counts[2] / 2.0f;
+    return dx ? x + offset : y + offset;
+}
+
+void addFinderCandidate(FinderCandidate* candidates, int* count, float x, float y, float moduleSize) {
+    for (int i = 0; i < *count; i++) {
+        FinderCandidate& c = candidates[i];
+        if (fabsf(c.x - x) <= c.moduleSize * 1.5f && fabsf(c.y - y) <= c.moduleSize * 1.5f &&
+            fabsf(c.moduleSize - moduleSize) <= max(1.0f, c.moduleSize * 0.5f)) {
+            c.x = (c.x * c.count + x) / (c.count + 1);
+            c.y = (c.y * c.count + y) / (c.count + 1);
+            c.moduleSize = (c.moduleSize * c.count + moduleSize) / (c.count + 1);
+            c.count++;
+            return;
+        }
+    }
+    if (*count < MAX_FINDER_CANDIDATES) {
+        candidates[(*count)++] = { x, y, moduleSize, 1 };
+    }
+}
+
+// Scan rows for finder patterns and confirm each across the column
+int findFinderPatterns(const uint8_t* binary, int width, int height, FinderCandidate* candidates) {
+    int count = 0;
+    uint16_t* runStart = (uint16_t*)malloc((width + 1) * sizeof(uint16_t));
+    uint16_t* runLength = (uint16_t*)malloc((width + 1) * sizeof(uint16_t));
+    if (!runStart || !runLength) {
+        free(runStart);
+        free(runLength);
+        return 0;
+    }
+
+    int rowStep = height > 400 ? 2 : 1;
+    for (int y = 0; y < height; y += rowStep) {
+        const uint8_t* row = binary + y * width;
+        int runs = 0;
+        for (int x = 0; x < width; x++) {
+            if (x == 0 || row[x] != row[x - 1]) {
+                runStart[runs] = x;
+                runLength[runs] = 0;
+                runs++;
+            }
+            runLength[runs - 1]++;
+        }
+        int first = row[0] ? 0 : 1;
+        for (int i = first; i + 4 < runs; i += 2) {
+            int counts[5] = { runLength[i], runLength[i + 1], runLength[i + 2], runLength[i + 3], runLength[i + 4] };
+            if (!finderRatio(counts)) continue;
+            int horizontal = counts[0] + counts[1] + counts[2] + counts[3] + counts[4];
+            int cx = runStart[i + 2] + runLength[i + 2] / 2;
+
+            int vertical = 0;
+            float cy = crossCheckFinder(binary, width, height, cx, y, 0, 1, horizontal, &vertical);
+            if (cy < 0 || 5 * abs(vertical - horizontal) >= 2 * horizontal) continue;
+            int refined = 0;
+            float fx = crossCheckFinder(binary, width, height, cx, (int)cy, 1, 0, horizontal, &refined);
+            if (fx < 0) continue;
+            addFinderCandidate(candidates, &count, fx, cy, (refined + vertical) / 14.0f);
+        }
+    }
+    free(runStart);
+    free(runLength);
+    return count;
+}
+
+// Alignment pattern (dark centre module in a light ring) nearest to the estimate
+bool findAlignmentPattern(const uint8_t* binary, int width, int height, float estimateX, float estimateY,
+                          float moduleSize, float allowance, float* foundX, float* foundY) {
+    int radius = (int)(allowance * moduleSize);
+    int x0 = max(0, (int)estimateX - radius);
+    int x1 = min(width, (int)estimateX + radius);
+    int y0 = max(0, (int)estimateY - radius);
+    int y1 = min(height, (int)estimateY + radius);
+    if (x1 - x0 < 3 * moduleSize || y1 - y0 < 3 * moduleSize) return false;
+
+    float low = moduleSize * 0.5f;
+    float high = moduleSize * 1.5f;
+    auto near = [&](int run) { return run >= low && run <= high; };
+    float bestDistance = 1e9f;
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = binary + y * width;
+        int x = x0;
+        while (x < x1 && row[x]) x++;         // Start on a light run
+        while (x < x1) {
+            int lightStart = x;
+            while (x < x1 && !row[x]) x++;
+            int darkStart = x;
+            while (x < x1 && row[x]) x++;
+            int darkEnd = x;
+            while (x < x1 && !row[x]) x++;
+            if (x >= x1) break;               // Trailing light run must be complete
+            if (!near(darkStart - lightStart) || !near(darkEnd - darkStart) || !near(x - darkEnd)) {
+                x = darkEnd;
+                continue;
+            }
+
+            // Same check down the column
+            int cx = (darkStart + darkEnd) / 2;
+            int top = y, bottom = y;
+            while (top > 0 && binary[(top - 1) * width + cx]) top--;
+            while (bottom + 1 < height && binary[(bottom + 1) * width + cx]) bottom++;
+            int above = 0, below = 0;
+            while (top - above - 1 >= 0 && !binary[(top - above - 1) * width + cx] && above <= high) above++;
+            while (bottom + below + 1 < height && !binary[(bottom + below + 1) * width + cx] && below <= high) below++;
+            if (near(bottom - top + 1) && near(above) && near(below)) {
+                float px = (darkStart + darkEnd) / 2.0f;
+                float py = (top + bottom + 1) / 2.0f;
+                float distance = hypotf(px - estimateX, py - estimateY);
+                if (distance < bestDistance) {
+                    bestDistance = distance;
+                    *foundX = px;
+                    *foundY = py;
+                }
+            }
+            x = darkEnd;
+        }
+    }
+    return bestDistance < 1e9f;
+}
+
+// Perspective transform taking module coordinates (u, v) to image coordinates
+struct Homography {
+    double h[8];
+
+    bool solve(const float* modulePoints, const float* imagePoints) {
+        double a[8][9];
+        for (int i = 0; i < 4; i++) {
+            double u = modulePoints[2 * i], v = modulePoints[2 * i + 1];
+            double x = imagePoints[2 * i], y = imagePoints[2 * i + 1];
+            double rowX[9] = { u, v, 1, 0, 0, 0, -u * x, -v * x, x };
+            double rowY[9] = { 0, 0, 0, u, v, 1, -u * y, -v * y, y };
+            memcpy(a[2 * i], rowX, sizeof(rowX));
+            memcpy(a[2 * i + 1], rowY, sizeof(rowY));
+        }
+        for (int col = 0; col < 8; col++) {
+            int pivot = col;
+            for (int r = col + 1; r < 8; r++) {
+                if (fabs(a[r][col]) > fabs(a[pivot][col])) pivot = r;
+            }
+            if (fabs(a[pivot][col]) < 1e-9) return false;
+            if (pivot != col) {
+                for (int c = 0; c < 9; c++) {
+                    double t = a[col][c];
+                    a[col][c] = a[pivot][c];
+                    a[pivot][c] = t;
+                }
+            }
+            for (int r = 0; r < 8; r++) {
+                if (r == col) continue;
+                double f = a[r][col] / a[col][col];
+                for (int c = col; c < 9; c++) {
+                    a[r][c] -= f * a[col][c];
+                }
+            }
+        }
+        for (int i = 0; i < 8; i++) {
+            h[i] = a[i][8] / a[i][i];
+        }
+        return true;
+    }
+
+    void map(float u, float v, float* x, float* y) const {
+        double w = h[6] * u + h[7] * v + 1;
+        *x = (float)((h[0] * u + h[1] * v + h[2]) / w);
+        *y = (float)((h[3] * u + h[4] * v + h[5]) / w);
+    }
+};
+
+bool sampleGrid(const uint8_t* binary, int width, int height, const Homography& transform,
+                int size, uint8_t* modules) {
+    for (int r = 0; r < size; r++) {
+        for (int c = 0; c < size; c++) {
+            float x, y;
+            transform.map(c + 0.5f, r + 0.5f, &x, &y);
+            int px = (int)floorf(x);
+            int py = (int)floorf(y);
+            if (px < 0 || py < 0 || px >= width || py >= height) return false;
+            modules[r * size + c] = binary[py * width + px];
+        }
+    }
+    return true;
+}
+
+float distance(const FinderCandidate& a, const FinderCandidate& b) {
+    return hypotf(a.x - b.x, a.y - b.y);
+}
+
+// ===================
+// EAN / UPC
+// ===================
+
+// Run widths of the L code (and R code, starting on a bar); G is the reverse
+const uint8_t EAN_WIDTHS[10][4] = {
+    { 3, 2, 1, 1 }, { 2, 2, 2, 1 }, { 2, 1, 2, 2 }, { 1, 4, 1, 1 }, { 1, 1, 3, 2 },
+    { 1, 2, 3, 1 }, { 1, 1, 1, 4 }, { 1, 3, 1, 2 }, { 1, 2, 1, 3 }, { 3, 1, 1, 2 }
+};
+
+// G positions among the six left digits (bit 5 = leftmost) for each EAN-13 first digit
+const uint8_t EAN_FIRST_DIGIT_PARITY[10] = { 0x00, 0x0b, 0x0d, 0x0e, 0x13, 0x19, 0x1c, 0x15, 0x16, 0x1a };
+
+const int EAN13_RUNS = 59;
+const int EAN13_MODULES = 95;
+const int EAN8_RUNS = 43;
+const int EAN8_MODULES = 67;
+
+// Digit for four runs spanning 7 modules: 0-9 for L/R, 10-19 for G, -1 if no pattern is close.
+// `spread` is how much wider bars print than spaces, taken off each bar before matching.
+int matchDigit(const uint16_t* runs, bool allowG, bool firstDark, float spread) {
+    int sum = runs[0] + runs[1] + runs[2] + runs[3];
+    if (sum < 4) return -1;
+    float scale = 7.0f / sum;
+    float width[4];
+    for (int i = 0; i < 4; i++) {
+        bool dark = (i % 2 == 0) == firstDark;
+        width[i] = (runs[i] + (dark ? -spread : spread) / 2) * scale;
+    }
+    int best = -1;
+    float bestError = 1.6f;
+    for (int parity = 0; parity < (allowG ? 2 : 1); parity++) {
+        for (int d = 0; d < 10; d++) {
+            float error = 0;
+            bool close = true;
+            for (int i = 0; i < 4; i++) {
+                int expected = parity ? EAN_WIDTHS[d][3 - i] : EAN_WIDTHS[d][i];
+                float diff = fabsf(width[i] - expected);
+                if (diff > 0.8f) close = false;
+                error += diff;
+            }
+            if (close && error < bestError) {
+                bestError = error;
+                best = d + parity * 10;
+            }
+        }
+    }
+    return best;
+}
+
+bool guardRuns(const uint16_t* runs, int count, float moduleSize) {
+    for (int i = 0; i < count; i++) {
+        if (runs[i] < moduleSize * 0.4f || runs[i] > moduleSize * 1.9f) return false;
+    }
+    return true;
+}
+
+// How much wider bars read than spaces, from the single-module guard runs
+// (bar-space-bar at each end, space-bar-space-bar-space in the centre)
+float guardSpread(const uint16_t* runs, int start, int centre, int end) {
+    int bars = runs[start] + runs[start + 2] + runs[centre + 1] + runs[centre + 3] + runs[end] + runs[end + 2];
+    int spaces = runs[start + 1] + runs[centre] + runs[centre + 2] + runs[centre + 4] + runs[end + 1];
+    return bars / 6.0f - spaces / 5.0f;
+}
+
+// EAN-13 (or UPC-A) starting at dark run `s`
+bool decodeEan13(const uint16_t* runs, int count, int s, BarcodeResult* result) {
+    if (s + EAN13_RUNS >= count) return false;
+    int total = 0;
+    for (int i = 0; i < EAN13_RUNS; i++) total += runs[s + i];
+    float moduleSize = (float)total / EAN13_MODULES;
+    if (runs[s - 1] < moduleSize * 5 || runs[s + EAN13_RUNS] < moduleSize * 5) return false;
+    if (!guardRuns(runs + s, 3, moduleSize) || !guardRuns(runs + s + 27, 5, moduleSize) ||
+        !guardRuns(runs + s + 56, 3, moduleSize)) {
+        return false;
+    }
+    float spread = guardSpread(runs, s, s + 27, s + 56);
+
+    int digits[13];
+    int parity = 0;
+    for (int i = 0; i < 6; i++) {
+        int d = matchDigit(runs + s + 3 + 4 * i, true, false, spread);
+        if (d < 0) return false;
+        digits[i + 1] = d % 10;
+        parity = (parity << 1) | (d >= 10);
+    }
+    for (int i = 0; i < 6; i++) {
+        int d = matchDigit(runs + s + 32 + 4 * i, false, true, spread);
+        if (d < 0) return false;
+        digits[i + 7] = d;
+    }
+    digits[0] = -1;
+    for (int d = 0; d < 10; d++) {
+        if (EAN_FIRST_DIGIT_PARITY[d] == parity) digits[0] = d;
+    }
+    if (digits[0] < 0) return false;
+
+    int sum = 0;
+    for (int i = 0; i < 12; i++) {
+        sum += (i % 2) ? 3 * digits[i] : digits[i];
+    }
+    if ((sum + digits[12]) % 10 != 0) return false;
+
+    // UPC-A is EAN-13 with a leading zero
+    int first = digits[0] == 0 ? 1 : 0;
+    result->format = first ? BARCODE_UPCA : BARCODE_EAN13;
+    result->length = 0;
+    for (int i = first; i < 13; i++) {
+        result->text[result->length++] = '0' + digits[i];
+    }
+    result->text[result->length] = '\0';
+    return true;
+}
+
+bool decodeEan8(const uint16_t* runs, int count, int s, BarcodeResult* result) {
+    if (s + EAN8_RUNS >= count) return false;
+    int total = 0;
+    for (int i = 0; i < EAN8_RUNS; i++) total += runs[s + i];
+    float moduleSize = (float)total / EAN8_MODULES;
+    if (runs[s - 1] < moduleSize * 5 || runs[s + EAN8_RUNS] < moduleSize * 5) return false;
+    if (!guardRuns(runs + s, 3, moduleSize) || !guardRuns(runs + s + 19, 5, moduleSize) ||
+        !guardRuns(runs + s + 40, 3, moduleSize)) {
+        return false;
+    }
+    float spread = guardSpread(runs, s, s + 19, s + 40);
+
+    int digits[8];
+    for (int i = 0; i < 4; i++) {
+        int d = matchDigit(runs + s + 3 + 4 * i, false, false, spread);
+        int r = matchDigit(runs + s + 24 + 4 * i, false, true, spread);
+        if (d < 0 || r < 0) return false;
+        digits[i] = d;
+        digits[i + 4] = r;
+    }
+    int sum = 0;
+    for (int i = 0; i < 7; i++) {
+        sum += (i % 2) ? digits[i] : 3 * digits[i];
+    }
+    if ((sum + digits[7]) % 10 != 0) return false;
+
+    result->format = BARCODE_EAN8;
+    result->length = 8;
+    for (int i = 0; i < 8; i++) {
+        result->text[i] = '0' + digits[i];
+    }
+    result->text[8] = '\0';
+    return true;
+}
+
+void* allocateLarge(size_t size) {
+    return psramFound() ? ps_malloc(size) : malloc(size);
+}
+
+} // namespace
+
+BarcodeDecoder::BarcodeDecoder() {
+    binary = nullptr;
+    binaryCapacity = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+BarcodeDecoder::~BarcodeDecoder() {
+    releaseBuffers();
+}
+
+void BarcodeDecoder::releaseBuffers() {
+    if (binary) free(binary);
+    binary = nullptr;
+    binaryCapacity = 0;
+}
+
+bool BarcodeDecoder::decodeJpeg(const uint8_t* jpeg, size_t length, BarcodeResult* result) {
+    JpegPlane luma;
+    if (!jpegTranscoder.decodePlanes(jpeg, length, JPEG_SCALE_FULL, &luma, 1)) {
+        Serial.println("Barcode: failed to decode image");
+        return false;
+    }
+    bool found = decode(luma.data, luma.width, luma.height, luma.stride, result);
+    free(luma.data);
+    return found;
+}
+
+bool BarcodeDecoder::decode(const uint8_t* gray, int width, int height, int stride, BarcodeResult* result) {
+    unsigned long startTime = micros();
+    memset(result, 0, sizeof(BarcodeResult));
+    stats.scans++;
+
+    bool found = false;
+    if (binarize(gray, width, height, stride)) {
+        bool sawFinders = false;
+        found = findQr(width, height, result, &sawFinders);
+        if (found) {
+            stats.qrCodes++;
+        } else {
+            if (sawFinders) stats.qrFailures++;
+            found = scanLinear(width, height, result);
+            if (found) stats.linearCodes++;
+        }
+    }
+
+    unsigned long elapsed = micros() - startTime;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+    return found;
+}
+
+bool BarcodeDecoder::binarize(const uint8_t* gray, int width, int height, int stride) {
+    size_t pixels = (size_t)width * height;
+    if (pixels > binaryCapacity) {
+        releaseBuffers();
+        binary = (uint8_t*)allocateLarge(pixels);
+        if (!binary) {
+            Serial.println("Barcode: failed to allocate threshold buffer");
+            return false;
+        }
+        binaryCapacity = pixels;
+    }
+    uint32_t* columnSum = (uint32_t*)calloc(width, sizeof(uint32_t));
+    if (!columnSum) return false;
+
+    // Dark when below the mean of a square window, kept as running column sums
+    int radius = max(4, width / BARCODE_THRESHOLD_WINDOW / 2);
+    for (int y = 0; y < min(radius, height); y++) {
+        for (int x = 0; x < width; x++) columnSum[x] += gray[y * stride + x];
+    }
+    for (int y = 0; y < height; y++) {
+        int add = y + radius;
+        int drop = y - radius - 1;
+        if (add < height) {
+            for (int x = 0; x < width; x++) columnSum[x] += gray[add * stride + x];
+        }
+        if (drop >= 0) {
+            for (int x = 0; x < width; x++) columnSum[x] -= gray[drop * stride + x];
+        }
+        int rows = min(height - 1, y + radius) - max(0, y - radius) + 1;
+
+        uint32_t sum = 0;
+        for (int x = 0; x < min(radius, width); x++) sum += columnSum[x];
+        const uint8_t* in = gray + y * stride;
+        uint8_t* out = binary + y * width;
+        for (int x = 0; x < width; x++) {
+            if (x + radius < width) sum += columnSum[x + radius];
+            if (x - radius - 1 >= 0) sum -= columnSum[x - radius - 1];
+            int count = rows * (min(width - 1, x + radius) - max(0, x - radius) + 1);
+            out[x] = (uint32_t)(in[x] + BARCODE_THRESHOLD_OFFSET) * count < sum;
+        }
+    }
+    free(columnSum);
+    return true;
+}
+
+bool BarcodeDecoder::findQr(int width, int height, BarcodeResult* result, bool* sawFinders) {
+    FinderCandidate* candidates = (FinderCandidate*)malloc(MAX_FINDER_CANDIDATES * sizeof(FinderCandidate));
+    if (!candidates) return false;
+    int count = findFinderPatterns(binary, width, height, candidates);
+
+    // Best-confirmed candidates first
+    for (int i = 1; i < count; i++) {
+        FinderCandidate c = candidates[i];
+        int j = i - 1;
+        while (j >= 0 && candidates[j].count < c.count) {
+            candidates[j + 1] = candidates[j];
+            j--;
+        }
+        candidates[j + 1] = c;
+    }
+    int usable = 0;
+    while (usable < count && usable < BARCODE_MAX_FINDERS && candidates[usable].count >= 2) usable++;
+    *sawFinders = usable >= 3;
+
+    uint8_t* modules = (uint8_t*)malloc(177 * 177);
+    bool found = false;
+    for (int a = 0; a < usable && !found && modules; a++) {
+        for (int b = a + 1; b < usable && !found; b++) {
+            for (int c = b + 1; c < usable && !found; c++) {
+                // Top-left is the corner opposite the longest side
+                FinderCandidate p[3] = { candidates[a], candidates[b], candidates[c] };
+                float ab = distance(p[0], p[1]), bc = distance(p[1], p[2]), ac = distance(p[0], p[2]);
+                int corner = (bc >= ab && bc >= ac) ? 0 : (ac >= ab ? 1 : 2);
+                FinderCandidate topLeft = p[corner];
+                FinderCandidate topRight = p[(corner + 1) % 3];
+                FinderCandidate bottomLeft = p[(corner + 2) % 3];
+                float cross = (topRight.x - topLeft.x) * (bottomLeft.y - topLeft.y) -
+                              (topRight.y - topLeft.y) * (bottomLeft.x - topLeft.x);
+                if (cross < 0) {
+                    FinderCandidate t = topRight;
+                    topRight = bottomLeft;
+                    bottomLeft = t;
+                }
+
+                float legA = distance(topLeft, topRight);
+                float legB = distance(topLeft, bottomLeft);
+                // Finder sizes were measured along rows and columns, so a rotated code reads larger
+                float axis = max(fabsf(topRight.x - topLeft.x), fabsf(topRight.y - topLeft.y)) / legA;
+                float moduleSize = axis * (topLeft.moduleSize + topRight.moduleSize + bottomLeft.moduleSize) / 3;
+                float cosine = ((topRight.x - topLeft.x) * (bottomLeft.x - topLeft.x) +
+                                (topRight.y - topLeft.y) * (bottomLeft.y - topLeft.y)) / (legA * legB);
+                float sizeRatio = max(topLeft.moduleSize, max(topRight.moduleSize, bottomLeft.moduleSize)) /
+                                  min(topLeft.moduleSize, min(topRight.moduleSize, bottomLeft.moduleSize));
+                if (fabsf(cosine) > 0.4f || max(legA, legB) > 1.6f * min(legA, legB) || sizeRatio > 2.0f ||
+                    (legA + legB) / 2 < 10 * moduleSize) {
+                    continue;
+                }
+
+                int estimate = (int)lroundf(((legA + legB) / 2 / moduleSize + 7 - 17) / 4);
+                static const int tries[3] = { 0, -1, 1 };
+                for (int t = 0; t < 3 && !found; t++) {
+                    int version = estimate + tries[t];
+                    if (version < 1 || version > 40) continue;
+
+                    for (int attempt = 0; attempt < 2 && !found; attempt++) {
+                        int size = 17 + 4 * version;
+                        float modulePoints[8] = { 3.5f, 3.5f, size - 3.5f, 3.5f, 3.5f, size - 3.5f, 0, 0 };
+                        float imagePoints[8] = { topLeft.x, topLeft.y, topRight.x, topRight.y,
+                                                 bottomLeft.x, bottomLeft.y, 0, 0 };
+
+                        // Fourth point: the bottom-right alignment pattern when there is one
+                        float ax = 0, ay = 0;
+                        bool aligned = false;
+                        if (version >= 2) {
+                            float along = (size - 10.0f) / (size - 7.0f);
+                            float ex = topLeft.x + along * (topRight.x - topLeft.x + bottomLeft.x - topLeft.x);
+                            float ey = topLeft.y + along * (topRight.y - topLeft.y + bottomLeft.y - topLeft.y);
+                            for (float allowance = 4; allowance <= 16 && !aligned; allowance *= 2) {
+                                aligned = findAlignmentPattern(binary, width, height, ex, ey, moduleSize, allowance, &ax, &ay);
+                            }
+                        }
+
+                        // Otherwise the parallelogram corner, nudged by up to two modules since
+                        // three finders alone cannot show perspective
+                        float stepX[2] = { (topRight.x - topLeft.x) / (size - 7), (bottomLeft.x - topLeft.x) / (size - 7) };
+                        float stepY[2] = { (topRight.y - topLeft.y) / (size - 7), (bottomLeft.y - topLeft.y) / (size - 7) };
+                        // Scale the far sides by how module size changes across the code
+                        float shrinkU = bottomLeft.moduleSize / topLeft.moduleSize;
+                        float shrinkV = topRight.moduleSize / topLeft.moduleSize;
+                        float cornerX = ((bottomLeft.x + shrinkU * (topRight.x - topLeft.x)) +
+                                         (topRight.x + shrinkV * (bottomLeft.x - topLeft.x))) / 2;
+                        float cornerY = ((bottomLeft.y + shrinkU * (topRight.y - topLeft.y)) +
+                                         (topRight.y + shrinkV * (bottomLeft.y - topLeft.y))) / 2;
+                        bool resample = false;
+                        int first = aligned ? -1 : 0;
+                        for (int n = first; n < QR_CORNER_NUDGES && !found && !resample; n++) {
+                            if (n < 0) {
+                                modulePoints[6] = size - 6.5f;
+                                modulePoints[7] = size - 6.5f;
+                                imagePoints[6] = ax;
+                                imagePoints[7] = ay;
+                            } else {
+                                int du = QR_CORNER_NUDGE[n][0], dv = QR_CORNER_NUDGE[n][1];
+                                modulePoints[6] = size - 3.5f;
+                                modulePoints[7] = size - 3.5f;
+                                imagePoints[6] = cornerX + du * stepX[0] + dv * stepX[1];
+                                imagePoints[7] = cornerY + du * stepY[0] + dv * stepY[1];
+                            }
+
+                            Homography transform;
+                            if (!transform.solve(modulePoints, imagePoints) ||
+                                !sampleGrid(binary, width, height, transform, size, modules)) {
+                                continue;
+                            }
+                            // Large codes carry their version; resample once if the estimate was off
+                            if (version >= 7 && attempt == 0 && n == first) {
+                                int read = readQrVersion(modules, size);
+                                if (read && read != version) {
+                                    version = read;
+                                    resample = true;
+                                    continue;
+                                }
+                            }
+                            if (decodeQrModules(modules, size, result)) {
+                                float cx, cy;
+                                transform.map(size / 2.0f, size / 2.0f, &cx, &cy);
+                                result->x = (uint16_t)constrain((int)cx, 0, width - 1);
+                                result->y = (uint16_t)constrain((int)cy, 0, height - 1);
+                                found = true;
+                            }
+                        }
+                        if (!resample) break;
+                    }
+                }
+            }
+        }
+    }
+    free(modules);
+    free(candidates);
+    return found;
+}
+
+int BarcodeDecoder::readQrVersion(const uint8_t* modules, int size) {
+    if (size < 45 || size > 177 || (size - 17) % 4) return 0;
+    for (int copy = 0; copy < 2; copy++) {
+        uint32_t raw = 0;
+        for (int bit = 17; bit >= 0; bit--) {
+            int row = copy ? size - 11 + bit % 3 : bit / 3;
+            int column = copy ? bit / 3 : size - 11 + bit % 3;
+            raw = (raw << 1) | module(modules, size, row, column);
+        }
+        for (int version = 7; version <= 40; version++) {
+            uint32_t codeword = (version << 12) | bchRemainder(version, 0x1f25, 12);
+            if (hammingDistance(raw, codeword) <= 3) return version;
+        }
+    }
+    return 0;
+}
+
+bool BarcodeDecoder::decodeQrModules(const uint8_t* modules, int size, BarcodeResult* result) {
+    if (size < 21 || size > 177 || (size - 17) % 4) return false;
+    int version = (size - 17) / 4;
+
+    int format = readFormat(modules, size);
+    if (format < 0) return false;
+    int level = format >> 3;
+    int mask = format & 7;
+    const QrBlockLayout& layout = QR_BLOCKS[version - 1][QR_LEVEL_INDEX[level]];
+    int blocks = layout.shortBlocks + layout.longBlocks;
+    int shortLength = layout.shortData + layout.ecc;
+    int total = layout.shortBlocks * shortLength + layout.longBlocks * (shortLength + 1);
+
+    uint8_t* reserved = (uint8_t*)malloc(size * size);
+    uint8_t* raw = (uint8_t*)calloc(total, 1);
+    uint8_t* data = (uint8_t*)malloc(total);
+    if (!reserved || !raw || !data) {
+        free(reserved);
+        free(raw);
+        free(data);
+        return false;
+    }
+    markFunctionModules(reserved, size, version);
+
+    // Codewords in the two-column zigzag from the bottom-right corner
+    int bit = 0;
+    int row = size - 1;
+    int direction = -1;
+    for (int column = size - 1; column > 0 && bit < total * 8; ) {
+        if (column == 6) column--;
+        for (int c = column; c >= column - 1; c--) {
+            if (reserved[row * size + c] || bit >= total * 8) continue;
+            bool value = modules[row * size + c] ^ maskBit(mask, row, c);
+            if (value) raw[bit >> 3] |= 0x80 >> (bit & 7);
+            bit++;
+        }
+        row += direction;
+        if (row < 0 || row >= size) {
+            direction = -direction;
+            row += direction;
+            column -= 2;
+        }
+    }
+
+    // De-interleave, correct and concatenate the data codewords
+    bool ok = true;
+    int corrected = 0;
+    int dataLength = 0;
+    uint8_t block[QR_MAX_BLOCK];
+    for (int b = 0; b < blocks && ok; b++) {
+        int dataCount = layout.shortData + (b >= layout.shortBlocks ? 1 : 0);
+        for (int i = 0; i < dataCount; i++) {
+            // Long blocks take their extra data codeword after all short ones have run out
+            int index = i < layout.shortData ? i * blocks + b
+                                              : layout.shortData * blocks + (b - layout.shortBlocks);
+            block[i] = raw[index];
+        }
+        int eccStart = layout.shortData * blocks + layout.longBlocks;
+        for (int i = 0; i < layout.ecc; i++) {
+            block[dataCount + i] = raw[eccStart + i * blocks + b];
+        }
+        int fixed = correctBlock(block, dataCount + layout.ecc, layout.ecc);
+        if (fixed < 0) {
+            ok = false;
+            break;
+        }
+        corrected += fixed;
+        memcpy(data + dataLength, block, dataCount);
+        dataLength += dataCount;
+    }
+
+    if (ok) {
+        result->length = 0;
+        ok = decodePayload(data, dataLength, version, result);
+        if (ok) {
+            result->format = BARCODE_QR;
+            result->version = version;
+            result->eccLevel = QR_LEVEL_NAME[level];
+            result->correctedErrors = min(corrected, 255);
+        }
+    }
+    free(reserved);
+    free(raw);
+    free(data);
+    return ok;
+}
+
+bool BarcodeDecoder::decodeLinearRuns(const uint16_t* runs, int count, BarcodeResult* result, int* centreRun) {
+    for (int s = 1; s < count; s += 2) {
+        if (decodeEan13(runs, count, s, result)) {
+            *centreRun = s + 29;
+            return true;
+        }
+        if (decodeEan8(runs, count, s, result)) {
+            *centreRun = s + 21;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BarcodeDecoder::scanLinear(int width, int height, BarcodeResult* result) {
+    uint16_t* runs = (uint16_t*)malloc((width + 2) * sizeof(uint16_t));
+    uint16_t* reversed = (uint16_t*)malloc((width + 2) * sizeof(uint16_t));
+    if (!runs || !reversed) {
+        free(runs);
+        free(reversed);
+        return false;
+    }
+
+    struct Vote {
+        BarcodeFormat format;
+        char text[14];
+        int votes;
+        int x;
+        int y;
+    };
+    Vote votes[BARCODE_LINEAR_ROWS * 2];
+    int voteCount = 0;
+    bool found = false;
+
+    for (int k = 0; k < BARCODE_LINEAR_ROWS && !found; k++) {
+        int y = (k + 1) * height / (BARCODE_LINEAR_ROWS + 1);
+        const uint8_t* row = binary + y * width;
+
+        // Alternating light/dark runs, starting with a (possibly empty) light run
+        int count = 1;
+        runs[0] = 0;
+        uint8_t colour = 0;
+        for (int x = 0; x < width; x++) {
+            if (row[x] != colour) {
+                colour = row[x];
+                runs[count++] = 0;
+            }
+            runs[count - 1]++;
+        }
+
+        // Also read right to left for codes held upside down
+        int reversedCount = 0;
+        if (colour) reversed[reversedCount++] = 0;
+        for (int i = count - 1; i >= 0; i--) {
+            reversed[reversedCount++] = runs[i];
+        }
+
+        for (int direction = 0; direction < 2 && !found; direction++) {
+            const uint16_t* line = direction ? reversed : runs;
+            int lineCount = direction ? reversedCount : count;
+            BarcodeResult candidate;
+            int centreRun;
+            if (!decodeLinearRuns(line, lineCount, &candidate, &centreRun)) continue;
+
+            int x = 0;
+            for (int i = 0; i < centreRun; i++) x += line[i];
+            x += line[centreRun] / 2;
+            if (direction) x = width - 1 - x;
+
+            int v = 0;
+            while (v < voteCount && (votes[v].format != candidate.format || strcmp(votes[v].text, candidate.text))) v++;
+            if (v == voteCount) {
+                votes[v].format = candidate.format;
+                strcpy(votes[v].text, candidate.text);
+                votes[v].votes = 0;
+                votes[v].x = 0;
+                votes[v].y = 0;
+                voteCount++;
+            }
+            votes[v].votes++;
+            votes[v].x += x;
+            votes[v].y += y;
+            if (votes[v].votes >= BARCODE_LINEAR_VOTES) {
+                result->format = candidate.format;
+                strcpy(result->text, candidate.text);
+                result->length = strlen(candidate.text);
+                result->x = votes[v].x / votes[v].votes;
+                result->y = votes[v].y / votes[v].votes;
+                found = true;
+            }
+        }
+    }
+    free(runs);
+    free(reversed);
+    return found;
+}
+
+const char* BarcodeDecoder::formatName(BarcodeFormat format) {
+    switch (format) {
+        case BARCODE_QR: return "QR code";
+        case BARCODE_EAN13: return "EAN-13";
+        case BARCODE_UPCA: return "UPC-A";
+        case BARCODE_EAN8: return "EAN-8";
+        default: return "none";
+    }
+}
+
+BarcodeDecoderStats BarcodeDecoder::getStats() {
+    return stats;
+}
+
+void BarcodeDecoder::logStats() {
+    if (stats.scans == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.scans);
+    Serial.printf("Barcode: %u scans, %u QR, %u EAN/UPC, %u QR undecodable, avg %lu us\n",
+                  stats.scans, stats.qrCodes, stats.linearCodes, stats.qrFailures, avgMicros);
+}
@@ -0,0 +1,81 @@
+#ifndef BARCODE_DECODER_H
+#define BARCODE_DECODER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+enum BarcodeFormat {
+    BARCODE_NONE,
+    BARCODE_QR,
+    BARCODE_EAN13,
+    BARCODE_UPCA,
+    BARCODE_EAN8
+};
+
+struct BarcodeResult {
+    BarcodeFormat format;
+    char text[BARCODE_MAX_TEXT + 1];  // Payload, NUL-terminated (QR byte mode is passed through as-is)
+    uint16_t length;
+    uint8_t version;          // QR version, 0 for linear codes
+    char eccLevel;            // QR error correction level 'L', 'M', 'Q' or 'H'
+    uint8_t correctedErrors;  // Codewords repaired by Reed-Solomon
+    uint16_t x;               // Centre of the code in image pixels
+    uint16_t y;
+};
+
+struct BarcodeDecoderStats {
+    uint32_t scans;
+    uint32_t qrCodes;
+    uint32_t linearCodes;
+    uint32_t qrFailures;      // Scans with QR finder patterns but no valid decode
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// On-device QR code and EAN/UPC decoder working on a grayscale image.
+// The image is thresholded against a local mean; QR codes are located from their
+// 1:1:3:1:1 finder patterns, sampled through a perspective transform anchored on
+// the finders and the bottom-right alignment pattern, then Reed-Solomon corrected.
+// EAN-13, UPC-A and EAN-8 are read from horizontal scanlines and must be seen on
+// BARCODE_LINEAR_VOTES lines before they are reported.
+class BarcodeDecoder {
+private:
+    uint8_t* binary;          // Thresholded image, 1 = dark
+    size_t binaryCapacity;
+    BarcodeDecoderStats stats;
+
+    bool binarize(const uint8_t* gray, int width, int height, int stride);
+    bool findQr(int width, int height, BarcodeResult* result, bool* sawFinders);
+    bool scanLinear(int width, int height, BarcodeResult* result);
+
+public:
+    BarcodeDecoder();
+    ~BarcodeDecoder();
+
+    // Find and decode one code in a luma plane or a JPEG
+    bool decode(const uint8_t* gray, int width, int height, int stride, BarcodeResult* result);
+    bool decodeJpeg(const uint8_t* jpeg, size_t length, BarcodeResult* result);
+
+    // QR payload from a sampled module grid (row-major, 1 = dark)
+    static bool decodeQrModules(const uint8_t* modules, int size, BarcodeResult* result);
+    // Version from the version information blocks (versions 7+), 0 if unreadable
+    static int readQrVersion(const uint8_t* modules, int size);
+
+    // EAN-13 / UPC-A / EAN-8 from the run lengths of one scanline; runs alternate
+    // light/dark starting with a light run (which may be empty)
+    static bool decodeLinearRuns(const uint16_t* runs, int count, BarcodeResult* result, int* centreRun);
+
+    static const char* formatName(BarcodeFormat format);
+
+    // Free the threshold buffer between scans
+    void releaseBuffers();
+
+    // Statistics
+    BarcodeDecoderStats getStats();
+    void logStats();
+};
+
+// Global barcode decoder instance
+extern BarcodeDecoder barcodeDecoder;
+
+#endif // BARCODE_DECODER_H
@@ -1,21 +1,71 @@
 #include "camera_manager.h"
 #include "board_config.h"
 #include "camera_pins.h"
+#include "jpeg_transcoder.h"
+#include "img_converters.h"
 #include <cstring>
 
 CameraManager cameraManager;
 
+// Capture profile per operation mode, indexed by OperationMode
+static const CaptureProfile captureProfiles[] = {
+    // Hazard detection: coarse scene layout is enough, keep uploads small
+    { FRAMESIZE_QVGA, 14, false, 0, 0, 0, 0, 0, 0, 12000 },
+    // Visual caption: whole scene at moderate detail
+    { FRAMESIZE_VGA,  12, false, 0, 0, 0, 0, 0, 0, 24000 },
+    // Sign detection: a little more detail for distant signs
+    { FRAMESIZE_SVGA, 12, false, 0, 0, 0, 0, 0, 0, 32000 },
+    // OCR: central window at native sensor resolution, never traded for size
+    { FRAMESIZE_SXGA, 10, true, 0.15, 0.20, 0.70, 0.60, 1120, 720, 0 },
+    // Barcode: decoded on the device, so quality matters more than size; SVGA keeps a
+    // hand-held code at two or more pixels per module while the scan stays quick
+    { FRAMESIZE_SVGA, 8, false, 0, 0, 0, 0, 0, 0, 0 },
+    // Colour: only a reduced decode of the centre is read, VGA is plenty
+    { FRAMESIZE_VGA,  12, false, 0, 0, 0, 0, 0, 0, 0 },
+    // Auto mode: one full-resolution frame, smaller tasks read pyramid levels
+    { FRAMESIZE_SXGA, 10, false, 0, 0, 0, 0, 0, 0, 0 }
+};
+
+// Target width per pyramid level (0 = as captured); each level takes the
+// coarsest power-of-two DCT reduction that stays at or above its target
+static const uint16_t pyramidLevelWidths[PYRAMID_LEVEL_COUNT] = { 0, 640, 320, 160 };
+
+// Blanking added around a custom OV3660/OV5640 window (HTS/VTS), and ISP crop inside it
+static const int SENSOR_WINDOW_HBLANK = 220;
+static const int SENSOR_WINDOW_VBLANK = 24;
+static const int SENSOR_WINDOW_ISP_OFFSET_X = 16;
+static const int SENSOR_WINDOW_ISP_OFFSET_Y = 4;
+
 CameraManager::CameraManager() {
     isInitialized = false;
     sensor = nullptr;
     lastCaptureTime = 0;
     captureCount = 0;
     autoCaptureEnabled = true; // Enable by default for glasses
+    activeProfileMode = MODE_VISUAL_CAPTION;
+    framesToSkip = 0;
+    sensorLock = nullptr;
+    sensorWriteCount = 0;
+    memset(profileStats, 0, sizeof(profileStats));
+    memset(&budgetStats, 0, sizeof(budgetStats));
+    currentPyramid = nullptr;
+    livePyramids = 0;
+    pyramidLock = nullptr;
+    memset(&pyramidStats, 0, sizeof(pyramidStats));
+    invalidateSensorState();
 }
 
 bool CameraManager::initialize() {
     Serial.println("Initializing camera...");
     
+    if (!sensorLock) {
+        sensorLock = xSemaphoreCreateMutex();
+    }
+    if (!sensorLock) {
+        Serial.println("Failed to create camera lock");
+        return false;
+    }
+    
     // Configure camera
     config.ledc_channel = LEDC_CHANNEL_0;
     config.ledc_timer = LEDC_TIMER_0;
@@ -45,6 +95,8 @@ bool CameraManager::initialize() {
     
     // Optimize for PSRAM if available
     if (psramFound()) {
+        // Frame buffers are sized once at init, so allocate for the largest capture profile
+        config.frame_size = FRAMESIZE_UXGA;
         config.jpeg_quality = 10;
         config.fb_count = 2;
         config.grab_mode = CAMERA_GRAB_LATEST;
@@ -77,27 +129,144 @@ bool CameraManager::initialize() {
     setupDefaultSettings();
     logCameraStatus();
     
+    if (!pyramidLock) {
+        pyramidLock = xSemaphoreCreateMutex();
+    }
+    
     isInitialized = true;
     Serial.println("Camera initialized successfully");
     return true;
 }
 
 bool CameraManager::reconfigure(framesize_t frameSize, int jpegQuality) {
+    CaptureProfile profile = { frameSize, jpegQuality, false, 0, 0, 0, 0, 0, 0, 0 };
+    return reconfigure(profile);
+}
+
+bool CameraManager::reconfigure(const CaptureProfile& profile) {
     if (!isInitialized) return false;
     
-    setFrameSize(frameSize);
-    setJPEGQuality(jpegQuality);
+    bool success = true;
+    bool windowed = false;
+    xSemaphoreTake(sensorLock, portMAX_DELAY);
     
-    Serial.printf("Camera reconfigured - Frame size: %d, JPEG quality: %d\n", 
-                  frameSize, jpegQuality);
-    return true;
+    // Only touch registers whose value differs from what the sensor already has
+    if (profile.useWindow) {
+        SensorWindow window;
+        if (computeSensorWindow(profile, window)) {
+            if (windowActive && memcmp(&window, &appliedWindow, sizeof(window)) == 0) {
+                windowed = true;
+            } else if (applySensorWindow(window)) {
+                windowed = true;
+            } else {
+                Serial.println("Sensor windowing not supported - using full frame");
+            }
+        }
+    }
+    
+    if (!windowed && (windowActive || profile.frameSize != appliedFrameSize)) {
+        success = setFrameSize(profile.frameSize) && success;
+    }
+    
+    if (profile.jpegQuality != appliedQuality) {
+        success = setJPEGQuality(profile.jpegQuality) && success;
+    }
+    xSemaphoreGive(sensorLock);
+    
+    if (windowed) {
+        Serial.printf("Camera reconfigured - Window: %dx%d at %d,%d -> %dx%d, JPEG quality: %d\n",
+                      appliedWindow.width, appliedWindow.height, appliedWindow.startX, appliedWindow.startY,
+                      appliedWindow.outputWidth, appliedWindow.outputHeight, appliedQuality);
+    } else {
+        Serial.printf("Camera reconfigured - Frame size: %d, JPEG quality: %d\n", 
+                      appliedFrameSize, appliedQuality);
+    }
+    return success;
+}
+
+const CaptureProfile& CameraManager::getCaptureProfile(OperationMode mode) {
+    if (mode < MODE_HAZARD_DETECTION || mode > MODE_AUTO_ALL) {
+        return captureProfiles[MODE_VISUAL_CAPTION];
+    }
+    return captureProfiles[mode];
+}
+
+size_t CameraManager::getMaxJpegSize() {
+    // The driver holds a JPEG frame in a fifth of a byte per pixel
+    size_t largest = 0;
+    for (int mode = MODE_HAZARD_DETECTION; mode <= MODE_AUTO_ALL; mode++) {
+        const CaptureProfile& profile = captureProfiles[mode];
+        size_t pixels = profile.useWindow ? (size_t)profile.outputWidth * profile.outputHeight
+                                          : (size_t)resolution[profile.frameSize].width * resolution[profile.frameSize].height;
+        largest = max(largest, pixels / 5);
+    }
+    return largest;
+}
+
+bool CameraManager::applyCaptureProfile(OperationMode mode) {
+    if (!isInitialized) return false;
+    
+    unsigned long switchStart = micros();
+    uint32_t writesBefore = sensorWriteCount;
+    
+    bool success = reconfigure(getCaptureProfile(mode));
+    
+    unsigned long switchTime = micros() - switchStart;
+    activeProfileMode = mode;
+    
+    CaptureProfileStats& stats = profileStats[mode];
+    stats.switches++;
+    stats.sensorWrites += sensorWriteCount - writesBefore;
+    stats.lastSwitchMicros = switchTime;
+    stats.totalSwitchMicros += switchTime;
+    
+    Serial.printf("Capture profile %d applied in %lu us (%u register writes)\n",
+                  mode, switchTime, sensorWriteCount - writesBefore);
+    return success;
+}
+
+OperationMode CameraManager::getActiveProfileMode() {
+    return activeProfileMode;
+}
+
+CaptureProfileStats CameraManager::getProfileStats(OperationMode mode) {
+    return profileStats[mode];
+}
+
+void CameraManager::logProfileStats() {
+    Serial.println("=== Capture Profiles ===");
+    for (int i = MODE_HAZARD_DETECTION; i <= MODE_AUTO_ALL; i++) {
+        const CaptureProfileStats& stats = profileStats[i];
+        unsigned long avgBytes = stats.frames > 0 ? (unsigned long)(stats.totalBytes / stats.frames) : 0;
+        unsigned long avgSwitch = stats.switches > 0 ? (unsigned long)(stats.totalSwitchMicros / stats.switches) : 0;
+        Serial.printf("Mode %d: %u frames, avg %lu bytes/frame, %u switches, avg switch %lu us, %u register writes\n",
+                      i, stats.frames, avgBytes, stats.switches, avgSwitch, stats.sensorWrites);
+    }
+    
+    if (budgetStats.budgetedFrames > 0) {
+        unsigned long avgBefore = budgetStats.reencodedFrames > 0 ? (unsigned long)(budgetStats.bytesBefore / budgetStats.reencodedFrames) : 0;
+        unsigned long avgAfter = budgetStats.reencodedFrames > 0 ? (unsigned long)(budgetStats.bytesAfter / budgetStats.reencodedFrames) : 0;
+        unsigned long avgMicros = budgetStats.reencodedFrames > 0 ? (unsigned long)(budgetStats.totalMicros / budgetStats.reencodedFrames) : 0;
+        Serial.printf("Byte budget: %u frames, %u re-encoded (%lu -> %lu bytes avg, %lu us avg), %u encodes, %u over budget\n",
+                      budgetStats.budgetedFrames, budgetStats.reencodedFrames, avgBefore, avgAfter, avgMicros,
+                      budgetStats.totalEncodes, budgetStats.overBudgetFrames);
+    }
+    if (pyramidStats.captures > 0) {
+        unsigned long avgDerive = pyramidStats.levelsDerived > 0 ? (unsigned long)(pyramidStats.deriveMicros / pyramidStats.levelsDerived) : 0;
+        Serial.printf("Pyramid: %u captures, %u level requests, %u derived (avg %lu us), %u refused, %u bytes live, %u peak\n",
+                      pyramidStats.captures, pyramidStats.levelRequests, pyramidStats.levelsDerived, avgDerive,
+                      pyramidStats.refused, (unsigned)pyramidStats.liveBytes, (unsigned)pyramidStats.peakBytes);
+    }
+    Serial.println("========================");
 }
 
 void CameraManager::deinitialize() {
     if (isInitialized) {
+        xSemaphoreTake(sensorLock, portMAX_DELAY);
         esp_camera_deinit();
         isInitialized = false;
         sensor = nullptr;
+        xSemaphoreGive(sensorLock);
         Serial.println("Camera deinitialized");
     }
 }
@@ -108,7 +277,17 @@ camera_fb_t* CameraManager::captureImage() {
         return nullptr;
     }
     
+    xSemaphoreTake(sensorLock, portMAX_DELAY);
     camera_fb_t* fb = esp_camera_fb_get();
+    
+    // Buffers filled before a geometry change still carry the old settings
+    while (fb && framesToSkip > 0) {
+        framesToSkip--;
+        esp_camera_fb_return(fb);
+        fb = esp_camera_fb_get();
+    }
+    xSemaphoreGive(sensorLock);
+    
     if (!fb) {
         Serial.println("Camera capture failed");
         return nullptr;
@@ -116,6 +295,8 @@ camera_fb_t* CameraManager::captureImage() {
     
     lastCaptureTime = millis();
     captureCount++;
+    profileStats[activeProfileMode].frames++;
+    profileStats[activeProfileMode].totalBytes += fb->len;
     
     Serial.printf("Image captured: %d bytes, %dx%d\n", 
                   fb->len, fb->width, fb->height);
@@ -123,6 +304,36 @@ camera_fb_t* CameraManager::captureImage() {
     return fb;
 }
 
+bool CameraManager::captureGrayscale(JpegPlane* luma) {
+    camera_fb_t* fb = captureImage();
+    if (!fb) {
+        return false;
+    }
+    
+    // Luma only; chroma is never decoded
+    bool decoded = jpegTranscoder.decodePlanes(fb->buf, fb->len, JPEG_SCALE_FULL, luma, 1);
+    releaseFrameBuffer(fb);
+    if (!decoded) {
+        Serial.println("Failed to decode grayscale frame");
+    }
+    return decoded;
+}
+
+camera_fb_t* CameraManager::grabPreviewFrame() {
+    if (!isInitialized) return nullptr;
+    
+    // Never makes a capture or a profile switch wait
+    if (xSemaphoreTake(sensorLock, 0) != pdTRUE) return nullptr;
+    camera_fb_t* fb = isInitialized ? esp_camera_fb_get() : nullptr;
+    while (fb && framesToSkip > 0) {
+        framesToSkip--;
+        esp_camera_fb_return(fb);
+        fb = esp_camera_fb_get();
+    }
+    xSemaphoreGive(sensorLock);
+    return fb;
+}
+
 void CameraManager::releaseFrameBuffer(camera_fb_t* fb) {
     if (fb) {
         esp_camera_fb_return(fb);
@@ -130,11 +341,29 @@ void CameraManager::releaseFrameBuffer(camera_fb_t* fb) {
 }
 
 bool CameraManager::captureToBuffer(uint8_t** imageData, size_t* imageSize) {
+    return captureToBuffer(imageData, imageSize, getCaptureProfile(activeProfileMode).byteBudget);
+}
+
+bool CameraManager::captureToBuffer(uint8_t** imageData, size_t* imageSize, size_t byteBudget) {
     camera_fb_t* fb = captureImage();
     if (!fb) {
         return false;
     }
     
+    // Auto mode tasks read their own resolution from the pyramid of this frame
+    if (activeProfileMode == MODE_AUTO_ALL) {
+        storePyramid(fb);
+    }
+    
+    if (byteBudget > 0) {
+        budgetStats.budgetedFrames++;
+        if (fb->format != PIXFORMAT_JPEG || fb->len > byteBudget) {
+            bool success = encodeToBudget(fb, byteBudget, imageData, imageSize);
+            releaseFrameBuffer(fb);
+            return success;
+        }
+    }
+    
     // Allocate buffer and copy data
     *imageSize = fb->len;
     *imageData = (uint8_t*)malloc(*imageSize);
@@ -151,14 +380,237 @@ bool CameraManager::captureToBuffer(uint8_t** imageData, size_t* imageSize) {
     return true;
 }
 
+// Typical JPEG rate of a fresh encode, used to aim the first pass on a raw frame:
+// about 1.6 bits per pixel at quality 50, size ~ scale^-0.9, finest scale = quality 95
+static const size_t RAW_FRAME_PIXELS_PER_BYTE = 5;
+static const float RAW_FRAME_RATE_EXPONENT = 0.9;
+static const float RAW_FRAME_MIN_SCALE = 0.1;
+
+// frame2jpg() wrapper for the budget search on raw (RGB565/YUV) frames
+static bool encodeRawFrame(void* context, float quantScale, uint8_t** output, size_t* outputSize) {
+    camera_fb_t* fb = (camera_fb_t*)context;
+    return frame2jpg(fb, JpegTranscoder::quantScaleToQuality(quantScale), output, outputSize);
+}
+
+bool CameraManager::encodeToBudget(camera_fb_t* fb, size_t byteBudget, uint8_t** imageData, size_t* imageSize) {
+    unsigned long startTime = micros();
+    JpegBudgetResult result;
+    bool success;
+    
+    if (fb->format == PIXFORMAT_JPEG) {
+        // Requantize the sensor's JPEG in the coefficient domain rather than decoding it
+        success = jpegTranscoder.fitToBudget(fb->buf, fb->len, byteBudget, imageData, imageSize, &result);
+    } else {
+        // First pass is aimed with a rough rate estimate (about 1.6 bits per pixel at quality 50)
+        JpegRateEstimate estimate = { (size_t)fb->width * fb->height / RAW_FRAME_PIXELS_PER_BYTE,
+                                      1.0, RAW_FRAME_RATE_EXPONENT, RAW_FRAME_MIN_SCALE, false };
+        success = jpegTranscoder.encodeToBudget(encodeRawFrame, fb, byteBudget, estimate,
+                                                imageData, imageSize, &result);
+    }
+    
+    if (!success) {
+        Serial.println("Byte-budget encode failed");
+        return false;
+    }
+    
+    unsigned long elapsed = micros() - startTime;
+    budgetStats.reencodedFrames++;
+    budgetStats.totalEncodes += result.encodes;
+    budgetStats.bytesBefore += fb->len;
+    budgetStats.bytesAfter += result.size;
+    budgetStats.totalMicros += elapsed;
+    if (!result.withinBudget) {
+        budgetStats.overBudgetFrames++;
+    }
+    
+    Serial.printf("Byte budget %u: %u -> %u bytes in %d encodes (scale %.2f, %lu us)\n",
+                  (unsigned)byteBudget, (unsigned)fb->len, (unsigned)result.size,
+                  result.encodes, result.quantScale, elapsed);
+    return true;
+}
+
+CaptureBudgetStats CameraManager::getBudgetStats() {
+    return budgetStats;
+}
+
+bool CameraManager::storePyramid(camera_fb_t* fb) {
+    if (!pyramidLock || fb->format != PIXFORMAT_JPEG) {
+        return false;
+    }
+    
+    xSemaphoreTake(pyramidLock, portMAX_DELAY);
+    
+    // Bounded: each pipeline stage holds at most one pyramid
+    if (livePyramids >= PYRAMID_MAX_LIVE) {
+        pyramidStats.refused++;
+        xSemaphoreGive(pyramidLock);
+        Serial.println("Pyramid capture refused: earlier frames still in use");
+        return false;
+    }
+    
+    // Copy out of the frame buffer so the driver can refill it
+    uint8_t* full = (uint8_t*)(psramFound() ? ps_malloc(fb->len) : malloc(fb->len));
+    if (!full) {
+        xSemaphoreGive(pyramidLock);
+        Serial.println("Failed to allocate pyramid frame");
+        return false;
+    }
+    memcpy(full, fb->buf, fb->len);
+    
+    FramePyramid* pyramid = new FramePyramid();
+    memset(pyramid, 0, sizeof(FramePyramid));
+    pyramid->captureNumber = captureCount;
+    pyramid->captureTime = millis();
+    pyramid->refCount = 1;
+    pyramid->levels[PYRAMID_FULL] = { full, fb->len, (uint16_t)fb->width, (uint16_t)fb->height };
+    
+    livePyramids++;
+    pyramidStats.captures++;
+    pyramidStats.liveBytes += fb->len;
+    pyramidStats.peakBytes = max(pyramidStats.peakBytes, pyramidStats.liveBytes);
+    
+    FramePyramid* previous = currentPyramid;
+    currentPyramid = pyramid;
+    if (previous) {
+        dropPyramidRef(previous);
+    }
+    
+    xSemaphoreGive(pyramidLock);
+    return true;
+}
+
+FramePyramid* CameraManager::acquirePyramid() {
+    if (!pyramidLock) return nullptr;
+    
+    xSemaphoreTake(pyramidLock, portMAX_DELAY);
+    FramePyramid* pyramid = currentPyramid;
+    if (pyramid) {
+        pyramid->refCount++;
+    }
+    xSemaphoreGive(pyramidLock);
+    return pyramid;
+}
+
+FramePyramid* CameraManager::acquireCapturedPyramid() {
+    FramePyramid* pyramid = acquirePyramid();
+    if (pyramid && pyramid->captureNumber != captureCount) {
+        // The latest capture was refused a pyramid; this one belongs to an older frame
+        releasePyramid(pyramid);
+        return nullptr;
+    }
+    return pyramid;
+}
+
+FramePyramid* CameraManager::retainPyramid(FramePyramid* pyramid) {
+    if (!pyramid || !pyramidLock) return nullptr;
+    
+    xSemaphoreTake(pyramidLock, portMAX_DELAY);
+    pyramid->refCount++;
+    xSemaphoreGive(pyramidLock);
+    return pyramid;
+}
+
+bool CameraManager::getPyramidLevel(FramePyramid* pyramid, PyramidLevel level, PyramidImage* image) {
+    if (!pyramid || !pyramidLock || level < PYRAMID_FULL || level >= PYRAMID_LEVEL_COUNT) {
+        return false;
+    }
+    
+    // Held across derivation so concurrent consumers transcode each level only once
+    xSemaphoreTake(pyramidLock, portMAX_DELAY);
+    pyramidStats.levelRequests++;
+    
+    PyramidImage& target = pyramid->levels[level];
+    if (!target.data) {
+        const PyramidImage& full = pyramid->levels[PYRAMID_FULL];
+        int scale = 1;
+        while (scale < JPEG_SCALE_EIGHTH && full.width / (scale * 2) >= pyramidLevelWidths[level]) {
+            scale *= 2;
+        }
+        
+        // Levels that need no reduction share the full frame's buffer
+        if (scale == 1) {
+            target = full;
+        } else {
+            unsigned long deriveStart = micros();
+            JpegTranscodeOptions options;
+            options.crop = false;
+            options.cropRect = { 0, 0, 0, 0 };
+            options.scale = (JpegScale)scale;
+            options.quantScale = 1.0;
+            options.optimizeHuffman = false;
+            options.timeLimitMicros = 0;
+            
+            uint8_t* data = nullptr;
+            size_t size = 0;
+            if (!jpegTranscoder.transcode(full.data, full.size, options, &data, &size)) {
+                xSemaphoreGive(pyramidLock);
+                Serial.printf("Failed to derive pyramid level %d\n", level);
+                return false;
+            }
+            target = { data, size, (uint16_t)((full.width + scale - 1) / scale),
+                       (uint16_t)((full.height + scale - 1) / scale) };
+            
+            pyramidStats.levelsDerived++;
+            pyramidStats.deriveMicros += micros() - deriveStart;
+            pyramidStats.liveBytes += size;
+            pyramidStats.peakBytes = max(pyramidStats.peakBytes, pyramidStats.liveBytes);
+        }
+    }
+    
+    *image = target;
+    xSemaphoreGive(pyramidLock);
+    return true;
+}
+
+void CameraManager::releasePyramid(FramePyramid* pyramid) {
+    if (!pyramid || !pyramidLock) return;
+    
+    xSemaphoreTake(pyramidLock, portMAX_DELAY);
+    dropPyramidRef(pyramid);
+    xSemaphoreGive(pyramidLock);
+}
+
+// Called with pyramidLock held
+void CameraManager::dropPyramidRef(FramePyramid* pyramid) {
+    if (--pyramid->refCount > 0) return;
+    
+    const uint8_t* full = pyramid->levels[PYRAMID_FULL].data;
+    for (int i = 0; i < PYRAMID_LEVEL_COUNT; i++) {
+        PyramidImage& level = pyramid->levels[i];
+        if (!level.data || (i != PYRAMID_FULL && level.data == full)) continue;
+        pyramidStats.liveBytes -= level.size;
+        free((void*)level.data);
+    }
+    livePyramids--;
+    delete pyramid;
+}
+
+PyramidStats CameraManager::getPyramidStats() {
+    return pyramidStats;
+}
+
 bool CameraManager::setFrameSize(framesize_t size) {
     if (!sensor) return false;
-    return sensor->set_framesize(sensor, size) == 0;
+    sensorWriteCount++;
+    if (sensor->set_framesize(sensor, size) != 0) {
+        invalidateSensorState();
+        return false;
+    }
+    appliedFrameSize = size;
+    windowActive = false;
+    framesToSkip = config.fb_count - 1;
+    return true;
 }
 
 bool CameraManager::setJPEGQuality(int quality) {
     if (!sensor) return false;
-    return sensor->set_quality(sensor, quality) == 0;
+    sensorWriteCount++;
+    if (sensor->set_quality(sensor, quality) != 0) {
+        appliedQuality = -1;
+        return false;
+    }
+    appliedQuality = quality;
+    return true;
 }
 
 bool CameraManager::setBrightness(int level) {
@@ -264,6 +716,7 @@ bool CameraManager::shouldAutoCapture() {
 
 void CameraManager::setupDefaultSettings() {
     if (!sensor) return;
+    xSemaphoreTake(sensorLock, portMAX_DELAY);
     
     // Apply optimal settings for Intel glasses use case
     
@@ -283,7 +736,8 @@ void CameraManager::setupDefaultSettings() {
     setVerticalFlip(true);
 #endif
     
-    // Optimize for AI processing
+    // Optimize for AI processing; mode-specific profiles are applied on top of this
+    invalidateSensorState();
     setFrameSize(FRAMESIZE_VGA);  // 640x480 good balance of quality and processing speed
     setJPEGQuality(12);           // Medium quality for faster transmission
     
@@ -296,6 +750,7 @@ void CameraManager::setupDefaultSettings() {
     setContrast(0);     // Normal contrast
     setBrightness(0);   // Normal brightness
     setSaturation(0);   // Normal saturation
+    xSemaphoreGive(sensorLock);
     
     Serial.println("Default camera settings applied");
 }
@@ -310,3 +765,74 @@ void CameraManager::logCameraStatus() {
     Serial.printf("Total captures: %d\n", captureCount);
     Serial.println("====================");
 }
+
+bool CameraManager::computeSensorWindow(const CaptureProfile& profile, SensorWindow& window) {
+    uint16_t arrayWidth, arrayHeight;
+    getSensorArraySize(&arrayWidth, &arrayHeight);
+    if (arrayWidth == 0 || arrayHeight == 0) return false;
+    
+    // Keep the window on an 8-pixel grid and the output on the 16-pixel JPEG MCU grid
+    window.startX = ((uint16_t)(profile.windowX * arrayWidth)) & ~7;
+    window.startY = ((uint16_t)(profile.windowY * arrayHeight)) & ~7;
+    window.width = ((uint16_t)(profile.windowWidth * arrayWidth)) & ~7;
+    window.height = ((uint16_t)(profile.windowHeight * arrayHeight)) & ~7;
+    window.width = min((int)window.width, arrayWidth - window.startX);
+    window.height = min((int)window.height, arrayHeight - window.startY);
+    window.outputWidth = min((int)profile.outputWidth, (int)window.width) & ~15;
+    window.outputHeight = min((int)profile.outputHeight, (int)window.height) & ~15;
+    
+    return window.width > 0 && window.height > 0 && window.outputWidth > 0 && window.outputHeight > 0;
+}
+
+bool CameraManager::applySensorWindow(const SensorWindow& window) {
+    if (!sensor || !sensor->set_res_raw) return false;
+    
+    int res;
+    sensorWriteCount++;
+    if (sensor->id.PID == OV2640_PID) {
+        // OV2640: window inside the UXGA readout mode, scaled by the DSP to the output size
+        res = sensor->set_res_raw(sensor, 0, 0, 0, 0, window.startX, window.startY,
+                                  window.width, window.height, window.outputWidth, window.outputHeight,
+                                  false, false);
+    } else {
+        // OV3660/OV5640: array window with timing totals and ISP scaling/binning
+        int endX = window.startX + window.width - 1;
+        int endY = window.startY + window.height - 1;
+        bool scale = window.outputWidth < window.width || window.outputHeight < window.height;
+        bool binning = window.width >= window.outputWidth * 2 && window.height >= window.outputHeight * 2;
+        res = sensor->set_res_raw(sensor, window.startX, window.startY, endX, endY,
+                                  SENSOR_WINDOW_ISP_OFFSET_X, SENSOR_WINDOW_ISP_OFFSET_Y,
+                                  window.width + SENSOR_WINDOW_HBLANK, window.height + SENSOR_WINDOW_VBLANK,
+                                  window.outputWidth, window.outputHeight, scale, binning);
+    }
+    
+    if (res != 0) {
+        return false;
+    }
+    
+    appliedWindow = window;
+    windowActive = true;
+    framesToSkip = config.fb_count - 1;
+    return true;
+}
+
+void CameraManager::getSensorArraySize(uint16_t* width, uint16_t* height) {
+    *width = 0;
+    *height = 0;
+    if (!sensor) return;
+    
+    switch (sensor->id.PID) {
+        case OV2640_PID: *width = 1600; *height = 1200; break;
+        case OV3660_PID: *width = 2048; *height = 1536; break;
+        case OV5640_PID: *width = 2592; *height = 1944; break;
+        default: break;
+    }
+}
+
+void CameraManager::invalidateSensorState() {
+    // Force the next reconfigure to write every setting
+    appliedFrameSize = FRAMESIZE_INVALID;
+    appliedQuality = -1;
+    windowActive = false;
+    memset(&appliedWindow, 0, sizeof(appliedWindow));
+}
@@ -3,7 +3,90 @@
 
 #include <Arduino.h>
 #include "esp_camera.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "intel_glasses_config.h"
+#include "jpeg_transcoder.h"
+
+// Per-mode capture profile
+struct CaptureProfile {
+    framesize_t frameSize;          // Output frame size when not windowed
+    int jpegQuality;                // Lower = higher quality, larger size
+    bool useWindow;                 // Read out only a region of the sensor array
+    float windowX;                  // Window origin, as a fraction of the sensor array
+    float windowY;
+    float windowWidth;              // Window size, as a fraction of the sensor array
+    float windowHeight;
+    uint16_t outputWidth;           // Output size when windowed
+    uint16_t outputHeight;
+    size_t byteBudget;              // Upload size limit in bytes, 0 = unlimited
+};
+
+// Sensor window in sensor array pixels
+struct SensorWindow {
+    uint16_t startX;
+    uint16_t startY;
+    uint16_t width;
+    uint16_t height;
+    uint16_t outputWidth;
+    uint16_t outputHeight;
+};
+
+// Capture statistics per operation mode
+struct CaptureProfileStats {
+    uint32_t frames;
+    uint64_t totalBytes;
+    uint32_t switches;              // Times this profile was applied
+    uint32_t sensorWrites;          // Register writes needed to apply it
+    unsigned long lastSwitchMicros;
+    uint64_t totalSwitchMicros;
+};
+
+// Byte-budget encoding statistics
+struct CaptureBudgetStats {
+    uint32_t budgetedFrames;        // Captures taken with a budget
+    uint32_t reencodedFrames;       // Captures that exceeded the budget and were re-encoded
+    uint32_t overBudgetFrames;      // Re-encodes that still did not fit
+    uint32_t totalEncodes;
+    uint64_t bytesBefore;
+    uint64_t bytesAfter;
+    uint64_t totalMicros;
+};
+
+// Resolution pyramid levels derived from one high-resolution capture
+enum PyramidLevel {
+    PYRAMID_FULL,                   // Frame as captured, for OCR
+    PYRAMID_CAPTION,                // About VGA, for captioning and signs
+    PYRAMID_HAZARD,                 // About QVGA, for hazard detection
+    PYRAMID_THUMBNAIL,              // About 160 px wide, for scene-change detection
+    PYRAMID_LEVEL_COUNT
+};
+
+// A JPEG pyramid level; data stays valid while the pyramid is held
+struct PyramidImage {
+    const uint8_t* data;
+    size_t size;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Read-only pyramid shared by all consumers of a capture; levels are derived on first request
+struct FramePyramid {
+    int captureNumber;              // getCaptureCount() when the frame was taken
+    unsigned long captureTime;
+    int refCount;                   // Holders, including the camera manager while it is current
+    PyramidImage levels[PYRAMID_LEVEL_COUNT];
+};
+
+struct PyramidStats {
+    uint32_t captures;
+    uint32_t levelRequests;
+    uint32_t levelsDerived;         // Requests that had to transcode a level
+    uint32_t refused;               // Captures refused because PYRAMID_MAX_LIVE pyramids were held
+    uint64_t deriveMicros;
+    size_t liveBytes;
+    size_t peakBytes;
+};
 
 class CameraManager {
 private:
@@ -13,18 +96,59 @@ private:
     unsigned long lastCaptureTime;
     int captureCount;
     
+    // Sensor state as last written, used to skip redundant register writes
+    framesize_t appliedFrameSize;
+    int appliedQuality;
+    bool windowActive;
+    SensorWindow appliedWindow;
+    int framesToSkip;               // Buffered frames still carrying the previous geometry
+    SemaphoreHandle_t sensorLock;   // Frame grabs and sensor writes; captures, previews and profile switches
+    uint32_t sensorWriteCount;
+    
+    // Active capture profile and per-mode statistics
+    OperationMode activeProfileMode;
+    CaptureProfileStats profileStats[MODE_AUTO_ALL + 1];
+    CaptureBudgetStats budgetStats;
+    
+    // Current resolution pyramid; older ones stay live until their last holder releases them
+    FramePyramid* currentPyramid;
+    int livePyramids;
+    SemaphoreHandle_t pyramidLock;
+    PyramidStats pyramidStats;
+    
 public:
     CameraManager();
     
     // Initialization and configuration
     bool initialize();
     bool reconfigure(framesize_t frameSize, int jpegQuality);
+    bool reconfigure(const CaptureProfile& profile);
+    
+    // Per-mode capture profiles
+    static const CaptureProfile& getCaptureProfile(OperationMode mode);
+    static size_t getMaxJpegSize();   // Largest JPEG any capture profile can produce
+    bool applyCaptureProfile(OperationMode mode);
+    OperationMode getActiveProfileMode();
+    CaptureProfileStats getProfileStats(OperationMode mode);
+    void logProfileStats();
     void deinitialize();
     
     // Image capture
     camera_fb_t* captureImage();
+    camera_fb_t* grabPreviewFrame();  // Latest frame for on-device analysis; nullptr while the camera is busy
     void releaseFrameBuffer(camera_fb_t* fb);
+    bool captureGrayscale(JpegPlane* luma); // Luma plane of a fresh capture; caller frees luma->data
     bool captureToBuffer(uint8_t** imageData, size_t* imageSize);
+    bool captureToBuffer(uint8_t** imageData, size_t* imageSize, size_t byteBudget);
+    CaptureBudgetStats getBudgetStats();
+    
+    // Resolution pyramid from a single capture
+    FramePyramid* acquirePyramid();   // Current pyramid or nullptr; pair with releasePyramid()
+    FramePyramid* acquireCapturedPyramid(); // Pyramid of the latest capture, nullptr if it has none
+    FramePyramid* retainPyramid(FramePyramid* pyramid); // Another reference to a held pyramid
+    bool getPyramidLevel(FramePyramid* pyramid, PyramidLevel level, PyramidImage* image);
+    void releasePyramid(FramePyramid* pyramid);
+    PyramidStats getPyramidStats();
     
     // Camera settings
     bool setFrameSize(framesize_t size);
@@ -59,6 +183,13 @@ public:
     
 private:
     void logCameraStatus();
+    bool computeSensorWindow(const CaptureProfile& profile, SensorWindow& window);
+    bool applySensorWindow(const SensorWindow& window);
+    void getSensorArraySize(uint16_t* width, uint16_t* height);
+    void invalidateSensorState();
+    bool encodeToBudget(camera_fb_t* fb, size_t byteBudget, uint8_t** imageData, size_t* imageSize);
+    bool storePyramid(camera_fb_t* fb);
+    void dropPyramidRef(FramePyramid* pyramid);
     bool autoCaptureEnabled;
 };
 
@@ -0,0 +1,380 @@
+#include "capture_pipeline.h"
+#include "camera_manager.h"
+#include "gsm_module.h"
+#include "ai_processor.h"
+#include "esp_timer.h"
+
+CapturePipeline capturePipeline;
+
+// Task configuration
+static const uint32_t CAPTURE_TASK_STACK = 4096;
+static const uint32_t ENCODE_TASK_STACK = 8192;
+static const uint32_t UPLOAD_TASK_STACK = 16384;
+static const TickType_t STAGE_POLL_TICKS = pdMS_TO_TICKS(100);
+
+CapturePipeline::CapturePipeline() {
+    isRunning = false;
+    nextSequence = 0;
+    triggerQueue = nullptr;
+    encodeQueue = nullptr;
+    uploadQueue = nullptr;
+    captureTaskHandle = nullptr;
+    encodeTaskHandle = nullptr;
+    uploadTaskHandle = nullptr;
+    statsLock = portMUX_INITIALIZER_UNLOCKED;
+    memset(&stats, 0, sizeof(stats));
+}
+
+CapturePipeline::~CapturePipeline() {
+    end();
+}
+
+bool CapturePipeline::begin() {
+    if (isRunning) return true;
+    if (captureTaskHandle || encodeTaskHandle || uploadTaskHandle) {
+        Serial.println("Pipeline stages from the last run are still stopping");
+        return false;
+    }
+
+    Serial.println("Starting capture pipeline...");
+
+    triggerQueue = xQueueCreate(1, sizeof(RequestPriority));
+    encodeQueue = xQueueCreate(PIPELINE_QUEUE_DEPTH, sizeof(PipelineFrame*));
+    uploadQueue = xQueueCreate(PIPELINE_QUEUE_DEPTH, sizeof(PipelineFrame*));
+
+    if (!triggerQueue || !encodeQueue || !uploadQueue) {
+        Serial.println("Failed to create pipeline queues");
+        end();
+        return false;
+    }
+
+    resetStats();
+    isRunning = true;
+
+    // Capture and encode share core 0, upload and response handling stay on the Arduino core
+    BaseType_t captureOk = xTaskCreatePinnedToCore(captureTask, "pipe_capture", CAPTURE_TASK_STACK,
+                                                   this, 2, &captureTaskHandle, PIPELINE_CAPTURE_CORE);
+    BaseType_t encodeOk = xTaskCreatePinnedToCore(encodeTask, "pipe_encode", ENCODE_TASK_STACK,
+                                                  this, 1, &encodeTaskHandle, PIPELINE_ENCODE_CORE);
+    BaseType_t uploadOk = xTaskCreatePinnedToCore(uploadTask, "pipe_upload", UPLOAD_TASK_STACK,
+                                                  this, 1, &uploadTaskHandle, PIPELINE_UPLOAD_CORE);
+
+    if (captureOk != pdPASS || encodeOk != pdPASS || uploadOk != pdPASS) {
+        Serial.println("Failed to create pipeline tasks");
+        end();
+        return false;
+    }
+
+    Serial.printf("Capture pipeline running (capture: core %d, encode: core %d, upload: core %d)\n",
+                  PIPELINE_CAPTURE_CORE, PIPELINE_ENCODE_CORE, PIPELINE_UPLOAD_CORE);
+    return true;
+}
+
+void CapturePipeline::end() {
+    if (!triggerQueue && !encodeQueue && !uploadQueue) return;
+
+    isRunning = false;
+
+    // Stages exit on their own once they see the flag; an upload in flight may take a while
+    unsigned long waitStart = millis();
+    while ((captureTaskHandle || encodeTaskHandle || uploadTaskHandle) &&
+           millis() - waitStart < CLOUD_API_TIMEOUT + 1000) {
+        delay(10);
+    }
+
+    // A stage still running would use the queues after they are deleted; keep them
+    // for end() to retry, and begin() refuses to start until the stages are gone
+    if (captureTaskHandle || encodeTaskHandle || uploadTaskHandle) {
+        Serial.println("Pipeline stages did not stop, keeping their queues");
+        return;
+    }
+
+    drainQueue(encodeQueue);
+    drainQueue(uploadQueue);
+
+    if (triggerQueue) vQueueDelete(triggerQueue);
+    if (encodeQueue) vQueueDelete(encodeQueue);
+    if (uploadQueue) vQueueDelete(uploadQueue);
+    triggerQueue = nullptr;
+    encodeQueue = nullptr;
+    uploadQueue = nullptr;
+
+    Serial.println("Capture pipeline stopped");
+}
+
+bool CapturePipeline::isActive() {
+    return isRunning;
+}
+
+bool CapturePipeline::requestCapture(RequestPriority priority) {
+    if (!isRunning) return false;
+
+    // An auto-capture never downgrades a manual request still waiting
+    RequestPriority pending;
+    if (xQueuePeek(triggerQueue, &pending, 0) == pdTRUE && pending < priority) {
+        priority = pending;
+    }
+    return xQueueOverwrite(triggerQueue, &priority) == pdTRUE;
+}
+
+bool CapturePipeline::isIdle() {
+    if (!isRunning) return true;
+
+    return uxQueueMessagesWaiting(triggerQueue) == 0 &&
+           uxQueueMessagesWaiting(encodeQueue) == 0 &&
+           uxQueueMessagesWaiting(uploadQueue) == 0 &&
+           !aiProcessor.getProcessingStatus();
+}
+
+PipelineStats CapturePipeline::getStats() {
+    portENTER_CRITICAL(&statsLock);
+    PipelineStats snapshot = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return snapshot;
+}
+
+float CapturePipeline::getThroughput() {
+    PipelineStats snapshot = getStats();
+    unsigned long elapsed = millis() - snapshot.startTime;
+    if (elapsed == 0) return 0.0;
+    return snapshot.framesCompleted * 1000.0 / elapsed;
+}
+
+float CapturePipeline::getStageOccupancy(PipelineStage stage) {
+    PipelineStats snapshot = getStats();
+    unsigned long elapsed = millis() - snapshot.startTime;
+    if (elapsed == 0 || stage >= STAGE_COUNT) return 0.0;
+    return snapshot.stages[stage].busyMicros / (elapsed * 1000.0);
+}
+
+void CapturePipeline::logStats() {
+    PipelineStats snapshot = getStats();
+
+    Serial.println("=== Capture Pipeline ===");
+    Serial.printf("Frames completed: %u (%u successful)\n", snapshot.framesCompleted, snapshot.framesSucceeded);
+    Serial.printf("Frames queued: %u, rejected: %u\n", snapshot.framesQueued, snapshot.framesRejected);
+    Serial.printf("Throughput: %.3f frames/s\n", getThroughput());
+    if (snapshot.framesCompleted > 0) {
+        Serial.printf("Avg capture-to-result latency: %lu ms\n", snapshot.totalLatency / snapshot.framesCompleted);
+    }
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        PipelineStage stage = (PipelineStage)i;
+        const PipelineStageStats& s = snapshot.stages[i];
+        unsigned long avgMs = s.processed > 0 ? (unsigned long)(s.busyMicros / s.processed / 1000) : 0;
+        Serial.printf("%-8s processed: %u, dropped: %u, avg: %lu ms, occupancy: %.1f%%\n",
+                      getStageName(stage).c_str(), s.processed, s.dropped, avgMs,
+                      getStageOccupancy(stage) * 100);
+    }
+    Serial.println("========================");
+}
+
+void CapturePipeline::resetStats() {
+    portENTER_CRITICAL(&statsLock);
+    memset(&stats, 0, sizeof(stats));
+    stats.startTime = millis();
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void CapturePipeline::captureTask(void* param) {
+    CapturePipeline* pipeline = (CapturePipeline*)param;
+    pipeline->runCaptureStage();
+    pipeline->captureTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void CapturePipeline::encodeTask(void* param) {
+    CapturePipeline* pipeline = (CapturePipeline*)param;
+    pipeline->runEncodeStage();
+    pipeline->encodeTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void CapturePipeline::uploadTask(void* param) {
+    CapturePipeline* pipeline = (CapturePipeline*)param;
+    pipeline->runUploadStage();
+    pipeline->uploadTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void CapturePipeline::runCaptureStage() {
+    while (isRunning) {
+        RequestPriority priority;
+        if (xQueueReceive(triggerQueue, &priority, STAGE_POLL_TICKS) != pdTRUE) {
+            continue;
+        }
+
+        int64_t stageStart = esp_timer_get_time();
+
+        PipelineFrame* frame = new PipelineFrame();
+        frame->sequence = nextSequence++;
+        frame->imageData = nullptr;
+        frame->imageSize = 0;
+        frame->encodedImage = nullptr;
+        frame->pyramid = nullptr;
+        frame->mode = aiProcessor.getOperationMode();
+        frame->priority = priority;
+        frame->captureTime = millis();
+
+        if (!cameraManager.captureToBuffer(&frame->imageData, &frame->imageSize)) {
+            Serial.println("Pipeline capture failed");
+            releaseFrame(frame);
+            continue;
+        }
+        frame->pyramid = cameraManager.acquireCapturedPyramid();
+
+        recordStage(STAGE_CAPTURE, esp_timer_get_time() - stageStart);
+        pushFrame(encodeQueue, frame, STAGE_ENCODE);
+    }
+}
+
+void CapturePipeline::runEncodeStage() {
+    while (isRunning) {
+        PipelineFrame* frame = nullptr;
+        if (xQueueReceive(encodeQueue, &frame, STAGE_POLL_TICKS) != pdTRUE) {
+            continue;
+        }
+
+        int64_t stageStart = esp_timer_get_time();
+
+        // Only frames uploaded as they are; auto mode sends pyramid levels and
+        // crops, OCR a bilevel TIFF
+        if (aiProcessor.uploadsFrame(frame->mode, frame->pyramid != nullptr)) {
+            gsmModule.optimizeImageForUpload(&frame->imageData, &frame->imageSize);
+            frame->encodedImage = new String(gsmModule.encodeImageToBase64(frame->imageData, frame->imageSize));
+            if (frame->encodedImage->length() == 0) {
+                Serial.printf("Pipeline encode failed for frame %u\n", frame->sequence);
+                releaseFrame(frame);
+                continue;
+            }
+        }
+
+        recordStage(STAGE_ENCODE, esp_timer_get_time() - stageStart);
+        pushFrame(uploadQueue, frame, STAGE_UPLOAD);
+    }
+}
+
+void CapturePipeline::runUploadStage() {
+    while (isRunning) {
+        PipelineFrame* frame = nullptr;
+        if (xQueueReceive(uploadQueue, &frame, STAGE_POLL_TICKS) != pdTRUE) {
+            continue;
+        }
+
+        // Wait for a token of the frame's class, swapping in any newer frame meanwhile
+        while (isRunning && !aiProcessor.canAcceptImage(frame->priority)) {
+            PipelineFrame* newer = nullptr;
+            if (xQueueReceive(uploadQueue, &newer, pdMS_TO_TICKS(20)) == pdTRUE) {
+                frame = replaceFrame(frame, newer, STAGE_UPLOAD);
+            }
+        }
+        if (!isRunning) {
+            releaseFrame(frame);
+            break;
+        }
+
+        int64_t stageStart = esp_timer_get_time();
+
+        bool success = aiProcessor.processImage(frame->imageData, frame->imageSize, frame->pyramid,
+                                                frame->priority, frame->encodedImage);
+        AdmissionDecision admission = success ? ADMISSION_ADMITTED : aiProcessor.getLastAdmission();
+
+        recordStage(STAGE_UPLOAD, esp_timer_get_time() - stageStart);
+
+        // Queued and rejected frames are neither a success nor a failure
+        unsigned long latency = millis() - frame->captureTime;
+        portENTER_CRITICAL(&statsLock);
+        if (admission == ADMISSION_QUEUED) {
+            stats.framesQueued++;
+        } else if (admission == ADMISSION_REJECTED) {
+            stats.framesRejected++;
+        } else {
+            stats.framesCompleted++;
+            if (success) stats.framesSucceeded++;
+            stats.totalLatency += latency;
+        }
+        portEXIT_CRITICAL(&statsLock);
+
+        if (admission == ADMISSION_ADMITTED) {
+            Serial.printf("Pipeline frame %u complete. Success: %s, Latency: %lu ms\n",
+                          frame->sequence, success ? "YES" : "NO", latency);
+        } else {
+            Serial.printf("Pipeline frame %u %s by admission control\n", frame->sequence,
+                          admission == ADMISSION_QUEUED ? "queued" : "rejected");
+        }
+
+        releaseFrame(frame);
+    }
+}
+
+bool CapturePipeline::pushFrame(QueueHandle_t queue, PipelineFrame* frame, PipelineStage stage) {
+    if (xQueueSend(queue, &frame, 0) == pdTRUE) {
+        return true;
+    }
+
+    // Queue is full: the frame already waiting is stale now that a newer one exists
+    PipelineFrame* stale = nullptr;
+    if (xQueueReceive(queue, &stale, 0) == pdTRUE) {
+        frame = replaceFrame(stale, frame, stage);
+    }
+
+    if (xQueueSend(queue, &frame, 0) != pdTRUE) {
+        releaseFrame(frame);
+        portENTER_CRITICAL(&statsLock);
+        stats.stages[stage].dropped++;
+        portEXIT_CRITICAL(&statsLock);
+        return false;
+    }
+    return true;
+}
+
+PipelineFrame* CapturePipeline::replaceFrame(PipelineFrame* stale, PipelineFrame* newer, PipelineStage stage) {
+    // The newer frame answers the stale frame's request too, so it keeps the more urgent class
+    if (stale->priority < newer->priority) {
+        newer->priority = stale->priority;
+    }
+    releaseFrame(stale);
+    portENTER_CRITICAL(&statsLock);
+    stats.stages[stage].dropped++;
+    portEXIT_CRITICAL(&statsLock);
+    return newer;
+}
+
+void CapturePipeline::recordStage(PipelineStage stage, uint64_t busyMicros) {
+    portENTER_CRITICAL(&statsLock);
+    stats.stages[stage].processed++;
+    stats.stages[stage].busyMicros += busyMicros;
+    portEXIT_CRITICAL(&statsLock);
+}
+
+void CapturePipeline::releaseFrame(PipelineFrame* frame) {
+    if (!frame) return;
+
+    if (frame->imageData) {
+        free(frame->imageData);
+    }
+    if (frame->encodedImage) {
+        delete frame->encodedImage;
+    }
+    if (frame->pyramid) {
+        cameraManager.releasePyramid(frame->pyramid);
+    }
+    delete frame;
+}
+
+void CapturePipeline::drainQueue(QueueHandle_t queue) {
+    if (!queue) return;
+
+    PipelineFrame* frame = nullptr;
+    while (xQueueReceive(queue, &frame, 0) == pdTRUE) {
+        releaseFrame(frame);
+    }
+}
+
+String CapturePipeline::getStageName(PipelineStage stage) {
+    switch (stage) {
+        case STAGE_CAPTURE: return "Capture";
+        case STAGE_ENCODE: return "Encode";
+        case STAGE_UPLOAD: return "Upload";
+        default: return "Unknown";
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef CAPTURE_PIPELINE_H
+#define CAPTURE_PIPELINE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "intel_glasses_config.h"
+#include "camera_manager.h"
+#include "admission_controller.h"
+
+// Pipeline stages, in the order a frame passes through them
+enum PipelineStage {
+    STAGE_CAPTURE,        // Sensor capture and copy out of the frame buffer
+    STAGE_ENCODE,         // Base64 encoding of the JPEG payload
+    STAGE_UPLOAD,         // Cloud upload and response handling
+    STAGE_COUNT
+};
+
+// A single frame travelling through the pipeline
+struct PipelineFrame {
+    uint32_t sequence;
+    uint8_t* imageData;       // JPEG copy owned by the frame
+    size_t imageSize;
+    String* encodedImage;     // Base64 payload produced by the encode stage
+    FramePyramid* pyramid;    // Resolution pyramid of this frame (auto mode), held until release
+    OperationMode mode;       // Mode the frame was captured in
+    RequestPriority priority; // Admission class, the most urgent of the requests it answers
+    unsigned long captureTime;
+};
+
+// Per-stage counters
+struct PipelineStageStats {
+    uint32_t processed;       // Frames that completed this stage
+    uint32_t dropped;         // Stale frames discarded while waiting for this stage
+    uint64_t busyMicros;      // Time spent doing work in this stage
+};
+
+struct PipelineStats {
+    PipelineStageStats stages[STAGE_COUNT];
+    uint32_t framesCompleted;   // Frames with a result from the cloud, successful or not
+    uint32_t framesSucceeded;
+    uint32_t framesQueued;      // Handed to admission control; their result comes from processQueued()
+    uint32_t framesRejected;    // Turned away by admission control
+    unsigned long startTime;
+    unsigned long totalLatency; // Capture-to-result time summed over completed frames
+};
+
+class CapturePipeline {
+private:
+    volatile bool isRunning;
+    uint32_t nextSequence;
+
+    // Bounded queues between stages
+    QueueHandle_t triggerQueue;   // Priority of the pending capture request (coalesced)
+    QueueHandle_t encodeQueue;    // Captured frames waiting for encode
+    QueueHandle_t uploadQueue;    // Encoded frames waiting for upload
+
+    TaskHandle_t captureTaskHandle;
+    TaskHandle_t encodeTaskHandle;
+    TaskHandle_t uploadTaskHandle;
+
+    PipelineStats stats;
+    portMUX_TYPE statsLock;
+
+public:
+    CapturePipeline();
+    ~CapturePipeline();
+
+    // Lifecycle
+    bool begin();
+    void end();
+    bool isActive();
+
+    // Request a new frame; repeated requests before the capture stage runs are
+    // coalesced into one of the most urgent class among them
+    bool requestCapture(RequestPriority priority = PRIORITY_AUTO);
+    bool isIdle();
+
+    // Metrics
+    PipelineStats getStats();
+    float getThroughput();                    // Completed frames per second
+    float getStageOccupancy(PipelineStage stage); // Fraction of wall time the stage was busy
+    void logStats();
+    void resetStats();
+
+private:
+    static void captureTask(void* param);
+    static void encodeTask(void* param);
+    static void uploadTask(void* param);
+
+    void runCaptureStage();
+    void runEncodeStage();
+    void runUploadStage();
+
+    bool pushFrame(QueueHandle_t queue, PipelineFrame* frame, PipelineStage stage);
+    PipelineFrame* replaceFrame(PipelineFrame* stale, PipelineFrame* newer, PipelineStage stage);
+    void recordStage(PipelineStage stage, uint64_t busyMicros);
+    void releaseFrame(PipelineFrame* frame);
+    void drainQueue(QueueHandle_t queue);
+    String getStageName(PipelineStage stage);
+};
+
+// Global capture pipeline instance
+extern CapturePipeline capturePipeline;
+
+#endif // CAPTURE_PIPELINE_H
@@ -0,0 +1,337 @@
+#include "clip_cache.h"
+#include <cstring>
+
+ClipCache clipCache;
+
+namespace {
+
+const uint32_t INDEX_MAGIC = 0x43504C43;    // "CLPC"
+const uint16_t INDEX_VERSION = 1;
+const int MAX_ORPHANS = 8;                  // Stray files removed per boot
+
+struct IndexHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    uint32_t useCounter;
+};
+
+uint64_t fnv1a(uint64_t hash, const char* text, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+// Key back from a clip file name, 0 when it is not one
+uint64_t keyFromName(const char* name) {
+    if (strlen(name) != 20 || strcmp(name + 16, ".mp3") != 0) return 0;
+    uint64_t key = 0;
+    for (int i = 0; i < 16; i++) {
+        char c = name[i];
+        int digit = c >= '0' && c <= '9' ? c - '0' : (c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1);
+        if (digit < 0) return 0;
+        key = key << 4 | digit;
+    }
+    return key;
+}
+
+String cachePath(const char* name) {
+    return String(CLIP_CACHE_DIR) + name;
+}
+
+} // namespace
+
+ClipCache::ClipCache() {
+    fs = nullptr;
+    entryCount = 0;
+    totalBytes = 0;
+    useCounter = 0;
+    hitsSinceSave = 0;
+    memset(recentMisses, 0, sizeof(recentMisses));
+    missIndex = 0;
+    captureKey = 0;
+    captureBuffer = nullptr;
+    captureSize = 0;
+    memset(&stats, 0, sizeof(stats));
+    statsLock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+ClipCache::~ClipCache() {
+    free(captureBuffer);
+}
+
+bool ClipCache::begin(fs::FS& filesystem) {
+    if (fs) return true;
+    fs = &filesystem;
+    String dir = CLIP_CACHE_DIR;
+    dir.remove(dir.length() - 1);
+    if (!fs->exists(dir)) fs->mkdir(dir);
+
+    entryCount = 0;
+    totalBytes = 0;
+    loadIndex();
+
+    // Clips whose file has gone
+    bool changed = false;
+    for (int i = entryCount - 1; i >= 0; i--) {
+        if (!fs->exists(pathFor(entries[i].key))) {
+            removeEntry(i);
+            changed = true;
+        }
+    }
+
+    // Files the index never heard of, e.g. written just before a power cut
+    String orphans[MAX_ORPHANS];
+    int orphanCount = 0;
+    File root = fs->open(dir);
+    if (root && root.isDirectory()) {
+        File file = root.openNextFile();
+        while (file && orphanCount < MAX_ORPHANS) {
+            const char* name = file.name();
+            const char* slash = strrchr(name, '/');
+            if (slash) name = slash + 1;
+            uint64_t key = keyFromName(name);
+            if (strcmp(name, "index.bin") != 0 && (key == 0 || find(key) < 0)) {
+                orphans[orphanCount++] = cachePath(name);
+            }
+            file.close();
+            file = root.openNextFile();
+        }
+        root.close();
+    }
+    for (int i = 0; i < orphanCount; i++) {
+        fs->remove(orphans[i]);
+    }
+
+    // The budget may have shrunk since the last boot
+    if (totalBytes > CLIP_CACHE_BUDGET) {
+        makeRoom(0);
+        changed = true;
+    }
+    if (changed) saveIndex();
+
+    Serial.printf("Clip cache: %d clips, %llu bytes (budget %u), %d stray files removed\n",
+                  entryCount, (unsigned long long)totalBytes, (unsigned)CLIP_CACHE_BUDGET, orphanCount);
+    return true;
+}
+
+void ClipCache::end() {
+    if (!fs) return;
+    if (hitsSinceSave > 0) saveIndex();
+    fs = nullptr;
+    captureKey = 0;
+    free(captureBuffer);
+    captureBuffer = nullptr;
+}
+
+bool ClipCache::isReady() {
+    return fs != nullptr;
+}
+
+uint64_t ClipCache::keyFor(const String& text, const char* voice, const String& format) {
+    // Clips are played back as MP3
+    if (!format.equalsIgnoreCase("mp3") || text.length() == 0) return 0;
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = fnv1a(hash, text.c_str(), text.length() + 1);   // The terminator separates the fields
+    hash = fnv1a(hash, voice, strlen(voice) + 1);
+    hash = fnv1a(hash, "mp3", 3);
+    return hash != 0 ? hash : 1;
+}
+
+bool ClipCache::open(uint64_t key, File* file) {
+    if (!fs || key == 0) return false;
+    unsigned long startTime = micros();
+    int index = find(key);
+    uint32_t size = 0;
+    if (index >= 0) {
+        *file = fs->open(pathFor(key), FILE_READ);
+        if (*file) {
+            size = entries[index].size;
+            entries[index].lastUsed = ++useCounter;
+            hitsSinceSave++;
+        } else {
+            removeEntry(index);
+            index = -1;
+        }
+    }
+    unsigned long elapsed = micros() - startTime;
+
+    portENTER_CRITICAL(&statsLock);
+    stats.lookups++;
+    stats.totalLookupMicros += elapsed;
+    if (elapsed > stats.maxLookupMicros) stats.maxLookupMicros = elapsed;
+    if (index >= 0) {
+        stats.hits++;
+        stats.bytesSaved += size;
+    }
+    portEXIT_CRITICAL(&statsLock);
+
+    // Recency only; losing some of it to a power cut costs nothing but order
+    if (hitsSinceSave >= CLIP_CACHE_INDEX_FLUSH) saveIndex();
+    return index >= 0;
+}
+
+bool ClipCache::beginCapture(uint64_t key, long expectedSize) {
+    captureKey = 0;
+    if (!fs || key == 0 || expectedSize > CLIP_CACHE_MAX_CLIP) return false;
+
+    // Only clips that keep coming back are worth the flash writes
+    int misses = 1;
+    for (int i = 0; i < CLIP_CACHE_MISS_HISTORY; i++) {
+        if (recentMisses[i] == key) misses++;
+    }
+    recentMisses[missIndex] = key;
+    missIndex = (missIndex + 1) % CLIP_CACHE_MISS_HISTORY;
+    if (misses < CLIP_CACHE_ADMIT_MISSES) {
+        portENTER_CRITICAL(&statsLock);
+        stats.notAdmitted++;
+        portEXIT_CRITICAL(&statsLock);
+        return false;
+    }
+
+    if (!captureBuffer) {
+        captureBuffer = (uint8_t*)(psramFound() ? ps_malloc(CLIP_CACHE_MAX_CLIP) : malloc(CLIP_CACHE_MAX_CLIP));
+        if (!captureBuffer) return false;
+    }
+    captureKey = key;
+    captureSize = 0;
+    return true;
+}
+
+void ClipCache::capture(const uint8_t* data, size_t size) {
+    if (captureKey == 0) return;
+    if (captureSize + size > CLIP_CACHE_MAX_CLIP) {
+        captureKey = 0;     // Too long to keep
+        return;
+    }
+    memcpy(captureBuffer + captureSize, data, size);
+    captureSize += size;
+}
+
+void ClipCache::endCapture(bool complete) {
+    if (captureKey != 0 && complete && captureSize > 0) {
+        store(captureKey, captureBuffer, captureSize);
+    }
+    captureKey = 0;
+}
+
+int ClipCache::find(uint64_t key) {
+    for (int i = 0; i < entryCount; i++) {
+        if (entries[i].key == key) return i;
+    }
+    return -1;
+}
+
+String ClipCache::pathFor(uint64_t key) {
+    char name[24];
+    snprintf(name, sizeof(name), "%08lx%08lx.mp3", (unsigned long)(key >> 32), (unsigned long)(key & 0xFFFFFFFF));
+    return cachePath(name);
+}
+
+void ClipCache::removeEntry(int index) {
+    fs->remove(pathFor(entries[index].key));
+    totalBytes -= entries[index].size;
+    entries[index] = entries[--entryCount];
+}
+
+bool ClipCache::makeRoom(size_t size) {
+    if (size > CLIP_CACHE_BUDGET) return false;
+    // Least recently used first; removing a file costs no data writes
+    while (entryCount > 0 && (entryCount >= CLIP_CACHE_MAX_ENTRIES || totalBytes + size > CLIP_CACHE_BUDGET)) {
+        int oldest = 0;
+        for (int i = 1; i < entryCount; i++) {
+            if ((int32_t)(entries[i].lastUsed - entries[oldest].lastUsed) < 0) oldest = i;
+        }
+        removeEntry(oldest);
+        portENTER_CRITICAL(&statsLock);
+        stats.evicted++;
+        portEXIT_CRITICAL(&statsLock);
+    }
+    return true;
+}
+
+bool ClipCache::store(uint64_t key, const uint8_t* data, size_t size) {
+    int existing = find(key);
+    if (existing >= 0) removeEntry(existing);
+    if (!makeRoom(size)) return false;
+
+    // Written under a temporary name, so a power cut never leaves half a clip
+    String temp = cachePath("clip.tmp");
+    File file = fs->open(temp, FILE_WRITE);
+    if (!file) return false;
+    size_t written = file.write(data, size);
+    file.close();
+    String path = pathFor(key);
+    if (written != size || !fs->rename(temp, path)) {
+        fs->remove(temp);
+        return false;
+    }
+
+    ClipCacheEntry& entry = entries[entryCount++];
+    entry.key = key;
+    entry.size = size;
+    entry.lastUsed = ++useCounter;
+    totalBytes += size;
+    portENTER_CRITICAL(&statsLock);
+    stats.stored++;
+    stats.bytesWritten += size;
+    portEXIT_CRITICAL(&statsLock);
+    return saveIndex();
+}
+
+bool ClipCache::loadIndex() {
+    File file = fs->open(cachePath("index.bin"), FILE_READ);
+    if (!file) return false;
+    IndexHeader header;
+    bool valid = file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) && header.magic == INDEX_MAGIC &&
+                 header.version == INDEX_VERSION && header.count <= CLIP_CACHE_MAX_ENTRIES &&
+                 file.read((uint8_t*)entries, header.count * sizeof(ClipCacheEntry)) == header.count * sizeof(ClipCacheEntry);
+    file.close();
+    if (!valid) return false;
+
+    entryCount = header.count;
+    useCounter = header.useCounter;
+    for (int i = 0; i < entryCount; i++) {
+        totalBytes += entries[i].size;
+    }
+    return true;
+}
+
+bool ClipCache::saveIndex() {
+    IndexHeader header = { INDEX_MAGIC, INDEX_VERSION, (uint16_t)entryCount, useCounter };
+    String temp = cachePath("index.tmp");
+    File file = fs->open(temp, FILE_WRITE);
+    if (!file) return false;
+    size_t size = sizeof(header) + entryCount * sizeof(ClipCacheEntry);
+    size_t written = file.write((const uint8_t*)&header, sizeof(header));
+    written += file.write((const uint8_t*)entries, entryCount * sizeof(ClipCacheEntry));
+    file.close();
+    if (written != size || !fs->rename(temp, cachePath("index.bin"))) {
+        fs->remove(temp);
+        return false;
+    }
+    hitsSinceSave = 0;
+    portENTER_CRITICAL(&statsLock);
+    stats.bytesWritten += size;
+    portEXIT_CRITICAL(&statsLock);
+    return true;
+}
+
+ClipCacheStats ClipCache::getStats() {
+    portENTER_CRITICAL(&statsLock);
+    ClipCacheStats copy = stats;
+    portEXIT_CRITICAL(&statsLock);
+    return copy;
+}
+
+void ClipCache::logStats() {
+    ClipCacheStats s = getStats();
+    if (s.lookups == 0) return;
+    Serial.printf("Clip cache: %u/%u hits (%.0f%%), %llu bytes not downloaded, lookup avg %llu us (max %lu); "
+                  "%d clips, %llu bytes; %u stored, %u evicted, %u not admitted, %llu bytes written\n",
+                  s.hits, s.lookups, s.hits * 100.0f / s.lookups, (unsigned long long)s.bytesSaved,
+                  (unsigned long long)(s.totalLookupMicros / s.lookups), s.maxLookupMicros, entryCount,
+                  (unsigned long long)totalBytes, s.stored, s.evicted, s.notAdmitted, (unsigned long long)s.bytesWritten);
+}
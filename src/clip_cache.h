@@ -0,0 +1,91 @@
+#ifndef CLIP_CACHE_H
+#define CLIP_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "intel_glasses_config.h"
+
+struct ClipCacheEntry {
+    uint64_t key;
+    uint32_t size;
+    uint32_t lastUsed;        // Use counter at the last hit or store
+};
+
+struct ClipCacheStats {
+    uint32_t lookups;
+    uint32_t hits;
+    uint32_t stored;
+    uint32_t notAdmitted;     // Misses not written, the clip was not heard often enough yet
+    uint32_t evicted;
+    uint64_t bytesSaved;      // Downloads avoided by hits
+    uint64_t bytesWritten;    // Flash writes, clips and index
+    uint64_t totalLookupMicros;
+    unsigned long maxLookupMicros;
+};
+
+// Flash cache of cloud speech clips, so a result heard before ("Area clear",
+// a common sign) plays without the network. Each clip is a file in
+// CLIP_CACHE_DIR named by a hash of its text, voice and format. A clip that
+// misses is kept in PSRAM while it streams and written only once it has
+// missed CLIP_CACHE_ADMIT_MISSES times recently, so one-off captions never
+// reach flash. Beyond CLIP_CACHE_BUDGET the least recently used clips are
+// removed. Recency lives in RAM; the index file is rewritten with every store
+// but only every CLIP_CACHE_INDEX_FLUSH hits. The filesystem is passed in so
+// the cache can run against any fs::FS.
+class ClipCache {
+private:
+    fs::FS* fs;
+    ClipCacheEntry entries[CLIP_CACHE_MAX_ENTRIES];
+    int entryCount;
+    uint64_t totalBytes;
+    uint32_t useCounter;
+    uint32_t hitsSinceSave;
+    uint64_t recentMisses[CLIP_CACHE_MISS_HISTORY];
+    int missIndex;
+
+    // Clip being captured from a stream
+    uint64_t captureKey;
+    uint8_t* captureBuffer;   // CLIP_CACHE_MAX_CLIP, allocated on first use
+    size_t captureSize;
+
+    ClipCacheStats stats;
+    portMUX_TYPE statsLock;
+
+    int find(uint64_t key);
+    String pathFor(uint64_t key);
+    void removeEntry(int index);
+    bool makeRoom(size_t size);
+    bool store(uint64_t key, const uint8_t* data, size_t size);
+    bool loadIndex();
+    bool saveIndex();
+
+public:
+    ClipCache();
+    ~ClipCache();
+
+    // Filesystem already mounted
+    bool begin(fs::FS& filesystem);
+    void end();
+    bool isReady();
+
+    // Key for a clip; 0 (not cacheable) for formats other than MP3
+    static uint64_t keyFor(const String& text, const char* voice, const String& format);
+
+    // Open a cached clip; false on a miss
+    bool open(uint64_t key, File* file);
+
+    // Keep a clip that missed while it streams; it is written at the end if
+    // it came whole and has been asked for often enough
+    bool beginCapture(uint64_t key, long expectedSize);
+    void capture(const uint8_t* data, size_t size);
+    void endCapture(bool complete);
+
+    // Statistics
+    ClipCacheStats getStats();
+    void logStats();
+};
+
+// Global clip cache instance
+extern ClipCache clipCache;
+
+#endif // CLIP_CACHE_H
@@ -0,0 +1,330 @@
+#include "colour_identifier.h"
+#include "jpeg_transcoder.h"
+#include <cstring>
+#include <cmath>
+
+ColourIdentifier colourIdentifier;
+
+namespace {
+
+struct NamedColour {
+    const char* name;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+};
+
+// Reference sRGB per name, picked from camera captures rather than paint chips,
+// so they are somewhat less saturated than the textbook values
+const NamedColour NAMED_COLOURS[] = {
+    { "black",       22,  22,  24 },
+    { "dark grey",   70,  70,  72 },
+    { "grey",       128, 128, 128 },
+    { "light grey", 190, 190, 188 },
+    { "white",      240, 240, 236 },
+    { "red",        200,  35,  35 },
+    { "dark red",   120,  22,  28 },
+    { "pink",       235, 150, 170 },
+    { "orange",     235, 125,  35 },
+    { "brown",      115,  72,  40 },
+    { "beige",      212, 192, 158 },
+    { "yellow",     232, 212,  45 },
+    { "olive",      118, 118,  45 },
+    { "green",       55, 148,  62 },
+    { "dark green",  28,  78,  38 },
+    { "teal",        22, 125, 128 },
+    { "turquoise",   64, 198, 196 },
+    { "light blue", 140, 180, 228 },
+    { "blue",        42,  82, 195 },
+    { "navy",        28,  36,  88 },
+    { "purple",     108,  52, 148 },
+    { "lavender",   178, 160, 218 },
+    { "magenta",    198,  42, 158 }
+};
+const int NAMED_COLOUR_COUNT = sizeof(NAMED_COLOURS) / sizeof(NAMED_COLOURS[0]);
+
+struct Lab {
+    float l;
+    float a;
+    float b;
+};
+
+float linearize(uint8_t value) {
+    float c = value / 255.0f;
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+float labCurve(float t) {
+    return t > 0.008856f ? cbrtf(t) : 7.787f * t + 16.0f / 116.0f;
+}
+
+// sRGB (D65) to CIELAB
+Lab toLab(uint8_t r, uint8_t g, uint8_t b) {
+    float rl = linearize(r), gl = linearize(g), bl = linearize(b);
+    float x = (0.4124f * rl + 0.3576f * gl + 0.1805f * bl) / 0.95047f;
+    float y = 0.2126f * rl + 0.7152f * gl + 0.0722f * bl;
+    float z = (0.0193f * rl + 0.1192f * gl + 0.9505f * bl) / 1.08883f;
+    float fx = labCurve(x), fy = labCurve(y), fz = labCurve(z);
+    return { 116.0f * fy - 16.0f, 500.0f * (fx - fy), 200.0f * (fy - fz) };
+}
+
+// Lightness counts half as much as hue and chroma (the 2:1 weighting used for
+// textiles), so folds and shadows in one garment stay one colour
+float difference(const Lab& p, const Lab& q) {
+    float dl = (p.l - q.l) * 0.5f;
+    float da = p.a - q.a;
+    float db = p.b - q.b;
+    return dl * dl + da * da + db * db;
+}
+
+const Lab* namedLab() {
+    static Lab table[NAMED_COLOUR_COUNT];
+    static bool ready = false;
+    if (!ready) {
+        for (int i = 0; i < NAMED_COLOUR_COUNT; i++) {
+            table[i] = toLab(NAMED_COLOURS[i].r, NAMED_COLOURS[i].g, NAMED_COLOURS[i].b);
+        }
+        ready = true;
+    }
+    return table;
+}
+
+int nearestLab(const Lab& colour) {
+    const Lab* table = namedLab();
+    int best = 0;
+    float bestDifference = 1e30f;
+    for (int i = 0; i < NAMED_COLOUR_COUNT; i++) {
+        float d = difference(colour, table[i]);
+        if (d < bestDifference) {
+            bestDifference = d;
+            best = i;
+        }
+    }
+    return best;
+}
+
+inline uint8_t clampByte(float value) {
+    return value < 0 ? 0 : (value > 255 ? 255 : (uint8_t)(value + 0.5f));
+}
+
+} // namespace
+
+ColourIdentifier::ColourIdentifier() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ColourIdentifier::identify(const uint8_t* jpeg, size_t length, ColourResult* result) {
+    unsigned long startTime = micros();
+
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(jpeg, length, &info) || info.components != 3) {
+        return false;
+    }
+
+    // Coarsest DCT scale that still has a chroma sample per grid point; the
+    // reduced decode averages each block, which also smooths out texture
+    int pitch = max(info.mcuWidth, info.mcuHeight) / 8;
+    int side = (int)(info.height * COLOUR_ROI_FRACTION);
+    JpegScale scale = JPEG_SCALE_EIGHTH;
+    while (scale > JPEG_SCALE_FULL && side / pitch / scale < COLOUR_SAMPLE_GRID) {
+        scale = (JpegScale)(scale / 2);
+    }
+
+    JpegPlane planes[3];
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, planes, 3)) {
+        return false;
+    }
+
+    // Grid over the centre square, converted to sRGB
+    int chromaX = info.mcuWidth / 8;
+    int chromaY = info.mcuHeight / 8;
+    float scaledSide = (float)side / scale;
+    float left = planes[0].width / 2.0f - scaledSide / 2;
+    float top = planes[0].height / 2.0f - scaledSide / 2;
+    float step = scaledSide / COLOUR_SAMPLE_GRID;
+    uint8_t rgb[COLOUR_SAMPLE_GRID * COLOUR_SAMPLE_GRID * 3];
+    int count = 0;
+    for (int j = 0; j < COLOUR_SAMPLE_GRID; j++) {
+        int y = constrain((int)(top + (j + 0.5f) * step), 0, planes[0].height - 1);
+        for (int i = 0; i < COLOUR_SAMPLE_GRID; i++) {
+            int x = constrain((int)(left + (i + 0.5f) * step), 0, planes[0].width - 1);
+            float luma = planes[0].data[y * planes[0].stride + x];
+            int chroma = (y / chromaY) * planes[1].stride + x / chromaX;
+            float cb = planes[1].data[chroma] - 128.0f;
+            float cr = planes[2].data[chroma] - 128.0f;
+            rgb[count * 3] = clampByte(luma + 1.402f * cr);
+            rgb[count * 3 + 1] = clampByte(luma - 0.344136f * cb - 0.714136f * cr);
+            rgb[count * 3 + 2] = clampByte(luma + 1.772f * cb);
+            count++;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        free(planes[i].data);
+    }
+
+    bool success = identifySamples(rgb, count, result);
+
+    unsigned long elapsed = micros() - startTime;
+    result->micros = elapsed;
+    stats.frames++;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+    return success;
+}
+
+bool ColourIdentifier::identifySamples(const uint8_t* rgb, int count, ColourResult* result) {
+    memset(result, 0, sizeof(ColourResult));
+    if (count <= 0) return false;
+
+    Lab* samples = (Lab*)malloc(count * sizeof(Lab));
+    uint8_t* assignment = (uint8_t*)malloc(count);
+    if (!samples || !assignment) {
+        free(samples);
+        free(assignment);
+        return false;
+    }
+    Lab mean = { 0, 0, 0 };
+    for (int i = 0; i < count; i++) {
+        samples[i] = toLab(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+        mean.l += samples[i].l;
+        mean.a += samples[i].a;
+        mean.b += samples[i].b;
+    }
+    mean.l /= count;
+    mean.a /= count;
+    mean.b /= count;
+
+    // Start from the mean, then repeatedly the sample farthest from every centre so far
+    int clusters = min(COLOUR_CLUSTERS, count);
+    Lab centres[COLOUR_CLUSTERS];
+    centres[0] = mean;
+    for (int k = 1; k < clusters; k++) {
+        int farthest = 0;
+        float farthestDifference = -1;
+        for (int i = 0; i < count; i++) {
+            float nearest = 1e30f;
+            for (int c = 0; c < k; c++) {
+                nearest = min(nearest, difference(samples[i], centres[c]));
+            }
+            if (nearest > farthestDifference) {
+                farthestDifference = nearest;
+                farthest = i;
+            }
+        }
+        centres[k] = samples[farthest];
+    }
+
+    int members[COLOUR_CLUSTERS];
+    for (int iteration = 0; iteration < COLOUR_ITERATIONS; iteration++) {
+        bool moved = false;
+        for (int i = 0; i < count; i++) {
+            int best = 0;
+            float bestDifference = 1e30f;
+            for (int c = 0; c < clusters; c++) {
+                float d = difference(samples[i], centres[c]);
+                if (d < bestDifference) {
+                    bestDifference = d;
+                    best = c;
+                }
+            }
+            if (iteration == 0 || assignment[i] != best) moved = true;
+            assignment[i] = best;
+        }
+        if (!moved) break;
+
+        Lab sums[COLOUR_CLUSTERS];
+        memset(sums, 0, sizeof(sums));
+        memset(members, 0, sizeof(members));
+        for (int i = 0; i < count; i++) {
+            Lab& sum = sums[assignment[i]];
+            sum.l += samples[i].l;
+            sum.a += samples[i].a;
+            sum.b += samples[i].b;
+            members[assignment[i]]++;
+        }
+        for (int c = 0; c < clusters; c++) {
+            if (members[c] == 0) continue;  // Empty cluster keeps its centre
+            centres[c] = { sums[c].l / members[c], sums[c].a / members[c], sums[c].b / members[c] };
+        }
+    }
+
+    // Name each cluster, pooling clusters that get the same name. Shadows pull the
+    // mean lightness down, so the name uses the lightness of the lit part instead.
+    int nameOf[COLOUR_CLUSTERS];
+    for (int c = 0; c < clusters; c++) {
+        uint16_t histogram[101];
+        memset(histogram, 0, sizeof(histogram));
+        int size = 0;
+        for (int i = 0; i < count; i++) {
+            if (assignment[i] != c) continue;
+            histogram[constrain((int)samples[i].l, 0, 100)]++;
+            size++;
+        }
+        Lab named = centres[c];
+        int above = 0;
+        for (int l = 100; l >= 0 && size > 0; l--) {
+            above += histogram[l];
+            if (above * 4 >= size) {
+                named.l = l + 0.5f;
+                break;
+            }
+        }
+        nameOf[c] = nearestLab(named);
+    }
+    int pooled[NAMED_COLOUR_COUNT];
+    uint32_t sums[NAMED_COLOUR_COUNT][3];
+    memset(pooled, 0, sizeof(pooled));
+    memset(sums, 0, sizeof(sums));
+    for (int i = 0; i < count; i++) {
+        int name = nameOf[assignment[i]];
+        pooled[name]++;
+        sums[name][0] += rgb[i * 3];
+        sums[name][1] += rgb[i * 3 + 1];
+        sums[name][2] += rgb[i * 3 + 2];
+    }
+    free(samples);
+    free(assignment);
+
+    // Largest first; the largest is always reported
+    while (result->count < COLOUR_MAX_NAMES) {
+        int best = -1;
+        for (int n = 0; n < NAMED_COLOUR_COUNT; n++) {
+            if (pooled[n] > 0 && (best < 0 || pooled[n] > pooled[best])) best = n;
+        }
+        if (best < 0) break;
+        float share = (float)pooled[best] / count;
+        if (result->count > 0 && share < COLOUR_MIN_SHARE) break;
+
+        DominantColour& colour = result->colours[result->count++];
+        colour.name = best;
+        colour.share = share;
+        colour.r = sums[best][0] / pooled[best];
+        colour.g = sums[best][1] / pooled[best];
+        colour.b = sums[best][2] / pooled[best];
+        pooled[best] = 0;
+    }
+    return result->count > 0;
+}
+
+int ColourIdentifier::nearestName(uint8_t r, uint8_t g, uint8_t b) {
+    return nearestLab(toLab(r, g, b));
+}
+
+const char* ColourIdentifier::colourName(int index) {
+    if (index < 0 || index >= NAMED_COLOUR_COUNT) return "unknown";
+    return NAMED_COLOURS[index].name;
+}
+
+int ColourIdentifier::nameCount() {
+    return NAMED_COLOUR_COUNT;
+}
+
+ColourIdentifierStats ColourIdentifier::getStats() {
+    return stats;
+}
+
+void ColourIdentifier::logStats() {
+    if (stats.frames == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.frames);
+    Serial.printf("Colour: %u frames, avg %lu us, last %lu us\n", stats.frames, avgMicros, stats.lastMicros);
+}
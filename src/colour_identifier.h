@@ -0,0 +1,59 @@
+#ifndef COLOUR_IDENTIFIER_H
+#define COLOUR_IDENTIFIER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+// One dominant colour of the sampled region
+struct DominantColour {
+    uint8_t name;             // Index into the named colour table
+    float share;              // Fraction of samples in this colour
+    uint8_t r;                // Mean sRGB of those samples
+    uint8_t g;
+    uint8_t b;
+};
+
+// Dominant colours, largest share first
+struct ColourResult {
+    DominantColour colours[COLOUR_MAX_NAMES];
+    int count;
+    unsigned long micros;
+};
+
+struct ColourIdentifierStats {
+    uint32_t frames;
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// Local colour identification. A centre square of the frame is sampled on a
+// COLOUR_SAMPLE_GRID grid from a reduced-scale YCbCr decode of the JPEG, the
+// samples are clustered with k-means in CIELAB, and each cluster is named after
+// the nearest entry of a small named colour table.
+class ColourIdentifier {
+private:
+    ColourIdentifierStats stats;
+
+public:
+    ColourIdentifier();
+
+    // Dominant colours at the centre of a JPEG
+    bool identify(const uint8_t* jpeg, size_t length, ColourResult* result);
+
+    // Dominant colours of `count` packed sRGB samples
+    static bool identifySamples(const uint8_t* rgb, int count, ColourResult* result);
+
+    // Named colour table
+    static int nearestName(uint8_t r, uint8_t g, uint8_t b);
+    static const char* colourName(int index);
+    static int nameCount();
+
+    // Statistics
+    ColourIdentifierStats getStats();
+    void logStats();
+};
+
+// Global colour identifier instance
+extern ColourIdentifier colourIdentifier;
+
+#endif // COLOUR_IDENTIFIER_H
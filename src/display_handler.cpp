@@ -206,6 +206,8 @@ String DisplayHandler::formatModeString(OperationMode mode) {
         case MODE_VISUAL_CAPTION: return "VISUAL DESC";
         case MODE_SIGN_DETECTION: return "SIGN DETECT";
         case MODE_OCR: return "TEXT SCAN";
+        case MODE_BARCODE: return "CODE SCAN";
+        case MODE_COLOUR: return "COLOUR ID";
         case MODE_AUTO_ALL: return "AUTO MODE";
         default: return "UNKNOWN";
     }
@@ -0,0 +1,362 @@
+#include "feedback_engine.h"
+#include <cstring>
+
+FeedbackEngine feedbackEngine;
+
+// Task configuration
+static const uint32_t FEEDBACK_TASK_STACK = 2048;
+
+namespace {
+
+// Timings as the blocking versions they replace
+const FeedbackStep TAP_STEPS[] = { { 100, FEEDBACK_VIBRATION, 0 } };
+const FeedbackStep LIGHT_STEPS[] = { { 200, FEEDBACK_VIBRATION, 0 } };
+const FeedbackStep MEDIUM_STEPS[] = { { 200, FEEDBACK_VIBRATION, 0 }, { 100, 0, 0 }, { 200, FEEDBACK_VIBRATION, 0 } };
+const FeedbackStep STRONG_STEPS[] = { { 300, FEEDBACK_VIBRATION, 0 }, { 200, 0, 0 } };
+const FeedbackStep COLLISION_STEPS[] = { { 100, FEEDBACK_VIBRATION, 0 }, { 100, 0, 0 } };
+const FeedbackStep FLASH_STEPS[] = { { 100, FEEDBACK_HAZARD_LED, 0 }, { 100, 0, 0 } };
+
+const FeedbackPattern PATTERNS[FEEDBACK_PATTERN_COUNT] = {
+    { TAP_STEPS,       1, 1,  FEEDBACK_VIBRATION,  FEEDBACK_PRIORITY_NOTIFY },
+    { LIGHT_STEPS,     1, 1,  FEEDBACK_VIBRATION,  FEEDBACK_PRIORITY_NOTIFY },
+    { MEDIUM_STEPS,    3, 1,  FEEDBACK_VIBRATION,  FEEDBACK_PRIORITY_WARNING },
+    { STRONG_STEPS,    2, 3,  FEEDBACK_VIBRATION,  FEEDBACK_PRIORITY_HAZARD },
+    { COLLISION_STEPS, 2, 5,  FEEDBACK_VIBRATION,  FEEDBACK_PRIORITY_HAZARD },
+    { FLASH_STEPS,     2, 10, FEEDBACK_HAZARD_LED, FEEDBACK_PRIORITY_EMERGENCY }
+};
+
+const uint8_t LED_CHANNELS = FEEDBACK_STATUS_LED | FEEDBACK_HAZARD_LED | FEEDBACK_PROCESSING_LED;
+
+bool overlaps(const FeedbackSlot& slot, uint8_t channels) {
+    return (slot.channels & channels) != 0;
+}
+
+} // namespace
+
+FeedbackEngine::FeedbackEngine() {
+    isRunning = false;
+    taskHandle = nullptr;
+    lock = portMUX_INITIALIZER_UNLOCKED;
+    memset(slots, 0, sizeof(slots));
+    nextSequence = 0;
+    baseline = 0;
+    outputs = 0;
+    frequency = 0;
+    outputsWritten = false;
+    memset(&stats, 0, sizeof(stats));
+}
+
+FeedbackEngine::~FeedbackEngine() {
+    end();
+}
+
+bool FeedbackEngine::begin() {
+    if (isRunning) return true;
+
+    pinMode(STATUS_LED_PIN, OUTPUT);
+    pinMode(HAZARD_LED_PIN, OUTPUT);
+    pinMode(PROCESSING_LED_PIN, OUTPUT);
+    pinMode(BUZZER_PIN, OUTPUT);
+    pinMode(VIBRATION_PIN, OUTPUT);
+
+    isRunning = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(feedbackTask, "feedback", FEEDBACK_TASK_STACK,
+                                            this, FEEDBACK_TASK_PRIORITY, &taskHandle, FEEDBACK_TASK_CORE);
+    if (ok != pdPASS) {
+        Serial.println("Feedback engine: failed to create task");
+        isRunning = false;
+        taskHandle = nullptr;
+        return false;
+    }
+    Serial.println("Feedback engine started");
+    return true;
+}
+
+void FeedbackEngine::end() {
+    if (!isRunning) return;
+    isRunning = false;
+    wake();
+
+    // The task notices the flag on its next wake-up and deletes itself
+    unsigned long start = millis();
+    while (taskHandle && millis() - start < 1000) {
+        delay(10);
+    }
+    Serial.println("Feedback engine stopped");
+}
+
+bool FeedbackEngine::isActive() {
+    return isRunning;
+}
+
+void FeedbackEngine::feedbackTask(void* param) {
+    FeedbackEngine* engine = (FeedbackEngine*)param;
+    engine->runLoop();
+    engine->taskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void FeedbackEngine::runLoop() {
+    while (isRunning) {
+        unsigned long wait = tick(millis());
+        // Sleeps until the next step is due; play() wakes it early
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(max(wait, 1UL)));
+    }
+    stop(FEEDBACK_ALL_CHANNELS);
+    writeOutputs(baseline & LED_CHANNELS, 0);
+}
+
+void FeedbackEngine::wake() {
+    if (taskHandle) xTaskNotifyGive(taskHandle);
+}
+
+bool FeedbackEngine::play(FeedbackPatternId id) {
+    if (id < 0 || id >= FEEDBACK_PATTERN_COUNT) return false;
+    return play(PATTERNS[id]);
+}
+
+bool FeedbackEngine::play(const FeedbackPattern& pattern) {
+    return queuePattern(pattern.steps, pattern.count, pattern.repeat, pattern.channels, pattern.priority);
+}
+
+bool FeedbackEngine::playTone(int frequency, int duration, uint8_t priority) {
+    FeedbackStep step = { (uint16_t)duration, FEEDBACK_BUZZER, (uint16_t)frequency };
+    return queuePattern(&step, 1, 1, FEEDBACK_BUZZER, priority);
+}
+
+bool FeedbackEngine::queuePattern(const FeedbackStep* steps, int count, int repeat, uint8_t channels, uint8_t priority) {
+    if (!isRunning || count <= 0 || repeat <= 0) return false;
+    count = min(count, FEEDBACK_MAX_STEPS);
+
+    portENTER_CRITICAL(&lock);
+    // A free slot, else the least urgent pending one if it is below this pattern
+    int index = -1;
+    int victim = -1;
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        if (slots[i].state == FEEDBACK_SLOT_FREE) {
+            index = i;
+            break;
+        }
+        if (slots[i].state == FEEDBACK_SLOT_PENDING && slots[i].priority < priority &&
+            (victim < 0 || slots[i].priority < slots[victim].priority)) {
+            victim = i;
+        }
+    }
+    if (index < 0 && victim >= 0) {
+        slots[victim].state = FEEDBACK_SLOT_FREE;
+        stats.dropped++;
+        index = victim;
+    }
+    if (index < 0) {
+        stats.dropped++;
+        portEXIT_CRITICAL(&lock);
+        return false;
+    }
+
+    // Waits behind patterns at least as urgent on its outputs, preempts the rest
+    bool blocked = false;
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        const FeedbackSlot& other = slots[i];
+        bool active = other.state == FEEDBACK_SLOT_PLAYING || other.state == FEEDBACK_SLOT_STARTING;
+        if (active && overlaps(other, channels) && other.priority >= priority) blocked = true;
+    }
+    if (!blocked) {
+        for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+            FeedbackSlot& other = slots[i];
+            bool active = other.state == FEEDBACK_SLOT_PLAYING || other.state == FEEDBACK_SLOT_STARTING;
+            if (active && overlaps(other, channels)) {
+                other.state = FEEDBACK_SLOT_FREE;
+                stats.preempted++;
+            }
+        }
+    }
+
+    FeedbackSlot& slot = slots[index];
+    memcpy(slot.steps, steps, count * sizeof(FeedbackStep));
+    slot.count = count;
+    slot.step = 0;
+    slot.repeatsLeft = repeat;
+    slot.channels = channels;
+    slot.priority = priority;
+    slot.sequence = nextSequence++;
+    slot.stamped = false;
+    slot.state = blocked ? FEEDBACK_SLOT_PENDING : FEEDBACK_SLOT_STARTING;
+    if (blocked) stats.queued++;
+    portEXIT_CRITICAL(&lock);
+
+    wake();
+    return true;
+}
+
+void FeedbackEngine::stop(uint8_t channels) {
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        if (slots[i].state != FEEDBACK_SLOT_FREE && overlaps(slots[i], channels)) {
+            slots[i].state = FEEDBACK_SLOT_FREE;
+        }
+    }
+    portEXIT_CRITICAL(&lock);
+    wake();
+}
+
+bool FeedbackEngine::isIdle() {
+    bool idle = true;
+    portENTER_CRITICAL(&lock);
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        if (slots[i].state != FEEDBACK_SLOT_FREE) idle = false;
+    }
+    portEXIT_CRITICAL(&lock);
+    return idle;
+}
+
+void FeedbackEngine::setBaseline(uint8_t levels, uint8_t channels) {
+    channels &= LED_CHANNELS;
+    portENTER_CRITICAL(&lock);
+    baseline = (baseline & ~channels) | (levels & channels);
+    portEXIT_CRITICAL(&lock);
+    if (isRunning) {
+        wake();
+    } else {
+        tick(millis());
+    }
+}
+
+void FeedbackEngine::startEligible(unsigned long now) {
+    // Pending patterns, most urgent and then oldest first, once their outputs are free
+    while (true) {
+        int best = -1;
+        for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+            const FeedbackSlot& slot = slots[i];
+            if (slot.state != FEEDBACK_SLOT_PENDING) continue;
+            bool blocked = false;
+            for (int j = 0; j < FEEDBACK_SLOTS; j++) {
+                bool active = slots[j].state == FEEDBACK_SLOT_PLAYING || slots[j].state == FEEDBACK_SLOT_STARTING;
+                if (active && overlaps(slots[j], slot.channels)) blocked = true;
+            }
+            if (blocked) continue;
+            if (best < 0 || slot.priority > slots[best].priority ||
+                (slot.priority == slots[best].priority && slot.sequence < slots[best].sequence)) {
+                best = i;
+            }
+        }
+        if (best < 0) break;
+        slots[best].state = FEEDBACK_SLOT_STARTING;
+    }
+
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        FeedbackSlot& slot = slots[i];
+        if (slot.state != FEEDBACK_SLOT_STARTING) continue;
+        slot.state = FEEDBACK_SLOT_PLAYING;
+        slot.step = 0;
+        slot.stepEnd = now + slot.steps[0].millis;
+        stats.played++;
+    }
+}
+
+unsigned long FeedbackEngine::tick(unsigned long now) {
+    portENTER_CRITICAL(&lock);
+    stats.ticks++;
+
+    // Advance playing patterns past every step that is due
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        FeedbackSlot& slot = slots[i];
+        if (slot.state != FEEDBACK_SLOT_PLAYING) continue;
+        while ((long)(now - slot.stepEnd) >= 0) {
+            stats.maxLateMillis = max(stats.maxLateMillis, now - slot.stepEnd);
+            if (++slot.step == slot.count) {
+                slot.step = 0;
+                if (--slot.repeatsLeft == 0) {
+                    slot.state = FEEDBACK_SLOT_FREE;
+                    stats.completed++;
+                    break;
+                }
+            }
+            slot.stepEnd += slot.steps[slot.step].millis;
+        }
+    }
+
+    // Drop stale pending patterns, then start those whose outputs are free
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        FeedbackSlot& slot = slots[i];
+        if (slot.state != FEEDBACK_SLOT_PENDING) continue;
+        if (!slot.stamped) {
+            // play() has no clock; the wait starts at the tick it wakes
+            slot.queued = now;
+            slot.stamped = true;
+        }
+        if (now - slot.queued > FEEDBACK_MAX_DELAY) {
+            slot.state = FEEDBACK_SLOT_FREE;
+            stats.dropped++;
+        }
+    }
+    startEligible(now);
+
+    // Outputs: owned channels from their pattern's step, LEDs otherwise from the baseline
+    uint8_t owned = 0;
+    uint8_t levels = 0;
+    uint16_t tone = 0;
+    unsigned long wait = FEEDBACK_IDLE_WAIT;
+    for (int i = 0; i < FEEDBACK_SLOTS; i++) {
+        const FeedbackSlot& slot = slots[i];
+        if (slot.state != FEEDBACK_SLOT_PLAYING) continue;
+        const FeedbackStep& step = slot.steps[slot.step];
+        owned |= slot.channels;
+        levels |= step.on & slot.channels;
+        if (step.on & slot.channels & FEEDBACK_BUZZER) tone = step.frequency;
+        wait = min(wait, slot.stepEnd - now);
+    }
+    levels |= baseline & LED_CHANNELS & ~owned;
+    portEXIT_CRITICAL(&lock);
+
+    writeOutputs(levels, tone);
+    return wait;
+}
+
+void FeedbackEngine::writeOutputs(uint8_t levels, uint16_t tone) {
+    // Only the outputs that changed
+    static const uint8_t channels[] = { FEEDBACK_VIBRATION, FEEDBACK_STATUS_LED, FEEDBACK_HAZARD_LED, FEEDBACK_PROCESSING_LED };
+    static const int pins[] = { VIBRATION_PIN, STATUS_LED_PIN, HAZARD_LED_PIN, PROCESSING_LED_PIN };
+    for (int i = 0; i < 4; i++) {
+        bool on = levels & channels[i];
+        if (!outputsWritten || on != (bool)(outputs & channels[i])) {
+            digitalWrite(pins[i], on ? HIGH : LOW);
+        }
+    }
+
+    if (tone != frequency) {
+        if (tone > 0) {
+            ledcSetup(FEEDBACK_LEDC_CHANNEL, tone, 8);
+            if (frequency == 0) ledcAttachPin(BUZZER_PIN, FEEDBACK_LEDC_CHANNEL);
+            ledcWrite(FEEDBACK_LEDC_CHANNEL, 128);
+        } else {
+            ledcWrite(FEEDBACK_LEDC_CHANNEL, 0);
+            ledcDetachPin(BUZZER_PIN);
+        }
+    }
+    outputs = levels | (tone > 0 ? FEEDBACK_BUZZER : 0);
+    frequency = tone;
+    outputsWritten = true;
+}
+
+uint8_t FeedbackEngine::getOutputs() {
+    return outputs;
+}
+
+uint16_t FeedbackEngine::getFrequency() {
+    return frequency;
+}
+
+FeedbackStats FeedbackEngine::getStats() {
+    FeedbackStats snapshot;
+    portENTER_CRITICAL(&lock);
+    snapshot = stats;
+    portEXIT_CRITICAL(&lock);
+    return snapshot;
+}
+
+void FeedbackEngine::logStats() {
+    FeedbackStats s = getStats();
+    if (s.played == 0 && s.dropped == 0) return;
+    Serial.printf("Feedback: %u patterns played (%u completed, %u preempted), %u queued, %u dropped, %u ticks, max %lu ms late\n",
+                  s.played, s.completed, s.preempted, s.queued, s.dropped, s.ticks, s.maxLateMillis);
+}
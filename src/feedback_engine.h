@@ -0,0 +1,147 @@
+#ifndef FEEDBACK_ENGINE_H
+#define FEEDBACK_ENGINE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "intel_glasses_config.h"
+
+// Outputs driven by the engine, as bits of a mask
+enum FeedbackChannel {
+    FEEDBACK_BUZZER         = 1,
+    FEEDBACK_VIBRATION      = 2,
+    FEEDBACK_STATUS_LED     = 4,
+    FEEDBACK_HAZARD_LED     = 8,
+    FEEDBACK_PROCESSING_LED = 16,
+    FEEDBACK_ALL_CHANNELS   = 31
+};
+
+// A pattern only preempts patterns of lower priority on the same outputs
+enum FeedbackPriority {
+    FEEDBACK_PRIORITY_NOTIFY,     // Confirmation tones and light haptics
+    FEEDBACK_PRIORITY_WARNING,    // Warning signs
+    FEEDBACK_PRIORITY_HAZARD,     // Hazards and collision warnings
+    FEEDBACK_PRIORITY_EMERGENCY
+};
+
+enum FeedbackPatternId {
+    FEEDBACK_HAPTIC_TAP,
+    FEEDBACK_HAPTIC_LIGHT,
+    FEEDBACK_HAPTIC_MEDIUM,
+    FEEDBACK_HAPTIC_STRONG,
+    FEEDBACK_HAPTIC_COLLISION,
+    FEEDBACK_EMERGENCY_FLASH,
+    FEEDBACK_PATTERN_COUNT
+};
+
+// One timed step: the pattern's outputs in `on` are on for `millis`
+struct FeedbackStep {
+    uint16_t millis;
+    uint8_t on;               // FeedbackChannel bits
+    uint16_t frequency;       // Buzzer tone (Hz) while FEEDBACK_BUZZER is on
+};
+
+struct FeedbackPattern {
+    const FeedbackStep* steps;
+    uint8_t count;
+    uint8_t repeat;           // Times the steps are played
+    uint8_t channels;         // Outputs the pattern owns while it plays
+    uint8_t priority;         // FeedbackPriority
+};
+
+enum FeedbackSlotState {
+    FEEDBACK_SLOT_FREE,
+    FEEDBACK_SLOT_PENDING,    // Waiting for its outputs
+    FEEDBACK_SLOT_STARTING,   // Outputs free, starts on the next tick
+    FEEDBACK_SLOT_PLAYING
+};
+
+struct FeedbackSlot {
+    FeedbackStep steps[FEEDBACK_MAX_STEPS];
+    uint8_t count;
+    uint8_t step;
+    uint8_t repeatsLeft;
+    uint8_t channels;
+    uint8_t priority;
+    uint8_t state;            // FeedbackSlotState
+    uint32_t sequence;        // Arrival order
+    unsigned long stepEnd;
+    unsigned long queued;     // First tick it waited at
+    bool stamped;             // `queued` is set
+};
+
+struct FeedbackStats {
+    uint32_t played;          // Patterns started
+    uint32_t completed;
+    uint32_t preempted;       // Cut short by a more urgent pattern
+    uint32_t queued;          // Had to wait for their outputs
+    uint32_t dropped;         // No free slot, or waited longer than FEEDBACK_MAX_DELAY
+    uint32_t ticks;
+    unsigned long maxLateMillis; // Worst delay of a step change past its due time
+};
+
+// Non-blocking tones, haptics and LEDs. A pattern is a list of timed steps
+// over the outputs it owns. play() only queues it; a dedicated task runs
+// tick(), which advances the steps and writes the outputs, and then sleeps
+// until the next step is due or a new pattern arrives. A pattern preempts
+// playing patterns of lower priority on the same outputs. Otherwise it waits
+// for those outputs, up to FEEDBACK_MAX_DELAY. Patterns on different outputs
+// play together. An LED not owned by a pattern shows the baseline set by
+// setBaseline(). tick() takes the time as a parameter, so the timing can be
+// checked with a virtual clock.
+class FeedbackEngine {
+private:
+    volatile bool isRunning;
+    TaskHandle_t taskHandle;
+    portMUX_TYPE lock;
+
+    FeedbackSlot slots[FEEDBACK_SLOTS];
+    uint32_t nextSequence;
+    uint8_t baseline;         // LED levels when no pattern owns them
+    uint8_t outputs;          // Levels written last
+    uint16_t frequency;       // Buzzer tone written last, 0 when silent
+    bool outputsWritten;
+    FeedbackStats stats;
+
+    static void feedbackTask(void* param);
+    void runLoop();
+    bool queuePattern(const FeedbackStep* steps, int count, int repeat, uint8_t channels, uint8_t priority);
+    void startEligible(unsigned long now);
+    void writeOutputs(uint8_t levels, uint16_t tone);
+    void wake();
+
+public:
+    FeedbackEngine();
+    ~FeedbackEngine();
+
+    bool begin();
+    void end();
+    bool isActive();
+
+    // Queue a pattern; false when it was dropped
+    bool play(FeedbackPatternId id);
+    bool play(const FeedbackPattern& pattern);
+    bool playTone(int frequency, int duration, uint8_t priority = FEEDBACK_PRIORITY_NOTIFY);
+    void stop(uint8_t channels);
+    bool isIdle();
+
+    // LED levels shown while no pattern owns them
+    void setBaseline(uint8_t levels, uint8_t channels);
+
+    // Advance to `now` and write the outputs; returns ms until the next step is
+    // due, or FEEDBACK_IDLE_WAIT when nothing is playing
+    unsigned long tick(unsigned long now);
+
+    // Levels and tone as last written
+    uint8_t getOutputs();
+    uint16_t getFrequency();
+
+    // Statistics
+    FeedbackStats getStats();
+    void logStats();
+};
+
+// Global feedback engine instance
+extern FeedbackEngine feedbackEngine;
+
+#endif // FEEDBACK_ENGINE_H
@@ -1,4 +1,7 @@
 #include "gsm_module.h"
+#include "response_decoder.h"
+#include "jpeg_transcoder.h"
+#include "camera_manager.h"
 #include <base64.h>
 #include <StreamDebugger.h>
 #define TINY_GSM_MODEM_SIM800
@@ -16,17 +19,70 @@ TinyGsm gsmModem(debugger);
 
 GSMModule gsmModule;
 
+namespace {
+
+// Chunked response body sink: the first resultLength bytes are the result,
+// anything after them is inline audio, kept while it fits and counted either way
+class ResponseSplitter : public Stream {
+public:
+    String* result;
+    size_t resultLength;
+    uint8_t* audio;
+    size_t audioSize;
+
+    size_t write(uint8_t byte) override {
+        return write(&byte, 1);
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t taken = 0;
+        if (result->length() < resultLength) {
+            taken = min(size, resultLength - result->length());
+            result->concat((const char*)data, taken);
+        }
+        size_t rest = size - taken;
+        if (audio && audioSize + rest <= INLINE_AUDIO_MAX_BYTES) {
+            memcpy(audio + audioSize, data + taken, rest);
+        }
+        audioSize += rest;
+        return size;
+    }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+} // namespace
+
 GSMModule::GSMModule() {
     gsmSerial = &Serial2;
     modem = &gsmModem;
     client = nullptr;
     http = nullptr;
     isConnected = false;
+    preEncodedSource = nullptr;
+    preEncodedImage = nullptr;
+    uplinkBytesPerSecond = 0;
+    optimizeMicrosPerKB = 0;
+    optimizeSavingRatio = 0.07;
+    imagesOptimized = 0;
+    imagesNotOptimized = 0;
+    bytesSaved = 0;
+    inlineStream = nullptr;
+    inlineAudio = nullptr;
+    inlineAudioSize = 0;
+    apiRequests = 0;
+    inlineAudioResponses = 0;
+    inlineAudioDropped = 0;
+    inlineAudioBytes = 0;
 }
 
 GSMModule::~GSMModule() {
     if (client) delete client;
+    dropInlineAudio();
     if (http) delete http;
+    free(inlineAudio);
 }
 
 bool GSMModule::initialize() {
@@ -105,30 +161,59 @@ void GSMModule::disconnect() {
     isConnected = false;
 }
 
-APIResponse GSMModule::sendImageForAnalysis(uint8_t* imageData, size_t imageSize, const String& endpoint, OperationMode mode) {
+APIResponse GSMModule::sendImageForAnalysis(uint8_t* imageData, size_t imageSize, const String& endpoint, OperationMode mode,
+                                            const char* format) {
     APIResponse response;
     response.success = false;
     response.confidence = 0.0;
     response.processing_time = 0;
+    response.regionCount = 0;
+    response.structured = false;
+    response.hasAudio = false;
+    response.audioInline = false;
+    dropInlineAudio();
     
     if (!isNetworkConnected()) {
         response.error = "Network not connected";
         return response;
     }
     
-    // Encode image to Base64
-    String base64Image = encodeImageToBase64(imageData, imageSize);
-    if (base64Image.length() == 0) {
+    // Encode image to Base64, reusing the pipeline's encoding when it matches this image
+    String localEncoding;
+    const String* base64Image = &localEncoding;
+    if (preEncodedImage && preEncodedSource == imageData) {
+        base64Image = preEncodedImage;
+    } else {
+        localEncoding = encodeImageToBase64(imageData, imageSize);
+    }
+    if (base64Image->length() == 0) {
         response.error = "Failed to encode image";
         return response;
     }
     
     // Create JSON payload
     JsonDocument doc;
-    doc["image"] = base64Image;
+    doc["image"] = *base64Image;
     doc["api_key"] = CLOUD_API_KEY;
     doc["mode"] = (int)mode;
     doc["timestamp"] = millis();
+    if (format) {
+        doc["format"] = format;  // Non-JPEG payload (e.g. bilevel TIFF for OCR)
+    }
+#if ENABLE_STRUCTURED_RESPONSES
+    doc["schema_version"] = STRUCTURED_RESPONSE_VERSION;
+#endif
+#if ENABLE_INLINE_AUDIO
+    // Speech may follow the result in this response, saving a request for audio_url;
+    // only for results that are spoken, hazards are announced from local clips
+    if (mode == MODE_VISUAL_CAPTION || mode == MODE_SIGN_DETECTION || mode == MODE_OCR) {
+        doc["audio_inline"] = INLINE_AUDIO_FORMAT;
+    }
+#endif
+#if ENABLE_CLIP_CACHE
+    // Part of the clip cache key, so the server must speak in this voice
+    doc["voice"] = CLOUD_TTS_VOICE;
+#endif
     
     String jsonString;
     serializeJson(doc, jsonString);
@@ -137,6 +222,13 @@ APIResponse GSMModule::sendImageForAnalysis(uint8_t* imageData, size_t imageSize
     String url = "https://" + String(CLOUD_API_HOST) + ":" + String(CLOUD_API_PORT) + endpoint;
     http->begin(url);  // Use URL-only method for TinyGsm compatibility
     http->addHeader("Content-Type", "application/json");
+#if ENABLE_STRUCTURED_RESPONSES
+    // CBOR preferred; a server that ignores this answers in JSON as before
+    http->addHeader("Accept", "application/cbor, application/json;q=0.5");
+#endif
+    // X-Result-Length is where inline audio starts
+    const char* responseHeaders[] = { "Content-Type", "X-Result-Length" };
+    http->collectHeaders(responseHeaders, 2);
     http->addHeader("Authorization", "Bearer " + String(CLOUD_API_KEY));
     http->setTimeout(CLOUD_API_TIMEOUT);
     
@@ -147,13 +239,49 @@ APIResponse GSMModule::sendImageForAnalysis(uint8_t* imageData, size_t imageSize
     int httpResponseCode = http->POST(jsonString);
     
     if (httpResponseCode > 0) {
-        String responsePayload = http->getString();
+        // The round trip includes server time, so this under-reads the link rate
+        unsigned long elapsed = millis() - startTime;
+        if (elapsed > 0) {
+            float rate = jsonString.length() * 1000.0 / elapsed;
+            uplinkBytesPerSecond = uplinkBytesPerSecond > 0 ? uplinkBytesPerSecond * 0.7 + rate * 0.3 : rate;
+        }
+        
+        apiRequests++;
+        bool cbor = http->header("Content-Type").startsWith("application/cbor");
+        String responsePayload;
+        long resultLength = http->header("X-Result-Length").toInt();
+        bool withAudio = ENABLE_INLINE_AUDIO && httpResponseCode == 200 && resultLength > 0;
+        if (withAudio && http->getSize() > resultLength) {
+            // Only the result is read here; the audio plays off the connection as it arrives
+            if (readResult(http->getStreamPtr(), &responsePayload, resultLength)) {
+                inlineStream = http;
+                inlineAudioSize = http->getSize() - resultLength;
+                inlineAudioResponses++;
+                inlineAudioBytes += inlineAudioSize;
+                http = new HTTPClient();
+            }
+        } else if (withAudio) {
+            // Without a length (chunked) the audio has to be read out whole
+            inlineAudioSize = readInlineResponse(&responsePayload, resultLength);
+        } else {
+            responsePayload = http->getString();
+        }
         Serial.printf("HTTP Response code: %d\n", httpResponseCode);
-        Serial.println("Response: " + responsePayload);
+        if (cbor) {
+            Serial.printf("Response: %u bytes CBOR\n", responsePayload.length());
+        } else {
+            Serial.println("Response: " + responsePayload);
+        }
         
         if (httpResponseCode == 200) {
-            response = parseAPIResponse(responsePayload);
+            response = cbor ? parseStructuredResponse(responsePayload, mode) : parseAPIResponse(responsePayload);
             response.processing_time = millis() - startTime;
+            if (inlineAudioSize > 0) {
+                response.hasAudio = true;
+                response.audioInline = true;
+                response.audioSize = inlineAudioSize;
+                Serial.printf("Inline audio: %u bytes\n", (unsigned)inlineAudioSize);
+            }
         } else {
             response.error = "HTTP Error: " + String(httpResponseCode);
         }
@@ -178,8 +306,8 @@ APIResponse GSMModule::callSignDetection(uint8_t* imageData, size_t imageSize) {
     return sendImageForAnalysis(imageData, imageSize, SIGN_DETECTION_ENDPOINT, MODE_SIGN_DETECTION);
 }
 
-APIResponse GSMModule::callOCR(uint8_t* imageData, size_t imageSize) {
-    return sendImageForAnalysis(imageData, imageSize, OCR_ENDPOINT, MODE_OCR);
+APIResponse GSMModule::callOCR(uint8_t* imageData, size_t imageSize, const char* format) {
+    return sendImageForAnalysis(imageData, imageSize, OCR_ENDPOINT, MODE_OCR, format);
 }
 
 String GSMModule::getSignalQuality() {
@@ -219,9 +347,9 @@ String GSMModule::encodeImageToBase64(uint8_t* imageData, size_t imageSize) {
     // Calculate Base64 encoded size
     size_t base64Size = ((imageSize + 2) / 3) * 4;
     
-    // Check if we have enough memory
-    if (base64Size > 100000) { // 100KB limit for Base64
-        Serial.println("Image too large for Base64 encoding");
+    // Nothing the camera captures is larger, so anything that is must be a mistake
+    if (base64Size > (CameraManager::getMaxJpegSize() + 2) / 3 * 4) {
+        Serial.printf("Image too large for Base64 encoding (%u bytes)\n", (unsigned)imageSize);
         return "";
     }
     
@@ -230,9 +358,153 @@ String GSMModule::encodeImageToBase64(uint8_t* imageData, size_t imageSize) {
     return encoded;
 }
 
+void GSMModule::setPreEncodedImage(const uint8_t* imageData, const String* encodedImage) {
+    preEncodedSource = imageData;
+    preEncodedImage = encodedImage;
+}
+
+bool GSMModule::optimizeImageForUpload(uint8_t** imageData, size_t* imageSize) {
+    if (!ENABLE_JPEG_OPTIMIZATION || !*imageData || *imageSize == 0) {
+        return false;
+    }
+    
+    // Only worth it while the bytes saved take longer to send than the pass takes to run
+    float sizeKB = *imageSize / 1024.0;
+    float predictedMicros = optimizeMicrosPerKB * sizeKB;
+    if (uplinkBytesPerSecond > 0) {
+        float savedMicros = *imageSize * optimizeSavingRatio / uplinkBytesPerSecond * 1000000.0;
+        if (uplinkBytesPerSecond > JPEG_OPTIMIZE_FAST_LINK || savedMicros < predictedMicros) {
+            imagesNotOptimized++;
+            return false;
+        }
+    }
+    if (predictedMicros > JPEG_OPTIMIZE_TIME_BUDGET * 1000.0) {
+        imagesNotOptimized++;
+        return false;
+    }
+    
+    unsigned long startTime = micros();
+    uint8_t* optimized = nullptr;
+    size_t optimizedSize = 0;
+    bool success = jpegTranscoder.optimize(*imageData, *imageSize, JPEG_OPTIMIZE_TIME_BUDGET * 1000UL,
+                                           &optimized, &optimizedSize);
+    unsigned long elapsed = micros() - startTime;
+    
+    // Timeouts still teach the cost model, as a lower bound
+    float microsPerKB = elapsed / sizeKB;
+    optimizeMicrosPerKB = optimizeMicrosPerKB > 0 ? optimizeMicrosPerKB * 0.7 + microsPerKB * 0.3 : microsPerKB;
+    
+    if (!success || optimizedSize >= *imageSize) {
+        if (optimized) free(optimized);
+        imagesNotOptimized++;
+        return false;
+    }
+    
+    float ratio = 1.0 - (float)optimizedSize / *imageSize;
+    optimizeSavingRatio = optimizeSavingRatio * 0.7 + ratio * 0.3;
+    imagesOptimized++;
+    bytesSaved += *imageSize - optimizedSize;
+    
+    Serial.printf("Optimized upload: %u -> %u bytes in %lu us\n",
+                  (unsigned)*imageSize, (unsigned)optimizedSize, elapsed);
+    
+    free(*imageData);
+    *imageData = optimized;
+    *imageSize = optimizedSize;
+    return true;
+}
+
+bool GSMModule::playInlineAudio(AudioCategory category, bool priority, uint64_t cacheKey) {
+    bool queued = false;
+    if (inlineStream) {
+        // The audio manager closes the connection either way
+        queued = audioManager.playAudioStream(inlineStream, inlineAudioSize, category, priority, cacheKey);
+        inlineStream = nullptr;
+    } else if (inlineAudioSize > 0) {
+        queued = audioManager.playAudioData(inlineAudio, inlineAudioSize, category, priority, cacheKey);
+    }
+    inlineAudioSize = 0;
+    return queued;
+}
+
+void GSMModule::dropInlineAudio() {
+    if (inlineStream) {
+        inlineStream->end();
+        delete inlineStream;
+        inlineStream = nullptr;
+    }
+    inlineAudioSize = 0;
+}
+
+bool GSMModule::readResult(Client* stream, String* result, size_t resultLength) {
+    if (!stream) return false;
+    result->reserve(resultLength);
+    uint8_t block[256];
+    unsigned long lastByte = millis();
+    while (result->length() < resultLength && millis() - lastByte < CLOUD_API_TIMEOUT) {
+        int available = stream->available();
+        if (available > 0) {
+            int got = stream->read(block, min((size_t)available, min(sizeof(block), resultLength - result->length())));
+            if (got > 0) {
+                result->concat((const char*)block, got);
+                lastByte = millis();
+            }
+        } else if (!stream->connected()) {
+            break;
+        } else {
+            delay(1);
+        }
+    }
+    return result->length() == resultLength;
+}
+
+size_t GSMModule::readInlineResponse(String* result, size_t resultLength) {
+    if (!inlineAudio) {
+        inlineAudio = (uint8_t*)(psramFound() ? ps_malloc(INLINE_AUDIO_MAX_BYTES) : malloc(INLINE_AUDIO_MAX_BYTES));
+    }
+    
+    // writeToStream undoes chunked transfer encoding, which the raw stream would not
+    ResponseSplitter splitter;
+    splitter.result = result;
+    splitter.resultLength = resultLength;
+    splitter.audio = inlineAudio;
+    splitter.audioSize = 0;
+    result->reserve(resultLength);
+    if (http->writeToStream(&splitter) < 0 || result->length() < resultLength || splitter.audioSize == 0) {
+        return 0;
+    }
+    if (!inlineAudio || splitter.audioSize > INLINE_AUDIO_MAX_BYTES) {
+        Serial.printf("Inline audio dropped: %u bytes\n", (unsigned)splitter.audioSize);
+        inlineAudioDropped++;
+        return 0;
+    }
+    inlineAudioResponses++;
+    inlineAudioBytes += splitter.audioSize;
+    return splitter.audioSize;
+}
+
+float GSMModule::getUplinkThroughput() {
+    return uplinkBytesPerSecond;
+}
+
+void GSMModule::logUploadStats() {
+    Serial.printf("Uplink: %.0f bytes/s, JPEG re-optimization: %u images (%llu bytes saved, %.0f us/KB), %u skipped\n",
+                  uplinkBytesPerSecond, imagesOptimized, (unsigned long long)bytesSaved,
+                  optimizeMicrosPerKB, imagesNotOptimized);
+    
+    // Each audio_url played costs a request of its own
+    if (apiRequests == 0) return;
+    uint32_t audioRequests = audioManager.getStreamStats().requests;
+    Serial.printf("Round trips: %u API requests, %u audio fetches (%.2f per request); inline audio in %u (%llu bytes), %u too long\n",
+                  apiRequests, audioRequests, (float)(apiRequests + audioRequests) / apiRequests,
+                  inlineAudioResponses, (unsigned long long)inlineAudioBytes, inlineAudioDropped);
+}
+
 APIResponse GSMModule::parseAPIResponse(String jsonResponse) {
     APIResponse response;
+    response.structured = false;
     
+    unsigned long decodeStart = micros();
     JsonDocument doc;
     DeserializationError error = deserializeJson(doc, jsonResponse);
     
@@ -240,6 +512,8 @@ APIResponse GSMModule::parseAPIResponse(String jsonResponse) {
         response.success = false;
         response.error = "Failed to parse JSON response";
         response.hasAudio = false;
+        response.audioInline = false;
+        response.regionCount = 0;
         return response;
     }
     
@@ -253,7 +527,58 @@ APIResponse GSMModule::parseAPIResponse(String jsonResponse) {
     response.audioUrl = doc["audio_url"] | "";
     response.audioFormat = doc["audio_format"] | "mp3";
     response.audioSize = doc["audio_size"] | 0;
+    response.audioInline = false;
+    
+    // Optional regions, e.g. "regions": [{"type": "text", "box": [x, y, width, height]}]
+    // with the box in fractions of the image size
+    response.regionCount = 0;
+    for (JsonObject region : doc["regions"].as<JsonArray>()) {
+        if (response.regionCount >= API_MAX_REGIONS) break;
+        String type = region["type"] | "";
+        JsonArray box = region["box"];
+        uint8_t kind = type == "text" ? CASCADE_TEXT : (type == "sign" ? CASCADE_SIGN : 0);
+        if (kind == 0 || box.size() != 4) continue;
+        ResponseRegion& r = response.regions[response.regionCount++];
+        r.kind = kind;
+        r.x = box[0] | 0.0f;
+        r.y = box[1] | 0.0f;
+        r.width = box[2] | 0.0f;
+        r.height = box[3] | 0.0f;
+    }
+    
+    responseDecoder.recordJson(jsonResponse.length(), micros() - decodeStart);
+    return response;
+}
+
+APIResponse GSMModule::parseStructuredResponse(const String& cborResponse, OperationMode mode) {
+    APIResponse response;
+    response.structured = false;
+    response.regionCount = 0;
+    response.hasAudio = false;
+    response.audioInline = false;
     
+    StructuredResult& details = response.details;
+    if (!responseDecoder.decode((const uint8_t*)cborResponse.c_str(), cborResponse.length(), &details)) {
+        response.success = false;
+        response.error = "Failed to decode CBOR response";
+        return response;
+    }
+    
+    // Text fields for the speech and display paths
+    response.structured = true;
+    response.success = details.success;
+    response.result = details.text;
+    response.error = details.error;
+    response.confidence = details.confidence;
+    if (mode < STRUCTURED_TASKS && details.taskConfidence[mode] >= 0) {
+        response.confidence = details.taskConfidence[mode];
+    }
+    response.hasAudio = details.hasAudio;
+    response.audioUrl = details.audioUrl;
+    response.audioFormat = details.audioFormat;
+    response.audioSize = details.audioSize;
+    response.regionCount = details.regionCount;
+    memcpy(response.regions, details.regions, sizeof(response.regions));
     return response;
 }
 
@@ -7,6 +7,7 @@
 #include <ArduinoJson.h>
 #include <StreamDebugger.h>
 #include "intel_glasses_config.h"
+#include "audio_manager.h"
 
 // SIM card APN credentials (configure for your carrier)
 extern const char* apn;      // Your APN
@@ -21,6 +22,28 @@ private:
     HardwareSerial* gsmSerial;
     bool isConnected;
     
+    // Base64 payload prepared ahead of time by the capture pipeline
+    const uint8_t* preEncodedSource;
+    const String* preEncodedImage;
+    
+    // Uplink rate and JPEG re-optimization cost, learned from past uploads
+    float uplinkBytesPerSecond;       // 0 until the first upload completes
+    float optimizeMicrosPerKB;        // 0 until the first re-optimization completes
+    float optimizeSavingRatio;
+    uint32_t imagesOptimized;
+    uint32_t imagesNotOptimized;
+    uint64_t bytesSaved;
+    
+    // Speech that came inline with the last response: still on its connection,
+    // or read out whole when the response was chunked
+    HTTPClient* inlineStream;
+    uint8_t* inlineAudio;             // INLINE_AUDIO_MAX_BYTES, allocated on first use
+    size_t inlineAudioSize;
+    uint32_t apiRequests;
+    uint32_t inlineAudioResponses;
+    uint32_t inlineAudioDropped;      // Longer than INLINE_AUDIO_MAX_BYTES
+    uint64_t inlineAudioBytes;
+    
 public:
     GSMModule();
     ~GSMModule();
@@ -31,11 +54,25 @@ public:
     void disconnect();
     
     // Image upload and API call methods
-    APIResponse sendImageForAnalysis(uint8_t* imageData, size_t imageSize, const String& endpoint, OperationMode mode);
+    APIResponse sendImageForAnalysis(uint8_t* imageData, size_t imageSize, const String& endpoint, OperationMode mode,
+                                     const char* format = nullptr);
     APIResponse callHazardDetection(uint8_t* imageData, size_t imageSize);
     APIResponse callVisualCaption(uint8_t* imageData, size_t imageSize);
     APIResponse callSignDetection(uint8_t* imageData, size_t imageSize);
-    APIResponse callOCR(uint8_t* imageData, size_t imageSize);
+    APIResponse callOCR(uint8_t* imageData, size_t imageSize, const char* format = nullptr);
+    
+    // Hand audio that came with the last response to audioManager; it is
+    // dropped by the next request otherwise
+    bool playInlineAudio(AudioCategory category, bool priority, uint64_t cacheKey = 0);
+    
+    // Image encoding
+    String encodeImageToBase64(uint8_t* imageData, size_t imageSize);
+    void setPreEncodedImage(const uint8_t* imageData, const String* encodedImage);
+    bool optimizeImageForUpload(uint8_t** imageData, size_t* imageSize);
+    
+    // Link metrics
+    float getUplinkThroughput();      // Bytes per second, 0 when unknown
+    void logUploadStats();            // Also HTTP round trips per request, audio fetches included
     
     // Utility methods
     String getSignalQuality();
@@ -45,8 +82,11 @@ public:
     void reset();
     
 private:
-    String encodeImageToBase64(uint8_t* imageData, size_t imageSize);
     APIResponse parseAPIResponse(String jsonResponse);
+    APIResponse parseStructuredResponse(const String& cborResponse, OperationMode mode);
+    bool readResult(Client* stream, String* result, size_t resultLength);
+    size_t readInlineResponse(String* result, size_t resultLength);
+    void dropInlineAudio();
     bool waitForResponse(int timeout = 30000);
 };
 
@@ -0,0 +1,396 @@
+#include "hazard_classifier.h"
+#include "jpeg_transcoder.h"
+#include <LittleFS.h>
+#include <cstring>
+#include <cmath>
+
+HazardClassifier hazardClassifier;
+
+namespace {
+
+const uint16_t MODEL_VERSION = 1;
+const size_t HEADER_SIZE = 32;
+const size_t LAYER_HEADER_SIZE = 36;
+
+// Little-endian field reader over the model blob
+struct ModelReader {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+
+    bool has(size_t count) { return offset + count <= size; }
+    uint8_t u8() { return data[offset++]; }
+    uint16_t u16() { uint16_t v; memcpy(&v, data + offset, 2); offset += 2; return v; }
+    int32_t i32() { int32_t v; memcpy(&v, data + offset, 4); offset += 4; return v; }
+    float f32() { float v; memcpy(&v, data + offset, 4); offset += 4; return v; }
+};
+
+int expectedSize(int input, int kernel, int stride, bool same) {
+    return same ? (input + stride - 1) / stride : (input - kernel) / stride + 1;
+}
+
+void* allocateLarge(size_t size) {
+    return psramFound() ? ps_malloc(size) : malloc(size);
+}
+
+} // namespace
+
+HazardClassifier::HazardClassifier() {
+    model = nullptr;
+    layers = nullptr;
+    weightSums = nullptr;
+    layerCount = 0;
+    arena[0] = nullptr;
+    arena[1] = nullptr;
+    inputWidth = 0;
+    inputHeight = 0;
+    outputScale = 0;
+    outputZeroPoint = 0;
+    classCount = 0;
+    hazardClass = 0;
+    clearSinceAudit = 0;
+    memset(&stats, 0, sizeof(stats));
+}
+
+HazardClassifier::~HazardClassifier() {
+    end();
+}
+
+bool HazardClassifier::begin() {
+    if (isReady()) return true;
+
+    if (!LittleFS.begin(false)) {
+        Serial.println("Hazard classifier: filesystem unavailable");
+        return false;
+    }
+    File file = LittleFS.open(HAZARD_MODEL_PATH, FILE_READ);
+    if (!file) {
+        Serial.println("Hazard classifier: no model at " HAZARD_MODEL_PATH ", local stage disabled");
+        return false;
+    }
+    size_t size = file.size();
+    if (size < HEADER_SIZE || size > HAZARD_MAX_MODEL_SIZE) {
+        Serial.printf("Hazard classifier: bad model size %u\n", (unsigned)size);
+        file.close();
+        return false;
+    }
+    uint8_t* data = (uint8_t*)allocateLarge(size);
+    if (!data) {
+        file.close();
+        Serial.println("Hazard classifier: failed to allocate model");
+        return false;
+    }
+    size_t read = file.read(data, size);
+    file.close();
+    if (read != size) {
+        free(data);
+        Serial.println("Hazard classifier: model read failed");
+        return false;
+    }
+    return loadModel(data, size);
+}
+
+void HazardClassifier::end() {
+    if (model) free(model);
+    if (layers) free(layers);
+    if (weightSums) free(weightSums);
+    if (arena[0]) free(arena[0]);
+    if (arena[1]) free(arena[1]);
+    model = nullptr;
+    layers = nullptr;
+    weightSums = nullptr;
+    arena[0] = nullptr;
+    arena[1] = nullptr;
+    layerCount = 0;
+}
+
+bool HazardClassifier::isReady() {
+    return layerCount > 0;
+}
+
+bool HazardClassifier::loadModel(uint8_t* data, size_t size) {
+    end();
+    model = data;
+    if (!parseModel(size)) {
+        end();
+        return false;
+    }
+    Serial.printf("Hazard classifier: %d layers, %dx%d input, %u bytes\n",
+                  layerCount, inputWidth, inputHeight, (unsigned)size);
+    return true;
+}
+
+bool HazardClassifier::parseModel(size_t size) {
+    ModelReader reader = { model, size, 0 };
+    if (!reader.has(HEADER_SIZE) || memcmp(model, "HZQ8", 4) != 0) {
+        Serial.println("Hazard classifier: not a model file");
+        return false;
+    }
+    reader.offset = 4;
+    uint16_t version = reader.u16();
+    int count = reader.u16();
+    inputWidth = reader.u16();
+    inputHeight = reader.u16();
+    float inputScale = reader.f32();
+    int32_t inputZeroPoint = reader.i32();
+    outputScale = reader.f32();
+    outputZeroPoint = reader.i32();
+    hazardClass = reader.u16();
+    reader.u16();
+    if (version != MODEL_VERSION || count == 0 || inputWidth == 0 || inputHeight == 0 || inputScale <= 0) {
+        Serial.printf("Hazard classifier: unsupported model (version %u)\n", version);
+        return false;
+    }
+
+    layers = (QuantizedLayer*)calloc(count, sizeof(QuantizedLayer));
+    if (!layers) return false;
+
+    // Walk the layers, checking that shapes chain and every array is in bounds
+    size_t largest = inputWidth * inputHeight;
+    size_t sumCount = 0;
+    int prevHeight = inputHeight, prevWidth = inputWidth, prevChannels = 1;
+    for (int i = 0; i < count; i++) {
+        if (!reader.has(LAYER_HEADER_SIZE)) return false;
+        QuantizedLayer& layer = layers[i];
+        layer.type = reader.u8();
+        layer.kernel = reader.u8();
+        layer.stride = reader.u8();
+        layer.samePadding = reader.u8();
+        layer.inputHeight = reader.u16();
+        layer.inputWidth = reader.u16();
+        layer.inputChannels = reader.u16();
+        layer.outputHeight = reader.u16();
+        layer.outputWidth = reader.u16();
+        layer.outputChannels = reader.u16();
+        layer.inputOffset = -reader.i32();
+        layer.outputOffset = reader.i32();
+        layer.activationMin = max(reader.i32(), (int32_t)-128);
+        layer.activationMax = min(reader.i32(), (int32_t)127);
+        uint32_t weightCount = reader.i32();
+
+        if (layer.inputHeight != prevHeight || layer.inputWidth != prevWidth ||
+            layer.inputChannels != prevChannels || layer.outputChannels == 0) {
+            Serial.printf("Hazard classifier: layer %d shape mismatch\n", i);
+            return false;
+        }
+
+        int k = layer.kernel;
+        uint32_t expected = 0;
+        bool valid = true;
+        switch (layer.type) {
+            case LAYER_CONV2D:
+            case LAYER_DEPTHWISE_CONV2D:
+                valid = k > 0 && layer.stride > 0 &&
+                        layer.outputHeight == expectedSize(layer.inputHeight, k, layer.stride, layer.samePadding) &&
+                        layer.outputWidth == expectedSize(layer.inputWidth, k, layer.stride, layer.samePadding);
+                if (layer.type == LAYER_CONV2D) {
+                    expected = layer.outputChannels * k * k * layer.inputChannels;
+                } else {
+                    valid = valid && layer.inputChannels == layer.outputChannels;
+                    expected = k * k * layer.outputChannels;
+                }
+                break;
+            case LAYER_AVERAGE_POOL:
+                valid = layer.outputHeight == 1 && layer.outputWidth == 1 &&
+                        layer.inputChannels == layer.outputChannels;
+                break;
+            case LAYER_FULLY_CONNECTED:
+                // Flattens whatever it is given
+                layer.inputChannels = layer.inputHeight * layer.inputWidth * layer.inputChannels;
+                layer.inputHeight = 1;
+                layer.inputWidth = 1;
+                valid = layer.outputHeight == 1 && layer.outputWidth == 1;
+                expected = layer.outputChannels * layer.inputChannels;
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid || weightCount != expected) {
+            Serial.printf("Hazard classifier: layer %d (type %d) is invalid\n", i, layer.type);
+            return false;
+        }
+
+        size_t padded = (weightCount + 3) & ~3u;
+        size_t arrays = 3 * layer.outputChannels * sizeof(int32_t);
+        if (!reader.has(padded + arrays)) return false;
+        layer.weights = (const int8_t*)(model + reader.offset);
+        reader.offset += padded;
+        layer.bias = (const int32_t*)(model + reader.offset);
+        layer.multiplier = layer.bias + layer.outputChannels;
+        layer.shift = layer.multiplier + layer.outputChannels;
+        reader.offset += arrays;
+
+        size_t outputSize = layer.outputHeight * layer.outputWidth * layer.outputChannels;
+        if (outputSize > largest) largest = outputSize;
+        if (layer.type != LAYER_AVERAGE_POOL) sumCount += layer.outputChannels;
+        prevHeight = layer.outputHeight;
+        prevWidth = layer.outputWidth;
+        prevChannels = layer.outputChannels;
+    }
+    if (prevHeight != 1 || prevWidth != 1 || hazardClass >= prevChannels) {
+        Serial.println("Hazard classifier: model does not end in class logits");
+        return false;
+    }
+    classCount = prevChannels;
+
+    // Zero-point folding for the fast kernels
+    weightSums = (int32_t*)malloc(max(sumCount, (size_t)1) * sizeof(int32_t));
+    arena[0] = (int8_t*)allocateLarge(largest);
+    arena[1] = (int8_t*)allocateLarge(largest);
+    if (!weightSums || !arena[0] || !arena[1]) {
+        Serial.println("Hazard classifier: failed to allocate buffers");
+        return false;
+    }
+    int32_t* sums = weightSums;
+    for (int i = 0; i < count; i++) {
+        if (layers[i].type == LAYER_AVERAGE_POOL) continue;
+        Int8Kernels::computeWeightSums(layers[i], sums);
+        layers[i].weightSums = sums;
+        sums += layers[i].outputChannels;
+    }
+
+    for (int v = 0; v < 256; v++) {
+        int q = (int)lroundf(v / 255.0f / inputScale) + inputZeroPoint;
+        inputTable[v] = (int8_t)constrain(q, -128, 127);
+    }
+
+    layerCount = count;
+    return true;
+}
+
+bool HazardClassifier::classify(const uint8_t* jpeg, size_t length, HazardPrediction* prediction) {
+    if (!isReady()) return false;
+
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(jpeg, length, &info)) {
+        return false;
+    }
+
+    // Coarsest DCT scale that still covers the model input
+    JpegScale scale = JPEG_SCALE_EIGHTH;
+    while (scale > JPEG_SCALE_FULL &&
+           (info.width / scale < inputWidth || info.height / scale < inputHeight)) {
+        scale = (JpegScale)(scale / 2);
+    }
+
+    unsigned long startTime = micros();
+    JpegPlane luma;
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, &luma, 1)) {
+        return false;
+    }
+    bool ok = classifyLuma(luma.data, luma.width, luma.height, luma.stride, prediction);
+    free(luma.data);
+    if (ok) {
+        // Count the decode as well
+        unsigned long elapsed = micros() - startTime;
+        stats.totalMicros += elapsed - prediction->micros;
+        stats.lastMicros = elapsed;
+        prediction->micros = elapsed;
+    }
+    return ok;
+}
+
+bool HazardClassifier::classifyLuma(const uint8_t* gray, int width, int height, int stride,
+                                    HazardPrediction* prediction, bool reference) {
+    if (!isReady() || width < inputWidth || height < inputHeight) return false;
+    unsigned long startTime = micros();
+
+    // Box-average down to the model input and quantize
+    int8_t* input = arena[0];
+    for (int y = 0; y < inputHeight; y++) {
+        int y0 = y * height / inputHeight;
+        int y1 = max(y0 + 1, (y + 1) * height / inputHeight);
+        for (int x = 0; x < inputWidth; x++) {
+            int x0 = x * width / inputWidth;
+            int x1 = max(x0 + 1, (x + 1) * width / inputWidth);
+            int sum = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                const uint8_t* row = gray + sy * stride;
+                for (int sx = x0; sx < x1; sx++) {
+                    sum += row[sx];
+                }
+            }
+            int count = (y1 - y0) * (x1 - x0);
+            input[y * inputWidth + x] = inputTable[(sum + count / 2) / count];
+        }
+    }
+
+    int current = 0;
+    for (int i = 0; i < layerCount; i++) {
+        if (reference) {
+            Int8Kernels::runReference(layers[i], arena[current], arena[current ^ 1]);
+        } else {
+            Int8Kernels::run(layers[i], arena[current], arena[current ^ 1]);
+        }
+        current ^= 1;
+    }
+
+    prediction->probability = outputProbability(arena[current]);
+    prediction->micros = micros() - startTime;
+    stats.frames++;
+    stats.totalMicros += prediction->micros;
+    stats.lastMicros = prediction->micros;
+    return true;
+}
+
+float HazardClassifier::outputProbability(const int8_t* logits) {
+    if (classCount == 1) {
+        float z = (logits[0] - outputZeroPoint) * outputScale;
+        return 1.0f / (1.0f + expf(-z));
+    }
+    float peak = -1e30f;
+    for (int c = 0; c < classCount; c++) {
+        peak = max(peak, (logits[c] - outputZeroPoint) * outputScale);
+    }
+    float total = 0;
+    float hazard = 0;
+    for (int c = 0; c < classCount; c++) {
+        float e = expf((logits[c] - outputZeroPoint) * outputScale - peak);
+        total += e;
+        if (c == hazardClass) hazard = e;
+    }
+    return hazard / total;
+}
+
+bool HazardClassifier::shouldSkipUpload(const HazardPrediction& prediction, bool* audit) {
+    *audit = false;
+    if (prediction.probability > HAZARD_CLEAR_THRESHOLD) return false;
+    if (++clearSinceAudit >= HAZARD_AUDIT_INTERVAL) {
+        clearSinceAudit = 0;
+        *audit = true;
+        return false;
+    }
+    stats.uploadsSkipped++;
+    return true;
+}
+
+bool HazardClassifier::shouldAlertEarly(const HazardPrediction& prediction) {
+    if (prediction.probability < HAZARD_ALERT_THRESHOLD) return false;
+    stats.earlyAlerts++;
+    return true;
+}
+
+void HazardClassifier::recordAudit(bool cloudHazard) {
+    stats.audits++;
+    if (cloudHazard) stats.auditMisses++;
+}
+
+void HazardClassifier::recordEarlyAlert(bool confirmed) {
+    if (confirmed) {
+        stats.earlyConfirmed++;
+    } else {
+        stats.earlyCancelled++;
+    }
+}
+
+HazardClassifierStats HazardClassifier::getStats() {
+    return stats;
+}
+
+void HazardClassifier::logStats() {
+    if (stats.frames == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.frames);
+    Serial.printf("Hazard classifier: %u frames, %u uploads skipped, audits %u (%u missed), early alerts %u (%u confirmed, %u cancelled), avg %lu us\n",
+                  stats.frames, stats.uploadsSkipped, stats.audits, stats.auditMisses,
+                  stats.earlyAlerts, stats.earlyConfirmed, stats.earlyCancelled, avgMicros);
+}
@@ -0,0 +1,90 @@
+#ifndef HAZARD_CLASSIFIER_H
+#define HAZARD_CLASSIFIER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+#include "int8_kernels.h"
+
+struct HazardPrediction {
+    float probability;        // 0..1, probability of the hazard class
+    unsigned long micros;     // Preprocess + inference time
+};
+
+struct HazardClassifierStats {
+    uint32_t frames;          // Frames classified
+    uint32_t uploadsSkipped;  // Confident clear frames not uploaded
+    uint32_t audits;          // Confident clear frames uploaded anyway
+    uint32_t auditMisses;     // ...where the cloud reported a hazard
+    uint32_t earlyAlerts;     // Alerts raised before the upload
+    uint32_t earlyConfirmed;  // ...confirmed by the cloud
+    uint32_t earlyCancelled;  // ...cancelled by the cloud
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// On-device int8 hazard / no-hazard classifier used as the first stage of hazard
+// detection. The model is a small quantized CNN over a downscaled luma frame,
+// loaded from HAZARD_MODEL_PATH on LittleFS. Without a model the classifier stays
+// inactive and every frame goes to the cloud as before.
+//
+// Model file, little-endian:
+//   header  "HZQ8", u16 version (1), u16 layerCount, u16 inputWidth, u16 inputHeight,
+//           f32 inputScale, i32 inputZeroPoint, f32 outputScale, i32 outputZeroPoint,
+//           u16 hazardClass, u16 reserved
+//   layer   u8 type, kernel, stride, samePadding, u16 input h/w/c, u16 output h/w/c,
+//           i32 inputZeroPoint, outputZeroPoint, activationMin, activationMax,
+//           u32 weightCount, i8 weights (padded to 4 bytes), i32 bias/multiplier/shift per output channel
+// The input is one luma channel scaled to 0..1. The last layer gives one logit per class.
+class HazardClassifier {
+private:
+    uint8_t* model;
+    QuantizedLayer* layers;
+    int32_t* weightSums;
+    int layerCount;
+    int8_t* arena[2];         // Ping-pong activations
+    uint16_t inputWidth;
+    uint16_t inputHeight;
+    int8_t inputTable[256];   // Luma to quantized input
+    float outputScale;
+    int32_t outputZeroPoint;
+    int classCount;
+    int hazardClass;
+    uint32_t clearSinceAudit;
+    HazardClassifierStats stats;
+
+    bool parseModel(size_t size);
+    float outputProbability(const int8_t* logits);
+
+public:
+    HazardClassifier();
+    ~HazardClassifier();
+
+    // Load HAZARD_MODEL_PATH from LittleFS
+    bool begin();
+    void end();
+    bool isReady();
+
+    // Use an in-memory model; takes ownership of a malloc() buffer
+    bool loadModel(uint8_t* data, size_t size);
+
+    // Classify a JPEG, or a luma plane of any size
+    bool classify(const uint8_t* jpeg, size_t length, HazardPrediction* prediction);
+    bool classifyLuma(const uint8_t* gray, int width, int height, int stride,
+                      HazardPrediction* prediction, bool reference = false);
+
+    // Upload decisions. Every HAZARD_AUDIT_INTERVAL-th confident clear frame is
+    // still uploaded (`audit` set) so that disagreement with the cloud shows up in the stats.
+    bool shouldSkipUpload(const HazardPrediction& prediction, bool* audit);
+    bool shouldAlertEarly(const HazardPrediction& prediction);
+    void recordAudit(bool cloudHazard);
+    void recordEarlyAlert(bool confirmed);
+
+    // Statistics
+    HazardClassifierStats getStats();
+    void logStats();
+};
+
+// Global hazard classifier instance
+extern HazardClassifier hazardClassifier;
+
+#endif // HAZARD_CLASSIFIER_H
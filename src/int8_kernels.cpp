@@ -0,0 +1,308 @@
+#include "int8_kernels.h"
+
+namespace {
+
+// Depthwise accumulators live on the stack
+const int MAX_DEPTHWISE_CHANNELS = 512;
+
+inline int32_t roundingDoublingHighMul(int32_t a, int32_t b) {
+    if (a == b && a == INT32_MIN) return INT32_MAX;
+    int64_t ab = (int64_t)a * b;
+    int32_t nudge = ab >= 0 ? (1 << 30) : (1 - (1 << 30));
+    return (int32_t)((ab + nudge) / (1LL << 31));
+}
+
+inline int32_t roundingDivideByPowerOfTwo(int32_t x, int exponent) {
+    int32_t mask = (int32_t)((1LL << exponent) - 1);
+    int32_t remainder = x & mask;
+    int32_t threshold = (mask >> 1) + (x < 0 ? 1 : 0);
+    return (x >> exponent) + (remainder > threshold ? 1 : 0);
+}
+
+inline int8_t storeOutput(const QuantizedLayer& layer, int32_t acc, int channel) {
+    acc += layer.bias[channel];
+    acc = Int8Kernels::multiplyByQuantizedMultiplier(acc, layer.multiplier[channel], layer.shift[channel]);
+    acc += layer.outputOffset;
+    if (acc < layer.activationMin) acc = layer.activationMin;
+    if (acc > layer.activationMax) acc = layer.activationMax;
+    return (int8_t)acc;
+}
+
+inline int32_t dot(const int8_t* x, const int8_t* w, int count) {
+    int32_t a0 = 0, a1 = 0, a2 = 0, a3 = 0;
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        a0 += x[i] * w[i];
+        a1 += x[i + 1] * w[i + 1];
+        a2 += x[i + 2] * w[i + 2];
+        a3 += x[i + 3] * w[i + 3];
+    }
+    for (; i < count; i++) {
+        a0 += x[i] * w[i];
+    }
+    return a0 + a1 + a2 + a3;
+}
+
+// One output pixel of a convolution with bounds checks (reference, and borders of the fast path)
+void convPixel(const QuantizedLayer& layer, const int8_t* input, int8_t* output, int oy, int ox) {
+    int k = layer.kernel;
+    int inC = layer.inputChannels;
+    int iy0 = oy * layer.stride - Int8Kernels::paddingTop(layer);
+    int ix0 = ox * layer.stride - Int8Kernels::paddingLeft(layer);
+    int8_t* out = output + (oy * layer.outputWidth + ox) * layer.outputChannels;
+
+    for (int oc = 0; oc < layer.outputChannels; oc++) {
+        int32_t acc = 0;
+        for (int ky = 0; ky < k; ky++) {
+            int iy = iy0 + ky;
+            if (iy < 0 || iy >= layer.inputHeight) continue;
+            for (int kx = 0; kx < k; kx++) {
+                int ix = ix0 + kx;
+                if (ix < 0 || ix >= layer.inputWidth) continue;
+                const int8_t* x = input + (iy * layer.inputWidth + ix) * inC;
+                const int8_t* w = layer.weights + ((oc * k + ky) * k + kx) * inC;
+                for (int ic = 0; ic < inC; ic++) {
+                    acc += (x[ic] + layer.inputOffset) * w[ic];
+                }
+            }
+        }
+        out[oc] = storeOutput(layer, acc, oc);
+    }
+}
+
+void depthwisePixel(const QuantizedLayer& layer, const int8_t* input, int8_t* output, int oy, int ox) {
+    int k = layer.kernel;
+    int channels = layer.outputChannels;
+    int iy0 = oy * layer.stride - Int8Kernels::paddingTop(layer);
+    int ix0 = ox * layer.stride - Int8Kernels::paddingLeft(layer);
+    int8_t* out = output + (oy * layer.outputWidth + ox) * channels;
+
+    for (int c = 0; c < channels; c++) {
+        int32_t acc = 0;
+        for (int ky = 0; ky < k; ky++) {
+            int iy = iy0 + ky;
+            if (iy < 0 || iy >= layer.inputHeight) continue;
+            for (int kx = 0; kx < k; kx++) {
+                int ix = ix0 + kx;
+                if (ix < 0 || ix >= layer.inputWidth) continue;
+                int8_t x = input[(iy * layer.inputWidth + ix) * channels + c];
+                acc += (x + layer.inputOffset) * layer.weights[(ky * k + kx) * channels + c];
+            }
+        }
+        out[c] = storeOutput(layer, acc, c);
+    }
+}
+
+// Output rows/columns whose window lies entirely inside the input
+inline void interiorRange(int padding, int stride, int kernel, int inputSize, int outputSize,
+                          int* first, int* last) {
+    *first = (padding + stride - 1) / stride;
+    int room = inputSize - kernel + padding;
+    *last = room < 0 ? 0 : room / stride + 1;
+    if (*last > outputSize) *last = outputSize;
+    if (*first > *last) *first = *last;
+}
+
+} // namespace
+
+int32_t Int8Kernels::multiplyByQuantizedMultiplier(int32_t x, int32_t multiplier, int32_t shift) {
+    int leftShift = shift > 0 ? shift : 0;
+    int rightShift = shift > 0 ? 0 : -shift;
+    return roundingDivideByPowerOfTwo(roundingDoublingHighMul(x * (1 << leftShift), multiplier), rightShift);
+}
+
+int Int8Kernels::paddingTop(const QuantizedLayer& layer) {
+    if (!layer.samePadding) return 0;
+    int total = (layer.outputHeight - 1) * layer.stride + layer.kernel - layer.inputHeight;
+    return total > 0 ? total / 2 : 0;
+}
+
+int Int8Kernels::paddingLeft(const QuantizedLayer& layer) {
+    if (!layer.samePadding) return 0;
+    int total = (layer.outputWidth - 1) * layer.stride + layer.kernel - layer.inputWidth;
+    return total > 0 ? total / 2 : 0;
+}
+
+void Int8Kernels::computeWeightSums(const QuantizedLayer& layer, int32_t* sums) {
+    int k = layer.kernel;
+    for (int oc = 0; oc < layer.outputChannels; oc++) {
+        int32_t sum = 0;
+        switch (layer.type) {
+            case LAYER_CONV2D:
+                for (int i = 0; i < k * k * layer.inputChannels; i++) {
+                    sum += layer.weights[oc * k * k * layer.inputChannels + i];
+                }
+                break;
+            case LAYER_DEPTHWISE_CONV2D:
+                for (int i = 0; i < k * k; i++) {
+                    sum += layer.weights[i * layer.outputChannels + oc];
+                }
+                break;
+            case LAYER_FULLY_CONNECTED:
+                for (int i = 0; i < layer.inputChannels; i++) {
+                    sum += layer.weights[oc * layer.inputChannels + i];
+                }
+                break;
+        }
+        sums[oc] = sum;
+    }
+}
+
+void Int8Kernels::run(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    switch (layer.type) {
+        case LAYER_CONV2D: conv2d(layer, input, output); break;
+        case LAYER_DEPTHWISE_CONV2D: depthwiseConv2d(layer, input, output); break;
+        case LAYER_AVERAGE_POOL: averagePool(layer, input, output); break;
+        case LAYER_FULLY_CONNECTED: fullyConnected(layer, input, output); break;
+    }
+}
+
+void Int8Kernels::runReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    switch (layer.type) {
+        case LAYER_CONV2D: conv2dReference(layer, input, output); break;
+        case LAYER_DEPTHWISE_CONV2D: depthwiseConv2dReference(layer, input, output); break;
+        case LAYER_AVERAGE_POOL: averagePool(layer, input, output); break;
+        case LAYER_FULLY_CONNECTED: fullyConnectedReference(layer, input, output); break;
+    }
+}
+
+void Int8Kernels::conv2dReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    for (int oy = 0; oy < layer.outputHeight; oy++) {
+        for (int ox = 0; ox < layer.outputWidth; ox++) {
+            convPixel(layer, input, output, oy, ox);
+        }
+    }
+}
+
+void Int8Kernels::conv2d(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    if (!layer.weightSums) {
+        conv2dReference(layer, input, output);
+        return;
+    }
+
+    int k = layer.kernel;
+    int inC = layer.inputChannels;
+    int outC = layer.outputChannels;
+    int top = paddingTop(layer);
+    int left = paddingLeft(layer);
+    int span = k * inC;            // One window row is contiguous in NHWC
+    int firstY, lastY, firstX, lastX;
+    interiorRange(top, layer.stride, k, layer.inputHeight, layer.outputHeight, &firstY, &lastY);
+    interiorRange(left, layer.stride, k, layer.inputWidth, layer.outputWidth, &firstX, &lastX);
+
+    for (int oy = 0; oy < layer.outputHeight; oy++) {
+        bool interiorRow = oy >= firstY && oy < lastY;
+        for (int ox = 0; ox < layer.outputWidth; ox++) {
+            if (!interiorRow || ox < firstX || ox >= lastX) {
+                convPixel(layer, input, output, oy, ox);
+                continue;
+            }
+            // Whole window inside: sum((x + offset) * w) = sum(x * w) + offset * sum(w)
+            const int8_t* window = input + ((oy * layer.stride - top) * layer.inputWidth +
+                                            ox * layer.stride - left) * inC;
+            int8_t* out = output + (oy * layer.outputWidth + ox) * outC;
+            const int8_t* w = layer.weights;
+            for (int oc = 0; oc < outC; oc++) {
+                int32_t acc = layer.inputOffset * layer.weightSums[oc];
+                const int8_t* x = window;
+                for (int ky = 0; ky < k; ky++) {
+                    acc += dot(x, w, span);
+                    x += layer.inputWidth * inC;
+                    w += span;
+                }
+                out[oc] = storeOutput(layer, acc, oc);
+            }
+        }
+    }
+}
+
+void Int8Kernels::depthwiseConv2dReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    for (int oy = 0; oy < layer.outputHeight; oy++) {
+        for (int ox = 0; ox < layer.outputWidth; ox++) {
+            depthwisePixel(layer, input, output, oy, ox);
+        }
+    }
+}
+
+void Int8Kernels::depthwiseConv2d(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    int channels = layer.outputChannels;
+    if (!layer.weightSums || channels > MAX_DEPTHWISE_CHANNELS) {
+        depthwiseConv2dReference(layer, input, output);
+        return;
+    }
+
+    int k = layer.kernel;
+    int top = paddingTop(layer);
+    int left = paddingLeft(layer);
+    int firstY, lastY, firstX, lastX;
+    interiorRange(top, layer.stride, k, layer.inputHeight, layer.outputHeight, &firstY, &lastY);
+    interiorRange(left, layer.stride, k, layer.inputWidth, layer.outputWidth, &firstX, &lastX);
+
+    int32_t acc[MAX_DEPTHWISE_CHANNELS];
+    for (int oy = 0; oy < layer.outputHeight; oy++) {
+        bool interiorRow = oy >= firstY && oy < lastY;
+        for (int ox = 0; ox < layer.outputWidth; ox++) {
+            if (!interiorRow || ox < firstX || ox >= lastX) {
+                depthwisePixel(layer, input, output, oy, ox);
+                continue;
+            }
+            for (int c = 0; c < channels; c++) {
+                acc[c] = layer.inputOffset * layer.weightSums[c];
+            }
+            // Channels innermost: each tap is a contiguous multiply-accumulate over all channels
+            int iy0 = oy * layer.stride - top;
+            int ix0 = ox * layer.stride - left;
+            const int8_t* w = layer.weights;
+            for (int ky = 0; ky < k; ky++) {
+                const int8_t* x = input + ((iy0 + ky) * layer.inputWidth + ix0) * channels;
+                for (int kx = 0; kx < k; kx++) {
+                    for (int c = 0; c < channels; c++) {
+                        acc[c] += x[c] * w[c];
+                    }
+                    x += channels;
+                    w += channels;
+                }
+            }
+            int8_t* out = output + (oy * layer.outputWidth + ox) * channels;
+            for (int c = 0; c < channels; c++) {
+                out[c] = storeOutput(layer, acc[c], c);
+            }
+        }
+    }
+}
+
+void Int8Kernels::averagePool(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    // The 1/(height*width) factor is folded into the multiplier by the exporter
+    int channels = layer.inputChannels;
+    int pixels = layer.inputHeight * layer.inputWidth;
+    for (int c = 0; c < channels; c++) {
+        int32_t acc = 0;
+        for (int p = 0; p < pixels; p++) {
+            acc += input[p * channels + c] + layer.inputOffset;
+        }
+        output[c] = storeOutput(layer, acc, c);
+    }
+}
+
+void Int8Kernels::fullyConnectedReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    for (int oc = 0; oc < layer.outputChannels; oc++) {
+        const int8_t* w = layer.weights + oc * layer.inputChannels;
+        int32_t acc = 0;
+        for (int i = 0; i < layer.inputChannels; i++) {
+            acc += (input[i] + layer.inputOffset) * w[i];
+        }
+        output[oc] = storeOutput(layer, acc, oc);
+    }
+}
+
+void Int8Kernels::fullyConnected(const QuantizedLayer& layer, const int8_t* input, int8_t* output) {
+    if (!layer.weightSums) {
+        fullyConnectedReference(layer, input, output);
+        return;
+    }
+    for (int oc = 0; oc < layer.outputChannels; oc++) {
+        int32_t acc = layer.inputOffset * layer.weightSums[oc] +
+                      dot(input, layer.weights + oc * layer.inputChannels, layer.inputChannels);
+        output[oc] = storeOutput(layer, acc, oc);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef INT8_KERNELS_H
+#define INT8_KERNELS_H
+
+#include <Arduino.h>
+
+// Layer types of a quantized model
+enum QuantizedLayerType {
+    LAYER_CONV2D = 1,             // Weights [out][k][k][in]
+    LAYER_DEPTHWISE_CONV2D = 2,   // Weights [k][k][channels], depth multiplier 1
+    LAYER_AVERAGE_POOL = 3,       // Global average over height and width
+    LAYER_FULLY_CONNECTED = 4     // Weights [out][in]
+};
+
+// One int8 layer (NHWC, batch 1). Quantization follows the usual TFLite scheme:
+// real = scale * (q - zeroPoint), per-output-channel weight scales folded into a
+// Q31 multiplier and power-of-two shift, zero-point weights.
+struct QuantizedLayer {
+    uint8_t type;
+    uint8_t kernel;
+    uint8_t stride;
+    uint8_t samePadding;          // 1: output = ceil(input / stride), 0: valid
+    uint16_t inputHeight;
+    uint16_t inputWidth;
+    uint16_t inputChannels;
+    uint16_t outputHeight;
+    uint16_t outputWidth;
+    uint16_t outputChannels;
+    int32_t inputOffset;          // -input zero point
+    int32_t outputOffset;         // Output zero point
+    int32_t activationMin;        // Fused ReLU / ReLU6 clamp in the output domain
+    int32_t activationMax;
+    const int8_t* weights;
+    const int32_t* bias;          // Per output channel
+    const int32_t* multiplier;    // Per output channel
+    const int32_t* shift;         // Per output channel, > 0 shifts left
+    const int32_t* weightSums;    // Per output channel sum of weights (fast kernels only)
+};
+
+// Inference kernels for int8 models. The reference versions are straight loops
+// over the definition; the others fold the input zero point into precomputed
+// weight sums, keep the inner loops free of bounds checks and unroll them, and
+// must give bit-identical results.
+class Int8Kernels {
+public:
+    // Requantize an int32 accumulator: x * multiplier * 2^shift with rounding
+    static int32_t multiplyByQuantizedMultiplier(int32_t x, int32_t multiplier, int32_t shift);
+
+    // Padding before the first row/column for a layer
+    static int paddingTop(const QuantizedLayer& layer);
+    static int paddingLeft(const QuantizedLayer& layer);
+
+    // Sums of weights per output channel, for QuantizedLayer::weightSums
+    static void computeWeightSums(const QuantizedLayer& layer, int32_t* sums);
+
+    // Run one layer of any type
+    static void run(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void runReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+
+    static void conv2d(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void conv2dReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void depthwiseConv2d(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void depthwiseConv2dReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void averagePool(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void fullyConnected(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+    static void fullyConnectedReference(const QuantizedLayer& layer, const int8_t* input, int8_t* output);
+};
+
+#endif // INT8_KERNELS_H
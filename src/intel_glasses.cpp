@@ -29,6 +29,17 @@ bool IntelGlasses::initialize() {
     Serial.println("Intel AI Glasses v1.0");
     Serial.println("Hazard Detection | Visual Caption | Sign Recognition | OCR");
     
+    // Tones, haptics and LEDs play from their own task, so nothing below waits on them
+    if (!feedbackEngine.begin()) {
+        Serial.println("Feedback engine unavailable - no tones or haptics");
+    }
+    
+    // Request and admission locks, shared by the main loop and the pipeline upload stage
+    if (!aiProcessor.begin()) {
+        handleSystemError("AI processor initialization failed");
+        return false;
+    }
+    
     // Initialize all subsystems
     if (!initializeSubsystems()) {
         handleSystemError("Subsystem initialization failed");
@@ -48,6 +59,21 @@ bool IntelGlasses::initialize() {
         return false;
     }
     
+    // Start the capture/encode/upload pipeline once the camera and network are verified
+    if (ENABLE_CAPTURE_PIPELINE && !capturePipeline.begin()) {
+        Serial.println("Capture pipeline unavailable - using sequential processing");
+    }
+    
+    // Local collision warnings run alongside everything else, without the network
+    if (ENABLE_LOOMING_DETECTION && !loomingDetector.begin()) {
+        Serial.println("Collision warning unavailable");
+    }
+    
+    // Optional local hazard model; hazard detection stays cloud-only without it
+    if (ENABLE_HAZARD_CLASSIFIER) {
+        hazardClassifier.begin();
+    }
+    
     setState(STATE_READY);
     systemReady = true;
     
@@ -95,6 +121,11 @@ void IntelGlasses::run() {
         processAutoCapture();
     }
     
+    // Frames queued by admission control, once their class has a token
+    if (currentState == STATE_READY && aiProcessor.hasQueuedRequest()) {
+        processQueuedCapture();
+    }
+    
     // Periodic status updates
     unsigned long currentTime = millis();
     if (currentTime - lastStatusUpdate >= 10000) { // Every 10 seconds
@@ -106,6 +137,7 @@ void IntelGlasses::run() {
     if (currentTime - lastHeartbeat >= 30000) { // Every 30 seconds
         Serial.println("Heartbeat - System operational");
         checkSystemHealth();
+        logPerformanceMetrics();
         lastHeartbeat = currentTime;
     }
     
@@ -148,7 +180,11 @@ void IntelGlasses::processManualCapture() {
         return;
     }
     
-    captureAndProcess();
+    // A manual capture in auto mode asks for a description as well
+    if (aiProcessor.getOperationMode() == MODE_AUTO_ALL) {
+        taskScheduler.request(MODE_VISUAL_CAPTION);
+    }
+    captureAndProcess(PRIORITY_MANUAL);
 }
 
 void IntelGlasses::processAutoCapture() {
@@ -157,12 +193,29 @@ void IntelGlasses::processAutoCapture() {
     }
 }
 
-void IntelGlasses::captureAndProcess() {
+void IntelGlasses::captureAndProcess(RequestPriority priority) {
     if (currentState != STATE_READY) {
         Serial.println("System not ready for capture");
         return;
     }
     
+    // Codes and colours are read on the device, with nothing to upload
+    OperationMode mode = aiProcessor.getOperationMode();
+    if (mode == MODE_BARCODE || mode == MODE_COLOUR) {
+        processLocalCapture(mode);
+        return;
+    }
+    
+    // With the pipeline running, capture is queued and results are handled by its upload stage
+    if (capturePipeline.isActive()) {
+        if (capturePipeline.requestCapture(priority)) {
+            displayHandler.showProcessing("Capturing...");
+        } else {
+            Serial.println("Failed to queue capture request");
+        }
+        return;
+    }
+    
     setState(STATE_PROCESSING);
     displayHandler.showProcessing("Capturing...");
     
@@ -180,10 +233,26 @@ void IntelGlasses::captureAndProcess() {
     }
     
     Serial.printf("Image captured: %d bytes\n", imageSize);
+    FramePyramid* pyramid = cameraManager.acquireCapturedPyramid();
+    if (aiProcessor.uploadsFrame(mode, pyramid != nullptr)) {
+        gsmModule.optimizeImageForUpload(&imageData, &imageSize);
+    }
     displayHandler.showProcessing("Processing with AI...");
     
     // Process with AI
-    bool success = aiProcessor.processImage(imageData, imageSize);
+    bool success = aiProcessor.processImage(imageData, imageSize, pyramid, priority);
+    cameraManager.releasePyramid(pyramid);
+    
+    // Queued and rejected frames are neither a success nor a failure
+    if (!success && aiProcessor.getLastAdmission() != ADMISSION_ADMITTED) {
+        bool queued = aiProcessor.getLastAdmission() == ADMISSION_QUEUED;
+        displayHandler.showProcessing(queued ? "Queued..." : "Busy, try again");
+        if (imageData) {
+            free(imageData);
+        }
+        setState(STATE_READY);
+        return;
+    }
     
     // Update metrics
     totalProcessedImages++;
@@ -208,6 +277,51 @@ void IntelGlasses::captureAndProcess() {
                   success ? "YES" : "NO", millis() - processingStart);
 }
 
+void IntelGlasses::processQueuedCapture() {
+    setState(STATE_PROCESSING);
+    displayHandler.showProcessing("Processing with AI...");
+    
+    // Service time only; the queue wait is reported by the admission controller
+    unsigned long processingStart = millis();
+    bool success = aiProcessor.processQueued();
+    
+    totalProcessedImages++;
+    if (success) {
+        successfulProcessing++;
+        unsigned long processingTime = millis() - processingStart;
+        averageProcessingTime = (averageProcessingTime * (successfulProcessing - 1) + processingTime) / successfulProcessing;
+        
+        displayHandler.showResult("Analysis complete", 3000);
+    } else {
+        displayHandler.showError("Analysis failed", 2000);
+    }
+    
+    setState(STATE_READY);
+    Serial.printf("Queued processing complete. Success: %s, Time: %lu ms\n",
+                  success ? "YES" : "NO", millis() - processingStart);
+}
+
+void IntelGlasses::processLocalCapture(OperationMode mode) {
+    setState(STATE_PROCESSING);
+    displayHandler.showProcessing("Scanning...");
+    
+    unsigned long processingStart = millis();
+    bool manual = !autoCaptureMode;
+    bool success = mode == MODE_COLOUR ? aiProcessor.scanColour(manual) : aiProcessor.scanBarcode(manual);
+    
+    totalProcessedImages++;
+    if (success) {
+        successfulProcessing++;
+        unsigned long processingTime = millis() - processingStart;
+        averageProcessingTime = (averageProcessingTime * (successfulProcessing - 1) + processingTime) / successfulProcessing;
+    } else {
+        displayHandler.showError("Capture failed", 2000);
+    }
+    
+    setState(STATE_READY);
+    Serial.printf("Local scan complete. Time: %lu ms\n", millis() - processingStart);
+}
+
 void IntelGlasses::handleModeChange() {
     aiProcessor.cycleMode();
     displayHandler.updateOperationMode(aiProcessor.getOperationMode());
@@ -232,6 +346,12 @@ void IntelGlasses::handleModeChange() {
         case OP_MODE_OCR:
             audioManager.playSystemAudio("ocr_mode");
             break;
+        case OP_MODE_BARCODE:
+            audioManager.playSystemAudio("barcode_mode");
+            break;
+        case OP_MODE_COLOUR:
+            audioManager.playSystemAudio("colour_mode");
+            break;
     }
 }
 
@@ -258,6 +378,12 @@ void IntelGlasses::handleSpeechModeChange(OperationMode newMode) {
         case OP_MODE_OCR:
             audioManager.playSystemAudio("ocr_mode");
             break;
+        case OP_MODE_BARCODE:
+            audioManager.playSystemAudio("barcode_mode");
+            break;
+        case OP_MODE_COLOUR:
+            audioManager.playSystemAudio("colour_mode");
+            break;
     }
 }
 
@@ -340,13 +466,8 @@ void IntelGlasses::toggleAutoCaptureMode() {
 void IntelGlasses::emergencyAlert() {
     Serial.println("EMERGENCY ALERT ACTIVATED!");
     
-    // Flash hazard LED
-    for (int i = 0; i < 10; i++) {
-        aiProcessor.updateStatusLEDs(false, true, false);
-        delay(100);
-        aiProcessor.updateStatusLEDs(false, false, false);
-        delay(100);
-    }
+    // Flash hazard LED, alongside the vibration
+    feedbackEngine.play(FEEDBACK_EMERGENCY_FLASH);
     
     // Provide strong feedback
     aiProcessor.provideAudioFeedback("Emergency alert activated", true);
@@ -363,6 +484,7 @@ void IntelGlasses::calibrateSystem() {
     
     // Calibrate camera settings
     cameraManager.setupDefaultSettings();
+    cameraManager.applyCaptureProfile(aiProcessor.getOperationMode());
     
     // Test network connection
     if (!gsmModule.isNetworkConnected()) {
@@ -437,6 +559,34 @@ String IntelGlasses::getSystemInfo() {
     return info;
 }
 
+void IntelGlasses::logPerformanceMetrics() {
+    Serial.println("=== Performance Metrics ===");
+    Serial.printf("Sequential captures: %d (%d successful), avg time: %.0f ms\n",
+                  totalProcessedImages, successfulProcessing, averageProcessingTime);
+    cameraManager.logProfileStats();
+    gsmModule.logUploadStats();
+    ocrPreprocessor.logStats();
+    textDetector.logStats();
+    signPrefilter.logStats();
+    loomingDetector.logStats();
+    hazardClassifier.logStats();
+    barcodeDecoder.logStats();
+    colourIdentifier.logStats();
+    aiProcessor.logCascadeStats();
+    responseDecoder.logStats();
+    alertTracker.logStats();
+    objectTracker.logStats();
+    taskScheduler.logStats();
+    admissionController.logStats();
+    feedbackEngine.logStats();
+    audioManager.logStats();
+    audioOutput.logStats();
+    clipCache.logStats();
+    if (capturePipeline.isActive()) {
+        capturePipeline.logStats();
+    }
+}
+
 bool IntelGlasses::initializeSubsystems() {
     Serial.println("Initializing subsystems...");
     
@@ -446,6 +596,9 @@ bool IntelGlasses::initializeSubsystems() {
     // Initialize display
     if (!initializeDisplay()) return false;
     
+    // Initialize audio output; without it clips are skipped, haptics still work
+    initializeAudio();
+    
     // Initialize speech recognition
     if (!initializeSpeechRecognition()) return false;
     
@@ -479,10 +632,20 @@ bool IntelGlasses::initializeCamera() {
         Serial.println("Camera initialization failed");
         return false;
     }
+    cameraManager.applyCaptureProfile(aiProcessor.getOperationMode());
     delay(500);
     return true;
 }
 
+bool IntelGlasses::initializeAudio() {
+    displayHandler.showProcessing("Init Audio...");
+    if (!audioManager.initialize()) {
+        Serial.println("Audio initialization failed, continuing without speech output");
+        return false;
+    }
+    return true;
+}
+
 bool IntelGlasses::initializeSpeechRecognition() {
     displayHandler.showProcessing("Init Speech...");
     
@@ -634,6 +797,7 @@ void IntelGlasses::enterSleepMode() {
     displayHandler.turnOff();
     aiProcessor.updateStatusLEDs(false, false, false);
     cameraManager.enableAutoCaptureMode(false);
+    loomingDetector.end();
     
     // TODO: Implement deep sleep mode
 }
@@ -645,6 +809,9 @@ void IntelGlasses::exitSleepMode() {
     // Re-enable systems
     displayHandler.showStatus();
     cameraManager.enableAutoCaptureMode(autoCaptureMode);
+    if (ENABLE_LOOMING_DETECTION) {
+        loomingDetector.begin();
+    }
 }
 
 void IntelGlasses::shutdown() {
@@ -657,10 +824,14 @@ void IntelGlasses::shutdown() {
     displayHandler.showProcessing("Shutting down...");
     delay(1000);
     
+    capturePipeline.end();
+    loomingDetector.end();
     cameraManager.deinitialize();
     gsmModule.disconnect();
     displayHandler.turnOff();
     aiProcessor.updateStatusLEDs(false, false, false);
+    audioManager.deinitialize();
+    feedbackEngine.end();
     
     Serial.println("Shutdown complete");
 }
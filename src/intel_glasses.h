@@ -9,6 +9,16 @@
 #include "input_handler.h"
 #include "display_handler.h"
 #include "speech_recognition.h"
+#include "capture_pipeline.h"
+#include "ocr_preprocessor.h"
+#include "text_detector.h"
+#include "sign_prefilter.h"
+#include "looming_detector.h"
+#include "hazard_classifier.h"
+#include "barcode_decoder.h"
+#include "colour_identifier.h"
+#include "response_decoder.h"
+#include "clip_cache.h"
 
 // System states
 enum SystemState {
@@ -59,7 +69,9 @@ public:
     bool isSystemReady();
     
     // Operation control
-    void captureAndProcess();
+    void captureAndProcess(RequestPriority priority = PRIORITY_AUTO);
+    void processQueuedCapture();
+    void processLocalCapture(OperationMode mode);
     void processManualCapture();
     void processAutoCapture();
     void processSpeechCommand(const SpeechResult& result);
@@ -98,6 +110,7 @@ private:
     bool initializeDisplay();
     bool initializeInput();
     bool initializeSpeechRecognition();
+    bool initializeAudio();
     bool testAllSystems();
     
     // Recovery procedures
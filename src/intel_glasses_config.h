@@ -37,6 +37,222 @@
 #define IMAGE_WIDTH           640
 #define IMAGE_HEIGHT          480
 
+// ===================
+// Capture Pipeline Configuration
+// ===================
+#define ENABLE_CAPTURE_PIPELINE   true   // Overlap capture/encode with upload across both cores
+#define PIPELINE_QUEUE_DEPTH      1      // Frames buffered between stages (older frames are dropped)
+#define PIPELINE_CAPTURE_CORE     0
+#define PIPELINE_ENCODE_CORE      0
+#define PIPELINE_UPLOAD_CORE      1
+#define PYRAMID_MAX_LIVE          (3 + ADMISSION_QUEUE_DEPTH) // Resolution pyramids held at once (one per pipeline stage and queued request)
+
+// ===================
+// Upload Optimization
+// ===================
+#define ENABLE_JPEG_OPTIMIZATION   true    // Re-code uploads with optimal Huffman tables (lossless)
+#define JPEG_OPTIMIZE_TIME_BUDGET  150     // CPU time allowed per image (ms)
+#define JPEG_OPTIMIZE_FAST_LINK    100000  // Skip re-coding above this uplink rate (bytes/s)
+
+// ===================
+// OCR Pre-processing
+// ===================
+#define ENABLE_OCR_BILEVEL       true    // Upload OCR frames as deskewed 1-bit CCITT G4 TIFF
+#define OCR_THRESHOLD_RADIUS     15      // Half-size of the local threshold window (pixels)
+#define OCR_THRESHOLD_K          0.34    // Sauvola sensitivity to local contrast
+#define OCR_MIN_CONTRAST         10      // Local standard deviation below this is background
+#define OCR_MAX_SKEW_DEGREES     8.0
+#define OCR_MIN_DESKEW_DEGREES   0.5     // Smaller skews are left alone
+
+// ===================
+// Text Detection
+// ===================
+#define ENABLE_TEXT_GATING       true    // Auto mode: skip OCR uploads without text, send only text crops
+#define TEXT_DETECT_WIDTH        640     // Minimum luma width of the finest detector level (pixels)
+#define TEXT_DETECT_LEVELS       3       // Octaves scanned, each half the previous resolution
+#define TEXT_EDGE_THRESHOLD      24      // Minimum gradient of a stroke edge
+#define TEXT_MAX_STROKE          6       // Widest stroke at detector resolution (pixels)
+#define TEXT_CELL_MIN_PAIRS      6       // Stroke pairs that make an 8x8 cell a text candidate
+#define TEXT_MIN_CELLS           3       // Smallest text cluster (cells)
+#define TEXT_MIN_STROKE_VARIATION 0.2    // Stroke width std/mean below this is a regular pattern
+#define TEXT_MAX_VERTICAL_RATIO  1.0     // Horizontal-stroke to vertical-stroke ratio above this is texture
+#define TEXT_MAX_BOXES           8
+#define TEXT_CROP_MARGIN         32      // Margin added around text boxes before cropping (pixels)
+
+// ===================
+// Sign Prefilter
+// ===================
+#define ENABLE_SIGN_PREFILTER    true    // Auto mode: skip sign uploads without sign colours, send only region crops
+#define SIGN_DETECT_WIDTH        320     // Minimum chroma width the prefilter works at (pixels)
+#define SIGN_MIN_LUMA            40      // Darker pixels have unreliable chroma
+#define SIGN_RED_MIN_CR          172     // YCbCr (JFIF) colour thresholds
+#define SIGN_RED_MIN_CB          64
+#define SIGN_RED_MAX_CB          150
+#define SIGN_YELLOW_MIN_CR       136
+#define SIGN_YELLOW_MAX_CB       96
+#define SIGN_YELLOW_MIN_LUMA     100
+#define SIGN_BLUE_MIN_CB         156
+#define SIGN_BLUE_MAX_CR         120
+#define SIGN_MIN_AREA            12      // Smallest blob at prefilter resolution (pixels)
+#define SIGN_MAX_AREA_FRACTION   0.25    // Larger blobs are walls, sky or vehicles
+#define SIGN_MIN_FILL            0.25    // Blob / bounding box; rings of prohibition signs are ~0.3
+#define SIGN_MAX_ASPECT          3.0
+#define SIGN_MAX_REGIONS         8
+#define SIGN_CROP_MARGIN         16      // Margin added around regions before cropping (pixels)
+
+// ===================
+// Collision Warning
+// ===================
+#define ENABLE_LOOMING_DETECTION  true   // Local time-to-collision alerts, independent of the network
+#define LOOMING_TARGET_FPS        10     // Analysis rate goal on the ESP32-S3
+#define LOOMING_WIDTH             80     // Working luma resolution (pixels)
+#define LOOMING_HEIGHT            60
+#define LOOMING_GRID_COLS         4      // Regions with their own expansion rate
+#define LOOMING_GRID_ROWS         3
+#define LOOMING_IGNORE_BOTTOM_ROWS 1     // Ground rows expand whenever walking
+#define LOOMING_MIN_TEXTURE       4.0    // Radial gradient energy needed for an estimate
+#define LOOMING_ALERT_TTC         2.0    // Alert below this time to collision (s)
+#define LOOMING_CONFIRM_FRAMES    2      // Consecutive frames under the threshold
+#define LOOMING_ALERT_COOLDOWN    3000   // Minimum time between alerts (ms)
+#define LOOMING_MAX_FRAME_GAP     500    // Longer gaps restart the estimate (ms)
+#define LOOMING_TASK_CORE         0
+#define LOOMING_TASK_PRIORITY     3
+// Capture profiles it runs under: walking modes, not close-up reading or scanning,
+// where the target is brought to the camera on purpose
+#define LOOMING_MODES             ((1 << MODE_HAZARD_DETECTION) | (1 << MODE_VISUAL_CAPTION) | \
+                                   (1 << MODE_SIGN_DETECTION) | (1 << MODE_AUTO_ALL))
+
+// ===================
+// Hazard Classifier
+// ===================
+#define ENABLE_HAZARD_CLASSIFIER  true   // Local int8 first stage for hazard detection
+#define HAZARD_MODEL_PATH         "/hazard_model.bin"   // On LittleFS
+#define HAZARD_MAX_MODEL_SIZE     (512 * 1024)
+#define HAZARD_CLEAR_THRESHOLD    0.10   // At or below: frame is clear, skip the upload
+#define HAZARD_ALERT_THRESHOLD    0.85   // At or above: alert before the upload confirms
+#define HAZARD_AUDIT_INTERVAL     10     // Upload every Nth clear frame anyway
+
+// ===================
+// Barcode Scanning
+// ===================
+#define BARCODE_MAX_TEXT          512    // Longest payload kept (bytes)
+#define BARCODE_THRESHOLD_WINDOW  8      // Local mean window = image width / this
+#define BARCODE_THRESHOLD_OFFSET  8      // Dark when this far below the local mean
+#define BARCODE_MAX_FINDERS       8      // QR finder candidates combined into triples
+#define BARCODE_LINEAR_ROWS       32     // Scanlines tried for EAN/UPC
+#define BARCODE_LINEAR_VOTES      2      // Scanlines that must agree on an EAN/UPC code
+#define BARCODE_REPEAT_INTERVAL   5000   // Same code is not announced again within this (ms)
+#define BARCODE_SPEAK_MAX         24     // Payload letters and digits read out; longer codes end in "and more"
+
+// ===================
+// Colour Identification
+// ===================
+#define COLOUR_ROI_FRACTION       0.30   // Centre square sampled, as a fraction of the frame height
+#define COLOUR_SAMPLE_GRID        16     // Samples per side of the square (16 x 16)
+#define COLOUR_CLUSTERS           4      // k-means clusters over the samples
+#define COLOUR_ITERATIONS         8      // k-means iterations
+#define COLOUR_MIN_SHARE          0.20   // Smaller clusters are not named (fraction of samples)
+#define COLOUR_MAX_NAMES          2      // Colours announced per capture
+#define COLOUR_REPEAT_INTERVAL    5000   // Same colours are not announced again within this (ms)
+
+// ===================
+// Cascaded Requests
+// ===================
+#define ENABLE_CASCADES           true   // Text or signs in a response trigger a follow-up on a crop of the same frame
+#define CASCADE_TEXT              1      // Follow-up kinds, combined in the rules below
+#define CASCADE_SIGN              2
+#define CASCADE_FROM_HAZARD       (CASCADE_TEXT | CASCADE_SIGN)  // Follow-ups a hazard response may trigger
+#define CASCADE_FROM_CAPTION      (CASCADE_TEXT | CASCADE_SIGN)  // Follow-ups a caption response may trigger
+#define CASCADE_FROM_SIGN         CASCADE_TEXT                   // Follow-ups a sign response may trigger
+#define CASCADE_MAX_DEPTH         2      // Follow-up requests chained from one capture
+#define CASCADE_CROP_MARGIN       0.05   // Margin added around a reported box (fraction of the frame)
+#define API_MAX_REGIONS           4      // Regions kept from one response
+
+// ===================
+// Structured Responses
+// ===================
+#define ENABLE_STRUCTURED_RESPONSES true  // Ask for CBOR results; JSON stays the fallback
+#define STRUCTURED_RESPONSE_VERSION 1    // Schema version requested and accepted
+#define STRUCTURED_MAX_TEXT       320    // Longest result text kept (bytes, including the terminator)
+#define STRUCTURED_MAX_ERROR      64
+#define STRUCTURED_MAX_URL        160
+#define STRUCTURED_MAX_DEPTH      8      // Nesting skipped in unknown fields
+#define STRUCTURED_TASKS          4      // Per-task confidences: hazard, caption, sign, OCR
+#define REGION_HAZARD             4      // Region kind of a hazard box, beside CASCADE_TEXT and CASCADE_SIGN
+
+// ===================
+// Inline Audio
+// ===================
+#define ENABLE_INLINE_AUDIO       true   // Ask for speech in the API response instead of an audio_url to fetch
+#define INLINE_AUDIO_FORMAT       "mp3"  // Format advertised in requests
+#define INLINE_AUDIO_MAX_BYTES    65536  // Longest clip read out of a chunked response (PSRAM); longer ones are dropped
+
+// ===================
+// Alert Tracking
+// ===================
+#define ENABLE_ALERT_TRACKING     true   // Announce a hazard or sign once, not on every capture
+#define ALERT_MAX_TRACKS          8      // Detections remembered at once
+#define ALERT_FIRE_SCORE          0.7    // Accumulated confidence needed to announce
+#define ALERT_SCORE_DECAY         0.5    // Weight of earlier sightings in the score
+#define ALERT_HIGH_CONFIDENCE     0.7    // As AIProcessor::isHighConfidence()
+#define ALERT_CLEAR_FRAMES        2      // Frames without a detection before it is forgotten
+#define ALERT_TRACK_TIMEOUT       20000  // Forgotten when not seen for this long (ms)
+#define ALERT_POSITION_TOLERANCE  0.2    // Horizontal offset still the same detection (fraction of the frame)
+#define ALERT_ESCALATE_RATIO      0.7    // Announce again when this much closer than last announced
+#define ALERT_ESCALATE_COOLDOWN   2000   // Minimum time between announcements of one detection (ms)
+#define ALERT_REMINDER_INTERVAL   0      // Repeat unchanged alerts after this long (ms), 0 = never
+
+// ===================
+// Object Tracking
+// ===================
+#define ENABLE_OBJECT_TRACKING    true   // Follow boxes reported by the cloud across frames
+#define OBJECT_MAX_TRACKS         16
+#define OBJECT_MIN_IOU            0.2    // Overlap with the predicted box that makes a match
+#define OBJECT_MAX_CENTROID_DISTANCE 0.15  // Without overlap, centres this close still match (fraction of the frame)
+#define OBJECT_MAX_MISSES         2      // Updates without a box before the track is dropped
+#define OBJECT_MIN_HITS           2      // Sightings before motion estimates are used
+#define OBJECT_POSITION_NOISE     0.02   // Box centre measurement error (fraction of the frame)
+#define OBJECT_SCALE_NOISE        0.1    // Log box side measurement error
+#define OBJECT_PROCESS_NOISE      0.01   // Acceleration noise of the motion model
+#define OBJECT_INITIAL_VELOCITY   0.1    // Velocity uncertainty of a new track (per second)
+#define OBJECT_APPROACH_TTC       8.0    // Announce hazards closer than this in time (s)
+#define OBJECT_REQUERY_GROWTH     1.5    // Re-read text or sign once its box side grew by this factor
+
+// ===================
+// Auto Mode Scheduling
+// ===================
+#define ENABLE_TASK_SCHEDULER     true   // Run caption, sign and OCR only when triggered, within a frame budget
+#define SCHED_TASKS               4      // Hazard, caption, sign, OCR (OperationMode order)
+#define SCHED_FRAME_BUDGET        4000   // Request time per auto frame shared by the tasks (ms)
+#define SCHED_INITIAL_COST        2500   // Expected request latency before any was measured (ms)
+#define SCHED_QUANTUM             500    // Deficit added per round, times the task weight (ms)
+#define SCHED_CAPTION_WEIGHT      1
+#define SCHED_SIGN_WEIGHT         2
+#define SCHED_OCR_WEIGHT          2
+#define SCHED_MAX_ROUNDS          32
+#define SCHED_CAPTION_INTERVAL    20000  // Minimum gap between captions (ms)
+#define SCHED_SIGN_INTERVAL       0
+#define SCHED_OCR_INTERVAL        0
+#define SCHED_SCENE_CHANGE        18     // Mean luma change that counts as a new scene (0-255)
+#define SCHED_THUMB_WIDTH         16     // Scene thumbnail compared for the caption trigger
+#define SCHED_THUMB_HEIGHT        12
+
+// ===================
+// Admission Control
+// ===================
+#define ADMISSION_MANUAL_INTERVAL 1000   // One manual request token per interval (ms)
+#define ADMISSION_MANUAL_BURST    3      // Manual requests allowed back to back
+#define ADMISSION_AUTO_INTERVAL   1000   // One auto-capture request token per interval (ms)
+#define ADMISSION_AUTO_BURST      1
+#define ADMISSION_QUEUE_DEPTH     4      // Frames waiting for a token (copies, in PSRAM when present)
+#define ADMISSION_MAX_WAIT        10000  // Queued frames older than this are dropped (ms)
+
+// ===================
+// Keyword Matching
+// ===================
+#define KEYWORD_MAX_STATES        160    // Automaton states; one per keyword character, plus one
+#define KEYWORD_MAX_CLASSES       32     // Distinct keyword characters (letters count once), plus one
+
 // ===================
 // LED Status Indicators
 // ===================
@@ -49,6 +265,53 @@
 // ===================
 #define BUZZER_PIN           25
 #define VIBRATION_PIN        26
+#define FEEDBACK_LEDC_CHANNEL     2      // Buzzer PWM; channels 0-1 share the camera XCLK timer
+#define FEEDBACK_SLOTS            6      // Patterns playing or waiting at once
+#define FEEDBACK_MAX_STEPS        8      // Steps per pattern (repeats are free)
+#define FEEDBACK_MAX_DELAY        1000   // Patterns waiting longer for their outputs are dropped (ms)
+#define FEEDBACK_IDLE_WAIT        1000   // Feedback task wake-up period with nothing playing (ms)
+#define FEEDBACK_TASK_CORE        1
+#define FEEDBACK_TASK_PRIORITY    4
+
+// ===================
+// Audio Output
+// ===================
+#define AUDIO_I2S_PORT            I2S_NUM_1   // I2S_NUM_0 is the microphone
+#define AUDIO_I2S_BCLK_PIN        41
+#define AUDIO_I2S_LRC_PIN         42
+#define AUDIO_I2S_DOUT_PIN        40
+#define AUDIO_SAMPLE_RATE         16000  // Output rate (Hz); clips at other rates are resampled
+#define AUDIO_DMA_BUFFERS         8
+#define AUDIO_DMA_FRAMES          256    // Samples per DMA buffer (16 ms at 16 kHz)
+#define AUDIO_RING_SAMPLES        8192   // Playback ring in front of the DMA (512 ms); a power of two
+#define AUDIO_CHUNK_SAMPLES       256    // Samples decoded per write into the ring
+#define AUDIO_QUEUE_SIZE          5      // Clips waiting to play
+#define AUDIO_OUTPUT_CORE         0
+#define AUDIO_OUTPUT_PRIORITY     5      // Above the playback task, so the DMA is refilled first
+#define AUDIO_PLAYBACK_PRIORITY   4
+#define AUDIO_DIR                 "/audio/"  // Clips on LittleFS
+
+// ===================
+// Audio Streaming
+// ===================
+#define AUDIO_STREAM_BUFFER           32768  // Compressed jitter buffer (bytes, PSRAM)
+#define AUDIO_STREAM_MIN_PREBUFFER    200    // Audio buffered before playback on a fast link (ms)
+#define AUDIO_STREAM_ASSUMED_LENGTH   4000   // Audio assumed still to come when the length is unknown (ms)
+#define AUDIO_STREAM_LINK_MARGIN      0.8    // Share of the measured downlink rate counted on
+#define AUDIO_STREAM_STALL_TIMEOUT    5000   // Give up after this long without a byte (ms)
+
+// ===================
+// Speech Clip Cache
+// ===================
+#define ENABLE_CLIP_CACHE         true
+#define CLOUD_TTS_VOICE           "default"      // Voice asked for in requests; part of the cache key
+#define CLIP_CACHE_DIR            "/tts/"        // On the LittleFS partition, beside AUDIO_DIR
+#define CLIP_CACHE_BUDGET         (384 * 1024)   // Flash for cached clips (bytes)
+#define CLIP_CACHE_MAX_ENTRIES    64
+#define CLIP_CACHE_MAX_CLIP       65536  // Longest clip cached (bytes), held in PSRAM while it streams
+#define CLIP_CACHE_ADMIT_MISSES   2      // Recent misses of a clip before it is written to flash
+#define CLIP_CACHE_MISS_HISTORY   32     // Misses remembered for admission
+#define CLIP_CACHE_INDEX_FLUSH    16     // Hits between index writes that only update recency
 
 // ===================
 // Speech Recognition Configuration
@@ -73,6 +336,8 @@ enum OperationMode {
     MODE_VISUAL_CAPTION,
     MODE_SIGN_DETECTION,
     MODE_OCR,
+    MODE_BARCODE,
+    MODE_COLOUR,
     MODE_AUTO_ALL
 };
 
@@ -81,10 +346,53 @@ enum OperationMode {
 #define OP_MODE_VISUAL_CAPTION MODE_VISUAL_CAPTION
 #define OP_MODE_SIGN_DETECTION MODE_SIGN_DETECTION
 #define OP_MODE_OCR MODE_OCR
+#define OP_MODE_BARCODE MODE_BARCODE
+#define OP_MODE_COLOUR MODE_COLOUR
 
 // ===================
 // Response Structure
 // ===================
+
+// Part of the uploaded image a response refers to, as fractions of its size
+struct ResponseRegion {
+    uint8_t kind;           // CASCADE_TEXT, CASCADE_SIGN or REGION_HAZARD
+    float x;
+    float y;
+    float width;
+    float height;
+};
+
+enum HazardType {
+    HAZARD_NONE,
+    HAZARD_OBSTACLE,
+    HAZARD_VEHICLE,
+    HAZARD_STAIRS,
+    HAZARD_DROP,            // Kerb, hole, platform edge
+    HAZARD_FIRE,
+    HAZARD_WATER,
+    HAZARD_PERSON,
+    HAZARD_OTHER
+};
+
+// Fixed-layout result decoded from a CBOR response, without heap allocation
+struct StructuredResult {
+    uint8_t version;
+    bool success;
+    float confidence;
+    uint8_t hazardType;     // HazardType
+    uint8_t direction;      // KeywordDirection
+    float distance;         // Metres to the hazard, 0 when unknown
+    float taskConfidence[STRUCTURED_TASKS];  // By OperationMode, -1 for tasks not run
+    ResponseRegion regions[API_MAX_REGIONS];
+    int regionCount;
+    bool hasAudio;
+    uint32_t audioSize;
+    char audioFormat[8];
+    char audioUrl[STRUCTURED_MAX_URL];
+    char text[STRUCTURED_MAX_TEXT];
+    char error[STRUCTURED_MAX_ERROR];
+};
+
 struct APIResponse {
     bool success;
     String result;
@@ -97,6 +405,15 @@ struct APIResponse {
     String audioUrl;        // URL for audio file from cloud
     String audioFormat;     // mp3, wav, etc.
     size_t audioSize;       // Size of audio data
+    bool audioInline;       // Audio came with the response; gsmModule.playInlineAudio() plays it
+    
+    // Text and sign regions reported by the cloud, for follow-up requests
+    ResponseRegion regions[API_MAX_REGIONS];
+    int regionCount;
+    
+    // Enumerated fields, valid when the cloud answered in CBOR
+    bool structured;
+    StructuredResult details;
 };
 
 #endif // INTEL_GLASSES_CONFIG_H
@@ -0,0 +1,1469 @@
+#include "jpeg_transcoder.h"
+#include <math.h>
+
+JpegTranscoder jpegTranscoder;
+
+namespace {
+
+// Zigzag position -> natural (row-major) index
+const uint8_t kZigzagToNatural[64] = {
+     0,  1,  8, 16,  9,  2,  3, 10, 17, 24, 32, 25, 18, 11,  4,  5,
+    12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13,  6,  7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+
+// Standard Huffman tables (ITU T.81 Annex K.3)
+const uint8_t kStdDcLumaBits[17] = { 0, 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 };
+const uint8_t kStdDcLumaValues[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+const uint8_t kStdDcChromaBits[17] = { 0, 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 };
+const uint8_t kStdDcChromaValues[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+const uint8_t kStdAcLumaBits[17] = { 0, 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7d };
+const uint8_t kStdAcLumaValues[] = {
+    0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07,
+    0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23, 0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0,
+    0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+    0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7,
+    0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5,
+    0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa
+};
+const uint8_t kStdAcChromaBits[17] = { 0, 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 };
+const uint8_t kStdAcChromaValues[] = {
+    0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71,
+    0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0,
+    0x15, 0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26,
+    0x27, 0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48,
+    0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68,
+    0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+    0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5,
+    0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3,
+    0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda,
+    0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8,
+    0xf9, 0xfa
+};
+
+const int MAX_COMPONENTS = 3;
+const int MAX_BLOCKS_PER_MCU = 10;
+const int MAX_METADATA_SEGMENTS = 8;
+
+// Huffman table as stored in a DHT segment
+struct HuffmanSpec {
+    uint8_t bits[17];         // bits[n] = number of codes of length n
+    uint8_t values[256];
+    bool defined;
+
+    void set(const uint8_t* specBits, const uint8_t* specValues) {
+        memcpy(bits, specBits, 17);
+        int count = 0;
+        for (int i = 1; i <= 16; i++) count += bits[i];
+        memcpy(values, specValues, count);
+        defined = true;
+    }
+};
+
+struct HuffmanDecoder {
+    static const int LOOKUP_BITS = 9;
+    uint16_t lookup[1 << LOOKUP_BITS];  // (length << 8) | value, 0 when the code is longer
+    int32_t maxCode[18];
+    int32_t valueOffset[17];
+    uint8_t values[256];
+
+    bool build(const HuffmanSpec& spec) {
+        if (!spec.defined) return false;
+        memset(lookup, 0, sizeof(lookup));
+        memcpy(values, spec.values, sizeof(values));
+
+        int32_t code = 0;
+        int index = 0;
+        for (int len = 1; len <= 16; len++) {
+            valueOffset[len] = index - code;
+            for (int i = 0; i < spec.bits[len]; i++) {
+                if (code >= (1 << len)) return false;
+                if (len <= LOOKUP_BITS) {
+                    int shift = LOOKUP_BITS - len;
+                    for (int fill = 0; fill < (1 << shift); fill++) {
+                        lookup[(code << shift) | fill] = (len << 8) | spec.values[index];
+                    }
+                }
+                code++;
+                index++;
+            }
+            maxCode[len] = spec.bits[len] ? code - 1 : -1;
+            code <<= 1;
+        }
+        maxCode[17] = INT32_MAX;
+        return true;
+    }
+};
+
+struct HuffmanEncoder {
+    uint16_t code[256];
+    uint8_t size[256];
+
+    void build(const HuffmanSpec& spec) {
+        memset(size, 0, sizeof(size));
+        uint16_t next = 0;
+        int index = 0;
+        for (int len = 1; len <= 16; len++) {
+            for (int i = 0; i < spec.bits[len]; i++) {
+                code[spec.values[index]] = next++;
+                size[spec.values[index]] = len;
+                index++;
+            }
+            next <<= 1;
+        }
+    }
+};
+
+struct JpegComponent {
+    uint8_t id;
+    uint8_t h;
+    uint8_t v;
+    uint8_t tq;               // Quantization table
+    uint8_t td;               // DC Huffman table
+    uint8_t ta;               // AC Huffman table
+    int16_t dcPred;
+};
+
+struct MetadataSegment {
+    const uint8_t* data;      // Marker included
+    size_t length;
+};
+
+// Parsed baseline JPEG headers
+struct JpegStream {
+    uint16_t width;
+    uint16_t height;
+    int componentCount;
+    JpegComponent comp[MAX_COMPONENTS];
+    uint16_t quant[4][64];    // Zigzag order, as stored in the file
+    uint8_t quantPrecision[4];
+    bool quantDefined[4];
+    HuffmanSpec dcSpec[4];
+    HuffmanSpec acSpec[4];
+    uint16_t restartInterval;
+    int hmax;
+    int vmax;
+    int mcuWidth;
+    int mcuHeight;
+    int mcusX;
+    int mcusY;
+    int blocksPerMcu;
+    const uint8_t* scan;
+    const uint8_t* end;
+    MetadataSegment metadata[MAX_METADATA_SEGMENTS];
+    int metadataCount;
+
+    bool parse(const uint8_t* data, size_t length) {
+        memset(this, 0, sizeof(*this));
+        if (!data || length < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+
+        const uint8_t* p = data + 2;
+        end = data + length;
+        bool haveFrame = false;
+
+        while (p < end) {
+            if (*p != 0xFF) return false;
+            while (p < end && *p == 0xFF) p++;
+            if (p >= end) return false;
+            uint8_t marker = *p++;
+
+            if (marker == 0xD8 || (marker >= 0xD0 && marker <= 0xD7) || marker == 0x01) continue;
+            if (marker == 0xD9) return false;   // EOI before any scan
+            if (p + 2 > end) return false;
+
+            size_t segLength = (p[0] << 8) | p[1];
+            if (segLength < 2 || p + segLength > end) return false;
+            const uint8_t* seg = p + 2;
+            const uint8_t* segEnd = p + segLength;
+
+            switch (marker) {
+                case 0xC0:  // Baseline
+                case 0xC1:  // Extended sequential, Huffman
+                    if (!parseFrame(seg, segEnd)) return false;
+                    haveFrame = true;
+                    break;
+                case 0xC4:
+                    if (!parseHuffman(seg, segEnd)) return false;
+                    break;
+                case 0xDB:
+                    if (!parseQuant(seg, segEnd)) return false;
+                    break;
+                case 0xDD:
+                    if (segLength < 4) return false;
+                    restartInterval = (seg[0] << 8) | seg[1];
+                    break;
+                case 0xDA:
+                    if (!haveFrame || !parseScan(seg, segEnd)) return false;
+                    scan = segEnd;
+                    return true;
+                default:
+                    if ((marker >= 0xC2 && marker <= 0xCF) && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+                        return false;   // Progressive, lossless and arithmetic coding are not supported
+                    }
+                    if (((marker >= 0xE0 && marker <= 0xEF) || marker == 0xFE) && metadataCount < MAX_METADATA_SEGMENTS) {
+                        metadata[metadataCount].data = p - 2;
+                        metadata[metadataCount].length = segLength + 2;
+                        metadataCount++;
+                    }
+                    break;
+            }
+            p = segEnd;
+        }
+        return false;
+    }
+
+    bool parseFrame(const uint8_t* seg, const uint8_t* segEnd) {
+        if (segEnd - seg < 6 || seg[0] != 8) return false;
+        height = (seg[1] << 8) | seg[2];
+        width = (seg[3] << 8) | seg[4];
+        componentCount = seg[5];
+        if (width == 0 || height == 0) return false;
+        if (componentCount != 1 && componentCount != 3) return false;
+        if (segEnd - seg < 6 + componentCount * 3) return false;
+
+        hmax = 1;
+        vmax = 1;
+        blocksPerMcu = 0;
+        for (int i = 0; i < componentCount; i++) {
+            const uint8_t* c = seg + 6 + i * 3;
+            comp[i].id = c[0];
+            comp[i].h = c[1] >> 4;
+            comp[i].v = c[1] & 0x0F;
+            comp[i].tq = c[2] & 0x03;
+            if (comp[i].h < 1 || comp[i].h > 2 || comp[i].v < 1 || comp[i].v > 2) return false;
+        }
+
+        // A single-component scan is non-interleaved: one block per MCU
+        if (componentCount == 1) {
+            comp[0].h = 1;
+            comp[0].v = 1;
+        }
+
+        for (int i = 0; i < componentCount; i++) {
+            hmax = max(hmax, (int)comp[i].h);
+            vmax = max(vmax, (int)comp[i].v);
+            blocksPerMcu += comp[i].h * comp[i].v;
+        }
+        if (blocksPerMcu > MAX_BLOCKS_PER_MCU) return false;
+
+        mcuWidth = 8 * hmax;
+        mcuHeight = 8 * vmax;
+        mcusX = (width + mcuWidth - 1) / mcuWidth;
+        mcusY = (height + mcuHeight - 1) / mcuHeight;
+        return true;
+    }
+
+    bool parseHuffman(const uint8_t* seg, const uint8_t* segEnd) {
+        while (seg < segEnd) {
+            if (segEnd - seg < 17) return false;
+            uint8_t tc = seg[0] >> 4;
+            uint8_t th = seg[0] & 0x0F;
+            if (tc > 1 || th > 3) return false;
+
+            HuffmanSpec& spec = tc == 0 ? dcSpec[th] : acSpec[th];
+            spec.bits[0] = 0;
+            int count = 0;
+            for (int i = 1; i <= 16; i++) {
+                spec.bits[i] = seg[i];
+                count += seg[i];
+            }
+            if (count > 256 || segEnd - seg < 17 + count) return false;
+            memcpy(spec.values, seg + 17, count);
+            spec.defined = true;
+            seg += 17 + count;
+        }
+        return true;
+    }
+
+    bool parseQuant(const uint8_t* seg, const uint8_t* segEnd) {
+        while (seg < segEnd) {
+            uint8_t pq = seg[0] >> 4;
+            uint8_t tq = seg[0] & 0x0F;
+            if (pq > 1 || tq > 3) return false;
+            int size = pq ? 128 : 64;
+            if (segEnd - seg < 1 + size) return false;
+            for (int i = 0; i < 64; i++) {
+                quant[tq][i] = pq ? ((seg[1 + i * 2] << 8) | seg[2 + i * 2]) : seg[1 + i];
+            }
+            quantPrecision[tq] = pq;
+            quantDefined[tq] = true;
+            seg += 1 + size;
+        }
+        return true;
+    }
+
+    bool parseScan(const uint8_t* seg, const uint8_t* segEnd) {
+        if (segEnd - seg < 1) return false;
+        int ns = seg[0];
+        if (ns != componentCount || segEnd - seg < 4 + ns * 2) return false;
+        for (int i = 0; i < ns; i++) {
+            uint8_t id = seg[1 + i * 2];
+            uint8_t tables = seg[2 + i * 2];
+            int found = -1;
+            for (int c = 0; c < componentCount; c++) {
+                if (comp[c].id == id) found = c;
+            }
+            if (found < 0) return false;
+            comp[found].td = tables >> 4;
+            comp[found].ta = tables & 0x0F;
+            if (comp[found].td > 3 || comp[found].ta > 3) return false;
+            if (!quantDefined[comp[found].tq]) return false;
+        }
+        const uint8_t* s = seg + 1 + ns * 2;
+        return s[0] == 0 && s[1] == 63 && s[2] == 0;
+    }
+};
+
+// Entropy-coded segment reader with byte-stuffing and marker handling
+struct BitReader {
+    const uint8_t* p;
+    const uint8_t* end;
+    uint32_t buffer;
+    int bits;
+    bool hitMarker;
+
+    void begin(const uint8_t* start, const uint8_t* stop) {
+        p = start;
+        end = stop;
+        buffer = 0;
+        bits = 0;
+        hitMarker = false;
+    }
+
+    inline void fill() {
+        while (bits <= 24) {
+            uint32_t byte = 0;
+            if (!hitMarker && p < end) {
+                byte = *p++;
+                if (byte == 0xFF) {
+                    uint8_t next = p < end ? *p : 0xD9;
+                    if (next == 0x00) {
+                        p++;
+                    } else {
+                        // Marker: leave it for the caller and feed zeros
+                        p--;
+                        hitMarker = true;
+                        byte = 0;
+                    }
+                }
+            }
+            buffer |= byte << (24 - bits);
+            bits += 8;
+        }
+    }
+
+    inline uint32_t getBits(int n) {
+        fill();
+        uint32_t value = buffer >> (32 - n);
+        buffer <<= n;
+        bits -= n;
+        return value;
+    }
+
+    inline int receiveExtend(int s) {
+        if (s == 0) return 0;
+        int value = getBits(s);
+        if (value < (1 << (s - 1))) value -= (1 << s) - 1;
+        return value;
+    }
+
+    inline int decode(const HuffmanDecoder& table) {
+        fill();
+        uint16_t entry = table.lookup[buffer >> (32 - HuffmanDecoder::LOOKUP_BITS)];
+        if (entry) {
+            int len = entry >> 8;
+            buffer <<= len;
+            bits -= len;
+            return entry & 0xFF;
+        }
+        for (int len = HuffmanDecoder::LOOKUP_BITS + 1; len <= 16; len++) {
+            int32_t code = buffer >> (32 - len);
+            if (code <= table.maxCode[len]) {
+                buffer <<= len;
+                bits -= len;
+                return table.values[code + table.valueOffset[len]];
+            }
+        }
+        return -1;
+    }
+
+    bool skipRestartMarker() {
+        // Discard buffered bits and step over the next RSTn marker
+        buffer = 0;
+        bits = 0;
+        hitMarker = false;
+        while (p + 1 < end) {
+            if (p[0] == 0xFF && p[1] >= 0xD0 && p[1] <= 0xD7) {
+                p += 2;
+                return true;
+            }
+            p++;
+        }
+        return false;
+    }
+};
+
+// Sequential decoder producing one MCU of quantized coefficients at a time
+class ScanDecoder {
+private:
+    JpegStream* stream;
+    BitReader reader;
+    HuffmanDecoder dc[4];
+    HuffmanDecoder ac[4];
+    uint32_t mcusDecoded;
+
+    bool decodeBlock(int16_t* block, JpegComponent& c) {
+        memset(block, 0, 64 * sizeof(int16_t));
+
+        int s = reader.decode(dc[c.td]);
+        if (s < 0 || s > 11) return false;
+        c.dcPred += reader.receiveExtend(s);
+        block[0] = c.dcPred;
+
+        const HuffmanDecoder& table = ac[c.ta];
+        for (int k = 1; k < 64;) {
+            int rs = reader.decode(table);
+            if (rs < 0) return false;
+            int r = rs >> 4;
+            s = rs & 0x0F;
+            if (s == 0) {
+                if (r != 15) break;     // EOB
+                k += 16;                // ZRL
+                continue;
+            }
+            k += r;
+            if (k > 63) return false;
+            block[k] = reader.receiveExtend(s);
+            k++;
+        }
+        return true;
+    }
+
+public:
+    bool begin(JpegStream& s) {
+        stream = &s;
+        mcusDecoded = 0;
+        for (int i = 0; i < s.componentCount; i++) {
+            if (!dc[s.comp[i].td].build(s.dcSpec[s.comp[i].td])) return false;
+            if (!ac[s.comp[i].ta].build(s.acSpec[s.comp[i].ta])) return false;
+            s.comp[i].dcPred = 0;
+        }
+        reader.begin(s.scan, s.end);
+        return true;
+    }
+
+    // Blocks are stored component by component, row-major within the MCU, in zigzag order
+    bool decodeMcu(int16_t (*blocks)[64]) {
+        if (stream->restartInterval && mcusDecoded > 0 && mcusDecoded % stream->restartInterval == 0) {
+            if (!reader.skipRestartMarker()) return false;
+            for (int i = 0; i < stream->componentCount; i++) {
+                stream->comp[i].dcPred = 0;
+            }
+        }
+
+        int b = 0;
+        for (int i = 0; i < stream->componentCount; i++) {
+            JpegComponent& c = stream->comp[i];
+            for (int n = 0; n < c.h * c.v; n++) {
+                if (!decodeBlock(blocks[b++], c)) return false;
+            }
+        }
+        mcusDecoded++;
+        return true;
+    }
+};
+
+// Growable output buffer
+struct OutputBuffer {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+
+    bool begin(size_t initial) {
+        data = (uint8_t*)malloc(initial);
+        size = 0;
+        capacity = data ? initial : 0;
+        failed = data == nullptr;
+        return !failed;
+    }
+
+    bool grow(size_t needed) {
+        if (failed) return false;
+        size_t newCapacity = capacity;
+        while (newCapacity < needed) newCapacity = newCapacity * 3 / 2 + 1024;
+        uint8_t* grown = (uint8_t*)realloc(data, newCapacity);
+        if (!grown) {
+            failed = true;
+            return false;
+        }
+        data = grown;
+        capacity = newCapacity;
+        return true;
+    }
+
+    inline void put(uint8_t byte) {
+        if (size >= capacity && !grow(size + 1)) return;
+        data[size++] = byte;
+    }
+
+    void write(const uint8_t* bytes, size_t length) {
+        if (size + length > capacity && !grow(size + length)) return;
+        memcpy(data + size, bytes, length);
+        size += length;
+    }
+
+    void put16(uint16_t value) {
+        put(value >> 8);
+        put(value & 0xFF);
+    }
+
+    void release() {
+        if (data) free(data);
+        data = nullptr;
+        size = 0;
+        capacity = 0;
+    }
+};
+
+// Baseline entropy encoder
+class ScanEncoder {
+private:
+    OutputBuffer* out;
+    HuffmanEncoder dc[2];
+    HuffmanEncoder ac[2];
+    uint32_t accumulator;
+    int accumulatedBits;
+    int16_t dcPred[MAX_COMPONENTS];
+    bool counting;
+    uint32_t counts[2][2][256];   // [DC/AC][table][symbol], gathered in counting mode
+
+    inline void putBits(uint32_t value, int count) {
+        accumulator = (accumulator << count) | (value & ((1u << count) - 1));
+        accumulatedBits += count;
+        while (accumulatedBits >= 8) {
+            uint8_t byte = (accumulator >> (accumulatedBits - 8)) & 0xFF;
+            out->put(byte);
+            if (byte == 0xFF) out->put(0x00);
+            accumulatedBits -= 8;
+        }
+    }
+
+    static inline int bitLength(int value) {
+        int magnitude = value < 0 ? -value : value;
+        int bits = 0;
+        while (magnitude) {
+            bits++;
+            magnitude >>= 1;
+        }
+        return bits;
+    }
+
+    inline void putSymbol(int tableClass, int table, int symbol) {
+        if (counting) {
+            counts[tableClass][table][symbol]++;
+            return;
+        }
+        const HuffmanEncoder& encoder = tableClass == 0 ? dc[table] : ac[table];
+        putBits(encoder.code[symbol], encoder.size[symbol]);
+    }
+
+    inline void putValue(int value, int bits) {
+        if (bits && !counting) putBits(value < 0 ? value - 1 : value, bits);
+    }
+
+public:
+    void begin(OutputBuffer* output, const HuffmanSpec* dcSpecs, const HuffmanSpec* acSpecs, int tableCount) {
+        out = output;
+        accumulator = 0;
+        accumulatedBits = 0;
+        for (int i = 0; i < tableCount; i++) {
+            dc[i].build(dcSpecs[i]);
+            ac[i].build(acSpecs[i]);
+        }
+        memset(dcPred, 0, sizeof(dcPred));
+        counting = false;
+    }
+
+    // Gather symbol statistics instead of writing output
+    void beginCount() {
+        out = nullptr;
+        accumulator = 0;
+        accumulatedBits = 0;
+        memset(dcPred, 0, sizeof(dcPred));
+        memset(counts, 0, sizeof(counts));
+        counting = true;
+    }
+
+    const uint32_t* getCounts(int tableClass, int table) const {
+        return counts[tableClass][table];
+    }
+
+    void encodeBlock(const int16_t* block, int component, int table) {
+        int diff = block[0] - dcPred[component];
+        dcPred[component] = block[0];
+        int bits = bitLength(diff);
+        putSymbol(0, table, bits);
+        putValue(diff, bits);
+
+        int run = 0;
+        for (int k = 1; k < 64; k++) {
+            int value = block[k];
+            if (value == 0) {
+                run++;
+                continue;
+            }
+            while (run > 15) {
+                putSymbol(1, table, 0xF0);
+                run -= 16;
+            }
+            bits = bitLength(value);
+            putSymbol(1, table, (run << 4) | bits);
+            putValue(value, bits);
+            run = 0;
+        }
+        if (run > 0) putSymbol(1, table, 0x00);
+    }
+
+    void finish() {
+        if (!counting && accumulatedBits > 0) {
+            putBits(0x7F, 8 - accumulatedBits);   // Pad with 1-bits
+        }
+    }
+};
+
+// Separable DCT basis: basis[r][x][u] = sqrt(2/r) * C(u) * cos((2x+1)u*pi/2r)
+float dctBasis8[8][8];
+float dctBasis4[4][4];
+float dctBasis2[2][2];
+bool dctBasisReady = false;
+
+void initDctBasis() {
+    if (dctBasisReady) return;
+    for (int x = 0; x < 8; x++) {
+        for (int u = 0; u < 8; u++) {
+            float c = u == 0 ? M_SQRT1_2 : 1.0f;
+            dctBasis8[x][u] = sqrtf(2.0f / 8) * c * cosf((2 * x + 1) * u * M_PI / 16);
+            if (x < 4 && u < 4) dctBasis4[x][u] = sqrtf(2.0f / 4) * c * cosf((2 * x + 1) * u * M_PI / 8);
+            if (x < 2 && u < 2) dctBasis2[x][u] = sqrtf(2.0f / 2) * c * cosf((2 * x + 1) * u * M_PI / 4);
+        }
+    }
+    dctBasisReady = true;
+}
+
+inline uint8_t clampPixel(float value) {
+    int v = (int)lroundf(value);
+    return v < 0 ? 0 : (v > 255 ? 255 : v);
+}
+
+// Reconstruct an r x r pixel patch from the low-frequency r x r coefficients of a block
+void reduceBlock(const int16_t* block, const uint16_t* quant, int r, uint8_t* out, int stride) {
+    if (r == 1) {
+        out[0] = clampPixel(block[0] * quant[0] / 8.0f + 128);
+        return;
+    }
+
+    const float* basis = r == 2 ? &dctBasis2[0][0] : (r == 4 ? &dctBasis4[0][0] : &dctBasis8[0][0]);
+    float scale = r / 8.0f;
+    float coef[8][8];
+    for (int v = 0; v < r; v++) {
+        for (int u = 0; u < r; u++) coef[v][u] = 0;
+    }
+    for (int k = 0; k < 64; k++) {
+        if (!block[k]) continue;
+        int n = kZigzagToNatural[k];
+        int v = n >> 3;
+        int u = n & 7;
+        if (u < r && v < r) coef[v][u] = block[k] * quant[k] * scale;
+    }
+
+    // Rows then columns
+    float temp[8][8];
+    for (int v = 0; v < r; v++) {
+        for (int x = 0; x < r; x++) {
+            float sum = 0;
+            for (int u = 0; u < r; u++) sum += basis[x * r + u] * coef[v][u];
+            temp[v][x] = sum;
+        }
+    }
+    for (int y = 0; y < r; y++) {
+        for (int x = 0; x < r; x++) {
+            float sum = 0;
+            for (int v = 0; v < r; v++) sum += basis[y * r + v] * temp[v][x];
+            out[y * stride + x] = clampPixel(sum + 128);
+        }
+    }
+}
+
+// Forward DCT and quantization of an 8x8 pixel block into zigzag order
+void forwardBlock(const uint8_t* pixels, int stride, const uint16_t* quant, int16_t* block) {
+    float temp[8][8];
+    for (int y = 0; y < 8; y++) {
+        for (int u = 0; u < 8; u++) {
+            float sum = 0;
+            for (int x = 0; x < 8; x++) sum += dctBasis8[x][u] * (pixels[y * stride + x] - 128);
+            temp[y][u] = sum;
+        }
+    }
+    float coef[64];
+    for (int v = 0; v < 8; v++) {
+        for (int u = 0; u < 8; u++) {
+            float sum = 0;
+            for (int y = 0; y < 8; y++) sum += dctBasis8[y][v] * temp[y][u];
+            coef[v * 8 + u] = sum;
+        }
+    }
+    for (int k = 0; k < 64; k++) {
+        int value = (int)lroundf(coef[kZigzagToNatural[k]] / quant[k]);
+        int limit = k == 0 ? 2047 : 1023;
+        block[k] = value < -limit ? -limit : (value > limit ? limit : value);
+    }
+}
+
+void writeHuffmanTable(OutputBuffer& out, int tableClass, int id, const HuffmanSpec& spec) {
+    int count = 0;
+    for (int i = 1; i <= 16; i++) count += spec.bits[i];
+    out.put(0xFF);
+    out.put(0xC4);
+    out.put16(2 + 1 + 16 + count);
+    out.put((tableClass << 4) | id);
+    out.write(spec.bits + 1, 16);
+    out.write(spec.values, count);
+}
+
+// Headers for the output stream; component 0 uses table 0, chroma components table 1
+void writeHeaders(OutputBuffer& out, const JpegStream& s, const uint16_t (*quant)[64], uint16_t width, uint16_t height,
+                  const HuffmanSpec* dcSpecs, const HuffmanSpec* acSpecs, bool keepMetadata) {
+    out.put(0xFF);
+    out.put(0xD8);
+
+    if (keepMetadata) {
+        for (int i = 0; i < s.metadataCount; i++) {
+            out.write(s.metadata[i].data, s.metadata[i].length);
+        }
+    }
+
+    bool written[4] = { false, false, false, false };
+    for (int i = 0; i < s.componentCount; i++) {
+        int tq = s.comp[i].tq;
+        if (written[tq]) continue;
+        written[tq] = true;
+        int pq = s.quantPrecision[tq];
+        out.put(0xFF);
+        out.put(0xDB);
+        out.put16(2 + 1 + (pq ? 128 : 64));
+        out.put((pq << 4) | tq);
+        for (int k = 0; k < 64; k++) {
+            if (pq) out.put16(quant[tq][k]);
+            else out.put(quant[tq][k]);
+        }
+    }
+
+    out.put(0xFF);
+    out.put(0xC0);
+    out.put16(8 + 3 * s.componentCount);
+    out.put(8);
+    out.put16(height);
+    out.put16(width);
+    out.put(s.componentCount);
+    for (int i = 0; i < s.componentCount; i++) {
+        out.put(s.comp[i].id);
+        out.put((s.comp[i].h << 4) | s.comp[i].v);
+        out.put(s.comp[i].tq);
+    }
+
+    int tables = s.componentCount > 1 ? 2 : 1;
+    for (int t = 0; t < tables; t++) {
+        writeHuffmanTable(out, 0, t, dcSpecs[t]);
+        writeHuffmanTable(out, 1, t, acSpecs[t]);
+    }
+
+    out.put(0xFF);
+    out.put(0xDA);
+    out.put16(6 + 2 * s.componentCount);
+    out.put(s.componentCount);
+    for (int i = 0; i < s.componentCount; i++) {
+        int t = i == 0 ? 0 : 1;
+        out.put(s.comp[i].id);
+        out.put((t << 4) | t);
+    }
+    out.put(0);
+    out.put(63);
+    out.put(0);
+}
+
+void standardTables(HuffmanSpec* dcSpecs, HuffmanSpec* acSpecs) {
+    dcSpecs[0].set(kStdDcLumaBits, kStdDcLumaValues);
+    acSpecs[0].set(kStdAcLumaBits, kStdAcLumaValues);
+    dcSpecs[1].set(kStdDcChromaBits, kStdDcChromaValues);
+    acSpecs[1].set(kStdAcChromaBits, kStdAcChromaValues);
+}
+
+bool hasSymbols(const uint32_t* counts) {
+    for (int i = 0; i < 256; i++) {
+        if (counts[i]) return true;
+    }
+    return false;
+}
+
+// Optimal length-limited Huffman table from symbol counts (ITU T.81 Annex K.2)
+void optimalTable(const uint32_t* counts, HuffmanSpec& spec) {
+    uint32_t freq[257];
+    int codeSize[257];
+    int others[257];
+    for (int i = 0; i < 256; i++) freq[i] = counts[i];
+    freq[256] = 1;          // Reserved symbol so no real code is all 1-bits
+    memset(codeSize, 0, sizeof(codeSize));
+    for (int i = 0; i < 257; i++) others[i] = -1;
+
+    // Repeatedly merge the two least frequent trees
+    while (true) {
+        int c1 = -1;
+        int c2 = -1;
+        uint32_t v1 = UINT32_MAX;
+        uint32_t v2 = UINT32_MAX;
+        for (int i = 0; i < 257; i++) {
+            if (freq[i] && freq[i] <= v1) {
+                v2 = v1;
+                c2 = c1;
+                v1 = freq[i];
+                c1 = i;
+            } else if (freq[i] && freq[i] <= v2) {
+                v2 = freq[i];
+                c2 = i;
+            }
+        }
+        if (c2 < 0) break;
+
+        freq[c1] += freq[c2];
+        freq[c2] = 0;
+        codeSize[c1]++;
+        while (others[c1] >= 0) {
+            c1 = others[c1];
+            codeSize[c1]++;
+        }
+        others[c1] = c2;
+        codeSize[c2]++;
+        while (others[c2] >= 0) {
+            c2 = others[c2];
+            codeSize[c2]++;
+        }
+    }
+
+    int bits[33];
+    memset(bits, 0, sizeof(bits));
+    for (int i = 0; i < 257; i++) {
+        if (codeSize[i]) bits[min(codeSize[i], 32)]++;
+    }
+
+    // Limit code lengths to 16 bits
+    for (int i = 32; i > 16; i--) {
+        while (bits[i] > 0) {
+            int j = i - 2;
+            while (bits[j] == 0) j--;
+            bits[i] -= 2;
+            bits[i - 1]++;
+            bits[j + 1] += 2;
+            bits[j]--;
+        }
+    }
+
+    // Drop the reserved symbol, which has the longest code
+    int longest = 16;
+    while (longest > 0 && bits[longest] == 0) longest--;
+    if (longest > 0) bits[longest]--;
+
+    spec.bits[0] = 0;
+    for (int i = 1; i <= 16; i++) spec.bits[i] = bits[i];
+    int p = 0;
+    for (int len = 1; len <= 32; len++) {
+        for (int symbol = 0; symbol < 256; symbol++) {
+            if (codeSize[symbol] == len) spec.values[p++] = symbol;
+        }
+    }
+    spec.defined = true;
+}
+
+// Crop in whole MCUs: [mcuX0, mcuX1) x [mcuY0, mcuY1)
+struct McuRegion {
+    int mcuX0;
+    int mcuY0;
+    int mcuX1;
+    int mcuY1;
+    uint16_t pixelWidth;
+    uint16_t pixelHeight;
+};
+
+// Quantization tables for the output, coarsened by quantScale when requantizing
+void scaleQuantTables(const JpegStream& s, float quantScale, uint16_t (*quant)[64]) {
+    for (int t = 0; t < 4; t++) {
+        int limit = s.quantPrecision[t] ? 32767 : 255;
+        for (int k = 0; k < 64; k++) {
+            int value = quantScale > 1.0f ? (int)lroundf(s.quant[t][k] * quantScale) : s.quant[t][k];
+            quant[t][k] = value < 1 ? 1 : (value > limit ? limit : value);
+        }
+    }
+}
+
+// Re-express quantized coefficients against a coarser table
+void requantizeBlock(const int16_t* block, const uint16_t* fromQuant, const uint16_t* toQuant, int16_t* out) {
+    for (int k = 0; k < 64; k++) {
+        if (!block[k] || fromQuant[k] == toQuant[k]) {
+            out[k] = block[k];
+            continue;
+        }
+        int scaled = block[k] * fromQuant[k];
+        int q = toQuant[k];
+        out[k] = scaled >= 0 ? (scaled + q / 2) / q : -((-scaled + q / 2) / q);
+    }
+}
+
+McuRegion computeRegion(const JpegStream& s, bool crop, const JpegCropRect& rect) {
+    McuRegion region = { 0, 0, s.mcusX, s.mcusY, s.width, s.height };
+    if (!crop) return region;
+
+    int x1 = min((int)rect.x + rect.width, (int)s.width);
+    int y1 = min((int)rect.y + rect.height, (int)s.height);
+    region.mcuX0 = min(rect.x / s.mcuWidth, s.mcusX - 1);
+    region.mcuY0 = min(rect.y / s.mcuHeight, s.mcusY - 1);
+    region.mcuX1 = max(region.mcuX0 + 1, (x1 + s.mcuWidth - 1) / s.mcuWidth);
+    region.mcuY1 = max(region.mcuY0 + 1, (y1 + s.mcuHeight - 1) / s.mcuHeight);
+    region.pixelWidth = min(region.mcuX1 * s.mcuWidth, (int)s.width) - region.mcuX0 * s.mcuWidth;
+    region.pixelHeight = min(region.mcuY1 * s.mcuHeight, (int)s.height) - region.mcuY0 * s.mcuHeight;
+    return region;
+}
+
+} // namespace
+
+JpegTranscoder::JpegTranscoder() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool JpegTranscoder::getInfo(const uint8_t* jpeg, size_t length, JpegInfo* info) {
+    JpegStream stream;
+    if (!stream.parse(jpeg, length)) return false;
+
+    info->width = stream.width;
+    info->height = stream.height;
+    info->components = stream.componentCount;
+    info->mcuWidth = stream.mcuWidth;
+    info->mcuHeight = stream.mcuHeight;
+    info->restartInterval = stream.restartInterval;
+    return true;
+}
+
+bool JpegTranscoder::alignCropRect(const uint8_t* jpeg, size_t length, const JpegCropRect& rect, JpegCropRect* aligned) {
+    JpegStream stream;
+    if (!stream.parse(jpeg, length)) return false;
+
+    McuRegion region = computeRegion(stream, true, rect);
+    aligned->x = region.mcuX0 * stream.mcuWidth;
+    aligned->y = region.mcuY0 * stream.mcuHeight;
+    aligned->width = region.pixelWidth;
+    aligned->height = region.pixelHeight;
+    return true;
+}
+
+bool JpegTranscoder::transcode(const uint8_t* jpeg, size_t length, const JpegTranscodeOptions& options,
+                               uint8_t** output, size_t* outputSize) {
+    unsigned long startTime = micros();
+    *output = nullptr;
+    *outputSize = 0;
+
+    JpegStream* stream = new JpegStream();
+    ScanDecoder* decoder = new ScanDecoder();
+    ScanEncoder* encoder = new ScanEncoder();
+    int16_t (*blocks)[64] = new int16_t[MAX_BLOCKS_PER_MCU][64];
+    uint16_t (*outQuant)[64] = new uint16_t[4][64];
+    uint8_t* strips[MAX_COMPONENTS] = { nullptr, nullptr, nullptr };
+    OutputBuffer out = { nullptr, 0, 0, false };
+    bool success = false;
+
+    do {
+        if (!stream->parse(jpeg, length)) {
+            Serial.println("JPEG transcode: unsupported or corrupt stream");
+            break;
+        }
+        if (!decoder->begin(*stream)) {
+            Serial.println("JPEG transcode: invalid Huffman tables");
+            break;
+        }
+
+        int k = options.scale;
+        if (k != 1 && k != 2 && k != 4 && k != 8) break;
+        int r = 8 / k;
+
+        McuRegion region = computeRegion(*stream, options.crop, options.cropRect);
+        uint16_t outWidth = (region.pixelWidth + k - 1) / k;
+        uint16_t outHeight = (region.pixelHeight + k - 1) / k;
+        int regionMcusX = region.mcuX1 - region.mcuX0;
+        int regionMcusY = region.mcuY1 - region.mcuY0;
+        int outMcusX = (regionMcusX + k - 1) / k;
+
+        HuffmanSpec dcSpecs[2];
+        HuffmanSpec acSpecs[2];
+        standardTables(dcSpecs, acSpecs);
+
+        bool requantize = options.quantScale > 1.0f;
+        scaleQuantTables(*stream, options.quantScale, outQuant);
+
+        // Pixel strips hold one output MCU row per component when downscaling
+        int stripWidth[MAX_COMPONENTS];
+        int stripHeight[MAX_COMPONENTS];
+        if (k > 1) {
+            initDctBasis();
+            bool allocated = true;
+            for (int i = 0; i < stream->componentCount; i++) {
+                stripWidth[i] = outMcusX * stream->comp[i].h * 8;
+                stripHeight[i] = stream->comp[i].v * 8;
+                strips[i] = (uint8_t*)malloc(stripWidth[i] * stripHeight[i]);
+                if (!strips[i]) allocated = false;
+            }
+            if (!allocated) {
+                Serial.println("JPEG transcode: out of memory");
+                break;
+            }
+        }
+
+        // With optimized tables the scan is coded twice: once to count symbols, once to write
+        int passes = options.optimizeHuffman ? 2 : 1;
+        bool decodeOk = true;
+        bool timedOut = false;
+        int16_t outBlock[64];
+        for (int pass = 0; pass < passes && decodeOk && !timedOut; pass++) {
+            if (pass < passes - 1) {
+                encoder->beginCount();
+            } else {
+                if (pass > 0) {
+                    decoder->begin(*stream);
+                    // Tables that were never used (chroma in a grayscale scan) keep the standard codes
+                    for (int t = 0; t < 2; t++) {
+                        if (hasSymbols(encoder->getCounts(0, t))) optimalTable(encoder->getCounts(0, t), dcSpecs[t]);
+                        if (hasSymbols(encoder->getCounts(1, t))) optimalTable(encoder->getCounts(1, t), acSpecs[t]);
+                    }
+                }
+
+                // Output rarely exceeds the input; the buffer grows if it does
+                if (!out.begin(length / (k * k) + 1024)) break;
+                writeHeaders(out, *stream, outQuant, outWidth, outHeight, dcSpecs, acSpecs, false);
+                encoder->begin(&out, dcSpecs, acSpecs, 2);
+            }
+
+            for (int my = 0; my < region.mcuY1 && decodeOk && !timedOut; my++) {
+                if (options.timeLimitMicros && micros() - startTime > options.timeLimitMicros) {
+                    timedOut = true;
+                    break;
+                }
+                for (int mx = 0; mx < stream->mcusX; mx++) {
+                    if (!decoder->decodeMcu(blocks)) {
+                        decodeOk = false;
+                        break;
+                    }
+                    if (my < region.mcuY0 || mx < region.mcuX0 || mx >= region.mcuX1) continue;
+
+                    if (k == 1) {
+                        // Coefficients pass straight through
+                        int b = 0;
+                        for (int i = 0; i < stream->componentCount; i++) {
+                            int n = stream->comp[i].h * stream->comp[i].v;
+                            for (int j = 0; j < n; j++, b++) {
+                                if (requantize) {
+                                    int tq = stream->comp[i].tq;
+                                    requantizeBlock(blocks[b], stream->quant[tq], outQuant[tq], outBlock);
+                                    encoder->encodeBlock(outBlock, i, i == 0 ? 0 : 1);
+                                } else {
+                                    encoder->encodeBlock(blocks[b], i, i == 0 ? 0 : 1);
+                                }
+                            }
+                        }
+                        continue;
+                    }
+
+                    // Reduce each block to an r x r patch in its component strip
+                    int rmx = mx - region.mcuX0;
+                    int rmy = my - region.mcuY0;
+                    int b = 0;
+                    for (int i = 0; i < stream->componentCount; i++) {
+                        const JpegComponent& c = stream->comp[i];
+                        for (int v = 0; v < c.v; v++) {
+                            for (int h = 0; h < c.h; h++, b++) {
+                                int px = (rmx * c.h + h) * r;
+                                int py = ((rmy % k) * c.v + v) * r;
+                                if (px >= stripWidth[i]) continue;
+                                reduceBlock(blocks[b], stream->quant[c.tq], r,
+                                            strips[i] + py * stripWidth[i] + px, stripWidth[i]);
+                            }
+                        }
+                    }
+                }
+                if (!decodeOk || k == 1 || my < region.mcuY0) continue;
+
+                int rmy = my - region.mcuY0;
+                if (rmy % k != k - 1 && rmy != regionMcusY - 1) continue;
+
+                // Replicate edges where the source region does not fill the strip
+                for (int i = 0; i < stream->componentCount; i++) {
+                    const JpegComponent& c = stream->comp[i];
+                    int filledWidth = min(regionMcusX * c.h * r, stripWidth[i]);
+                    int filledHeight = ((rmy % k) + 1) * c.v * r;
+                    uint8_t* strip = strips[i];
+                    for (int y = 0; y < filledHeight; y++) {
+                        uint8_t* row = strip + y * stripWidth[i];
+                        memset(row + filledWidth, row[filledWidth - 1], stripWidth[i] - filledWidth);
+                    }
+                    for (int y = filledHeight; y < stripHeight[i]; y++) {
+                        memcpy(strip + y * stripWidth[i], strip + (filledHeight - 1) * stripWidth[i], stripWidth[i]);
+                    }
+                }
+
+                for (int omx = 0; omx < outMcusX; omx++) {
+                    for (int i = 0; i < stream->componentCount; i++) {
+                        const JpegComponent& c = stream->comp[i];
+                        for (int v = 0; v < c.v; v++) {
+                            for (int h = 0; h < c.h; h++) {
+                                const uint8_t* src = strips[i] + v * 8 * stripWidth[i] + (omx * c.h + h) * 8;
+                                forwardBlock(src, stripWidth[i], outQuant[c.tq], outBlock);
+                                encoder->encodeBlock(outBlock, i, i == 0 ? 0 : 1);
+                            }
+                        }
+                    }
+                }
+            }
+
+            encoder->finish();
+        }
+
+        if (timedOut) {
+            Serial.println("JPEG transcode: time limit exceeded");
+            break;
+        }
+        if (!decodeOk) {
+            Serial.println("JPEG transcode: entropy decode failed");
+            break;
+        }
+
+        out.put(0xFF);
+        out.put(0xD9);
+        if (out.failed) {
+            Serial.println("JPEG transcode: out of memory");
+            break;
+        }
+
+        success = true;
+    } while (false);
+
+    for (int i = 0; i < MAX_COMPONENTS; i++) {
+        if (strips[i]) free(strips[i]);
+    }
+    delete[] blocks;
+    delete[] outQuant;
+    delete encoder;
+    delete decoder;
+    delete stream;
+
+    unsigned long elapsed = micros() - startTime;
+    stats.lastMicros = elapsed;
+    if (success) {
+        *output = out.data;
+        *outputSize = out.size;
+        stats.transcodes++;
+        stats.bytesIn += length;
+        stats.bytesOut += out.size;
+        stats.totalMicros += elapsed;
+    } else {
+        out.release();
+        stats.failures++;
+    }
+    return success;
+}
+
+bool JpegTranscoder::crop(camera_fb_t* fb, const JpegCropRect& rect, uint8_t** output, size_t* outputSize) {
+    if (!fb || fb->format != PIXFORMAT_JPEG) return false;
+
+    JpegTranscodeOptions options;
+    options.crop = true;
+    options.cropRect = rect;
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return transcode(fb->buf, fb->len, options, output, outputSize);
+}
+
+bool JpegTranscoder::downscale(camera_fb_t* fb, JpegScale scale, uint8_t** output, size_t* outputSize) {
+    if (!fb || fb->format != PIXFORMAT_JPEG) return false;
+
+    JpegTranscodeOptions options;
+    options.crop = false;
+    options.cropRect = { 0, 0, 0, 0 };
+    options.scale = scale;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return transcode(fb->buf, fb->len, options, output, outputSize);
+}
+
+bool JpegTranscoder::optimize(const uint8_t* jpeg, size_t length, unsigned long timeLimitMicros,
+                              uint8_t** output, size_t* outputSize) {
+    JpegTranscodeOptions options;
+    options.crop = false;
+    options.cropRect = { 0, 0, 0, 0 };
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = true;
+    options.timeLimitMicros = timeLimitMicros;
+    return transcode(jpeg, length, options, output, outputSize);
+}
+
+bool JpegTranscoder::decodePlanes(const uint8_t* jpeg, size_t length, JpegScale scale, JpegPlane* planes, int planeCount) {
+    for (int i = 0; i < planeCount; i++) {
+        planes[i].data = nullptr;
+    }
+
+    JpegStream* stream = new JpegStream();
+    ScanDecoder* decoder = new ScanDecoder();
+    int16_t (*blocks)[64] = new int16_t[MAX_BLOCKS_PER_MCU][64];
+    bool success = false;
+
+    do {
+        if (!stream->parse(jpeg, length) || !decoder->begin(*stream)) {
+            Serial.println("JPEG decode: unsupported or corrupt stream");
+            break;
+        }
+        int k = scale;
+        if (k != 1 && k != 2 && k != 4 && k != 8) break;
+        if (planeCount < 1 || planeCount > stream->componentCount) break;
+        int r = 8 / k;
+
+        bool allocated = true;
+        for (int i = 0; i < planeCount; i++) {
+            const JpegComponent& c = stream->comp[i];
+            int sampleWidth = (stream->width * c.h + stream->hmax - 1) / stream->hmax;
+            int sampleHeight = (stream->height * c.v + stream->vmax - 1) / stream->vmax;
+            planes[i].width = (sampleWidth + k - 1) / k;
+            planes[i].height = (sampleHeight + k - 1) / k;
+            planes[i].stride = stream->mcusX * c.h * r;
+            planes[i].data = (uint8_t*)malloc(planes[i].stride * stream->mcusY * c.v * r);
+            if (!planes[i].data) allocated = false;
+        }
+        if (!allocated) {
+            Serial.println("JPEG decode: out of memory");
+            break;
+        }
+
+        initDctBasis();
+        bool decodeOk = true;
+        for (int my = 0; my < stream->mcusY && decodeOk; my++) {
+            for (int mx = 0; mx < stream->mcusX; mx++) {
+                if (!decoder->decodeMcu(blocks)) {
+                    decodeOk = false;
+                    break;
+                }
+                int b = 0;
+                for (int i = 0; i < planeCount; i++) {
+                    const JpegComponent& c = stream->comp[i];
+                    for (int v = 0; v < c.v; v++) {
+                        for (int h = 0; h < c.h; h++, b++) {
+                            uint8_t* dst = planes[i].data + ((my * c.v + v) * r) * planes[i].stride + (mx * c.h + h) * r;
+                            reduceBlock(blocks[b], stream->quant[c.tq], r, dst, planes[i].stride);
+                        }
+                    }
+                }
+            }
+        }
+        if (!decodeOk) {
+            Serial.println("JPEG decode: entropy decode failed");
+            break;
+        }
+        success = true;
+    } while (false);
+
+    if (!success) {
+        for (int i = 0; i < planeCount; i++) {
+            if (planes[i].data) free(planes[i].data);
+            planes[i].data = nullptr;
+        }
+    }
+    delete[] blocks;
+    delete decoder;
+    delete stream;
+    return success;
+}
+
+// Budget search limits
+static const float BUDGET_MAX_SCALE = 25.0;
+static const float BUDGET_ACCEPT_RATIO = 0.90;  // Results within 10% under the budget are accepted
+static const float BUDGET_REQUANT_EXPONENT = 0.45; // Requantizing an existing stream saves less than a fresh encode
+
+// Scale at which a power-law rate curve through (scale, size) with the given exponent reaches target
+static float predictScale(float scale, size_t size, size_t target, float exponent) {
+    return scale * powf((float)size / target, 1.0f / exponent);
+}
+
+// Local exponent of the rate curve between two encodes
+static float fitExponent(float scaleA, size_t sizeA, float scaleB, size_t sizeB, float fallback) {
+    float dScale = logf(scaleB / scaleA);
+    if (sizeA == 0 || sizeB == 0 || fabsf(dScale) < 0.01) return fallback;
+    float exponent = -logf((float)sizeB / sizeA) / dScale;
+    return constrain(exponent, 0.1f, 2.5f);
+}
+
+bool JpegTranscoder::encodeToBudget(JpegEncodeFunction encode, void* context, size_t budget,
+                                    const JpegRateEstimate& estimate,
+                                    uint8_t** output, size_t* outputSize, JpegBudgetResult* result) {
+    *output = nullptr;
+    *outputSize = 0;
+    result->size = 0;
+    result->quantScale = 0;
+    result->encodes = 0;
+    result->withinBudget = false;
+
+    // Best result so far, and the closest encode on each side of the budget
+    uint8_t* best = nullptr;
+    size_t bestSize = 0;
+    float bestScale = 0;
+    bool bestFits = false;
+    float overScale = 0;
+    size_t overSize = 0;
+    float underScale = 0;
+    size_t underSize = 0;
+
+    float lastScale = estimate.quantScale;
+    size_t lastSize = estimate.size;
+    float exponent = estimate.exponent;
+
+    // Each pass aims a little further below the budget so the last one lands inside it
+    const float targetMargins[3] = { 0.97, 0.95, 0.92 };
+    float scale = predictScale(lastScale, lastSize, (size_t)(budget * targetMargins[0]), exponent);
+
+    for (int pass = 0; pass < 3; pass++) {
+        scale = constrain(scale, estimate.minScale, BUDGET_MAX_SCALE);
+
+        uint8_t* encoded = nullptr;
+        size_t encodedSize = 0;
+        result->encodes++;
+        if (!encode(context, scale, &encoded, &encodedSize)) break;
+
+        bool fits = encodedSize <= budget;
+        bool better = !best ||
+                      (fits && (!bestFits || encodedSize > bestSize)) ||
+                      (!fits && !bestFits && encodedSize < bestSize);
+        if (better) {
+            if (best) free(best);
+            best = encoded;
+            bestSize = encodedSize;
+            bestScale = scale;
+            bestFits = fits;
+        } else {
+            free(encoded);
+        }
+
+        if (fits && (underSize == 0 || encodedSize > underSize)) {
+            underScale = scale;
+            underSize = encodedSize;
+        } else if (!fits && (overSize == 0 || encodedSize < overSize)) {
+            overScale = scale;
+            overSize = encodedSize;
+        }
+
+        if (fits && (encodedSize >= budget * BUDGET_ACCEPT_RATIO || scale <= estimate.minScale)) break;
+        if (!fits && scale >= BUDGET_MAX_SCALE) break;
+        if (pass == 2) break;
+
+        size_t target = (size_t)(budget * targetMargins[pass + 1]);
+        if (underSize > 0 && overSize > 0) {
+            // Bracketed: interpolate on the log-log line between the two sides
+            exponent = fitExponent(underScale, underSize, overScale, overSize, exponent);
+            scale = predictScale(underScale, underSize, target, exponent);
+        } else {
+            // One-sided: refit the slope from the last two points and extrapolate
+            if (pass > 0 || estimate.measured) {
+                exponent = fitExponent(lastScale, lastSize, scale, encodedSize, exponent);
+            }
+            lastScale = scale;
+            lastSize = encodedSize;
+            scale = predictScale(scale, encodedSize, target, exponent);
+        }
+    }
+
+    if (!best) return false;
+
+    *output = best;
+    *outputSize = bestSize;
+    result->size = bestSize;
+    result->quantScale = bestScale;
+    result->withinBudget = bestFits;
+    return true;
+}
+
+struct RequantizeContext {
+    JpegTranscoder* transcoder;
+    const uint8_t* jpeg;
+    size_t length;
+};
+
+static bool requantizeEncode(void* context, float quantScale, uint8_t** output, size_t* outputSize) {
+    RequantizeContext* ctx = (RequantizeContext*)context;
+    JpegTranscodeOptions options;
+    options.crop = false;
+    options.cropRect = { 0, 0, 0, 0 };
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = quantScale;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return ctx->transcoder->transcode(ctx->jpeg, ctx->length, options, output, outputSize);
+}
+
+bool JpegTranscoder::fitToBudget(const uint8_t* jpeg, size_t length, size_t budget,
+                                 uint8_t** output, size_t* outputSize, JpegBudgetResult* result) {
+    if (length <= budget) {
+        // Already fits: hand back an untouched copy
+        *output = (uint8_t*)malloc(length);
+        if (!*output) return false;
+        memcpy(*output, jpeg, length);
+        *outputSize = length;
+        result->size = length;
+        result->quantScale = 1.0;
+        result->encodes = 0;
+        result->withinBudget = true;
+        return true;
+    }
+
+    // Scales are relative to the source tables; coarsening cannot go below them
+    RequantizeContext context = { this, jpeg, length };
+    JpegRateEstimate estimate = { length, 1.0, BUDGET_REQUANT_EXPONENT, 1.0, true };
+    return encodeToBudget(requantizeEncode, &context, budget, estimate, output, outputSize, result);
+}
+
+int JpegTranscoder::quantScaleToQuality(float quantScale) {
+    // Inverse of the libjpeg quality scaling: scale = 50/q below 50, (200 - 2q)/100 above
+    float percent = quantScale * 100;
+    int quality = percent <= 100 ? (int)lroundf((200 - percent) / 2) : (int)lroundf(5000 / percent);
+    return constrain(quality, 1, 100);
+}
+
+JpegTranscodeStats JpegTranscoder::getStats() {
+    return stats;
+}
+
+void JpegTranscoder::logStats() {
+    Serial.println("=== JPEG Transcoder ===");
+    Serial.printf("Transcodes: %u (failures: %u)\n", stats.transcodes, stats.failures);
+    if (stats.transcodes > 0) {
+        Serial.printf("Avg time: %lu us, bytes in/out: %lu/%lu\n",
+                      (unsigned long)(stats.totalMicros / stats.transcodes),
+                      (unsigned long)(stats.bytesIn / stats.transcodes),
+                      (unsigned long)(stats.bytesOut / stats.transcodes));
+    }
+    Serial.println("=======================");
+}
+
+void JpegTranscoder::resetStats() {
+    memset(&stats, 0, sizeof(stats));
+}
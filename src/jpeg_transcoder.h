@@ -0,0 +1,129 @@
+#ifndef JPEG_TRANSCODER_H
+#define JPEG_TRANSCODER_H
+
+#include <Arduino.h>
+#include "esp_camera.h"
+
+// Downscale factors applied in the DCT domain
+enum JpegScale {
+    JPEG_SCALE_FULL = 1,
+    JPEG_SCALE_HALF = 2,
+    JPEG_SCALE_QUARTER = 4,
+    JPEG_SCALE_EIGHTH = 8
+};
+
+// Crop rectangle in source pixels; expanded outward to MCU boundaries
+struct JpegCropRect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+// Basic stream information
+struct JpegInfo {
+    uint16_t width;
+    uint16_t height;
+    uint8_t components;
+    uint8_t mcuWidth;         // MCU size in pixels (8 or 16)
+    uint8_t mcuHeight;
+    uint16_t restartInterval;
+};
+
+struct JpegTranscodeOptions {
+    bool crop;                // Apply cropRect
+    JpegCropRect cropRect;
+    JpegScale scale;          // Downscale after cropping
+    float quantScale;         // > 1 coarsens the quantization tables (lower quality, fewer bytes)
+    bool optimizeHuffman;     // Code the scan with per-image optimal Huffman tables (two passes)
+    unsigned long timeLimitMicros; // Abandon the transcode past this much CPU time, 0 = no limit
+};
+
+// Decoded 8-bit component plane; data is allocated with malloc()
+struct JpegPlane {
+    uint8_t* data;
+    uint16_t width;
+    uint16_t height;
+    uint16_t stride;          // Padded to whole blocks
+};
+
+// Outcome of a byte-budget encode
+struct JpegBudgetResult {
+    size_t size;
+    float quantScale;         // Quantization scale that produced the result
+    int encodes;              // Encoder passes used (at most 3)
+    bool withinBudget;
+};
+
+// Starting point for a budget search: size ~ quantScale^-exponent through (quantScale, size)
+struct JpegRateEstimate {
+    size_t size;
+    float quantScale;
+    float exponent;
+    float minScale;           // Finest scale the encoder can usefully produce
+    bool measured;            // size was observed rather than guessed
+};
+
+// Encoder callback for budget search: produce a JPEG at the given quantization scale,
+// where 1.0 corresponds to libjpeg-style quality 50
+typedef bool (*JpegEncodeFunction)(void* context, float quantScale, uint8_t** output, size_t* outputSize);
+
+// Transcoder statistics
+struct JpegTranscodeStats {
+    uint32_t transcodes;
+    uint32_t failures;
+    uint64_t bytesIn;
+    uint64_t bytesOut;
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// Baseline JPEG transcoder working on entropy-decoded DCT coefficients.
+// Crops are taken on MCU boundaries without touching pixels, and downscaling
+// uses only the low-frequency coefficients of each block, so the frame is
+// never fully decoded. Output is a single baseline scan without APPn/COM
+// segments or restart markers. Output buffers are allocated with malloc() and
+// must be released by the caller with free().
+class JpegTranscoder {
+private:
+    JpegTranscodeStats stats;
+
+public:
+    JpegTranscoder();
+
+    // Stream inspection
+    bool getInfo(const uint8_t* jpeg, size_t length, JpegInfo* info);
+    bool alignCropRect(const uint8_t* jpeg, size_t length, const JpegCropRect& rect, JpegCropRect* aligned);
+
+    // Transcoding
+    bool transcode(const uint8_t* jpeg, size_t length, const JpegTranscodeOptions& options,
+                   uint8_t** output, size_t* outputSize);
+    bool crop(camera_fb_t* fb, const JpegCropRect& rect, uint8_t** output, size_t* outputSize);
+    bool downscale(camera_fb_t* fb, JpegScale scale, uint8_t** output, size_t* outputSize);
+    
+    // Lossless re-optimization: same coefficients, optimal Huffman tables, metadata dropped
+    bool optimize(const uint8_t* jpeg, size_t length, unsigned long timeLimitMicros,
+                  uint8_t** output, size_t* outputSize);
+    
+    // Pixel decode at 1/1 to 1/8 scale; planeCount 1 decodes luma only, 3 adds Cb and Cr
+    // at their own (subsampled) resolution
+    bool decodePlanes(const uint8_t* jpeg, size_t length, JpegScale scale, JpegPlane* planes, int planeCount);
+    
+    // Byte-budget encoding: converges on the finest quantization that fits in at most 3 encodes
+    bool encodeToBudget(JpegEncodeFunction encode, void* context, size_t budget,
+                        const JpegRateEstimate& estimate,
+                        uint8_t** output, size_t* outputSize, JpegBudgetResult* result);
+    bool fitToBudget(const uint8_t* jpeg, size_t length, size_t budget,
+                     uint8_t** output, size_t* outputSize, JpegBudgetResult* result);
+    static int quantScaleToQuality(float quantScale);
+
+    // Statistics
+    JpegTranscodeStats getStats();
+    void logStats();
+    void resetStats();
+};
+
+// Global JPEG transcoder instance
+extern JpegTranscoder jpegTranscoder;
+
+#endif // JPEG_TRANSCODER_H
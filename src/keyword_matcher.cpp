@@ -0,0 +1,169 @@
+#include "keyword_matcher.h"
+#include <cstring>
+
+KeywordMatcher keywordMatcher;
+
+namespace {
+
+struct Keyword {
+    const char* text;         // Lower case; UTF-8 outside ASCII is matched as is
+    uint8_t categories;
+    uint8_t direction;
+};
+
+// Order matters for directions (first entry wins, as the old if/else chain did)
+// and for the reported hazard keyword. At most 32 entries.
+const Keyword KEYWORDS[] = {
+    // English
+    { "hazard",   KEYWORD_HAZARD,                   DIRECTION_NONE },
+    { "danger",   KEYWORD_HAZARD | KEYWORD_WARNING, DIRECTION_NONE },
+    { "warning",  KEYWORD_HAZARD | KEYWORD_WARNING, DIRECTION_NONE },
+    { "obstacle", KEYWORD_HAZARD,                   DIRECTION_NONE },
+    { "fire",     KEYWORD_HAZARD,                   DIRECTION_NONE },
+    { "caution",  KEYWORD_HAZARD | KEYWORD_WARNING, DIRECTION_NONE },
+    { "risk",     KEYWORD_HAZARD,                   DIRECTION_NONE },
+    { "unsafe",   KEYWORD_HAZARD,                   DIRECTION_NONE },
+    { "stop",     KEYWORD_WARNING,                  DIRECTION_NONE },
+    { "right",    KEYWORD_DIRECTION,                DIRECTION_RIGHT },
+    { "left",     KEYWORD_DIRECTION,                DIRECTION_LEFT },
+    { "front",    KEYWORD_DIRECTION,                DIRECTION_FRONT },
+    { "behind",   KEYWORD_DIRECTION,                DIRECTION_BEHIND },
+    { "sign",     KEYWORD_SIGN,                     DIRECTION_NONE },
+    { "text",     KEYWORD_TEXT,                     DIRECTION_NONE },
+    { "written",  KEYWORD_TEXT,                     DIRECTION_NONE },
+    { "reads",    KEYWORD_TEXT,                     DIRECTION_NONE },
+    { "says",     KEYWORD_TEXT,                     DIRECTION_NONE }
+};
+const int KEYWORD_COUNT = sizeof(KEYWORDS) / sizeof(KEYWORDS[0]);
+
+const char* DIRECTION_NAMES[] = { "", "right", "left", "front", "behind" };
+
+} // namespace
+
+KeywordMatcher::KeywordMatcher() {
+    stateCount = 0;
+    classCount = 0;
+    ready = false;
+}
+
+bool KeywordMatcher::build() {
+    static_assert(sizeof(KEYWORDS) / sizeof(KEYWORDS[0]) <= 32, "keyword bitmask holds 32 entries");
+    static_assert(KEYWORD_MAX_STATES <= 256 && KEYWORD_MAX_CLASSES <= 256, "states and classes are stored as bytes");
+
+    // Character classes: class 0 is every byte no keyword uses, letters share
+    // a class per case pair, any other keyword byte gets its own
+    memset(classOf, 0, sizeof(classOf));
+    classCount = 1;
+    for (int k = 0; k < KEYWORD_COUNT; k++) {
+        for (const uint8_t* p = (const uint8_t*)KEYWORDS[k].text; *p; p++) {
+            uint8_t c = *p;
+            if (classOf[c] != 0) continue;
+            if (classCount >= KEYWORD_MAX_CLASSES) {
+                Serial.println("Keyword matcher: too many distinct characters, raise KEYWORD_MAX_CLASSES");
+                return false;
+            }
+            classOf[c] = classCount;
+            if (c >= 'a' && c <= 'z') classOf[c - 'a' + 'A'] = classCount;
+            classCount++;
+        }
+    }
+
+    // Trie of the keywords; 0 in a transition means "not in the trie" until
+    // the failure links are folded in
+    memset(transitions, 0, sizeof(transitions));
+    memset(outputs, 0, sizeof(outputs));
+    stateCount = 1;
+    for (int k = 0; k < KEYWORD_COUNT; k++) {
+        int state = 0;
+        for (const uint8_t* p = (const uint8_t*)KEYWORDS[k].text; *p; p++) {
+            uint8_t cls = classOf[*p];
+            if (transitions[state][cls] == 0) {
+                if (stateCount >= KEYWORD_MAX_STATES) {
+                    Serial.println("Keyword matcher: keyword table too large, raise KEYWORD_MAX_STATES");
+                    return false;
+                }
+                transitions[state][cls] = stateCount++;
+            }
+            state = transitions[state][cls];
+        }
+        outputs[state] |= 1UL << k;
+    }
+
+    // Breadth-first: every missing transition takes the one of the failure
+    // state, which is complete already as it is shallower
+    uint8_t failure[KEYWORD_MAX_STATES];
+    uint8_t queue[KEYWORD_MAX_STATES];
+    int head = 0, tail = 0;
+    failure[0] = 0;
+    for (int cls = 0; cls < classCount; cls++) {
+        uint8_t next = transitions[0][cls];
+        if (next != 0) {
+            failure[next] = 0;
+            queue[tail++] = next;
+        }
+    }
+    while (head < tail) {
+        uint8_t state = queue[head++];
+        outputs[state] |= outputs[failure[state]];
+        for (int cls = 0; cls < classCount; cls++) {
+            uint8_t next = transitions[state][cls];
+            if (next != 0) {
+                failure[next] = transitions[failure[state]][cls];
+                queue[tail++] = next;
+            } else {
+                transitions[state][cls] = transitions[failure[state]][cls];
+            }
+        }
+    }
+
+    Serial.printf("Keyword matcher: %d keywords, %d states, %d character classes\n",
+                  KEYWORD_COUNT, stateCount, classCount);
+    ready = true;
+    return true;
+}
+
+bool KeywordMatcher::classify(const char* text, size_t length, KeywordMatches* matches) {
+    memset(matches, 0, sizeof(KeywordMatches));
+    matches->hazard = -1;
+    if (!ready && !build()) {
+        return false;
+    }
+
+    uint32_t found = 0;
+    int state = 0;
+    const uint8_t* p = (const uint8_t*)text;
+    for (size_t i = 0; i < length; i++) {
+        state = transitions[state][classOf[p[i]]];
+        found |= outputs[state];
+    }
+
+    matches->keywords = found;
+    for (int k = 0; found != 0 && k < KEYWORD_COUNT; k++) {
+        if (!(found & (1UL << k))) continue;
+        const Keyword& keyword = KEYWORDS[k];
+        matches->categories |= keyword.categories;
+        if ((keyword.categories & KEYWORD_HAZARD) && matches->hazard < 0) matches->hazard = k;
+        if (keyword.direction != DIRECTION_NONE && matches->direction == DIRECTION_NONE) {
+            matches->direction = keyword.direction;
+        }
+    }
+    return true;
+}
+
+bool KeywordMatcher::classify(const String& text, KeywordMatches* matches) {
+    return classify(text.c_str(), text.length(), matches);
+}
+
+const char* KeywordMatcher::keyword(int index) {
+    if (index < 0 || index >= KEYWORD_COUNT) return "";
+    return KEYWORDS[index].text;
+}
+
+int KeywordMatcher::keywordCount() {
+    return KEYWORD_COUNT;
+}
+
+const char* KeywordMatcher::directionName(int direction) {
+    if (direction < DIRECTION_NONE || direction > DIRECTION_BEHIND) return "";
+    return DIRECTION_NAMES[direction];
+}
@@ -0,0 +1,66 @@
+#ifndef KEYWORD_MATCHER_H
+#define KEYWORD_MATCHER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+// What a keyword says about a result; one keyword may be in several categories
+enum KeywordCategory {
+    KEYWORD_HAZARD    = 1,    // Result describes a hazard
+    KEYWORD_DIRECTION = 2,    // Where the hazard is
+    KEYWORD_WARNING   = 4,    // Sign is a warning sign
+    KEYWORD_TEXT      = 8,    // Result mentions text (cascade trigger)
+    KEYWORD_SIGN      = 16    // Result mentions a sign (cascade trigger)
+};
+
+enum KeywordDirection {
+    DIRECTION_NONE,
+    DIRECTION_RIGHT,
+    DIRECTION_LEFT,
+    DIRECTION_FRONT,
+    DIRECTION_BEHIND
+};
+
+struct KeywordMatches {
+    uint32_t keywords;        // Bit i set when keyword table entry i occurs
+    uint8_t categories;       // KeywordCategory bits of the keywords found
+    uint8_t direction;        // KeywordDirection; the earliest table entry wins
+    int8_t hazard;            // First hazard keyword in table order, -1 if none
+};
+
+// Multi-keyword classifier for cloud results. The keyword table is compiled once
+// into an Aho-Corasick automaton with every failure link folded into the
+// transition table, so a result is classified in one pass over its bytes with a
+// single table lookup per byte and no allocation. ASCII letters are folded to
+// one character class, so matching is case-insensitive without copying the
+// text. Keywords are matched as substrings, like the String::indexOf() checks
+// they replace. Other languages are added as table entries: UTF-8 bytes outside
+// ASCII get character classes of their own and are matched exactly.
+class KeywordMatcher {
+private:
+    uint8_t transitions[KEYWORD_MAX_STATES][KEYWORD_MAX_CLASSES];
+    uint32_t outputs[KEYWORD_MAX_STATES];
+    uint8_t classOf[256];
+    int stateCount;
+    int classCount;
+    bool ready;
+
+    bool build();
+
+public:
+    KeywordMatcher();
+
+    // Classify `length` bytes of text
+    bool classify(const char* text, size_t length, KeywordMatches* matches);
+    bool classify(const String& text, KeywordMatches* matches);
+
+    // Keyword table
+    static const char* keyword(int index);
+    static int keywordCount();
+    static const char* directionName(int direction);
+};
+
+// Global keyword matcher instance
+extern KeywordMatcher keywordMatcher;
+
+#endif // KEYWORD_MATCHER_H
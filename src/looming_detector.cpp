@@ -0,0 +1,366 @@
+#include "looming_detector.h"
+#include "jpeg_transcoder.h"
+#include "camera_manager.h"
+#include "ai_processor.h"
+#include "audio_manager.h"
+#include <cstring>
+
+LoomingDetector loomingDetector;
+
+// Task configuration
+static const uint32_t LOOMING_TASK_STACK = 4096;
+
+// Smoothing of the per-frame expansion estimate
+static const float EXPANSION_SMOOTHING = 0.5;
+
+LoomingDetector::LoomingDetector() {
+    isRunning = false;
+    taskHandle = nullptr;
+    previousFrame = nullptr;
+    currentFrame = nullptr;
+    reset();
+}
+
+LoomingDetector::~LoomingDetector() {
+    end();
+    free(previousFrame);
+    free(currentFrame);
+}
+
+bool LoomingDetector::begin() {
+    if (isRunning) return true;
+
+    if (!previousFrame) previousFrame = (uint8_t*)malloc(LOOMING_WIDTH * LOOMING_HEIGHT);
+    if (!currentFrame) currentFrame = (uint8_t*)malloc(LOOMING_WIDTH * LOOMING_HEIGHT);
+    if (!previousFrame || !currentFrame) {
+        Serial.println("Looming detector: out of memory");
+        return false;
+    }
+    reset();
+
+    isRunning = true;
+    BaseType_t ok = xTaskCreatePinnedToCore(loomingTask, "looming", LOOMING_TASK_STACK,
+                                            this, LOOMING_TASK_PRIORITY, &taskHandle, LOOMING_TASK_CORE);
+    if (ok != pdPASS) {
+        Serial.println("Looming detector: failed to create task");
+        isRunning = false;
+        taskHandle = nullptr;
+        return false;
+    }
+
+    Serial.printf("Looming detector started: %dx%d, %dx%d regions, target %d fps\n",
+                  LOOMING_WIDTH, LOOMING_HEIGHT, LOOMING_GRID_COLS, LOOMING_GRID_ROWS, LOOMING_TARGET_FPS);
+    return true;
+}
+
+void LoomingDetector::end() {
+    if (!isRunning) return;
+    isRunning = false;
+
+    // The task notices the flag within one frame period and deletes itself
+    unsigned long start = millis();
+    while (taskHandle && millis() - start < 1000) {
+        delay(10);
+    }
+    Serial.println("Looming detector stopped");
+}
+
+bool LoomingDetector::isActive() {
+    return isRunning;
+}
+
+void LoomingDetector::reset() {
+    hasPrevious = false;
+    previousTime = 0;
+    sourceWidth = 0;
+    sourceHeight = 0;
+    memset(regions, 0, sizeof(regions));
+    alertRegion = -1;
+    lastAlertTime = 0;
+    memset(&stats, 0, sizeof(stats));
+    memset(profileStats, 0, sizeof(profileStats));
+    stats.startTime = millis();
+}
+
+void LoomingDetector::loomingTask(void* param) {
+    LoomingDetector* detector = (LoomingDetector*)param;
+    detector->runLoop();
+    detector->taskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+
+void LoomingDetector::runLoop() {
+    const TickType_t period = pdMS_TO_TICKS(1000 / LOOMING_TARGET_FPS);
+    TickType_t lastWake = xTaskGetTickCount();
+    unsigned long lastTick = millis();
+
+    while (isRunning) {
+        unsigned long now = millis();
+        OperationMode mode = cameraManager.getActiveProfileMode();
+        bool enabled = (LOOMING_MODES & (1 << mode)) != 0;
+        if (!enabled) {
+            // No frames taken at all; the estimate restarts on return
+            hasPrevious = false;
+        } else if (cameraManager.isReady()) {
+            profileStats[mode].activeMillis += now - lastTick;
+            camera_fb_t* fb = cameraManager.grabPreviewFrame();
+            if (fb) {
+                uint32_t framesBefore = stats.frames;
+                bool alert = fb->format == PIXFORMAT_JPEG && processFrame(fb->buf, fb->len, now);
+                cameraManager.releaseFrameBuffer(fb);
+                if (stats.frames != framesBefore) {
+                    profileStats[mode].frames++;
+                    profileStats[mode].totalMicros += stats.lastMicros;
+                }
+                if (alert) {
+                    raiseAlert();
+                }
+            } else {
+                stats.busyFrames++;
+            }
+        }
+        lastTick = now;
+        // Runs flat out when a frame takes longer than the period
+        vTaskDelayUntil(&lastWake, period);
+    }
+}
+
+bool LoomingDetector::processFrame(const uint8_t* jpeg, size_t length, unsigned long timestamp) {
+    if (!previousFrame) previousFrame = (uint8_t*)malloc(LOOMING_WIDTH * LOOMING_HEIGHT);
+    if (!currentFrame) currentFrame = (uint8_t*)malloc(LOOMING_WIDTH * LOOMING_HEIGHT);
+    if (!previousFrame || !currentFrame) return false;
+
+    unsigned long startTime = micros();
+    if (!loadFrame(jpeg, length)) {
+        stats.skippedFrames++;
+        return false;
+    }
+
+    bool alert = false;
+    float interval = (timestamp - previousTime) / 1000.0f;
+    if (hasPrevious && interval > 0 && interval < LOOMING_MAX_FRAME_GAP / 1000.0f) {
+        alert = updateRegions(interval);
+    } else {
+        // First frame, or too long since the last one for the derivatives to hold
+        for (int i = 0; i < LOOMING_REGION_COUNT; i++) {
+            regions[i].expansion = 0;
+            regions[i].timeToCollision = 0;
+            regions[i].confirmations = 0;
+        }
+    }
+
+    uint8_t* swap = previousFrame;
+    previousFrame = currentFrame;
+    currentFrame = swap;
+    hasPrevious = true;
+    previousTime = timestamp;
+
+    if (alert) {
+        if (lastAlertTime != 0 && timestamp - lastAlertTime < LOOMING_ALERT_COOLDOWN) {
+            alert = false;
+        } else {
+            lastAlertTime = timestamp;
+            stats.alerts++;
+        }
+    }
+
+    unsigned long elapsed = micros() - startTime;
+    stats.frames++;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+    return alert;
+}
+
+bool LoomingDetector::loadFrame(const uint8_t* jpeg, size_t length) {
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(jpeg, length, &info)) {
+        return false;
+    }
+
+    // A profile switch changes the field of view; start over
+    if (info.width != sourceWidth || info.height != sourceHeight) {
+        hasPrevious = false;
+        sourceWidth = info.width;
+        sourceHeight = info.height;
+    }
+
+    // Coarsest DCT scale that still covers the working resolution
+    JpegScale scale = JPEG_SCALE_EIGHTH;
+    while (scale > JPEG_SCALE_FULL &&
+           (info.width / scale < LOOMING_WIDTH || info.height / scale < LOOMING_HEIGHT)) {
+        scale = (JpegScale)(scale / 2);
+    }
+
+    JpegPlane luma;
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, &luma, 1)) {
+        return false;
+    }
+
+    // Box-average down to the working grid
+    for (int y = 0; y < LOOMING_HEIGHT; y++) {
+        int y0 = y * luma.height / LOOMING_HEIGHT;
+        int y1 = max(y0 + 1, (y + 1) * luma.height / LOOMING_HEIGHT);
+        uint8_t* out = currentFrame + y * LOOMING_WIDTH;
+        for (int x = 0; x < LOOMING_WIDTH; x++) {
+            int x0 = x * luma.width / LOOMING_WIDTH;
+            int x1 = max(x0 + 1, (x + 1) * luma.width / LOOMING_WIDTH);
+            int sum = 0;
+            for (int sy = y0; sy < y1; sy++) {
+                const uint8_t* row = luma.data + sy * luma.stride;
+                for (int sx = x0; sx < x1; sx++) {
+                    sum += row[sx];
+                }
+            }
+            int count = (y1 - y0) * (x1 - x0);
+            out[x] = (sum + count / 2) / count;
+        }
+    }
+    free(luma.data);
+    return true;
+}
+
+bool LoomingDetector::updateRegions(float interval) {
+    // Normal equations per region for [A B C] with features (Ex, Ey, G = x*Ex + y*Ey),
+    // x and y relative to the region centre
+    struct Sums {
+        float aa, ab, ag, bb, bg, gg;
+        float at, bt, gt;
+        int pixels;
+    };
+    Sums sums[LOOMING_REGION_COUNT];
+    memset(sums, 0, sizeof(sums));
+
+    const int regionWidth = LOOMING_WIDTH / LOOMING_GRID_COLS;
+    const int regionHeight = LOOMING_HEIGHT / LOOMING_GRID_ROWS;
+    for (int y = 1; y < LOOMING_HEIGHT - 1; y++) {
+        int row = min(y / regionHeight, LOOMING_GRID_ROWS - 1);
+        float ry = y - (row * regionHeight + (regionHeight - 1) * 0.5f);
+        const uint8_t* p = previousFrame + y * LOOMING_WIDTH;
+        const uint8_t* c = currentFrame + y * LOOMING_WIDTH;
+        for (int x = 1; x < LOOMING_WIDTH - 1; x++) {
+            int column = min(x / regionWidth, LOOMING_GRID_COLS - 1);
+            float rx = x - (column * regionWidth + (regionWidth - 1) * 0.5f);
+
+            // Spatial derivatives averaged over both frames, temporal difference
+            float ex = ((p[x + 1] - p[x - 1]) + (c[x + 1] - c[x - 1])) * 0.25f;
+            float ey = ((p[x + LOOMING_WIDTH] - p[x - LOOMING_WIDTH]) +
+                        (c[x + LOOMING_WIDTH] - c[x - LOOMING_WIDTH])) * 0.25f;
+            float et = (float)c[x] - p[x];
+            float g = rx * ex + ry * ey;
+
+            Sums& s = sums[row * LOOMING_GRID_COLS + column];
+            s.aa += ex * ex;
+            s.ab += ex * ey;
+            s.ag += ex * g;
+            s.bb += ey * ey;
+            s.bg += ey * g;
+            s.gg += g * g;
+            s.at += ex * et;
+            s.bt += ey * et;
+            s.gt += g * et;
+            s.pixels++;
+        }
+    }
+
+    bool alert = false;
+    for (int i = 0; i < LOOMING_REGION_COUNT; i++) {
+        const Sums& s = sums[i];
+        LoomingRegion& region = regions[i];
+
+        // Solve by Cramer's rule; C = det(M with third column replaced) / det(M)
+        float minorAB = s.aa * s.bb - s.ab * s.ab;
+        float det = s.aa * (s.bb * s.gg - s.bg * s.bg)
+                  - s.ab * (s.ab * s.gg - s.bg * s.ag)
+                  + s.ag * (s.ab * s.bg - s.bb * s.ag);
+        // Energy of G left over once translation is accounted for
+        region.texture = (minorAB > 0 && s.pixels > 0) ? det / minorAB / s.pixels : 0;
+        if (region.texture < LOOMING_MIN_TEXTURE) {
+            region.expansion = 0;
+            region.timeToCollision = 0;
+            region.confirmations = 0;
+            continue;
+        }
+
+        float ra = -s.at, rb = -s.bt, rg = -s.gt;
+        float detC = s.aa * (s.bb * rg - rb * s.bg)
+                   - s.ab * (s.ab * rg - rb * s.ag)
+                   + ra * (s.ab * s.bg - s.bb * s.ag);
+        float expansion = detC / det / interval;
+        region.expansion += EXPANSION_SMOOTHING * (expansion - region.expansion);
+        region.timeToCollision = region.expansion > 0 ? 1.0f / region.expansion : 0;
+
+        // Ground rows expand whenever the wearer walks and never count towards an alert
+        int row = i / LOOMING_GRID_COLS;
+        bool approaching = region.timeToCollision > 0 && region.timeToCollision <= LOOMING_ALERT_TTC;
+        if (approaching && row < LOOMING_GRID_ROWS - LOOMING_IGNORE_BOTTOM_ROWS) {
+            if (region.confirmations < 255) region.confirmations++;
+        } else {
+            region.confirmations = 0;
+        }
+
+        if (region.timeToCollision > 0 &&
+            (stats.minTimeToCollision == 0 || region.timeToCollision < stats.minTimeToCollision)) {
+            stats.minTimeToCollision = region.timeToCollision;
+        }
+        if (region.confirmations >= LOOMING_CONFIRM_FRAMES &&
+            (!alert || region.timeToCollision < regions[alertRegion].timeToCollision)) {
+            alert = true;
+            alertRegion = i;
+        }
+    }
+    return alert;
+}
+
+void LoomingDetector::raiseAlert() {
+    const LoomingRegion& region = regions[alertRegion];
+    String direction = getAlertDirection();
+    Serial.printf("COLLISION WARNING: %s, time to contact %.1f s\n", direction.c_str(), region.timeToCollision);
+
+    aiProcessor.updateStatusLEDs(false, true, false);
+    aiProcessor.provideHapticFeedback(4);
+    audioManager.playHazardAlert("obstacle", direction);
+}
+
+const LoomingRegion& LoomingDetector::getRegion(int index) {
+    return regions[constrain(index, 0, LOOMING_REGION_COUNT - 1)];
+}
+
+int LoomingDetector::getAlertRegion() {
+    return alertRegion;
+}
+
+String LoomingDetector::getAlertDirection() {
+    if (alertRegion < 0) return "";
+    int column = alertRegion % LOOMING_GRID_COLS;
+    if (column * 3 < LOOMING_GRID_COLS - 1) return "left";
+    if (column * 3 >= 2 * LOOMING_GRID_COLS) return "right";
+    return "ahead";
+}
+
+float LoomingDetector::getFrameRate() {
+    unsigned long elapsed = millis() - stats.startTime;
+    return elapsed > 0 ? stats.frames * 1000.0f / elapsed : 0;
+}
+
+LoomingStats LoomingDetector::getStats() {
+    return stats;
+}
+
+LoomingProfileStats LoomingDetector::getProfileStats(OperationMode mode) {
+    return profileStats[constrain((int)mode, (int)MODE_HAZARD_DETECTION, (int)MODE_AUTO_ALL)];
+}
+
+void LoomingDetector::logStats() {
+    if (stats.frames == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.frames);
+    Serial.printf("Looming: %.1f fps (target %d), avg %lu us/frame, %u alerts, %u periods camera busy, shortest TTC %.1f s\n",
+                  getFrameRate(), LOOMING_TARGET_FPS, avgMicros, stats.alerts, stats.busyFrames, stats.minTimeToCollision);
+
+    // Rate reached under each profile; larger frames take longer to decode
+    for (int mode = MODE_HAZARD_DETECTION; mode <= MODE_AUTO_ALL; mode++) {
+        const LoomingProfileStats& p = profileStats[mode];
+        if (p.frames == 0 || p.activeMillis == 0) continue;
+        Serial.printf("  Profile %d: %.1f fps, avg %lu us/frame\n", mode,
+                      p.frames * 1000.0f / p.activeMillis, (unsigned long)(p.totalMicros / p.frames));
+    }
+}
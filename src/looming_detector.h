@@ -0,0 +1,97 @@
+#ifndef LOOMING_DETECTOR_H
+#define LOOMING_DETECTOR_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "intel_glasses_config.h"
+
+#define LOOMING_REGION_COUNT (LOOMING_GRID_COLS * LOOMING_GRID_ROWS)
+
+// Expansion estimate of one image region
+struct LoomingRegion {
+    float expansion;          // Smoothed expansion rate (1/s), > 0 when approaching
+    float timeToCollision;    // Seconds, 0 when not approaching or not measurable
+    float texture;            // Gradient energy backing the estimate
+    uint8_t confirmations;    // Consecutive frames under the alert threshold
+};
+
+// Analysis under one capture profile, whose frame size sets the decode cost
+struct LoomingProfileStats {
+    uint32_t frames;
+    uint64_t totalMicros;
+    uint64_t activeMillis;    // Time spent running under this profile
+};
+
+struct LoomingStats {
+    uint32_t frames;          // Frames analysed
+    uint32_t skippedFrames;   // Frames that could not be decoded
+    uint32_t busyFrames;      // Periods without a frame while a capture or profile switch held the camera
+    uint32_t alerts;
+    uint64_t totalMicros;     // Processing time (decode + estimate)
+    unsigned long lastMicros;
+    unsigned long startTime;
+    float minTimeToCollision; // Shortest time to collision seen since reset
+};
+
+// Local looming detector. Consecutive low-resolution luma frames are compared
+// with the brightness-constancy constraint Ex*u + Ey*v + Et = 0 under a per-region
+// flow model u = A + C*x, v = B + C*y: A and B absorb head rotation and bobbing,
+// C is the expansion rate and 1/C the time to collision. A region that stays under
+// LOOMING_ALERT_TTC raises a haptic and audio alert without any network round trip.
+class LoomingDetector {
+private:
+    volatile bool isRunning;
+    TaskHandle_t taskHandle;
+
+    uint8_t* previousFrame;   // LOOMING_WIDTH x LOOMING_HEIGHT luma
+    uint8_t* currentFrame;
+    bool hasPrevious;
+    unsigned long previousTime;
+    uint16_t sourceWidth;     // Geometry of the previous frame, to catch profile changes
+    uint16_t sourceHeight;
+
+    LoomingRegion regions[LOOMING_REGION_COUNT];
+    int alertRegion;          // Region of the latest alert
+    unsigned long lastAlertTime;
+    LoomingStats stats;
+    LoomingProfileStats profileStats[MODE_AUTO_ALL + 1];
+
+public:
+    LoomingDetector();
+    ~LoomingDetector();
+
+    // Background task on LOOMING_TASK_CORE pulling frames from the camera while
+    // the active capture profile is one of LOOMING_MODES
+    bool begin();
+    void end();
+    bool isActive();
+
+    // Analyse one frame; returns true when a collision alert should be raised.
+    // Used by the task and by host-side replay.
+    bool processFrame(const uint8_t* jpeg, size_t length, unsigned long timestamp);
+    void reset();
+
+    // Results
+    const LoomingRegion& getRegion(int index);
+    int getAlertRegion();
+    String getAlertDirection();
+    float getFrameRate();     // Frames analysed per second since reset
+
+    // Statistics
+    LoomingStats getStats();
+    LoomingProfileStats getProfileStats(OperationMode mode);
+    void logStats();
+
+private:
+    static void loomingTask(void* param);
+    void runLoop();
+    bool loadFrame(const uint8_t* jpeg, size_t length);
+    bool updateRegions(float interval);
+    void raiseAlert();
+};
+
+// Global looming detector instance
+extern LoomingDetector loomingDetector;
+
+#endif // LOOMING_DETECTOR_H
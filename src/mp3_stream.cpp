@@ -0,0 +1,199 @@
+#include "mp3_stream.h"
+#include "libhelix-mp3/mp3dec.h"
+#include <cstring>
+
+namespace {
+
+// Layer III bitrates (kbit/s) by bitrate index, MPEG-1 and MPEG-2/2.5
+const uint16_t BITRATES[2][16] = {
+    { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 },
+    { 0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0 }
+};
+
+// Sample rates by version bits (MPEG-2.5, reserved, MPEG-2, MPEG-1) and rate index
+const uint32_t SAMPLE_RATES[4][3] = {
+    { 11025, 12000, 8000 },
+    { 0, 0, 0 },
+    { 22050, 24000, 16000 },
+    { 44100, 48000, 32000 }
+};
+
+} // namespace
+
+Mp3StreamDecoder::Mp3StreamDecoder() {
+    decoder = nullptr;
+    buffer = nullptr;
+    pcm = nullptr;
+    readPos = 0;
+    writePos = 0;
+    tagBytesLeft = 0;
+    started = false;
+    finished = false;
+    memset(&format, 0, sizeof(format));
+    frames = 0;
+    errors = 0;
+}
+
+Mp3StreamDecoder::~Mp3StreamDecoder() {
+    end();
+}
+
+bool Mp3StreamDecoder::begin() {
+    end();
+    buffer = (uint8_t*)(psramFound() ? ps_malloc(AUDIO_STREAM_BUFFER) : malloc(AUDIO_STREAM_BUFFER));
+    pcm = (int16_t*)malloc(MP3_MAX_FRAME_SAMPLES * sizeof(int16_t));
+    decoder = MP3InitDecoder();
+    if (!buffer || !pcm || !decoder) {
+        end();
+        return false;
+    }
+    readPos = 0;
+    writePos = 0;
+    tagBytesLeft = 0;
+    started = false;
+    finished = false;
+    memset(&format, 0, sizeof(format));
+    frames = 0;
+    errors = 0;
+    return true;
+}
+
+void Mp3StreamDecoder::end() {
+    if (decoder) MP3FreeDecoder((HMP3Decoder)decoder);
+    decoder = nullptr;
+    free(buffer);
+    buffer = nullptr;
+    free(pcm);
+    pcm = nullptr;
+}
+
+size_t Mp3StreamDecoder::feed(const uint8_t* data, size_t size) {
+    if (!buffer) return 0;
+    if (writePos + size > AUDIO_STREAM_BUFFER && readPos > 0) {
+        // Move what is left to the front; helix needs each frame contiguous
+        memmove(buffer, buffer + readPos, writePos - readPos);
+        writePos -= readPos;
+        readPos = 0;
+    }
+    size = min(size, (size_t)AUDIO_STREAM_BUFFER - writePos);
+    memcpy(buffer + writePos, data, size);
+    writePos += size;
+    return size;
+}
+
+size_t Mp3StreamDecoder::space() {
+    return buffer ? AUDIO_STREAM_BUFFER - (writePos - readPos) : 0;
+}
+
+void Mp3StreamDecoder::finish() {
+    finished = true;
+}
+
+bool Mp3StreamDecoder::findFrame(Mp3FrameHeader* header) {
+    while (true) {
+        if (tagBytesLeft > 0) {
+            size_t drop = min(tagBytesLeft, writePos - readPos);
+            readPos += drop;
+            tagBytesLeft -= drop;
+            if (tagBytesLeft > 0) return false;
+        }
+        if (!started) {
+            if (writePos - readPos < 10 && !finished) return false;
+            started = true;
+            const uint8_t* p = buffer + readPos;
+            if (writePos - readPos >= 10 && memcmp(p, "ID3", 3) == 0) {
+                // Size is syncsafe (7 bits per byte); a footer adds 10 bytes
+                tagBytesLeft = 10 + ((p[6] & 0x7F) << 21 | (p[7] & 0x7F) << 14 | (p[8] & 0x7F) << 7 | (p[9] & 0x7F)) +
+                               ((p[5] & 0x10) ? 10 : 0);
+                continue;
+            }
+        }
+
+        // Next sync word (11 set bits)
+        while (readPos + 1 < writePos && !(buffer[readPos] == 0xFF && (buffer[readPos + 1] & 0xE0) == 0xE0)) {
+            readPos++;
+        }
+        if (writePos - readPos < 4) return false;
+        if (!parseHeader(buffer + readPos, header)) {
+            readPos++;
+            continue;
+        }
+        if (format.sampleRate == 0) format = *header;
+        return writePos - readPos >= header->frameBytes;
+    }
+}
+
+int Mp3StreamDecoder::decodeFrame() {
+    if (!decoder) return 0;
+    Mp3FrameHeader header;
+    while (findFrame(&header)) {
+        unsigned char* in = buffer + readPos;
+        int left = header.frameBytes;
+        int result = MP3Decode((HMP3Decoder)decoder, &in, &left, pcm, 0);
+        readPos += header.frameBytes;
+
+        // The first frames may point back into a bit reservoir the stream never had
+        if (result == ERR_MP3_MAINDATA_UNDERFLOW) continue;
+        if (result != ERR_MP3_NONE) {
+            errors++;
+            continue;
+        }
+        MP3FrameInfo info;
+        MP3GetLastFrameInfo((HMP3Decoder)decoder, &info);
+        format = header;
+        format.channels = info.nChans;
+        frames++;
+        return info.outputSamps / info.nChans;
+    }
+    return 0;
+}
+
+const int16_t* Mp3StreamDecoder::samples() {
+    return pcm;
+}
+
+bool Mp3StreamDecoder::readFormat() {
+    if (format.sampleRate == 0 && buffer) {
+        Mp3FrameHeader header;
+        findFrame(&header);
+    }
+    return format.sampleRate != 0;
+}
+
+const Mp3FrameHeader& Mp3StreamDecoder::getFormat() {
+    return format;
+}
+
+size_t Mp3StreamDecoder::bufferedBytes() {
+    return writePos - readPos;
+}
+
+uint32_t Mp3StreamDecoder::bufferedMillis() {
+    if (format.bitrate == 0) return 0;
+    return (uint64_t)(writePos - readPos) * 8000 / format.bitrate;
+}
+
+uint32_t Mp3StreamDecoder::framesDecoded() {
+    return frames;
+}
+
+uint32_t Mp3StreamDecoder::decodeErrors() {
+    return errors;
+}
+
+bool Mp3StreamDecoder::parseHeader(const uint8_t* data, Mp3FrameHeader* header) {
+    if (data[0] != 0xFF || (data[1] & 0xE0) != 0xE0) return false;
+    int version = (data[1] >> 3) & 3;          // 0 MPEG-2.5, 2 MPEG-2, 3 MPEG-1
+    int layer = (data[1] >> 1) & 3;            // 1 is Layer III
+    int bitrateIndex = data[2] >> 4;
+    int rateIndex = (data[2] >> 2) & 3;
+    if (version == 1 || layer != 1 || bitrateIndex == 0 || bitrateIndex == 15 || rateIndex == 3) return false;
+
+    bool mpeg1 = version == 3;
+    header->bitrate = BITRATES[mpeg1 ? 0 : 1][bitrateIndex] * 1000;
+    header->sampleRate = SAMPLE_RATES[version][rateIndex];
+    header->samples = mpeg1 ? 1152 : 576;
+    header->frameBytes = (mpeg1 ? 144 : 72) * header->bitrate / header->sampleRate + ((data[2] >> 1) & 1);
+    header->channels = (data[3] >> 6) == 3 ? 1 : 2;
+    return true;
+}
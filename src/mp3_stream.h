@@ -0,0 +1,70 @@
+#ifndef MP3_STREAM_H
+#define MP3_STREAM_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+// Most samples one MPEG audio frame decodes to (MPEG-1 Layer III, stereo)
+#define MP3_MAX_FRAME_SAMPLES 2304
+
+// Fields of an MPEG audio Layer III frame header
+struct Mp3FrameHeader {
+    uint32_t bitrate;         // Bits per second
+    uint32_t sampleRate;
+    uint16_t frameBytes;      // Whole frame, header included
+    uint16_t samples;         // Per channel
+    uint8_t channels;
+};
+
+// Incremental MP3 decoding for streams that arrive in pieces. The compressed
+// bytes sit in a buffer (which is also the stream's jitter buffer) until a
+// whole frame is there; decodeFrame() then hands that frame to the helix
+// decoder. A leading ID3v2 tag is skipped, and bytes that are not a frame are
+// dropped until the next sync word.
+class Mp3StreamDecoder {
+private:
+    void* decoder;            // HMP3Decoder, allocated per stream
+    uint8_t* buffer;          // AUDIO_STREAM_BUFFER bytes
+    size_t readPos;
+    size_t writePos;
+    size_t tagBytesLeft;      // ID3v2 tag still to drop
+    bool started;             // Past the point where a tag can start
+    bool finished;            // No more bytes will come
+    int16_t* pcm;             // MP3_MAX_FRAME_SAMPLES
+    Mp3FrameHeader format;    // From the first frame, zeros until then
+    uint32_t frames;
+    uint32_t errors;
+
+    bool findFrame(Mp3FrameHeader* header);
+
+public:
+    Mp3StreamDecoder();
+    ~Mp3StreamDecoder();
+
+    // Get ready for a new stream; false when out of memory
+    bool begin();
+    void end();
+
+    // Compressed input
+    size_t feed(const uint8_t* data, size_t size);
+    size_t space();
+    void finish();
+
+    // Decode the next whole frame; returns the samples per channel decoded,
+    // or 0 when more input is needed (or the stream is over, once finished)
+    int decodeFrame();
+    const int16_t* samples();
+
+    // Stream format, from the latest frame; readFormat() looks at the first
+    // header without decoding and is true once the format is known
+    bool readFormat();
+    const Mp3FrameHeader& getFormat();
+    size_t bufferedBytes();
+    uint32_t bufferedMillis();
+    uint32_t framesDecoded();
+    uint32_t decodeErrors();
+
+    static bool parseHeader(const uint8_t* data, Mp3FrameHeader* header);
+};
+
+#endif // MP3_STREAM_H
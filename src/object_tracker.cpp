@@ -0,0 +1,284 @@
+#include "object_tracker.h"
+#include <cstring>
+#include <cmath>
+
+ObjectTracker objectTracker;
+
+namespace {
+
+float overlap(const ResponseRegion& a, const ResponseRegion& b) {
+    float width = min(a.x + a.width, b.x + b.width) - max(a.x, b.x);
+    float height = min(a.y + a.height, b.y + b.height) - max(a.y, b.y);
+    if (width <= 0 || height <= 0) return 0;
+    float intersection = width * height;
+    return intersection / (a.width * a.height + b.width * b.height - intersection);
+}
+
+float logSide(const ResponseRegion& box) {
+    return 0.5f * logf(max(box.width * box.height, 1e-6f));
+}
+
+} // namespace
+
+ObjectTracker::ObjectTracker() {
+    reset();
+}
+
+void ObjectTracker::reset() {
+    trackCount = 0;
+    nextId = 1;
+    memset(tracks, 0, sizeof(tracks));
+    memset(&stats, 0, sizeof(stats));
+}
+
+void ObjectTracker::predict(const KalmanAxis& axis, float dt, float processNoise, KalmanAxis* predicted) {
+    // x' = F x, P' = F P F^T + Q with white-noise acceleration
+    predicted->position = axis.position + axis.velocity * dt;
+    predicted->velocity = axis.velocity;
+    float dt2 = dt * dt;
+    predicted->p00 = axis.p00 + 2 * dt * axis.p01 + dt2 * axis.p11 + processNoise * dt2 * dt / 3;
+    predicted->p01 = axis.p01 + dt * axis.p11 + processNoise * dt2 / 2;
+    predicted->p11 = axis.p11 + processNoise * dt;
+}
+
+void ObjectTracker::measure(KalmanAxis& axis, float value, float measurementNoise) {
+    float innovation = value - axis.position;
+    float s = axis.p00 + measurementNoise * measurementNoise;
+    float k0 = axis.p00 / s;
+    float k1 = axis.p01 / s;
+    axis.position += k0 * innovation;
+    axis.velocity += k1 * innovation;
+    float p00 = axis.p00, p01 = axis.p01;
+    axis.p00 = (1 - k0) * p00;
+    axis.p01 = (1 - k0) * p01;
+    axis.p11 -= k1 * p01;
+}
+
+void ObjectTracker::startTrack(uint8_t kind, const ResponseRegion& box, unsigned long now) {
+    if (trackCount == OBJECT_MAX_TRACKS) {
+        // Full: replace the track seen least recently
+        int oldest = 0;
+        for (int i = 1; i < trackCount; i++) {
+            if (tracks[i].lastSeen < tracks[oldest].lastSeen) oldest = i;
+        }
+        tracks[oldest] = tracks[--trackCount];
+    }
+    TrackedObject& track = tracks[trackCount++];
+    memset(&track, 0, sizeof(TrackedObject));
+    track.id = nextId++;
+    if (nextId == 0) nextId = 1;
+    track.kind = kind;
+    float velocityVariance = OBJECT_INITIAL_VELOCITY * OBJECT_INITIAL_VELOCITY;
+    track.x = { box.x + box.width / 2, 0, OBJECT_POSITION_NOISE * OBJECT_POSITION_NOISE, 0, velocityVariance };
+    track.y = { box.y + box.height / 2, 0, OBJECT_POSITION_NOISE * OBJECT_POSITION_NOISE, 0, velocityVariance };
+    track.scale = { logSide(box), 0, OBJECT_SCALE_NOISE * OBJECT_SCALE_NOISE, 0, velocityVariance };
+    track.box = box;
+    track.hits = 1;
+    track.firstSeen = now;
+    track.lastSeen = now;
+    stats.created++;
+}
+
+void ObjectTracker::correct(TrackedObject& track, const ResponseRegion& box, unsigned long now) {
+    float dt = (now - track.lastSeen) / 1000.0f;
+    predict(track.x, dt, OBJECT_PROCESS_NOISE, &track.x);
+    predict(track.y, dt, OBJECT_PROCESS_NOISE, &track.y);
+    predict(track.scale, dt, OBJECT_PROCESS_NOISE, &track.scale);
+    measure(track.x, box.x + box.width / 2, OBJECT_POSITION_NOISE);
+    measure(track.y, box.y + box.height / 2, OBJECT_POSITION_NOISE);
+    measure(track.scale, logSide(box), OBJECT_SCALE_NOISE);
+    track.box = box;
+    track.hits++;
+    track.misses = 0;
+    track.lastSeen = now;
+    stats.matched++;
+}
+
+void ObjectTracker::update(uint8_t kind, const ResponseRegion* boxes, int count, unsigned long now, uint16_t* ids) {
+    unsigned long startTime = micros();
+    count = min(count, API_MAX_REGIONS);
+    stats.updates++;
+    stats.boxes += count;
+
+    // Predicted box of every track of this kind at `now`
+    int candidates[OBJECT_MAX_TRACKS];
+    ResponseRegion predicted[OBJECT_MAX_TRACKS];
+    int candidateCount = 0;
+    for (int i = 0; i < trackCount; i++) {
+        const TrackedObject& track = tracks[i];
+        if (track.kind != kind) continue;
+        float dt = (now - track.lastSeen) / 1000.0f;
+        float aspect = sqrtf(track.box.width / max(track.box.height, 1e-6f));
+        float side = expf(track.scale.position + track.scale.velocity * dt);
+        ResponseRegion& box = predicted[candidateCount];
+        box.width = side * aspect;
+        box.height = side / aspect;
+        box.x = track.x.position + track.x.velocity * dt - box.width / 2;
+        box.y = track.y.position + track.y.velocity * dt - box.height / 2;
+        candidates[candidateCount++] = i;
+    }
+
+    // Association score per pair: IoU above the minimum, else closeness of centres
+    float scores[OBJECT_MAX_TRACKS][API_MAX_REGIONS];
+    for (int c = 0; c < candidateCount; c++) {
+        const ResponseRegion& a = predicted[c];
+        for (int b = 0; b < count; b++) {
+            const ResponseRegion& box = boxes[b];
+            float iou = overlap(a, box);
+            float dx = (a.x + a.width / 2) - (box.x + box.width / 2);
+            float dy = (a.y + a.height / 2) - (box.y + box.height / 2);
+            float distance = sqrtf(dx * dx + dy * dy);
+            if (iou >= OBJECT_MIN_IOU) {
+                scores[c][b] = 1 + iou;
+            } else if (distance <= OBJECT_MAX_CENTROID_DISTANCE) {
+                scores[c][b] = 1 - distance / OBJECT_MAX_CENTROID_DISTANCE;
+            } else {
+                scores[c][b] = -1;
+            }
+        }
+    }
+
+    // Greedy: best remaining pair first
+    int trackOfBox[API_MAX_REGIONS];
+    bool candidateUsed[OBJECT_MAX_TRACKS];
+    memset(candidateUsed, 0, sizeof(candidateUsed));
+    for (int b = 0; b < count; b++) trackOfBox[b] = -1;
+    while (true) {
+        int bestCandidate = -1, bestBox = -1;
+        float bestScore = 0;
+        for (int c = 0; c < candidateCount; c++) {
+            if (candidateUsed[c]) continue;
+            for (int b = 0; b < count; b++) {
+                if (trackOfBox[b] < 0 && scores[c][b] >= bestScore) {
+                    bestScore = scores[c][b];
+                    bestCandidate = c;
+                    bestBox = b;
+                }
+            }
+        }
+        if (bestCandidate < 0) break;
+        candidateUsed[bestCandidate] = true;
+        trackOfBox[bestBox] = candidates[bestCandidate];
+    }
+
+    // Misses first, while track indices are still those of the candidates
+    for (int c = 0; c < candidateCount; c++) {
+        if (!candidateUsed[c]) tracks[candidates[c]].misses++;
+    }
+    for (int b = 0; b < count; b++) {
+        if (trackOfBox[b] >= 0) {
+            correct(tracks[trackOfBox[b]], boxes[b], now);
+            if (ids) ids[b] = tracks[trackOfBox[b]].id;
+        }
+    }
+
+    // Drop lost tracks, then start tracks for unmatched boxes
+    int kept = 0;
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].misses > OBJECT_MAX_MISSES) continue;
+        if (kept != i) tracks[kept] = tracks[i];
+        kept++;
+    }
+    trackCount = kept;
+    for (int b = 0; b < count; b++) {
+        if (trackOfBox[b] >= 0) continue;
+        startTrack(kind, boxes[b], now);
+        if (ids) ids[b] = tracks[trackCount - 1].id;
+    }
+
+    unsigned long elapsed = micros() - startTime;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+}
+
+TrackedObject* ObjectTracker::find(const ResponseRegion& box) {
+    for (int i = 0; i < trackCount; i++) {
+        const ResponseRegion& last = tracks[i].box;
+        if (tracks[i].misses == 0 && tracks[i].kind == box.kind && last.x == box.x && last.y == box.y &&
+            last.width == box.width && last.height == box.height) {
+            return &tracks[i];
+        }
+    }
+    return nullptr;
+}
+
+TrackedObject* ObjectTracker::findById(uint16_t id) {
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].id == id) return &tracks[i];
+    }
+    return nullptr;
+}
+
+ObjectMotion ObjectTracker::motion(const TrackedObject& track) {
+    ObjectMotion result = { 0, 0, track.x.velocity, track.y.velocity };
+    if (track.hits < OBJECT_MIN_HITS) {
+        return result;
+    }
+    // The box side grows as 1 / distance, so its log grows at 1 / time to contact
+    if (track.scale.velocity > 0.01f) {
+        result.timeToContact = 1.0f / track.scale.velocity;
+    }
+    float exitTime = 0;
+    const KalmanAxis* axes[2] = { &track.x, &track.y };
+    for (int i = 0; i < 2; i++) {
+        const KalmanAxis& axis = *axes[i];
+        float t = 0;
+        if (axis.velocity > 0.001f) t = (1 - axis.position) / axis.velocity;
+        else if (axis.velocity < -0.001f) t = axis.position / -axis.velocity;
+        if (t > 0 && (exitTime == 0 || t < exitTime)) exitTime = t;
+    }
+    result.timeToExit = exitTime;
+    return result;
+}
+
+bool ObjectTracker::needsFollowUp(const ResponseRegion& box) {
+    const TrackedObject* track = find(box);
+    if (!track || !track->queried) return true;
+    // Side grown enough since it was read that a new reading may be better
+    return track->scale.position - track->queriedScale >= logf(OBJECT_REQUERY_GROWTH);
+}
+
+void ObjectTracker::markQueried(const ResponseRegion& box) {
+    TrackedObject* track = find(box);
+    if (!track) return;
+    track->queried = true;
+    track->queriedScale = track->scale.position;
+}
+
+TrackedObject* ObjectTracker::nextApproaching(unsigned long now) {
+    for (int i = 0; i < trackCount; i++) {
+        TrackedObject& track = tracks[i];
+        if (track.kind != REGION_HAZARD || track.approachAnnounced || track.lastSeen != now) continue;
+        ObjectMotion m = motion(track);
+        if (m.timeToContact > 0 && m.timeToContact < OBJECT_APPROACH_TTC) {
+            track.approachAnnounced = true;
+            stats.approaching++;
+            return &track;
+        }
+    }
+    return nullptr;
+}
+
+int ObjectTracker::trackCountOf(uint8_t kind) {
+    int count = 0;
+    for (int i = 0; i < trackCount; i++) {
+        if (tracks[i].kind == kind) count++;
+    }
+    return count;
+}
+
+void ObjectTracker::recordSkippedFollowUp() {
+    stats.followUpsSkipped++;
+}
+
+ObjectTrackerStats ObjectTracker::getStats() {
+    return stats;
+}
+
+void ObjectTracker::logStats() {
+    if (stats.updates == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.updates);
+    Serial.printf("Objects: %u boxes, %u matched, %u IDs, %u approaching, %u follow-ups skipped, avg %lu us, last %lu us\n",
+                  stats.boxes, stats.matched, stats.created, stats.approaching, stats.followUpsSkipped,
+                  avgMicros, stats.lastMicros);
+}
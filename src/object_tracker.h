@@ -0,0 +1,101 @@
+#ifndef OBJECT_TRACKER_H
+#define OBJECT_TRACKER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+// Constant-velocity Kalman filter of one coordinate
+struct KalmanAxis {
+    float position;
+    float velocity;           // Per second
+    float p00, p01, p11;      // Covariance
+};
+
+struct TrackedObject {
+    uint16_t id;              // Stable across frames, never 0
+    uint8_t kind;             // CASCADE_TEXT, CASCADE_SIGN or REGION_HAZARD
+    KalmanAxis x;             // Box centre, fraction of the frame
+    KalmanAxis y;
+    KalmanAxis scale;         // log of the box side (half log of its area)
+    ResponseRegion box;       // Box as last reported
+    uint16_t hits;
+    uint8_t misses;           // Consecutive updates of its kind without it
+    bool approachAnnounced;
+    bool queried;             // A follow-up request already covered it
+    float queriedScale;       // scale.position at that follow-up
+    unsigned long firstSeen;
+    unsigned long lastSeen;
+};
+
+struct ObjectMotion {
+    float timeToContact;      // Seconds until it fills the view, 0 when not approaching
+    float timeToExit;         // Seconds until its centre leaves the frame, 0 when not leaving
+    float velocityX;          // Fractions of the frame per second
+    float velocityY;
+};
+
+struct ObjectTrackerStats {
+    uint32_t updates;
+    uint32_t boxes;
+    uint32_t created;         // New IDs handed out
+    uint32_t matched;         // Boxes associated with an existing track
+    uint32_t approaching;     // Approach announcements
+    uint32_t followUpsSkipped;
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// Multi-object tracker over the boxes reported by the cloud. Each update takes
+// the boxes of one kind from one response. They are matched greedily to the
+// Kalman-predicted boxes of that kind: by IoU, or by centre distance when the
+// boxes no longer overlap after a long capture interval. Each object keeps a
+// stable ID. Independent constant-velocity filters on the centre and log scale
+// smooth the boxes and give the object's motion: a growing scale means it is
+// approaching (time to contact is 1 / growth rate), and centre velocity gives
+// the time until it leaves the view.
+class ObjectTracker {
+private:
+    TrackedObject tracks[OBJECT_MAX_TRACKS];
+    int trackCount;
+    uint16_t nextId;
+    ObjectTrackerStats stats;
+
+    void startTrack(uint8_t kind, const ResponseRegion& box, unsigned long now);
+    void correct(TrackedObject& track, const ResponseRegion& box, unsigned long now);
+    static void predict(const KalmanAxis& axis, float dt, float processNoise, KalmanAxis* predicted);
+    static void measure(KalmanAxis& axis, float value, float measurementNoise);
+
+public:
+    ObjectTracker();
+
+    // Boxes of `kind` from one response; `ids` (optional) receives the track ID of
+    // each box. Tracks of that kind without a box count a miss.
+    void update(uint8_t kind, const ResponseRegion* boxes, int count, unsigned long now, uint16_t* ids = nullptr);
+
+    // Track whose last box is `box`, nullptr if none
+    TrackedObject* find(const ResponseRegion& box);
+    TrackedObject* findById(uint16_t id);
+    ObjectMotion motion(const TrackedObject& track);
+
+    // Follow-up bookkeeping: a queried object is not queried again until it
+    // has grown by OBJECT_REQUERY_GROWTH (closer, so easier to read)
+    bool needsFollowUp(const ResponseRegion& box);
+    void markQueried(const ResponseRegion& box);
+
+    // Hazard tracks approaching with less than OBJECT_APPROACH_TTC to contact,
+    // each returned once
+    TrackedObject* nextApproaching(unsigned long now);
+
+    int trackCountOf(uint8_t kind);
+    void reset();
+
+    // Statistics
+    void recordSkippedFollowUp();
+    ObjectTrackerStats getStats();
+    void logStats();
+};
+
+// Global object tracker instance
+extern ObjectTracker objectTracker;
+
+#endif // OBJECT_TRACKER_H
@@ -0,0 +1,543 @@
+#include "ocr_preprocessor.h"
+#include "jpeg_transcoder.h"
+#include <cstring>
+
+OcrPreprocessor ocrPreprocessor;
+
+namespace {
+
+// ITU T.4 modified Huffman run-length codes (code value, length in bits)
+struct RunCode {
+    uint16_t code;
+    uint8_t length;
+};
+
+const RunCode kWhiteTerminating[64] = {
+    { 0x035,  8 }, { 0x007,  6 }, { 0x007,  4 }, { 0x008,  4 },
+    { 0x00B,  4 }, { 0x00C,  4 }, { 0x00E,  4 }, { 0x00F,  4 },
+    { 0x013,  5 }, { 0x014,  5 }, { 0x007,  5 }, { 0x008,  5 },
+    { 0x008,  6 }, { 0x003,  6 }, { 0x034,  6 }, { 0x035,  6 },
+    { 0x02A,  6 }, { 0x02B,  6 }, { 0x027,  7 }, { 0x00C,  7 },
+    { 0x008,  7 }, { 0x017,  7 }, { 0x003,  7 }, { 0x004,  7 },
+    { 0x028,  7 }, { 0x02B,  7 }, { 0x013,  7 }, { 0x024,  7 },
+    { 0x018,  7 }, { 0x002,  8 }, { 0x003,  8 }, { 0x01A,  8 },
+    { 0x01B,  8 }, { 0x012,  8 }, { 0x013,  8 }, { 0x014,  8 },
+    { 0x015,  8 }, { 0x016,  8 }, { 0x017,  8 }, { 0x028,  8 },
+    { 0x029,  8 }, { 0x02A,  8 }, { 0x02B,  8 }, { 0x02C,  8 },
+    { 0x02D,  8 }, { 0x004,  8 }, { 0x005,  8 }, { 0x00A,  8 },
+    { 0x00B,  8 }, { 0x052,  8 }, { 0x053,  8 }, { 0x054,  8 },
+    { 0x055,  8 }, { 0x024,  8 }, { 0x025,  8 }, { 0x058,  8 },
+    { 0x059,  8 }, { 0x05A,  8 }, { 0x05B,  8 }, { 0x04A,  8 },
+    { 0x04B,  8 }, { 0x032,  8 }, { 0x033,  8 }, { 0x034,  8 }
+};
+
+// Runs of 64..1728 in steps of 64
+const RunCode kWhiteMakeup[27] = {
+    { 0x01B,  5 }, { 0x012,  5 }, { 0x017,  6 }, { 0x037,  7 },
+    { 0x036,  8 }, { 0x037,  8 }, { 0x064,  8 }, { 0x065,  8 },
+    { 0x068,  8 }, { 0x067,  8 }, { 0x0CC,  9 }, { 0x0CD,  9 },
+    { 0x0D2,  9 }, { 0x0D3,  9 }, { 0x0D4,  9 }, { 0x0D5,  9 },
+    { 0x0D6,  9 }, { 0x0D7,  9 }, { 0x0D8,  9 }, { 0x0D9,  9 },
+    { 0x0DA,  9 }, { 0x0DB,  9 }, { 0x098,  9 }, { 0x099,  9 },
+    { 0x09A,  9 }, { 0x018,  6 }, { 0x09B,  9 }
+};
+
+const RunCode kBlackTerminating[64] = {
+    { 0x037, 10 }, { 0x002,  3 }, { 0x003,  2 }, { 0x002,  2 },
+    { 0x003,  3 }, { 0x003,  4 }, { 0x002,  4 }, { 0x003,  5 },
+    { 0x005,  6 }, { 0x004,  6 }, { 0x004,  7 }, { 0x005,  7 },
+    { 0x007,  7 }, { 0x004,  8 }, { 0x007,  8 }, { 0x018,  9 },
+    { 0x017, 10 }, { 0x018, 10 }, { 0x008, 10 }, { 0x067, 11 },
+    { 0x068, 11 }, { 0x06C, 11 }, { 0x037, 11 }, { 0x028, 11 },
+    { 0x017, 11 }, { 0x018, 11 }, { 0x0CA, 12 }, { 0x0CB, 12 },
+    { 0x0CC, 12 }, { 0x0CD, 12 }, { 0x068, 12 }, { 0x069, 12 },
+    { 0x06A, 12 }, { 0x06B, 12 }, { 0x0D2, 12 }, { 0x0D3, 12 },
+    { 0x0D4, 12 }, { 0x0D5, 12 }, { 0x0D6, 12 }, { 0x0D7, 12 },
+    { 0x06C, 12 }, { 0x06D, 12 }, { 0x0DA, 12 }, { 0x0DB, 12 },
+    { 0x054, 12 }, { 0x055, 12 }, { 0x056, 12 }, { 0x057, 12 },
+    { 0x064, 12 }, { 0x065, 12 }, { 0x052, 12 }, { 0x053, 12 },
+    { 0x024, 12 }, { 0x037, 12 }, { 0x038, 12 }, { 0x027, 12 },
+    { 0x028, 12 }, { 0x058, 12 }, { 0x059, 12 }, { 0x02B, 12 },
+    { 0x02C, 12 }, { 0x05A, 12 }, { 0x066, 12 }, { 0x067, 12 }
+};
+
+const RunCode kBlackMakeup[27] = {
+    { 0x00F, 10 }, { 0x0C8, 12 }, { 0x0C9, 12 }, { 0x05B, 12 },
+    { 0x033, 12 }, { 0x034, 12 }, { 0x035, 12 }, { 0x06C, 13 },
+    { 0x06D, 13 }, { 0x04A, 13 }, { 0x04B, 13 }, { 0x04C, 13 },
+    { 0x04D, 13 }, { 0x072, 13 }, { 0x073, 13 }, { 0x074, 13 },
+    { 0x075, 13 }, { 0x076, 13 }, { 0x077, 13 }, { 0x052, 13 },
+    { 0x053, 13 }, { 0x054, 13 }, { 0x055, 13 }, { 0x05A, 13 },
+    { 0x05B, 13 }, { 0x064, 13 }, { 0x065, 13 }
+};
+
+// Runs of 1792..2560, shared by both colours
+const RunCode kExtendedMakeup[13] = {
+    { 0x008, 11 }, { 0x00C, 11 }, { 0x00D, 11 }, { 0x012, 12 },
+    { 0x013, 12 }, { 0x014, 12 }, { 0x015, 12 }, { 0x016, 12 },
+    { 0x017, 12 }, { 0x01C, 12 }, { 0x01D, 12 }, { 0x01E, 12 },
+    { 0x01F, 12 }
+};
+
+// Two-dimensional mode codes (ITU T.6)
+const RunCode kPassCode = { 0x1, 4 };         // 0001
+const RunCode kHorizontalCode = { 0x1, 3 };   // 001
+const RunCode kVerticalCodes[7] = {           // Indexed by b1 - a1 + 3
+    { 0x03, 7 }, { 0x03, 6 }, { 0x03, 3 }, { 0x1, 1 }, { 0x2, 3 }, { 0x02, 6 }, { 0x02, 7 }
+};
+
+// MSB-first bit writer into a growable malloc() buffer
+struct BitWriter {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    uint32_t accumulator;
+    int accumulatedBits;
+    bool failed;
+
+    bool begin(size_t initial) {
+        data = (uint8_t*)malloc(initial);
+        size = 0;
+        capacity = data ? initial : 0;
+        accumulator = 0;
+        accumulatedBits = 0;
+        failed = data == nullptr;
+        return !failed;
+    }
+
+    void putByte(uint8_t byte) {
+        if (size >= capacity) {
+            size_t newCapacity = capacity * 3 / 2 + 1024;
+            uint8_t* grown = failed ? nullptr : (uint8_t*)realloc(data, newCapacity);
+            if (!grown) {
+                failed = true;
+                return;
+            }
+            data = grown;
+            capacity = newCapacity;
+        }
+        data[size++] = byte;
+    }
+
+    inline void putBits(uint32_t value, int count) {
+        accumulator = (accumulator << count) | (value & ((1u << count) - 1));
+        accumulatedBits += count;
+        while (accumulatedBits >= 8) {
+            putByte((accumulator >> (accumulatedBits - 8)) & 0xFF);
+            accumulatedBits -= 8;
+        }
+    }
+
+    inline void putCode(const RunCode& code) {
+        putBits(code.code, code.length);
+    }
+
+    void putRun(int run, bool black) {
+        const RunCode* terminating = black ? kBlackTerminating : kWhiteTerminating;
+        const RunCode* makeup = black ? kBlackMakeup : kWhiteMakeup;
+        while (run >= 2560) {
+            putCode(kExtendedMakeup[12]);
+            run -= 2560;
+        }
+        if (run >= 1792) {
+            putCode(kExtendedMakeup[(run - 1792) / 64]);
+            run %= 64;
+        } else if (run >= 64) {
+            putCode(makeup[run / 64 - 1]);
+            run %= 64;
+        }
+        putCode(terminating[run]);
+    }
+
+    void flush() {
+        if (accumulatedBits > 0) putBits(0, 8 - accumulatedBits);
+    }
+};
+
+inline int pixelAt(const uint8_t* row, int x) {
+    return (row[x >> 3] >> (7 - (x & 7))) & 1;
+}
+
+// First position >= start whose pixel is not `color`, or width. Whole bytes of
+// `color` are skipped eight pixels at a time.
+int findChange(const uint8_t* row, int start, int width, int color) {
+    int x = start;
+    uint8_t skip = color ? 0xFF : 0x00;
+    while (x < width && (x & 7)) {
+        if (pixelAt(row, x) != color) return x;
+        x++;
+    }
+    while (x + 8 <= width && row[x >> 3] == skip) x += 8;
+    while (x < width && pixelAt(row, x) == color) x++;
+    return x < width ? x : width;
+}
+
+inline int findChangeFrom(const uint8_t* row, int start, int width, int color) {
+    return start < width ? findChange(row, start, width, color) : width;
+}
+
+// Encode one row against the reference row (ITU T.6 two-dimensional coding)
+void encodeG4Row(BitWriter& out, const uint8_t* row, const uint8_t* reference, int width) {
+    int a0 = 0;
+    int a1 = pixelAt(row, 0) ? 0 : findChange(row, 0, width, 0);
+    int b1 = pixelAt(reference, 0) ? 0 : findChange(reference, 0, width, 0);
+
+    while (true) {
+        int b2 = findChangeFrom(reference, b1, width, b1 < width ? pixelAt(reference, b1) : 0);
+        if (b2 >= a1) {
+            int d = b1 - a1;
+            if (d < -3 || d > 3) {
+                // Horizontal mode: two runs coded explicitly
+                int a2 = findChangeFrom(row, a1, width, a1 < width ? pixelAt(row, a1) : 0);
+                out.putCode(kHorizontalCode);
+                if (a0 + a1 == 0 || pixelAt(row, a0) == 0) {
+                    out.putRun(a1 - a0, false);
+                    out.putRun(a2 - a1, true);
+                } else {
+                    out.putRun(a1 - a0, true);
+                    out.putRun(a2 - a1, false);
+                }
+                a0 = a2;
+            } else {
+                out.putCode(kVerticalCodes[d + 3]);
+                a0 = a1;
+            }
+        } else {
+            out.putCode(kPassCode);
+            a0 = b2;
+        }
+        if (a0 >= width) break;
+
+        int color = pixelAt(row, a0);
+        a1 = findChange(row, a0, width, color);
+        b1 = findChange(reference, a0, width, !color);
+        b1 = findChangeFrom(reference, b1, width, color);
+    }
+}
+
+void put16(uint8_t* p, uint16_t value) {
+    p[0] = value & 0xFF;
+    p[1] = value >> 8;
+}
+
+void put32(uint8_t* p, uint32_t value) {
+    put16(p, value & 0xFFFF);
+    put16(p + 2, value >> 16);
+}
+
+void putTiffEntry(uint8_t* p, uint16_t tag, uint16_t type, uint32_t value) {
+    put16(p, tag);
+    put16(p + 2, type);
+    put32(p + 4, 1);
+    if (type == 3) {
+        put16(p + 8, value);
+        put16(p + 10, 0);
+    } else {
+        put32(p + 8, value);
+    }
+}
+
+const int TIFF_ENTRY_COUNT = 8;
+const int TIFF_HEADER_SIZE = 8 + 2 + TIFF_ENTRY_COUNT * 12 + 4;
+
+// Sauvola dynamic range of the standard deviation
+const float SAUVOLA_RANGE = 128.0;
+
+} // namespace
+
+OcrPreprocessor::OcrPreprocessor() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool OcrPreprocessor::process(const uint8_t* jpeg, size_t length, uint8_t** output, size_t* outputSize) {
+    unsigned long startTime = micros();
+    *output = nullptr;
+    *outputSize = 0;
+
+    JpegPlane luma;
+    BilevelImage image = { nullptr, 0, 0, 0 };
+    BilevelImage rotated = { nullptr, 0, 0, 0 };
+    bool success = false;
+
+    do {
+        if (!jpegTranscoder.decodePlanes(jpeg, length, JPEG_SCALE_FULL, &luma, 1)) {
+            break;
+        }
+        bool binarized = binarize(luma.data, luma.width, luma.height, luma.stride, &image);
+        free(luma.data);
+        if (!binarized) break;
+
+        float skew = estimateSkew(image);
+        stats.lastSkewDegrees = skew;
+        if (fabsf(skew) >= OCR_MIN_DESKEW_DEGREES) {
+            if (rotate(image, skew, &rotated)) {
+                free(image.bits);
+                image = rotated;
+            }
+        }
+
+        success = encodeTiffG4(image, output, outputSize);
+    } while (false);
+
+    if (image.bits) free(image.bits);
+
+    unsigned long elapsed = micros() - startTime;
+    stats.lastMicros = elapsed;
+    if (success) {
+        stats.images++;
+        stats.bytesIn += length;
+        stats.bytesOut += *outputSize;
+        stats.totalMicros += elapsed;
+        Serial.printf("OCR bilevel: %u -> %u bytes, skew %.1f deg, %lu us\n",
+                      (unsigned)length, (unsigned)*outputSize, stats.lastSkewDegrees, elapsed);
+    } else {
+        stats.failures++;
+        Serial.println("OCR pre-processing failed");
+    }
+    return success;
+}
+
+bool OcrPreprocessor::binarize(const uint8_t* gray, int width, int height, int stride, BilevelImage* image) {
+    image->width = width;
+    image->height = height;
+    image->stride = (width + 7) / 8;
+    image->bits = (uint8_t*)calloc(image->stride * height, 1);
+
+    // Column sums over the vertical window, updated one row at a time
+    uint32_t* columnSum = (uint32_t*)malloc(width * sizeof(uint32_t));
+    uint32_t* columnSquares = (uint32_t*)malloc(width * sizeof(uint32_t));
+    if (!image->bits || !columnSum || !columnSquares) {
+        if (image->bits) free(image->bits);
+        if (columnSum) free(columnSum);
+        if (columnSquares) free(columnSquares);
+        image->bits = nullptr;
+        Serial.println("OCR binarize: out of memory");
+        return false;
+    }
+
+    const int radius = OCR_THRESHOLD_RADIUS;
+    const float minVariance = (float)OCR_MIN_CONTRAST * OCR_MIN_CONTRAST;
+    memset(columnSum, 0, width * sizeof(uint32_t));
+    memset(columnSquares, 0, width * sizeof(uint32_t));
+    for (int y = 0; y <= radius && y < height; y++) {
+        const uint8_t* row = gray + y * stride;
+        for (int x = 0; x < width; x++) {
+            columnSum[x] += row[x];
+            columnSquares[x] += row[x] * row[x];
+        }
+    }
+
+    for (int y = 0; y < height; y++) {
+        if (y > 0) {
+            int enter = y + radius;
+            int leave = y - radius - 1;
+            if (enter < height) {
+                const uint8_t* row = gray + enter * stride;
+                for (int x = 0; x < width; x++) {
+                    columnSum[x] += row[x];
+                    columnSquares[x] += row[x] * row[x];
+                }
+            }
+            if (leave >= 0) {
+                const uint8_t* row = gray + leave * stride;
+                for (int x = 0; x < width; x++) {
+                    columnSum[x] -= row[x];
+                    columnSquares[x] -= row[x] * row[x];
+                }
+            }
+        }
+        int rows = min(height - 1, y + radius) - max(0, y - radius) + 1;
+
+        uint32_t sum = 0;
+        uint32_t squares = 0;
+        for (int x = 0; x <= radius && x < width; x++) {
+            sum += columnSum[x];
+            squares += columnSquares[x];
+        }
+
+        const uint8_t* row = gray + y * stride;
+        uint8_t* out = image->bits + y * image->stride;
+        uint8_t packed = 0;
+        for (int x = 0; x < width; x++) {
+            if (x > 0) {
+                if (x + radius < width) {
+                    sum += columnSum[x + radius];
+                    squares += columnSquares[x + radius];
+                }
+                if (x - radius - 1 >= 0) {
+                    sum -= columnSum[x - radius - 1];
+                    squares -= columnSquares[x - radius - 1];
+                }
+            }
+            int columns = min(width - 1, x + radius) - max(0, x - radius) + 1;
+            float n = (float)(columns * rows);
+            float mean = sum / n;
+            float variance = squares / n - mean * mean;
+
+            // Flat regions are background; elsewhere the threshold follows local mean and contrast
+            bool black = false;
+            if (variance > minVariance) {
+                float threshold = mean * (1.0f + OCR_THRESHOLD_K * (sqrtf(variance) / SAUVOLA_RANGE - 1.0f));
+                black = row[x] < threshold;
+            }
+            packed = (packed << 1) | (black ? 1 : 0);
+            if ((x & 7) == 7) {
+                out[x >> 3] = packed;
+                packed = 0;
+            }
+        }
+        if (width & 7) {
+            out[width >> 3] = packed << (8 - (width & 7));
+        }
+    }
+
+    free(columnSum);
+    free(columnSquares);
+    return true;
+}
+
+float OcrPreprocessor::estimateSkew(const BilevelImage& image) {
+    // Text lines give the sharpest horizontal projection profile at their own angle
+    // Every other row is sampled, so bins span two rows to keep all angles on an equal footing
+    int maxOffset = (int)(image.width * tanf(OCR_MAX_SKEW_DEGREES * M_PI / 180.0f)) + 1;
+    int bins = (image.height + 2 * maxOffset) / 2 + 1;
+    uint32_t* profile = (uint32_t*)malloc(bins * sizeof(uint32_t));
+    if (!profile) return 0;
+
+    float bestAngle = 0;
+    uint64_t bestScore = 0;
+    float step = 0.5;
+    float low = -OCR_MAX_SKEW_DEGREES;
+    float high = OCR_MAX_SKEW_DEGREES;
+
+    // Coarse sweep, then a finer one around the best coarse angle
+    for (int round = 0; round < 2; round++) {
+        for (float angle = low; angle <= high + 0.001f; angle += step) {
+            float slope = tanf(angle * M_PI / 180.0f);
+            memset(profile, 0, bins * sizeof(uint32_t));
+            for (int y = 0; y < image.height; y += 2) {
+                const uint8_t* row = image.bits + y * image.stride;
+                for (int xb = 0; xb < image.stride; xb++) {
+                    if (!row[xb]) continue;
+                    for (int bit = 0; bit < 8; bit++) {
+                        if (!(row[xb] & (0x80 >> bit))) continue;
+                        int x = xb * 8 + bit;
+                        int bin = (y - (int)lroundf(x * slope) + maxOffset) >> 1;
+                        if (bin >= 0 && bin < bins) profile[bin]++;
+                    }
+                }
+            }
+            uint64_t score = 0;
+            for (int i = 0; i < bins; i++) {
+                score += (uint64_t)profile[i] * profile[i];
+            }
+            if (score > bestScore) {
+                bestScore = score;
+                bestAngle = angle;
+            }
+        }
+        low = bestAngle - step;
+        high = bestAngle + step;
+        step = 0.125;
+    }
+
+    free(profile);
+    return bestAngle;
+}
+
+bool OcrPreprocessor::rotate(const BilevelImage& image, float degrees, BilevelImage* rotated) {
+    rotated->width = image.width;
+    rotated->height = image.height;
+    rotated->stride = image.stride;
+    rotated->bits = (uint8_t*)calloc(image.stride * image.height, 1);
+    if (!rotated->bits) return false;
+
+    // Nearest-neighbour sampling of the source along each rotated output row, in 16.16 fixed point
+    float radians = degrees * M_PI / 180.0f;
+    int32_t cosStep = (int32_t)lroundf(cosf(radians) * 65536);
+    int32_t sinStep = (int32_t)lroundf(sinf(radians) * 65536);
+    float cx = image.width / 2.0f;
+    float cy = image.height / 2.0f;
+
+    for (int y = 0; y < image.height; y++) {
+        int32_t sx = (int32_t)lroundf((cx - cx * cosf(radians) - (y - cy) * sinf(radians)) * 65536);
+        int32_t sy = (int32_t)lroundf((cy - cx * sinf(radians) + (y - cy) * cosf(radians)) * 65536);
+        uint8_t* out = rotated->bits + y * rotated->stride;
+        for (int x = 0; x < image.width; x++, sx += cosStep, sy += sinStep) {
+            int px = (sx + 32768) >> 16;
+            int py = (sy + 32768) >> 16;
+            if (px < 0 || py < 0 || px >= image.width || py >= image.height) continue;
+            if (pixelAt(image.bits + py * image.stride, px)) {
+                out[x >> 3] |= 0x80 >> (x & 7);
+            }
+        }
+    }
+    return true;
+}
+
+bool OcrPreprocessor::encodeTiffG4(const BilevelImage& image, uint8_t** output, size_t* outputSize) {
+    BitWriter out;
+    if (!out.begin(TIFF_HEADER_SIZE + image.stride * image.height / 8 + 1024)) return false;
+
+    // Header and IFD are written up front; the strip byte count is patched in afterwards
+    for (int i = 0; i < TIFF_HEADER_SIZE; i++) out.putByte(0);
+    if (out.failed) {
+        free(out.data);
+        return false;
+    }
+
+    uint8_t* reference = (uint8_t*)calloc(image.stride, 1);  // Imaginary all-white row above the image
+    if (!reference) {
+        free(out.data);
+        return false;
+    }
+    for (int y = 0; y < image.height; y++) {
+        const uint8_t* row = image.bits + y * image.stride;
+        encodeG4Row(out, row, y > 0 ? image.bits + (y - 1) * image.stride : reference, image.width);
+    }
+    free(reference);
+
+    // End of facsimile block: two EOL codes
+    out.putBits(0x001, 12);
+    out.putBits(0x001, 12);
+    out.flush();
+    if (out.failed) {
+        if (out.data) free(out.data);
+        Serial.println("OCR G4 encode: out of memory");
+        return false;
+    }
+
+    uint8_t* header = out.data;
+    header[0] = 'I';
+    header[1] = 'I';
+    put16(header + 2, 42);
+    put32(header + 4, 8);
+    uint8_t* ifd = header + 8;
+    put16(ifd, TIFF_ENTRY_COUNT);
+    uint8_t* entry = ifd + 2;
+    putTiffEntry(entry, 256, 4, image.width);               // ImageWidth
+    putTiffEntry(entry + 12, 257, 4, image.height);         // ImageLength
+    putTiffEntry(entry + 24, 258, 3, 1);                    // BitsPerSample
+    putTiffEntry(entry + 36, 259, 3, 4);                    // Compression: CCITT T.6
+    putTiffEntry(entry + 48, 262, 3, 0);                    // Photometric: WhiteIsZero
+    putTiffEntry(entry + 60, 273, 4, TIFF_HEADER_SIZE);     // StripOffsets
+    putTiffEntry(entry + 72, 278, 4, image.height);         // RowsPerStrip
+    putTiffEntry(entry + 84, 279, 4, out.size - TIFF_HEADER_SIZE); // StripByteCounts
+    put32(entry + 96, 0);                                   // No further IFDs
+
+    *output = out.data;
+    *outputSize = out.size;
+    return true;
+}
+
+OcrPreprocessStats OcrPreprocessor::getStats() {
+    return stats;
+}
+
+void OcrPreprocessor::logStats() {
+    if (stats.images == 0 && stats.failures == 0) return;
+    unsigned long avgMicros = stats.images > 0 ? (unsigned long)(stats.totalMicros / stats.images) : 0;
+    float ratio = stats.bytesOut > 0 ? (float)stats.bytesIn / stats.bytesOut : 0;
+    Serial.printf("OCR bilevel: %u images (%u failed), %.1fx smaller than JPEG, avg %lu us\n",
+                  stats.images, stats.failures, ratio, avgMicros);
+}
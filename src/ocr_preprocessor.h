@@ -0,0 +1,55 @@
+#ifndef OCR_PREPROCESSOR_H
+#define OCR_PREPROCESSOR_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+// Upload format tag for bilevel OCR images
+#define OCR_FORMAT_TIFF_G4  "tiff-g4"
+
+// 1-bit image, rows packed MSB first, 1 = black
+struct BilevelImage {
+    uint8_t* bits;            // Allocated with malloc()
+    uint16_t width;
+    uint16_t height;
+    uint16_t stride;          // Bytes per row
+};
+
+struct OcrPreprocessStats {
+    uint32_t images;
+    uint32_t failures;
+    uint64_t bytesIn;         // Source JPEG bytes
+    uint64_t bytesOut;        // TIFF G4 bytes
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+    float lastSkewDegrees;
+};
+
+// Turns a captured JPEG into a deskewed bilevel TIFF (CCITT Group 4) for OCR upload.
+// Luma is decoded straight from the JPEG, thresholded against local mean and
+// contrast (Sauvola), deskewed by projection profile and G4 encoded.
+class OcrPreprocessor {
+private:
+    OcrPreprocessStats stats;
+
+public:
+    OcrPreprocessor();
+
+    // Full pipeline; output is allocated with malloc() and must be freed by the caller
+    bool process(const uint8_t* jpeg, size_t length, uint8_t** output, size_t* outputSize);
+
+    // Individual stages
+    bool binarize(const uint8_t* gray, int width, int height, int stride, BilevelImage* image);
+    float estimateSkew(const BilevelImage& image);
+    bool rotate(const BilevelImage& image, float degrees, BilevelImage* rotated);
+    bool encodeTiffG4(const BilevelImage& image, uint8_t** output, size_t* outputSize);
+
+    // Statistics
+    OcrPreprocessStats getStats();
+    void logStats();
+};
+
+// Global OCR pre-processor instance
+extern OcrPreprocessor ocrPreprocessor;
+
+#endif // OCR_PREPROCESSOR_H
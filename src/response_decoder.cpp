@@ -0,0 +1,311 @@
+#include "response_decoder.h"
+#include <cstring>
+#include <cmath>
+
+ResponseDecoder responseDecoder;
+
+namespace {
+
+enum CborMajor {
+    CBOR_UINT,
+    CBOR_NEGATIVE,
+    CBOR_BYTES,
+    CBOR_TEXT,
+    CBOR_ARRAY,
+    CBOR_MAP,
+    CBOR_TAG,
+    CBOR_SIMPLE
+};
+
+enum ResponseKey {
+    KEY_VERSION,
+    KEY_SUCCESS,
+    KEY_TEXT,
+    KEY_ERROR,
+    KEY_CONFIDENCE,
+    KEY_HAZARD_TYPE,
+    KEY_DIRECTION,
+    KEY_DISTANCE,
+    KEY_TASK_CONFIDENCE,
+    KEY_REGIONS,
+    KEY_AUDIO
+};
+
+struct CborReader {
+    const uint8_t* data;
+    const uint8_t* end;
+};
+
+// Initial byte and argument of the next item. For simple values and floats
+// the argument is the raw value or bit pattern.
+bool readHead(CborReader& reader, uint8_t* major, uint8_t* info, uint64_t* argument) {
+    if (reader.data >= reader.end) return false;
+    uint8_t initial = *reader.data++;
+    *major = initial >> 5;
+    *info = initial & 0x1F;
+    int size;
+    if (*info < 24) {
+        *argument = *info;
+        return true;
+    } else if (*info <= 27) {
+        size = 1 << (*info - 24);
+    } else {
+        return false;  // Reserved, or indefinite length
+    }
+    if (reader.end - reader.data < size) return false;
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value = (value << 8) | *reader.data++;
+    }
+    *argument = value;
+    return true;
+}
+
+float halfToFloat(uint16_t half) {
+    int exponent = (half >> 10) & 0x1F;
+    int mantissa = half & 0x3FF;
+    float value;
+    if (exponent == 0) {
+        value = ldexpf(mantissa, -24);
+    } else if (exponent == 31) {
+        value = mantissa ? NAN : INFINITY;
+    } else {
+        value = ldexpf(mantissa + 1024, exponent - 25);
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+bool skipItem(CborReader& reader, int depth) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (depth > STRUCTURED_MAX_DEPTH || !readHead(reader, &major, &info, &argument)) return false;
+    switch (major) {
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            if ((uint64_t)(reader.end - reader.data) < argument) return false;
+            reader.data += argument;
+            return true;
+        case CBOR_ARRAY:
+        case CBOR_MAP: {
+            uint64_t items = major == CBOR_MAP ? argument * 2 : argument;
+            for (uint64_t i = 0; i < items; i++) {
+                if (!skipItem(reader, depth + 1)) return false;
+            }
+            return true;
+        }
+        case CBOR_TAG:
+            return skipItem(reader, depth + 1);
+        default:
+            return true;
+    }
+}
+
+bool readUnsigned(CborReader& reader, uint32_t* value) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (!readHead(reader, &major, &info, &argument) || major != CBOR_UINT || argument > 0xFFFFFFFF) return false;
+    *value = (uint32_t)argument;
+    return true;
+}
+
+bool readFloat(CborReader& reader, float* value) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (!readHead(reader, &major, &info, &argument)) return false;
+    if (major == CBOR_UINT) {
+        *value = (float)argument;
+    } else if (major == CBOR_NEGATIVE) {
+        *value = -1.0f - (float)argument;
+    } else if (major == CBOR_SIMPLE && info == 25) {
+        *value = halfToFloat((uint16_t)argument);
+    } else if (major == CBOR_SIMPLE && info == 26) {
+        uint32_t bits = (uint32_t)argument;
+        memcpy(value, &bits, sizeof(float));
+    } else if (major == CBOR_SIMPLE && info == 27) {
+        double wide;
+        memcpy(&wide, &argument, sizeof(double));
+        *value = (float)wide;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool readBool(CborReader& reader, bool* value) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (!readHead(reader, &major, &info, &argument) || major != CBOR_SIMPLE || (info != 20 && info != 21)) return false;
+    *value = info == 21;
+    return true;
+}
+
+// Text string into a fixed buffer, truncated on a UTF-8 character boundary
+bool readText(CborReader& reader, char* text, size_t capacity) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (!readHead(reader, &major, &info, &argument) || major != CBOR_TEXT) return false;
+    if ((uint64_t)(reader.end - reader.data) < argument) return false;
+    size_t length = min((size_t)argument, capacity - 1);
+    if (length < argument) {
+        while (length > 0 && (reader.data[length] & 0xC0) == 0x80) length--;
+    }
+    memcpy(text, reader.data, length);
+    text[length] = '\0';
+    reader.data += argument;
+    return true;
+}
+
+bool readArrayHead(CborReader& reader, uint32_t* count) {
+    uint8_t major, info;
+    uint64_t argument;
+    if (!readHead(reader, &major, &info, &argument) || major != CBOR_ARRAY || argument > 0xFFFF) return false;
+    *count = (uint32_t)argument;
+    return true;
+}
+
+bool readRegions(CborReader& reader, StructuredResult* result) {
+    uint32_t count;
+    if (!readArrayHead(reader, &count)) return false;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t fields, kind;
+        float box[4];
+        if (!readArrayHead(reader, &fields) || fields != 5 || !readUnsigned(reader, &kind)) return false;
+        for (int j = 0; j < 4; j++) {
+            if (!readFloat(reader, &box[j])) return false;
+        }
+        if (result->regionCount >= API_MAX_REGIONS || kind == 0 || kind > 255) continue;
+        ResponseRegion& region = result->regions[result->regionCount++];
+        region.kind = kind;
+        region.x = box[0];
+        region.y = box[1];
+        region.width = box[2];
+        region.height = box[3];
+    }
+    return true;
+}
+
+bool readAudio(CborReader& reader, StructuredResult* result) {
+    uint32_t fields;
+    if (!readArrayHead(reader, &fields) || fields < 3) return false;
+    if (!readText(reader, result->audioUrl, sizeof(result->audioUrl)) ||
+        !readText(reader, result->audioFormat, sizeof(result->audioFormat)) ||
+        !readUnsigned(reader, &result->audioSize)) {
+        return false;
+    }
+    for (uint32_t i = 3; i < fields; i++) {
+        if (!skipItem(reader, 1)) return false;
+    }
+    result->hasAudio = result->audioUrl[0] != '\0';
+    return true;
+}
+
+} // namespace
+
+ResponseDecoder::ResponseDecoder() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool ResponseDecoder::decode(const uint8_t* data, size_t length, StructuredResult* result) {
+    unsigned long startTime = micros();
+
+    memset(result, 0, sizeof(StructuredResult));
+    for (int i = 0; i < STRUCTURED_TASKS; i++) {
+        result->taskConfidence[i] = -1;
+    }
+    strcpy(result->audioFormat, "mp3");
+
+    CborReader reader = { data, data + length };
+    uint8_t major, info;
+    uint64_t entries;
+    bool valid = readHead(reader, &major, &info, &entries) && major == CBOR_MAP;
+    for (uint64_t i = 0; valid && i < entries; i++) {
+        uint32_t key, value = 0;
+        const uint8_t* keyStart = reader.data;
+        if (!readUnsigned(reader, &key)) {
+            // Not one of ours; skip the key and its value
+            reader.data = keyStart;
+            valid = skipItem(reader, 1) && skipItem(reader, 1);
+            continue;
+        }
+        switch (key) {
+            case KEY_VERSION:
+                valid = readUnsigned(reader, &value) && value == STRUCTURED_RESPONSE_VERSION;
+                result->version = value;
+                break;
+            case KEY_SUCCESS:
+                valid = readBool(reader, &result->success);
+                break;
+            case KEY_TEXT:
+                valid = readText(reader, result->text, sizeof(result->text));
+                break;
+            case KEY_ERROR:
+                valid = readText(reader, result->error, sizeof(result->error));
+                break;
+            case KEY_CONFIDENCE:
+                valid = readFloat(reader, &result->confidence);
+                break;
+            case KEY_HAZARD_TYPE:
+                valid = readUnsigned(reader, &value);
+                result->hazardType = value <= HAZARD_OTHER ? (uint8_t)value : (uint8_t)HAZARD_OTHER;
+                break;
+            case KEY_DIRECTION:
+                valid = readUnsigned(reader, &value);
+                result->direction = value <= 255 ? value : 0;
+                break;
+            case KEY_DISTANCE:
+                valid = readFloat(reader, &result->distance);
+                break;
+            case KEY_TASK_CONFIDENCE: {
+                uint32_t count;
+                valid = readArrayHead(reader, &count);
+                for (uint32_t t = 0; valid && t < count; t++) {
+                    float confidence;
+                    valid = readFloat(reader, &confidence);
+                    if (t < STRUCTURED_TASKS) result->taskConfidence[t] = confidence;
+                }
+                break;
+            }
+            case KEY_REGIONS:
+                valid = readRegions(reader, result);
+                break;
+            case KEY_AUDIO:
+                valid = readAudio(reader, result);
+                break;
+            default:
+                valid = skipItem(reader, 1);
+                break;
+        }
+    }
+    // A version is required, so a stray JSON or HTML body never passes
+    valid = valid && result->version == STRUCTURED_RESPONSE_VERSION;
+
+    unsigned long elapsed = micros() - startTime;
+    if (valid) {
+        stats.cborResponses++;
+        stats.cborBytes += length;
+        stats.cborMicros += elapsed;
+    } else {
+        stats.failures++;
+    }
+    return valid;
+}
+
+void ResponseDecoder::recordJson(size_t bytes, unsigned long micros) {
+    stats.jsonResponses++;
+    stats.jsonBytes += bytes;
+    stats.jsonMicros += micros;
+}
+
+ResponseDecoderStats ResponseDecoder::getStats() {
+    return stats;
+}
+
+void ResponseDecoder::logStats() {
+    if (stats.cborResponses == 0 && stats.jsonResponses == 0 && stats.failures == 0) return;
+    uint32_t cbor = max(stats.cborResponses, (uint32_t)1);
+    uint32_t json = max(stats.jsonResponses, (uint32_t)1);
+    Serial.printf("Responses: %u CBOR (avg %llu bytes, %llu us), %u JSON (avg %llu bytes, %llu us), %u undecodable\n",
+                  stats.cborResponses, (unsigned long long)(stats.cborBytes / cbor), (unsigned long long)(stats.cborMicros / cbor),
+                  stats.jsonResponses, (unsigned long long)(stats.jsonBytes / json), (unsigned long long)(stats.jsonMicros / json),
+                  stats.failures);
+}
@@ -0,0 +1,60 @@
+#ifndef RESPONSE_DECODER_H
+#define RESPONSE_DECODER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+
+struct ResponseDecoderStats {
+    uint32_t cborResponses;   // Decoded structured responses
+    uint32_t jsonResponses;   // Responses that fell back to JSON
+    uint32_t failures;        // CBOR responses that did not decode
+    uint64_t cborBytes;
+    uint64_t jsonBytes;
+    uint64_t cborMicros;      // Decode time
+    uint64_t jsonMicros;
+};
+
+// Decoder for structured (CBOR, RFC 8949) cloud responses. Requests ask for
+// CBOR with an Accept header; a server that only speaks JSON keeps working, as
+// the Content-Type of the reply selects the parser. The response is decoded
+// straight into a StructuredResult with no heap allocation.
+//
+// Schema version 1, a map with small integer keys (unknown keys are skipped,
+// so fields can be added without a version bump):
+//    0  version, uint            STRUCTURED_RESPONSE_VERSION
+//    1  success, bool
+//    2  text, tstr               result to speak
+//    3  error, tstr
+//    4  confidence, float
+//    5  hazard type, uint        HazardType
+//    6  direction, uint          KeywordDirection
+//    7  distance, float          metres
+//    8  task confidences, array of float, indexed by OperationMode
+//    9  regions, array of [kind uint, x, y, width, height]
+//                                kind CASCADE_TEXT, CASCADE_SIGN or REGION_HAZARD,
+//                                box in fractions of the uploaded image
+//   10  audio, [url tstr, format tstr, size uint]
+// Floats may be sent as any CBOR float width or as integers. Indefinite-length
+// items are not accepted.
+class ResponseDecoder {
+private:
+    ResponseDecoderStats stats;
+
+public:
+    ResponseDecoder();
+
+    // Decode a CBOR response
+    bool decode(const uint8_t* data, size_t length, StructuredResult* result);
+
+    // JSON fallback accounting
+    void recordJson(size_t bytes, unsigned long micros);
+
+    // Statistics
+    ResponseDecoderStats getStats();
+    void logStats();
+};
+
+// Global response decoder instance
+extern ResponseDecoder responseDecoder;
+
+#endif // RESPONSE_DECODER_H
@@ -0,0 +1,288 @@
+#include "sign_prefilter.h"
+#include <cstring>
+
+SignPrefilter signPrefilter;
+
+namespace {
+
+const int COLOUR_COUNT = 3;
+const SignColour COLOURS[COLOUR_COUNT] = { SIGN_COLOUR_RED, SIGN_COLOUR_YELLOW, SIGN_COLOUR_BLUE };
+
+// Thresholds are compared on 7-bit values (x >> 1) so that four of them can be
+// tested at once in a 32-bit word without borrows crossing lanes
+const uint32_t T_LUMA = SIGN_MIN_LUMA >> 1;
+const uint32_t T_RED_CR = SIGN_RED_MIN_CR >> 1;
+const uint32_t T_RED_CB = SIGN_RED_MIN_CB >> 1;
+const uint32_t T_RED_CB_MAX = (SIGN_RED_MAX_CB >> 1) + 1;
+const uint32_t T_YELLOW_CR = SIGN_YELLOW_MIN_CR >> 1;
+const uint32_t T_YELLOW_CB_MAX = (SIGN_YELLOW_MAX_CB >> 1) + 1;
+const uint32_t T_YELLOW_LUMA = SIGN_YELLOW_MIN_LUMA >> 1;
+const uint32_t T_BLUE_CB = SIGN_BLUE_MIN_CB >> 1;
+const uint32_t T_BLUE_CR_MAX = (SIGN_BLUE_MAX_CR >> 1) + 1;
+
+const uint32_t LANE_HIGH = 0x80808080;
+const uint32_t LANE_LOW7 = 0x7f7f7f7f;
+const uint32_t LANE_ONES = 0x01010101;
+
+// High bit of each lane set where the 7-bit lane value is >= t
+inline uint32_t atLeast(uint32_t lanes, uint32_t t) {
+    return ((lanes | LANE_HIGH) - t * LANE_ONES) & LANE_HIGH;
+}
+
+inline uint32_t load7(const uint8_t* p) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    return (word >> 1) & LANE_LOW7;
+}
+
+inline uint8_t classifyPixel(int y, int cb, int cr) {
+    uint32_t y7 = y >> 1;
+    uint32_t cb7 = cb >> 1;
+    uint32_t cr7 = cr >> 1;
+    if (y7 < T_LUMA) return 0;
+    uint8_t classes = 0;
+    if (cr7 >= T_RED_CR && cb7 >= T_RED_CB && cb7 < T_RED_CB_MAX) classes |= SIGN_COLOUR_RED;
+    if (cr7 >= T_YELLOW_CR && cb7 < T_YELLOW_CB_MAX && y7 >= T_YELLOW_LUMA) classes |= SIGN_COLOUR_YELLOW;
+    if (cb7 >= T_BLUE_CB && cr7 < T_BLUE_CR_MAX) classes |= SIGN_COLOUR_BLUE;
+    return classes;
+}
+
+} // namespace
+
+SignPrefilter::SignPrefilter() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+void SignPrefilter::classifyRowScalar(const uint8_t* y, const uint8_t* cb, const uint8_t* cr,
+                                     uint8_t* classes, int width) {
+    for (int x = 0; x < width; x++) {
+        classes[x] = classifyPixel(y[x], cb[x], cr[x]);
+    }
+}
+
+void SignPrefilter::classifyRow(const uint8_t* y, const uint8_t* cb, const uint8_t* cr,
+                                uint8_t* classes, int width) {
+    int x = 0;
+    for (; x + 4 <= width; x += 4) {
+        uint32_t Y = load7(y + x);
+        uint32_t Cb = load7(cb + x);
+        uint32_t Cr = load7(cr + x);
+
+        uint32_t lit = atLeast(Y, T_LUMA);
+        uint32_t red = atLeast(Cr, T_RED_CR) & atLeast(Cb, T_RED_CB) & ~atLeast(Cb, T_RED_CB_MAX) & lit;
+        uint32_t yellow = atLeast(Cr, T_YELLOW_CR) & ~atLeast(Cb, T_YELLOW_CB_MAX) & atLeast(Y, T_YELLOW_LUMA);
+        uint32_t blue = atLeast(Cb, T_BLUE_CB) & ~atLeast(Cr, T_BLUE_CR_MAX) & lit;
+
+        // Lane high bits down to the SignColour bit positions
+        uint32_t word = (red >> 7) | (yellow >> 6) | (blue >> 5);
+        memcpy(classes + x, &word, sizeof(word));
+    }
+    for (; x < width; x++) {
+        classes[x] = classifyPixel(y[x], cb[x], cr[x]);
+    }
+}
+
+bool SignPrefilter::detect(const uint8_t* jpeg, size_t length, SignCandidates* candidates) {
+    unsigned long startTime = micros();
+
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(jpeg, length, &info) || info.components != 3) {
+        return false;
+    }
+
+    // Coarsest DCT scale that leaves SIGN_DETECT_WIDTH chroma samples across
+    int pitch = max(info.mcuWidth, info.mcuHeight) / 8;
+    JpegScale scale = JPEG_SCALE_EIGHTH;
+    while (scale > JPEG_SCALE_FULL && info.width / pitch / scale < SIGN_DETECT_WIDTH) {
+        scale = (JpegScale)(scale / 2);
+    }
+
+    JpegPlane planes[3];
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, planes, 3)) {
+        return false;
+    }
+
+    // Resample all three planes in place onto one square grid at chroma pitch
+    // (4:2:2 chroma is only subsampled horizontally)
+    int chromaX = info.mcuWidth / 8;
+    int chromaY = info.mcuHeight / 8;
+    int width = planes[1].width * chromaX / pitch;
+    int height = planes[1].height * chromaY / pitch;
+    for (int y = 0; y < height; y++) {
+        const uint8_t* lumaRow = planes[0].data + (y * pitch) * planes[0].stride;
+        const uint8_t* cbRow = planes[1].data + (y * pitch / chromaY) * planes[1].stride;
+        const uint8_t* crRow = planes[2].data + (y * pitch / chromaY) * planes[2].stride;
+        uint8_t* lumaOut = planes[0].data + y * width;
+        uint8_t* cbOut = planes[1].data + y * width;
+        uint8_t* crOut = planes[2].data + y * width;
+        for (int x = 0; x < width; x++) {
+            lumaOut[x] = lumaRow[x * pitch];
+            cbOut[x] = cbRow[x * pitch / chromaX];
+            crOut[x] = crRow[x * pitch / chromaX];
+        }
+    }
+    bool success = detectPlanes(planes[0].data, planes[1].data, planes[2].data, width, height,
+                                width, scale * pitch, candidates);
+    for (int i = 0; i < 3; i++) {
+        free(planes[i].data);
+    }
+    if (!success) return false;
+
+    candidates->sourceWidth = info.width;
+    candidates->sourceHeight = info.height;
+    for (int i = 0; i < candidates->count; i++) {
+        SignRegion& region = candidates->regions[i];
+        if (region.x + region.width > info.width) region.width = info.width - region.x;
+        if (region.y + region.height > info.height) region.height = info.height - region.y;
+    }
+
+    unsigned long elapsed = micros() - startTime;
+    stats.frames++;
+    if (candidates->count > 0) stats.signFrames++;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+    return true;
+}
+
+bool SignPrefilter::detectPlanes(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, int width, int height,
+                                 int stride, int scale, SignCandidates* candidates) {
+    memset(candidates, 0, sizeof(SignCandidates));
+    candidates->sourceWidth = width * scale;
+    candidates->sourceHeight = height * scale;
+
+    int pixels = width * height;
+    uint8_t* classes = (uint8_t*)malloc(pixels);
+    int32_t* stack = (int32_t*)malloc(pixels * sizeof(int32_t));
+    if (!classes || !stack) {
+        free(classes);
+        free(stack);
+        return false;
+    }
+
+    for (int row = 0; row < height; row++) {
+        classifyRow(y + row * stride, cb + row * stride, cr + row * stride, classes + row * width, width);
+    }
+
+    // 4-connected blobs per colour; visited pixels have their colour bit cleared
+    int maxArea = (int)(pixels * SIGN_MAX_AREA_FRACTION);
+    for (int c = 0; c < COLOUR_COUNT; c++) {
+        uint8_t bit = COLOURS[c];
+        for (int start = 0; start < pixels; start++) {
+            if (!(classes[start] & bit)) continue;
+            classes[start] &= ~bit;
+            int top = 0;
+            stack[top++] = start;
+            int minX = width, minY = height, maxX = -1, maxY = -1;
+            int area = 0;
+            while (top > 0) {
+                int index = stack[--top];
+                int px = index % width;
+                int py = index / width;
+                area++;
+                if (px < minX) minX = px;
+                if (px > maxX) maxX = px;
+                if (py < minY) minY = py;
+                if (py > maxY) maxY = py;
+                if (px > 0 && (classes[index - 1] & bit)) {
+                    classes[index - 1] &= ~bit;
+                    stack[top++] = index - 1;
+                }
+                if (px + 1 < width && (classes[index + 1] & bit)) {
+                    classes[index + 1] &= ~bit;
+                    stack[top++] = index + 1;
+                }
+                if (py > 0 && (classes[index - width] & bit)) {
+                    classes[index - width] &= ~bit;
+                    stack[top++] = index - width;
+                }
+                if (py + 1 < height && (classes[index + width] & bit)) {
+                    classes[index + width] &= ~bit;
+                    stack[top++] = index + width;
+                }
+            }
+
+            // Signs are compact, solid or ring-shaped and neither tiny nor frame-filling
+            if (area < SIGN_MIN_AREA || area > maxArea) continue;
+            int boxWidth = maxX - minX + 1;
+            int boxHeight = maxY - minY + 1;
+            float fill = (float)area / (boxWidth * boxHeight);
+            if (fill < SIGN_MIN_FILL) continue;
+            if (boxWidth > SIGN_MAX_ASPECT * boxHeight || boxHeight > SIGN_MAX_ASPECT * boxWidth) continue;
+
+            // Keep the largest SIGN_MAX_REGIONS regions
+            SignRegion region;
+            region.x = minX * scale;
+            region.y = minY * scale;
+            region.width = boxWidth * scale;
+            region.height = boxHeight * scale;
+            region.colour = COLOURS[c];
+            region.fill = fill;
+            int slot = candidates->count;
+            if (slot == SIGN_MAX_REGIONS) {
+                slot = 0;
+                for (int i = 1; i < SIGN_MAX_REGIONS; i++) {
+                    const SignRegion& r = candidates->regions[i];
+                    const SignRegion& smallest = candidates->regions[slot];
+                    if (r.width * r.height < smallest.width * smallest.height) slot = i;
+                }
+                const SignRegion& smallest = candidates->regions[slot];
+                if (smallest.width * smallest.height >= region.width * region.height) continue;
+            } else {
+                candidates->count++;
+            }
+            candidates->regions[slot] = region;
+        }
+    }
+
+    free(classes);
+    free(stack);
+    return true;
+}
+
+bool SignPrefilter::cropToRegions(const uint8_t* jpeg, size_t length, const SignCandidates& candidates,
+                                  uint8_t** output, size_t* outputSize) {
+    if (candidates.count == 0) return false;
+
+    int minX = candidates.sourceWidth, minY = candidates.sourceHeight, maxX = 0, maxY = 0;
+    for (int i = 0; i < candidates.count; i++) {
+        const SignRegion& region = candidates.regions[i];
+        minX = min(minX, (int)region.x);
+        minY = min(minY, (int)region.y);
+        maxX = max(maxX, region.x + region.width);
+        maxY = max(maxY, region.y + region.height);
+    }
+    minX = max(0, minX - SIGN_CROP_MARGIN);
+    minY = max(0, minY - SIGN_CROP_MARGIN);
+    maxX = min((int)candidates.sourceWidth, maxX + SIGN_CROP_MARGIN);
+    maxY = min((int)candidates.sourceHeight, maxY + SIGN_CROP_MARGIN);
+
+    JpegTranscodeOptions options;
+    options.crop = true;
+    options.cropRect = { (uint16_t)minX, (uint16_t)minY, (uint16_t)(maxX - minX), (uint16_t)(maxY - minY) };
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return jpegTranscoder.transcode(jpeg, length, options, output, outputSize);
+}
+
+void SignPrefilter::recordSkippedUpload() {
+    stats.uploadsSkipped++;
+}
+
+void SignPrefilter::recordUpload(size_t fullSize, size_t sentSize) {
+    stats.bytesFull += fullSize;
+    stats.bytesSent += sentSize;
+}
+
+SignPrefilterStats SignPrefilter::getStats() {
+    return stats;
+}
+
+void SignPrefilter::logStats() {
+    if (stats.frames == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.frames);
+    float cropRatio = stats.bytesFull > 0 ? (float)stats.bytesSent / stats.bytesFull : 1.0f;
+    Serial.printf("Sign prefilter: %u frames, %u with candidates, %u sign uploads skipped, crops %.0f%% of upload bytes, avg %lu us\n",
+                  stats.frames, stats.signFrames, stats.uploadsSkipped, cropRatio * 100, avgMicros);
+}
@@ -0,0 +1,81 @@
+#ifndef SIGN_PREFILTER_H
+#define SIGN_PREFILTER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+#include "jpeg_transcoder.h"
+
+// Colour classes, also the bits of a classified pixel
+enum SignColour {
+    SIGN_COLOUR_RED = 1,
+    SIGN_COLOUR_YELLOW = 2,
+    SIGN_COLOUR_BLUE = 4
+};
+
+// Saturated blob that may be a sign, in source image pixels
+struct SignRegion {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    SignColour colour;
+    float fill;               // Blob pixels / bounding box pixels
+};
+
+struct SignCandidates {
+    SignRegion regions[SIGN_MAX_REGIONS];
+    int count;
+    uint16_t sourceWidth;
+    uint16_t sourceHeight;
+};
+
+struct SignPrefilterStats {
+    uint32_t frames;          // Frames examined
+    uint32_t signFrames;      // Frames with candidate regions
+    uint32_t uploadsSkipped;  // Sign uploads avoided on frames without candidates
+    uint64_t bytesFull;       // Bytes of the image that would have been uploaded
+    uint64_t bytesSent;       // Bytes actually uploaded (region crops)
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// Colour-segmentation prefilter for sign detection. Red, yellow and blue
+// high-saturation pixels are picked out of a low-resolution YCbCr decode of the
+// JPEG (no RGB conversion; thresholds apply to Cb/Cr directly) and grouped into
+// blobs with sign-like size, aspect and fill.
+class SignPrefilter {
+private:
+    SignPrefilterStats stats;
+
+public:
+    SignPrefilter();
+
+    // Find candidate regions in a JPEG
+    bool detect(const uint8_t* jpeg, size_t length, SignCandidates* candidates);
+
+    // Find candidate regions in co-sited Y/Cb/Cr planes; regions are scaled up by `scale`
+    bool detectPlanes(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, int width, int height,
+                      int stride, int scale, SignCandidates* candidates);
+
+    // Per-pixel colour classification of one row into SignColour bits. The packed
+    // version handles four pixels per 32-bit word; the scalar one is its reference.
+    static void classifyRow(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* classes, int width);
+    static void classifyRowScalar(const uint8_t* y, const uint8_t* cb, const uint8_t* cr, uint8_t* classes, int width);
+
+    // Crop of the JPEG covering all regions; output is allocated with malloc()
+    bool cropToRegions(const uint8_t* jpeg, size_t length, const SignCandidates& candidates,
+                       uint8_t** output, size_t* outputSize);
+
+    // Upload accounting
+    void recordSkippedUpload();
+    void recordUpload(size_t fullSize, size_t sentSize);
+
+    // Statistics
+    SignPrefilterStats getStats();
+    void logStats();
+};
+
+// Global sign prefilter instance
+extern SignPrefilter signPrefilter;
+
+#endif // SIGN_PREFILTER_H
@@ -0,0 +1,196 @@
+#include "task_scheduler.h"
+#include <cstring>
+
+TaskScheduler taskScheduler;
+
+TaskScheduler::TaskScheduler() {
+    memset(tasks, 0, sizeof(tasks));
+    for (int t = 0; t < SCHED_TASKS; t++) {
+        tasks[t].cost = SCHED_INITIAL_COST;
+    }
+    roundRobin = 0;
+    budgetLeft = 0;
+    optionalRuns = 0;
+    frameTime = 0;
+    firstFrame = 0;
+    frames = 0;
+    haveCaptionedScene = false;
+    haveCurrentScene = false;
+}
+
+float TaskScheduler::quantum(int task) {
+    switch (task) {
+        case MODE_VISUAL_CAPTION: return SCHED_QUANTUM * SCHED_CAPTION_WEIGHT;
+        case MODE_SIGN_DETECTION: return SCHED_QUANTUM * SCHED_SIGN_WEIGHT;
+        case MODE_OCR:            return SCHED_QUANTUM * SCHED_OCR_WEIGHT;
+        default:                  return SCHED_QUANTUM;
+    }
+}
+
+unsigned long TaskScheduler::minInterval(int task) {
+    switch (task) {
+        case MODE_VISUAL_CAPTION: return SCHED_CAPTION_INTERVAL;
+        case MODE_SIGN_DETECTION: return SCHED_SIGN_INTERVAL;
+        case MODE_OCR:            return SCHED_OCR_INTERVAL;
+        default:                  return 0;
+    }
+}
+
+void TaskScheduler::beginFrame(unsigned long now) {
+    if (frames == 0) firstFrame = now;
+    frames++;
+    frameTime = now;
+    budgetLeft = SCHED_FRAME_BUDGET;
+    optionalRuns = 0;
+    haveCurrentScene = false;
+    for (int t = 0; t < SCHED_TASKS; t++) {
+        tasks[t].triggered = false;
+        tasks[t].done = false;
+    }
+    tasks[MODE_HAZARD_DETECTION].triggered = true;
+}
+
+void TaskScheduler::setTriggered(int task, bool triggered) {
+    if (task < 0 || task >= SCHED_TASKS || task == MODE_HAZARD_DETECTION) return;
+    SchedulerTask& entry = tasks[task];
+
+    if (entry.requested) {
+        entry.triggered = true;
+        return;
+    }
+    if (!triggered) {
+        // Nothing queued, so no credit is kept (as in DRR for an empty queue)
+        entry.triggered = false;
+        entry.deficit = 0;
+        entry.stats.idle++;
+        return;
+    }
+    if (entry.lastRun != 0 && frameTime - entry.lastRun < minInterval(task)) {
+        entry.triggered = false;
+        entry.stats.tooSoon++;
+        return;
+    }
+    entry.triggered = true;
+}
+
+void TaskScheduler::request(int task) {
+    if (task >= 0 && task < SCHED_TASKS) tasks[task].requested = true;
+}
+
+bool TaskScheduler::sceneChanged(const uint8_t* jpeg, size_t length, JpegScale scale) {
+    // The 1/8 scale decode is DC coefficients only, one value per 8x8 block
+    JpegPlane luma;
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, &luma, 1)) {
+        return true;
+    }
+    bool changed = sceneChangedLuma(luma.data, luma.width, luma.height, luma.stride);
+    free(luma.data);
+    return changed;
+}
+
+bool TaskScheduler::sceneChangedLuma(const uint8_t* gray, int width, int height, int stride) {
+    // Box-average into the thumbnail
+    for (int ty = 0; ty < SCHED_THUMB_HEIGHT; ty++) {
+        int y0 = ty * height / SCHED_THUMB_HEIGHT;
+        int y1 = max(y0 + 1, (ty + 1) * height / SCHED_THUMB_HEIGHT);
+        for (int tx = 0; tx < SCHED_THUMB_WIDTH; tx++) {
+            int x0 = tx * width / SCHED_THUMB_WIDTH;
+            int x1 = max(x0 + 1, (tx + 1) * width / SCHED_THUMB_WIDTH);
+            uint32_t sum = 0;
+            for (int y = y0; y < y1; y++) {
+                for (int x = x0; x < x1; x++) sum += gray[y * stride + x];
+            }
+            currentScene[ty * SCHED_THUMB_WIDTH + tx] = sum / ((y1 - y0) * (x1 - x0));
+        }
+    }
+    haveCurrentScene = true;
+    if (!haveCaptionedScene) return true;
+
+    uint32_t difference = 0;
+    for (int i = 0; i < SCHED_THUMB_WIDTH * SCHED_THUMB_HEIGHT; i++) {
+        difference += abs((int)currentScene[i] - (int)captionedScene[i]);
+    }
+    return difference >= (uint32_t)SCHED_SCENE_CHANGE * SCHED_THUMB_WIDTH * SCHED_THUMB_HEIGHT;
+}
+
+int TaskScheduler::nextTask() {
+    SchedulerTask& hazard = tasks[MODE_HAZARD_DETECTION];
+    if (hazard.triggered && !hazard.done) {
+        hazard.done = true;
+        return MODE_HAZARD_DETECTION;
+    }
+
+    // Deficit round robin over the rest: each visit adds a quantum, a task runs
+    // once its deficit covers its expected latency
+    for (int round = 0; round < SCHED_MAX_ROUNDS; round++) {
+        bool waiting = false;
+        for (int k = 0; k < SCHED_TASKS; k++) {
+            int t = (roundRobin + k) % SCHED_TASKS;
+            SchedulerTask& task = tasks[t];
+            if (t == MODE_HAZARD_DETECTION || task.done || !task.triggered) continue;
+            // The first task after hazard may overrun, so a costly task is never shut out
+            if (optionalRuns > 0 && task.cost > budgetLeft) {
+                // Still earns this frame's quantum, so it wins a later frame
+                task.deficit = min(task.deficit + quantum(t), (float)SCHED_FRAME_BUDGET);
+                task.done = true;
+                task.stats.overBudget++;
+                continue;
+            }
+            if (task.deficit < task.cost) {
+                task.deficit = min(task.deficit + quantum(t), (float)SCHED_FRAME_BUDGET);
+            }
+            if (task.deficit >= task.cost) {
+                task.done = true;
+                roundRobin = (t + 1) % SCHED_TASKS;
+                return t;
+            }
+            waiting = true;
+        }
+        if (!waiting) break;
+    }
+    return -1;
+}
+
+void TaskScheduler::recordRun(int task, unsigned long elapsed, bool success) {
+    if (task < 0 || task >= SCHED_TASKS) return;
+    SchedulerTask& entry = tasks[task];
+    budgetLeft -= elapsed;
+    if (task != MODE_HAZARD_DETECTION) optionalRuns++;
+    entry.deficit = max(entry.deficit - (float)elapsed, -(float)SCHED_FRAME_BUDGET);
+    entry.cost = entry.cost * 0.7f + elapsed * 0.3f;
+    entry.lastRun = frameTime;
+    entry.requested = false;
+    entry.stats.runs++;
+    if (!success) entry.stats.failures++;
+    entry.stats.totalMillis += elapsed;
+    entry.stats.lastMillis = elapsed;
+
+    if (task == MODE_VISUAL_CAPTION && haveCurrentScene) {
+        memcpy(captionedScene, currentScene, sizeof(captionedScene));
+        haveCaptionedScene = true;
+    }
+}
+
+SchedulerTaskStats TaskScheduler::getTaskStats(int task) {
+    SchedulerTaskStats none;
+    memset(&none, 0, sizeof(none));
+    return task >= 0 && task < SCHED_TASKS ? tasks[task].stats : none;
+}
+
+float TaskScheduler::requestsPerMinute(int task) {
+    if (task < 0 || task >= SCHED_TASKS || frames < 2 || frameTime == firstFrame) return 0;
+    return tasks[task].stats.runs * 60000.0f / (frameTime - firstFrame);
+}
+
+void TaskScheduler::logStats() {
+    if (frames == 0) return;
+    const char* names[SCHED_TASKS] = { "hazard", "caption", "sign", "OCR" };
+    Serial.printf("Scheduler: %u auto frames\n", frames);
+    for (int t = 0; t < SCHED_TASKS; t++) {
+        const SchedulerTaskStats& s = tasks[t].stats;
+        unsigned long avgMillis = s.runs > 0 ? (unsigned long)(s.totalMillis / s.runs) : 0;
+        Serial.printf("  %-7s %u runs (%.1f/min, %u failed), avg %lu ms, last %lu ms; skipped: %u idle, %u interval, %u budget\n",
+                      names[t], s.runs, requestsPerMinute(t), s.failures, avgMillis, s.lastMillis,
+                      s.idle, s.tooSoon, s.overBudget);
+    }
+}
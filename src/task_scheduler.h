@@ -0,0 +1,82 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+#include "jpeg_transcoder.h"
+
+// Tasks are the cloud modes, indexed by OperationMode
+struct SchedulerTaskStats {
+    uint32_t runs;
+    uint32_t failures;
+    uint32_t idle;            // Frames where its trigger did not fire
+    uint32_t tooSoon;         // Triggered within its minimum interval
+    uint32_t overBudget;      // Triggered but no frame budget left
+    uint64_t totalMillis;
+    unsigned long lastMillis;
+};
+
+struct SchedulerTask {
+    bool triggered;           // Trigger fired for the current frame
+    bool requested;           // Asked for by the user, runs on the next frame
+    bool done;                // Ran or was ruled out in the current frame
+    float deficit;            // Deficit round-robin credit (ms)
+    float cost;               // Expected latency (ms), running average
+    unsigned long lastRun;
+    SchedulerTaskStats stats;
+};
+
+// Chooses which cloud tasks run on an auto-mode frame. Hazard detection runs on
+// every frame, ahead of the rest. Caption, sign and OCR run only when their
+// trigger fires: a large scene change or a user request, sign colours from the
+// prefilter, text from the text detector. They then share what is left of
+// SCHED_FRAME_BUDGET by deficit round robin. Each round adds a weighted
+// quantum to a task's deficit, and a task runs once its deficit covers its
+// expected latency. Deficits carry over while a task stays triggered, so a
+// task that was squeezed out gets its turn on a later frame.
+class TaskScheduler {
+private:
+    SchedulerTask tasks[SCHED_TASKS];
+    int roundRobin;           // Task the next round starts at
+    float budgetLeft;         // Of the current frame (ms)
+    int optionalRuns;         // Tasks other than hazard run in the current frame
+    unsigned long frameTime;
+    unsigned long firstFrame;
+    uint32_t frames;
+
+    // Scene thumbnails: last captioned frame and the current one
+    uint8_t captionedScene[SCHED_THUMB_WIDTH * SCHED_THUMB_HEIGHT];
+    uint8_t currentScene[SCHED_THUMB_WIDTH * SCHED_THUMB_HEIGHT];
+    bool haveCaptionedScene;
+    bool haveCurrentScene;
+
+    static float quantum(int task);
+    static unsigned long minInterval(int task);
+
+public:
+    TaskScheduler();
+
+    // Start a frame and set the triggers; hazard is always triggered
+    void beginFrame(unsigned long now);
+    void setTriggered(int task, bool triggered);
+    void request(int task);
+
+    // Caption trigger: mean luma change against the last captioned frame. A
+    // full frame needs only the 1/8 (DC) decode; a thumbnail needs more detail.
+    bool sceneChanged(const uint8_t* jpeg, size_t length, JpegScale scale = JPEG_SCALE_EIGHTH);
+    bool sceneChangedLuma(const uint8_t* gray, int width, int height, int stride);
+
+    // Next task to run on this frame, -1 when done
+    int nextTask();
+    void recordRun(int task, unsigned long elapsed, bool success);
+
+    // Statistics
+    SchedulerTaskStats getTaskStats(int task);
+    float requestsPerMinute(int task);
+    void logStats();
+};
+
+// Global task scheduler instance
+extern TaskScheduler taskScheduler;
+
+#endif // TASK_SCHEDULER_H
@@ -0,0 +1,372 @@
+#include "text_detector.h"
+#include <cstring>
+
+TextDetector textDetector;
+
+namespace {
+
+const int CELL_SHIFT = 3;     // 8x8 pixel cells
+
+// Last edge seen along a scan line
+struct EdgeState {
+    int16_t runStart;         // Start of the current above-threshold run, -1 when outside a run
+    int16_t runPeak;          // Position of the strongest gradient in the run
+    int16_t runMagnitude;     // Signed peak gradient of the run
+    int16_t lastPosition;     // Previous completed edge
+    int16_t lastMagnitude;    // Signed gradient of the previous edge, 0 when none
+};
+
+inline void resetEdge(EdgeState& e) {
+    e.runStart = -1;
+    e.runPeak = 0;
+    e.runMagnitude = 0;
+    e.lastPosition = 0;
+    e.lastMagnitude = 0;
+}
+
+// Close an edge run; returns the stroke width when it pairs with the previous edge
+// (opposite polarity, similar strength, close enough), otherwise 0
+inline int closeEdge(EdgeState& e) {
+    int width = 0;
+    int magnitude = e.runMagnitude;
+    int last = e.lastMagnitude;
+    if (last != 0 && (last ^ magnitude) < 0) {
+        int distance = e.runPeak - e.lastPosition;
+        int a = abs(magnitude);
+        int b = abs(last);
+        if (distance <= TEXT_MAX_STROKE && 2 * min(a, b) >= max(a, b)) {
+            width = distance;
+        }
+    }
+    e.lastPosition = e.runPeak;
+    e.lastMagnitude = magnitude;
+    e.runStart = -1;
+    return width;
+}
+
+// Feed one gradient sample at `position`; returns the stroke width of a completed pair, or 0
+inline int feedEdge(EdgeState& e, int position, int gradient) {
+    int width = 0;
+    bool strong = gradient >= TEXT_EDGE_THRESHOLD || gradient <= -TEXT_EDGE_THRESHOLD;
+    if (e.runStart >= 0 && (!strong || (gradient ^ e.runMagnitude) < 0)) {
+        width = closeEdge(e);
+    }
+    if (strong) {
+        if (e.runStart < 0) {
+            e.runStart = position;
+            e.runPeak = position;
+            e.runMagnitude = gradient;
+        } else if (abs(gradient) > abs(e.runMagnitude)) {
+            e.runPeak = position;
+            e.runMagnitude = gradient;
+        }
+    }
+    return width;
+}
+
+// Add a box to the detection, merging it with any box it overlaps. When the list
+// is full the weakest box gives way.
+void addBox(TextDetection* result, TextBox box) {
+    for (int i = 0; i < result->boxCount; i++) {
+        TextBox& other = result->boxes[i];
+        int x0 = max(box.x, other.x);
+        int y0 = max(box.y, other.y);
+        int x1 = min(box.x + box.width, other.x + other.width);
+        int y1 = min(box.y + box.height, other.y + other.height);
+        if (x0 < x1 && y0 < y1) {
+            int left = min(box.x, other.x);
+            int top = min(box.y, other.y);
+            box.width = max(box.x + box.width, other.x + other.width) - left;
+            box.height = max(box.y + box.height, other.y + other.height) - top;
+            box.x = left;
+            box.y = top;
+            box.score = max(box.score, other.score);
+            result->boxes[i] = result->boxes[--result->boxCount];
+            addBox(result, box);
+            return;
+        }
+    }
+
+    int slot = result->boxCount;
+    if (slot == TEXT_MAX_BOXES) {
+        slot = 0;
+        for (int i = 1; i < TEXT_MAX_BOXES; i++) {
+            if (result->boxes[i].score < result->boxes[slot].score) slot = i;
+        }
+        if (result->boxes[slot].score >= box.score) return;
+    } else {
+        result->boxCount++;
+    }
+    result->boxes[slot] = box;
+    if (box.score > result->score) result->score = box.score;
+}
+
+} // namespace
+
+TextDetector::TextDetector() {
+    memset(&stats, 0, sizeof(stats));
+}
+
+bool TextDetector::detect(const uint8_t* jpeg, size_t length, TextDetection* result) {
+    unsigned long startTime = micros();
+
+    JpegInfo info;
+    if (!jpegTranscoder.getInfo(jpeg, length, &info)) {
+        return false;
+    }
+
+    // Coarsest DCT scale that still leaves TEXT_DETECT_WIDTH pixels across
+    JpegScale scale = JPEG_SCALE_EIGHTH;
+    while (scale > JPEG_SCALE_FULL && info.width / scale < TEXT_DETECT_WIDTH) {
+        scale = (JpegScale)(scale / 2);
+    }
+
+    JpegPlane luma;
+    if (!jpegTranscoder.decodePlanes(jpeg, length, scale, &luma, 1)) {
+        return false;
+    }
+    bool success = detectLuma(luma.data, luma.width, luma.height, luma.stride, scale, result);
+    free(luma.data);
+    if (!success) return false;
+
+    result->sourceWidth = info.width;
+    result->sourceHeight = info.height;
+    for (int i = 0; i < result->boxCount; i++) {
+        TextBox& box = result->boxes[i];
+        if (box.x + box.width > info.width) box.width = info.width - box.x;
+        if (box.y + box.height > info.height) box.height = info.height - box.y;
+    }
+
+    unsigned long elapsed = micros() - startTime;
+    stats.frames++;
+    if (result->hasText) stats.textFrames++;
+    stats.totalMicros += elapsed;
+    stats.lastMicros = elapsed;
+    return true;
+}
+
+bool TextDetector::detectLuma(const uint8_t* gray, int width, int height, int stride, int scale,
+                              TextDetection* result) {
+    memset(result, 0, sizeof(TextDetection));
+    result->sourceWidth = width * scale;
+    result->sourceHeight = height * scale;
+
+    // Fine levels catch small print, coarse levels large lettering whose strokes
+    // are too wide to pair at full detector resolution
+    bool success = scanLevel(gray, width, height, stride, scale, result);
+    uint8_t* level = nullptr;
+    for (int i = 1; success && i < TEXT_DETECT_LEVELS; i++) {
+        int levelWidth = width >> 1;
+        int levelHeight = height >> 1;
+        if (levelWidth < 16 || levelHeight < 16) break;
+        uint8_t* reduced = (uint8_t*)malloc(levelWidth * levelHeight);
+        if (!reduced) {
+            success = false;
+            break;
+        }
+        for (int y = 0; y < levelHeight; y++) {
+            const uint8_t* top = gray + (2 * y) * stride;
+            const uint8_t* bottom = top + stride;
+            uint8_t* out = reduced + y * levelWidth;
+            for (int x = 0; x < levelWidth; x++) {
+                out[x] = (top[2 * x] + top[2 * x + 1] + bottom[2 * x] + bottom[2 * x + 1] + 2) >> 2;
+            }
+        }
+        free(level);
+        level = reduced;
+        gray = level;
+        width = levelWidth;
+        height = levelHeight;
+        stride = levelWidth;
+        scale *= 2;
+        success = scanLevel(gray, width, height, stride, scale, result);
+    }
+    free(level);
+
+    result->hasText = success && result->boxCount > 0;
+    return success;
+}
+
+bool TextDetector::scanLevel(const uint8_t* gray, int width, int height, int stride, int scale,
+                             TextDetection* result) {
+    if (width < 16 || height < 16) return true;
+
+    int cellsX = width >> CELL_SHIFT;
+    int cellsY = height >> CELL_SHIFT;
+    int cellCount = cellsX * cellsY;
+
+    // Per cell: horizontal pairs (vertical strokes), vertical pairs (horizontal strokes),
+    // sum and sum of squares of the horizontal stroke widths, then a component label
+    uint16_t* horizontalPairs = (uint16_t*)calloc(cellCount, sizeof(uint16_t));
+    uint16_t* verticalPairs = (uint16_t*)calloc(cellCount, sizeof(uint16_t));
+    uint16_t* strokeSum = (uint16_t*)calloc(cellCount, sizeof(uint16_t));
+    uint16_t* strokeSquares = (uint16_t*)calloc(cellCount, sizeof(uint16_t));
+    int16_t* labels = (int16_t*)malloc(cellCount * sizeof(int16_t));
+    int16_t* stack = (int16_t*)malloc(cellCount * sizeof(int16_t));
+    EdgeState* columns = (EdgeState*)malloc(width * sizeof(EdgeState));
+    if (!horizontalPairs || !verticalPairs || !strokeSum || !strokeSquares || !labels || !stack || !columns) {
+        free(horizontalPairs);
+        free(verticalPairs);
+        free(strokeSum);
+        free(strokeSquares);
+        free(labels);
+        free(stack);
+        free(columns);
+        return false;
+    }
+
+    // One pass over the rows: horizontal scan along the row, vertical scan carried
+    // down every column in `columns`
+    for (int x = 0; x < width; x++) resetEdge(columns[x]);
+    int scanHeight = cellsY << CELL_SHIFT;
+    int scanWidth = cellsX << CELL_SHIFT;
+    for (int y = 1; y < scanHeight - 1; y++) {
+        const uint8_t* above = gray + (y - 1) * stride;
+        const uint8_t* row = gray + y * stride;
+        const uint8_t* below = gray + (y + 1) * stride;
+        int cellRow = (y >> CELL_SHIFT) * cellsX;
+
+        EdgeState edge;
+        resetEdge(edge);
+        for (int x = 1; x < scanWidth - 1; x++) {
+            int stroke = feedEdge(edge, x, row[x + 1] - row[x - 1]);
+            if (stroke) {
+                int cell = cellRow + (edge.lastPosition >> CELL_SHIFT);
+                horizontalPairs[cell]++;
+                strokeSum[cell] += stroke;
+                strokeSquares[cell] += stroke * stroke;
+            }
+            EdgeState& column = columns[x];
+            if (feedEdge(column, y, below[x] - above[x])) {
+                verticalPairs[(column.lastPosition >> CELL_SHIFT) * cellsX + (x >> CELL_SHIFT)]++;
+            }
+        }
+    }
+
+    // Candidate cells need strokes in both directions: lone bars, fences and
+    // blinds only produce one
+    for (int i = 0; i < cellCount; i++) {
+        bool candidate = horizontalPairs[i] >= TEXT_CELL_MIN_PAIRS &&
+                         verticalPairs[i] >= TEXT_CELL_MIN_PAIRS / 2;
+        labels[i] = candidate ? 0 : -1;
+    }
+
+    // Cluster candidates; a one-cell horizontal gap still joins (spaces between words)
+    int label = 0;
+    for (int start = 0; start < cellCount; start++) {
+        if (labels[start] != 0) continue;
+        label++;
+        int top = 0;
+        stack[top++] = start;
+        labels[start] = label;
+        int minX = cellsX, minY = cellsY, maxX = -1, maxY = -1;
+        int cells = 0;
+        uint32_t pairs = 0;
+        uint32_t horizontal = 0, vertical = 0, widthSum = 0, widthSquares = 0;
+        while (top > 0) {
+            int index = stack[--top];
+            int cx = index % cellsX;
+            int cy = index / cellsX;
+            cells++;
+            horizontal += horizontalPairs[index];
+            vertical += verticalPairs[index];
+            widthSum += strokeSum[index];
+            widthSquares += strokeSquares[index];
+            if (cx < minX) minX = cx;
+            if (cx > maxX) maxX = cx;
+            if (cy < minY) minY = cy;
+            if (cy > maxY) maxY = cy;
+            for (int dy = -1; dy <= 1; dy++) {
+                int ny = cy + dy;
+                if (ny < 0 || ny >= cellsY) continue;
+                for (int dx = -2; dx <= 2; dx++) {
+                    int nx = cx + dx;
+                    if (nx < 0 || nx >= cellsX) continue;
+                    int neighbour = ny * cellsX + nx;
+                    if (labels[neighbour] == 0) {
+                        labels[neighbour] = label;
+                        stack[top++] = neighbour;
+                    }
+                }
+            }
+        }
+
+        if (cells < TEXT_MIN_CELLS) continue;
+
+        // Glyphs mix stroke widths and are dominated by vertical strokes; grids, fences
+        // and brickwork repeat one width, foliage has no preferred direction
+        float meanWidth = (float)widthSum / horizontal;
+        float variance = (float)widthSquares / horizontal - meanWidth * meanWidth;
+        float variation = variance > 0 ? sqrtf(variance) / meanWidth : 0;
+        if (variation < TEXT_MIN_STROKE_VARIATION) continue;
+        if (vertical > TEXT_MAX_VERTICAL_RATIO * horizontal) continue;
+        pairs = horizontal + vertical;
+
+        TextBox box;
+        int cellSize = (1 << CELL_SHIFT) * scale;
+        box.x = minX * cellSize;
+        box.y = minY * cellSize;
+        box.width = (maxX - minX + 1) * cellSize;
+        box.height = (maxY - minY + 1) * cellSize;
+        box.score = min(1.0f, (float)pairs / (cells * 4.0f * TEXT_CELL_MIN_PAIRS));
+
+        addBox(result, box);
+    }
+
+    free(horizontalPairs);
+    free(verticalPairs);
+    free(strokeSum);
+    free(strokeSquares);
+    free(labels);
+    free(stack);
+    free(columns);
+    return true;
+}
+
+bool TextDetector::cropToText(const uint8_t* jpeg, size_t length, const TextDetection& detection,
+                              uint8_t** output, size_t* outputSize) {
+    if (detection.boxCount == 0) return false;
+
+    int minX = detection.sourceWidth, minY = detection.sourceHeight, maxX = 0, maxY = 0;
+    for (int i = 0; i < detection.boxCount; i++) {
+        const TextBox& box = detection.boxes[i];
+        minX = min(minX, (int)box.x);
+        minY = min(minY, (int)box.y);
+        maxX = max(maxX, box.x + box.width);
+        maxY = max(maxY, box.y + box.height);
+    }
+    minX = max(0, minX - TEXT_CROP_MARGIN);
+    minY = max(0, minY - TEXT_CROP_MARGIN);
+    maxX = min((int)detection.sourceWidth, maxX + TEXT_CROP_MARGIN);
+    maxY = min((int)detection.sourceHeight, maxY + TEXT_CROP_MARGIN);
+
+    JpegTranscodeOptions options;
+    options.crop = true;
+    options.cropRect = { (uint16_t)minX, (uint16_t)minY, (uint16_t)(maxX - minX), (uint16_t)(maxY - minY) };
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return jpegTranscoder.transcode(jpeg, length, options, output, outputSize);
+}
+
+void TextDetector::recordSkippedUpload() {
+    stats.uploadsSkipped++;
+}
+
+void TextDetector::recordUpload(size_t fullSize, size_t sentSize) {
+    stats.bytesFull += fullSize;
+    stats.bytesSent += sentSize;
+}
+
+TextDetectorStats TextDetector::getStats() {
+    return stats;
+}
+
+void TextDetector::logStats() {
+    if (stats.frames == 0) return;
+    unsigned long avgMicros = (unsigned long)(stats.totalMicros / stats.frames);
+    float cropRatio = stats.bytesFull > 0 ? (float)stats.bytesSent / stats.bytesFull : 1.0f;
+    Serial.printf("Text detector: %u frames, %u with text, %u OCR uploads skipped, crops %.0f%% of frame bytes, avg %lu us\n",
+                  stats.frames, stats.textFrames, stats.uploadsSkipped, cropRatio * 100, avgMicros);
+}
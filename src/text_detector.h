@@ -0,0 +1,72 @@
+#ifndef TEXT_DETECTOR_H
+#define TEXT_DETECTOR_H
+
+#include <Arduino.h>
+#include "intel_glasses_config.h"
+#include "jpeg_transcoder.h"
+
+// Candidate text region in source image pixels
+struct TextBox {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+    float score;              // 0..1, stroke density of the region
+};
+
+struct TextDetection {
+    TextBox boxes[TEXT_MAX_BOXES];
+    int boxCount;
+    float score;              // Best box score, 0 when nothing was found
+    bool hasText;
+    uint16_t sourceWidth;
+    uint16_t sourceHeight;
+};
+
+struct TextDetectorStats {
+    uint32_t frames;          // Frames examined
+    uint32_t textFrames;      // Frames with text
+    uint32_t uploadsSkipped;  // OCR uploads avoided on text-free frames
+    uint64_t bytesFull;       // Full-frame bytes of frames that were uploaded
+    uint64_t bytesSent;       // Bytes actually uploaded for those frames (text crops)
+    uint64_t totalMicros;
+    unsigned long lastMicros;
+};
+
+// Lightweight text-presence detector. Works on downscaled luma planes decoded
+// straight from the JPEG: each row is scanned for stroke pairs (an edge followed
+// by an edge of opposite polarity and similar strength within a stroke width),
+// pair counts are pooled into cells, and clusters of dense cells become text boxes.
+class TextDetector {
+private:
+    TextDetectorStats stats;
+
+    bool scanLevel(const uint8_t* gray, int width, int height, int stride, int scale, TextDetection* result);
+
+public:
+    TextDetector();
+
+    // Detect text in a JPEG
+    bool detect(const uint8_t* jpeg, size_t length, TextDetection* result);
+
+    // Detect text in a luma plane over TEXT_DETECT_LEVELS octaves; boxes are scaled
+    // up by `scale` to source pixels
+    bool detectLuma(const uint8_t* gray, int width, int height, int stride, int scale, TextDetection* result);
+
+    // Crop of the JPEG covering all detected boxes; output is allocated with malloc()
+    bool cropToText(const uint8_t* jpeg, size_t length, const TextDetection& detection,
+                    uint8_t** output, size_t* outputSize);
+
+    // Upload accounting
+    void recordSkippedUpload();
+    void recordUpload(size_t fullSize, size_t sentSize);
+
+    // Statistics
+    TextDetectorStats getStats();
+    void logStats();
+};
+
+// Global text detector instance
+extern TextDetector textDetector;
+
+#endif // TEXT_DETECTOR_H
@@ -0,0 +1,170 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// Host stand-in for the Arduino-ESP32 core, enough to build the firmware
+// modules under test. Definitions live in host_runtime.h.
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include "freertos/FreeRTOS.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+using std::min; using std::max;
+typedef uint8_t byte;
+typedef bool boolean;
+#define HEX 16
+#define DEC 10
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define INPUT_PULLDOWN 3
+#define HIGH 1
+#define LOW 0
+#define SERIAL_8N1 0x800001c
+#define PROGMEM
+#define IRAM_ATTR
+#define F(x) (x)
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+class String {
+public:
+    std::string s;
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const std::string& x) : s(x) {}
+    String(char c) : s(1, c) {}
+    String(int v, int base = 10) { char b[32]; snprintf(b, 32, base == 16 ? "%x" : "%d", v); s = b; }
+    String(unsigned v, int base = 10) { char b[32]; snprintf(b, 32, base == 16 ? "%x" : "%u", v); s = b; }
+    String(long v, int base = 10) { char b[32]; snprintf(b, 32, base == 16 ? "%lx" : "%ld", v); s = b; }
+    String(unsigned long v, int base = 10) { char b[32]; snprintf(b, 32, base == 16 ? "%lx" : "%lu", v); s = b; }
+    String(long long v) { s = std::to_string(v); }
+    String(unsigned long long v) { s = std::to_string(v); }
+    String(float v, int d = 2) { char b[64]; snprintf(b, 64, "%.*f", d, v); s = b; }
+    String(double v, int d = 2) { char b[64]; snprintf(b, 64, "%.*f", d, v); s = b; }
+    unsigned int length() const { return s.size(); }
+    const char* c_str() const { return s.c_str(); }
+    char operator[](unsigned i) const { return i < s.size() ? s[i] : 0; }
+    char& operator[](unsigned i) { return s[i]; }
+    char charAt(unsigned i) const { return (*this)[i]; }
+    void setCharAt(unsigned i, char c) { if (i < s.size()) s[i] = c; }
+    String& operator+=(const String& o) { s += o.s; return *this; }
+    String& operator+=(const char* o) { s += o; return *this; }
+    String& operator+=(char o) { s += o; return *this; }
+    String& operator+=(int o) { s += String(o).s; return *this; }
+    String& operator+=(unsigned o) { s += String(o).s; return *this; }
+    String& operator+=(long o) { s += String(o).s; return *this; }
+    String& operator+=(unsigned long o) { s += String(o).s; return *this; }
+    String& operator+=(float o) { s += String(o).s; return *this; }
+    String& operator+=(double o) { s += String(o).s; return *this; }
+    bool concat(const char* p, unsigned n) { s.append(p, n); return true; }
+    bool concat(const String& o) { s += o.s; return true; }
+    bool concat(char c) { s += c; return true; }
+    bool operator==(const String& o) const { return s == o.s; }
+    bool operator==(const char* o) const { return s == o; }
+    bool operator!=(const String& o) const { return s != o.s; }
+    bool operator!=(const char* o) const { return s != o; }
+    bool operator<(const String& o) const { return s < o.s; }
+    bool equals(const String& o) const { return s == o.s; }
+    bool equalsIgnoreCase(const String& o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+    int compareTo(const String& o) const { return s.compare(o.s); }
+    int indexOf(const String& o, unsigned from = 0) const { auto p = s.find(o.s, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(const char* o, unsigned from = 0) const { return indexOf(String(o), from); }
+    int indexOf(char c, unsigned from = 0) const { auto p = s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { auto p = s.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(const String& o) const { auto p = s.rfind(o.s); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned a) const { return a > s.size() ? String() : String(s.substr(a)); }
+    String substring(unsigned a, unsigned b) const { if (a > b) std::swap(a, b); if (a > s.size()) return String(); return String(s.substr(a, b - a)); }
+    void replace(const String& a, const String& b) { if (a.s.empty()) return; size_t p = 0; while ((p = s.find(a.s, p)) != std::string::npos) { s.replace(p, a.s.size(), b.s); p += b.s.size(); } }
+    void replace(char a, char b) { std::replace(s.begin(), s.end(), a, b); }
+    void remove(unsigned i) { if (i < s.size()) s.erase(i); }
+    void remove(unsigned i, unsigned n) { if (i < s.size()) s.erase(i, n); }
+    void trim() { size_t a = s.find_first_not_of(" \t\r\n"); if (a == std::string::npos) { s.clear(); return; } s = s.substr(a, s.find_last_not_of(" \t\r\n") - a + 1); }
+    void toLowerCase() { for (auto& c : s) c = tolower((unsigned char)c); }
+    void toUpperCase() { for (auto& c : s) c = toupper((unsigned char)c); }
+    bool startsWith(const String& p) const { return s.rfind(p.s, 0) == 0; }
+    bool endsWith(const String& p) const { return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0; }
+    bool reserve(unsigned n) { s.reserve(n); return true; }
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+    void getBytes(unsigned char* b, unsigned n) const { if (!n) return; size_t k = std::min<size_t>(n - 1, s.size()); memcpy(b, s.data(), k); b[k] = 0; }
+    void toCharArray(char* b, unsigned n) const { getBytes((unsigned char*)b, n); }
+    bool isEmpty() const { return s.empty(); }
+    explicit operator bool() const { return true; }
+};
+inline String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+inline String operator+(const String& a, const char* b) { return String(a.s + b); }
+inline String operator+(const char* a, const String& b) { return String(std::string(a) + b.s); }
+inline String operator+(const String& a, char b) { return String(a.s + b); }
+template<class T> inline String operator+(const String& a, T b) { return String(a.s + String(b).s); }
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) { return 1; }
+    virtual size_t write(const uint8_t* b, size_t n) { size_t k = 0; while (k < n && write(b[k])) k++; return k; }
+    size_t write(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+    size_t print(const String& s) { return write((const uint8_t*)s.c_str(), s.length()); }
+    size_t print(const char* s) { return write(s); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int v, int base = 10) { return print(String(v, base)); }
+    size_t print(unsigned v, int base = 10) { return print(String(v, base)); }
+    size_t print(long v, int base = 10) { return print(String(v, base)); }
+    size_t print(unsigned long v, int base = 10) { return print(String(v, base)); }
+    size_t print(double v, int d = 2) { return print(String(v, d)); }
+    size_t println() { return write((const uint8_t*)"\r\n", 2); }
+    template<class T> size_t println(const T& v) { return print(v) + println(); }
+    size_t println(double v, int d) { return print(v, d) + println(); }
+    size_t printf(const char* f, ...) __attribute__((format(printf, 2, 3)));
+    virtual void flush() {}
+};
+class Stream : public Print {
+public:
+    virtual int available() { return 0; }
+    virtual int read() { return -1; }
+    virtual int peek() { return -1; }
+    void setTimeout(unsigned long) {}
+    size_t readBytes(uint8_t* b, size_t n) { size_t k = 0; int c; while (k < n && (c = read()) >= 0) b[k++] = c; return k; }
+    size_t readBytes(char* b, size_t n) { return readBytes((uint8_t*)b, n); }
+    String readString() { String r; int c; while ((c = read()) >= 0) r += (char)c; return r; }
+    String readStringUntil(char t) { String r; int c; while ((c = read()) >= 0 && c != t) r += (char)c; return r; }
+};
+class Client : public Stream {
+public:
+    using Stream::read;
+    virtual int read(uint8_t* b, size_t n) { return readBytes(b, n); }
+};
+class HardwareSerial : public Stream {
+public:
+    HardwareSerial() {}
+    HardwareSerial(int) {}
+    void begin(unsigned long, uint32_t = SERIAL_8N1, int = -1, int = -1) {}
+    void setDebugOutput(bool) {}
+    void end() {}
+    size_t write(uint8_t c) override { fputc(c, stdout); return 1; }
+    size_t write(const uint8_t* b, size_t n) override { return fwrite(b, 1, n, stdout); }
+    using Print::write;
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial, Serial2;
+class EspClass { public: uint32_t getFreeHeap(); uint32_t getFreePsram() { return 0; } uint32_t getPsramSize() { return 0; } uint32_t getHeapSize() { return 0; } void restart() {} const char* getChipModel() { return "host"; } uint32_t getCpuFreqMHz() { return 240; } uint32_t getMinFreeHeap() { return 0; } uint32_t getMaxAllocHeap() { return 0; } };
+extern EspClass ESP;
+unsigned long millis(); unsigned long micros(); void delay(unsigned long); void delayMicroseconds(unsigned);
+void yield();
+bool psramFound(); void* ps_malloc(size_t); void* ps_calloc(size_t, size_t); void* ps_realloc(void*, size_t);
+void pinMode(int, int); void digitalWrite(int, int); int digitalRead(int); int analogRead(int); void analogWrite(int, int);
+double ledcSetup(int, double, int); void ledcAttachPin(int, int); void ledcDetachPin(int); void ledcWrite(int, uint32_t); double ledcWriteTone(int, double);
+long random(long); long random(long, long); void randomSeed(unsigned long);
+long map(long, long, long, long, long);
+template<class T, class L, class H> auto constrain(T x, L l, H h) -> typename std::common_type<T, L, H>::type { return x < l ? l : (x > h ? h : x); }
+
+#endif // HOST_ARDUINO_H
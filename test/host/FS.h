@@ -0,0 +1,117 @@
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+// Host stand-in for the Arduino fs::FS/fs::File API, backed by a directory on
+// the development machine. Paths are relative to the root given to the FS
+#include <Arduino.h>
+#include <cstdio>
+#include <dirent.h>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+class File {
+private:
+    struct Handle {
+        std::string hostPath;
+        std::string name;
+        FILE* file = nullptr;
+        DIR* dir = nullptr;
+        ~Handle() {
+            if (file) fclose(file);
+            if (dir) closedir(dir);
+        }
+    };
+    std::shared_ptr<Handle> handle;
+
+public:
+    File() {}
+
+    static File openHost(const std::string& hostPath, const char* mode) {
+        File result;
+        struct stat info;
+        bool isDir = stat(hostPath.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+        std::shared_ptr<Handle> handle = std::make_shared<Handle>();
+        if (isDir) {
+            if (mode[0] != 'r' || !(handle->dir = opendir(hostPath.c_str()))) return result;
+        } else {
+            std::string hostMode = std::string(mode) + "b";
+            if (!(handle->file = fopen(hostPath.c_str(), hostMode.c_str()))) return result;
+        }
+        handle->hostPath = hostPath;
+        size_t slash = hostPath.rfind('/');
+        handle->name = slash == std::string::npos ? hostPath : hostPath.substr(slash + 1);
+        result.handle = handle;
+        return result;
+    }
+
+    explicit operator bool() const { return handle && (handle->file || handle->dir); }
+    bool isDirectory() const { return handle && handle->dir; }
+    const char* name() const { return handle ? handle->name.c_str() : ""; }
+
+    size_t read(uint8_t* data, size_t size) { return handle && handle->file ? fread(data, 1, size, handle->file) : 0; }
+    int read() {
+        uint8_t byte;
+        return read(&byte, 1) == 1 ? byte : -1;
+    }
+    size_t write(const uint8_t* data, size_t size) {
+        return handle && handle->file ? fwrite(data, 1, size, handle->file) : 0;
+    }
+    size_t write(uint8_t byte) { return write(&byte, 1); }
+    bool seek(uint32_t position) { return handle && handle->file && fseek(handle->file, position, SEEK_SET) == 0; }
+    size_t position() const { return handle && handle->file ? ftell(handle->file) : 0; }
+    size_t size() const {
+        struct stat info;
+        if (handle && handle->file) fflush(handle->file);
+        return handle && stat(handle->hostPath.c_str(), &info) == 0 ? info.st_size : 0;
+    }
+    int available() { return size() - position(); }
+    void flush() { if (handle && handle->file) fflush(handle->file); }
+
+    File openNextFile() {
+        if (!isDirectory()) return File();
+        while (struct dirent* entry = readdir(handle->dir)) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+            std::string path = handle->hostPath;
+            path.append("/").append(entry->d_name);
+            return openHost(path, FILE_READ);
+        }
+        return File();
+    }
+
+    void close() { handle.reset(); }
+};
+
+class FS {
+private:
+    std::string root;
+
+    std::string hostPath(const String& path) const { return root + path.c_str(); }
+
+public:
+    explicit FS(const std::string& hostRoot) : root(hostRoot) {}
+
+    File open(const String& path, const char* mode = FILE_READ) { return File::openHost(hostPath(path), mode); }
+    bool exists(const String& path) {
+        struct stat info;
+        return stat(hostPath(path).c_str(), &info) == 0;
+    }
+    bool remove(const String& path) { return ::remove(hostPath(path).c_str()) == 0; }
+    bool rename(const String& from, const String& to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+    bool mkdir(const String& path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+    bool rmdir(const String& path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_FS_H
@@ -0,0 +1,19 @@
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+// Host stand-in for the Arduino HTTPClient. No request leaves the machine:
+// GET() fails, so callers take their error paths
+#include <Arduino.h>
+
+class HTTPClient {
+public:
+    bool begin(const String&) { return true; }
+    void setTimeout(uint16_t) {}
+    int GET() { return -1; }
+    int getSize() { return -1; }
+    Client* getStreamPtr() { return nullptr; }
+    bool connected() { return false; }
+    void end() {}
+};
+
+#endif // HOST_HTTP_CLIENT_H
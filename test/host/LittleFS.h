@@ -0,0 +1,25 @@
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+// Host stand-in for the LittleFS partition: an FS over the directory
+// HOST_LITTLEFS_ROOT, which mounts only when that directory exists. A test that
+// builds a module using it defines the LittleFS global.
+#include <FS.h>
+
+#ifndef HOST_LITTLEFS_ROOT
+#define HOST_LITTLEFS_ROOT "littlefs"
+#endif
+
+class LittleFSFS : public fs::FS {
+public:
+    LittleFSFS() : FS(HOST_LITTLEFS_ROOT) {}
+    bool begin(bool formatOnFail = false) {
+        (void)formatOnFail;
+        return exists("/");
+    }
+    void end() {}
+};
+
+extern LittleFSFS LittleFS;
+
+#endif // HOST_LITTLEFS_H
@@ -0,0 +1,6 @@
+#ifndef HOST_STREAM_DEBUGGER_H
+#define HOST_STREAM_DEBUGGER_H
+
+// Host stand-in for StreamDebugger: no firmware header uses its types
+
+#endif // HOST_STREAM_DEBUGGER_H
@@ -0,0 +1,9 @@
+#ifndef HOST_TINY_GSM_CLIENT_H
+#define HOST_TINY_GSM_CLIENT_H
+
+// Host stand-in for TinyGSM. Headers that reach the modem only hold pointers
+// to it, so the types are declared and never defined
+class TinyGsm;
+class TinyGsmClient;
+
+#endif // HOST_TINY_GSM_CLIENT_H
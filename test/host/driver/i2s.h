@@ -0,0 +1,49 @@
+#ifndef HOST_DRIVER_I2S_H
+#define HOST_DRIVER_I2S_H
+
+// Host stand-in for the legacy ESP-IDF I2S driver. Only the types are needed:
+// host builds of the audio path write to a file instead (AUDIO_HOST_SINK)
+#include <cstdint>
+#include <cstddef>
+#include "../esp_timer.h"
+
+typedef enum { I2S_NUM_0, I2S_NUM_1 } i2s_port_t;
+typedef enum { I2S_MODE_MASTER = 1, I2S_MODE_SLAVE = 2, I2S_MODE_TX = 4, I2S_MODE_RX = 8 } i2s_mode_t;
+typedef enum { I2S_BITS_PER_SAMPLE_16BIT = 16, I2S_BITS_PER_SAMPLE_32BIT = 32 } i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_FMT_RIGHT_LEFT, I2S_CHANNEL_FMT_ONLY_LEFT, I2S_CHANNEL_FMT_ONLY_RIGHT } i2s_channel_fmt_t;
+typedef enum { I2S_COMM_FORMAT_STAND_I2S = 1 } i2s_comm_format_t;
+
+#define ESP_INTR_FLAG_LEVEL1 2
+#define I2S_PIN_NO_CHANGE -1
+
+typedef struct {
+    int mode;
+    int sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+} i2s_config_t;
+
+typedef struct {
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queueSize, void* queue);
+esp_err_t i2s_driver_uninstall(i2s_port_t port);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins);
+esp_err_t i2s_set_clk(i2s_port_t port, uint32_t rate, uint32_t bits, int channels);
+esp_err_t i2s_zero_dma_buffer(i2s_port_t port);
+esp_err_t i2s_write(i2s_port_t port, const void* data, size_t size, size_t* written, uint32_t ticks);
+esp_err_t i2s_read(i2s_port_t port, void* data, size_t size, size_t* read, uint32_t ticks);
+
+#endif // HOST_DRIVER_I2S_H
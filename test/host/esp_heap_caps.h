@@ -0,0 +1,17 @@
+#ifndef HOST_ESP_HEAP_CAPS_H
+#define HOST_ESP_HEAP_CAPS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_SPIRAM 1
+#define MALLOC_CAP_8BIT 2
+#define MALLOC_CAP_INTERNAL 4
+#define MALLOC_CAP_DMA 8
+
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps);
+void heap_caps_free(void* pointer);
+size_t heap_caps_get_free_size(uint32_t caps);
+
+#endif // HOST_ESP_HEAP_CAPS_H
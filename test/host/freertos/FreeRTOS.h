@@ -0,0 +1,68 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// Host stand-in for the FreeRTOS API used by the firmware. Tasks run as
+// std::threads and a tick is one millisecond; see host_runtime.h.
+#include <cstdint>
+#include <cstddef>
+
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void* QueueHandle_t;
+typedef void* TaskHandle_t;
+typedef void* SemaphoreHandle_t;
+typedef void* TimerHandle_t;
+typedef struct { int x; } portMUX_TYPE;
+typedef void (*TaskFunction_t)(void*);
+
+#define portMUX_INITIALIZER_UNLOCKED {0}
+#define portENTER_CRITICAL(m) hostEnterCritical(m)
+#define portEXIT_CRITICAL(m) hostExitCritical(m)
+#define portENTER_CRITICAL_ISR(m) hostEnterCritical(m)
+#define portEXIT_CRITICAL_ISR(m) hostExitCritical(m)
+#define portYIELD_FROM_ISR(x) (void)(x)
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xffffffffu
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(x) (x)
+#define tskNO_AFFINITY 0x7fffffff
+#define configMAX_PRIORITIES 25
+#define tskIDLE_PRIORITY 0
+
+// One process-wide lock stands in for every portMUX spinlock
+void hostEnterCritical(portMUX_TYPE* mux);
+void hostExitCritical(portMUX_TYPE* mux);
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stack, void* param,
+                                   UBaseType_t priority, TaskHandle_t* handle, BaseType_t core);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previous, TickType_t ticks);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+BaseType_t xPortGetCoreID();
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks);
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks);
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t ticks);
+BaseType_t xQueueReset(QueueHandle_t queue);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+void vQueueDelete(QueueHandle_t queue);
+
+SemaphoreHandle_t xSemaphoreCreateMutex();
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore);
+void vSemaphoreDelete(SemaphoreHandle_t semaphore);
+
+#endif // HOST_FREERTOS_H
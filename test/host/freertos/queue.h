@@ -0,0 +1,6 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+#endif // HOST_FREERTOS_QUEUE_H
@@ -0,0 +1,262 @@
+#ifndef HOST_RUNTIME_H
+#define HOST_RUNTIME_H
+
+// Definitions behind the host stand-ins in this directory. Each test includes
+// this once, after the firmware sources it builds, so every test binary gets
+// its own copy. millis() and micros() follow the host's steady clock, FreeRTOS
+// tasks run as detached std::threads and a tick is one millisecond. Pin and
+// LEDC writes are recorded in hostPinLevels and hostLedcDuty. With
+// hostStartTasks false, task creation succeeds without starting the task, so a
+// test can drive a module's loop itself under a virtual clock.
+
+#include <Arduino.h>
+#include <cstdarg>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+HardwareSerial Serial;
+HardwareSerial Serial2;
+EspClass ESP;
+
+bool hostStartTasks = true;
+int hostPinLevels[64];
+uint32_t hostLedcDuty[16];
+double hostLedcFrequency[16];
+
+static const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+size_t Print::printf(const char* format, ...) {
+    char buffer[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    return write((const uint8_t*)buffer, std::min<size_t>(length, sizeof(buffer) - 1));
+}
+
+uint32_t EspClass::getFreeHeap() { return 256 * 1024; }
+
+unsigned long millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+unsigned long micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+}
+
+int64_t esp_timer_get_time() { return micros(); }
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(unsigned us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void yield() { std::this_thread::yield(); }
+
+bool psramFound() { return true; }
+void* ps_malloc(size_t size) { return malloc(size); }
+void* ps_calloc(size_t count, size_t size) { return calloc(count, size); }
+void* ps_realloc(void* pointer, size_t size) { return realloc(pointer, size); }
+void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+void* heap_caps_calloc(size_t count, size_t size, uint32_t) { return calloc(count, size); }
+void heap_caps_free(void* pointer) { free(pointer); }
+size_t heap_caps_get_free_size(uint32_t) { return 4 * 1024 * 1024; }
+
+void pinMode(int, int) {}
+void digitalWrite(int pin, int level) { if (pin >= 0 && pin < 64) hostPinLevels[pin] = level; }
+int digitalRead(int pin) { return pin >= 0 && pin < 64 ? hostPinLevels[pin] : LOW; }
+int analogRead(int) { return 0; }
+void analogWrite(int, int) {}
+double ledcSetup(int channel, double frequency, int) { hostLedcFrequency[channel & 15] = frequency; return frequency; }
+void ledcAttachPin(int, int) {}
+void ledcDetachPin(int) {}
+void ledcWrite(int channel, uint32_t duty) { hostLedcDuty[channel & 15] = duty; }
+double ledcWriteTone(int channel, double frequency) { hostLedcFrequency[channel & 15] = frequency; return frequency; }
+
+long random(long limit) { return limit > 0 ? rand() % limit : 0; }
+long random(long low, long high) { return high > low ? low + rand() % (high - low) : low; }
+void randomSeed(unsigned long seed) { srand(seed); }
+long map(long x, long inLow, long inHigh, long outLow, long outHigh) {
+    return (x - inLow) * (outHigh - outLow) / (inHigh - inLow) + outLow;
+}
+
+// ===================
+// FreeRTOS
+// ===================
+
+static std::recursive_mutex hostCritical;
+void hostEnterCritical(portMUX_TYPE*) { hostCritical.lock(); }
+void hostExitCritical(portMUX_TYPE*) { hostCritical.unlock(); }
+
+struct HostTask {
+    std::mutex lock;
+    std::condition_variable wake;
+    uint32_t notifications = 0;
+};
+
+static thread_local HostTask* hostCurrentTask = nullptr;
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+    if (!hostCurrentTask) hostCurrentTask = new HostTask;
+    return hostCurrentTask;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char*, uint32_t, void* param,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t) {
+    if (!hostStartTasks) {
+        if (handle) *handle = nullptr;
+        return pdPASS;
+    }
+    HostTask* task = new HostTask;
+    if (handle) *handle = task;
+    std::thread([=] {
+        hostCurrentTask = task;
+        function(param);
+    }).detach();
+    return pdPASS;
+}
+
+// Tasks return right after deleting themselves, which ends the thread
+void vTaskDelete(TaskHandle_t) {}
+void vTaskDelay(TickType_t ticks) { delay(ticks); }
+TickType_t xTaskGetTickCount() { return millis(); }
+BaseType_t xPortGetCoreID() { return 0; }
+
+void vTaskDelayUntil(TickType_t* previous, TickType_t ticks) {
+    *previous += ticks;
+    TickType_t now = xTaskGetTickCount();
+    if ((int32_t)(*previous - now) > 0) delay(*previous - now);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    HostTask* task = (HostTask*)xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    task->wake.wait_for(guard, std::chrono::milliseconds(ticks), [task] { return task->notifications > 0; });
+    uint32_t count = task->notifications;
+    if (clear) task->notifications = 0;
+    else if (count) task->notifications--;
+    return count;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t handle) {
+    HostTask* task = (HostTask*)handle;
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->wake.notify_one();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t handle, BaseType_t* woken) {
+    xTaskNotifyGive(handle);
+    if (woken) *woken = pdFALSE;
+}
+
+struct HostQueue {
+    std::mutex lock;
+    std::condition_variable changed;
+    std::deque<std::vector<uint8_t>> items;
+    UBaseType_t length;
+    UBaseType_t itemSize;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    HostQueue* queue = new HostQueue;
+    queue->length = length;
+    queue->itemSize = itemSize;
+    return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t handle, const void* item, TickType_t ticks) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!queue->changed.wait_for(guard, std::chrono::milliseconds(ticks),
+                                 [queue] { return queue->items.size() < queue->length; })) {
+        return pdFALSE;
+    }
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t handle, const void* item, TickType_t ticks) {
+    return xQueueSend(handle, item, ticks);
+}
+
+// Only meant for queues of length one, as on the target
+BaseType_t xQueueOverwrite(QueueHandle_t handle, const void* item) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    const uint8_t* bytes = (const uint8_t*)item;
+    queue->items.clear();
+    queue->items.emplace_back(bytes, bytes + queue->itemSize);
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+static BaseType_t hostQueueTake(QueueHandle_t handle, void* item, TickType_t ticks, bool remove) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::unique_lock<std::mutex> guard(queue->lock);
+    if (!queue->changed.wait_for(guard, std::chrono::milliseconds(ticks), [queue] { return !queue->items.empty(); })) {
+        return pdFALSE;
+    }
+    memcpy(item, queue->items.front().data(), queue->itemSize);
+    if (remove) {
+        queue->items.pop_front();
+        queue->changed.notify_all();
+    }
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t handle, void* item, TickType_t ticks) {
+    return hostQueueTake(handle, item, ticks, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t handle, void* item, TickType_t ticks) {
+    return hostQueueTake(handle, item, ticks, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    queue->items.clear();
+    queue->changed.notify_all();
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t handle) {
+    HostQueue* queue = (HostQueue*)handle;
+    std::lock_guard<std::mutex> guard(queue->lock);
+    return queue->length - queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t handle) { delete (HostQueue*)handle; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new std::timed_mutex; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+    std::timed_mutex* mutex = (std::timed_mutex*)semaphore;
+    if (ticks == portMAX_DELAY) {
+        mutex->lock();
+        return pdTRUE;
+    }
+    return mutex->try_lock_for(std::chrono::milliseconds(ticks)) ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+    ((std::timed_mutex*)semaphore)->unlock();
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete (std::timed_mutex*)semaphore; }
+
+#endif // HOST_RUNTIME_H
@@ -0,0 +1,49 @@
+#ifndef HOST_MP3DEC_H
+#define HOST_MP3DEC_H
+
+// Host stand-in for the helix MP3 decoder API. Declarations only: a test that
+// builds mp3_stream.cpp defines these functions itself
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void* HMP3Decoder;
+
+enum {
+    ERR_MP3_NONE = 0,
+    ERR_MP3_INDATA_UNDERFLOW = -1,
+    ERR_MP3_MAINDATA_UNDERFLOW = -2,
+    ERR_MP3_FREE_BITRATE_SYNC = -3,
+    ERR_MP3_OUT_OF_MEMORY = -4,
+    ERR_MP3_NULL_POINTER = -5,
+    ERR_MP3_INVALID_FRAMEHEADER = -6,
+    ERR_MP3_INVALID_SIDEINFO = -7,
+    ERR_MP3_INVALID_SCALEFACT = -8,
+    ERR_MP3_INVALID_HUFFCODES = -9,
+    ERR_MP3_INVALID_DEQUANTIZE = -10,
+    ERR_MP3_INVALID_IMDCT = -11,
+    ERR_MP3_INVALID_SUBBAND = -12,
+    ERR_UNKNOWN = -9999
+};
+
+typedef struct _MP3FrameInfo {
+    int bitrate;
+    int nChans;
+    int samprate;
+    int bitsPerSample;
+    int outputSamps;
+    int layer;
+    int version;
+} MP3FrameInfo;
+
+HMP3Decoder MP3InitDecoder(void);
+void MP3FreeDecoder(HMP3Decoder hMP3Decoder);
+int MP3Decode(HMP3Decoder hMP3Decoder, unsigned char** inbuf, int* bytesLeft, short* outbuf, int useSize);
+void MP3GetLastFrameInfo(HMP3Decoder hMP3Decoder, MP3FrameInfo* mp3FrameInfo);
+int MP3FindSyncWord(unsigned char* buf, int nBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_MP3DEC_H
@@ -0,0 +1,620 @@
+#ifndef TEST_IMAGES_H
+#define TEST_IMAGES_H
+
+// 160x120 baseline JPEG, 4:2:2 like the camera's, quality 75: a colour
+// gradient with a red rectangle at (20,30)-(70,90), a blue disc centred at
+// (120,45) and a white panel at (90,85)-(150,110) with five black bars.
+#include <cstdint>
+#include <cstddef>
+
+static const uint8_t TEST_SCENE_JPEG[] = {
+    0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x08, 0x06, 0x06, 0x07, 0x06, 0x05, 0x08,
+    0x07, 0x07, 0x07, 0x09, 0x09, 0x08, 0x0a, 0x0c, 0x14, 0x0d, 0x0c, 0x0b, 0x0b, 0x0c, 0x19, 0x12,
+    0x13, 0x0f, 0x14, 0x1d, 0x1a, 0x1f, 0x1e, 0x1d, 0x1a, 0x1c, 0x1c, 0x20, 0x24, 0x2e, 0x27, 0x20,
+    0x22, 0x2c, 0x23, 0x1c, 0x1c, 0x28, 0x37, 0x29, 0x2c, 0x30, 0x31, 0x34, 0x34, 0x34, 0x1f, 0x27,
+    0x39, 0x3d, 0x38, 0x32, 0x3c, 0x2e, 0x33, 0x34, 0x32, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x09, 0x09,
+    0x09, 0x0c, 0x0b, 0x0c, 0x18, 0x0d, 0x0d, 0x18, 0x32, 0x21, 0x1c, 0x21, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0xff, 0xc0,
+    0x00, 0x11, 0x08, 0x00, 0x78, 0x00, 0xa0, 0x03, 0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+    0x01, 0xff, 0xc4, 0x00, 0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+    0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05,
+    0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21,
+    0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23,
+    0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a,
+    0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+    0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7,
+    0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5,
+    0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1,
+    0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00,
+    0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00,
+    0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13,
+    0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15,
+    0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27,
+    0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+    0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4,
+    0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9,
+    0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xe4,
+    0xb6, 0xd2, 0xed, 0xaf, 0x6d, 0xb3, 0x89, 0x31, 0x76, 0xd2, 0xed, 0xa9, 0x6c, 0xd1, 0x31, 0x76,
+    0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xac, 0xdb, 0x34, 0x4c, 0x5d, 0xb4, 0xbb,
+    0x6a, 0x1b, 0x34, 0x4c, 0x5d, 0xb4, 0xbb, 0x6a, 0x5b, 0x2d, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c,
+    0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x31,
+    0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x32, 0x8e, 0xda, 0x5d, 0xb5, 0xec, 0x36, 0x7c, 0xca, 0x62,
+    0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5,
+    0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50,
+    0xd9, 0x69, 0x8b, 0xb6, 0x97, 0x6d, 0x43, 0x66, 0x89, 0x8b, 0xb6, 0x8d, 0xb5, 0x0d, 0x9a, 0x26,
+    0x2e, 0xda, 0x5d, 0xb5, 0x0d, 0x9a, 0x26, 0x2e, 0xda, 0x5d, 0xb5, 0x0d, 0x9a, 0x26, 0x52, 0xdb,
+    0x4b, 0xb6, 0xbd, 0x96, 0xcf, 0x99, 0x4c, 0x5d, 0xb4, 0xbb, 0x6a, 0x1b, 0x34, 0x4c, 0x5d, 0xb4,
+    0xbb, 0x6a, 0x1b, 0x34, 0x4c, 0x36, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8,
+    0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xb4, 0xc5, 0xdb, 0x4c, 0x96, 0x58, 0xa0, 0x5d,
+    0xd2, 0x38, 0x51, 0xdb, 0x3d, 0x4d, 0x10, 0x84, 0xaa, 0x49, 0x42, 0x0a, 0xed, 0x96, 0xe6, 0xa2,
+    0xae, 0xca, 0x4f, 0xab, 0x46, 0x31, 0xb2, 0x26, 0x6f, 0x5d, 0xc7, 0x1f, 0xe3, 0x42, 0x6a, 0xe8,
+    0x4f, 0xcf, 0x0b, 0x01, 0xfe, 0xc9, 0xcf, 0xf8, 0x57, 0xaf, 0xfd, 0x87, 0x53, 0x92, 0xfc, 0xea,
+    0xff, 0x00, 0x87, 0xdf, 0xff, 0x00, 0x00, 0xe7, 0xfa, 0xf4, 0x6f, 0xb6, 0x85, 0xeb, 0x7b, 0x88,
+    0x6e, 0x46, 0x63, 0x70, 0x4f, 0x75, 0x3d, 0x45, 0x4f, 0xb6, 0xbc, 0x4a, 0xf4, 0xa7, 0x46, 0x6e,
+    0x13, 0x56, 0x68, 0xef, 0xa7, 0x51, 0x4d, 0x73, 0x44, 0x5d, 0xb4, 0xbb, 0x6b, 0x9d, 0xb3, 0x64,
+    0xca, 0x3b, 0x69, 0x76, 0xd7, 0xb0, 0xd9, 0xf3, 0x29, 0x88, 0xee, 0x91, 0xe3, 0x71, 0xc6, 0x7a,
+    0x71, 0x4d, 0xf3, 0xe1, 0xfe, 0xff, 0x00, 0xe8, 0x6b, 0x96, 0xa6, 0x2e, 0x94, 0x25, 0xcb, 0x27,
+    0xaf, 0xcc, 0xf5, 0xb0, 0xd9, 0x4e, 0x33, 0x11, 0x4d, 0x55, 0xa5, 0x0b, 0xc5, 0xf9, 0xaf, 0x4e,
+    0xac, 0x5f, 0xb4, 0x43, 0xfd, 0xff, 0x00, 0xd0, 0xd1, 0xf6, 0x88, 0x7f, 0xbf, 0xfa, 0x1a, 0xc9,
+    0xe3, 0x68, 0x7f, 0x37, 0xe0, 0xce, 0x95, 0x91, 0xe6, 0x1f, 0xf3, 0xef, 0xf1, 0x8f, 0xf9, 0x8b,
+    0xf6, 0x98, 0x7f, 0xbf, 0xfa, 0x1a, 0x5f, 0xb4, 0xc1, 0xfd, 0xff, 0x00, 0xd0, 0xd4, 0x3c, 0x65,
+    0x1f, 0xe6, 0xfc, 0xca, 0x59, 0x26, 0x3f, 0xfe, 0x7d, 0xfe, 0x2b, 0xfc, 0xc5, 0x5b, 0x88, 0x59,
+    0x82, 0x87, 0xc9, 0x27, 0x03, 0x83, 0x53, 0xed, 0xab, 0x85, 0x58, 0x54, 0x57, 0x8b, 0x39, 0xf1,
+    0x18, 0x4a, 0xd8, 0x56, 0xa3, 0x5a, 0x36, 0x6f, 0xcd, 0x7e, 0x82, 0xed, 0xa5, 0xdb, 0x4d, 0xb3,
+    0x14, 0xca, 0xd7, 0xb7, 0x69, 0x68, 0x9d, 0x9a, 0x43, 0xf7, 0x57, 0xfa, 0x9a, 0xc1, 0x77, 0x69,
+    0x1c, 0xbb, 0xb1, 0x66, 0x3d, 0x49, 0xaf, 0xa3, 0xc9, 0xf0, 0xdc, 0x94, 0xdd, 0x69, 0x6e, 0xf6,
+    0xf4, 0xff, 0x00, 0x82, 0x72, 0xe2, 0x6a, 0x5d, 0xf2, 0xae, 0x83, 0x68, 0xaf, 0x68, 0xe5, 0x14,
+    0x12, 0xa4, 0x10, 0x48, 0x23, 0x90, 0x47, 0x6a, 0xde, 0xd3, 0xaf, 0xc5, 0xd0, 0x11, 0x48, 0x40,
+    0x98, 0x7f, 0xe3, 0xdf, 0xfd, 0x7a, 0xf1, 0xb3, 0x9c, 0x2f, 0xb5, 0xa3, 0xed, 0x23, 0xbc, 0x7f,
+    0x2e, 0xbf, 0xe6, 0x75, 0xe0, 0xea, 0xf2, 0x4f, 0x95, 0xec, 0xcd, 0x1d, 0xb4, 0xbb, 0x6b, 0xe3,
+    0xdb, 0x3d, 0x94, 0xca, 0x3b, 0x69, 0x76, 0xd7, 0xb0, 0xd9, 0xf3, 0x29, 0x95, 0x2f, 0x86, 0x3c,
+    0xbf, 0xc7, 0xfa, 0x55, 0x4a, 0xf9, 0xec, 0x6f, 0xf1, 0xe5, 0xf2, 0xfc, 0x8f, 0xd3, 0x32, 0x0f,
+    0xf9, 0x17, 0x53, 0xf9, 0xff, 0x00, 0xe9, 0x4c, 0x28, 0xae, 0x43, 0xd9, 0x0a, 0x28, 0x02, 0x48,
+    0x3f, 0xe3, 0xe2, 0x3f, 0xf7, 0x87, 0xf3, 0xad, 0xad, 0xb5, 0xe9, 0x60, 0x7e, 0x16, 0x7c, 0x7f,
+    0x12, 0x7f, 0x16, 0x9f, 0xa3, 0xfc, 0xc5, 0xdb, 0x4b, 0xb6, 0xba, 0xdb, 0x3e, 0x75, 0x33, 0x97,
+    0xbb, 0xb8, 0x37, 0x37, 0x2f, 0x27, 0x38, 0x27, 0x0a, 0x0f, 0x61, 0x50, 0xd7, 0xdd, 0xd1, 0xa7,
+    0xec, 0xa9, 0xc6, 0x0b, 0xa2, 0x3c, 0xf9, 0x3b, 0xb6, 0xc2, 0x8a, 0xd4, 0x41, 0x4f, 0x86, 0x56,
+    0x82, 0x64, 0x95, 0x0f, 0xcc, 0xa7, 0x22, 0xa2, 0x70, 0x53, 0x8b, 0x8b, 0xd9, 0x8d, 0x3b, 0x3b,
+    0xa3, 0xaf, 0x89, 0x84, 0xb1, 0x24, 0x8a, 0x0e, 0x1d, 0x43, 0x0c, 0xfb, 0xd3, 0xf6, 0xd7, 0xe7,
+    0x13, 0x4e, 0x32, 0x71, 0x7d, 0x0f, 0x7e, 0x32, 0xba, 0xb9, 0x4b, 0x6d, 0x2e, 0xda, 0xf5, 0xdb,
+    0x3e, 0x69, 0x32, 0x96, 0xa2, 0x31, 0xe5, 0xfe, 0x3f, 0xd2, 0xa8, 0xd7, 0xcf, 0xe3, 0x7f, 0x8f,
+    0x2f, 0x97, 0xe4, 0x7e, 0x9d, 0xc3, 0xff, 0x00, 0xf2, 0x2e, 0xa7, 0xf3, 0xff, 0x00, 0xd2, 0x98,
+    0x51, 0x5c, 0xa7, 0xb4, 0x14, 0x50, 0x04, 0x96, 0xff, 0x00, 0xf1, 0xf3, 0x17, 0xfb, 0xe3, 0xf9,
+    0xd6, 0xf6, 0xda, 0xf4, 0x70, 0x7f, 0x0b, 0x3e, 0x3b, 0x89, 0xbf, 0x8d, 0x4f, 0xd1, 0xfe, 0x62,
+    0xed, 0xa8, 0xee, 0xb2, 0xb6, 0x73, 0xb2, 0x92, 0x08, 0x8d, 0x88, 0x23, 0xb7, 0x15, 0xdd, 0x4e,
+    0xce, 0xa4, 0x53, 0xee, 0x8f, 0x9b, 0xbe, 0x87, 0x25, 0x45, 0x7d, 0xf1, 0xc2, 0x14, 0x50, 0x01,
+    0x45, 0x00, 0x75, 0x9a, 0x46, 0x5b, 0x4b, 0x80, 0x92, 0x49, 0xc1, 0x1c, 0xfd, 0x4d, 0x5e, 0xdb,
+    0x5f, 0x9d, 0x63, 0x6c, 0xb1, 0x35, 0x12, 0xfe, 0x67, 0xf9, 0x9e, 0xdd, 0x17, 0xee, 0x47, 0xd0,
+    0xa3, 0xb6, 0x97, 0x6d, 0x77, 0xb6, 0x7c, 0xe2, 0x65, 0x0d, 0x4c, 0x63, 0xca, 0xfc, 0x7f, 0xa5,
+    0x67, 0xd7, 0x85, 0x8c, 0xfe, 0x34, 0xbe, 0x5f, 0x91, 0xfa, 0x8f, 0x0f, 0x7f, 0xc8, 0xb6, 0x9f,
+    0xcf, 0xff, 0x00, 0x4a, 0x61, 0x45, 0x72, 0x9e, 0xd0, 0x51, 0x40, 0x12, 0xdb, 0x7f, 0xc7, 0xd4,
+    0x3f, 0xef, 0xaf, 0xf3, 0xae, 0x8b, 0x6d, 0x77, 0xe1, 0x3e, 0x16, 0x7c, 0x67, 0x13, 0xff, 0x00,
+    0x1a, 0x9f, 0xa3, 0xfc, 0xc5, 0xdb, 0x48, 0xf1, 0x2c, 0x91, 0xb2, 0x38, 0xca, 0xb0, 0x20, 0x8f,
+    0x51, 0x5d, 0x6a, 0x4e, 0x2e, 0xe8, 0xf9, 0xa4, 0xce, 0x31, 0xd1, 0xa3, 0x91, 0x91, 0xc6, 0x19,
+    0x49, 0x04, 0x7a, 0x11, 0x4d, 0xaf, 0xd0, 0xa2, 0xd4, 0x95, 0xd1, 0xc8, 0x14, 0x53, 0x00, 0xa2,
+    0x80, 0x3b, 0x6b, 0x1b, 0x7f, 0xb3, 0xd8, 0xc3, 0x11, 0x5d, 0xa5, 0x50, 0x6e, 0x19, 0xcf, 0x3d,
+    0xff, 0x00, 0x5c, 0xd5, 0x9d, 0xb5, 0xf9, 0x9e, 0x22, 0xa7, 0xb4, 0xab, 0x29, 0xf7, 0x6d, 0x9e,
+    0xcc, 0x34, 0x8a, 0x45, 0x1d, 0xb4, 0xbb, 0x6b, 0xd4, 0x6c, 0xf9, 0xb4, 0xcc, 0xdd, 0x58, 0x63,
+    0xc9, 0xff, 0x00, 0x81, 0x7f, 0x4a, 0xcd, 0xaf, 0x0f, 0x17, 0xfc, 0x67, 0xfd, 0x74, 0x3f, 0x53,
+    0xe1, 0xdf, 0xf9, 0x16, 0x52, 0xf9, 0xff, 0x00, 0xe9, 0x4c, 0x28, 0xae, 0x63, 0xdb, 0x0a, 0x28,
+    0x02, 0x5b, 0x5f, 0xf8, 0xfb, 0x87, 0xfe, 0xba, 0x2f, 0xf3, 0xae, 0x9f, 0x6d, 0x77, 0x61, 0x7e,
+    0x16, 0x7c, 0x57, 0x14, 0x7f, 0x1a, 0x9f, 0xa3, 0xfc, 0xc5, 0xdb, 0x4b, 0xb6, 0xba, 0x1b, 0x3e,
+    0x69, 0x33, 0x0b, 0x5d, 0xd3, 0x5c, 0xb1, 0xbc, 0x88, 0x64, 0x63, 0xf7, 0x80, 0x75, 0x18, 0xef,
+    0xf9, 0x56, 0x05, 0x7d, 0xa6, 0x53, 0x88, 0x55, 0xb0, 0xd1, 0x5d, 0x63, 0xa3, 0xf9, 0x6d, 0xf8,
+    0x18, 0xcd, 0x59, 0x85, 0x15, 0xe9, 0x90, 0x15, 0xb3, 0xa1, 0x69, 0x8f, 0x3c, 0xe9, 0x77, 0x22,
+    0xe2, 0x18, 0xce, 0x57, 0x3f, 0xc4, 0xc3, 0xd3, 0xe8, 0x7f, 0xc2, 0xbc, 0xfc, 0xcf, 0x12, 0xb0,
+    0xf8, 0x59, 0x49, 0xee, 0xf4, 0x5e, 0xaf, 0xfa, 0xb9, 0xa5, 0x28, 0xf3, 0x4d, 0x23, 0xaa, 0xdb,
+    0x4b, 0xb6, 0xbf, 0x3c, 0x6c, 0xf5, 0x13, 0x28, 0xed, 0xa5, 0xdb, 0x5e, 0xcb, 0x67, 0xcc, 0xa6,
+    0x65, 0xeb, 0x23, 0x1e, 0x47, 0xfc, 0x0b, 0xfa, 0x56, 0x55, 0x78, 0x98, 0xaf, 0xe3, 0x3f, 0xeb,
+    0xa1, 0xfa, 0xaf, 0x0e, 0x7f, 0xc8, 0xb2, 0x97, 0xcf, 0xff, 0x00, 0x4a, 0x61, 0x45, 0x73, 0x9e,
+    0xe0, 0x51, 0x40, 0x13, 0x5a, 0x7f, 0xc7, 0xec, 0x1f, 0xf5, 0xd1, 0x7f, 0x9d, 0x75, 0x7b, 0x6b,
+    0xb7, 0x0d, 0xf0, 0xb3, 0xe2, 0x78, 0xab, 0xf8, 0xd4, 0xfd, 0x1f, 0xe6, 0x2e, 0xda, 0x5d, 0xb5,
+    0xbb, 0x67, 0xcc, 0x26, 0x2e, 0xda, 0xc4, 0xbe, 0xf0, 0xe2, 0x4a, 0xcd, 0x25, 0xab, 0x88, 0xd8,
+    0x9c, 0xec, 0x6f, 0xbb, 0xf8, 0x7a, 0x77, 0xf5, 0xfc, 0x2b, 0xb7, 0x2f, 0xc7, 0xbc, 0x1d, 0x5e,
+    0x6b, 0x5e, 0x2f, 0x75, 0xfd, 0x75, 0x43, 0x6b, 0x99, 0x18, 0xb2, 0xe9, 0x1a, 0x84, 0x38, 0xdd,
+    0x6b, 0x21, 0xcf, 0xf7, 0x06, 0xef, 0xe5, 0x9a, 0x48, 0xb4, 0xab, 0xf9, 0x98, 0xaa, 0xda, 0x4a,
+    0x08, 0x19, 0xf9, 0xd7, 0x68, 0xfc, 0xcd, 0x7d, 0x6a, 0xcc, 0xf0, 0x6e, 0x1c, 0xfe, 0xd1, 0x5b,
+    0xf1, 0xfb, 0xb7, 0xfc, 0x0c, 0xb9, 0x25, 0x7b, 0x58, 0xd7, 0xb1, 0xf0, 0xcf, 0xdd, 0x7b, 0xd7,
+    0xf7, 0xf2, 0xd0, 0xfd, 0x3a, 0x9f, 0xcc, 0x71, 0xf9, 0xd7, 0x44, 0xb1, 0xaa, 0x28, 0x55, 0x50,
+    0xaa, 0x06, 0x00, 0x03, 0x00, 0x0a, 0xf9, 0x1c, 0xd7, 0x32, 0x78, 0xca, 0x89, 0x47, 0x48, 0xad,
+    0xbf, 0xcc, 0xeb, 0xa5, 0x0e, 0x54, 0x3b, 0x6d, 0x2e, 0xda, 0xf1, 0xdb, 0x3a, 0x13, 0x29, 0x6d,
+    0xa5, 0xdb, 0x5e, 0xc3, 0x67, 0xcc, 0xa6, 0x64, 0x6b, 0x83, 0x1e, 0x47, 0xfc, 0x0b, 0xfa, 0x56,
+    0x45, 0x78, 0xf8, 0xaf, 0xe2, 0xbf, 0xeb, 0xa1, 0xfa, 0xbf, 0x0d, 0xff, 0x00, 0xc8, 0xae, 0x97,
+    0xfd, 0xbd, 0xff, 0x00, 0xa5, 0x30, 0xa2, 0xb9, 0xcf, 0x74, 0x28, 0xa0, 0x09, 0xec, 0xff, 0x00,
+    0xe3, 0xfa, 0xdf, 0xfe, 0xba, 0x2f, 0xf3, 0xae, 0xbb, 0x6d, 0x75, 0xe1, 0xf6, 0x67, 0xc3, 0xf1,
+    0x5f, 0xf1, 0xa9, 0xfa, 0x3f, 0xcc, 0x5d, 0xb4, 0xbb, 0x6b, 0x66, 0xcf, 0x97, 0x4c, 0x5d, 0xb4,
+    0xbb, 0x6a, 0x1b, 0x2d, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8,
+    0x6c, 0xd1, 0x31, 0x76, 0xd2, 0xed, 0xa8, 0x6c, 0xd1, 0x32, 0x8e, 0xda, 0x5d, 0xb5, 0xec, 0xb6,
+    0x7c, 0xca, 0x66, 0x36, 0xbe, 0x31, 0xf6, 0x7f, 0xf8, 0x17, 0xf4, 0xac, 0x6a, 0xf2, 0x31, 0x3f,
+    0xc5, 0x67, 0xeb, 0x5c, 0x35, 0xff, 0x00, 0x22, 0xba, 0x5f, 0xf6, 0xf7, 0xfe, 0x94, 0xc2, 0x8a,
+    0xc0, 0xf7, 0x42, 0x8a, 0x00, 0x9e, 0xcb, 0xfe, 0x3f, 0xed, 0xff, 0x00, 0xeb, 0xaa, 0xff, 0x00,
+    0x31, 0x5d, 0x9e, 0xda, 0xea, 0xa1, 0xb3, 0x3e, 0x17, 0x8b, 0x3f, 0x8d, 0x4f, 0xd1, 0xfe, 0x62,
+    0xed, 0xad, 0xfd, 0x37, 0xc2, 0x17, 0xfa, 0x9d, 0x84, 0x57, 0x90, 0xcd, 0x6c, 0xb1, 0xc9, 0x9c,
+    0x07, 0x66, 0x07, 0x82, 0x47, 0x65, 0x3e, 0x95, 0xba, 0x4e, 0x4e, 0xc8, 0xf9, 0x9a, 0x50, 0x73,
+    0x76, 0x45, 0xbf, 0xf8, 0x40, 0xb5, 0x4f, 0xf9, 0xef, 0x67, 0xff, 0x00, 0x7d, 0xb7, 0xff, 0x00,
+    0x13, 0x47, 0xfc, 0x20, 0x5a, 0xa7, 0xfc, 0xf7, 0xb3, 0xff, 0x00, 0xbe, 0xdb, 0xff, 0x00, 0x89,
+    0xa6, 0xe8, 0xc8, 0xe8, 0x58, 0x79, 0x8b, 0xff, 0x00, 0x08, 0x1e, 0xa7, 0xff, 0x00, 0x3d, 0xec,
+    0xff, 0x00, 0xef, 0xb6, 0xff, 0x00, 0xe2, 0x69, 0x7f, 0xe1, 0x03, 0xd4, 0xff, 0x00, 0xe7, 0xbd,
+    0x9f, 0xfd, 0xf6, 0xdf, 0xfc, 0x4d, 0x4b, 0xa1, 0x22, 0xd5, 0x19, 0x07, 0xfc, 0x20, 0x9a, 0x9f,
+    0xfc, 0xf7, 0xb3, 0xff, 0x00, 0xbe, 0xdb, 0xff, 0x00, 0x89, 0xa5, 0xff, 0x00, 0x84, 0x13, 0x53,
+    0xff, 0x00, 0x9e, 0xf6, 0x9f, 0xf7, 0xdb, 0x7f, 0xf1, 0x35, 0x2f, 0x0f, 0x32, 0x95, 0x29, 0x11,
+    0xdc, 0xf8, 0x33, 0x50, 0xb5, 0xb5, 0x96, 0xe1, 0xe6, 0xb5, 0x29, 0x12, 0x17, 0x60, 0xac, 0xd9,
+    0x20, 0x0c, 0xf1, 0xf2, 0xd7, 0x3f, 0xb6, 0xb0, 0xab, 0x4d, 0xc3, 0x46, 0x36, 0x9c, 0x77, 0x28,
+    0xed, 0xa5, 0xdb, 0x5e, 0xab, 0x67, 0xcb, 0xa6, 0x56, 0xbc, 0xd3, 0xa2, 0xbe, 0xd9, 0xe6, 0xb3,
+    0x8d, 0x99, 0xc6, 0xd2, 0x3b, 0xfe, 0x1e, 0xd5, 0x57, 0xfe, 0x11, 0xeb, 0x5f, 0xf9, 0xe9, 0x37,
+    0xe6, 0x3f, 0xc2, 0xb9, 0x6a, 0x50, 0x8c, 0xe5, 0xcc, 0xcf, 0xa5, 0xc0, 0x71, 0x2e, 0x2f, 0x05,
+    0x87, 0x8e, 0x1e, 0x9c, 0x62, 0xd4, 0x6f, 0xba, 0x77, 0xd5, 0xb7, 0xdd, 0x77, 0x17, 0xfe, 0x11,
+    0xeb, 0x5f, 0xf9, 0xe9, 0x37, 0xfd, 0xf4, 0x3f, 0xc2, 0x8f, 0xf8, 0x47, 0x6d, 0x3f, 0xe7, 0xa4,
+    0xdf, 0xf7, 0xd0, 0xff, 0x00, 0x0a, 0xc9, 0xe1, 0xa0, 0x76, 0xae, 0x30, 0xc7, 0x7f, 0x24, 0x3e,
+    0xe7, 0xff, 0x00, 0xc9, 0x0b, 0xff, 0x00, 0x08, 0xed, 0xa7, 0xfc, 0xf4, 0x9f, 0xfe, 0xfa, 0x1f,
+    0xe1, 0x4b, 0xff, 0x00, 0x08, 0xe5, 0xa7, 0xfc, 0xf4, 0x9f, 0xfe, 0xfa, 0x1f, 0xe1, 0x52, 0xe8,
+    0x44, 0xb5, 0xc5, 0xd8, 0xdf, 0xe5, 0x8f, 0xdc, 0xff, 0x00, 0xf9, 0x21, 0xf0, 0xe8, 0x16, 0xb0,
+    0xcc, 0x92, 0xac, 0x93, 0x16, 0x46, 0x0c, 0x32, 0x46, 0x38, 0xfc, 0x2b, 0x57, 0x6d, 0x54, 0x62,
+    0xa1, 0xb1, 0xe5, 0xe6, 0x19, 0xa5, 0x6c, 0xc2, 0x51, 0x9d, 0x54, 0x95, 0xbb, 0x5f, 0xf5, 0x6c,
+    0x5d, 0xb5, 0xdc, 0x25, 0xe5, 0xc6, 0x9b, 0xf0, 0xa6, 0xfe, 0xfa, 0xd2, 0x4f, 0x2e, 0xe6, 0xda,
+    0xc2, 0xea, 0x68, 0x9f, 0x68, 0x3b, 0x5d, 0x43, 0x95, 0x38, 0x3c, 0x1e, 0x40, 0xeb, 0x5a, 0xd2,
+    0xf8, 0x8c, 0xf0, 0x6f, 0xdf, 0x7e, 0x87, 0x01, 0xf0, 0x6f, 0xe2, 0x07, 0x8a, 0x3c, 0x57, 0xe2,
+    0xfb, 0xbb, 0x1d, 0x6f, 0x53, 0xfb, 0x55, 0xb4, 0x76, 0x0f, 0x32, 0xa7, 0xd9, 0xe2, 0x4c, 0x38,
+    0x92, 0x30, 0x0e, 0x55, 0x41, 0xe8, 0xc7, 0xf3, 0xac, 0x8f, 0x89, 0xbf, 0x13, 0x7c, 0x61, 0xe1,
+    0xef, 0x88, 0x7a, 0xa6, 0x97, 0xa5, 0xea, 0xff, 0x00, 0x67, 0xb2, 0x83, 0xca, 0xf2, 0xe2, 0xfb,
+    0x34, 0x2f, 0xb7, 0x74, 0x48, 0xc7, 0x96, 0x42, 0x4f, 0x24, 0x9e, 0xb5, 0xd0, 0x7a, 0x27, 0xa2,
+    0x7c, 0x64, 0xf1, 0x36, 0xb1, 0xe1, 0x4f, 0x08, 0x5a, 0x5f, 0x68, 0x97, 0x9f, 0x65, 0xb9, 0x92,
+    0xfd, 0x21, 0x67, 0xf2, 0x91, 0xf2, 0x86, 0x39, 0x09, 0x18, 0x60, 0x47, 0x55, 0x1f, 0x95, 0x1f,
+    0x06, 0xfc, 0x4d, 0xac, 0x78, 0xaf, 0xc2, 0x17, 0x77, 0xda, 0xdd, 0xe7, 0xda, 0xae, 0x63, 0xbf,
+    0x78, 0x55, 0xfc, 0xa4, 0x4c, 0x20, 0x8e, 0x32, 0x06, 0x14, 0x01, 0xd5, 0x8f, 0xe7, 0x40, 0x1e,
+    0x77, 0xf0, 0xcb, 0xe2, 0x6f, 0x8c, 0x3c, 0x43, 0xf1, 0x0f, 0x4b, 0xd2, 0xf5, 0x4d, 0x5f, 0xed,
+    0x16, 0x53, 0xf9, 0xbe, 0x64, 0x5f, 0x66, 0x85, 0x37, 0x6d, 0x89, 0xd8, 0x72, 0xa8, 0x08, 0xe4,
+    0x03, 0xd6, 0xb5, 0xfe, 0x32, 0x7c, 0x40, 0xf1, 0x47, 0x85, 0x3c, 0x5f, 0x69, 0x63, 0xa2, 0x6a,
+    0x7f, 0x65, 0xb6, 0x92, 0xc1, 0x26, 0x64, 0xfb, 0x3c, 0x4f, 0x97, 0x32, 0x48, 0x09, 0xcb, 0x29,
+    0x3d, 0x14, 0x7e, 0x54, 0x01, 0xe9, 0xba, 0x65, 0xed, 0xc6, 0xa5, 0xf0, 0xde, 0xce, 0xfa, 0xee,
+    0x4f, 0x32, 0xe6, 0xe7, 0x48, 0x49, 0xa5, 0x7d, 0xa0, 0x6e, 0x76, 0x84, 0x12, 0x70, 0x38, 0x1c,
+    0x93, 0xd2, 0xb8, 0x1d, 0xb5, 0xc1, 0x8b, 0xdd, 0x18, 0xd4, 0xdc, 0xa5, 0xb6, 0x97, 0x6d, 0x77,
+    0x36, 0x7c, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9,
+    0xa2, 0x61, 0xb6, 0x97, 0x6d, 0x43, 0x66, 0x89, 0x8b, 0xb6, 0x97, 0x6d, 0x43, 0x66, 0x89, 0x8b,
+    0xb6, 0xba, 0xeb, 0xde, 0x3e, 0x0d, 0xeb, 0x1f, 0xf6, 0x0b, 0xbc, 0xff, 0x00, 0xd0, 0x64, 0xab,
+    0xa3, 0xf1, 0x1d, 0xd8, 0x27, 0xef, 0xbf, 0x43, 0xc8, 0x3f, 0x67, 0x9f, 0xf9, 0x1f, 0xef, 0xff,
+    0x00, 0xec, 0x17, 0x27, 0xfe, 0x8d, 0x8a, 0xb0, 0x7e, 0x33, 0xff, 0x00, 0xc9, 0x59, 0xd6, 0xff,
+    0x00, 0xed, 0x87, 0xfe, 0x88, 0x8e, 0xba, 0x8f, 0x4c, 0xf5, 0xaf, 0xda, 0x1b, 0xfe, 0x44, 0x0b,
+    0x0f, 0xfb, 0x0a, 0x47, 0xff, 0x00, 0xa2, 0xa5, 0xa3, 0xf6, 0x79, 0xff, 0x00, 0x91, 0x02, 0xff,
+    0x00, 0xfe, 0xc2, 0x92, 0x7f, 0xe8, 0xa8, 0xa8, 0x03, 0xc9, 0x7e, 0x0c, 0x7f, 0xc9, 0x59, 0xd1,
+    0x3f, 0xed, 0xbf, 0xfe, 0x88, 0x92, 0xb7, 0xbf, 0x68, 0x6f, 0xf9, 0x1f, 0xec, 0x3f, 0xec, 0x17,
+    0x1f, 0xfe, 0x8d, 0x96, 0x80, 0x3d, 0xb3, 0xc3, 0xbf, 0xf2, 0x4a, 0x34, 0x9f, 0xfb, 0x01, 0xc3,
+    0xff, 0x00, 0xa2, 0x05, 0x71, 0xbb, 0x6b, 0xcf, 0xc6, 0x7c, 0x48, 0xc2, 0xb6, 0xe8, 0xa3, 0xb6,
+    0x97, 0x6d, 0x76, 0xb6, 0x7c, 0x92, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5,
+    0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa5, 0xdb, 0x50,
+    0xd9, 0xa2, 0x62, 0xed, 0xae, 0xe3, 0x49, 0x7d, 0x2a, 0xeb, 0xc2, 0x03, 0x4c, 0xd4, 0x6e, 0x2d,
+    0xfc, 0x99, 0xe2, 0x96, 0x19, 0xe1, 0x79, 0x82, 0x12, 0x8c, 0x58, 0x11, 0xd4, 0x11, 0x90, 0x6a,
+    0xe8, 0xc9, 0x29, 0x6a, 0x77, 0x60, 0xe7, 0x18, 0xcd, 0xb9, 0x3b, 0x68, 0x56, 0xf0, 0xf7, 0x85,
+    0x3c, 0x0d, 0xe1, 0x4d, 0x42, 0x4b, 0xed, 0x12, 0x3b, 0x5b, 0x5b, 0x99, 0x22, 0x30, 0xb3, 0xfd,
+    0xb9, 0xdf, 0x28, 0x48, 0x24, 0x61, 0x9c, 0x8e, 0xaa, 0x3f, 0x2a, 0x83, 0x5a, 0xf0, 0x3f, 0xc3,
+    0xef, 0x10, 0xea, 0xd3, 0xea, 0x9a, 0xa5, 0xbd, 0xad, 0xc5, 0xec, 0xfb, 0x7c, 0xc9, 0x7e, 0xdf,
+    0x22, 0x6e, 0xda, 0xa1, 0x47, 0x0a, 0xe0, 0x0e, 0x00, 0x1d, 0x2b, 0xa7, 0xda, 0x43, 0xb9, 0xe9,
+    0x7b, 0x5a, 0x7f, 0xcc, 0xbe, 0xf3, 0x5b, 0xc4, 0x5a, 0x6f, 0x85, 0xbc, 0x57, 0xa7, 0xc7, 0x63,
+    0xad, 0xc9, 0x6b, 0x75, 0x6d, 0x1c, 0xa2, 0x65, 0x4f, 0xb5, 0x14, 0xc3, 0x80, 0x40, 0x39, 0x56,
+    0x07, 0xa3, 0x1f, 0xce, 0x8f, 0x0f, 0x69, 0xbe, 0x17, 0xf0, 0xa6, 0x9f, 0x25, 0x8e, 0x88, 0xf6,
+    0xb6, 0xb6, 0xd2, 0x4a, 0x66, 0x64, 0xfb, 0x51, 0x7c, 0xb9, 0x00, 0x13, 0x96, 0x62, 0x7a, 0x28,
+    0xfc, 0xa8, 0xf6, 0x90, 0xee, 0x87, 0xed, 0x21, 0xdd, 0x19, 0x3a, 0x2f, 0x81, 0xbe, 0x1f, 0xf8,
+    0x7b, 0x56, 0x83, 0x54, 0xd2, 0xed, 0xed, 0x6d, 0xef, 0x60, 0xdd, 0xe5, 0xcb, 0xf6, 0xf9, 0x1f,
+    0x6e, 0xe5, 0x2a, 0x78, 0x67, 0x20, 0xf0, 0x48, 0xe9, 0x56, 0x3c, 0x43, 0xe1, 0x3f, 0x03, 0xf8,
+    0xaf, 0x50, 0x8e, 0xfb, 0x5a, 0x8a, 0xd6, 0xea, 0xe6, 0x38, 0x84, 0x2a, 0xff, 0x00, 0x6d, 0x74,
+    0xc2, 0x02, 0x48, 0x18, 0x57, 0x03, 0xab, 0x1f, 0xce, 0x97, 0xb5, 0x87, 0xf3, 0x20, 0xf6, 0x90,
+    0xee, 0x8d, 0x49, 0x24, 0xd2, 0x6c, 0x7c, 0x36, 0xfa, 0x75, 0x8d, 0xcd, 0xba, 0xc1, 0x05, 0xa1,
+    0x82, 0x08, 0x84, 0xc1, 0x88, 0x55, 0x4d, 0xaa, 0xbc, 0x92, 0x4f, 0x00, 0x0f, 0x5a, 0xe1, 0x36,
+    0xd7, 0x06, 0x32, 0x71, 0x93, 0x5c, 0xae, 0xe6, 0x15, 0xa4, 0x9b, 0x56, 0x28, 0xed, 0xa5, 0xdb,
+    0x5d, 0xad, 0x9f, 0x24, 0x98, 0xbb, 0x69, 0x76, 0xd4, 0x36, 0x68, 0x98, 0xbb, 0x69, 0x76, 0xd4,
+    0xb6, 0x68, 0x98, 0xbb, 0x69, 0x76, 0xd4, 0x36, 0x68, 0x98, 0xbb, 0x69, 0x76, 0xd4, 0x36, 0x68,
+    0x98, 0xbb, 0x69, 0x76, 0xd4, 0x36, 0x68, 0x98, 0xbb, 0x69, 0x76, 0xd4, 0x36, 0x68, 0x98, 0xbb,
+    0x69, 0x76, 0xd4, 0x36, 0x5a, 0x62, 0xed, 0xa5, 0xdb, 0x50, 0xd9, 0xa2, 0x62, 0xed, 0xa3, 0x6d,
+    0x43, 0x66, 0x89, 0x9f, 0xff, 0xd9,
+};
+
+static const size_t TEST_SCENE_JPEG_LENGTH = sizeof(TEST_SCENE_JPEG);
+
+// 256x160 baseline JPEG, 4:2:2, quality 75: a white sign at (100,40)-(240,112)
+// reading "PLATFORM 4" and "EXIT Street" in 20 px bold sans on a wall gradient,
+// with a fence of four 6 px posts at x = 8-61 on the left.
+static const uint8_t TEST_TEXT_JPEG[] = {
+    0xff, 0xd8, 0xff, 0xe0, 0x00, 0x10, 0x4a, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0xff, 0xdb, 0x00, 0x43, 0x00, 0x08, 0x06, 0x06, 0x07, 0x06, 0x05, 0x08,
+    0x07, 0x07, 0x07, 0x09, 0x09, 0x08, 0x0a, 0x0c, 0x14, 0x0d, 0x0c, 0x0b, 0x0b, 0x0c, 0x19, 0x12,
+    0x13, 0x0f, 0x14, 0x1d, 0x1a, 0x1f, 0x1e, 0x1d, 0x1a, 0x1c, 0x1c, 0x20, 0x24, 0x2e, 0x27, 0x20,
+    0x22, 0x2c, 0x23, 0x1c, 0x1c, 0x28, 0x37, 0x29, 0x2c, 0x30, 0x31, 0x34, 0x34, 0x34, 0x1f, 0x27,
+    0x39, 0x3d, 0x38, 0x32, 0x3c, 0x2e, 0x33, 0x34, 0x32, 0xff, 0xdb, 0x00, 0x43, 0x01, 0x09, 0x09,
+    0x09, 0x0c, 0x0b, 0x0c, 0x18, 0x0d, 0x0d, 0x18, 0x32, 0x21, 0x1c, 0x21, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32,
+    0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0xff, 0xc0,
+    0x00, 0x11, 0x08, 0x00, 0xa0, 0x01, 0x00, 0x03, 0x01, 0x21, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11,
+    0x01, 0xff, 0xc4, 0x00, 0x1f, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+    0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05,
+    0x05, 0x04, 0x04, 0x00, 0x00, 0x01, 0x7d, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21,
+    0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xa1, 0x08, 0x23,
+    0x42, 0xb1, 0xc1, 0x15, 0x52, 0xd1, 0xf0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0a, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2a, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a,
+    0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a,
+    0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a,
+    0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99,
+    0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6, 0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7,
+    0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5,
+    0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe1, 0xe2, 0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf1,
+    0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9, 0xfa, 0xff, 0xc4, 0x00, 0x1f, 0x01, 0x00, 0x03,
+    0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0xff, 0xc4, 0x00, 0xb5, 0x11, 0x00,
+    0x02, 0x01, 0x02, 0x04, 0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00,
+    0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13,
+    0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91, 0xa1, 0xb1, 0xc1, 0x09, 0x23, 0x33, 0x52, 0xf0, 0x15,
+    0x62, 0x72, 0xd1, 0x0a, 0x16, 0x24, 0x34, 0xe1, 0x25, 0xf1, 0x17, 0x18, 0x19, 0x1a, 0x26, 0x27,
+    0x28, 0x29, 0x2a, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49,
+    0x4a, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69,
+    0x6a, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7a, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88,
+    0x89, 0x8a, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0xa2, 0xa3, 0xa4, 0xa5, 0xa6,
+    0xa7, 0xa8, 0xa9, 0xaa, 0xb2, 0xb3, 0xb4, 0xb5, 0xb6, 0xb7, 0xb8, 0xb9, 0xba, 0xc2, 0xc3, 0xc4,
+    0xc5, 0xc6, 0xc7, 0xc8, 0xc9, 0xca, 0xd2, 0xd3, 0xd4, 0xd5, 0xd6, 0xd7, 0xd8, 0xd9, 0xda, 0xe2,
+    0xe3, 0xe4, 0xe5, 0xe6, 0xe7, 0xe8, 0xe9, 0xea, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7, 0xf8, 0xf9,
+    0xfa, 0xff, 0xda, 0x00, 0x0c, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3f, 0x00, 0xc5,
+    0xa5, 0xac, 0x4d, 0x45, 0xa5, 0xa4, 0x31, 0x45, 0x28, 0xa4, 0x00, 0x29, 0x45, 0x21, 0x8a, 0x29,
+    0x45, 0x20, 0x16, 0x96, 0x90, 0xc5, 0xa5, 0xa4, 0x02, 0xd2, 0xd2, 0x01, 0x69, 0x69, 0x0c, 0x5a,
+    0x5a, 0x40, 0x02, 0x9c, 0x28, 0x18, 0x0a, 0x5a, 0x90, 0x16, 0x94, 0x52, 0x18, 0xb4, 0xb4, 0x00,
+    0xb4, 0xb4, 0x80, 0x5a, 0x5a, 0x43, 0x30, 0xa9, 0x6b, 0xb4, 0xc4, 0x5a, 0x5a, 0x00, 0x5a, 0x5a,
+    0x43, 0x01, 0x4e, 0x14, 0x80, 0x51, 0x40, 0xa4, 0x02, 0xd2, 0xd2, 0x18, 0xb4, 0xb4, 0x86, 0x2d,
+    0x2d, 0x20, 0x16, 0x96, 0x90, 0x0b, 0x4b, 0x48, 0x62, 0x8a, 0x51, 0x48, 0x00, 0x52, 0x8a, 0x43,
+    0x14, 0x52, 0x8a, 0x40, 0x2d, 0x2d, 0x00, 0x2d, 0x2d, 0x21, 0x8b, 0x4b, 0x48, 0x0c, 0x3a, 0xcc,
+    0xb4, 0xd5, 0xfe, 0xd5, 0x74, 0x90, 0xf9, 0x1b, 0x77, 0x67, 0x9d, 0xf9, 0xc7, 0x19, 0xf4, 0xae,
+    0xe3, 0x13, 0x56, 0xb3, 0x2c, 0xf5, 0x8f, 0xb5, 0x5d, 0x24, 0x1e, 0x46, 0xdd, 0xd9, 0xe7, 0x7e,
+    0x71, 0x81, 0x9f, 0x4a, 0x40, 0x6a, 0x0a, 0xcc, 0xb3, 0xd6, 0x7e, 0xd7, 0x74, 0x90, 0x7d, 0x9f,
+    0x6e, 0xec, 0xfc, 0xdb, 0xf3, 0x8c, 0x0c, 0xfa, 0x52, 0x19, 0xab, 0x59, 0x76, 0x5a, 0xd7, 0xda,
+    0xee, 0xd2, 0x0f, 0xb3, 0xec, 0xdd, 0x9f, 0x9b, 0x7e, 0x71, 0x81, 0x9f, 0x4a, 0x00, 0xd6, 0xa5,
+    0xa9, 0x18, 0xb4, 0xb4, 0x80, 0x5a, 0x5a, 0x43, 0x16, 0x8a, 0x40, 0x2d, 0x3a, 0x90, 0xc2, 0x96,
+    0x90, 0x0b, 0x4b, 0x40, 0xc5, 0xa5, 0xa4, 0x02, 0x8a, 0x5a, 0x43, 0x16, 0x8a, 0x40, 0x3a, 0x8a,
+    0x40, 0x2d, 0x2d, 0x21, 0x98, 0x75, 0xcc, 0xe9, 0x3f, 0xf2, 0x13, 0x87, 0xfe, 0x05, 0xff, 0x00,
+    0xa0, 0x9a, 0xee, 0x30, 0x3a, 0x8a, 0xe5, 0xf4, 0x8f, 0xf9, 0x0a, 0x43, 0xff, 0x00, 0x02, 0xff,
+    0x00, 0xd0, 0x4d, 0x20, 0x3a, 0xa1, 0x5c, 0xb6, 0x8f, 0xff, 0x00, 0x21, 0x58, 0x7f, 0xe0, 0x5f,
+    0xfa, 0x09, 0xa0, 0x67, 0x54, 0x2b, 0x95, 0xd1, 0xbf, 0xe4, 0x2b, 0x07, 0xfc, 0x0b, 0xff, 0x00,
+    0x41, 0x34, 0x90, 0x33, 0xac, 0x14, 0xa2, 0xa4, 0x62, 0xd2, 0xd2, 0x18, 0xb4, 0xb4, 0x80, 0x5a,
+    0x5a, 0x43, 0x16, 0x96, 0x90, 0x0b, 0x4b, 0x48, 0x60, 0x29, 0xc2, 0x80, 0x01, 0x4b, 0x52, 0x02,
+    0xd2, 0x8a, 0x43, 0x16, 0x96, 0x80, 0x16, 0x96, 0x90, 0x0b, 0x4b, 0x48, 0x66, 0x15, 0x73, 0x3a,
+    0x4f, 0xfc, 0x84, 0xe1, 0xff, 0x00, 0x81, 0x7f, 0xe8, 0x26, 0xbb, 0x8c, 0x0e, 0xa2, 0xb9, 0x8d,
+    0x23, 0xfe, 0x42, 0x90, 0xff, 0x00, 0xc0, 0xbf, 0xf4, 0x13, 0x48, 0x67, 0x53, 0x5c, 0xb6, 0x8f,
+    0xff, 0x00, 0x21, 0x58, 0x7f, 0xe0, 0x5f, 0xfa, 0x09, 0xa0, 0x19, 0xd5, 0xd7, 0x29, 0xa3, 0x7f,
+    0xc8, 0x56, 0x0f, 0xf8, 0x17, 0xfe, 0x82, 0x69, 0x03, 0x3a, 0xd1, 0x4b, 0x52, 0x50, 0x52, 0xd2,
+    0x01, 0x69, 0x69, 0x0c, 0x5a, 0x5a, 0x00, 0x5a, 0x5a, 0x40, 0x2d, 0x2d, 0x21, 0x8b, 0x4a, 0x29,
+    0x0c, 0x05, 0x38, 0x52, 0x00, 0x14, 0xa2, 0x90, 0x0b, 0x4b, 0x48, 0x62, 0xd2, 0xd2, 0x01, 0x69,
+    0x69, 0x01, 0x87, 0x5c, 0xc6, 0x91, 0xff, 0x00, 0x21, 0x48, 0x7f, 0xe0, 0x5f, 0xfa, 0x09, 0xae,
+    0xe3, 0x13, 0xa9, 0xae, 0x5f, 0x47, 0xff, 0x00, 0x90, 0xa4, 0x3f, 0xf0, 0x2f, 0xfd, 0x04, 0xd2,
+    0x06, 0x75, 0x22, 0xb9, 0x6d, 0x1f, 0xfe, 0x42, 0xb0, 0xff, 0x00, 0xc0, 0xbf, 0xf4, 0x13, 0x40,
+    0x33, 0xab, 0xae, 0x57, 0x46, 0xff, 0x00, 0x90, 0xb4, 0x1f, 0xf0, 0x2f, 0xfd, 0x04, 0xd2, 0x43,
+    0x67, 0x59, 0x4b, 0x52, 0x31, 0x69, 0x69, 0x0c, 0xef, 0xfe, 0x1a, 0x7f, 0xcc, 0x53, 0xfe, 0xd9,
+    0x7f, 0xec, 0xf5, 0xdf, 0x56, 0xd0, 0xf8, 0x4e, 0x79, 0xfc, 0x41, 0x45, 0x51, 0x21, 0x45, 0x00,
+    0x14, 0x50, 0x01, 0x45, 0x00, 0x14, 0x50, 0x01, 0x45, 0x00, 0x14, 0x50, 0x01, 0x45, 0x00, 0x79,
+    0x0e, 0xb3, 0xff, 0x00, 0x21, 0xcd, 0x43, 0xfe, 0xbe, 0x64, 0xff, 0x00, 0xd0, 0x8d, 0x52, 0xaf,
+    0x3e, 0x5b, 0x9d, 0xb1, 0xd8, 0xc3, 0xae, 0x63, 0x48, 0xff, 0x00, 0x90, 0xa4, 0x3f, 0xf0, 0x2f,
+    0xfd, 0x04, 0xd7, 0x69, 0x8b, 0x3a, 0x9a, 0xe5, 0xf4, 0x7f, 0xf9, 0x0a, 0x43, 0xff, 0x00, 0x02,
+    0xff, 0x00, 0xd0, 0x4d, 0x00, 0xce, 0xaa, 0xb9, 0x5d, 0x1f, 0xfe, 0x42, 0xb0, 0xff, 0x00, 0xc0,
+    0xbf, 0xf4, 0x13, 0x48, 0x6c, 0xea, 0xc5, 0x72, 0xba, 0x37, 0xfc, 0x85, 0xa0, 0xff, 0x00, 0x81,
+    0x7f, 0xe8, 0x26, 0x90, 0x33, 0xac, 0x14, 0xa2, 0xa4, 0xa1, 0x69, 0x68, 0x03, 0xbf, 0xf8, 0x69,
+    0xff, 0x00, 0x31, 0x4f, 0xfb, 0x65, 0xff, 0x00, 0xb3, 0xd6, 0xaf, 0xc4, 0x5d, 0x62, 0xff, 0x00,
+    0x42, 0xf0, 0x4d, 0xee, 0xa3, 0xa6, 0xcf, 0xe4, 0x5d, 0x46, 0xd1, 0x84, 0x93, 0x62, 0xb6, 0x32,
+    0xea, 0x0f, 0x0c, 0x08, 0xe8, 0x4d, 0x74, 0x50, 0x4a, 0x52, 0x8a, 0x67, 0x3d, 0x4d, 0xd9, 0xc3,
+    0x4d, 0xad, 0xf8, 0xe6, 0xc3, 0xc0, 0x56, 0xbe, 0x30, 0xff, 0x00, 0x84, 0x92, 0x1b, 0xa8, 0x9b,
+    0x6b, 0x49, 0x67, 0x2d, 0x84, 0x6a, 0x00, 0x2d, 0xb7, 0xef, 0x2f, 0x27, 0x9c, 0x7a, 0x75, 0xab,
+    0xfe, 0x30, 0xf1, 0xee, 0xaa, 0x9f, 0x0e, 0x34, 0x5f, 0x10, 0x69, 0x13, 0x7d, 0x8a, 0xe2, 0xf6,
+    0x70, 0x92, 0x81, 0x1a, 0xb8, 0x1f, 0x2b, 0xee, 0x03, 0x70, 0x3c, 0x6e, 0x5a, 0xed, 0xf6, 0x54,
+    0xe5, 0x24, 0xd2, 0xeb, 0x63, 0x1b, 0xb4, 0x7a, 0x46, 0x95, 0x3c, 0x97, 0x3a, 0x3d, 0x94, 0xf3,
+    0x36, 0xe9, 0x65, 0xb7, 0x8d, 0xdd, 0xb1, 0x8c, 0x92, 0xa0, 0x93, 0xc5, 0x71, 0x3f, 0x14, 0x3c,
+    0x59, 0xa9, 0xe8, 0x30, 0x69, 0x9a, 0x7e, 0x85, 0x37, 0x97, 0xaa, 0x5f, 0x4f, 0x85, 0x21, 0x15,
+    0xce, 0xd1, 0xc6, 0x30, 0xc0, 0x8e, 0x59, 0x87, 0xe4, 0x6b, 0x9e, 0x94, 0x14, 0xaa, 0x72, 0xbd,
+    0x8a, 0x6e, 0xc8, 0x5f, 0x87, 0x3e, 0x27, 0xd4, 0xbc, 0x5b, 0xe1, 0x5d, 0x42, 0x0b, 0xbb, 0xdd,
+    0x9a, 0xcd, 0xb3, 0xbc, 0x46, 0xe3, 0xc9, 0x5c, 0xa6, 0xe0, 0x76, 0x39, 0x40, 0x00, 0x38, 0x39,
+    0x18, 0xef, 0xb6, 0xb9, 0xcf, 0x1b, 0xea, 0xde, 0x36, 0xf0, 0x75, 0xd6, 0x97, 0x0f, 0xfc, 0x25,
+    0xdf, 0x6c, 0xfb, 0x7b, 0x3a, 0xe7, 0xfb, 0x36, 0x18, 0xf6, 0x6d, 0x2a, 0x3d, 0x0e, 0x7e, 0xf7,
+    0xb7, 0x4a, 0xde, 0x34, 0xe9, 0xaa, 0xae, 0x9b, 0x42, 0x6d, 0xf2, 0xdc, 0xec, 0x2e, 0xed, 0xfc,
+    0x4d, 0xe1, 0xef, 0x0d, 0xeb, 0x7a, 0x85, 0xef, 0x8a, 0x3f, 0xb4, 0x64, 0x8a, 0xca, 0x47, 0xb7,
+    0x1f, 0xd9, 0xf1, 0xc3, 0xe5, 0x3a, 0x82, 0x43, 0x71, 0x9d, 0xdf, 0x43, 0xc5, 0x73, 0xde, 0x0b,
+    0x93, 0xc6, 0xde, 0x2f, 0xd0, 0x06, 0xa9, 0xff, 0x00, 0x09, 0xa7, 0xd9, 0x33, 0x2b, 0x47, 0xe5,
+    0x7f, 0x65, 0xc3, 0x27, 0x4c, 0x73, 0x9e, 0x3d, 0x7d, 0x2a, 0x57, 0xb2, 0xe4, 0x73, 0xe5, 0xeb,
+    0xdc, 0x35, 0xbd, 0xae, 0x74, 0x1e, 0x35, 0xf1, 0x7c, 0xde, 0x06, 0xf0, 0xb5, 0xa3, 0x48, 0xeb,
+    0x7d, 0xaa, 0xca, 0x04, 0x28, 0xee, 0x9b, 0x16, 0x47, 0x0a, 0x37, 0x48, 0x54, 0x74, 0x1d, 0xf0,
+    0x3d, 0x40, 0xac, 0x7b, 0xf6, 0xf8, 0x8b, 0xa4, 0x78, 0x6d, 0xbc, 0x41, 0x2e, 0xb7, 0x69, 0x3c,
+    0x90, 0xc6, 0x27, 0x9f, 0x4d, 0x36, 0x4a, 0x15, 0x13, 0xa9, 0x1b, 0xc7, 0x24, 0x81, 0xd7, 0xa7,
+    0x43, 0xcd, 0x28, 0x42, 0x9f, 0x2a, 0x73, 0x5b, 0xbf, 0xb8, 0x1b, 0x7d, 0x09, 0x75, 0x5f, 0x1e,
+    0xdc, 0xdf, 0xfc, 0x26, 0x9b, 0xc4, 0xba, 0x43, 0xfd, 0x8e, 0xf5, 0x1d, 0x23, 0x71, 0xb5, 0x5f,
+    0xcb, 0x7f, 0x31, 0x43, 0x0f, 0x98, 0x10, 0x41, 0x07, 0x23, 0x8e, 0x84, 0x57, 0x3d, 0x77, 0xe2,
+    0x4f, 0x1b, 0xe9, 0x3e, 0x09, 0xd3, 0x7c, 0x58, 0xde, 0x22, 0x86, 0xee, 0x2b, 0x97, 0x55, 0x7b,
+    0x39, 0x6c, 0x63, 0x40, 0xb9, 0xdd, 0xfc, 0x4b, 0x82, 0x7e, 0xef, 0xb7, 0x5a, 0xd2, 0x14, 0x60,
+    0x95, 0xa4, 0xae, 0xef, 0x61, 0x39, 0x3e, 0x86, 0xf7, 0x8f, 0xbc, 0x65, 0xab, 0x69, 0xfe, 0x01,
+    0xd1, 0x35, 0xbd, 0x2a, 0x6f, 0xb1, 0x5c, 0x5f, 0x34, 0x4c, 0xe3, 0xcb, 0x57, 0xc2, 0xb4, 0x45,
+    0xb6, 0xfc, 0xc0, 0xf7, 0xc7, 0x34, 0xef, 0x0b, 0x7c, 0x41, 0x9a, 0x4f, 0x00, 0x6a, 0x9a, 0x8e,
+    0xb4, 0xe1, 0xf5, 0x3d, 0x24, 0xb2, 0x4e, 0x19, 0x42, 0x17, 0x63, 0xfe, 0xaf, 0x20, 0x00, 0x06,
+    0x4f, 0xcb, 0xf8, 0x54, 0x7b, 0x04, 0xe9, 0xdd, 0x6f, 0x71, 0xf3, 0x6a, 0x64, 0xfc, 0x2f, 0xf1,
+    0x9f, 0x89, 0xb5, 0xff, 0x00, 0x16, 0xdc, 0x58, 0x6b, 0x57, 0xc6, 0x68, 0x56, 0xc9, 0xa6, 0x58,
+    0xcc, 0x11, 0xa6, 0x0e, 0xe4, 0xc1, 0xca, 0xa8, 0x3d, 0x1b, 0xf5, 0xaf, 0x5e, 0xa8, 0xc4, 0x42,
+    0x30, 0x9d, 0xa3, 0xb0, 0xe2, 0xdb, 0x5a, 0x9f, 0x3a, 0x78, 0xe7, 0xc4, 0x37, 0x70, 0xf8, 0x93,
+    0x53, 0x8b, 0x4d, 0x7d, 0xa9, 0x6f, 0x73, 0x20, 0x9a, 0x5d, 0xa1, 0x86, 0xe2, 0xc7, 0x0b, 0xc8,
+    0xf6, 0x3f, 0xe4, 0x56, 0xc6, 0x9f, 0x2b, 0xcf, 0xa6, 0xda, 0xcb, 0x21, 0xdc, 0xef, 0x0a, 0x33,
+    0x1c, 0x63, 0x24, 0x80, 0x4d, 0x72, 0x62, 0x68, 0x46, 0x9d, 0x18, 0xcb, 0xed, 0x3d, 0xff, 0x00,
+    0x33, 0xa6, 0x94, 0xdc, 0xa4, 0xd7, 0x43, 0x2e, 0xb9, 0x8d, 0x23, 0xfe, 0x42, 0x90, 0xff, 0x00,
+    0xc0, 0xbf, 0xf4, 0x13, 0x40, 0x33, 0xa9, 0xae, 0x5f, 0x47, 0xff, 0x00, 0x90, 0xac, 0x3f, 0xf0,
+    0x2f, 0xfd, 0x04, 0xd2, 0x1b, 0x3a, 0xaa, 0xe5, 0x74, 0x7f, 0xf9, 0x0a, 0xc3, 0xff, 0x00, 0x02,
+    0xff, 0x00, 0xd0, 0x4d, 0x00, 0xce, 0xb2, 0xb9, 0x4d, 0x1b, 0xfe, 0x42, 0xd0, 0x7f, 0xc0, 0xbf,
+    0xf4, 0x13, 0x48, 0x1f, 0x43, 0xad, 0x14, 0xb5, 0x25, 0x05, 0x2d, 0x20, 0x3b, 0xff, 0x00, 0x86,
+    0x9f, 0xf3, 0x14, 0xff, 0x00, 0xb6, 0x5f, 0xfb, 0x3d, 0x4f, 0xf1, 0x73, 0xfe, 0x49, 0xbe, 0xa5,
+    0xfe, 0xfc, 0x3f, 0xfa, 0x31, 0x6b, 0xab, 0x0d, 0xf1, 0x47, 0xd4, 0xe6, 0xab, 0xbb, 0x39, 0x7f,
+    0x0e, 0xf8, 0x1b, 0x54, 0xf1, 0x4f, 0x81, 0x34, 0xa8, 0x6f, 0x7c, 0x53, 0x32, 0x69, 0x0e, 0xa1,
+    0xc5, 0x8c, 0x56, 0x68, 0xa5, 0x40, 0x63, 0xc7, 0x99, 0x9c, 0x9f, 0x5e, 0x41, 0xa7, 0xfc, 0x60,
+    0xd3, 0x6d, 0xb4, 0x7f, 0x87, 0xda, 0x3e, 0x9d, 0x66, 0x9b, 0x2d, 0xed, 0xee, 0xd5, 0x10, 0x13,
+    0x93, 0x81, 0x1b, 0xf5, 0xf7, 0xef, 0x5d, 0xaa, 0xa2, 0x75, 0x54, 0x52, 0xb2, 0xb9, 0x95, 0xbd,
+    0xdb, 0x9d, 0xc6, 0x85, 0xe2, 0x7f, 0x0f, 0xb6, 0x91, 0xa6, 0x5b, 0x0d, 0x73, 0x4c, 0x37, 0x06,
+    0x08, 0xa3, 0x11, 0x0b, 0xb8, 0xf7, 0x6e, 0xda, 0x06, 0xdc, 0x67, 0x39, 0xcf, 0x18, 0xaf, 0x32,
+    0xbd, 0xbc, 0xd4, 0xfc, 0x4b, 0xf1, 0x86, 0x7d, 0x47, 0x4a, 0xd2, 0x4e, 0xad, 0x0e, 0x8a, 0xc2,
+    0x34, 0x83, 0xed, 0x09, 0x08, 0xf9, 0x72, 0x01, 0xdc, 0xdc, 0x7f, 0xac, 0x24, 0x8f, 0x5c, 0x54,
+    0x52, 0x83, 0x8c, 0xa4, 0xe7, 0xa6, 0x83, 0x6e, 0xf6, 0xb0, 0xff, 0x00, 0x0b, 0x5d, 0x5f, 0xf8,
+    0x67, 0xe2, 0xec, 0xb0, 0xea, 0x9a, 0x71, 0xd2, 0xe3, 0xd7, 0x03, 0x30, 0xb6, 0x33, 0xac, 0xa1,
+    0x4b, 0x31, 0x2a, 0x43, 0x2f, 0x07, 0xe6, 0x05, 0x47, 0xfb, 0xd5, 0x7b, 0xe3, 0x6f, 0xfc, 0x84,
+    0xfc, 0x2f, 0xff, 0x00, 0x5d, 0x26, 0xff, 0x00, 0xd0, 0xa2, 0xad, 0x12, 0x5e, 0xda, 0x2d, 0x75,
+    0x5f, 0xa0, 0xbe, 0xcb, 0x3d, 0x0b, 0xc6, 0xdf, 0xf2, 0x23, 0x6b, 0xbf, 0xf5, 0xe3, 0x37, 0xfe,
+    0x80, 0x6b, 0xce, 0x3e, 0x18, 0xf8, 0x13, 0xc3, 0x5e, 0x21, 0xf0, 0x80, 0xbe, 0xd5, 0x74, 0xdf,
+    0xb4, 0x5c, 0xfd, 0xa1, 0xd3, 0x7f, 0x9f, 0x22, 0x70, 0x31, 0x81, 0x85, 0x60, 0x2b, 0x1a, 0x73,
+    0x94, 0x28, 0xb7, 0x1e, 0xe3, 0x69, 0x37, 0xa9, 0x7b, 0xe3, 0x3f, 0x87, 0xe7, 0x97, 0xc3, 0x9a,
+    0x55, 0xdd, 0x84, 0x2c, 0xd6, 0xfa, 0x59, 0x64, 0x74, 0x5c, 0xb6, 0xc8, 0xd8, 0x28, 0x0c, 0x7d,
+    0x86, 0xc0, 0x33, 0xef, 0x5a, 0x9e, 0x24, 0xf8, 0x89, 0xe1, 0xeb, 0xaf, 0x87, 0xf7, 0xb3, 0x5b,
+    0xea, 0x10, 0x49, 0x73, 0x79, 0x68, 0xd0, 0xa5, 0xa8, 0x70, 0x65, 0x57, 0x75, 0xdb, 0x82, 0xbd,
+    0x46, 0x32, 0x79, 0x3c, 0x71, 0x55, 0x18, 0xba, 0x90, 0x85, 0xba, 0x30, 0xbd, 0x9b, 0x39, 0x16,
+    0xd1, 0x6e, 0xf4, 0x5f, 0xd9, 0xfe, 0xf9, 0x6f, 0x23, 0x68, 0xa5, 0xba, 0xba, 0x4b, 0x91, 0x1b,
+    0x8c, 0x15, 0x52, 0xf1, 0xa8, 0xc8, 0xed, 0x90, 0xb9, 0xfc, 0x6b, 0x37, 0x50, 0xf0, 0xbd, 0xd4,
+    0x3f, 0x0c, 0xb4, 0x6f, 0x11, 0xc1, 0x7f, 0x77, 0x79, 0x0c, 0x05, 0x64, 0x9a, 0xc2, 0xee, 0x4f,
+    0x32, 0x04, 0x05, 0x88, 0xca, 0xa7, 0x18, 0x19, 0xc0, 0x23, 0xdc, 0xf3, 0x5b, 0xc6, 0xa2, 0xdf,
+    0xbc, 0x89, 0x68, 0xdb, 0xf8, 0x99, 0xad, 0x5b, 0xf8, 0x83, 0xe1, 0x6e, 0x83, 0xa9, 0x5b, 0x22,
+    0xc6, 0x92, 0xdd, 0x28, 0x31, 0xaf, 0x48, 0xd8, 0x46, 0xe1, 0x97, 0xf0, 0x20, 0xfe, 0x15, 0x36,
+    0xb7, 0xf0, 0xe7, 0x52, 0xd5, 0xbc, 0x49, 0xa7, 0xdc, 0x58, 0xa9, 0x5d, 0x1b, 0x50, 0x8a, 0xdd,
+    0xf5, 0x2d, 0xb2, 0x2a, 0x80, 0x50, 0x73, 0xf2, 0xe7, 0x27, 0x23, 0xa6, 0x01, 0xe4, 0x9a, 0x88,
+    0xcd, 0x52, 0x8a, 0xe6, 0xf3, 0x1b, 0x57, 0x64, 0xbe, 0x0f, 0x45, 0x8f, 0xe3, 0xa7, 0x88, 0xd1,
+    0x14, 0x2a, 0x2d, 0xb4, 0x81, 0x54, 0x0c, 0x00, 0x37, 0x45, 0x5e, 0x9f, 0xad, 0x0b, 0xe3, 0xa1,
+    0x5f, 0x8d, 0x30, 0x66, 0xfc, 0xdb, 0xc8, 0x2d, 0xb9, 0x03, 0xf7, 0x9b, 0x4e, 0xde, 0xbc, 0x75,
+    0xc7, 0x5a, 0xe7, 0xad, 0x6e, 0x78, 0xdf, 0xb2, 0x2a, 0x3b, 0x1f, 0x33, 0xea, 0xf6, 0x7a, 0x96,
+    0x95, 0xa2, 0xcb, 0x63, 0x7d, 0xa6, 0x18, 0x64, 0x5b, 0x8c, 0xcf, 0x3b, 0x5c, 0x2b, 0x96, 0x93,
+    0x24, 0x1c, 0x81, 0xfe, 0x35, 0xd5, 0x68, 0x32, 0xcf, 0x2e, 0x8d, 0x6d, 0xe7, 0xdb, 0xf9, 0x3b,
+    0x63, 0x55, 0x4f, 0x9c, 0x36, 0xf5, 0xda, 0x30, 0xdc, 0x74, 0xcf, 0xa5, 0x65, 0x8c, 0xe4, 0x95,
+    0x1e, 0x65, 0x2b, 0xea, 0xfa, 0x7f, 0x5b, 0x1b, 0xd1, 0xba, 0x9d, 0x9a, 0xe8, 0x55, 0xae, 0x5f,
+    0x48, 0xff, 0x00, 0x90, 0xa4, 0x3f, 0xf0, 0x2f, 0xfd, 0x04, 0xd6, 0x25, 0x33, 0xaa, 0xae, 0x5b,
+    0x47, 0xff, 0x00, 0x90, 0xac, 0x3f, 0xf0, 0x2f, 0xfd, 0x04, 0xd0, 0x37, 0xb9, 0xd5, 0x8a, 0xe5,
+    0x34, 0x6f, 0xf9, 0x0a, 0xc1, 0xff, 0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x20, 0x7b, 0x9d, 0x60,
+    0xae, 0x53, 0x45, 0xff, 0x00, 0x90, 0xb4, 0x1f, 0xf0, 0x2f, 0xfd, 0x04, 0xd2, 0x07, 0xba, 0x3a,
+    0xda, 0x51, 0x52, 0x58, 0xb4, 0xb4, 0x01, 0xdf, 0xfc, 0x35, 0xff, 0x00, 0x98, 0xa7, 0xfd, 0xb2,
+    0xff, 0x00, 0xd9, 0xeb, 0xb6, 0xbb, 0xb2, 0xb5, 0xd4, 0x2d, 0x9a, 0xda, 0xf6, 0xda, 0x1b, 0x98,
+    0x1b, 0x1b, 0xa2, 0x9a, 0x30, 0xea, 0x70, 0x72, 0x32, 0x0f, 0x1d, 0x6b, 0x68, 0x36, 0x92, 0x68,
+    0xe7, 0xa9, 0xf1, 0x31, 0xd6, 0xd6, 0xd6, 0xf6, 0x76, 0xe9, 0x6f, 0x6b, 0x04, 0x50, 0x41, 0x18,
+    0xc2, 0x47, 0x12, 0x05, 0x55, 0x1e, 0xc0, 0x70, 0x2a, 0x2b, 0xed, 0x32, 0xc3, 0x54, 0x85, 0x61,
+    0xd4, 0x2c, 0x6d, 0xae, 0xe2, 0x56, 0xdc, 0xa9, 0x71, 0x12, 0xc8, 0x01, 0xe9, 0x90, 0x08, 0x3c,
+    0xf2, 0x6a, 0xb9, 0x9a, 0x77, 0xbe, 0xa4, 0x14, 0xa2, 0xf0, 0xa7, 0x87, 0x60, 0x95, 0x25, 0x8b,
+    0x40, 0xd2, 0xa3, 0x91, 0x18, 0x32, 0x3a, 0x59, 0xc6, 0x0a, 0x91, 0xc8, 0x20, 0xe3, 0x83, 0x56,
+    0xec, 0x74, 0x9d, 0x37, 0x4c, 0x69, 0x5a, 0xc3, 0x4f, 0xb4, 0xb4, 0x69, 0x48, 0x32, 0x1b, 0x78,
+    0x56, 0x32, 0xf8, 0xce, 0x33, 0x81, 0xcf, 0x53, 0xf9, 0xd5, 0x3a, 0x93, 0x7a, 0x36, 0x2b, 0x20,
+    0xba, 0xd2, 0x74, 0xdb, 0xeb, 0x98, 0x6e, 0x6e, 0xf4, 0xfb, 0x4b, 0x89, 0xe1, 0x20, 0xc5, 0x2c,
+    0xb0, 0xab, 0xb4, 0x78, 0x39, 0xf9, 0x49, 0x19, 0x1c, 0xf3, 0xc5, 0x17, 0xda, 0x4e, 0x9b, 0xa9,
+    0xb4, 0x4d, 0x7f, 0xa7, 0xda, 0x5d, 0xb4, 0x24, 0x98, 0xcc, 0xf0, 0xac, 0x85, 0x33, 0x8c, 0xe3,
+    0x23, 0x8e, 0x83, 0xf2, 0xa4, 0xa7, 0x25, 0xd4, 0x2c, 0x58, 0x9e, 0x08, 0x6e, 0x60, 0x92, 0x0b,
+    0x88, 0x92, 0x58, 0x64, 0x52, 0xaf, 0x1c, 0x8a, 0x19, 0x58, 0x1e, 0xa0, 0x83, 0xd4, 0x54, 0x76,
+    0x56, 0x16, 0x7a, 0x6d, 0xbf, 0xd9, 0xec, 0x2d, 0x20, 0xb5, 0x87, 0x25, 0xbc, 0xb8, 0x23, 0x08,
+    0xb9, 0x3d, 0x4e, 0x00, 0xc5, 0x2b, 0xbb, 0x58, 0x65, 0x82, 0x32, 0x30, 0x7a, 0x56, 0x6c, 0x7e,
+    0x1e, 0xd1, 0x21, 0xba, 0x17, 0x51, 0x68, 0xfa, 0x7a, 0x5c, 0x03, 0x91, 0x2a, 0xdb, 0x20, 0x7c,
+    0xfa, 0xe7, 0x19, 0xa6, 0xa4, 0xd6, 0xcc, 0x2c, 0x5b, 0xbb, 0xb2, 0xb5, 0xd4, 0x2d, 0x9a, 0xda,
+    0xf6, 0xda, 0x1b, 0x98, 0x1b, 0x1b, 0xa2, 0x9a, 0x30, 0xea, 0x70, 0x72, 0x32, 0x0f, 0x1d, 0x69,
+    0xab, 0xa7, 0x59, 0x26, 0x9f, 0xfd, 0x9e, 0xb6, 0x76, 0xe2, 0xcb, 0x61, 0x4f, 0xb3, 0x88, 0x97,
+    0xcb, 0xda, 0x7a, 0x8d, 0xb8, 0xc6, 0x3d, 0xa8, 0xe6, 0x76, 0xb5, 0xc0, 0xaa, 0x7c, 0x39, 0xa1,
+    0x9b, 0x21, 0x64, 0x74, 0x5d, 0x38, 0xda, 0x2b, 0xf9, 0x82, 0x03, 0x6a, 0x9b, 0x03, 0xe3, 0x1b,
+    0xb6, 0xe3, 0x19, 0xc7, 0x19, 0xad, 0x25, 0x55, 0x44, 0x54, 0x45, 0x0a, 0xaa, 0x30, 0x00, 0x18,
+    0x00, 0x50, 0xe5, 0x27, 0xbb, 0x0b, 0x15, 0x61, 0xd2, 0xb4, 0xeb, 0x7b, 0xf9, 0x6f, 0xe1, 0xb0,
+    0xb5, 0x8e, 0xf2, 0x50, 0x44, 0x97, 0x09, 0x0a, 0x89, 0x1c, 0x1c, 0x70, 0x58, 0x0c, 0x9e, 0x83,
+    0xf2, 0xab, 0x74, 0x9b, 0x6f, 0x70, 0x3c, 0x77, 0x5f, 0xb7, 0x86, 0xe7, 0x58, 0xd4, 0x23, 0x9e,
+    0x28, 0xe5, 0x4f, 0xb5, 0x48, 0x76, 0xba, 0x86, 0x19, 0xdc, 0x7b, 0x1a, 0xac, 0x88, 0xa8, 0x8a,
+    0x88, 0xa1, 0x51, 0x46, 0x02, 0x81, 0x80, 0x07, 0xa5, 0x70, 0x4a, 0x4f, 0xe1, 0xbe, 0x87, 0x6c,
+    0x52, 0xdc, 0xc4, 0xae, 0x5f, 0x48, 0xff, 0x00, 0x90, 0xa4, 0x3f, 0xf0, 0x2f, 0xfd, 0x04, 0xd7,
+    0x59, 0x93, 0xdc, 0xea, 0xab, 0x96, 0xd1, 0xff, 0x00, 0xe4, 0x2b, 0x0f, 0xfc, 0x0b, 0xff, 0x00,
+    0x41, 0x34, 0x03, 0xdd, 0x1d, 0x5d, 0x72, 0x9a, 0x37, 0xfc, 0x85, 0x60, 0xff, 0x00, 0x81, 0x7f,
+    0xe8, 0x26, 0x90, 0x3d, 0xd1, 0xd6, 0x0a, 0xe5, 0x34, 0x5f, 0xf9, 0x0b, 0x41, 0xff, 0x00, 0x02,
+    0xff, 0x00, 0xd0, 0x4d, 0x20, 0x7b, 0xa3, 0xad, 0x14, 0xa2, 0xa4, 0xb1, 0x69, 0x68, 0x03, 0xbf,
+    0xf8, 0x6b, 0xff, 0x00, 0x31, 0x4f, 0xfb, 0x65, 0xff, 0x00, 0xb3, 0xd7, 0x7b, 0x5a, 0xc3, 0x63,
+    0x9e, 0xa7, 0xc4, 0x14, 0x55, 0x10, 0x14, 0x50, 0x01, 0x45, 0x00, 0x14, 0x50, 0x01, 0x45, 0x00,
+    0x14, 0x50, 0x01, 0x45, 0x00, 0x14, 0x50, 0x07, 0x91, 0x6b, 0x1f, 0xf2, 0x1c, 0xd4, 0x3f, 0xeb,
+    0xe6, 0x4f, 0xfd, 0x08, 0xd5, 0x3a, 0xf3, 0xe5, 0xb9, 0xdd, 0x1d, 0x8c, 0x2a, 0xe6, 0x34, 0x7f,
+    0xf9, 0x0a, 0x43, 0xff, 0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x76, 0x98, 0xbe, 0x87, 0x53, 0x5c,
+    0xb6, 0x8f, 0xff, 0x00, 0x21, 0x58, 0x7f, 0xe0, 0x5f, 0xfa, 0x09, 0xa0, 0x1e, 0xe8, 0xea, 0xc5,
+    0x72, 0xba, 0x37, 0xfc, 0x85, 0xa0, 0xff, 0x00, 0x81, 0x7f, 0xe8, 0x26, 0x90, 0xde, 0xe8, 0xeb,
+    0x2b, 0x93, 0xd1, 0x7f, 0xe4, 0x2d, 0x07, 0xfc, 0x0b, 0xff, 0x00, 0x41, 0x34, 0x04, 0xb7, 0x47,
+    0x5d, 0x4b, 0x52, 0x50, 0xb4, 0x52, 0x19, 0xdf, 0xfc, 0x35, 0xff, 0x00, 0x98, 0x9f, 0xfd, 0xb2,
+    0xff, 0x00, 0xd9, 0xeb, 0x53, 0xe2, 0x2e, 0xb1, 0x7f, 0xa1, 0x78, 0x26, 0xf7, 0x51, 0xd3, 0x67,
+    0xf2, 0x2e, 0xa3, 0x68, 0xc2, 0x49, 0xb1, 0x5b, 0x19, 0x75, 0x07, 0x86, 0x04, 0x74, 0x26, 0xba,
+    0x28, 0x25, 0x29, 0x45, 0x33, 0x96, 0xae, 0xec, 0xc0, 0xf0, 0xdd, 0x9f, 0x8d, 0xbc, 0x41, 0xe1,
+    0xeb, 0x2d, 0x5b, 0xfe, 0x13, 0x8f, 0x23, 0xed, 0x29, 0xbf, 0xca, 0xfe, 0xc9, 0x85, 0xf6, 0xf2,
+    0x46, 0x33, 0xc6, 0x7a, 0x7a, 0x55, 0xbf, 0x88, 0xfa, 0xa7, 0x89, 0x7c, 0x39, 0x1d, 0xa6, 0xb9,
+    0xa4, 0x5d, 0x6f, 0xd3, 0xa1, 0x75, 0x5b, 0xdb, 0x36, 0x89, 0x08, 0x23, 0x3c, 0x36, 0xed, 0xbb,
+    0x80, 0x3f, 0x74, 0xe0, 0xf1, 0xc7, 0xbd, 0x74, 0xfe, 0xe9, 0xd5, 0xe4, 0xe5, 0xb7, 0x4d, 0xcc,
+    0xb5, 0xb5, 0xcc, 0x6b, 0xef, 0x1f, 0xea, 0x7e, 0x2b, 0xf1, 0x1e, 0x95, 0xa3, 0x78, 0x2e, 0xe8,
+    0xdb, 0xac, 0x91, 0x89, 0xaf, 0x2e, 0x5a, 0x15, 0x7f, 0x2c, 0x10, 0x09, 0x04, 0x30, 0x23, 0xe5,
+    0x1d, 0x7d, 0x49, 0x03, 0x35, 0x73, 0xc4, 0x1e, 0x27, 0xd6, 0xb4, 0xef, 0x8a, 0xda, 0x1e, 0x85,
+    0x6f, 0x7e, 0x46, 0x9f, 0x71, 0x1c, 0x5e, 0x74, 0x6d, 0x14, 0x64, 0xb9, 0x2c, 0xc0, 0x92, 0x76,
+    0xe4, 0x67, 0x03, 0xa6, 0x2a, 0xfd, 0x8c, 0x53, 0x51, 0x6b, 0x5b, 0x36, 0x1c, 0xcf, 0x73, 0x3f,
+    0xc7, 0x77, 0x7e, 0x36, 0xf0, 0x5e, 0x8f, 0x0e, 0xa2, 0x3c, 0x63, 0xf6, 0xb1, 0x2d, 0xc0, 0x83,
+    0xcb, 0xfe, 0xcc, 0x86, 0x3d, 0xb9, 0x56, 0x6c, 0xe7, 0x9f, 0xee, 0xfe, 0xb5, 0xd7, 0x78, 0x56,
+    0xc7, 0xc4, 0xac, 0xb6, 0x7a, 0x96, 0xa9, 0xe2, 0x9f, 0xb7, 0xdb, 0x4f, 0x6e, 0xb2, 0x1b, 0x4f,
+    0xec, 0xf8, 0xe2, 0xc1, 0x65, 0x04, 0x7c, 0xeb, 0xcf, 0x19, 0xf4, 0xe6, 0xa6, 0x7e, 0xcb, 0xd9,
+    0xa9, 0x28, 0xef, 0xe6, 0x0a, 0xf7, 0xb5, 0xcd, 0x9f, 0x11, 0x6a, 0xdf, 0xd8, 0x5e, 0x1d, 0xbf,
+    0xd5, 0x04, 0x5e, 0x6b, 0x5b, 0x42, 0xd2, 0x2a, 0x7f, 0x78, 0xf6, 0x07, 0xdb, 0x35, 0xc0, 0xf8,
+    0x72, 0xe7, 0xc7, 0x3e, 0x2c, 0xd0, 0x06, 0xb5, 0x67, 0xe2, 0xbb, 0x08, 0x24, 0x91, 0x9b, 0x6d,
+    0x8f, 0xd8, 0x91, 0x95, 0x30, 0x48, 0xc3, 0x37, 0x2c, 0xb9, 0xc6, 0x7a, 0x1e, 0x08, 0xa8, 0xa7,
+    0x18, 0x28, 0x39, 0xcd, 0x5f, 0x5b, 0x0d, 0xde, 0xf6, 0x45, 0xcf, 0x1b, 0x78, 0xfa, 0xfb, 0xc1,
+    0xfa, 0x06, 0x95, 0x11, 0xfb, 0x24, 0x9e, 0x20, 0x99, 0x23, 0x6b, 0x98, 0x25, 0x8d, 0xd9, 0x36,
+    0xed, 0x3b, 0xd8, 0x15, 0x20, 0x7d, 0xf0, 0x07, 0x5e, 0xfd, 0x2b, 0x7b, 0x46, 0xf1, 0xee, 0x81,
+    0xab, 0x68, 0xf7, 0x37, 0xd1, 0xdf, 0x86, 0x16, 0x30, 0x2c, 0xb7, 0xa5, 0x60, 0x90, 0x08, 0xb2,
+    0x0f, 0x40, 0x57, 0x27, 0x90, 0x7a, 0x67, 0xa5, 0x37, 0x41, 0xf2, 0x29, 0xc7, 0xfa, 0xec, 0x1c,
+    0xda, 0xd9, 0x8e, 0xb6, 0xf1, 0xff, 0x00, 0x85, 0xaf, 0x25, 0xb1, 0x8a, 0xdf, 0x56, 0x8e, 0x49,
+    0x6f, 0x9f, 0x65, 0xba, 0x08, 0xdf, 0x73, 0x1d, 0xdb, 0x79, 0x1b, 0x72, 0xbc, 0x83, 0xc9, 0xc5,
+    0x3b, 0x55, 0xf1, 0xef, 0x85, 0xf4, 0x5b, 0xd6, 0xb3, 0xbf, 0xd5, 0xe1, 0x8e, 0xe1, 0x4e, 0x1a,
+    0x35, 0x56, 0x90, 0xa9, 0xf4, 0x3b, 0x41, 0xc1, 0xfa, 0xd4, 0x7b, 0x0a, 0x97, 0xe5, 0xb0, 0x73,
+    0x23, 0x66, 0xcf, 0x53, 0xb1, 0xbf, 0xd3, 0xd6, 0xfe, 0xd2, 0xee, 0x19, 0xad, 0x19, 0x4b, 0x09,
+    0x91, 0xc1, 0x5c, 0x0e, 0xbc, 0xf6, 0xc7, 0x7f, 0x4a, 0xe7, 0xd7, 0xe2, 0x47, 0x83, 0xde, 0xf7,
+    0xec, 0x83, 0x5d, 0xb7, 0xf3, 0x4b, 0x6d, 0xc9, 0x56, 0x09, 0x9f, 0xf7, 0xf1, 0xb7, 0xf1, 0xcd,
+    0x4c, 0x69, 0x4e, 0x57, 0x49, 0x6c, 0x36, 0xd2, 0x33, 0x7e, 0x23, 0xf8, 0xfd, 0xbc, 0x21, 0x67,
+    0x6b, 0x1e, 0x9c, 0x6d, 0xa5, 0xd4, 0xa6, 0x70, 0xfe, 0x4c, 0xf1, 0xbb, 0x2f, 0x93, 0x86, 0xcb,
+    0x02, 0xa4, 0x0c, 0xee, 0x00, 0x75, 0xef, 0xd2, 0xb7, 0x7c, 0x2f, 0xe2, 0xfd, 0x27, 0xc5, 0x56,
+    0xcc, 0x74, 0xfb, 0xb1, 0x34, 0xf0, 0x46, 0x86, 0xe5, 0x56, 0x27, 0x40, 0x8c, 0xc0, 0xf0, 0x37,
+    0x01, 0x9e, 0x41, 0xe9, 0x9e, 0x95, 0x6e, 0x8b, 0x54, 0x94, 0xc5, 0xcd, 0xad, 0x8e, 0x07, 0x58,
+    0xff, 0x00, 0x90, 0xe6, 0xa1, 0xff, 0x00, 0x5f, 0x32, 0x7f, 0xe8, 0x46, 0xa9, 0xd7, 0x92, 0xf7,
+    0x3d, 0x15, 0xb1, 0x87, 0x5c, 0xbe, 0x8f, 0xff, 0x00, 0x21, 0x48, 0x7f, 0xe0, 0x5f, 0xfa, 0x09,
+    0xae, 0xc3, 0x07, 0xba, 0x3a, 0xaa, 0xe5, 0x74, 0x7f, 0xf9, 0x0a, 0xc3, 0xff, 0x00, 0x02, 0xff,
+    0x00, 0xd0, 0x4d, 0x03, 0x7b, 0xa3, 0xac, 0x15, 0xca, 0x68, 0xdf, 0xf2, 0x16, 0x83, 0xfe, 0x05,
+    0xff, 0x00, 0xa0, 0x9a, 0x41, 0x2d, 0xd1, 0xd6, 0x0a, 0xe4, 0xf4, 0x5f, 0xf9, 0x0b, 0xc1, 0xff,
+    0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x20, 0x96, 0xe8, 0xeb, 0xa9, 0x45, 0x49, 0x62, 0xd2, 0xd0,
+    0x07, 0x7d, 0xf0, 0xd7, 0xfe, 0x62, 0x7f, 0xf6, 0xcb, 0xff, 0x00, 0x67, 0xa9, 0xbe, 0x2e, 0x7f,
+    0xc9, 0x37, 0xd4, 0xbf, 0xdf, 0x87, 0xff, 0x00, 0x46, 0x2d, 0x75, 0x61, 0xfe, 0x38, 0xfa, 0x9c,
+    0xb5, 0xb7, 0x67, 0x25, 0xe0, 0xed, 0x0f, 0xe1, 0xc4, 0xbe, 0x1a, 0xd3, 0x2f, 0x35, 0x4b, 0x8d,
+    0x35, 0x35, 0x3d, 0x81, 0xe5, 0xf3, 0x75, 0x23, 0x1b, 0x07, 0x0c, 0x71, 0x95, 0xde, 0x31, 0xdb,
+    0xb5, 0x74, 0xff, 0x00, 0x14, 0x7c, 0x52, 0x9a, 0x4f, 0x87, 0xbf, 0xb2, 0xad, 0x55, 0x67, 0xd4,
+    0x75, 0x55, 0x30, 0xc5, 0x10, 0x1b, 0xb0, 0x8d, 0xc1, 0x6c, 0x77, 0xce, 0x70, 0x3d, 0xcf, 0xb5,
+    0x75, 0x49, 0x54, 0x9d, 0x64, 0xa7, 0xb5, 0xcc, 0x95, 0x94, 0x74, 0x38, 0x8f, 0x0d, 0xc3, 0x7b,
+    0xf0, 0xa3, 0xc5, 0xd6, 0x90, 0xeb, 0x42, 0x3f, 0xb0, 0x6a, 0xd0, 0x22, 0xc9, 0x3a, 0x8e, 0x22,
+    0x7e, 0xe3, 0x3f, 0xec, 0xb1, 0xc1, 0xec, 0x41, 0x07, 0xb5, 0x6a, 0x78, 0xb8, 0xe7, 0xe3, 0xbf,
+    0x87, 0x08, 0xe9, 0xe5, 0xc3, 0xff, 0x00, 0xa1, 0xbd, 0x68, 0xed, 0x29, 0xf3, 0xad, 0x9a, 0x64,
+    0xec, 0xac, 0x69, 0x7c, 0x73, 0xff, 0x00, 0x91, 0x36, 0xc7, 0xfe, 0xc2, 0x09, 0xff, 0x00, 0xa2,
+    0xe4, 0xae, 0xf3, 0xc3, 0xdf, 0xf2, 0x2c, 0xe9, 0x5f, 0xf5, 0xe7, 0x0f, 0xfe, 0x80, 0x2b, 0x9a,
+    0x5f, 0xc1, 0x8f, 0xab, 0x2d, 0x7c, 0x43, 0xb5, 0xdb, 0xab, 0x1b, 0x2d, 0x0a, 0xf6, 0xe3, 0x53,
+    0x8f, 0xcc, 0xb1, 0x58, 0x8f, 0x9e, 0xbb, 0x77, 0x65, 0x0f, 0x07, 0x8e, 0xfd, 0x6b, 0xc3, 0xfc,
+    0x4d, 0xa1, 0x78, 0x2f, 0x4e, 0xd1, 0xe4, 0xd6, 0xfc, 0x2b, 0xe2, 0x76, 0x8a, 0xf1, 0x4a, 0x98,
+    0xad, 0x52, 0xe3, 0x2c, 0x72, 0x47, 0x00, 0x70, 0xeb, 0x81, 0xce, 0x4e, 0x7a, 0x55, 0xe1, 0x9c,
+    0xd6, 0xca, 0xe9, 0xee, 0x29, 0xd8, 0xd4, 0xf1, 0xc4, 0xfa, 0x96, 0xa1, 0xf0, 0x4f, 0x40, 0xba,
+    0xd4, 0xc3, 0xb5, 0xdb, 0x5d, 0x46, 0xd2, 0xb3, 0x0e, 0x4a, 0xed, 0x94, 0x2b, 0x1f, 0xa8, 0xdb,
+    0xf9, 0xd7, 0x65, 0xab, 0x6a, 0xba, 0x7e, 0xa7, 0xf0, 0xa3, 0x51, 0xfb, 0x05, 0xf5, 0xbd, 0xc9,
+    0x8b, 0x4c, 0x02, 0x41, 0x0c, 0xa1, 0x8c, 0x67, 0x67, 0x46, 0x03, 0xa1, 0xe0, 0xf0, 0x7d, 0x2a,
+    0x9c, 0x74, 0x8f, 0x2e, 0xc9, 0xbf, 0xcc, 0x48, 0x8f, 0xe0, 0xfd, 0xac, 0x30, 0xfc, 0x3d, 0xb5,
+    0x9a, 0x28, 0xd1, 0x66, 0x9e, 0x49, 0x5a, 0x47, 0xc7, 0x2c, 0x43, 0x95, 0x19, 0xfc, 0x00, 0xaf,
+    0x36, 0xf0, 0x6c, 0x57, 0x56, 0xb7, 0xda, 0xdd, 0x8d, 0xff, 0x00, 0x8a, 0xad, 0xbc, 0x3f, 0x7a,
+    0x5f, 0x6d, 0xca, 0x5e, 0xd9, 0x45, 0x2f, 0x9f, 0xd7, 0x77, 0xcd, 0x21, 0x1d, 0xfb, 0x77, 0xce,
+    0x6a, 0xa2, 0xef, 0x2a, 0x9a, 0x5f, 0xfe, 0x1c, 0x1e, 0xc8, 0xe8, 0xed, 0xfc, 0x3e, 0xb6, 0x1f,
+    0x09, 0xfc, 0x4b, 0x67, 0xe1, 0xed, 0x77, 0xfb, 0x69, 0x5a, 0x55, 0x2c, 0x60, 0x84, 0xa0, 0x5c,
+    0x6c, 0x32, 0x28, 0xf9, 0x8e, 0xec, 0xa7, 0xa7, 0xd2, 0xb0, 0xf4, 0x7b, 0x3b, 0x2d, 0x67, 0xc0,
+    0x70, 0x58, 0xde, 0x78, 0xfb, 0x4f, 0xb0, 0xb3, 0x07, 0x73, 0xe9, 0xf2, 0xd8, 0x44, 0x24, 0x8d,
+    0x83, 0x67, 0x21, 0xb7, 0x07, 0x6f, 0xa8, 0xea, 0x0e, 0x3d, 0xaa, 0xd4, 0xdb, 0x4e, 0x5c, 0xba,
+    0xdf, 0x6f, 0x90, 0xad, 0xe6, 0x6e, 0xfc, 0x47, 0xb4, 0x16, 0xdf, 0x07, 0x74, 0x18, 0x60, 0xbc,
+    0x37, 0xf0, 0xc5, 0x3c, 0x25, 0x2e, 0x7c, 0xb2, 0x9b, 0xe3, 0xf2, 0xa4, 0xda, 0x70, 0x49, 0x23,
+    0x82, 0xa2, 0xbd, 0x2f, 0xc3, 0x3a, 0xae, 0x9f, 0xa9, 0xe8, 0x96, 0xbf, 0x60, 0xbe, 0xb7, 0xb9,
+    0x31, 0x41, 0x18, 0x90, 0x43, 0x28, 0x63, 0x19, 0xdb, 0xd1, 0x80, 0xe8, 0x78, 0x3c, 0x1f, 0x4a,
+    0xe7, 0xa8, 0x9b, 0xa6, 0x9d, 0xba, 0xb2, 0x96, 0xe7, 0x9d, 0xeb, 0x1f, 0xf2, 0x1b, 0xd4, 0x3f,
+    0xeb, 0xe6, 0x4f, 0xfd, 0x08, 0xd5, 0x2a, 0xf1, 0x5e, 0xe7, 0xa5, 0x1d, 0x8c, 0x3a, 0xe5, 0xf4,
+    0x7f, 0xf9, 0x0a, 0x43, 0xff, 0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x76, 0x98, 0x3d, 0xd1, 0xd5,
+    0x57, 0x2b, 0xa3, 0xff, 0x00, 0xc8, 0x56, 0x1f, 0xf8, 0x17, 0xfe, 0x82, 0x68, 0x1b, 0xdd, 0x1d,
+    0x65, 0x72, 0x9a, 0x37, 0xfc, 0x85, 0xa0, 0xff, 0x00, 0x81, 0x7f, 0xe8, 0x26, 0x90, 0x4b, 0x74,
+    0x75, 0x82, 0xb9, 0x3d, 0x17, 0xfe, 0x42, 0xf0, 0x7f, 0xc0, 0xbf, 0xf4, 0x13, 0x40, 0x4b, 0x74,
+    0x75, 0xe2, 0x81, 0x52, 0x58, 0xb4, 0xb4, 0x86, 0x77, 0xdf, 0x0d, 0x7f, 0xe6, 0x27, 0xff, 0x00,
+    0x6c, 0xbf, 0xf6, 0x7a, 0xed, 0xae, 0xec, 0xad, 0x75, 0x0b, 0x66, 0xb6, 0xbd, 0xb6, 0x86, 0xe6,
+    0x06, 0xc6, 0xe8, 0xa6, 0x8c, 0x3a, 0x9c, 0x1c, 0x8c, 0x83, 0xc7, 0x5a, 0xda, 0x0d, 0xa4, 0x9a,
+    0x39, 0x6a, 0x7c, 0x4c, 0xcc, 0xff, 0x00, 0x84, 0x43, 0xc3, 0x3f, 0xf4, 0x2e, 0xe9, 0x1f, 0xf8,
+    0x05, 0x1f, 0xff, 0x00, 0x13, 0x57, 0x64, 0xd1, 0xb4, 0xb9, 0xaf, 0xa3, 0xbe, 0x97, 0x4d, 0xb3,
+    0x7b, 0xb8, 0x80, 0x11, 0xce, 0xd0, 0x29, 0x91, 0x31, 0xd3, 0x0d, 0x8c, 0x8c, 0x56, 0x8e, 0xa4,
+    0xde, 0xed, 0x99, 0xd9, 0x0f, 0xbf, 0xd3, 0x2c, 0x35, 0x48, 0x96, 0x2d, 0x42, 0xc6, 0xda, 0xee,
+    0x35, 0x6d, 0xca, 0x97, 0x11, 0x2c, 0x80, 0x1f, 0x50, 0x08, 0x3c, 0xd4, 0x6d, 0xa2, 0xe9, 0x4d,
+    0x75, 0x05, 0xd3, 0x69, 0x96, 0x46, 0xe2, 0xdd, 0x42, 0x43, 0x31, 0x81, 0x77, 0xc6, 0xa3, 0xa0,
+    0x53, 0x8c, 0x80, 0x3b, 0x62, 0x92, 0x9c, 0x92, 0xb2, 0x61, 0x64, 0x49, 0x7d, 0xa6, 0xd8, 0x6a,
+    0x90, 0xac, 0x3a, 0x85, 0x95, 0xb5, 0xdc, 0x4a, 0xdb, 0xc2, 0x5c, 0x44, 0xb2, 0x28, 0x6c, 0x63,
+    0x38, 0x20, 0xf3, 0xc9, 0xfc, 0xea, 0xc4, 0x71, 0xa4, 0x31, 0x24, 0x51, 0x22, 0xa4, 0x68, 0xa1,
+    0x55, 0x14, 0x60, 0x28, 0x1d, 0x00, 0x1d, 0x85, 0x2b, 0xbb, 0x58, 0x60, 0xe8, 0x92, 0x23, 0x24,
+    0x8a, 0xae, 0x8c, 0x30, 0x55, 0x86, 0x41, 0x15, 0x9a, 0xbe, 0x19, 0xd0, 0x56, 0x71, 0x3a, 0xe8,
+    0x9a, 0x68, 0x94, 0x1c, 0x89, 0x05, 0xa4, 0x7b, 0x81, 0xfa, 0xe2, 0x9a, 0x94, 0xa3, 0xb3, 0x0b,
+    0x17, 0xee, 0x2d, 0xa0, 0xbc, 0xb7, 0x7b, 0x7b, 0x98, 0x23, 0x9e, 0x17, 0x18, 0x68, 0xe5, 0x40,
+    0xca, 0xdf, 0x50, 0x78, 0x35, 0x52, 0xdf, 0x41, 0xd1, 0xed, 0x2d, 0xa7, 0xb6, 0xb6, 0xd2, 0x6c,
+    0x21, 0x82, 0xe0, 0x62, 0x68, 0xa3, 0xb6, 0x45, 0x59, 0x07, 0xa3, 0x00, 0x30, 0x7a, 0x9e, 0xb4,
+    0x29, 0x49, 0x2b, 0x26, 0x16, 0x2c, 0xd9, 0xd9, 0x5a, 0xe9, 0xf6, 0xcb, 0x6d, 0x65, 0x6d, 0x0d,
+    0xb4, 0x0b, 0x9d, 0xb1, 0x43, 0x18, 0x45, 0x19, 0x39, 0x38, 0x03, 0x8e, 0xb5, 0x05, 0xee, 0x89,
+    0xa5, 0x6a, 0x52, 0xac, 0xb7, 0xda, 0x65, 0x95, 0xd4, 0x8b, 0xc0, 0x79, 0xed, 0xd5, 0xc8, 0xfc,
+    0x48, 0xa1, 0x4a, 0x49, 0xdd, 0x3d, 0x42, 0xc5, 0xa8, 0x2d, 0xe0, 0xb5, 0x85, 0x61, 0xb7, 0x86,
+    0x38, 0x62, 0x5e, 0x89, 0x1a, 0x85, 0x51, 0xf8, 0x0a, 0xa2, 0xde, 0x1d, 0xd1, 0x1e, 0xe4, 0xdc,
+    0xb6, 0x8d, 0xa7, 0xb5, 0xc1, 0x39, 0x32, 0x9b, 0x54, 0x2c, 0x4f, 0xae, 0x71, 0x9a, 0x14, 0xa4,
+    0xb5, 0x4c, 0x2c, 0x5d, 0x9e, 0xd6, 0xde, 0xea, 0xd9, 0xad, 0xae, 0x20, 0x8a, 0x68, 0x18, 0x61,
+    0xa2, 0x91, 0x03, 0x29, 0x1e, 0x84, 0x1e, 0x2a, 0x0b, 0x0d, 0x27, 0x4d, 0xd2, 0x84, 0x83, 0x4e,
+    0xd3, 0xed, 0x2c, 0xc4, 0x98, 0x2e, 0x2d, 0xe1, 0x58, 0xf7, 0x63, 0xa6, 0x76, 0x81, 0x9e, 0xa6,
+    0x8e, 0x67, 0x6b, 0x5f, 0x40, 0xb1, 0xe5, 0xfa, 0xc7, 0xfc, 0x86, 0xef, 0xff, 0x00, 0xeb, 0xe6,
+    0x4f, 0xfd, 0x08, 0xd5, 0x3a, 0xf3, 0xa5, 0xb9, 0xe8, 0x47, 0x63, 0x0a, 0xb9, 0x7d, 0x1f, 0xfe,
+    0x42, 0xb0, 0xff, 0x00, 0xc0, 0xbf, 0xf4, 0x13, 0x5d, 0x86, 0x0f, 0x74, 0x75, 0x55, 0xca, 0xe8,
+    0xdf, 0xf2, 0x15, 0x83, 0xfe, 0x05, 0xff, 0x00, 0xa0, 0x9a, 0x01, 0xee, 0x8e, 0xb0, 0x57, 0x29,
+    0xa3, 0x7f, 0xc8, 0x5a, 0x0f, 0xf8, 0x17, 0xfe, 0x82, 0x69, 0x04, 0xb7, 0x47, 0x5b, 0x5c, 0x96,
+    0x8b, 0xff, 0x00, 0x21, 0x78, 0x3f, 0xe0, 0x5f, 0xfa, 0x09, 0xa0, 0x72, 0xdd, 0x1d, 0x7d, 0x2d,
+    0x49, 0x42, 0xd1, 0x48, 0x67, 0x7d, 0xf0, 0xd7, 0xfe, 0x62, 0x7f, 0xf6, 0xcb, 0xff, 0x00, 0x67,
+    0xae, 0xf6, 0xb5, 0x86, 0xc7, 0x2d, 0x4f, 0x89, 0x85, 0x15, 0x44, 0x05, 0x14, 0x00, 0x51, 0x40,
+    0x05, 0x14, 0x00, 0x51, 0x40, 0x05, 0x14, 0x00, 0x51, 0x40, 0x05, 0x14, 0x01, 0xe4, 0x7a, 0xc7,
+    0xfc, 0x87, 0x2f, 0xff, 0x00, 0xeb, 0xe6, 0x4f, 0xfd, 0x08, 0xd5, 0x3a, 0xe0, 0x7b, 0x9e, 0x84,
+    0x76, 0x46, 0x1d, 0x72, 0xda, 0x3f, 0xfc, 0x85, 0x61, 0xff, 0x00, 0x81, 0x7f, 0xe8, 0x26, 0xbb,
+    0x0c, 0x1e, 0xe8, 0xea, 0xeb, 0x94, 0xd1, 0xbf, 0xe4, 0x2b, 0x07, 0xfc, 0x0b, 0xff, 0x00, 0x41,
+    0x34, 0x04, 0xb7, 0x47, 0x5a, 0x2b, 0x93, 0xd1, 0x7f, 0xe4, 0x2d, 0x07, 0xfc, 0x0b, 0xff, 0x00,
+    0x41, 0x34, 0x87, 0x2d, 0xd1, 0xd6, 0x8a, 0xe4, 0xb4, 0x4f, 0xf9, 0x0b, 0xc1, 0xff, 0x00, 0x02,
+    0xff, 0x00, 0xd0, 0x4d, 0x01, 0x2d, 0xd1, 0xd7, 0x8a, 0x51, 0x52, 0x58, 0xb4, 0xb4, 0x80, 0xb3,
+    0x6d, 0x7d, 0x77, 0x65, 0xbb, 0xec, 0xb7, 0x53, 0xc1, 0xbf, 0x1b, 0xbc, 0xa9, 0x0a, 0xee, 0xc7,
+    0x4c, 0xe3, 0xea, 0x6a, 0xc7, 0xf6, 0xe6, 0xad, 0xff, 0x00, 0x41, 0x4b, 0xdf, 0xfc, 0x08, 0x7f,
+    0xf1, 0xa2, 0xec, 0x39, 0x53, 0xdd, 0x0b, 0xfd, 0xb9, 0xab, 0x7f, 0xd0, 0x52, 0xf7, 0xff, 0x00,
+    0x02, 0x1f, 0xfc, 0x69, 0x7f, 0xb6, 0xf5, 0x6f, 0xfa, 0x0a, 0x5e, 0xff, 0x00, 0xe0, 0x43, 0xff,
+    0x00, 0x8d, 0x2e, 0x66, 0x2e, 0x48, 0xf6, 0x17, 0xfb, 0x6f, 0x56, 0xff, 0x00, 0xa0, 0xa5, 0xef,
+    0xfe, 0x04, 0x3f, 0xf8, 0xd1, 0xfd, 0xb7, 0xab, 0x7f, 0xd0, 0x52, 0xf7, 0xff, 0x00, 0x02, 0x1f,
+    0xfc, 0x69, 0x73, 0x3e, 0xe3, 0xe4, 0x8f, 0x61, 0x7f, 0xb6, 0xf5, 0x6f, 0xfa, 0x09, 0xde, 0xff,
+    0x00, 0xe0, 0x43, 0xff, 0x00, 0x8d, 0x2f, 0xf6, 0xd6, 0xab, 0xff, 0x00, 0x41, 0x3b, 0xdf, 0xfb,
+    0xfe, 0xdf, 0xe3, 0x47, 0x33, 0xee, 0x1c, 0x91, 0xec, 0x2f, 0xf6, 0xd6, 0xab, 0xff, 0x00, 0x41,
+    0x3b, 0xdf, 0xfb, 0xfe, 0xdf, 0xe3, 0x4b, 0xfd, 0xb5, 0xaa, 0xff, 0x00, 0xd0, 0x4e, 0xf7, 0xfe,
+    0xff, 0x00, 0xb7, 0xf8, 0xd2, 0xe6, 0x7d, 0xc3, 0x92, 0x3d, 0x80, 0x6b, 0x5a, 0xaf, 0xfd, 0x04,
+    0xef, 0x3f, 0xef, 0xfb, 0x7f, 0x8d, 0x2f, 0xf6, 0xce, 0xab, 0xff, 0x00, 0x41, 0x3b, 0xcf, 0xfb,
+    0xfe, 0xdf, 0xe3, 0x4b, 0x9a, 0x5d, 0xc7, 0xc9, 0x1e, 0xc2, 0xff, 0x00, 0x6c, 0xea, 0x9f, 0xf4,
+    0x12, 0xbc, 0xff, 0x00, 0xbf, 0xed, 0xfe, 0x34, 0xbf, 0xdb, 0x3a, 0xa7, 0xfd, 0x04, 0xaf, 0x3f,
+    0xef, 0xfb, 0x7f, 0x8d, 0x2e, 0x69, 0x77, 0x0e, 0x48, 0xf6, 0x17, 0xfb, 0x67, 0x54, 0xff, 0x00,
+    0xa0, 0x95, 0xe7, 0xfd, 0xff, 0x00, 0x6f, 0xf1, 0xa5, 0xfe, 0xd9, 0xd5, 0x3f, 0xe8, 0x25, 0x79,
+    0xff, 0x00, 0x7f, 0xdb, 0xfc, 0x69, 0x73, 0xcb, 0xb8, 0xf9, 0x23, 0xd8, 0x3f, 0xb6, 0x75, 0x4f,
+    0xfa, 0x09, 0x5e, 0x7f, 0xdf, 0xf6, 0xff, 0x00, 0x1a, 0x5f, 0xed, 0x8d, 0x53, 0xfe, 0x82, 0x57,
+    0x9f, 0xf7, 0xfd, 0xbf, 0xc6, 0x8e, 0x79, 0x77, 0x0e, 0x48, 0xf6, 0x2a, 0x3b, 0xb4, 0x8e, 0xce,
+    0xec, 0x59, 0xd8, 0x92, 0xcc, 0xc7, 0x24, 0x9f, 0x53, 0x45, 0x43, 0x2c, 0xc2, 0xae, 0x5b, 0x47,
+    0xff, 0x00, 0x90, 0xac, 0x3f, 0xf0, 0x2f, 0xfd, 0x04, 0xd7, 0x69, 0xcd, 0x2d, 0xd1, 0xd5, 0xd7,
+    0x29, 0xa3, 0x7f, 0xc8, 0x56, 0x0f, 0xf8, 0x17, 0xfe, 0x82, 0x68, 0x09, 0x6e, 0x8e, 0xb6, 0xb9,
+    0x3d, 0x17, 0xfe, 0x42, 0xd0, 0x7f, 0xc0, 0xbf, 0xf4, 0x13, 0x48, 0x72, 0xdd, 0x1d, 0x68, 0xae,
+    0x4b, 0x44, 0xff, 0x00, 0x90, 0xbc, 0x1f, 0xf0, 0x2f, 0xfd, 0x04, 0xd0, 0x12, 0xdd, 0x1d, 0x80,
+    0xa0, 0x54, 0x96, 0x2d, 0x2d, 0x21, 0x8b, 0x4b, 0x48, 0x05, 0xa5, 0xa4, 0x02, 0xd2, 0xd2, 0x18,
+    0xb4, 0xb4, 0x80, 0x51, 0x4a, 0x29, 0x0c, 0x05, 0x38, 0x52, 0x00, 0x14, 0xa2, 0x90, 0xc5, 0xa5,
+    0xa0, 0x05, 0xa5, 0xa4, 0x02, 0xd2, 0xd2, 0x19, 0x87, 0x5c, 0xae, 0x8f, 0xff, 0x00, 0x21, 0x58,
+    0x7f, 0xe0, 0x5f, 0xfa, 0x09, 0xae, 0xe6, 0x73, 0xcb, 0x74, 0x75, 0x95, 0xca, 0x68, 0xdf, 0xf2,
+    0x16, 0x83, 0xfe, 0x05, 0xff, 0x00, 0xa0, 0x9a, 0x41, 0x2d, 0xd1, 0xd6, 0x0a, 0xe4, 0xf4, 0x5f,
+    0xf9, 0x0b, 0xc1, 0xff, 0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x20, 0x96, 0xe8, 0xeb, 0xab, 0x92,
+    0xd1, 0x3f, 0xe4, 0x2f, 0x07, 0xfc, 0x0b, 0xff, 0x00, 0x41, 0x34, 0x04, 0xb7, 0x47, 0x5f, 0x4b,
+    0x52, 0x68, 0x2d, 0x2d, 0x20, 0x0a, 0x75, 0x21, 0x8b, 0x45, 0x20, 0x16, 0x9d, 0x40, 0x05, 0x2d,
+    0x21, 0x8b, 0x4b, 0x48, 0x05, 0xa5, 0xa4, 0x31, 0x45, 0x2d, 0x20, 0x16, 0x8a, 0x43, 0x1d, 0x45,
+    0x20, 0x16, 0x96, 0x90, 0x18, 0x75, 0xca, 0xe8, 0xff, 0x00, 0xf2, 0x15, 0x87, 0xfe, 0x05, 0xff,
+    0x00, 0xa0, 0x9a, 0xed, 0x39, 0xe5, 0xba, 0x3a, 0xca, 0xe5, 0x34, 0x6f, 0xf9, 0x0b, 0x41, 0xff,
+    0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x01, 0x2d, 0xd1, 0xd6, 0x8a, 0xe4, 0xb4, 0x5f, 0xf9, 0x0b,
+    0xc1, 0xff, 0x00, 0x02, 0xff, 0x00, 0xd0, 0x4d, 0x20, 0x96, 0xe8, 0xeb, 0x85, 0x72, 0x5a, 0x27,
+    0xfc, 0x85, 0xe0, 0xff, 0x00, 0x81, 0x7f, 0xe8, 0x26, 0x81, 0xcb, 0x74, 0x75, 0xe2, 0x94, 0x54,
+    0x96, 0x2d, 0x2d, 0x20, 0x16, 0x96, 0x90, 0xc5, 0xa5, 0xa4, 0x02, 0xd2, 0xd2, 0x18, 0xb4, 0xb4,
+    0x80, 0x05, 0x38, 0x50, 0x31, 0x45, 0x14, 0x80, 0x5a, 0x51, 0x48, 0x62, 0xd2, 0xd2, 0x01, 0x69,
+    0x69, 0x00, 0xb4, 0xb4, 0x86, 0x61, 0x57, 0x37, 0xa5, 0x5a, 0xdc, 0x47, 0xa9, 0xc2, 0xef, 0x04,
+    0xaa, 0xa3, 0x76, 0x4b, 0x21, 0x03, 0xa1, 0xae, 0xe6, 0x73, 0x49, 0x6a, 0x8e, 0x9a, 0xb9, 0x9d,
+    0x26, 0xd6, 0xe2, 0x3d, 0x4e, 0x17, 0x92, 0xde, 0x55, 0x51, 0xbb, 0x25, 0x90, 0x80, 0x3e, 0x53,
+    0x48, 0x72, 0x5a, 0xa3, 0xa8, 0xae, 0x63, 0x48, 0xb4, 0xb9, 0x8f, 0x54, 0x85, 0xe4, 0xb7, 0x95,
+    0x14, 0x6e, 0xc9, 0x64, 0x20, 0x0f, 0x94, 0xd2, 0x09, 0x2d, 0x51, 0xd4, 0xd7, 0x2f, 0xa3, 0xda,
+    0x5c, 0xc5, 0xaa, 0x42, 0xf2, 0x5b, 0xca, 0x8a, 0x37, 0x65, 0x99, 0x08, 0x03, 0xe5, 0x34, 0x04,
+    0x96, 0xa8, 0xea, 0x85, 0x2d, 0x49, 0x61, 0x4b, 0x40, 0xc5, 0xa5, 0xa4, 0x02, 0xd2, 0xd2, 0x18,
+    0xb4, 0xb4, 0x80, 0x5a, 0x5a, 0x43, 0x16, 0x94, 0x52, 0x01, 0x45, 0x28, 0xa4, 0x00, 0x29, 0x45,
+    0x21, 0x8b, 0x4b, 0x48, 0x05, 0xa5, 0xa4, 0x31, 0x69, 0x69, 0x01, 0x87, 0x4b, 0x5d, 0xc6, 0x22,
+    0xd2, 0xd2, 0x18, 0x0a, 0x70, 0xa4, 0x01, 0x4b, 0x48, 0x62, 0xd2, 0xd2, 0x01, 0x69, 0x69, 0x00,
+    0x53, 0xa9, 0x0c, 0x5a, 0x29, 0x00, 0xb4, 0xea, 0x06, 0x14, 0xb4, 0x80, 0x5a, 0x5a, 0x43, 0x16,
+    0x96, 0x90, 0x0a, 0x29, 0x69, 0x00, 0xb4, 0x52, 0x18, 0xea, 0x29, 0x00, 0xb4, 0xb4, 0x80, 0xff,
+    0xd9,
+};
+
+static const size_t TEST_TEXT_JPEG_LENGTH = sizeof(TEST_TEXT_JPEG);
+
+#endif // TEST_IMAGES_H
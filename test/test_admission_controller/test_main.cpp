@@ -0,0 +1,242 @@
+#include <unity.h>
+#include <map>
+#include "admission_controller.cpp"
+#include "host_runtime.h"
+
+// ===================
+// Collaborator stand-ins: pyramid references counted per pyramid
+// ===================
+
+static std::map<FramePyramid*, int> pyramidRefs;
+
+CameraManager::CameraManager() {}
+
+FramePyramid* CameraManager::retainPyramid(FramePyramid* pyramid) {
+    if (pyramid) pyramidRefs[pyramid]++;
+    return pyramid;
+}
+
+void CameraManager::releasePyramid(FramePyramid* pyramid) {
+    if (pyramid) pyramidRefs[pyramid]--;
+}
+
+CameraManager cameraManager;
+
+// ===================
+// Helpers
+// ===================
+
+static const unsigned long T0 = 5000;     // ms, clock at the start of every test
+
+// Frames are one byte, so a served request shows which frame it carries
+static AdmissionDecision enqueueFrame(AdmissionController& controller, RequestPriority priority, OperationMode mode,
+                                      uint8_t frameId, unsigned long now, FramePyramid* pyramid = nullptr) {
+    return controller.enqueue(priority, mode, &frameId, 1, pyramid, now);
+}
+
+// Serves the next request and returns its frame id, or -1 when none is ready
+static int serve(AdmissionController& controller, unsigned long now, RequestPriority* priority = nullptr) {
+    QueuedRequest request;
+    if (!controller.next(now, &request)) return -1;
+    int frameId = request.imageData[0];
+    if (priority) *priority = (RequestPriority)request.priority;
+    free(request.imageData);
+    cameraManager.releasePyramid(request.pyramid);
+    return frameId;
+}
+
+// Takes every token of a class, so the next request of that class has to queue
+static void drainTokens(AdmissionController& controller, RequestPriority priority, unsigned long now) {
+    while (controller.admit(priority, now)) {}
+}
+
+void setUp() {
+    pyramidRefs.clear();
+}
+
+void tearDown() {}
+
+// ===================
+// Tests
+// ===================
+
+void test_bursts_are_capped_and_tokens_refill_per_interval() {
+    AdmissionController controller;
+    TEST_ASSERT_TRUE(controller.begin());
+
+    for (int i = 0; i < ADMISSION_MANUAL_BURST; i++) TEST_ASSERT_TRUE(controller.admit(PRIORITY_MANUAL, T0));
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_MANUAL, T0));
+    TEST_ASSERT_TRUE(controller.admit(PRIORITY_AUTO, T0));
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_AUTO, T0));
+
+    // Half an interval is half a token
+    TEST_ASSERT_FALSE(controller.hasToken(PRIORITY_AUTO, T0 + ADMISSION_AUTO_INTERVAL / 2));
+    TEST_ASSERT_TRUE(controller.hasToken(PRIORITY_AUTO, T0 + ADMISSION_AUTO_INTERVAL));
+    TEST_ASSERT_TRUE(controller.admit(PRIORITY_AUTO, T0 + ADMISSION_AUTO_INTERVAL));
+    TEST_ASSERT_TRUE(controller.admit(PRIORITY_MANUAL, T0 + ADMISSION_MANUAL_INTERVAL));
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_MANUAL, T0 + ADMISSION_MANUAL_INTERVAL));
+
+    // A long idle spell refills to the burst size, no further
+    unsigned long later = T0 + 100 * ADMISSION_MANUAL_INTERVAL;
+    int admitted = 0;
+    while (controller.admit(PRIORITY_MANUAL, later)) admitted++;
+    TEST_ASSERT_EQUAL(ADMISSION_MANUAL_BURST, admitted);
+    TEST_ASSERT_EQUAL_UINT32(2 * ADMISSION_MANUAL_BURST + 1, controller.getStats(PRIORITY_MANUAL).admitted);
+    TEST_ASSERT_EQUAL_UINT32(2, controller.getStats(PRIORITY_AUTO).admitted);
+}
+
+void test_same_class_and_mode_coalesces_into_the_newest_frame() {
+    AdmissionController controller;
+    controller.begin();
+    drainTokens(controller, PRIORITY_AUTO, T0);
+    FramePyramid* first = (FramePyramid*)0x1000;
+    FramePyramid* second = (FramePyramid*)0x2000;
+
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 1, T0, first));
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 2, T0 + 300, second));
+    TEST_ASSERT_EQUAL(1, controller.queuedCount());
+    TEST_ASSERT_EQUAL(0, pyramidRefs[first]);
+    TEST_ASSERT_EQUAL(1, pyramidRefs[second]);
+
+    // Another mode or another class queues separately
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_AUTO, MODE_HAZARD_DETECTION, 3, T0 + 300));
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_MANUAL, MODE_AUTO_ALL, 4, T0 + 300));
+    TEST_ASSERT_EQUAL(3, controller.queuedCount());
+
+    AdmissionStats stats = controller.getStats(PRIORITY_AUTO);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.queued);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.coalesced);
+
+    // The merged request carries the newest frame and waits from the first one
+    TEST_ASSERT_EQUAL(4, serve(controller, T0 + 300));
+    TEST_ASSERT_EQUAL(2, serve(controller, T0 + ADMISSION_AUTO_INTERVAL));
+    TEST_ASSERT_EQUAL(0, pyramidRefs[second]);
+    TEST_ASSERT_EQUAL_UINT32(ADMISSION_AUTO_INTERVAL, controller.getStats(PRIORITY_AUTO).lastWaitMillis);
+    controller.clear();
+}
+
+void test_full_queue_evicts_the_least_urgent_class() {
+    AdmissionController controller;
+    controller.begin();
+    drainTokens(controller, PRIORITY_AUTO, T0);
+    drainTokens(controller, PRIORITY_MANUAL, T0);
+    const OperationMode modes[] = { MODE_HAZARD_DETECTION, MODE_VISUAL_CAPTION, MODE_SIGN_DETECTION,
+                                    MODE_OCR, MODE_BARCODE, MODE_COLOUR };
+    FramePyramid* oldest = (FramePyramid*)0x1000;
+
+    for (int i = 0; i < ADMISSION_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_AUTO, modes[i], i, T0 + i,
+                                                         i == 0 ? oldest : nullptr));
+    }
+
+    // Nothing less urgent to push out for another auto request
+    TEST_ASSERT_EQUAL(ADMISSION_REJECTED, enqueueFrame(controller, PRIORITY_AUTO, modes[ADMISSION_QUEUE_DEPTH], 9, T0 + 10));
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getStats(PRIORITY_AUTO).rejected);
+
+    // A manual request takes the place of the oldest auto one
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_MANUAL, MODE_OCR, 20, T0 + 10));
+    TEST_ASSERT_EQUAL(ADMISSION_QUEUE_DEPTH, controller.queuedCount());
+    TEST_ASSERT_EQUAL_UINT32(2, controller.getStats(PRIORITY_AUTO).rejected);
+    TEST_ASSERT_EQUAL_UINT32(0, controller.getStats(PRIORITY_MANUAL).rejected);
+    TEST_ASSERT_EQUAL(0, pyramidRefs[oldest]);
+
+    // Once only manual requests are left, a further one is turned away
+    for (int i = 1; i < ADMISSION_QUEUE_DEPTH; i++) {
+        TEST_ASSERT_EQUAL(ADMISSION_QUEUED, enqueueFrame(controller, PRIORITY_MANUAL, modes[i - 1], 20 + i, T0 + 10));
+    }
+    TEST_ASSERT_EQUAL_UINT32(ADMISSION_QUEUE_DEPTH + 1, controller.getStats(PRIORITY_AUTO).rejected);
+    TEST_ASSERT_EQUAL(ADMISSION_REJECTED, enqueueFrame(controller, PRIORITY_MANUAL, MODE_COLOUR, 30, T0 + 10));
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getStats(PRIORITY_MANUAL).rejected);
+    controller.clear();
+    TEST_ASSERT_EQUAL(0, controller.queuedCount());
+}
+
+void test_requests_expire_after_the_maximum_wait() {
+    AdmissionController controller;
+    controller.begin();
+    drainTokens(controller, PRIORITY_AUTO, T0);
+    FramePyramid* pyramid = (FramePyramid*)0x1000;
+
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 1, T0, pyramid);
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_OCR, 2, T0 + 500);
+
+    // The older request is dropped, the newer one still goes out
+    TEST_ASSERT_EQUAL(2, serve(controller, T0 + ADMISSION_MAX_WAIT + 1));
+    TEST_ASSERT_EQUAL(0, controller.queuedCount());
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getStats(PRIORITY_AUTO).expired);
+    TEST_ASSERT_EQUAL(0, pyramidRefs[pyramid]);
+
+    // A request waiting exactly the maximum is still served
+    unsigned long requeued = T0 + ADMISSION_MAX_WAIT + 1;
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 3, requeued);
+    TEST_ASSERT_EQUAL(3, serve(controller, requeued + ADMISSION_MAX_WAIT));
+    TEST_ASSERT_EQUAL_UINT32(2, controller.getStats(PRIORITY_AUTO).served);
+    TEST_ASSERT_EQUAL_UINT32(1, controller.getStats(PRIORITY_AUTO).expired);
+}
+
+void test_waiting_requests_are_not_overtaken() {
+    AdmissionController controller;
+    controller.begin();
+    drainTokens(controller, PRIORITY_AUTO, T0);
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 1, T0);
+
+    // The auto token that comes in belongs to the queued auto request
+    unsigned long refilled = T0 + ADMISSION_AUTO_INTERVAL;
+    TEST_ASSERT_TRUE(controller.hasReady(refilled));
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_AUTO, refilled));
+    // A more urgent class may go ahead of it
+    TEST_ASSERT_TRUE(controller.admit(PRIORITY_MANUAL, refilled));
+
+    // Nor may a manual request pass a queued manual one
+    drainTokens(controller, PRIORITY_MANUAL, refilled);
+    enqueueFrame(controller, PRIORITY_MANUAL, MODE_OCR, 2, refilled);
+    unsigned long later = refilled + ADMISSION_MANUAL_INTERVAL;
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_MANUAL, later));
+    TEST_ASSERT_FALSE(controller.admit(PRIORITY_AUTO, later));
+
+    // The manual request is served first although the auto one is older
+    RequestPriority priority;
+    TEST_ASSERT_EQUAL(2, serve(controller, later, &priority));
+    TEST_ASSERT_EQUAL(PRIORITY_MANUAL, priority);
+    TEST_ASSERT_EQUAL(1, serve(controller, later, &priority));
+    TEST_ASSERT_EQUAL(PRIORITY_AUTO, priority);
+    TEST_ASSERT_FALSE(controller.hasReady(later));
+}
+
+void test_queue_wait_is_recorded_per_class() {
+    AdmissionController controller;
+    controller.begin();
+    drainTokens(controller, PRIORITY_AUTO, T0);
+
+    // No token, no request
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 1, T0);
+    TEST_ASSERT_EQUAL(-1, serve(controller, T0 + ADMISSION_AUTO_INTERVAL / 2));
+    TEST_ASSERT_EQUAL(1, serve(controller, T0 + ADMISSION_AUTO_INTERVAL));
+
+    unsigned long second = T0 + 2 * ADMISSION_AUTO_INTERVAL;
+    enqueueFrame(controller, PRIORITY_AUTO, MODE_AUTO_ALL, 2, second);
+    TEST_ASSERT_EQUAL(2, serve(controller, second + 3 * ADMISSION_AUTO_INTERVAL));
+
+    AdmissionStats stats = controller.getStats(PRIORITY_AUTO);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.queued);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.served);
+    TEST_ASSERT_EQUAL_UINT32(4 * ADMISSION_AUTO_INTERVAL, (uint32_t)stats.totalWaitMillis);
+    TEST_ASSERT_EQUAL_UINT32(3 * ADMISSION_AUTO_INTERVAL, stats.maxWaitMillis);
+    TEST_ASSERT_EQUAL_UINT32(3 * ADMISSION_AUTO_INTERVAL, stats.lastWaitMillis);
+
+    // The other class keeps its own figures
+    AdmissionStats manual = controller.getStats(PRIORITY_MANUAL);
+    TEST_ASSERT_EQUAL_UINT32(0, manual.served);
+    TEST_ASSERT_EQUAL_UINT32(0, (uint32_t)manual.totalWaitMillis);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_bursts_are_capped_and_tokens_refill_per_interval);
+    RUN_TEST(test_same_class_and_mode_coalesces_into_the_newest_frame);
+    RUN_TEST(test_full_queue_evicts_the_least_urgent_class);
+    RUN_TEST(test_requests_expire_after_the_maximum_wait);
+    RUN_TEST(test_waiting_requests_are_not_overtaken);
+    RUN_TEST(test_queue_wait_is_recorded_per_class);
+    return UNITY_END();
+}
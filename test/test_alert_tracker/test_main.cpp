@@ -0,0 +1,138 @@
+#include <unity.h>
+#include <string>
+#include <vector>
+#include "alert_tracker.cpp"
+#include "host_runtime.h"
+
+// One frame of a replayed sequence; source < 0 is a frame without a detection
+struct Frame {
+    int source;
+    uint32_t type;
+    uint8_t direction;
+    float position;
+    float distance;
+    float confidence;
+};
+
+static const Frame NONE = { -1, 0, 0, -1, 0, 0 };
+
+static Frame hazard(uint32_t type, uint8_t direction, float distance, float confidence, float position = -1) {
+    return { ALERT_SOURCE_HAZARD, type, direction, position, distance, confidence };
+}
+
+static Frame sign(uint32_t type) {
+    return { ALERT_SOURCE_SIGN, type, 0, -1, 0, 0.9f };
+}
+
+// Replays frames 5 s apart; N = new alert, E = escalation, . = silent, - = no detection
+static std::string replay(uint8_t source, const std::vector<Frame>& frames) {
+    AlertTracker tracker;
+    std::string decisions;
+    unsigned long now = 1000;
+    for (const Frame& frame : frames) {
+        AlertObservation observation = { (uint8_t)frame.source, frame.type, frame.direction,
+                                         frame.position, frame.distance, frame.confidence };
+        AlertDecision decision = tracker.update(source, frame.source < 0 ? nullptr : &observation, now);
+        if (frame.source < 0) {
+            decisions += '-';
+        } else {
+            decisions += decision == ALERT_NEW ? 'N' : decision == ALERT_ESCALATE ? 'E' : '.';
+        }
+        now += 5000;
+    }
+    return decisions;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_steady_hazard_is_announced_once() {
+    TEST_ASSERT_EQUAL_STRING("N.....", replay(ALERT_SOURCE_HAZARD, {
+        hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.85f),
+        hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.9f) }).c_str());
+}
+
+void test_single_missed_frame_keeps_the_track() {
+    TEST_ASSERT_EQUAL_STRING("N.-..", replay(ALERT_SOURCE_HAZARD, {
+        hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.9f), NONE, hazard(1, 3, 0, 0.9f), hazard(1, 3, 0, 0.9f) }).c_str());
+}
+
+void test_cleared_track_is_announced_again() {
+    TEST_ASSERT_EQUAL_STRING("N--N", replay(ALERT_SOURCE_HAZARD, {
+        hazard(1, 3, 0, 0.9f), NONE, NONE, hazard(1, 3, 0, 0.9f) }).c_str());
+}
+
+void test_approaching_hazard_escalates() {
+    TEST_ASSERT_EQUAL_STRING("N.E.E.", replay(ALERT_SOURCE_HAZARD, {
+        hazard(2, 1, 6, 0.9f), hazard(2, 1, 5.5f, 0.9f), hazard(2, 1, 4, 0.9f),
+        hazard(2, 1, 3.5f, 0.9f), hazard(2, 1, 2.5f, 0.9f), hazard(2, 1, 2.4f, 0.9f) }).c_str());
+}
+
+void test_low_confidence_waits_for_the_score() {
+    TEST_ASSERT_EQUAL_STRING("..NE.", replay(ALERT_SOURCE_HAZARD, {
+        hazard(4, 3, 0, 0.4f), hazard(4, 3, 0, 0.4f), hazard(4, 3, 0, 0.5f),
+        hazard(4, 3, 0, 0.9f), hazard(4, 3, 0, 0.9f) }).c_str());
+    TEST_ASSERT_EQUAL_STRING(".--.", replay(ALERT_SOURCE_HAZARD, {
+        hazard(4, 3, 0, 0.4f), NONE, NONE, hazard(4, 3, 0, 0.4f) }).c_str());
+}
+
+void test_separate_hazards_are_tracked_separately() {
+    TEST_ASSERT_EQUAL_STRING("NN..", replay(ALERT_SOURCE_HAZARD, {
+        hazard(1, 1, 0, 0.9f), hazard(7, 2, 0, 0.9f), hazard(1, 1, 0, 0.9f), hazard(7, 2, 0, 0.9f) }).c_str());
+    TEST_ASSERT_EQUAL_STRING("N.N", replay(ALERT_SOURCE_HAZARD, {
+        hazard(1, 3, 0, 0.9f, 0.2f), hazard(1, 3, 0, 0.9f, 0.25f), hazard(1, 3, 0, 0.9f, 0.8f) }).c_str());
+}
+
+void test_signs_are_deduplicated() {
+    TEST_ASSERT_EQUAL_STRING("N.-.N", replay(ALERT_SOURCE_SIGN, {
+        sign(42), sign(42), NONE, sign(42), sign(43) }).c_str());
+}
+
+void test_tracks_expire_after_the_timeout() {
+    AlertTracker tracker;
+    AlertObservation observation = { ALERT_SOURCE_HAZARD, 1, 3, -1, 0, 0.9f };
+    TEST_ASSERT_EQUAL(ALERT_NEW, tracker.update(ALERT_SOURCE_HAZARD, &observation, 0));
+    TEST_ASSERT_EQUAL(ALERT_NEW, tracker.update(ALERT_SOURCE_HAZARD, &observation, ALERT_TRACK_TIMEOUT + 1));
+}
+
+void test_oldest_track_is_evicted_when_full() {
+    AlertTracker tracker;
+    int announced = 0;
+    // Updated as another source, so no sign track counts a miss
+    for (int i = 0; i < ALERT_MAX_TRACKS + 3; i++) {
+        AlertObservation observation = { ALERT_SOURCE_SIGN, (uint32_t)i, 0, -1, 0, 0.9f };
+        if (tracker.update(ALERT_SOURCE_LOCAL, &observation, i) == ALERT_NEW) announced++;
+    }
+    TEST_ASSERT_EQUAL(ALERT_MAX_TRACKS + 3, announced);
+    TEST_ASSERT_EQUAL(ALERT_MAX_TRACKS, tracker.activeTracks());
+}
+
+void test_mark_announced_silences_the_confirmation() {
+    // Announced early by the local classifier: the cloud's sightings stay quiet
+    AlertObservation cloud = { ALERT_SOURCE_HAZARD, 1, 3, -1, 0, 0.5f };
+    AlertTracker marked;
+    TEST_ASSERT_EQUAL(ALERT_SILENT, marked.update(ALERT_SOURCE_HAZARD, &cloud, 1000));
+    marked.markAnnounced(cloud, 1000);
+    TEST_ASSERT_EQUAL(1, marked.activeTracks());
+    TEST_ASSERT_EQUAL(ALERT_SILENT, marked.update(ALERT_SOURCE_HAZARD, &cloud, 6000));
+
+    // Without it the second sighting reaches the score and alerts
+    AlertTracker unmarked;
+    TEST_ASSERT_EQUAL(ALERT_SILENT, unmarked.update(ALERT_SOURCE_HAZARD, &cloud, 1000));
+    TEST_ASSERT_EQUAL(ALERT_NEW, unmarked.update(ALERT_SOURCE_HAZARD, &cloud, 6000));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_hazard_is_announced_once);
+    RUN_TEST(test_single_missed_frame_keeps_the_track);
+    RUN_TEST(test_cleared_track_is_announced_again);
+    RUN_TEST(test_approaching_hazard_escalates);
+    RUN_TEST(test_low_confidence_waits_for_the_score);
+    RUN_TEST(test_separate_hazards_are_tracked_separately);
+    RUN_TEST(test_signs_are_deduplicated);
+    RUN_TEST(test_tracks_expire_after_the_timeout);
+    RUN_TEST(test_oldest_track_is_evicted_when_full);
+    RUN_TEST(test_mark_announced_silences_the_confirmation);
+    return UNITY_END();
+}
@@ -0,0 +1,228 @@
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <vector>
+#define AUDIO_HOST_SINK "test_audio_manager.pcm"
+#define HOST_LITTLEFS_ROOT "test_audio_manager_fs"
+#include "audio_manager.cpp"
+#include "audio_output.cpp"
+#include "clip_cache.cpp"
+#include "mp3_stream.cpp"
+#include "host_runtime.h"
+
+// ===================
+// Collaborator stand-ins: LittleFS over a scratch directory, no MP3 decoder
+// ===================
+
+LittleFSFS LittleFS;
+
+HMP3Decoder MP3InitDecoder(void) { return nullptr; }
+void MP3FreeDecoder(HMP3Decoder) {}
+int MP3Decode(HMP3Decoder, unsigned char**, int*, short*, int) { return ERR_MP3_INVALID_FRAMEHEADER; }
+void MP3GetLastFrameInfo(HMP3Decoder, MP3FrameInfo* info) { memset(info, 0, sizeof(MP3FrameInfo)); }
+int MP3FindSyncWord(unsigned char*, int) { return -1; }
+
+// ===================
+// Clips
+// ===================
+
+// 16-bit PCM WAV of interleaved samples
+static std::vector<uint8_t> makeWav(const std::vector<int16_t>& samples, uint32_t rate, uint16_t channels) {
+    uint32_t dataSize = samples.size() * sizeof(int16_t);
+    std::vector<uint8_t> wav(44 + dataSize);
+    auto put16 = [&wav](size_t at, uint16_t v) { wav[at] = v; wav[at + 1] = v >> 8; };
+    auto put32 = [&wav](size_t at, uint32_t v) { for (int i = 0; i < 4; i++) wav[at + i] = v >> (8 * i); };
+    memcpy(&wav[0], "RIFF", 4);
+    put32(4, 36 + dataSize);
+    memcpy(&wav[8], "WAVEfmt ", 8);
+    put32(16, 16);
+    put16(20, 1);
+    put16(22, channels);
+    put32(24, rate);
+    put32(28, rate * channels * 2);
+    put16(32, channels * 2);
+    put16(34, 16);
+    memcpy(&wav[36], "data", 4);
+    put32(40, dataSize);
+    memcpy(&wav[44], samples.data(), dataSize);
+    return wav;
+}
+
+// `seconds` of a `frequency` sine at `rate`, the same on every channel
+static std::vector<int16_t> sine(float frequency, float seconds, uint32_t rate, int channels) {
+    std::vector<int16_t> samples;
+    for (int i = 0; i < (int)(seconds * rate); i++) {
+        int16_t value = (int16_t)lroundf(12000 * sinf(2 * (float)M_PI * frequency * i / rate));
+        for (int c = 0; c < channels; c++) samples.push_back(value);
+    }
+    return samples;
+}
+
+static std::vector<int16_t> readSink() {
+    std::vector<int16_t> samples;
+    FILE* file = fopen(AUDIO_HOST_SINK, "rb");
+    if (!file) return samples;
+    int16_t sample;
+    while (fread(&sample, sizeof(sample), 1, file) == 1) samples.push_back(sample);
+    fclose(file);
+    return samples;
+}
+
+// Waits until every queued clip has played out
+static void waitForSilence(unsigned long timeoutMs) {
+    unsigned long start = millis();
+    while ((audioManager.isCurrentlyPlaying() || audioManager.hasQueuedAudio()) && millis() - start < timeoutMs) delay(5);
+    delay(20);
+}
+
+void setUp() {
+    std::filesystem::create_directories(HOST_LITTLEFS_ROOT AUDIO_DIR);
+    TEST_ASSERT_TRUE(audioManager.initialize());
+    audioManager.setGlobalVolume(100);
+}
+
+void tearDown() {
+    audioManager.deinitialize();
+    std::filesystem::remove_all(HOST_LITTLEFS_ROOT);
+    remove(AUDIO_HOST_SINK);
+}
+
+void test_memory_wav_reaches_the_sink_unchanged() {
+    std::vector<int16_t> samples = sine(440, 1.0f, AUDIO_SAMPLE_RATE, 1);
+    std::vector<uint8_t> wav = makeWav(samples, AUDIO_SAMPLE_RATE, 1);
+    AudioManagerStats before = audioManager.getStats();
+    TEST_ASSERT_TRUE(audioManager.playAudioData(wav.data(), wav.size(), AUDIO_CAPTION));
+    // The queue took a copy
+    std::fill(wav.begin(), wav.end(), 0);
+    waitForSilence(3000);
+    TEST_ASSERT_EQUAL(before.played + 1, audioManager.getStats().played);
+
+    std::vector<int16_t> played = readSink();
+    TEST_ASSERT_EQUAL(samples.size(), played.size());
+    TEST_ASSERT_EQUAL_MEMORY(samples.data(), played.data(), samples.size() * sizeof(int16_t));
+}
+
+void test_stereo_clip_is_resampled_to_the_output_rate() {
+    const uint32_t rate = 22050;
+    std::vector<uint8_t> wav = makeWav(sine(1000, 1.0f, rate, 2), rate, 2);
+    TEST_ASSERT_TRUE(audioManager.playAudioData(wav.data(), wav.size(), AUDIO_CAPTION));
+    waitForSilence(3000);
+
+    std::vector<int16_t> played = readSink();
+    TEST_ASSERT_INT_WITHIN(2, AUDIO_SAMPLE_RATE, played.size());
+    // Against the ideal sine at the output rate, allowing the resampler a sample of delay
+    std::vector<int16_t> ideal = sine(1000, 1.0f, AUDIO_SAMPLE_RATE, 1);
+    double best = 0;
+    for (int lag = 0; lag <= 1; lag++) {
+        double signal = 0, error = 0;
+        for (size_t i = lag; i + 1 < played.size() && i < ideal.size(); i++) {
+            signal += (double)ideal[i - lag] * ideal[i - lag];
+            error += ((double)played[i] - ideal[i - lag]) * ((double)played[i] - ideal[i - lag]);
+        }
+        best = max(best, 10 * log10(signal / max(error, 1.0)));
+    }
+    TEST_ASSERT_GREATER_THAN(35, (int)best);
+}
+
+void test_hazard_alert_cuts_a_caption_short_and_jumps_the_queue() {
+    std::vector<int16_t> hazardSamples = sine(900, 0.3f, AUDIO_SAMPLE_RATE, 1);
+    std::vector<uint8_t> caption = makeWav(sine(300, 3.0f, AUDIO_SAMPLE_RATE, 1), AUDIO_SAMPLE_RATE, 1);
+    std::vector<uint8_t> hazard = makeWav(hazardSamples, AUDIO_SAMPLE_RATE, 1);
+    FILE* file = fopen(HOST_LITTLEFS_ROOT AUDIO_DIR "hazard_left.wav", "wb");
+    fwrite(hazard.data(), 1, hazard.size(), file);
+    fclose(file);
+
+    AudioManagerStats before = audioManager.getStats();
+    audioManager.playAudioData(caption.data(), caption.size(), AUDIO_CAPTION);
+    delay(300);
+    audioManager.playModeChangeConfirmation("reading");
+    audioManager.playHazardAlert("obstacle", "left");
+    waitForSilence(3000);
+
+    AudioManagerStats after = audioManager.getStats();
+    TEST_ASSERT_EQUAL(1, after.interrupted - before.interrupted);
+    TEST_ASSERT_EQUAL(2, after.played - before.played);
+
+    // The hazard follows what had reached the DMA of the caption, whole, and
+    // the mode change tone (no clip on flash) comes after it
+    std::vector<int16_t> played = readSink();
+    auto at = std::search(played.begin(), played.end(), hazardSamples.begin(), hazardSamples.begin() + 64);
+    TEST_ASSERT_TRUE(at != played.end());
+    size_t position = at - played.begin();
+    TEST_ASSERT_LESS_THAN(AUDIO_SAMPLE_RATE * 3 / 5, position);
+    TEST_ASSERT_GREATER_THAN(position + hazardSamples.size(), played.size());
+    TEST_ASSERT_EQUAL_MEMORY(hazardSamples.data(), &played[position], hazardSamples.size() * sizeof(int16_t));
+}
+
+// Prints how long play calls take to return while a clip plays, the latency from
+// startStream() to the first samples at the sink, and the underruns over
+// back-to-back clips
+void test_benchmark_play_latency() {
+    std::vector<uint8_t> caption = makeWav(sine(300, 4.0f, AUDIO_SAMPLE_RATE, 1), AUDIO_SAMPLE_RATE, 1);
+    std::vector<uint8_t> reply = makeWav(sine(500, 0.5f, AUDIO_SAMPLE_RATE, 1), AUDIO_SAMPLE_RATE, 1);
+    std::vector<uint8_t> click = makeWav(sine(1000, 0.1f, AUDIO_SAMPLE_RATE, 1), AUDIO_SAMPLE_RATE, 1);
+    audioManager.playAudioData(caption.data(), caption.size(), AUDIO_CAPTION);
+    delay(100);
+
+    // Each call queues behind the playing caption; the queue is emptied untimed
+    std::vector<double> toneMicros, clipMicros;
+    for (int i = 0; i < 100; i++) {
+        auto start = std::chrono::steady_clock::now();
+        audioManager.playTone(880, 80, 1, AUDIO_SYSTEM);
+        toneMicros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        start = std::chrono::steady_clock::now();
+        audioManager.playAudioData(reply.data(), reply.size(), AUDIO_OCR);
+        clipMicros.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        audioManager.clearQueue();
+        delay(2);
+    }
+    TEST_ASSERT_TRUE(audioManager.isCurrentlyPlaying());
+    audioManager.stopAllAudio();
+    waitForSilence(2000);
+
+    // Restart so that the silence after the stopped caption is not counted below
+    audioManager.deinitialize();
+    TEST_ASSERT_TRUE(audioManager.initialize());
+    audioManager.setGlobalVolume(100);
+
+    // Clips started from silence, for the latency to the first samples
+    AudioOutputStats before = audioOutput.getStats();
+    for (int i = 0; i < 10; i++) {
+        audioManager.playAudioData(click.data(), click.size(), AUDIO_OCR);
+        waitForSilence(2000);
+    }
+    AudioOutputStats isolated = audioOutput.getStats();
+    uint32_t streams = isolated.streams - before.streams;
+    TEST_ASSERT_EQUAL(10, streams);
+
+    // Back-to-back clips: the ring must keep the DMA fed across clip changes
+    for (int i = 0; i < 4; i++) audioManager.playAudioData(reply.data(), reply.size(), AUDIO_OCR);
+    waitForSilence(5000);
+    AudioOutputStats output = audioOutput.getStats();
+
+    std::sort(toneMicros.begin(), toneMicros.end());
+    std::sort(clipMicros.begin(), clipMicros.end());
+    char line[200];
+    snprintf(line, sizeof(line), "play calls while playing: tone median %.1f us (max %.1f), 16 KB clip median %.1f us (max %.1f)",
+             toneMicros[toneMicros.size() / 2], toneMicros.back(), clipMicros[clipMicros.size() / 2], clipMicros.back());
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "startStream to first samples at the sink: %.0f us mean over %u clips started from silence",
+             (double)(isolated.totalStartMicros - before.totalStartMicros) / streams, (unsigned)streams);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "4 clips back to back: %u underruns (%.1f ms of silence) over %.1f s played",
+             (unsigned)(output.underruns - isolated.underruns),
+             (output.underrunSamples - isolated.underrunSamples) * 1000.0 / AUDIO_SAMPLE_RATE,
+             (double)(output.samplesPlayed - isolated.samplesPlayed) / AUDIO_SAMPLE_RATE);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_memory_wav_reaches_the_sink_unchanged);
+    RUN_TEST(test_stereo_clip_is_resampled_to_the_output_rate);
+    RUN_TEST(test_hazard_alert_cuts_a_caption_short_and_jumps_the_queue);
+    RUN_TEST(test_benchmark_play_latency);
+    return UNITY_END();
+}
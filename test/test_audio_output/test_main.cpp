@@ -0,0 +1,154 @@
+#include <unity.h>
+#include <vector>
+#define AUDIO_HOST_SINK "test_audio_output.pcm"
+#include "audio_output.cpp"
+#include "host_runtime.h"
+
+static std::vector<int16_t> ramp(size_t count, int start) {
+    std::vector<int16_t> samples(count);
+    for (size_t i = 0; i < count; i++) samples[i] = (int16_t)(start + i * 7);
+    return samples;
+}
+
+static std::vector<int16_t> readSink() {
+    std::vector<int16_t> samples;
+    FILE* file = fopen(AUDIO_HOST_SINK, "rb");
+    if (!file) return samples;
+    int16_t sample;
+    while (fread(&sample, sizeof(sample), 1, file) == 1) samples.push_back(sample);
+    fclose(file);
+    return samples;
+}
+
+// Waits until the output task has played everything buffered
+static void waitForDrain(AudioOutput& output) {
+    unsigned long start = millis();
+    while (output.bufferedSamples() > 0 && millis() - start < 2000) delay(5);
+    delay(20);
+}
+
+void setUp() {}
+
+void tearDown() {
+    remove(AUDIO_HOST_SINK);
+}
+
+void test_ring_wraps_and_keeps_order() {
+    PcmRingBuffer ring;
+    TEST_ASSERT_FALSE(ring.allocate(1000));
+    TEST_ASSERT_TRUE(ring.allocate(16));
+
+    std::vector<int16_t> data = ramp(40, -100);
+    int16_t out[16];
+    size_t written = 0, read = 0;
+    // Uneven chunks so the indices cross the end of the ring at different points
+    while (read < data.size()) {
+        written += ring.write(data.data() + written, std::min<size_t>(11, data.size() - written));
+        TEST_ASSERT_EQUAL(16, ring.space() + ring.available());
+        size_t count = ring.read(out, 5);
+        for (size_t i = 0; i < count; i++) TEST_ASSERT_EQUAL(data[read + i], out[i]);
+        read += count;
+    }
+    TEST_ASSERT_EQUAL(0, ring.available());
+
+    TEST_ASSERT_EQUAL(16, ring.write(data.data(), 20));
+    ring.discard();
+    TEST_ASSERT_EQUAL(0, ring.available());
+    TEST_ASSERT_EQUAL(16, ring.space());
+}
+
+void test_stream_reaches_the_sink_unchanged() {
+    AudioOutput output;
+    TEST_ASSERT_TRUE(output.begin());
+    // 0.75 s: more than the ring holds, so the producer waits for space
+    std::vector<int16_t> samples = ramp(AUDIO_SAMPLE_RATE * 3 / 4, -20000);
+    unsigned long start = millis();
+    output.startStream();
+    for (size_t i = 0; i < samples.size(); i += AUDIO_CHUNK_SAMPLES) {
+        size_t count = std::min<size_t>(AUDIO_CHUNK_SAMPLES, samples.size() - i);
+        TEST_ASSERT_EQUAL(count, output.write(samples.data() + i, count, 1000));
+    }
+    output.endStream();
+    TEST_ASSERT_TRUE(output.isDraining());
+    waitForDrain(output);
+    TEST_ASSERT_FALSE(output.isDraining());
+    // Paced in real time, less what the DMA buffers hold ahead
+    TEST_ASSERT_GREATER_OR_EQUAL(750 - AUDIO_DMA_BUFFERS * AUDIO_DMA_FRAMES * 1000 / AUDIO_SAMPLE_RATE,
+                                 millis() - start);
+
+    AudioOutputStats stats = output.getStats();
+    output.end();
+    TEST_ASSERT_EQUAL(1, stats.streams);
+    TEST_ASSERT_EQUAL(samples.size(), stats.samplesPlayed);
+    TEST_ASSERT_EQUAL(0, stats.underruns);
+    TEST_ASSERT_LESS_OR_EQUAL(AUDIO_RING_SAMPLES, stats.maxFill);
+    TEST_ASSERT_INT_WITHIN(50, start, stats.lastFirstSamplesMillis);
+
+    std::vector<int16_t> played = readSink();
+    TEST_ASSERT_EQUAL(samples.size(), played.size());
+    TEST_ASSERT_EQUAL_MEMORY(samples.data(), played.data(), samples.size() * sizeof(int16_t));
+}
+
+void test_volume_scales_samples() {
+    AudioOutput output;
+    TEST_ASSERT_TRUE(output.begin());
+    output.setVolume(50);
+    std::vector<int16_t> samples = ramp(AUDIO_DMA_FRAMES * 4, -3000);
+    output.startStream();
+    output.write(samples.data(), samples.size(), 1000);
+    output.endStream();
+    waitForDrain(output);
+    output.end();
+
+    std::vector<int16_t> played = readSink();
+    TEST_ASSERT_EQUAL(samples.size(), played.size());
+    for (size_t i = 0; i < samples.size(); i++) TEST_ASSERT_EQUAL(samples[i] * 50 / 100, played[i]);
+}
+
+void test_gap_in_a_stream_counts_as_one_underrun() {
+    AudioOutput output;
+    TEST_ASSERT_TRUE(output.begin());
+    std::vector<int16_t> samples = ramp(AUDIO_DMA_FRAMES * 2, 0);
+    output.startStream();
+    output.write(samples.data(), samples.size(), 1000);
+    // The DMA plays out its 32 ms, then zeros for the rest of the gap
+    delay(200);
+    output.write(samples.data(), samples.size(), 1000);
+    output.endStream();
+    waitForDrain(output);
+
+    AudioOutputStats stats = output.getStats();
+    output.end();
+    TEST_ASSERT_EQUAL(1, stats.streams);
+    TEST_ASSERT_EQUAL(1, stats.underruns);
+    TEST_ASSERT_INT_WITHIN(AUDIO_SAMPLE_RATE / 20, AUDIO_SAMPLE_RATE * 168 / 1000, stats.underrunSamples);
+    TEST_ASSERT_EQUAL(2 * samples.size(), readSink().size());
+}
+
+void test_flush_drops_buffered_samples() {
+    AudioOutput output;
+    TEST_ASSERT_TRUE(output.begin());
+    output.setPaused(true);
+    std::vector<int16_t> samples = ramp(AUDIO_DMA_FRAMES * 8, 0);
+    output.startStream();
+    TEST_ASSERT_EQUAL(samples.size(), output.write(samples.data(), samples.size(), 1000));
+    TEST_ASSERT_EQUAL(samples.size(), output.bufferedSamples());
+    output.flush();
+    TEST_ASSERT_EQUAL(0, output.bufferedSamples());
+    TEST_ASSERT_EQUAL(AUDIO_RING_SAMPLES, output.freeSamples());
+    output.endStream();
+    output.setPaused(false);
+    delay(20);
+    output.end();
+    TEST_ASSERT_EQUAL(0, readSink().size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_wraps_and_keeps_order);
+    RUN_TEST(test_stream_reaches_the_sink_unchanged);
+    RUN_TEST(test_volume_scales_samples);
+    RUN_TEST(test_gap_in_a_stream_counts_as_one_underrun);
+    RUN_TEST(test_flush_drops_buffered_samples);
+    return UNITY_END();
+}
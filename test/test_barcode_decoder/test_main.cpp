@@ -0,0 +1,775 @@
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "barcode_decoder.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+// Module grids from the Python qrcode package (mask 3, no quiet zone), '#' = dark
+// "HELLO WORLD", 21x21
+static const char* const QR_HELLO_V1[21] = {
+    "#######.##..#.#######",
+    "#.....#.#.#...#.....#",
+    "#.###.#...#...#.###.#",
+    "#.###.#.#.##..#.###.#",
+    "#.###.#.......#.###.#",
+    "#.....#.......#.....#",
+    "#######.#.#.#.#######",
+    "........##...........",
+    "#.##.###.#....#..#.##",
+    "#.####.##...##..#####",
+    "#..#..#####.#.#...#..",
+    "###.#..####.##..#.##.",
+    ".###.####.##......#..",
+    "........###..#.#..##.",
+    "#######.#....###.#.##",
+    "#.....#.########..##.",
+    "#.###.#..###..##...##",
+    "#.###.#.##...#..##.#.",
+    "#.###.#.#..#.#..##...",
+    "#.....#..#.##.##.#...",
+    "#######.##.##..#..##.",
+};
+
+// "https://example.com/p?id=42", 29x29
+static const char* const QR_URL_V3[29] = {
+    "#######..###...##.#...#######",
+    "#.....#.#.#.###..#..#.#.....#",
+    "#.###.#.#..##..#..#...#.###.#",
+    "#.###.#....####..#....#.###.#",
+    "#.###.#..##...#....#..#.###.#",
+    "#.....#....##...####..#.....#",
+    "#######.#.#.#.#.#.#.#.#######",
+    "..........#######...#........",
+    ".###.##...#.....#.#.#.....##.",
+    ".###...#.....##..###.######.#",
+    "#.##.#####..#..#.##.#.#.##.#.",
+    "#..#.#...#..#..#..###..##...#",
+    "####.######......#..##.#..###",
+    "####....###...##.###..##.##.#",
+    ".##...#.#.###...#..##..###.##",
+    "#.#..#..#.###.#.....#...##..#",
+    "....#.##.##.#..#.#...#..##...",
+    "..#..#...###..#...#.......#..",
+    "#..##.###.#.#.#...#.#.#.##...",
+    "..##...###.#.#####...###..###",
+    ".#..###..#.#...####.#######..",
+    "........##.##....##.#...##.##",
+    "#######..#..#...#.###.#.#.##.",
+    "#.....#.#####.#..#..#...#....",
+    "#.###.#..##.#..##...#######.#",
+    "#.###.#.###..##....#....##.#.",
+    "#.###.#.#.#.......#.#..#..#.#",
+    "#.....#.##....##..###...##.#.",
+    "#######..#.#.#....#.#..#.#.#.",
+};
+
+// "0123456789" x 12, 45x45
+static const char* const QR_DIGITS_V7[45] = {
+    "#######.####....###..#..##.###..#...#.#######",
+    "#.....#....#..#.#.####..#..#.####..#..#.....#",
+    "#.###.#.#...#..#..##..#...###..#.#.#..#.###.#",
+    "#.###.#.###....#.#.#......##.####..##.#.###.#",
+    "#.###.#.#.#..#####..######.#.#....###.#.###.#",
+    "#.....#...####...####...##..##..#.....#.....#",
+    "#######.#.#.#.#.#.#.#.#.#.#.#.#.#.#.#.#######",
+    ".........##.#########...#..#.#....#.#........",
+    "####..#.##...#.###############.##...##..###.#",
+    ".#####...#.#.#.#..#.....##.#.##.####..##..#.#",
+    "...##.#.#.####.#.#..##..#..###.##..#..###....",
+    "#...##.#.###.##.##..###.##..###...##.#..#..##",
+    "..#.#.##.#.####...#.##.#.#..#......###..####.",
+    ".##....#...##.#....#.###..#.#.###..#..#.#...#",
+    "####..####....###..#...##..#...#.###...#..#.#",
+    "..#.##.#.##...##.####.######.#..#.#.###..#..#",
+    "#######.#....#...#......#....#####....######.",
+    ".###.#...##..#.#.#..#.##.#..#.#..#.......####",
+    ".#.########....###.#.#..##.....#..#..#..#..#.",
+    "###.##...#...######.#....#.#.#..###.##.#..###",
+    "###.######.#.#..###.#######.##..#...#####....",
+    "#.#.#...#..###..#.#.#...###...#.#.#.#...#.##.",
+    "#.###.#.#.###.#.#.#.#.#.#.#....#....#.#.#...#",
+    "###.#...##.....#..###...#..##.##.####...##...",
+    "..#######...#....#.######.....###.#.#####.#..",
+    "######.##...###..#..#..#.#....#.#.#.#....#..#",
+    "#...#.##....#.###..##.#.####.#.#...#..####..#",
+    "..#..#..#..#..##.##....#...#.#.#.#.#...#..#..",
+    "....####.#.#.#.#.#..#....######.##.#.###....#",
+    ".##.#....#####..##.####..#...##...##.#..####.",
+    "##.#.##..#...##...##..#.##..#.#....#...##..##",
+    "####....#.#.#......#..#.#.....#.#..#..#.###..",
+    ".#...##...##..#.#....#..###..##..##.##..#.#.#",
+    "#.#..#.#....#...###.##.#..##.###..#.##..##...",
+    "....#.##.#....#.#.#######.###.###.##..#.###.#",
+    ".####..#.#.....#..#.#...#.###..#.#.##..#.####",
+    "#..##.####.##..#.#.######.##.######.#####.###",
+    "........####.#####.##...##.#.#...####...#####",
+    "#######..###.#...####.#.##..##..#.###.#.#..#.",
+    "#.....#.....##..#...#...###.......###...##.#.",
+    "#.###.#..###..##..#.############.#.######...#",
+    "#.###.#.#####...#....#.##.#....#.#....##.....",
+    "#.###.#.#.#..##...#..#.####.###.##.#.....##..",
+    "#.....#.#...#......##.....#...###..#######.##",
+    "#######.#.#...###..#.##....#..##.####..#.#.#.",
+};
+
+static const char* DIGITS_120 =
+    "0123456789012345678901234567890123456789012345678901234567890123456789"
+    "01234567890123456789012345678901234567890123456789";
+
+static std::vector<uint8_t> modulesOf(const char* const* rows, int size) {
+    std::vector<uint8_t> modules(size * size);
+    for (int i = 0; i < size * size; i++) modules[i] = rows[i / size][i % size] == '#';
+    return modules;
+}
+
+// EAN L codes as module strings, '1' = bar; R is the complement and G the reversed R
+static const char* EAN_L[10] = {
+    "0001101", "0011001", "0010011", "0111101", "0100011",
+    "0110001", "0101111", "0111011", "0110111", "0001011"
+};
+static const char* EAN13_PARITY[10] = {
+    "LLLLLL", "LLGLGG", "LLGGLG", "LLGGGL", "LGLLGG", "LGGLLG", "LGGGLL", "LGLGLG", "LGLGGL", "LGGLGL"
+};
+
+static std::string eanDigit(int digit, char set) {
+    std::string bits = EAN_L[digit];
+    if (set == 'L') return bits;
+    for (char& bit : bits) bit = bit == '1' ? '0' : '1';
+    if (set == 'G') bits = std::string(bits.rbegin(), bits.rend());
+    return bits;
+}
+
+static std::string ean13Modules(const char* code) {
+    std::string bits = "101";
+    for (int i = 0; i < 6; i++) bits += eanDigit(code[i + 1] - '0', EAN13_PARITY[code[0] - '0'][i]);
+    bits += "01010";
+    for (int i = 7; i < 13; i++) bits += eanDigit(code[i] - '0', 'R');
+    return bits + "101";
+}
+
+static std::string ean8Modules(const char* code) {
+    std::string bits = "101";
+    for (int i = 0; i < 4; i++) bits += eanDigit(code[i] - '0', 'L');
+    bits += "01010";
+    for (int i = 4; i < 8; i++) bits += eanDigit(code[i] - '0', 'R');
+    return bits + "101";
+}
+
+// Scanline runs for a code with a 10-module quiet zone each side; bars print
+// `spread` pixels wider than they should, taken from the spaces next to them
+static std::vector<uint16_t> linearRuns(const std::string& bits, int moduleSize, int spread) {
+    std::vector<uint16_t> runs = { (uint16_t)(10 * moduleSize) };
+    char colour = '0';
+    for (char bit : bits) {
+        if (bit != colour) {
+            colour = bit;
+            runs.push_back(0);
+        }
+        runs.back() += moduleSize;
+    }
+    runs.push_back(10 * moduleSize);
+    for (size_t i = 1; i + 1 < runs.size(); i += 2) {
+        runs[i] += spread;
+        runs[i - 1] -= spread / 2;
+        runs[i + 1] -= spread - spread / 2;
+    }
+    return runs;
+}
+
+static bool decodeRuns(const std::vector<uint16_t>& runs, BarcodeResult* result) {
+    int centreRun;
+    memset(result, 0, sizeof(BarcodeResult));
+    return BarcodeDecoder::decodeLinearRuns(runs.data(), runs.size(), result, &centreRun);
+}
+
+// Grayscale page with uneven light: 200 at the left falling to 120 at the right
+static std::vector<uint8_t> page(int width, int height) {
+    std::vector<uint8_t> gray(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) gray[y * width + x] = 200 - 80 * x / width;
+    }
+    return gray;
+}
+
+// Darkens the modules of a QR grid drawn at (left, top), rotated by `degrees` about its centre
+static void drawQr(std::vector<uint8_t>& gray, int width, const std::vector<uint8_t>& modules, int size,
+                   int left, int top, float moduleSize, float degrees) {
+    int height = gray.size() / width;
+    float centreX = left + size * moduleSize / 2;
+    float centreY = top + size * moduleSize / 2;
+    float c = cosf(degrees * (float)M_PI / 180), s = sinf(degrees * (float)M_PI / 180);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            float u = (c * (x - centreX) + s * (y - centreY)) / moduleSize + size / 2.0f;
+            float v = (-s * (x - centreX) + c * (y - centreY)) / moduleSize + size / 2.0f;
+            if (u < 0 || v < 0 || u >= size || v >= size) continue;
+            if (modules[(int)v * size + (int)u]) gray[y * width + x] = 30;
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_ean13_upca_and_ean8_from_runs() {
+    BarcodeResult result;
+    TEST_ASSERT_TRUE(decodeRuns(linearRuns(ean13Modules("4006381333931"), 2, 0), &result));
+    TEST_ASSERT_EQUAL(BARCODE_EAN13, result.format);
+    TEST_ASSERT_EQUAL_STRING("4006381333931", result.text);
+    TEST_ASSERT_EQUAL(13, result.length);
+
+    // UPC-A is reported without the EAN-13 leading zero
+    TEST_ASSERT_TRUE(decodeRuns(linearRuns(ean13Modules("0036000291452"), 3, 0), &result));
+    TEST_ASSERT_EQUAL(BARCODE_UPCA, result.format);
+    TEST_ASSERT_EQUAL_STRING("036000291452", result.text);
+
+    TEST_ASSERT_TRUE(decodeRuns(linearRuns(ean8Modules("96385074"), 2, 0), &result));
+    TEST_ASSERT_EQUAL(BARCODE_EAN8, result.format);
+    TEST_ASSERT_EQUAL_STRING("96385074", result.text);
+}
+
+void test_ink_spread_and_direction() {
+    // Bars a module-third too wide, as from a blotted print
+    BarcodeResult result;
+    TEST_ASSERT_TRUE(decodeRuns(linearRuns(ean13Modules("5901234123457"), 6, 2), &result));
+    TEST_ASSERT_EQUAL_STRING("5901234123457", result.text);
+
+    // Runs are read left to right only; right to left no other code matches
+    // (scanLinear reverses the line itself)
+    std::vector<uint16_t> runs = linearRuns(ean13Modules("5901234123457"), 2, 0);
+    std::vector<uint16_t> reversed(runs.rbegin(), runs.rend());
+    TEST_ASSERT_FALSE(decodeRuns(reversed, &result));
+}
+
+void test_bad_check_digit_and_missing_quiet_zone_are_rejected() {
+    BarcodeResult result;
+    TEST_ASSERT_FALSE(decodeRuns(linearRuns(ean13Modules("4006381333932"), 2, 0), &result));
+    TEST_ASSERT_FALSE(decodeRuns(linearRuns(ean8Modules("96385075"), 2, 0), &result));
+
+    std::vector<uint16_t> runs = linearRuns(ean13Modules("4006381333931"), 2, 0);
+    runs.front() = 4;
+    TEST_ASSERT_FALSE(decodeRuns(runs, &result));
+}
+
+void test_qr_modules_decode_at_each_version_and_level() {
+    BarcodeResult result;
+    std::vector<uint8_t> hello = modulesOf(QR_HELLO_V1, 21);
+    TEST_ASSERT_TRUE(BarcodeDecoder::decodeQrModules(hello.data(), 21, &result));
+    TEST_ASSERT_EQUAL_STRING("HELLO WORLD", result.text);
+    TEST_ASSERT_EQUAL(11, result.length);
+    TEST_ASSERT_EQUAL(1, result.version);
+    TEST_ASSERT_EQUAL('M', result.eccLevel);
+    TEST_ASSERT_EQUAL(0, result.correctedErrors);
+
+    std::vector<uint8_t> url = modulesOf(QR_URL_V3, 29);
+    TEST_ASSERT_TRUE(BarcodeDecoder::decodeQrModules(url.data(), 29, &result));
+    TEST_ASSERT_EQUAL_STRING("https://example.com/p?id=42", result.text);
+    TEST_ASSERT_EQUAL('Q', result.eccLevel);
+
+    std::vector<uint8_t> digits = modulesOf(QR_DIGITS_V7, 45);
+    TEST_ASSERT_EQUAL(7, BarcodeDecoder::readQrVersion(digits.data(), 45));
+    TEST_ASSERT_TRUE(BarcodeDecoder::decodeQrModules(digits.data(), 45, &result));
+    TEST_ASSERT_EQUAL_STRING(DIGITS_120, result.text);
+    TEST_ASSERT_EQUAL('L', result.eccLevel);
+}
+
+void test_qr_errors_are_corrected_until_too_many() {
+    std::vector<uint8_t> url = modulesOf(QR_URL_V3, 29);
+    // Damage a 4x4 patch in the data area: a few codewords
+    std::vector<uint8_t> damaged(url);
+    for (int y = 12; y < 16; y++) {
+        for (int x = 18; x < 22; x++) damaged[y * 29 + x] ^= 1;
+    }
+    BarcodeResult result;
+    TEST_ASSERT_TRUE(BarcodeDecoder::decodeQrModules(damaged.data(), 29, &result));
+    TEST_ASSERT_EQUAL_STRING("https://example.com/p?id=42", result.text);
+    TEST_ASSERT_GREATER_THAN(0, result.correctedErrors);
+
+    // Half the data area inverted is beyond any level
+    for (int y = 9; y < 29; y++) {
+        for (int x = 9; x < 20; x++) damaged[y * 29 + x] ^= 1;
+    }
+    TEST_ASSERT_FALSE(BarcodeDecoder::decodeQrModules(damaged.data(), 29, &result));
+}
+
+void test_qr_found_in_an_unevenly_lit_image() {
+    const int width = 240, height = 200;
+    std::vector<uint8_t> gray = page(width, height);
+    drawQr(gray, width, modulesOf(QR_URL_V3, 29), 29, 60, 40, 4, 0);
+    BarcodeDecoder decoder;
+    BarcodeResult result;
+    TEST_ASSERT_TRUE(decoder.decode(gray.data(), width, height, width, &result));
+    TEST_ASSERT_EQUAL(BARCODE_QR, result.format);
+    TEST_ASSERT_EQUAL_STRING("https://example.com/p?id=42", result.text);
+    TEST_ASSERT_INT_WITHIN(4, 60 + 58, result.x);
+    TEST_ASSERT_INT_WITHIN(4, 40 + 58, result.y);
+
+    // Turned a little in the hand
+    gray = page(width, height);
+    drawQr(gray, width, modulesOf(QR_HELLO_V1, 21), 21, 70, 50, 5, 12);
+    TEST_ASSERT_TRUE(decoder.decode(gray.data(), width, height, width, &result));
+    TEST_ASSERT_EQUAL_STRING("HELLO WORLD", result.text);
+    TEST_ASSERT_EQUAL(2, decoder.getStats().qrCodes);
+}
+
+void test_ean13_found_in_an_image_upside_down() {
+    const int width = 320, height = 120;
+    std::string bits = ean13Modules("4006381333931");
+    std::vector<uint8_t> gray = page(width, height);
+    // Drawn mirrored, as read from a pack held upside down
+    for (int y = 20; y < 100; y++) {
+        for (int m = 0; m < (int)bits.size(); m++) {
+            if (bits[bits.size() - 1 - m] != '1') continue;
+            for (int x = 60 + 2 * m; x < 62 + 2 * m; x++) gray[y * width + x] = 30;
+        }
+    }
+    BarcodeDecoder decoder;
+    BarcodeResult result;
+    TEST_ASSERT_TRUE(decoder.decode(gray.data(), width, height, width, &result));
+    TEST_ASSERT_EQUAL(BARCODE_EAN13, result.format);
+    TEST_ASSERT_EQUAL_STRING("4006381333931", result.text);
+    TEST_ASSERT_INT_WITHIN(3, 60 + 95, result.x);
+    TEST_ASSERT_EQUAL(1, decoder.getStats().linearCodes);
+}
+
+void test_nothing_found_in_clutter() {
+    // Blank page, random blobs and stripes that are neither finders nor EAN runs, a street
+    const int width = 160, height = 120;
+    std::vector<uint8_t> gray = page(width, height);
+    BarcodeDecoder decoder;
+    BarcodeResult result;
+    TEST_ASSERT_FALSE(decoder.decode(gray.data(), width, height, width, &result));
+    TEST_ASSERT_EQUAL(BARCODE_NONE, result.format);
+
+    srand(3);
+    for (int blob = 0; blob < 40; blob++) {
+        int left = rand() % (width - 12), top = rand() % (height - 12), side = 2 + rand() % 10;
+        for (int y = top; y < top + side; y++) {
+            for (int x = left; x < left + side; x++) gray[y * width + x] = 30;
+        }
+    }
+    for (int x = 0; x < width; x++) {
+        if (x % 7 < 3) gray[100 * width + x] = gray[101 * width + x] = 30;
+    }
+    TEST_ASSERT_FALSE(decoder.decode(gray.data(), width, height, width, &result));
+    TEST_ASSERT_FALSE(decoder.decodeJpeg(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &result));
+    decoder.releaseBuffers();
+    TEST_ASSERT_EQUAL(3, decoder.getStats().scans);
+    TEST_ASSERT_EQUAL(0, decoder.getStats().qrCodes + decoder.getStats().linearCodes);
+}
+
+// ===================
+// Benchmark: generated corpus of codes in cluttered 800x600 JPEGs
+// ===================
+
+// Encoder in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize);
+
+// Byte-mode QR encoder for versions 1-10, after ISO/IEC 18004. Per level L, M, Q, H:
+// ECC codewords per block, then blocks and data codewords of the two block groups
+static const uint8_t QR_ENCODE_BLOCKS[10][4][5] = {
+    { { 7, 1, 19, 0, 0 }, { 10, 1, 16, 0, 0 }, { 13, 1, 13, 0, 0 }, { 17, 1, 9, 0, 0 } },
+    { { 10, 1, 34, 0, 0 }, { 16, 1, 28, 0, 0 }, { 22, 1, 22, 0, 0 }, { 28, 1, 16, 0, 0 } },
+    { { 15, 1, 55, 0, 0 }, { 26, 1, 44, 0, 0 }, { 18, 2, 17, 0, 0 }, { 22, 2, 13, 0, 0 } },
+    { { 20, 1, 80, 0, 0 }, { 18, 2, 32, 0, 0 }, { 26, 2, 24, 0, 0 }, { 16, 4, 9, 0, 0 } },
+    { { 26, 1, 108, 0, 0 }, { 24, 2, 43, 0, 0 }, { 18, 2, 15, 2, 16 }, { 22, 2, 11, 2, 12 } },
+    { { 18, 2, 68, 0, 0 }, { 16, 4, 27, 0, 0 }, { 24, 4, 19, 0, 0 }, { 28, 4, 15, 0, 0 } },
+    { { 20, 2, 78, 0, 0 }, { 18, 4, 31, 0, 0 }, { 18, 2, 14, 4, 15 }, { 26, 4, 13, 1, 14 } },
+    { { 24, 2, 97, 0, 0 }, { 22, 2, 38, 2, 39 }, { 22, 4, 18, 2, 19 }, { 26, 4, 14, 2, 15 } },
+    { { 30, 2, 116, 0, 0 }, { 22, 3, 36, 2, 37 }, { 20, 4, 16, 4, 17 }, { 24, 4, 12, 4, 13 } },
+    { { 18, 2, 68, 2, 69 }, { 26, 4, 43, 1, 44 }, { 24, 6, 19, 2, 20 }, { 28, 6, 15, 2, 16 } }
+};
+static const uint8_t QR_ENCODE_ALIGNMENT[10][3] = {
+    { 0 }, { 6, 18 }, { 6, 22 }, { 6, 26 }, { 6, 30 }, { 6, 34 }, { 6, 22, 38 }, { 6, 24, 42 }, { 6, 26, 46 }, { 6, 28, 50 }
+};
+static const char QR_LEVELS[4] = { 'L', 'M', 'Q', 'H' };
+static const uint8_t QR_LEVEL_BITS[4] = { 1, 0, 3, 2 };
+
+static int qrDataCodewords(int version, int level) {
+    const uint8_t* b = QR_ENCODE_BLOCKS[version - 1][level];
+    return b[1] * b[2] + b[3] * b[4];
+}
+
+static uint8_t gfMultiply(uint8_t a, uint8_t b) {
+    int product = 0;
+    for (int i = 7; i >= 0; i--) {
+        product = (product << 1) ^ ((product >> 7) * 0x11D);
+        if ((b >> i) & 1) product ^= a;
+    }
+    return product;
+}
+
+static std::vector<uint8_t> reedSolomon(const std::vector<uint8_t>& data, int degree) {
+    std::vector<uint8_t> divisor(degree, 0);
+    divisor[degree - 1] = 1;
+    uint8_t root = 1;
+    for (int i = 0; i < degree; i++) {
+        for (int j = 0; j < degree; j++) {
+            divisor[j] = gfMultiply(divisor[j], root);
+            if (j + 1 < degree) divisor[j] ^= divisor[j + 1];
+        }
+        root = gfMultiply(root, 0x02);
+    }
+    std::vector<uint8_t> remainder(degree, 0);
+    for (uint8_t byte : data) {
+        uint8_t factor = byte ^ remainder[0];
+        remainder.erase(remainder.begin());
+        remainder.push_back(0);
+        for (int j = 0; j < degree; j++) remainder[j] ^= gfMultiply(divisor[j], factor);
+    }
+    return remainder;
+}
+
+static std::vector<uint8_t> qrEncode(const std::string& text, int version, int level, int mask) {
+    const int size = 17 + 4 * version;
+    std::vector<uint8_t> modules(size * size, 0), function(size * size, 0);
+    auto set = [&](int x, int y, bool dark) {
+        modules[y * size + x] = dark;
+        function[y * size + x] = 1;
+    };
+
+    // Finders with separators, timing lines, alignment patterns
+    const int corners[3][2] = { { 3, 3 }, { size - 4, 3 }, { 3, size - 4 } };
+    for (const auto& c : corners) {
+        for (int dy = -4; dy <= 4; dy++) {
+            for (int dx = -4; dx <= 4; dx++) {
+                int x = c[0] + dx, y = c[1] + dy, ring = max(abs(dx), abs(dy));
+                if (x >= 0 && y >= 0 && x < size && y < size) set(x, y, ring != 2 && ring != 4);
+            }
+        }
+    }
+    for (int i = 8; i < size - 8; i++) {
+        set(6, i, i % 2 == 0);
+        set(i, 6, i % 2 == 0);
+    }
+    for (int cy : QR_ENCODE_ALIGNMENT[version - 1]) {
+        for (int cx : QR_ENCODE_ALIGNMENT[version - 1]) {
+            if (!cx || !cy || (cx == 6 && cy == 6) || (cx == 6 && cy == size - 7) || (cx == size - 7 && cy == 6)) continue;
+            for (int dy = -2; dy <= 2; dy++) {
+                for (int dx = -2; dx <= 2; dx++) set(cx + dx, cy + dy, max(abs(dx), abs(dy)) != 1);
+            }
+        }
+    }
+
+    // Format information around the finders, version information from 7 up
+    int format = QR_LEVEL_BITS[level] << 3 | mask, remainder = format;
+    for (int i = 0; i < 10; i++) remainder = (remainder << 1) ^ ((remainder >> 9) * 0x537);
+    int formatBits = (format << 10 | remainder) ^ 0x5412;
+    auto bit = [](int value, int i) { return ((value >> i) & 1) != 0; };
+    for (int i = 0; i < 6; i++) set(8, i, bit(formatBits, i));
+    set(8, 7, bit(formatBits, 6));
+    set(8, 8, bit(formatBits, 7));
+    set(7, 8, bit(formatBits, 8));
+    for (int i = 9; i < 15; i++) set(14 - i, 8, bit(formatBits, i));
+    for (int i = 0; i < 8; i++) set(size - 1 - i, 8, bit(formatBits, i));
+    for (int i = 8; i < 15; i++) set(8, size - 15 + i, bit(formatBits, i));
+    set(8, size - 8, true);
+    if (version >= 7) {
+        int versionRemainder = version;
+        for (int i = 0; i < 12; i++) versionRemainder = (versionRemainder << 1) ^ ((versionRemainder >> 11) * 0x1F25);
+        int versionBits = version << 12 | versionRemainder;
+        for (int i = 0; i < 18; i++) {
+            set(size - 11 + i % 3, i / 3, bit(versionBits, i));
+            set(i / 3, size - 11 + i % 3, bit(versionBits, i));
+        }
+    }
+
+    // Byte mode segment, terminator and pad codewords
+    const uint8_t* blocks = QR_ENCODE_BLOCKS[version - 1][level];
+    int dataCodewords = qrDataCodewords(version, level);
+    std::vector<bool> bits;
+    auto append = [&bits](int value, int length) {
+        for (int i = length - 1; i >= 0; i--) bits.push_back((value >> i) & 1);
+    };
+    append(4, 4);
+    append(text.size(), version < 10 ? 8 : 16);
+    for (unsigned char c : text) append(c, 8);
+    append(0, min(4, dataCodewords * 8 - (int)bits.size()));
+    while (bits.size() % 8) bits.push_back(false);
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < bits.size(); i += 8) {
+        int byte = 0;
+        for (int j = 0; j < 8; j++) byte = byte << 1 | bits[i + j];
+        data.push_back(byte);
+    }
+    for (int pad = 0; (int)data.size() < dataCodewords; pad++) data.push_back(pad % 2 ? 0x11 : 0xEC);
+
+    // Blocks with their ECC, interleaved
+    std::vector<std::vector<uint8_t>> dataBlocks, eccBlocks;
+    size_t offset = 0;
+    for (int group = 0; group < 2; group++) {
+        for (int b = 0; b < blocks[1 + 2 * group]; b++) {
+            std::vector<uint8_t> block(data.begin() + offset, data.begin() + offset + blocks[2 + 2 * group]);
+            offset += block.size();
+            eccBlocks.push_back(reedSolomon(block, blocks[0]));
+            dataBlocks.push_back(block);
+        }
+    }
+    std::vector<uint8_t> codewords;
+    for (size_t i = 0; i < dataBlocks.back().size(); i++) {
+        for (const auto& block : dataBlocks) {
+            if (i < block.size()) codewords.push_back(block[i]);
+        }
+    }
+    for (int i = 0; i < blocks[0]; i++) {
+        for (const auto& block : eccBlocks) codewords.push_back(block[i]);
+    }
+
+    // Zigzag placement in column pairs from the bottom right, masked
+    size_t index = 0;
+    for (int right = size - 1; right >= 1; right -= 2) {
+        if (right == 6) right = 5;
+        for (int vertical = 0; vertical < size; vertical++) {
+            for (int j = 0; j < 2; j++) {
+                int x = right - j;
+                int y = ((right + 1) & 2) == 0 ? size - 1 - vertical : vertical;
+                if (function[y * size + x]) continue;
+                bool dark = index < codewords.size() * 8 && ((codewords[index >> 3] >> (7 - (index & 7))) & 1);
+                index++;
+                bool invert;
+                switch (mask) {
+                    case 0: invert = (x + y) % 2 == 0; break;
+                    case 1: invert = y % 2 == 0; break;
+                    case 2: invert = x % 3 == 0; break;
+                    case 3: invert = (x + y) % 3 == 0; break;
+                    case 4: invert = (x / 3 + y / 2) % 2 == 0; break;
+                    case 5: invert = x * y % 2 + x * y % 3 == 0; break;
+                    case 6: invert = (x * y % 2 + x * y % 3) % 2 == 0; break;
+                    default: invert = ((x + y) % 2 + x * y % 3) % 2 == 0; break;
+                }
+                modules[y * size + x] = dark != invert;
+            }
+        }
+    }
+    return modules;
+}
+
+static const int CORPUS_WIDTH = 800;
+static const int CORPUS_HEIGHT = 600;
+
+// Cluttered grey scene with a light gradient, blurred and noised like a camera frame
+class CorpusImage {
+public:
+    std::vector<float> gray;
+    std::mt19937& rng;
+
+    explicit CorpusImage(std::mt19937& random) : gray(CORPUS_WIDTH * CORPUS_HEIGHT), rng(random) {
+        float base = uniform(90, 170);
+        for (int i = 0; i < CORPUS_WIDTH * CORPUS_HEIGHT; i++) gray[i] = base;
+        int shapes = 20 + rng() % 30;
+        for (int s = 0; s < shapes; s++) {
+            int x0 = rng() % CORPUS_WIDTH, y0 = rng() % CORPUS_HEIGHT;
+            int w = 10 + rng() % 200, h = 10 + rng() % 200;
+            float shade = uniform(20, 235);
+            bool striped = rng() % 4 == 0;
+            int period = 3 + rng() % 12;
+            for (int y = y0; y < min(CORPUS_HEIGHT, y0 + h); y++) {
+                for (int x = x0; x < min(CORPUS_WIDTH, x0 + w); x++) {
+                    if (!striped || (x / period) % 2) gray[y * CORPUS_WIDTH + x] = shade;
+                }
+            }
+        }
+    }
+
+    float uniform(float low, float high) { return low + (high - low) * (rng() % 10000) / 10000.0f; }
+
+    // Label of `columns` x `rows` modules (quiet zone included) drawn through a
+    // perspective quad: rotated by `degrees`, each corner pushed up to `tilt` of the side
+    void label(const std::vector<uint8_t>& modules, int columns, int rows, int quiet, float moduleSize, float degrees,
+               float tilt, float centreX, float centreY) {
+        float halfWidth = (columns + 2 * quiet) * moduleSize / 2, halfHeight = (rows + 2 * quiet) * moduleSize / 2;
+        float c = cosf(degrees * (float)M_PI / 180), s = sinf(degrees * (float)M_PI / 180);
+        float corners[4][2];
+        const float signs[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+        for (int k = 0; k < 4; k++) {
+            float px = signs[k][0] * halfWidth + uniform(-tilt, tilt) * 2 * halfWidth;
+            float py = signs[k][1] * halfHeight + uniform(-tilt, tilt) * 2 * halfHeight;
+            corners[k][0] = centreX + c * px - s * py;
+            corners[k][1] = centreY + s * px + c * py;
+        }
+        // Homography from the unit square to the quad (Heckbert), inverted through its adjugate
+        float dx1 = corners[1][0] - corners[2][0], dx2 = corners[3][0] - corners[2][0];
+        float dx3 = corners[0][0] - corners[1][0] + corners[2][0] - corners[3][0];
+        float dy1 = corners[1][1] - corners[2][1], dy2 = corners[3][1] - corners[2][1];
+        float dy3 = corners[0][1] - corners[1][1] + corners[2][1] - corners[3][1];
+        float denominator = dx1 * dy2 - dx2 * dy1;
+        float g = (dx3 * dy2 - dx2 * dy3) / denominator, h = (dx1 * dy3 - dx3 * dy1) / denominator;
+        float a = corners[1][0] - corners[0][0] + g * corners[1][0], b = corners[3][0] - corners[0][0] + h * corners[3][0];
+        float d = corners[1][1] - corners[0][1] + g * corners[1][1], e = corners[3][1] - corners[0][1] + h * corners[3][1];
+        float c0 = corners[0][0], f = corners[0][1];
+        const float inverse[3][3] = {
+            { e - f * h, c0 * h - b, b * f - c0 * e },
+            { f * g - d, a - c0 * g, c0 * d - a * f },
+            { d * h - e * g, b * g - a * h, a * e - b * d }
+        };
+        float minX = CORPUS_WIDTH, minY = CORPUS_HEIGHT, maxX = 0, maxY = 0;
+        for (const auto& corner : corners) {
+            minX = min(minX, corner[0]);
+            minY = min(minY, corner[1]);
+            maxX = max(maxX, corner[0]);
+            maxY = max(maxY, corner[1]);
+        }
+        float paper = uniform(190, 240), ink = uniform(15, 60);
+        int totalColumns = columns + 2 * quiet, totalRows = rows + 2 * quiet;
+        for (int y = max(0, (int)minY); y < min(CORPUS_HEIGHT, (int)maxY + 1); y++) {
+            for (int x = max(0, (int)minX); x < min(CORPUS_WIDTH, (int)maxX + 1); x++) {
+                float w = inverse[2][0] * x + inverse[2][1] * y + inverse[2][2];
+                float u = (inverse[0][0] * x + inverse[0][1] * y + inverse[0][2]) / w;
+                float v = (inverse[1][0] * x + inverse[1][1] * y + inverse[1][2]) / w;
+                if (u < 0 || v < 0 || u >= 1 || v >= 1) continue;
+                int column = (int)(u * totalColumns) - quiet, row = (int)(v * totalRows) - quiet;
+                bool dark = column >= 0 && row >= 0 && column < columns && row < rows && modules[row * columns + column];
+                gray[y * CORPUS_WIDTH + x] = dark ? ink : paper;
+            }
+        }
+    }
+
+    // Light falling off across the frame, 3x3 blur, sensor noise, then JPEG at quality 80
+    std::vector<uint8_t> encode() {
+        float fromX = uniform(0, CORPUS_WIDTH), fromY = uniform(0, CORPUS_HEIGHT), falloff = uniform(0.2f, 0.45f);
+        std::vector<uint8_t> rgb(CORPUS_WIDTH * CORPUS_HEIGHT * 3);
+        for (int y = 0; y < CORPUS_HEIGHT; y++) {
+            for (int x = 0; x < CORPUS_WIDTH; x++) {
+                float sum = 0;
+                int count = 0;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        int sx = x + dx, sy = y + dy;
+                        if (sx < 0 || sy < 0 || sx >= CORPUS_WIDTH || sy >= CORPUS_HEIGHT) continue;
+                        sum += gray[sy * CORPUS_WIDTH + sx];
+                        count++;
+                    }
+                }
+                float distance = hypotf(x - fromX, y - fromY) / CORPUS_WIDTH;
+                int value = constrain((int)(sum / count * (1 - falloff * distance) + uniform(-6, 6)), 0, 255);
+                rgb[(y * CORPUS_WIDTH + x) * 3] = rgb[(y * CORPUS_WIDTH + x) * 3 + 1] = rgb[(y * CORPUS_WIDTH + x) * 3 + 2] = value;
+            }
+        }
+        uint8_t* jpeg = nullptr;
+        size_t size = 0;
+        TEST_ASSERT_TRUE(libjpegEncodeRgb(rgb.data(), CORPUS_WIDTH, CORPUS_HEIGHT, 80, &jpeg, &size));
+        std::vector<uint8_t> out(jpeg, jpeg + size);
+        free(jpeg);
+        return out;
+    }
+};
+
+// EAN/UPC bar pattern as a module grid `rows` high
+static std::vector<uint8_t> barModules(const std::string& bits, int rows) {
+    std::vector<uint8_t> modules(bits.size() * rows);
+    for (size_t i = 0; i < modules.size(); i++) modules[i] = bits[i % bits.size()] == '1';
+    return modules;
+}
+
+static std::string withCheckDigit(std::string digits) {
+    int sum = 0;
+    for (size_t i = 0; i < digits.size(); i++) {
+        int weight = (digits.size() - i) % 2 ? 3 : 1;
+        sum += (digits[i] - '0') * weight;
+    }
+    return digits + (char)('0' + (10 - sum % 10) % 10);
+}
+
+void test_qr_encoder_matches_the_reference_grid() {
+    // The corpus below relies on the encoder; QR_URL_V3 is level Q, mask 3
+    std::vector<uint8_t> url = qrEncode("https://example.com/p?id=42", 3, 2, 3);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(modulesOf(QR_URL_V3, 29).data(), url.data(), 29 * 29);
+
+    // Every version, level and mask the corpus uses reads back from the grid
+    BarcodeResult result;
+    for (int version = 1; version <= 10; version++) {
+        for (int level = 0; level < 4; level++) {
+            std::string text(qrDataCodewords(version, level) - 3, 'a' + version);
+            std::vector<uint8_t> modules = qrEncode(text, version, level, (version + level) % 8);
+            TEST_ASSERT_TRUE(BarcodeDecoder::decodeQrModules(modules.data(), 17 + 4 * version, &result));
+            TEST_ASSERT_EQUAL_STRING(text.c_str(), result.text);
+            TEST_ASSERT_EQUAL(version, result.version);
+            TEST_ASSERT_EQUAL(QR_LEVELS[level], result.eccLevel);
+        }
+    }
+}
+
+// Prints per-format decode rates, false positives and decode time (JPEG luma
+// decode included) over 150 QR codes at versions 1-10, 43 EAN-13, 38 EAN-8 and
+// 39 UPC-A rotated and tilted on clutter, plus 80 images with no code
+void test_benchmark_generated_corpus() {
+    enum { QR, EAN13, EAN8, UPCA, NEGATIVE };
+    const char* NAMES[5] = { "QR (v1-10)", "EAN-13", "EAN-8", "UPC-A", "negatives" };
+    const int COUNTS[5] = { 150, 43, 38, 39, 80 };
+    int decoded[5] = { 0 }, wrong = 0;
+    std::vector<double> millis;
+    std::mt19937 rng(37);
+    BarcodeDecoder decoder;
+
+    for (int kind = QR; kind <= NEGATIVE; kind++) {
+        for (int n = 0; n < COUNTS[kind]; n++) {
+            CorpusImage image(rng);
+            std::string expected;
+            float centreX = image.uniform(300, 500), centreY = image.uniform(220, 380);
+            if (kind == QR) {
+                int version = 1 + n % 10, level = rng() % 4;
+                int length = image.uniform(qrDataCodewords(version, level) / 3, qrDataCodewords(version, level) - 3);
+                for (int i = 0; i < length; i++) expected += (char)(' ' + rng() % 95);
+                int size = 17 + 4 * version;
+                float moduleSize = image.uniform(3, min(8.0f, 380.0f / (size + 8)));
+                image.label(qrEncode(expected, version, level, rng() % 8), size, size, 4, moduleSize,
+                            image.uniform(0, 360), 0.06f, centreX, centreY);
+            } else if (kind != NEGATIVE) {
+                std::string digits;
+                int count = kind == EAN8 ? 7 : 11;
+                if (kind == EAN13) digits += (char)('1' + rng() % 9);
+                for (int i = 0; i < count; i++) digits += (char)('0' + rng() % 10);
+                std::string code = withCheckDigit(digits);
+                std::string bits = kind == EAN8 ? ean8Modules(code.c_str()) : ean13Modules(kind == UPCA ? ("0" + code).c_str() : code.c_str());
+                expected = code;
+                float moduleSize = image.uniform(2, 4.5f);
+                image.label(barModules(bits, bits.size() * 2 / 3), bits.size(), bits.size() * 2 / 3, 10, moduleSize,
+                            image.uniform(-20, 20) + (rng() % 2) * 180, 0.04f, centreX, centreY);
+            }
+            std::vector<uint8_t> jpeg = image.encode();
+
+            BarcodeResult result;
+            auto start = std::chrono::steady_clock::now();
+            bool found = decoder.decodeJpeg(jpeg.data(), jpeg.size(), &result);
+            millis.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (!found) continue;
+            if (kind != NEGATIVE && expected == std::string(result.text, result.length)) decoded[kind]++;
+            else if (kind == NEGATIVE) decoded[kind]++;
+            else wrong++;
+        }
+    }
+    decoder.releaseBuffers();
+
+    char line[160];
+    for (int kind = QR; kind < NEGATIVE; kind++) {
+        snprintf(line, sizeof(line), "%-12s %3d/%d", NAMES[kind], decoded[kind], COUNTS[kind]);
+        TEST_MESSAGE(line);
+    }
+    snprintf(line, sizeof(line), "%-12s %3d/%d false positives; %d wrong decodes", NAMES[NEGATIVE], decoded[NEGATIVE],
+             COUNTS[NEGATIVE], wrong);
+    TEST_MESSAGE(line);
+    std::sort(millis.begin(), millis.end());
+    snprintf(line, sizeof(line), "decodeJpeg median %.1f ms, max %.1f ms", millis[millis.size() / 2], millis.back());
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ean13_upca_and_ean8_from_runs);
+    RUN_TEST(test_ink_spread_and_direction);
+    RUN_TEST(test_bad_check_digit_and_missing_quiet_zone_are_rejected);
+    RUN_TEST(test_qr_modules_decode_at_each_version_and_level);
+    RUN_TEST(test_qr_errors_are_corrected_until_too_many);
+    RUN_TEST(test_qr_found_in_an_unevenly_lit_image);
+    RUN_TEST(test_ean13_found_in_an_image_upside_down);
+    RUN_TEST(test_nothing_found_in_clutter);
+    RUN_TEST(test_qr_encoder_matches_the_reference_grid);
+    RUN_TEST(test_benchmark_generated_corpus);
+    return UNITY_END();
+}
@@ -0,0 +1,283 @@
+#include <unity.h>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "capture_pipeline.cpp"
+#include "host_runtime.h"
+
+// ===================
+// Collaborator stand-ins: a camera stamping a counter into each frame and an
+// upload path whose token and result the test controls
+// ===================
+
+struct UploadCall {
+    uint8_t frameId;          // First byte of the uploaded frame
+    RequestPriority priority;
+};
+
+static std::mutex fakeLock;
+static std::atomic<int> captureDelay(0);    // ms per stage
+static std::atomic<int> encodeDelay(0);
+static std::atomic<int> uploadDelay(0);
+static std::atomic<bool> tokensOpen(true);
+static std::atomic<int> capturedFrames(0);
+static std::atomic<int> encodesStarted(0);
+static std::atomic<RequestPriority> lastTokenAsked(PRIORITY_AUTO);
+static std::vector<UploadCall> uploads;
+static std::deque<AdmissionDecision> scriptedAdmissions; // ADMITTED entries fail the upload
+static AdmissionDecision lastDecision = ADMISSION_ADMITTED;
+
+CameraManager::CameraManager() {}
+
+bool CameraManager::captureToBuffer(uint8_t** imageData, size_t* imageSize) {
+    delay(captureDelay);
+    *imageSize = 64;
+    *imageData = (uint8_t*)malloc(*imageSize);
+    memset(*imageData, 0, *imageSize);
+    (*imageData)[0] = (uint8_t)capturedFrames++;
+    return true;
+}
+
+FramePyramid* CameraManager::acquireCapturedPyramid() { return nullptr; }
+void CameraManager::releasePyramid(FramePyramid*) {}
+
+GSMModule::GSMModule() {}
+GSMModule::~GSMModule() {}
+bool GSMModule::optimizeImageForUpload(uint8_t**, size_t*) { return true; }
+
+String GSMModule::encodeImageToBase64(uint8_t* imageData, size_t imageSize) {
+    encodesStarted++;
+    delay(encodeDelay);
+    return String("frame");
+}
+
+AIProcessor::AIProcessor() {}
+OperationMode AIProcessor::getOperationMode() { return MODE_HAZARD_DETECTION; }
+bool AIProcessor::uploadsFrame(OperationMode, bool) { return true; }
+bool AIProcessor::getProcessingStatus() { return false; }
+
+bool AIProcessor::canAcceptImage(RequestPriority priority) {
+    lastTokenAsked = priority;
+    return tokensOpen;
+}
+
+bool AIProcessor::processImage(uint8_t* imageData, size_t imageSize, FramePyramid* pyramid,
+                               RequestPriority priority, const String* encodedImage) {
+    std::lock_guard<std::mutex> guard(fakeLock);
+    bool success = true;
+    lastDecision = ADMISSION_ADMITTED;
+    if (!scriptedAdmissions.empty()) {
+        lastDecision = scriptedAdmissions.front();
+        scriptedAdmissions.pop_front();
+        success = false;
+    }
+    if (lastDecision == ADMISSION_ADMITTED) {
+        uploads.push_back({ imageData[0], priority });
+        delay(uploadDelay);
+    }
+    return success;
+}
+
+AdmissionDecision AIProcessor::getLastAdmission() {
+    std::lock_guard<std::mutex> guard(fakeLock);
+    return lastDecision;
+}
+
+CameraManager cameraManager;
+GSMModule gsmModule;
+AIProcessor aiProcessor;
+
+// ===================
+// Helpers
+// ===================
+
+static bool waitFor(std::function<bool()> condition, unsigned long timeoutMs = 2000) {
+    unsigned long start = millis();
+    while (!condition()) {
+        if (millis() - start > timeoutMs) return false;
+        delay(1);
+    }
+    return true;
+}
+
+static uint32_t uploadResults() {
+    PipelineStats stats = capturePipeline.getStats();
+    return stats.framesCompleted + stats.framesQueued + stats.framesRejected;
+}
+
+static uint32_t stageProcessed(PipelineStage stage) {
+    return capturePipeline.getStats().stages[stage].processed;
+}
+
+static std::vector<UploadCall> recordedUploads() {
+    std::lock_guard<std::mutex> guard(fakeLock);
+    return uploads;
+}
+
+void setUp() {
+    captureDelay = 2;
+    encodeDelay = 2;
+    uploadDelay = 20;
+    tokensOpen = true;
+    capturedFrames = 0;
+    encodesStarted = 0;
+    lastTokenAsked = PRIORITY_AUTO;
+    uploads.clear();
+    scriptedAdmissions.clear();
+    lastDecision = ADMISSION_ADMITTED;
+    TEST_ASSERT_TRUE(capturePipeline.begin());
+}
+
+void tearDown() {
+    capturePipeline.end();
+}
+
+// ===================
+// Tests
+// ===================
+
+void test_request_before_begin_is_refused() {
+    capturePipeline.end();
+    TEST_ASSERT_FALSE(capturePipeline.requestCapture(PRIORITY_MANUAL));
+    TEST_ASSERT_TRUE(capturePipeline.isIdle());
+}
+
+void test_frames_pass_through_every_stage() {
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+        TEST_ASSERT_TRUE(waitFor([i] { return uploadResults() == (uint32_t)i + 1; }));
+    }
+    TEST_ASSERT_TRUE(waitFor([] { return capturePipeline.isIdle(); }));
+
+    PipelineStats stats = capturePipeline.getStats();
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(3, stats.stages[i].processed);
+        TEST_ASSERT_EQUAL_UINT32(0, stats.stages[i].dropped);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, stats.framesCompleted);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.framesSucceeded);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.framesQueued);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.framesRejected);
+    TEST_ASSERT_TRUE(stats.totalLatency >= 3 * 20);
+    TEST_ASSERT_TRUE(stats.stages[STAGE_UPLOAD].busyMicros >= 3 * 20000);
+    TEST_ASSERT_TRUE(capturePipeline.getThroughput() > 0);
+    TEST_ASSERT_TRUE(capturePipeline.getStageOccupancy(STAGE_UPLOAD) > 0);
+
+    std::vector<UploadCall> calls = recordedUploads();
+    TEST_ASSERT_EQUAL(3, (int)calls.size());
+    for (int i = 0; i < 3; i++) TEST_ASSERT_EQUAL_UINT8(i, calls[i].frameId);
+}
+
+void test_slow_encode_keeps_only_the_newest_capture() {
+    encodeDelay = 150;
+
+    // Frame 0 occupies the encoder; frames 1-3 meet a full queue of depth one
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+    TEST_ASSERT_TRUE(waitFor([] { return encodesStarted == 1; }));
+    for (int i = 1; i <= 3; i++) {
+        TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+        TEST_ASSERT_TRUE(waitFor([i] { return stageProcessed(STAGE_CAPTURE) == (uint32_t)i + 1; }));
+    }
+    TEST_ASSERT_TRUE(waitFor([] { return uploadResults() == 2; }));
+
+    PipelineStats stats = capturePipeline.getStats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.stages[STAGE_CAPTURE].processed);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.stages[STAGE_ENCODE].dropped);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.stages[STAGE_ENCODE].processed);
+
+    std::vector<UploadCall> calls = recordedUploads();
+    TEST_ASSERT_EQUAL(2, (int)calls.size());
+    TEST_ASSERT_EQUAL_UINT8(0, calls[0].frameId);
+    TEST_ASSERT_EQUAL_UINT8(3, calls[1].frameId);
+}
+
+void test_upload_waiting_for_a_token_swaps_in_newer_frames() {
+    tokensOpen = false;
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+        TEST_ASSERT_TRUE(waitFor([i] { return stageProcessed(STAGE_ENCODE) == (uint32_t)i + 1; }));
+    }
+    // Every stale frame is gone before the token arrives
+    TEST_ASSERT_TRUE(waitFor([] { return capturePipeline.getStats().stages[STAGE_UPLOAD].dropped == 3; }));
+    TEST_ASSERT_EQUAL_UINT32(0, uploadResults());
+
+    tokensOpen = true;
+    TEST_ASSERT_TRUE(waitFor([] { return uploadResults() == 1; }));
+    TEST_ASSERT_TRUE(waitFor([] { return capturePipeline.isIdle(); }));
+
+    std::vector<UploadCall> calls = recordedUploads();
+    TEST_ASSERT_EQUAL(1, (int)calls.size());
+    TEST_ASSERT_EQUAL_UINT8(3, calls[0].frameId);
+    TEST_ASSERT_EQUAL_UINT32(1, capturePipeline.getStats().framesCompleted);
+}
+
+void test_replacement_frame_inherits_the_more_urgent_class() {
+    tokensOpen = false;
+
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_MANUAL));
+    TEST_ASSERT_TRUE(waitFor([] { return stageProcessed(STAGE_ENCODE) == 1; }));
+    TEST_ASSERT_TRUE(waitFor([] { return lastTokenAsked == PRIORITY_MANUAL; }));
+
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+    TEST_ASSERT_TRUE(waitFor([] { return capturePipeline.getStats().stages[STAGE_UPLOAD].dropped == 1; }));
+
+    // The newer auto frame now waits for a manual token and uploads as manual
+    delay(50);
+    TEST_ASSERT_EQUAL(PRIORITY_MANUAL, (RequestPriority)lastTokenAsked);
+    tokensOpen = true;
+    TEST_ASSERT_TRUE(waitFor([] { return uploadResults() == 1; }));
+
+    std::vector<UploadCall> calls = recordedUploads();
+    TEST_ASSERT_EQUAL(1, (int)calls.size());
+    TEST_ASSERT_EQUAL_UINT8(1, calls[0].frameId);
+    TEST_ASSERT_EQUAL(PRIORITY_MANUAL, calls[0].priority);
+}
+
+void test_auto_request_does_not_downgrade_a_pending_manual_one() {
+    captureDelay = 100;
+
+    // Frame 0 holds the camera while a manual and then an auto request arrive
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+    TEST_ASSERT_TRUE(waitFor([] { return capturedFrames == 1; }));
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_MANUAL));
+    TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+    TEST_ASSERT_TRUE(waitFor([] { return uploadResults() == 2; }));
+
+    std::vector<UploadCall> calls = recordedUploads();
+    TEST_ASSERT_EQUAL(2, (int)calls.size());
+    TEST_ASSERT_EQUAL(PRIORITY_AUTO, calls[0].priority);
+    TEST_ASSERT_EQUAL(PRIORITY_MANUAL, calls[1].priority);
+    TEST_ASSERT_EQUAL_UINT32(2, stageProcessed(STAGE_CAPTURE));
+}
+
+void test_queued_and_rejected_frames_are_not_results() {
+    scriptedAdmissions = { ADMISSION_QUEUED, ADMISSION_REJECTED, ADMISSION_ADMITTED };
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(capturePipeline.requestCapture(PRIORITY_AUTO));
+        TEST_ASSERT_TRUE(waitFor([i] { return uploadResults() == (uint32_t)i + 1; }));
+    }
+
+    PipelineStats stats = capturePipeline.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesQueued);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesRejected);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.framesCompleted);  // One network failure, one success
+    TEST_ASSERT_EQUAL_UINT32(1, stats.framesSucceeded);
+    TEST_ASSERT_EQUAL_UINT32(4, stats.stages[STAGE_UPLOAD].processed);
+    TEST_ASSERT_EQUAL(2, (int)recordedUploads().size());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_request_before_begin_is_refused);
+    RUN_TEST(test_frames_pass_through_every_stage);
+    RUN_TEST(test_slow_encode_keeps_only_the_newest_capture);
+    RUN_TEST(test_upload_waiting_for_a_token_swaps_in_newer_frames);
+    RUN_TEST(test_replacement_frame_inherits_the_more_urgent_class);
+    RUN_TEST(test_auto_request_does_not_downgrade_a_pending_manual_one);
+    RUN_TEST(test_queued_and_rejected_frames_are_not_results);
+    return UNITY_END();
+}
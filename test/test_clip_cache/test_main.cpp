@@ -0,0 +1,189 @@
+#include <unity.h>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "clip_cache.cpp"
+#include "host_runtime.h"
+
+static std::string root;
+
+static std::vector<uint8_t> clipBytes(size_t size, uint8_t seed) {
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < size; i++) data[i] = (uint8_t)(seed + i * 13);
+    return data;
+}
+
+// Misses a clip until it is admitted, then streams it in network-sized pieces
+static void missAndStore(ClipCache& cache, uint64_t key, const std::vector<uint8_t>& data) {
+    for (int i = 1; i < CLIP_CACHE_ADMIT_MISSES; i++) TEST_ASSERT_FALSE(cache.beginCapture(key, data.size()));
+    TEST_ASSERT_TRUE(cache.beginCapture(key, data.size()));
+    for (size_t i = 0; i < data.size(); i += 1460) cache.capture(data.data() + i, std::min<size_t>(1460, data.size() - i));
+    cache.endCapture(true);
+}
+
+static std::vector<uint8_t> readClip(ClipCache& cache, uint64_t key) {
+    std::vector<uint8_t> data;
+    File file;
+    if (!cache.open(key, &file)) return data;
+    data.resize(file.size());
+    data.resize(file.read(data.data(), data.size()));
+    file.close();
+    return data;
+}
+
+static int filesIn(const char* dir) {
+    fs::FS filesystem(root);
+    File directory = filesystem.open(dir);
+    int count = 0;
+    for (File file = directory.openNextFile(); file; file = directory.openNextFile()) count++;
+    return count;
+}
+
+void setUp() {
+    char path[] = "/tmp/clip_cache_XXXXXX";
+    root = mkdtemp(path);
+}
+
+void tearDown() {
+    std::filesystem::remove_all(root);
+}
+
+void test_keys_cover_text_voice_and_format() {
+    uint64_t key = ClipCache::keyFor("Area clear", "en-US-1", "mp3");
+    TEST_ASSERT_NOT_EQUAL(0, key);
+    TEST_ASSERT_EQUAL(key, ClipCache::keyFor("Area clear", "en-US-1", "MP3"));
+    TEST_ASSERT_NOT_EQUAL(key, ClipCache::keyFor("Area clear", "en-US-2", "mp3"));
+    TEST_ASSERT_NOT_EQUAL(key, ClipCache::keyFor("Area clear.", "en-US-1", "mp3"));
+    // The field separator keeps text and voice from running together
+    TEST_ASSERT_NOT_EQUAL(ClipCache::keyFor("ab", "c", "mp3"), ClipCache::keyFor("a", "bc", "mp3"));
+    TEST_ASSERT_EQUAL(0, ClipCache::keyFor("Area clear", "en-US-1", "wav"));
+    TEST_ASSERT_EQUAL(0, ClipCache::keyFor("", "en-US-1", "mp3"));
+}
+
+void test_clip_is_written_once_it_keeps_missing() {
+    fs::FS filesystem(root);
+    ClipCache cache;
+    TEST_ASSERT_TRUE(cache.begin(filesystem));
+    uint64_t key = ClipCache::keyFor("Stop sign ahead", "en-US-1", "mp3");
+    std::vector<uint8_t> clip = clipBytes(20000, 3);
+
+    File file;
+    TEST_ASSERT_FALSE(cache.open(key, &file));
+    missAndStore(cache, key, clip);
+    TEST_ASSERT_TRUE(readClip(cache, key) == clip);
+
+    ClipCacheStats stats = cache.getStats();
+    TEST_ASSERT_EQUAL(2, stats.lookups);
+    TEST_ASSERT_EQUAL(1, stats.hits);
+    TEST_ASSERT_EQUAL(1, stats.stored);
+    TEST_ASSERT_EQUAL(CLIP_CACHE_ADMIT_MISSES - 1, stats.notAdmitted);
+    TEST_ASSERT_EQUAL(clip.size(), stats.bytesSaved);
+    // The clip and its index, no temporary files left behind
+    TEST_ASSERT_EQUAL(2, filesIn(CLIP_CACHE_DIR));
+}
+
+void test_partial_and_oversized_clips_are_not_written() {
+    fs::FS filesystem(root);
+    ClipCache cache;
+    TEST_ASSERT_TRUE(cache.begin(filesystem));
+    uint64_t cut = ClipCache::keyFor("Crossing", "en-US-1", "mp3");
+    uint64_t huge = ClipCache::keyFor("A very long caption", "en-US-1", "mp3");
+    std::vector<uint8_t> clip = clipBytes(CLIP_CACHE_MAX_CLIP + 1, 5);
+
+    for (int i = 1; i < CLIP_CACHE_ADMIT_MISSES; i++) cache.beginCapture(cut, 1000);
+    TEST_ASSERT_TRUE(cache.beginCapture(cut, 1000));
+    cache.capture(clip.data(), 500);
+    cache.endCapture(false);      // Stream broke off
+
+    // Length unknown up front: dropped once it outgrows the buffer
+    for (int i = 1; i < CLIP_CACHE_ADMIT_MISSES; i++) cache.beginCapture(huge, -1);
+    TEST_ASSERT_TRUE(cache.beginCapture(huge, -1));
+    cache.capture(clip.data(), CLIP_CACHE_MAX_CLIP);
+    cache.capture(clip.data() + CLIP_CACHE_MAX_CLIP, 1);
+    cache.endCapture(true);
+    TEST_ASSERT_FALSE(cache.beginCapture(huge, clip.size()));
+
+    TEST_ASSERT_EQUAL(0, cache.getStats().stored);
+    TEST_ASSERT_TRUE(readClip(cache, cut).empty());
+    TEST_ASSERT_TRUE(readClip(cache, huge).empty());
+}
+
+void test_least_recently_used_clip_is_evicted() {
+    fs::FS filesystem(root);
+    ClipCache cache;
+    TEST_ASSERT_TRUE(cache.begin(filesystem));
+    const size_t size = 60000;
+    const int fit = CLIP_CACHE_BUDGET / size;
+    std::vector<uint64_t> keys;
+    for (int i = 0; i <= fit; i++) keys.push_back(ClipCache::keyFor(String("Sign ") + i, "en-US-1", "mp3"));
+
+    for (int i = 0; i < fit; i++) missAndStore(cache, keys[i], clipBytes(size, i));
+    // The oldest clip is heard again, so the second oldest goes
+    TEST_ASSERT_EQUAL(size, readClip(cache, keys[0]).size());
+    missAndStore(cache, keys[fit], clipBytes(size, fit));
+
+    TEST_ASSERT_EQUAL(1, cache.getStats().evicted);
+    TEST_ASSERT_TRUE(readClip(cache, keys[1]).empty());
+    TEST_ASSERT_TRUE(readClip(cache, keys[0]) == clipBytes(size, 0));
+    TEST_ASSERT_TRUE(readClip(cache, keys[fit]) == clipBytes(size, fit));
+    TEST_ASSERT_EQUAL(fit + 1, filesIn(CLIP_CACHE_DIR));
+}
+
+void test_index_survives_a_restart_and_strays_are_cleaned() {
+    fs::FS filesystem(root);
+    uint64_t kept = ClipCache::keyFor("Area clear", "en-US-1", "mp3");
+    uint64_t lost = ClipCache::keyFor("Exit", "en-US-1", "mp3");
+    {
+        ClipCache cache;
+        TEST_ASSERT_TRUE(cache.begin(filesystem));
+        missAndStore(cache, kept, clipBytes(3000, 1));
+        missAndStore(cache, lost, clipBytes(4000, 2));
+        cache.end();
+    }
+
+    // A clip file gone, and a temporary file and an unknown clip left by a power cut
+    char lostName[24];
+    snprintf(lostName, sizeof(lostName), "%016llx.mp3", (unsigned long long)lost);
+    TEST_ASSERT_TRUE(filesystem.remove(String(CLIP_CACHE_DIR) + lostName));
+    File stray = filesystem.open(String(CLIP_CACHE_DIR) + "clip.tmp", FILE_WRITE);
+    stray.write((const uint8_t*)"half", 4);
+    stray.close();
+    stray = filesystem.open(String(CLIP_CACHE_DIR) + "00000000000000ab.mp3", FILE_WRITE);
+    stray.close();
+
+    ClipCache cache;
+    TEST_ASSERT_TRUE(cache.begin(filesystem));
+    TEST_ASSERT_TRUE(readClip(cache, kept) == clipBytes(3000, 1));
+    TEST_ASSERT_TRUE(readClip(cache, lost).empty());
+    TEST_ASSERT_EQUAL(2, filesIn(CLIP_CACHE_DIR));
+}
+
+void test_corrupt_index_starts_empty() {
+    fs::FS filesystem(root);
+    uint64_t key = ClipCache::keyFor("Area clear", "en-US-1", "mp3");
+    {
+        ClipCache cache;
+        TEST_ASSERT_TRUE(cache.begin(filesystem));
+        missAndStore(cache, key, clipBytes(3000, 1));
+    }
+    File index = filesystem.open(String(CLIP_CACHE_DIR) + "index.bin", FILE_WRITE);
+    index.write((const uint8_t*)"garbage", 7);
+    index.close();
+
+    ClipCache cache;
+    TEST_ASSERT_TRUE(cache.begin(filesystem));
+    TEST_ASSERT_TRUE(readClip(cache, key).empty());
+    // The clip it no longer knows about is removed as a stray
+    TEST_ASSERT_EQUAL(1, filesIn(CLIP_CACHE_DIR));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_keys_cover_text_voice_and_format);
+    RUN_TEST(test_clip_is_written_once_it_keeps_missing);
+    RUN_TEST(test_partial_and_oversized_clips_are_not_written);
+    RUN_TEST(test_least_recently_used_clip_is_evicted);
+    RUN_TEST(test_index_survives_a_restart_and_strays_are_cleaned);
+    RUN_TEST(test_corrupt_index_starts_empty);
+    return UNITY_END();
+}
@@ -0,0 +1,236 @@
+#include <unity.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "colour_identifier.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+static int nameIndex(const char* name) {
+    for (int i = 0; i < ColourIdentifier::nameCount(); i++) {
+        if (!strcmp(ColourIdentifier::colourName(i), name)) return i;
+    }
+    return -1;
+}
+
+// Appends `count` samples of one colour scaled by `light` (1 = as printed)
+static void addSamples(std::vector<uint8_t>& rgb, int count, uint8_t r, uint8_t g, uint8_t b, float light) {
+    for (int i = 0; i < count; i++) {
+        rgb.push_back(min(255, (int)(r * light)));
+        rgb.push_back(min(255, (int)(g * light)));
+        rgb.push_back(min(255, (int)(b * light)));
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_reference_colours_name_themselves() {
+    TEST_ASSERT_EQUAL(23, ColourIdentifier::nameCount());
+    for (int i = 0; i < ColourIdentifier::nameCount(); i++) {
+        const NamedColour& colour = NAMED_COLOURS[i];
+        TEST_ASSERT_EQUAL_STRING(colour.name, ColourIdentifier::colourName(ColourIdentifier::nearestName(colour.r, colour.g, colour.b)));
+    }
+    TEST_ASSERT_EQUAL_STRING("unknown", ColourIdentifier::colourName(-1));
+    TEST_ASSERT_EQUAL_STRING("unknown", ColourIdentifier::colourName(ColourIdentifier::nameCount()));
+}
+
+void test_textbook_colours_get_their_names() {
+    TEST_ASSERT_EQUAL(nameIndex("red"), ColourIdentifier::nearestName(255, 0, 0));
+    TEST_ASSERT_EQUAL(nameIndex("green"), ColourIdentifier::nearestName(0, 255, 0));
+    TEST_ASSERT_EQUAL(nameIndex("blue"), ColourIdentifier::nearestName(0, 0, 255));
+    TEST_ASSERT_EQUAL(nameIndex("yellow"), ColourIdentifier::nearestName(255, 255, 0));
+    TEST_ASSERT_EQUAL(nameIndex("orange"), ColourIdentifier::nearestName(255, 165, 0));
+    TEST_ASSERT_EQUAL(nameIndex("pink"), ColourIdentifier::nearestName(255, 192, 203));
+    TEST_ASSERT_EQUAL(nameIndex("teal"), ColourIdentifier::nearestName(0, 128, 128));
+    TEST_ASSERT_EQUAL(nameIndex("white"), ColourIdentifier::nearestName(255, 255, 255));
+    TEST_ASSERT_EQUAL(nameIndex("black"), ColourIdentifier::nearestName(0, 0, 0));
+}
+
+void test_folds_stay_one_colour() {
+    // Garments lit from one side, falling off to 75% across the folds
+    const char* names[] = { "blue", "red", "green", "orange", "purple" };
+    for (const char* name : names) {
+        const NamedColour& colour = NAMED_COLOURS[nameIndex(name)];
+        std::vector<uint8_t> rgb;
+        for (int i = 0; i < 256; i++) addSamples(rgb, 1, colour.r, colour.g, colour.b, 1.0f - 0.25f * i / 255);
+        ColourResult result;
+        TEST_ASSERT_TRUE(ColourIdentifier::identifySamples(rgb.data(), rgb.size() / 3, &result));
+        TEST_ASSERT_EQUAL_MESSAGE(1, result.count, name);
+        TEST_ASSERT_EQUAL_STRING(name, ColourIdentifier::colourName(result.colours[0].name));
+    }
+}
+
+void test_two_colours_largest_first_and_small_ones_dropped() {
+    // Yellow and navy stripes with a few white stitches
+    std::vector<uint8_t> rgb;
+    addSamples(rgb, 96, 28, 36, 88, 1.0f);
+    addSamples(rgb, 140, 232, 212, 45, 1.0f);
+    addSamples(rgb, 20, 240, 240, 236, 1.0f);
+    ColourResult result;
+    TEST_ASSERT_TRUE(ColourIdentifier::identifySamples(rgb.data(), rgb.size() / 3, &result));
+    TEST_ASSERT_EQUAL(2, result.count);
+    TEST_ASSERT_EQUAL(nameIndex("yellow"), result.colours[0].name);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 140.0f / 256, result.colours[0].share);
+    TEST_ASSERT_EQUAL(232, result.colours[0].r);
+    TEST_ASSERT_EQUAL(45, result.colours[0].b);
+    TEST_ASSERT_EQUAL(nameIndex("navy"), result.colours[1].name);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 96.0f / 256, result.colours[1].share);
+
+    // A minor second colour is not announced, but a single colour always is
+    rgb.clear();
+    addSamples(rgb, 220, 55, 148, 62, 1.0f);
+    addSamples(rgb, 36, 200, 35, 35, 1.0f);
+    TEST_ASSERT_TRUE(ColourIdentifier::identifySamples(rgb.data(), rgb.size() / 3, &result));
+    TEST_ASSERT_EQUAL(1, result.count);
+    TEST_ASSERT_EQUAL(nameIndex("green"), result.colours[0].name);
+
+    TEST_ASSERT_FALSE(ColourIdentifier::identifySamples(rgb.data(), 0, &result));
+    TEST_ASSERT_EQUAL(0, result.count);
+}
+
+void test_centre_of_the_scene() {
+    // The centre square holds the edge of the red rectangle against the green-grey wall
+    ColourIdentifier identifier;
+    ColourResult result;
+    TEST_ASSERT_TRUE(identifier.identify(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &result));
+    TEST_ASSERT_EQUAL(2, result.count);
+    TEST_ASSERT_EQUAL(nameIndex("teal"), result.colours[0].name);
+    TEST_ASSERT_EQUAL(nameIndex("red"), result.colours[1].name);
+    TEST_ASSERT_FLOAT_WITHIN(0.08f, 0.25f, result.colours[1].share);
+    TEST_ASSERT_INT_WITHIN(20, 202, result.colours[1].r);
+
+    TEST_ASSERT_FALSE(identifier.identify(TEST_SCENE_JPEG, 100, &result));
+    TEST_ASSERT_EQUAL(1, identifier.getStats().frames);
+}
+
+// ===================
+// Benchmark: generated labelled set
+// ===================
+
+// Encoder in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize);
+
+static const int PATCH_WIDTH = 640;
+static const int PATCH_HEIGHT = 480;
+
+// 640x480 frame of a garment filling the middle, in one named colour or stripes of
+// two, jittered off the table entry by up to `jitter` per channel. Folds shade it
+// to between 70% and 100%, a two-pixel weave and sensor noise add texture, and the
+// white balance is off by up to 10% in red and blue.
+static std::vector<uint8_t> garment(std::mt19937& rng, int first, int second, int jitter) {
+    auto uniform = [&rng](float low, float high) { return low + (high - low) * (rng() % 10000) / 10000.0f; };
+    int base[2][3];
+    for (int c = 0; c < 2; c++) {
+        const NamedColour& colour = NAMED_COLOURS[c == 0 ? first : second < 0 ? first : second];
+        base[c][0] = constrain(colour.r + (int)uniform(-jitter, jitter), 0, 255);
+        base[c][1] = constrain(colour.g + (int)uniform(-jitter, jitter), 0, 255);
+        base[c][2] = constrain(colour.b + (int)uniform(-jitter, jitter), 0, 255);
+    }
+    float redGain = uniform(0.9f, 1.1f), blueGain = uniform(0.9f, 1.1f);
+    float foldPeriod = uniform(60, 200), foldPhase = uniform(0, 6.28f), foldAngle = uniform(0, 3.14f);
+    int stripe = (int)uniform(24, 60);
+    bool vertical = rng() % 2;
+    int background[3] = { (int)(rng() % 256), (int)(rng() % 256), (int)(rng() % 256) };
+
+    std::vector<uint8_t> rgb(PATCH_WIDTH * PATCH_HEIGHT * 3);
+    for (int y = 0; y < PATCH_HEIGHT; y++) {
+        for (int x = 0; x < PATCH_WIDTH; x++) {
+            uint8_t* p = rgb.data() + (y * PATCH_WIDTH + x) * 3;
+            bool inside = abs(x - PATCH_WIDTH / 2) < PATCH_WIDTH / 3 && abs(y - PATCH_HEIGHT / 2) < PATCH_HEIGHT / 3;
+            if (!inside) {
+                for (int c = 0; c < 3; c++) p[c] = background[c];
+                continue;
+            }
+            int which = second >= 0 && ((vertical ? x : y) / stripe) % 2;
+            float along = x * cosf(foldAngle) + y * sinf(foldAngle);
+            float light = 0.85f + 0.15f * sinf(along * 6.28f / foldPeriod + foldPhase);
+            light *= (x + y) % 4 < 2 ? 1.03f : 0.97f;
+            float gains[3] = { redGain, 1, blueGain };
+            for (int c = 0; c < 3; c++) p[c] = constrain((int)(base[which][c] * light * gains[c] + uniform(-6, 6)), 0, 255);
+        }
+    }
+    uint8_t* jpeg = nullptr;
+    size_t size = 0;
+    TEST_ASSERT_TRUE(libjpegEncodeRgb(rgb.data(), PATCH_WIDTH, PATCH_HEIGHT, 80, &jpeg, &size));
+    std::vector<uint8_t> out(jpeg, jpeg + size);
+    free(jpeg);
+    return out;
+}
+
+// Prints top-1 accuracy over 6 garments per named colour, both names found over
+// 60 two-colour stripes, the commonest confusions and the time per frame
+void test_benchmark_labelled_set() {
+    std::mt19937 rng(38);
+    ColourIdentifier identifier;
+    const int names = ColourIdentifier::nameCount();
+    int singles = 0, singleHits = 0, stripes = 0, stripeHits = 0;
+    std::map<std::string, int> confusions;
+    std::vector<double> millis;
+
+    auto identify = [&](const std::vector<uint8_t>& jpeg, ColourResult* result) {
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(identifier.identify(jpeg.data(), jpeg.size(), result));
+        millis.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    };
+
+    for (int name = 0; name < names; name++) {
+        for (int n = 0; n < 6; n++) {
+            ColourResult result;
+            identify(garment(rng, name, -1, 12), &result);
+            singles++;
+            if (result.colours[0].name == name) {
+                singleHits++;
+            } else {
+                confusions[std::string(ColourIdentifier::colourName(name)) + " as " + ColourIdentifier::colourName(result.colours[0].name)]++;
+            }
+        }
+    }
+    for (int n = 0; n < 60; n++) {
+        int first = rng() % names, second = rng() % names;
+        while (second == first) second = rng() % names;
+        ColourResult result;
+        identify(garment(rng, first, second, 12), &result);
+        stripes++;
+        bool hasFirst = false, hasSecond = false;
+        for (int c = 0; c < result.count; c++) {
+            hasFirst |= result.colours[c].name == first;
+            hasSecond |= result.colours[c].name == second;
+        }
+        stripeHits += hasFirst && hasSecond;
+    }
+
+    std::vector<std::pair<int, std::string>> ranked;
+    for (const auto& entry : confusions) ranked.push_back({ -entry.second, entry.first });
+    std::sort(ranked.begin(), ranked.end());
+    std::string common;
+    for (size_t i = 0; i < ranked.size() && i < 4; i++) {
+        common += (i ? ", " : "") + ranked[i].second + " " + std::to_string(-ranked[i].first);
+    }
+    std::sort(millis.begin(), millis.end());
+
+    char line[240];
+    snprintf(line, sizeof(line), "single colour top-1 %d/%d; two-colour stripes both named %d/%d", singleHits, singles,
+             stripeHits, stripes);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "commonest misses: %s", common.c_str());
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "identify with decode: median %.2f ms, max %.2f ms per 640x480 frame", millis[millis.size() / 2], millis.back());
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reference_colours_name_themselves);
+    RUN_TEST(test_textbook_colours_get_their_names);
+    RUN_TEST(test_folds_stay_one_colour);
+    RUN_TEST(test_two_colours_largest_first_and_small_ones_dropped);
+    RUN_TEST(test_centre_of_the_scene);
+    RUN_TEST(test_benchmark_labelled_set);
+    return UNITY_END();
+}
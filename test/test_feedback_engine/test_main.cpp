@@ -0,0 +1,166 @@
+#include <unity.h>
+#include <vector>
+#include "feedback_engine.cpp"
+#include "host_runtime.h"
+
+// Output levels and tone from one tick to the next change
+struct Edge {
+    unsigned long time;
+    uint8_t outputs;
+    uint16_t frequency;
+};
+
+// Drives tick() under a virtual clock, jumping to each due step like the task
+class VirtualClock {
+public:
+    FeedbackEngine& engine;
+    unsigned long now;
+    std::vector<Edge> edges;
+
+    VirtualClock(FeedbackEngine& target, unsigned long start) : engine(target), now(start) {}
+
+    void runUntil(unsigned long end) {
+        while (now <= end) {
+            unsigned long wait = engine.tick(now);
+            uint8_t outputs = engine.getOutputs();
+            uint16_t frequency = engine.getFrequency();
+            if (edges.empty() || edges.back().outputs != outputs || edges.back().frequency != frequency) {
+                edges.push_back({ now, outputs, frequency });
+            }
+            if (now + wait > end) {
+                now = end + 1;
+                break;
+            }
+            now += wait;
+        }
+    }
+
+    int risingEdges(uint8_t channel) {
+        int count = 0;
+        for (size_t i = 0; i < edges.size(); i++) {
+            bool before = i > 0 && (edges[i - 1].outputs & channel);
+            if ((edges[i].outputs & channel) && !before) count++;
+        }
+        return count;
+    }
+};
+
+void setUp() {
+    hostStartTasks = false;
+}
+
+void tearDown() {
+    hostStartTasks = true;
+}
+
+void test_patterns_on_different_outputs_play_together() {
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    VirtualClock clock(engine, 1000);
+    TEST_ASSERT_TRUE(engine.play(FEEDBACK_EMERGENCY_FLASH));
+    TEST_ASSERT_TRUE(engine.play(FEEDBACK_HAPTIC_STRONG));
+    TEST_ASSERT_TRUE(engine.playTone(800, 150));
+    clock.runUntil(3100);
+
+    TEST_ASSERT_EQUAL(10, clock.risingEdges(FEEDBACK_HAZARD_LED));
+    TEST_ASSERT_EQUAL(3, clock.risingEdges(FEEDBACK_VIBRATION));
+    TEST_ASSERT_EQUAL(1, clock.risingEdges(FEEDBACK_BUZZER));
+    TEST_ASSERT_EQUAL(800, clock.edges.front().frequency);
+    // Last change: the LED going off for the flash's final 100 ms
+    TEST_ASSERT_EQUAL(1000 + 10 * 200 - 100, clock.edges.back().time);
+    TEST_ASSERT_EQUAL(0, clock.edges.back().outputs);
+    TEST_ASSERT_TRUE(engine.isIdle());
+    TEST_ASSERT_EQUAL(0, engine.getStats().maxLateMillis);
+    TEST_ASSERT_EQUAL(LOW, hostPinLevels[HAZARD_LED_PIN]);
+    TEST_ASSERT_EQUAL(0, hostLedcDuty[FEEDBACK_LEDC_CHANNEL]);
+}
+
+void test_urgent_pattern_preempts_and_others_wait() {
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    VirtualClock clock(engine, 3000);
+    engine.play(FEEDBACK_HAPTIC_LIGHT);
+    clock.runUntil(3050);
+    engine.play(FEEDBACK_HAPTIC_COLLISION);   // Cuts the light haptic short
+    engine.play(FEEDBACK_HAPTIC_MEDIUM);      // Waits for the collision pattern
+    clock.runUntil(5000);
+
+    FeedbackStats stats = engine.getStats();
+    TEST_ASSERT_EQUAL(1, stats.preempted);
+    TEST_ASSERT_EQUAL(1, stats.queued);
+    TEST_ASSERT_EQUAL(3, stats.played);
+    TEST_ASSERT_EQUAL(2, stats.completed);
+    TEST_ASSERT_EQUAL(0, stats.dropped);
+    // Light from 3000, collision 5 x 200 ms from 3051 (its first pulse continues
+    // the light one), then the 500 ms medium pattern
+    TEST_ASSERT_EQUAL(1 + 4 + 2, clock.risingEdges(FEEDBACK_VIBRATION));
+    TEST_ASSERT_EQUAL(3051 + 1000 + 500, clock.edges.back().time);
+}
+
+void test_waiting_pattern_is_dropped_after_the_max_delay() {
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    VirtualClock clock(engine, 1000);
+    engine.play(FEEDBACK_EMERGENCY_FLASH);
+    clock.runUntil(1010);
+    FeedbackPattern blink = { nullptr, 0, 1, FEEDBACK_HAZARD_LED, FEEDBACK_PRIORITY_NOTIFY };
+    FeedbackStep step = { 50, FEEDBACK_HAZARD_LED, 0 };
+    blink.steps = &step;
+    blink.count = 1;
+    engine.play(blink);
+    clock.runUntil(4000);
+    TEST_ASSERT_EQUAL(1, engine.getStats().dropped);
+    TEST_ASSERT_EQUAL(10, clock.risingEdges(FEEDBACK_HAZARD_LED));
+}
+
+void test_baseline_shows_when_no_pattern_owns_the_led() {
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    VirtualClock clock(engine, 1000);
+    engine.setBaseline(FEEDBACK_HAZARD_LED | FEEDBACK_STATUS_LED, FEEDBACK_HAZARD_LED | FEEDBACK_STATUS_LED);
+    clock.runUntil(1000);
+    TEST_ASSERT_EQUAL(FEEDBACK_HAZARD_LED | FEEDBACK_STATUS_LED, engine.getOutputs());
+
+    engine.play(FEEDBACK_EMERGENCY_FLASH);
+    clock.runUntil(1150);
+    // Off half of the flash: the pattern owns the LED, the status LED keeps its baseline
+    TEST_ASSERT_EQUAL(FEEDBACK_STATUS_LED, engine.getOutputs());
+    clock.runUntil(4000);
+    TEST_ASSERT_EQUAL(FEEDBACK_HAZARD_LED | FEEDBACK_STATUS_LED, engine.getOutputs());
+}
+
+void test_coarse_ticks_keep_pattern_length() {
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    engine.play(FEEDBACK_HAPTIC_STRONG);
+    unsigned long now = 10000;
+    for (; !engine.isIdle(); now += 7) engine.tick(now);
+    // 3 x 500 ms, finished on the first 7 ms tick at or after it was due
+    TEST_ASSERT_INT_WITHIN(7, 10000 + 1500, now - 7);
+    TEST_ASSERT_LESS_THAN(7, engine.getStats().maxLateMillis);
+}
+
+void test_task_plays_in_real_time() {
+    hostStartTasks = true;
+    FeedbackEngine engine;
+    TEST_ASSERT_TRUE(engine.begin());
+    TEST_ASSERT_TRUE(engine.play(FEEDBACK_HAPTIC_TAP));
+    delay(40);
+    TEST_ASSERT_EQUAL(HIGH, hostPinLevels[VIBRATION_PIN]);
+    delay(160);
+    TEST_ASSERT_EQUAL(LOW, hostPinLevels[VIBRATION_PIN]);
+    TEST_ASSERT_TRUE(engine.isIdle());
+    engine.end();
+    TEST_ASSERT_FALSE(engine.isActive());
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_patterns_on_different_outputs_play_together);
+    RUN_TEST(test_urgent_pattern_preempts_and_others_wait);
+    RUN_TEST(test_waiting_pattern_is_dropped_after_the_max_delay);
+    RUN_TEST(test_baseline_shows_when_no_pattern_owns_the_led);
+    RUN_TEST(test_coarse_ticks_keep_pattern_length);
+    RUN_TEST(test_task_plays_in_real_time);
+    return UNITY_END();
+}
@@ -0,0 +1,184 @@
+#include <unity.h>
+#include <random>
+#include <vector>
+#include "int8_kernels.cpp"
+#include "host_runtime.h"
+
+static std::mt19937 rng(36);
+
+static int randomInt(int low, int high) {
+    return std::uniform_int_distribution<int>(low, high)(rng);
+}
+
+// A layer with random weights and requantization, and storage for its arrays
+class RandomLayer {
+public:
+    QuantizedLayer layer;
+    std::vector<int8_t> weights;
+    std::vector<int32_t> bias, multiplier, shift, sums;
+
+    RandomLayer(uint8_t type, int size, int inChannels, int outChannels, int kernel, int stride, bool same) {
+        memset(&layer, 0, sizeof(layer));
+        layer.type = type;
+        layer.kernel = kernel;
+        layer.stride = stride;
+        layer.samePadding = same;
+        layer.inputHeight = size;
+        layer.inputWidth = size + 1;
+        layer.inputChannels = inChannels;
+        layer.outputChannels = outChannels;
+        if (type == LAYER_FULLY_CONNECTED || type == LAYER_AVERAGE_POOL) {
+            layer.outputHeight = 1;
+            layer.outputWidth = 1;
+        } else if (same) {
+            layer.outputHeight = (layer.inputHeight + stride - 1) / stride;
+            layer.outputWidth = (layer.inputWidth + stride - 1) / stride;
+        } else {
+            layer.outputHeight = (layer.inputHeight - kernel) / stride + 1;
+            layer.outputWidth = (layer.inputWidth - kernel) / stride + 1;
+        }
+        layer.inputOffset = randomInt(-127, 128);
+        layer.outputOffset = randomInt(-20, 20);
+        layer.activationMin = randomInt(0, 1) ? -128 : layer.outputOffset;   // None or fused ReLU
+        layer.activationMax = 127;
+
+        size_t count = type == LAYER_CONV2D ? (size_t)outChannels * kernel * kernel * inChannels
+                     : type == LAYER_DEPTHWISE_CONV2D ? (size_t)kernel * kernel * outChannels
+                     : (size_t)outChannels * inChannels;
+        weights.resize(count);
+        for (int8_t& w : weights) w = randomInt(-127, 127);
+        for (int c = 0; c < outChannels; c++) {
+            bias.push_back(randomInt(-5000, 5000));
+            multiplier.push_back(randomInt(1 << 30, INT32_MAX));
+            shift.push_back(randomInt(-12, -6));
+        }
+        layer.weights = weights.data();
+        layer.bias = bias.data();
+        layer.multiplier = multiplier.data();
+        layer.shift = shift.data();
+        sums.resize(outChannels);
+        Int8Kernels::computeWeightSums(layer, sums.data());
+        layer.weightSums = sums.data();
+    }
+
+    size_t inputSize() const { return (size_t)layer.inputHeight * layer.inputWidth * layer.inputChannels; }
+    size_t outputSize() const { return (size_t)layer.outputHeight * layer.outputWidth * layer.outputChannels; }
+};
+
+static std::vector<int8_t> randomInput(size_t size) {
+    std::vector<int8_t> input(size);
+    for (int8_t& x : input) x = randomInt(-128, 127);
+    return input;
+}
+
+// Runs the fast and reference kernels and expects the same bytes
+static void expectSameAsReference(RandomLayer& random) {
+    std::vector<int8_t> input = randomInput(random.inputSize());
+    std::vector<int8_t> fast(random.outputSize()), reference(random.outputSize());
+    Int8Kernels::run(random.layer, input.data(), fast.data());
+    Int8Kernels::runReference(random.layer, input.data(), reference.data());
+    TEST_ASSERT_EQUAL_INT8_ARRAY(reference.data(), fast.data(), reference.size());
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_requantization_rounds_like_tflite() {
+    const int32_t half = 1 << 30;
+    TEST_ASSERT_EQUAL(50, Int8Kernels::multiplyByQuantizedMultiplier(100, half, 0));
+    // Ties in the high multiply round up, as in gemmlowp
+    TEST_ASSERT_EQUAL(2, Int8Kernels::multiplyByQuantizedMultiplier(3, half, 0));
+    TEST_ASSERT_EQUAL(-1, Int8Kernels::multiplyByQuantizedMultiplier(-3, half, 0));
+    // The final shift rounds ties away from zero
+    TEST_ASSERT_EQUAL(-2, Int8Kernels::multiplyByQuantizedMultiplier(-6, half, -1));
+    TEST_ASSERT_EQUAL(2, Int8Kernels::multiplyByQuantizedMultiplier(6, half, -1));
+    TEST_ASSERT_EQUAL(3, Int8Kernels::multiplyByQuantizedMultiplier(3, half, 1));
+    TEST_ASSERT_EQUAL(25, Int8Kernels::multiplyByQuantizedMultiplier(100, half, -1));
+    TEST_ASSERT_EQUAL(INT32_MAX, Int8Kernels::multiplyByQuantizedMultiplier(INT32_MIN, INT32_MIN, 0));
+
+    // Rounded twice, so within one step of the exact product
+    for (int i = 0; i < 100000; i++) {
+        int32_t x = randomInt(-(1 << 20), 1 << 20);
+        int32_t multiplier = randomInt(1 << 30, INT32_MAX);
+        int32_t shift = randomInt(-15, 2);
+        double exact = (double)x * multiplier / 2147483648.0 * pow(2.0, shift);
+        TEST_ASSERT_TRUE(fabs(Int8Kernels::multiplyByQuantizedMultiplier(x, multiplier, shift) - exact) <= 1.0);
+    }
+}
+
+void test_same_padding_is_split_like_tensorflow() {
+    RandomLayer random(LAYER_CONV2D, 5, 1, 1, 3, 2, true);
+    TEST_ASSERT_EQUAL(3, random.layer.outputHeight);
+    TEST_ASSERT_EQUAL(1, Int8Kernels::paddingTop(random.layer));
+    // 6 wide: the odd padding column goes after the input
+    TEST_ASSERT_EQUAL(3, random.layer.outputWidth);
+    TEST_ASSERT_EQUAL(0, Int8Kernels::paddingLeft(random.layer));
+    random.layer.samePadding = 0;
+    TEST_ASSERT_EQUAL(0, Int8Kernels::paddingTop(random.layer));
+}
+
+void test_identity_convolution_copies_the_input() {
+    // 3x3 kernel with only its centre set, requantized by exactly one
+    int8_t weights[9] = { 0, 0, 0, 0, 1, 0, 0, 0, 0 };
+    int32_t zero = 0, one = 1 << 30, shift = 1, sum = 1;
+    QuantizedLayer layer = { LAYER_CONV2D, 3, 1, 1, 4, 4, 1, 4, 4, 1, 0, 0, -128, 127,
+                             weights, &zero, &one, &shift, &sum };
+    int8_t input[16], fast[16], reference[16];
+    for (int i = 0; i < 16; i++) input[i] = i * 17 - 128;
+    Int8Kernels::conv2d(layer, input, fast);
+    Int8Kernels::conv2dReference(layer, input, reference);
+    TEST_ASSERT_EQUAL_INT8_ARRAY(input, reference, 16);
+    TEST_ASSERT_EQUAL_INT8_ARRAY(input, fast, 16);
+}
+
+void test_convolutions_match_the_reference() {
+    const int kernels[] = { 1, 3, 5 };
+    const int channels[] = { 1, 3, 8, 13 };
+    for (int kernel : kernels) {
+        for (int stride = 1; stride <= 2; stride++) {
+            for (int same = 0; same <= 1; same++) {
+                for (int inChannels : channels) {
+                    RandomLayer conv(LAYER_CONV2D, 9, inChannels, 7, kernel, stride, same);
+                    expectSameAsReference(conv);
+                    RandomLayer depthwise(LAYER_DEPTHWISE_CONV2D, 9, inChannels, inChannels, kernel, stride, same);
+                    expectSameAsReference(depthwise);
+                }
+            }
+        }
+    }
+}
+
+void test_fully_connected_matches_the_reference() {
+    const int sizes[] = { 1, 4, 7, 64, 131 };
+    for (int inputs : sizes) {
+        RandomLayer dense(LAYER_FULLY_CONNECTED, 1, inputs, 5, 1, 1, false);
+        dense.layer.inputWidth = 1;
+        expectSameAsReference(dense);
+        // Without precomputed sums the fast path falls back to the reference
+        dense.layer.weightSums = nullptr;
+        expectSameAsReference(dense);
+    }
+}
+
+void test_average_pool_averages_each_channel() {
+    // 2x2x2 input with zero point -10; the exporter folds the 1/4 into the multiplier
+    int32_t zero[2] = { 0, 0 }, quarter[2] = { 1 << 30, 1 << 30 }, shift[2] = { -1, -1 };
+    QuantizedLayer layer = { LAYER_AVERAGE_POOL, 0, 1, 0, 2, 2, 2, 1, 1, 2, 10, 0, -128, 127,
+                             nullptr, zero, quarter, shift, nullptr };
+    int8_t input[8] = { -10, 0, -6, 20, -2, 40, 2, 60 };
+    int8_t output[2];
+    Int8Kernels::run(layer, input, output);
+    TEST_ASSERT_EQUAL((0 + 4 + 8 + 12) / 4, output[0]);
+    TEST_ASSERT_EQUAL((10 + 30 + 50 + 70) / 4, output[1]);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_requantization_rounds_like_tflite);
+    RUN_TEST(test_same_padding_is_split_like_tensorflow);
+    RUN_TEST(test_identity_convolution_copies_the_input);
+    RUN_TEST(test_convolutions_match_the_reference);
+    RUN_TEST(test_fully_connected_matches_the_reference);
+    RUN_TEST(test_average_pool_averages_each_channel);
+    return UNITY_END();
+}
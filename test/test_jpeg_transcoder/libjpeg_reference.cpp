@@ -0,0 +1,131 @@
+// libjpeg baseline for the transcoder benchmark. jpeglib.h and the Arduino
+// stand-ins both define boolean, so this file includes no firmware headers.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <jpeglib.h>
+
+// What a capture would go through without the transcoder: RGB decode, 2x2 box
+// filter, fresh encode at the quality matching quantScale
+bool libjpegHalfScale(const uint8_t* jpeg, size_t length, int quality, uint8_t** output, size_t* outputSize) {
+    jpeg_decompress_struct in;
+    jpeg_error_mgr inErrors;
+    in.err = jpeg_std_error(&inErrors);
+    jpeg_create_decompress(&in);
+    jpeg_mem_src(&in, jpeg, length);
+    jpeg_read_header(&in, TRUE);
+    in.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&in);
+    int width = in.output_width, height = in.output_height;
+    std::vector<uint8_t> rgb(width * height * 3);
+    while (in.output_scanline < in.output_height) {
+        JSAMPROW row = rgb.data() + in.output_scanline * width * 3;
+        jpeg_read_scanlines(&in, &row, 1);
+    }
+    jpeg_finish_decompress(&in);
+    jpeg_destroy_decompress(&in);
+
+    int halfWidth = width / 2, halfHeight = height / 2;
+    std::vector<uint8_t> half(halfWidth * halfHeight * 3);
+    for (int y = 0; y < halfHeight; y++) {
+        for (int x = 0; x < halfWidth; x++) {
+            for (int c = 0; c < 3; c++) {
+                const uint8_t* p = rgb.data() + (2 * y * width + 2 * x) * 3 + c;
+                half[(y * halfWidth + x) * 3 + c] = (p[0] + p[3] + p[width * 3] + p[width * 3 + 3] + 2) / 4;
+            }
+        }
+    }
+
+    jpeg_compress_struct out;
+    jpeg_error_mgr outErrors;
+    out.err = jpeg_std_error(&outErrors);
+    jpeg_create_compress(&out);
+    unsigned char* buffer = nullptr;
+    unsigned long bufferSize = 0;
+    jpeg_mem_dest(&out, &buffer, &bufferSize);
+    out.image_width = halfWidth;
+    out.image_height = halfHeight;
+    out.input_components = 3;
+    out.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&out);
+    jpeg_set_quality(&out, quality, TRUE);
+    jpeg_start_compress(&out, TRUE);
+    while (out.next_scanline < out.image_height) {
+        JSAMPROW row = half.data() + out.next_scanline * halfWidth * 3;
+        jpeg_write_scanlines(&out, &row, 1);
+    }
+    jpeg_finish_compress(&out);
+    jpeg_destroy_compress(&out);
+    *output = buffer;
+    *outputSize = bufferSize;
+    return true;
+}
+
+// Synthetic scene for the optimize corpus: a sky gradient, coloured blocks,
+// textured ground and sensor noise, encoded with libjpeg's standard tables
+bool libjpegEncodeScene(int width, int height, int quality, bool subsample420, unsigned seed,
+                        uint8_t** output, size_t* outputSize) {
+    std::vector<uint8_t> rgb(width * height * 3);
+    unsigned state = seed * 2654435761u + 1;
+    auto next = [&state]() { state = state * 1103515245u + 12345u; return (state >> 16) & 0x7FFF; };
+    int horizon = height * (40 + next() % 20) / 100;
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t* p = rgb.data() + (y * width + x) * 3;
+            if (y < horizon) {
+                p[0] = 120 + 60 * y / horizon;
+                p[1] = 160 + 50 * y / horizon;
+                p[2] = 230 - 20 * y / horizon;
+            } else {
+                int texture = ((x / 3 + y / 2) % 7) * 6 + ((x * 7 + y * 13) % 11);
+                p[0] = 90 + texture;
+                p[1] = 80 + texture;
+                p[2] = 60 + texture / 2;
+            }
+        }
+    }
+    int blocks = 6 + next() % 10;
+    for (int b = 0; b < blocks; b++) {
+        int bw = width / 12 + next() % (width / 4), bh = height / 10 + next() % (height / 3);
+        int bx = next() % (width - bw), by = next() % (height - bh);
+        uint8_t colour[3] = { (uint8_t)(next() % 256), (uint8_t)(next() % 256), (uint8_t)(next() % 256) };
+        for (int y = by; y < by + bh; y++) {
+            for (int x = bx; x < bx + bw; x++) {
+                uint8_t* p = rgb.data() + (y * width + x) * 3;
+                bool edge = y < by + 2 || x < bx + 2 || y >= by + bh - 2 || x >= bx + bw - 2;
+                for (int c = 0; c < 3; c++) p[c] = edge ? colour[c] / 3 : colour[c];
+            }
+        }
+    }
+    for (size_t i = 0; i < rgb.size(); i++) {
+        int v = rgb[i] + (int)(next() % 9) - 4;
+        rgb[i] = v < 0 ? 0 : (v > 255 ? 255 : v);
+    }
+
+    jpeg_compress_struct out;
+    jpeg_error_mgr errors;
+    out.err = jpeg_std_error(&errors);
+    jpeg_create_compress(&out);
+    unsigned char* buffer = nullptr;
+    unsigned long bufferSize = 0;
+    jpeg_mem_dest(&out, &buffer, &bufferSize);
+    out.image_width = width;
+    out.image_height = height;
+    out.input_components = 3;
+    out.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&out);
+    jpeg_set_quality(&out, quality, TRUE);
+    out.comp_info[0].h_samp_factor = 2;
+    out.comp_info[0].v_samp_factor = subsample420 ? 2 : 1;
+    jpeg_start_compress(&out, TRUE);
+    while (out.next_scanline < out.image_height) {
+        JSAMPROW row = rgb.data() + out.next_scanline * width * 3;
+        jpeg_write_scanlines(&out, &row, 1);
+    }
+    jpeg_finish_compress(&out);
+    jpeg_destroy_compress(&out);
+    *output = buffer;
+    *outputSize = bufferSize;
+    return true;
+}
@@ -0,0 +1,461 @@
+#include <unity.h>
+#include <chrono>
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+// Luma and chroma of the scene as libjpeg decodes it, at full and half scale
+struct ScenePoint {
+    uint16_t x, y;
+    uint8_t luma, halfLuma, cb, cr;
+};
+
+static const ScenePoint SCENE_POINTS[] = {
+    {  45,  60,  81,  81,  99, 214 },   // Red rectangle
+    { 120,  45,  67,  67, 203, 102 },   // Blue disc
+    {  10,  10,  88,  88, 156, 112 },   // Gradient corners
+    { 150,   5, 102, 102, 129, 152 },
+    {   5, 115, 149, 148, 122,  66 },
+    {  80,  60, 126, 127, 124, 110 },
+};
+
+static const int PIXEL_TOLERANCE = 3;
+
+static uint8_t at(const JpegPlane& plane, int x, int y) {
+    return plane.data[y * plane.stride + x];
+}
+
+static void freePlanes(JpegPlane* planes, int count) {
+    for (int i = 0; i < count; i++) free(planes[i].data);
+}
+
+static JpegTranscodeOptions plainOptions() {
+    JpegTranscodeOptions options;
+    options.crop = false;
+    options.cropRect = { 0, 0, 0, 0 };
+    options.scale = JPEG_SCALE_FULL;
+    options.quantScale = 1.0;
+    options.optimizeHuffman = false;
+    options.timeLimitMicros = 0;
+    return options;
+}
+
+static camera_fb_t sceneFrame() {
+    camera_fb_t fb;
+    memset(&fb, 0, sizeof(fb));
+    fb.buf = (uint8_t*)TEST_SCENE_JPEG;
+    fb.len = TEST_SCENE_JPEG_LENGTH;
+    fb.width = 160;
+    fb.height = 120;
+    fb.format = PIXFORMAT_JPEG;
+    return fb;
+}
+
+void setUp() {
+    jpegTranscoder.resetStats();
+}
+
+void tearDown() {}
+
+void test_reads_stream_info() {
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &info));
+    TEST_ASSERT_EQUAL(160, info.width);
+    TEST_ASSERT_EQUAL(120, info.height);
+    TEST_ASSERT_EQUAL(3, info.components);
+    TEST_ASSERT_EQUAL(16, info.mcuWidth);
+    TEST_ASSERT_EQUAL(8, info.mcuHeight);
+    TEST_ASSERT_FALSE(jpegTranscoder.getInfo(TEST_SCENE_JPEG, 100, &info));
+}
+
+void test_decode_matches_libjpeg() {
+    JpegPlane planes[3];
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_FULL, planes, 3));
+    TEST_ASSERT_EQUAL(160, planes[0].width);
+    TEST_ASSERT_EQUAL(120, planes[0].height);
+    // 4:2:2: chroma at half the width
+    TEST_ASSERT_EQUAL(80, planes[1].width);
+    TEST_ASSERT_EQUAL(120, planes[1].height);
+    for (const ScenePoint& point : SCENE_POINTS) {
+        TEST_ASSERT_INT_WITHIN(PIXEL_TOLERANCE, point.luma, at(planes[0], point.x, point.y));
+        TEST_ASSERT_INT_WITHIN(PIXEL_TOLERANCE, point.cb, at(planes[1], point.x / 2, point.y));
+        TEST_ASSERT_INT_WITHIN(PIXEL_TOLERANCE, point.cr, at(planes[2], point.x / 2, point.y));
+    }
+    freePlanes(planes, 3);
+
+    JpegPlane half;
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_HALF, &half, 1));
+    TEST_ASSERT_EQUAL(80, half.width);
+    TEST_ASSERT_EQUAL(60, half.height);
+    for (const ScenePoint& point : SCENE_POINTS) {
+        TEST_ASSERT_INT_WITHIN(PIXEL_TOLERANCE, point.halfLuma, at(half, point.x / 2, point.y / 2));
+    }
+    freePlanes(&half, 1);
+}
+
+void test_crop_keeps_coefficients() {
+    JpegCropRect rect = { 37, 21, 50, 40 };
+    JpegCropRect aligned;
+    TEST_ASSERT_TRUE(jpegTranscoder.alignCropRect(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, rect, &aligned));
+    // Expanded outward to the 16x8 MCU grid
+    TEST_ASSERT_EQUAL(32, aligned.x);
+    TEST_ASSERT_EQUAL(16, aligned.y);
+    TEST_ASSERT_EQUAL(64, aligned.width);
+    TEST_ASSERT_EQUAL(48, aligned.height);
+
+    camera_fb_t fb = sceneFrame();
+    uint8_t* cropped = nullptr;
+    size_t croppedSize = 0;
+    TEST_ASSERT_TRUE(jpegTranscoder.crop(&fb, rect, &cropped, &croppedSize));
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(cropped, croppedSize, &info));
+    TEST_ASSERT_EQUAL(aligned.width, info.width);
+    TEST_ASSERT_EQUAL(aligned.height, info.height);
+
+    // Same blocks, so the same pixels as the matching part of the full frame
+    JpegPlane full, part;
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_FULL, &full, 1));
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(cropped, croppedSize, JPEG_SCALE_FULL, &part, 1));
+    for (int y = 0; y < aligned.height; y++) {
+        TEST_ASSERT_EQUAL_MEMORY(full.data + (aligned.y + y) * full.stride + aligned.x, part.data + y * part.stride,
+                                 aligned.width);
+    }
+    freePlanes(&full, 1);
+    freePlanes(&part, 1);
+    free(cropped);
+
+    JpegTranscodeStats stats = jpegTranscoder.getStats();
+    TEST_ASSERT_EQUAL(1, stats.transcodes);
+    TEST_ASSERT_EQUAL(croppedSize, stats.bytesOut);
+}
+
+void test_downscale_matches_a_scaled_decode() {
+    camera_fb_t fb = sceneFrame();
+    const JpegScale scales[] = { JPEG_SCALE_HALF, JPEG_SCALE_QUARTER, JPEG_SCALE_EIGHTH };
+    for (JpegScale scale : scales) {
+        uint8_t* small = nullptr;
+        size_t smallSize = 0;
+        TEST_ASSERT_TRUE(jpegTranscoder.downscale(&fb, scale, &small, &smallSize));
+        TEST_ASSERT_LESS_THAN(TEST_SCENE_JPEG_LENGTH, smallSize);
+        JpegInfo info;
+        TEST_ASSERT_TRUE(jpegTranscoder.getInfo(small, smallSize, &info));
+        TEST_ASSERT_EQUAL(160 / scale, info.width);
+        TEST_ASSERT_EQUAL(120 / scale, info.height);
+
+        JpegPlane reference, decoded;
+        TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, scale, &reference, 1));
+        TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(small, smallSize, JPEG_SCALE_FULL, &decoded, 1));
+        long error = 0;
+        for (int y = 0; y < info.height; y++) {
+            for (int x = 0; x < info.width; x++) error += abs(at(reference, x, y) - at(decoded, x, y));
+        }
+        // Requantized with the source tables: a few levels apart on average
+        TEST_ASSERT_LESS_OR_EQUAL(5 * info.width * info.height, error);
+        freePlanes(&reference, 1);
+        freePlanes(&decoded, 1);
+        free(small);
+    }
+}
+
+void test_truncated_input() {
+    // Cut in the headers: rejected without output
+    JpegTranscodeOptions options = plainOptions();
+    options.scale = JPEG_SCALE_HALF;
+    uint8_t* output = (uint8_t*)1;
+    size_t outputSize = 1;
+    TEST_ASSERT_FALSE(jpegTranscoder.transcode(TEST_SCENE_JPEG, 300, options, &output, &outputSize));
+    TEST_ASSERT_NULL(output);
+    TEST_ASSERT_EQUAL(0, outputSize);
+    JpegPlane plane;
+    TEST_ASSERT_FALSE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, 300, JPEG_SCALE_FULL, &plane, 1));
+    TEST_ASSERT_NULL(plane.data);
+    TEST_ASSERT_EQUAL(1, jpegTranscoder.getStats().failures);
+
+    // Cut in the scan: the rest decodes as zeros, like libjpeg
+    TEST_ASSERT_TRUE(jpegTranscoder.transcode(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH / 2, options, &output, &outputSize));
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(output, outputSize, &info));
+    TEST_ASSERT_EQUAL(80, info.width);
+    free(output);
+}
+
+// Encoder whose output follows a power law in the quantization scale, down to a floor
+struct ModelEncoder {
+    double sizeAtUnitScale;
+    double exponent;
+    size_t floor;
+    int calls;
+};
+
+static bool modelEncode(void* context, float quantScale, uint8_t** output, size_t* outputSize) {
+    ModelEncoder* model = (ModelEncoder*)context;
+    model->calls++;
+    *outputSize = std::max(model->floor, (size_t)(model->sizeAtUnitScale * pow(quantScale, -model->exponent)));
+    *output = (uint8_t*)malloc(*outputSize);
+    return *output != nullptr;
+}
+
+void test_budget_search_converges_in_three_encodes() {
+    const size_t budgets[] = { 4000, 12000, 30000 };
+    for (size_t budget : budgets) {
+        // The estimate's exponent is off, so the search has to correct it
+        ModelEncoder model = { 20000, 1.3, 500, 0 };
+        JpegRateEstimate estimate = { 20000, 1.0, 0.8, 0.2, false };
+        uint8_t* output = nullptr;
+        size_t outputSize = 0;
+        JpegBudgetResult result;
+        TEST_ASSERT_TRUE(jpegTranscoder.encodeToBudget(modelEncode, &model, budget, estimate, &output, &outputSize, &result));
+        TEST_ASSERT_TRUE(result.withinBudget);
+        TEST_ASSERT_LESS_OR_EQUAL(budget, outputSize);
+        TEST_ASSERT_GREATER_OR_EQUAL(budget * 8 / 10, outputSize);
+        TEST_ASSERT_EQUAL(outputSize, result.size);
+        TEST_ASSERT_EQUAL(model.calls, result.encodes);
+        TEST_ASSERT_LESS_OR_EQUAL(3, result.encodes);
+        free(output);
+    }
+}
+
+void test_unreachable_budget_returns_the_smallest_encode() {
+    ModelEncoder model = { 20000, 1.0, 6000, 0 };
+    JpegRateEstimate estimate = { 20000, 1.0, 1.0, 0.2, false };
+    uint8_t* output = nullptr;
+    size_t outputSize = 0;
+    JpegBudgetResult result;
+    TEST_ASSERT_TRUE(jpegTranscoder.encodeToBudget(modelEncode, &model, 3000, estimate, &output, &outputSize, &result));
+    TEST_ASSERT_FALSE(result.withinBudget);
+    TEST_ASSERT_EQUAL(6000, outputSize);
+    TEST_ASSERT_LESS_OR_EQUAL(3, result.encodes);
+    free(output);
+}
+
+void test_fit_to_budget_requantizes_the_capture() {
+    const size_t budget = TEST_SCENE_JPEG_LENGTH * 6 / 10;
+    uint8_t* output = nullptr;
+    size_t outputSize = 0;
+    JpegBudgetResult result;
+    TEST_ASSERT_TRUE(jpegTranscoder.fitToBudget(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, budget, &output, &outputSize, &result));
+    TEST_ASSERT_TRUE(result.withinBudget);
+    TEST_ASSERT_LESS_OR_EQUAL(budget, outputSize);
+    TEST_ASSERT_TRUE(result.quantScale > 1.0f);
+    TEST_ASSERT_LESS_OR_EQUAL(3, result.encodes);
+    JpegPlane plane;
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(output, outputSize, JPEG_SCALE_FULL, &plane, 1));
+    TEST_ASSERT_EQUAL(160, plane.width);
+    TEST_ASSERT_INT_WITHIN(12, SCENE_POINTS[0].luma, at(plane, SCENE_POINTS[0].x, SCENE_POINTS[0].y));
+    freePlanes(&plane, 1);
+    free(output);
+
+    // Already small enough: an untouched copy
+    TEST_ASSERT_TRUE(jpegTranscoder.fitToBudget(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, TEST_SCENE_JPEG_LENGTH,
+                                                &output, &outputSize, &result));
+    TEST_ASSERT_EQUAL(0, result.encodes);
+    TEST_ASSERT_EQUAL(TEST_SCENE_JPEG_LENGTH, outputSize);
+    TEST_ASSERT_EQUAL_MEMORY(TEST_SCENE_JPEG, output, outputSize);
+    free(output);
+}
+
+void test_quant_scale_maps_to_libjpeg_quality() {
+    TEST_ASSERT_EQUAL(50, JpegTranscoder::quantScaleToQuality(1.0f));
+    TEST_ASSERT_EQUAL(75, JpegTranscoder::quantScaleToQuality(0.5f));
+    TEST_ASSERT_EQUAL(25, JpegTranscoder::quantScaleToQuality(2.0f));
+    TEST_ASSERT_EQUAL(100, JpegTranscoder::quantScaleToQuality(0.0f));
+    TEST_ASSERT_EQUAL(1, JpegTranscoder::quantScaleToQuality(100.0f));
+}
+
+static bool hasMarker(const uint8_t* jpeg, size_t length, uint8_t first, uint8_t last) {
+    // Walks the segments before the scan
+    size_t i = 2;
+    while (i + 4 <= length && jpeg[i] == 0xFF) {
+        uint8_t marker = jpeg[i + 1];
+        if (marker >= first && marker <= last) return true;
+        if (marker == 0xDA) break;
+        i += 2 + (jpeg[i + 2] << 8 | jpeg[i + 3]);
+    }
+    return false;
+}
+
+void test_optimize_is_lossless_and_smaller() {
+    TEST_ASSERT_TRUE(hasMarker(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, 0xE0, 0xEF));
+    uint8_t* output = nullptr;
+    size_t outputSize = 0;
+    TEST_ASSERT_TRUE(jpegTranscoder.optimize(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, 0, &output, &outputSize));
+    TEST_ASSERT_LESS_THAN(TEST_SCENE_JPEG_LENGTH, outputSize);
+    TEST_ASSERT_FALSE(hasMarker(output, outputSize, 0xE0, 0xEF));
+    TEST_ASSERT_FALSE(hasMarker(output, outputSize, 0xFE, 0xFE));
+
+    JpegPlane source[3], optimized[3];
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_FULL, source, 3));
+    TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(output, outputSize, JPEG_SCALE_FULL, optimized, 3));
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(source[i].stride, optimized[i].stride);
+        TEST_ASSERT_EQUAL_MEMORY(source[i].data, optimized[i].data, source[i].stride * source[i].height);
+    }
+    freePlanes(source, 3);
+    freePlanes(optimized, 3);
+
+    // Optimizing again changes nothing more
+    uint8_t* again = nullptr;
+    size_t againSize = 0;
+    TEST_ASSERT_TRUE(jpegTranscoder.optimize(output, outputSize, 0, &again, &againSize));
+    TEST_ASSERT_EQUAL(outputSize, againSize);
+    free(again);
+    free(output);
+}
+
+void test_optimize_gives_up_past_its_time_limit() {
+    uint8_t* output = (uint8_t*)1;
+    size_t outputSize = 1;
+    TEST_ASSERT_FALSE(jpegTranscoder.optimize(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, 1, &output, &outputSize));
+    TEST_ASSERT_NULL(output);
+    TEST_ASSERT_EQUAL(0, outputSize);
+}
+
+// ===================
+// Benchmark: transcode against a libjpeg decode, resize and encode
+// ===================
+
+static const int BENCH_RUNS = 50;
+
+static void report(const char* format, ...) {
+    char line[160];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    TEST_MESSAGE(line);
+}
+
+// Reference path in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegHalfScale(const uint8_t* jpeg, size_t length, int quality, uint8_t** output, size_t* outputSize);
+bool libjpegEncodeScene(int width, int height, int quality, bool subsample420, unsigned seed,
+                        uint8_t** output, size_t* outputSize);
+
+// Mean luma error against a half-scale decode of the source
+static float halfScaleError(const uint8_t* jpeg, size_t length) {
+    JpegPlane reference, decoded;
+    jpegTranscoder.decodePlanes(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_HALF, &reference, 1);
+    if (!jpegTranscoder.decodePlanes(jpeg, length, JPEG_SCALE_FULL, &decoded, 1)) {
+        freePlanes(&reference, 1);
+        return 255;
+    }
+    long error = 0;
+    for (int y = 0; y < reference.height; y++) {
+        for (int x = 0; x < reference.width; x++) error += abs(at(reference, x, y) - at(decoded, x, y));
+    }
+    float mean = (float)error / (reference.width * reference.height);
+    freePlanes(&reference, 1);
+    freePlanes(&decoded, 1);
+    return mean;
+}
+
+// Prints time and size of both paths; only correctness is asserted, as the
+// sanitizer build instruments the transcoder and not the system libjpeg
+void test_benchmark_transcode_against_decode_resize_encode() {
+    JpegTranscodeOptions options = plainOptions();
+    options.scale = JPEG_SCALE_HALF;
+    int quality = JpegTranscoder::quantScaleToQuality(options.quantScale);
+
+    uint8_t* transcoded = nullptr;
+    size_t transcodedSize = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_RUNS; i++) {
+        free(transcoded);
+        TEST_ASSERT_TRUE(jpegTranscoder.transcode(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, options,
+                                                  &transcoded, &transcodedSize));
+    }
+    double transcodeMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    uint8_t* reencoded = nullptr;
+    size_t reencodedSize = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_RUNS; i++) {
+        free(reencoded);
+        TEST_ASSERT_TRUE(libjpegHalfScale(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, quality, &reencoded, &reencodedSize));
+    }
+    double reencodeMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(transcoded, transcodedSize, &info));
+    TEST_ASSERT_EQUAL(80, info.width);
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(reencoded, reencodedSize, &info));
+    TEST_ASSERT_EQUAL(80, info.width);
+    float transcodeError = halfScaleError(transcoded, transcodedSize);
+    float reencodeError = halfScaleError(reencoded, reencodedSize);
+    TEST_ASSERT_LESS_OR_EQUAL(5, (int)transcodeError);
+
+    report("Half scale, %d runs, source %u bytes", BENCH_RUNS, (unsigned)TEST_SCENE_JPEG_LENGTH);
+    report("  transcode:                 %7.1f us/frame, %5u bytes, luma error %.2f",
+           transcodeMicros / BENCH_RUNS, (unsigned)transcodedSize, transcodeError);
+    report("  libjpeg decode/resize/enc: %7.1f us/frame, %5u bytes, luma error %.2f (quality %d)",
+           reencodeMicros / BENCH_RUNS, (unsigned)reencodedSize, reencodeError, quality);
+    free(transcoded);
+    free(reencoded);
+}
+
+// Prints the saving and cost of optimize() over a corpus of libjpeg encodes,
+// QVGA to SXGA, quality 70-92, 4:2:0 and 4:2:2; every output must decode
+// to the same pixels as its source
+void test_benchmark_optimize_corpus() {
+    const int sizes[][2] = { { 320, 240 }, { 640, 480 }, { 800, 600 }, { 1024, 768 }, { 1280, 1024 } };
+    const int qualities[] = { 70, 80, 92 };
+    size_t totalIn = 0, totalOut = 0;
+    double totalMicros = 0, minSaving = 100, maxSaving = 0;
+    int images = 0;
+    unsigned seed = 1;
+
+    for (auto& size : sizes) {
+        for (int quality : qualities) {
+            for (bool subsample420 : { true, false }) {
+                uint8_t* source = nullptr;
+                size_t sourceSize = 0;
+                TEST_ASSERT_TRUE(libjpegEncodeScene(size[0], size[1], quality, subsample420, seed++, &source, &sourceSize));
+
+                uint8_t* output = nullptr;
+                size_t outputSize = 0;
+                auto start = std::chrono::steady_clock::now();
+                TEST_ASSERT_TRUE(jpegTranscoder.optimize(source, sourceSize, 0, &output, &outputSize));
+                totalMicros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+                JpegPlane before[3], after[3];
+                TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(source, sourceSize, JPEG_SCALE_FULL, before, 3));
+                TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(output, outputSize, JPEG_SCALE_FULL, after, 3));
+                for (int i = 0; i < 3; i++) {
+                    TEST_ASSERT_EQUAL_MEMORY(before[i].data, after[i].data, before[i].stride * before[i].height);
+                }
+                freePlanes(before, 3);
+                freePlanes(after, 3);
+
+                double saving = 100.0 * (sourceSize - outputSize) / sourceSize;
+                minSaving = std::min(minSaving, saving);
+                maxSaving = std::max(maxSaving, saving);
+                totalIn += sourceSize;
+                totalOut += outputSize;
+                images++;
+                free(source);
+                free(output);
+            }
+        }
+    }
+
+    report("optimize over %d images: %u -> %u bytes, %.1f%% saved (%.1f-%.1f%% per image), %.1f us/KB",
+           images, (unsigned)totalIn, (unsigned)totalOut, 100.0 * (totalIn - totalOut) / totalIn,
+           minSaving, maxSaving, totalMicros / (totalIn / 1024.0));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_reads_stream_info);
+    RUN_TEST(test_decode_matches_libjpeg);
+    RUN_TEST(test_crop_keeps_coefficients);
+    RUN_TEST(test_downscale_matches_a_scaled_decode);
+    RUN_TEST(test_truncated_input);
+    RUN_TEST(test_budget_search_converges_in_three_encodes);
+    RUN_TEST(test_unreachable_budget_returns_the_smallest_encode);
+    RUN_TEST(test_fit_to_budget_requantizes_the_capture);
+    RUN_TEST(test_quant_scale_maps_to_libjpeg_quality);
+    RUN_TEST(test_optimize_is_lossless_and_smaller);
+    RUN_TEST(test_optimize_gives_up_past_its_time_limit);
+    RUN_TEST(test_benchmark_transcode_against_decode_resize_encode);
+    RUN_TEST(test_benchmark_optimize_corpus);
+    return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include "keyword_matcher.cpp"
+#include "host_runtime.h"
+
+// The String::indexOf() checks the matcher replaced, made case-insensitive
+static bool indexOfHazard(String text) {
+    text.toLowerCase();
+    return text.indexOf("hazard") >= 0 || text.indexOf("danger") >= 0 ||
+           text.indexOf("warning") >= 0 || text.indexOf("obstacle") >= 0 ||
+           text.indexOf("fire") >= 0 || text.indexOf("caution") >= 0 ||
+           text.indexOf("risk") >= 0 || text.indexOf("unsafe") >= 0;
+}
+
+static String indexOfDirection(String text) {
+    text.toLowerCase();
+    if (text.indexOf("right") >= 0) return "right";
+    if (text.indexOf("left") >= 0) return "left";
+    if (text.indexOf("front") >= 0) return "front";
+    if (text.indexOf("behind") >= 0) return "behind";
+    return "";
+}
+
+static bool indexOfWarning(String text) {
+    text.toLowerCase();
+    return text.indexOf("warning") >= 0 || text.indexOf("danger") >= 0 ||
+           text.indexOf("caution") >= 0 || text.indexOf("stop") >= 0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_finds_hazard_and_direction() {
+    KeywordMatches matches;
+    TEST_ASSERT_TRUE(keywordMatcher.classify(String("There is an open manhole, Danger, to your LEFT."), &matches));
+    TEST_ASSERT_TRUE(matches.categories & KEYWORD_HAZARD);
+    TEST_ASSERT_TRUE(matches.categories & KEYWORD_WARNING);
+    TEST_ASSERT_EQUAL(DIRECTION_LEFT, matches.direction);
+    TEST_ASSERT_EQUAL_STRING("danger", KeywordMatcher::keyword(matches.hazard));
+}
+
+void test_plain_caption_matches_nothing() {
+    KeywordMatches matches;
+    TEST_ASSERT_TRUE(keywordMatcher.classify(String("A person walking a dog on a sunny day."), &matches));
+    TEST_ASSERT_EQUAL(0, matches.categories);
+    TEST_ASSERT_EQUAL(0, matches.keywords);
+    TEST_ASSERT_EQUAL(DIRECTION_NONE, matches.direction);
+    TEST_ASSERT_EQUAL(-1, matches.hazard);
+}
+
+void test_matches_substrings_and_overlaps() {
+    // "bright" holds "right", which indexOf() found as well
+    KeywordMatches matches;
+    TEST_ASSERT_TRUE(keywordMatcher.classify(String("A bright sign that says STOP"), &matches));
+    TEST_ASSERT_EQUAL(DIRECTION_RIGHT, matches.direction);
+    TEST_ASSERT_TRUE(matches.categories & KEYWORD_SIGN);
+    TEST_ASSERT_TRUE(matches.categories & KEYWORD_TEXT);
+    TEST_ASSERT_TRUE(matches.categories & KEYWORD_WARNING);
+    TEST_ASSERT_FALSE(matches.categories & KEYWORD_HAZARD);
+}
+
+void test_direction_follows_table_order() {
+    KeywordMatches matches;
+    TEST_ASSERT_TRUE(keywordMatcher.classify(String("behind you and to the left"), &matches));
+    TEST_ASSERT_EQUAL(DIRECTION_LEFT, matches.direction);
+}
+
+// Captions made of words from the result texts, keywords in mixed case among them
+static std::vector<String> randomCaptions(int count) {
+    const char* words[] = { "a", "the", "person", "walking", "on", "sidewalk", "with", "car", "parked", "to",
+                            "your", "Right", "left", "in", "Front", "of", "you", "behind", "there", "is", "an",
+                            "Obstacle", "open", "manhole", "Warning", "sign", "reads", "Stop", "construction",
+                            "area", "fire", "hydrant", "bright", "sunny", "day", "Caution", "wet", "floor",
+                            "stairs", "risk", "tripping", "unsafe", "Danger", "high", "voltage", "text", "says",
+                            "exit", "written", "window", "dog", "traffic", "light", "green", "red" };
+    const int wordCount = sizeof(words) / sizeof(words[0]);
+    std::mt19937 rng(7);
+    std::vector<String> captions;
+    for (int i = 0; i < count; i++) {
+        std::string text;
+        int length = 6 + rng() % 40;
+        for (int j = 0; j < length; j++) {
+            if (j) text += ' ';
+            text += words[rng() % wordCount];
+        }
+        captions.push_back(String(text.c_str()));
+    }
+    return captions;
+}
+
+void test_agrees_with_index_of_checks() {
+    for (const String& result : randomCaptions(2000)) {
+        KeywordMatches matches;
+        TEST_ASSERT_TRUE(keywordMatcher.classify(result, &matches));
+        TEST_ASSERT_EQUAL(indexOfHazard(result), (matches.categories & KEYWORD_HAZARD) != 0);
+        TEST_ASSERT_EQUAL(indexOfWarning(result), (matches.categories & KEYWORD_WARNING) != 0);
+        TEST_ASSERT_EQUAL_STRING(indexOfDirection(result).c_str(), KeywordMatcher::directionName(matches.direction));
+    }
+}
+
+// Prints the time per caption of both; timings are not asserted
+void test_benchmark_against_index_of_checks() {
+    std::vector<String> captions = randomCaptions(2000);
+    const int rounds = 10;
+    int hits = 0, indexOfHits = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const String& result : captions) {
+            KeywordMatches matches;
+            keywordMatcher.classify(result, &matches);
+            hits += (matches.categories & KEYWORD_HAZARD) != 0;
+            hits += (matches.categories & KEYWORD_WARNING) != 0;
+            hits += matches.direction != DIRECTION_NONE;
+        }
+    }
+    double matcherMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const String& result : captions) {
+            indexOfHits += indexOfHazard(result);
+            indexOfHits += indexOfWarning(result);
+            indexOfHits += indexOfDirection(result).length() > 0;
+        }
+    }
+    double indexOfMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL(indexOfHits, hits);
+    int runs = rounds * captions.size();
+    char line[160];
+    snprintf(line, sizeof(line), "%d captions: matcher %.2f us each, indexOf checks %.2f us each",
+             runs, matcherMicros / runs, indexOfMicros / runs);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_finds_hazard_and_direction);
+    RUN_TEST(test_plain_caption_matches_nothing);
+    RUN_TEST(test_matches_substrings_and_overlaps);
+    RUN_TEST(test_direction_follows_table_order);
+    RUN_TEST(test_agrees_with_index_of_checks);
+    RUN_TEST(test_benchmark_against_index_of_checks);
+    return UNITY_END();
+}
@@ -0,0 +1,404 @@
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "looming_detector.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+
+// ===================
+// Collaborator stand-ins: a camera serving synthetic frames and recorded alerts
+// ===================
+
+static std::mutex fakeLock;
+static OperationMode fakeMode = MODE_HAZARD_DETECTION;
+static std::vector<std::vector<uint8_t>> fakeFrames;
+static size_t fakeNextFrame = 0;
+static camera_fb_t fakeBuffer;
+static std::atomic<int> hapticPatterns(0);
+static std::vector<String> spokenAlerts;
+
+CameraManager::CameraManager() {}
+OperationMode CameraManager::getActiveProfileMode() { return fakeMode; }
+bool CameraManager::isReady() { return true; }
+
+camera_fb_t* CameraManager::grabPreviewFrame() {
+    std::lock_guard<std::mutex> guard(fakeLock);
+    if (fakeNextFrame >= fakeFrames.size()) return nullptr;
+    std::vector<uint8_t>& frame = fakeFrames[fakeNextFrame++];
+    fakeBuffer.buf = frame.data();
+    fakeBuffer.len = frame.size();
+    fakeBuffer.format = PIXFORMAT_JPEG;
+    return &fakeBuffer;
+}
+
+void CameraManager::releaseFrameBuffer(camera_fb_t*) {}
+
+AIProcessor::AIProcessor() {}
+void AIProcessor::updateStatusLEDs(bool, bool, bool) {}
+void AIProcessor::provideHapticFeedback(int pattern) { hapticPatterns += pattern; }
+
+Mp3StreamDecoder::Mp3StreamDecoder() {}
+Mp3StreamDecoder::~Mp3StreamDecoder() {}
+AudioManager::AudioManager() {}
+AudioManager::~AudioManager() {}
+void AudioManager::playHazardAlert(const String& hazardType, const String& direction) {
+    std::lock_guard<std::mutex> guard(fakeLock);
+    spokenAlerts.push_back(hazardType + " " + direction);
+}
+
+CameraManager cameraManager;
+AIProcessor aiProcessor;
+AudioManager audioManager;
+
+// ===================
+// Synthetic frames
+// ===================
+
+static const int FRAME_WIDTH = 160;
+static const int FRAME_HEIGHT = 120;
+static const int FRAME_INTERVAL = 100;    // ms
+
+// Baseline grayscale JPEG built from the transcoder's own DCT and entropy coder
+static std::vector<uint8_t> encodeGray(const uint8_t* pixels, int width, int height) {
+    initDctBasis();
+    JpegStream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.width = width;
+    stream.height = height;
+    stream.componentCount = 1;
+    stream.comp[0] = { 1, 1, 1, 0, 0, 0, 0 };
+    uint16_t quant[4][64];
+    for (int k = 0; k < 64; k++) quant[0][k] = 2;
+    HuffmanSpec dcSpecs[2], acSpecs[2];
+    standardTables(dcSpecs, acSpecs);
+
+    OutputBuffer out;
+    out.begin(16384);
+    writeHeaders(out, stream, quant, width, height, dcSpecs, acSpecs, false);
+    ScanEncoder encoder;
+    encoder.begin(&out, dcSpecs, acSpecs, 1);
+    int16_t block[64];
+    for (int y = 0; y < height; y += 8) {
+        for (int x = 0; x < width; x += 8) {
+            forwardBlock(pixels + y * width + x, width, quant[0], block);
+            encoder.encodeBlock(block, 0, 0);
+        }
+    }
+    encoder.finish();
+    out.put(0xFF);
+    out.put(0xD9);
+    std::vector<uint8_t> jpeg(out.data, out.data + out.size);
+    out.release();
+    return jpeg;
+}
+
+// Smooth texture: a sum of plane waves of 12 to 40 pixel wavelength
+static float texture(float u, float v) {
+    static const float waves[6][4] = {
+        { 0.9f, 0.4f, 14, 0.0f }, { -0.3f, 0.95f, 22, 1.3f }, { 0.7f, -0.7f, 31, 2.1f },
+        { 0.2f, 0.98f, 12, 0.7f }, { -0.85f, -0.5f, 40, 4.0f }, { 1.0f, 0.0f, 19, 5.2f }
+    };
+    float value = 128;
+    for (const auto& w : waves) value += 16 * sinf((w[0] * u + w[1] * v) * 2 * (float)M_PI / w[2] + w[3]);
+    return value;
+}
+
+// The texture magnified by `scale` about (centreX, centreY) and shifted by (shiftX, shiftY)
+static std::vector<uint8_t> frame(float scale, float centreX, float centreY, float shiftX, float shiftY) {
+    std::vector<uint8_t> pixels(FRAME_WIDTH * FRAME_HEIGHT);
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            float u = centreX + (x - centreX) / scale + shiftX;
+            float v = centreY + (y - centreY) / scale + shiftY;
+            pixels[y * FRAME_WIDTH + x] = constrain((int)lroundf(texture(u, v)), 0, 255);
+        }
+    }
+    return encodeGray(pixels.data(), FRAME_WIDTH, FRAME_HEIGHT);
+}
+
+// Only the rows from `firstRow` down magnified, as the floor does while walking
+static std::vector<uint8_t> floorFrame(int index, float contact, int firstRow) {
+    float scale = contact / (contact - index * FRAME_INTERVAL / 1000.0f);
+    std::vector<uint8_t> pixels(FRAME_WIDTH * FRAME_HEIGHT);
+    for (int y = 0; y < FRAME_HEIGHT; y++) {
+        for (int x = 0; x < FRAME_WIDTH; x++) {
+            float s = y >= firstRow ? scale : 1;
+            float u = FRAME_WIDTH / 2 + (x - FRAME_WIDTH / 2) / s;
+            float v = FRAME_HEIGHT - (FRAME_HEIGHT - y) / s;
+            pixels[y * FRAME_WIDTH + x] = constrain((int)lroundf(texture(u, v)), 0, 255);
+        }
+    }
+    return encodeGray(pixels.data(), FRAME_WIDTH, FRAME_HEIGHT);
+}
+
+// Walking towards a wall, `contact` seconds away at the first frame
+static std::vector<uint8_t> approachFrame(int index, float contact) {
+    float elapsed = index * FRAME_INTERVAL / 1000.0f;
+    return frame(contact / (contact - elapsed), FRAME_WIDTH / 2, FRAME_HEIGHT / 2, 0, 0);
+}
+
+void setUp() {
+    fakeMode = MODE_HAZARD_DETECTION;
+    fakeFrames.clear();
+    fakeNextFrame = 0;
+    hapticPatterns = 0;
+    spokenAlerts.clear();
+}
+
+void tearDown() {}
+
+void test_approaching_wall_raises_one_alert_in_time() {
+    const float contact = 3.5f;
+    LoomingDetector detector;
+    int alerts = 0;
+    for (int i = 0; i < 24; i++) {
+        std::vector<uint8_t> jpeg = approachFrame(i, contact);
+        float truth = contact - i * FRAME_INTERVAL / 1000.0f;
+        if (detector.processFrame(jpeg.data(), jpeg.size(), 1000 + i * FRAME_INTERVAL)) {
+            alerts++;
+            // Alert once two frames agree the wall is under LOOMING_ALERT_TTC
+            TEST_ASSERT_FLOAT_WITHIN(0.25f, LOOMING_ALERT_TTC + 0.05f, truth);
+            TEST_ASSERT_LESS_THAN(LOOMING_GRID_ROWS - LOOMING_IGNORE_BOTTOM_ROWS, detector.getAlertRegion() / LOOMING_GRID_COLS);
+            TEST_ASSERT_TRUE(detector.getAlertDirection().length() > 0);
+        }
+        // Once the smoothing has settled, every region tracks the true time to contact
+        for (int r = 0; i >= 8 && r < LOOMING_REGION_COUNT; r++) {
+            TEST_ASSERT_FLOAT_WITHIN(0.15f * truth, truth, detector.getRegion(r).timeToCollision);
+            TEST_ASSERT_GREATER_THAN(LOOMING_MIN_TEXTURE, detector.getRegion(r).texture);
+        }
+    }
+    // The rest of the approach falls within LOOMING_ALERT_COOLDOWN
+    TEST_ASSERT_EQUAL(1, alerts);
+    LoomingStats stats = detector.getStats();
+    TEST_ASSERT_EQUAL(1, stats.alerts);
+    TEST_ASSERT_EQUAL(24, stats.frames);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 1.2f, stats.minTimeToCollision);
+}
+
+void test_head_turn_and_bobbing_do_not_alert() {
+    LoomingDetector detector;
+    for (int i = 0; i < 20; i++) {
+        std::vector<uint8_t> jpeg = frame(1, FRAME_WIDTH / 2, FRAME_HEIGHT / 2, i * 1.5f, 2 * sinf(i));
+        TEST_ASSERT_FALSE(detector.processFrame(jpeg.data(), jpeg.size(), 1000 + i * FRAME_INTERVAL));
+        for (int r = 0; r < LOOMING_REGION_COUNT; r++) {
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, 0, detector.getRegion(r).expansion);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, detector.getStats().alerts);
+}
+
+void test_expanding_floor_does_not_alert() {
+    // Floor a second away filling the bottom region row
+    LoomingDetector detector;
+    const int bottomRow = LOOMING_GRID_ROWS - LOOMING_IGNORE_BOTTOM_ROWS;
+    for (int i = 0; i < 8; i++) {
+        std::vector<uint8_t> jpeg = floorFrame(i, 1.5f, bottomRow * FRAME_HEIGHT / LOOMING_GRID_ROWS);
+        TEST_ASSERT_FALSE(detector.processFrame(jpeg.data(), jpeg.size(), 1000 + i * FRAME_INTERVAL));
+    }
+    const LoomingRegion& floor = detector.getRegion(bottomRow * LOOMING_GRID_COLS + 1);
+    TEST_ASSERT_TRUE(floor.timeToCollision > 0 && floor.timeToCollision < LOOMING_ALERT_TTC);
+    TEST_ASSERT_EQUAL(0, floor.confirmations);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0, detector.getRegion(1).expansion);
+}
+
+void test_gaps_and_profile_switches_restart_the_estimate() {
+    LoomingDetector detector;
+    for (int i = 0; i < 5; i++) {
+        std::vector<uint8_t> jpeg = approachFrame(i, 3.5f);
+        detector.processFrame(jpeg.data(), jpeg.size(), 1000 + i * FRAME_INTERVAL);
+    }
+    TEST_ASSERT_GREATER_THAN(0, detector.getRegion(5).timeToCollision);
+
+    // Too long since the last frame for the derivatives to hold
+    std::vector<uint8_t> jpeg = approachFrame(5, 3.5f);
+    detector.processFrame(jpeg.data(), jpeg.size(), 1400 + LOOMING_MAX_FRAME_GAP + 100);
+    TEST_ASSERT_EQUAL_FLOAT(0, detector.getRegion(5).timeToCollision);
+    jpeg = approachFrame(6, 3.5f);
+    detector.processFrame(jpeg.data(), jpeg.size(), 1500 + LOOMING_MAX_FRAME_GAP + 200);
+    TEST_ASSERT_GREATER_THAN(0, detector.getRegion(5).timeToCollision);
+
+    // A different frame size means another profile and field of view
+    std::vector<uint8_t> pixels(96 * 72, 128);
+    for (int i = 0; i < 96 * 72; i++) pixels[i] = texture(i % 96, i / 96);
+    jpeg = encodeGray(pixels.data(), 96, 72);
+    detector.processFrame(jpeg.data(), jpeg.size(), 1800 + LOOMING_MAX_FRAME_GAP);
+    TEST_ASSERT_EQUAL_FLOAT(0, detector.getRegion(5).timeToCollision);
+
+    // Undecodable frames are skipped without touching the estimate
+    TEST_ASSERT_FALSE(detector.processFrame(jpeg.data(), 50, 1900 + LOOMING_MAX_FRAME_GAP));
+    LoomingStats stats = detector.getStats();
+    TEST_ASSERT_EQUAL(1, stats.skippedFrames);
+    TEST_ASSERT_EQUAL(8, stats.frames);
+}
+
+void test_task_alerts_through_haptics_and_speech() {
+    for (int i = 0; i < 24; i++) fakeFrames.push_back(approachFrame(i, 3.5f));
+    LoomingDetector detector;
+    TEST_ASSERT_TRUE(detector.begin());
+    delay(24 * FRAME_INTERVAL + 300);
+    detector.end();
+    TEST_ASSERT_FALSE(detector.isActive());
+
+    LoomingStats stats = detector.getStats();
+    TEST_ASSERT_EQUAL(24, stats.frames);
+    TEST_ASSERT_GREATER_THAN(0, stats.busyFrames);
+    TEST_ASSERT_EQUAL(1, stats.alerts);
+    TEST_ASSERT_EQUAL(24, detector.getProfileStats(MODE_HAZARD_DETECTION).frames);
+    TEST_ASSERT_EQUAL(4, hapticPatterns.load());
+    TEST_ASSERT_EQUAL(1, spokenAlerts.size());
+    // The wall fills the view, so any direction is right
+    String spoken = spokenAlerts[0];
+    TEST_ASSERT_TRUE(spoken == "obstacle left" || spoken == "obstacle ahead" || spoken == "obstacle right");
+}
+
+void test_task_takes_no_frames_while_reading() {
+    fakeMode = MODE_OCR;
+    fakeFrames.push_back(approachFrame(0, 3.5f));
+    LoomingDetector detector;
+    TEST_ASSERT_TRUE(detector.begin());
+    delay(3 * FRAME_INTERVAL);
+    detector.end();
+    TEST_ASSERT_EQUAL(0, fakeNextFrame);
+    TEST_ASSERT_EQUAL(0, detector.getStats().frames);
+}
+
+// ===================
+// Benchmark: replay of rendered walking sequences
+// ===================
+
+static const int REPLAY_WIDTH = 320;
+static const int REPLAY_HEIGHT = 240;
+static const float REPLAY_FOCAL = 160;    // Pixels, about 90 degrees across
+static const float WALKING_SPEED = 1.2f;  // m/s
+
+// Textured plane facing the camera, `depth` metres ahead at the first frame and
+// `halfWidth` x `halfHeight` metres about (centreX, centreY); a zero half width
+// fills the view
+struct ReplayPlane {
+    float depth;
+    float centreX, centreY;
+    float halfWidth, halfHeight;
+    float speed;              // Closing speed (m/s)
+    float offset;             // Texture phase, so planes do not share a pattern
+};
+
+// One QVGA frame of the planes at time t, nearest first, seen with the head
+// turned by `yaw` and bobbed by `bob` pixels
+static std::vector<uint8_t> replayFrame(const std::vector<ReplayPlane>& planes, float t, float yaw, float bob) {
+    std::vector<uint8_t> pixels(REPLAY_WIDTH * REPLAY_HEIGHT);
+    for (int y = 0; y < REPLAY_HEIGHT; y++) {
+        for (int x = 0; x < REPLAY_WIDTH; x++) {
+            float rayX = (x - REPLAY_WIDTH / 2 - yaw) / REPLAY_FOCAL;
+            float rayY = (y - REPLAY_HEIGHT / 2 - bob) / REPLAY_FOCAL;
+            float value = 128;
+            for (const ReplayPlane& plane : planes) {
+                float depth = plane.depth - plane.speed * t;
+                if (depth <= 0.05f) continue;
+                float worldX = rayX * depth - plane.centreX, worldY = rayY * depth - plane.centreY;
+                if (plane.halfWidth > 0 && (fabsf(worldX) > plane.halfWidth || fabsf(worldY) > plane.halfHeight)) continue;
+                // Two pixels per texture unit when the plane is first seen
+                float unitsPerMetre = REPLAY_FOCAL / plane.depth / 2;
+                value = texture(worldX * unitsPerMetre + plane.offset, worldY * unitsPerMetre + plane.offset);
+                break;
+            }
+            pixels[y * REPLAY_WIDTH + x] = constrain((int)lroundf(value), 0, 255);
+        }
+    }
+    return encodeGray(pixels.data(), REPLAY_WIDTH, REPLAY_HEIGHT);
+}
+
+struct ReplayRun {
+    std::vector<ReplayPlane> planes;  // The obstacle, when there is one, comes first
+    float seconds;
+    float yawRate;            // Pixels per frame of steady head turn
+    bool approach;
+};
+
+// Prints alerts and lead time on approach runs, false alerts on the rest and
+// ms per frame, over 12 rendered approaches and 8 runs without an obstacle ahead.
+// Every run has a 2 Hz head bob and a random yaw drift.
+void test_benchmark_walking_replay() {
+    std::mt19937 rng(35);
+    auto uniform = [&rng](float low, float high) {
+        return low + (high - low) * (rng() % 10000) / 10000.0f;
+    };
+    std::vector<ReplayRun> runs;
+    for (int i = 0; i < 12; i++) {
+        // Poles, people and doors from 3 to 6 s away, up to half a metre off the path
+        float contact = uniform(3, 6);
+        ReplayPlane obstacle = { contact * WALKING_SPEED, uniform(-0.5f, 0.5f), uniform(-0.3f, 0.3f),
+                                 uniform(0.2f, 0.8f), uniform(0.6f, 1.0f), WALKING_SPEED, uniform(0, 50) };
+        ReplayPlane street = { uniform(30, 50), 0, 0, 0, 0, WALKING_SPEED, uniform(0, 50) };
+        runs.push_back({ { obstacle, street }, contact - 0.3f, 0, true });
+    }
+    // Walking an open street, standing, turning the head, and passing obstacles
+    // that leave the view before they get close
+    for (int i = 0; i < 3; i++) {
+        runs.push_back({ { { uniform(40, 60), 0, 0, 0, 0, WALKING_SPEED, uniform(0, 50) } }, 12, 0, false });
+    }
+    runs.push_back({ { { 4, 0, 0, 0, 0, 0, 7 } }, 12, 0, false });
+    runs.push_back({ { { 5, 0, 0, 0, 0, 0, 19 } }, 12, 6, false });
+    runs.push_back({ { { 6, 0, 0, 0, 0, 0, 23 } }, 12, -6, false });
+    for (int side = -1; side <= 1; side += 2) {
+        ReplayPlane passing = { 8, side * 3.4f, 0, 0.4f, 1.0f, WALKING_SPEED, uniform(0, 50) };
+        ReplayPlane street = { 45, 0, 0, 0, 0, WALKING_SPEED, uniform(0, 50) };
+        runs.push_back({ { passing, street }, 12, 0, false });
+    }
+
+    int approaches = 0, alerted = 0, falseAlerts = 0, frames = 0;
+    float minLead = 1e9f, maxLead = 0, otherSeconds = 0;
+    double millis = 0;
+    for (const ReplayRun& run : runs) {
+        LoomingDetector detector;
+        int count = (int)(run.seconds * 1000 / FRAME_INTERVAL);
+        float yaw = 0, lead = -1;
+        int alerts = 0;
+        for (int i = 0; i < count; i++) {
+            float t = i * FRAME_INTERVAL / 1000.0f;
+            yaw += run.yawRate + uniform(-1, 1);
+            float bob = 3 * sinf(2 * (float)M_PI * 2 * t);
+            std::vector<uint8_t> jpeg = replayFrame(run.planes, t, yaw, bob);
+            auto start = std::chrono::steady_clock::now();
+            bool alert = detector.processFrame(jpeg.data(), jpeg.size(), 1000 + i * FRAME_INTERVAL);
+            millis += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            frames++;
+            if (!alert) continue;
+            alerts++;
+            if (run.approach && lead < 0) lead = (run.planes[0].depth - run.planes[0].speed * t) / run.planes[0].speed;
+        }
+        if (run.approach) {
+            approaches++;
+            if (lead >= 0) {
+                alerted++;
+                minLead = min(minLead, lead);
+                maxLead = max(maxLead, lead);
+            }
+        } else {
+            falseAlerts += alerts;
+            otherSeconds += run.seconds;
+        }
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "approaches alerted %d/%d with %.1f-%.1f s to spare; %d false alerts in %.0f s of other walking",
+             alerted, approaches, alerted ? minLead : 0.0f, maxLead, falseAlerts, otherSeconds);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "decode + estimate %.2f ms per QVGA frame over %d frames", millis / frames, frames);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_approaching_wall_raises_one_alert_in_time);
+    RUN_TEST(test_head_turn_and_bobbing_do_not_alert);
+    RUN_TEST(test_expanding_floor_does_not_alert);
+    RUN_TEST(test_gaps_and_profile_switches_restart_the_estimate);
+    RUN_TEST(test_task_alerts_through_haptics_and_speech);
+    RUN_TEST(test_task_takes_no_frames_while_reading);
+    RUN_TEST(test_benchmark_walking_replay);
+    return UNITY_END();
+}
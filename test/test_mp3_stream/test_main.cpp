@@ -0,0 +1,256 @@
+#include <unity.h>
+#include <vector>
+#include "mp3_stream.cpp"
+#include "host_runtime.h"
+
+// ===================
+// Helix stand-in
+// ===================
+
+// Frames built by makeFrame() carry their index and a marker after the header.
+// The stand-in checks that it was handed exactly one whole frame and "decodes"
+// it to a ramp that encodes the index, so the test can tell which frames played.
+struct FakeHelix {
+    MP3FrameInfo info;
+    int calls;
+};
+
+static const uint8_t PAYLOAD_MARK = 0xA5;
+static const uint8_t PAYLOAD_RESERVOIR = 0x5A;   // First frame pointing into a missing bit reservoir
+
+HMP3Decoder MP3InitDecoder(void) { return calloc(1, sizeof(FakeHelix)); }
+void MP3FreeDecoder(HMP3Decoder decoder) { free(decoder); }
+void MP3GetLastFrameInfo(HMP3Decoder decoder, MP3FrameInfo* info) { *info = ((FakeHelix*)decoder)->info; }
+
+int MP3FindSyncWord(unsigned char* buf, int nBytes) {
+    for (int i = 0; i + 1 < nBytes; i++) {
+        if (buf[i] == 0xFF && (buf[i + 1] & 0xE0) == 0xE0) return i;
+    }
+    return -1;
+}
+
+int MP3Decode(HMP3Decoder decoder, unsigned char** inbuf, int* bytesLeft, short* outbuf, int) {
+    FakeHelix* helix = (FakeHelix*)decoder;
+    helix->calls++;
+    Mp3FrameHeader header;
+    if (*bytesLeft < 4 || !Mp3StreamDecoder::parseHeader(*inbuf, &header)) return ERR_MP3_INVALID_FRAMEHEADER;
+    if (*bytesLeft < header.frameBytes) return ERR_MP3_INDATA_UNDERFLOW;
+    const unsigned char* payload = *inbuf + 4;
+    *inbuf += header.frameBytes;
+    *bytesLeft -= header.frameBytes;
+    if (payload[2] == PAYLOAD_RESERVOIR) return ERR_MP3_MAINDATA_UNDERFLOW;
+    if (payload[2] != PAYLOAD_MARK) return ERR_MP3_INVALID_HUFFCODES;
+
+    int index = payload[0] | payload[1] << 8;
+    for (int i = 0; i < header.samples * header.channels; i++) outbuf[i] = (short)(index * 100 + i % 100);
+    helix->info.bitrate = header.bitrate;
+    helix->info.nChans = header.channels;
+    helix->info.samprate = header.sampleRate;
+    helix->info.bitsPerSample = 16;
+    helix->info.outputSamps = header.samples * header.channels;
+    helix->info.layer = 3;
+    helix->info.version = header.samples == 1152 ? 0 : 1;
+    return ERR_MP3_NONE;
+}
+
+// ===================
+// Streams
+// ===================
+
+// MPEG-1 Layer III, 128 kbit/s, 44.1 kHz, joint stereo: 417 bytes, 418 padded
+static const uint8_t STEREO_HEADER[4] = { 0xFF, 0xFB, 0x90, 0x44 };
+// MPEG-2 Layer III, 32 kbit/s, 16 kHz, mono: 144 bytes
+static const uint8_t MONO_HEADER[4] = { 0xFF, 0xF3, 0x48, 0xC4 };
+
+static void makeFrame(std::vector<uint8_t>& stream, const uint8_t* header, int index, uint8_t mark = PAYLOAD_MARK,
+                      bool padded = false) {
+    Mp3FrameHeader parsed;
+    uint8_t bytes[4] = { header[0], header[1], (uint8_t)(header[2] | (padded ? 2 : 0)), header[3] };
+    Mp3StreamDecoder::parseHeader(bytes, &parsed);
+    size_t start = stream.size();
+    stream.insert(stream.end(), bytes, bytes + 4);
+    stream.push_back(index & 0xFF);
+    stream.push_back(index >> 8);
+    stream.push_back(mark);
+    // Filler that never looks like a sync word
+    while (stream.size() < start + parsed.frameBytes) stream.push_back((stream.size() * 37) & 0x7F);
+}
+
+// ID3v2.4 tag with a syncsafe size, optionally followed by a footer
+static void makeTag(std::vector<uint8_t>& stream, uint32_t size, bool footer) {
+    const uint8_t head[10] = { 'I', 'D', '3', 4, 0, (uint8_t)(footer ? 0x10 : 0), (uint8_t)(size >> 21 & 0x7F),
+                               (uint8_t)(size >> 14 & 0x7F), (uint8_t)(size >> 7 & 0x7F), (uint8_t)(size & 0x7F) };
+    stream.insert(stream.end(), head, head + 10);
+    // Tag bodies may contain sync-like bytes; they must not be taken for frames
+    for (uint32_t i = 0; i < size; i++) stream.push_back(i % 50 == 0 ? 0xFF : 0xFB);
+    if (footer) {
+        const uint8_t foot[10] = { '3', 'D', 'I', 4, 0, 0x10, head[6], head[7], head[8], head[9] };
+        stream.insert(stream.end(), foot, foot + 10);
+    }
+}
+
+// Feeds the stream in `chunk`-byte pieces, decoding whenever possible; returns
+// the frame index of each decoded frame
+static std::vector<int> play(Mp3StreamDecoder& decoder, const std::vector<uint8_t>& stream, size_t chunk) {
+    std::vector<int> played;
+    size_t position = 0;
+    while (true) {
+        if (position < stream.size()) {
+            position += decoder.feed(stream.data() + position, min(chunk, stream.size() - position));
+            if (position == stream.size()) decoder.finish();
+        }
+        int samples;
+        while ((samples = decoder.decodeFrame()) > 0) {
+            TEST_ASSERT_EQUAL(decoder.getFormat().samples, samples);
+            played.push_back(decoder.samples()[0] / 100);
+        }
+        if (position == stream.size() && samples == 0) break;
+    }
+    return played;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_parse_header() {
+    Mp3FrameHeader header;
+    TEST_ASSERT_TRUE(Mp3StreamDecoder::parseHeader(STEREO_HEADER, &header));
+    TEST_ASSERT_EQUAL(128000, header.bitrate);
+    TEST_ASSERT_EQUAL(44100, header.sampleRate);
+    TEST_ASSERT_EQUAL(417, header.frameBytes);
+    TEST_ASSERT_EQUAL(1152, header.samples);
+    TEST_ASSERT_EQUAL(2, header.channels);
+
+    const uint8_t padded[4] = { 0xFF, 0xFB, 0x92, 0x44 };
+    TEST_ASSERT_TRUE(Mp3StreamDecoder::parseHeader(padded, &header));
+    TEST_ASSERT_EQUAL(418, header.frameBytes);
+
+    TEST_ASSERT_TRUE(Mp3StreamDecoder::parseHeader(MONO_HEADER, &header));
+    TEST_ASSERT_EQUAL(32000, header.bitrate);
+    TEST_ASSERT_EQUAL(16000, header.sampleRate);
+    TEST_ASSERT_EQUAL(144, header.frameBytes);
+    TEST_ASSERT_EQUAL(576, header.samples);
+    TEST_ASSERT_EQUAL(1, header.channels);
+
+    const uint8_t rejected[][4] = {
+        { 0xFF, 0x7B, 0x90, 0x44 },   // No sync word
+        { 0xFF, 0xFD, 0x90, 0x44 },   // Layer II
+        { 0xFF, 0xEB, 0x90, 0x44 },   // Reserved version
+        { 0xFF, 0xFB, 0x00, 0x44 },   // Free bitrate
+        { 0xFF, 0xFB, 0xF0, 0x44 },   // Bad bitrate
+        { 0xFF, 0xFB, 0x9C, 0x44 }    // Reserved sample rate
+    };
+    for (const auto& bytes : rejected) TEST_ASSERT_FALSE(Mp3StreamDecoder::parseHeader(bytes, &header));
+}
+
+void test_frames_decode_from_any_chunk_size() {
+    std::vector<uint8_t> stream;
+    makeTag(stream, 700, true);
+    for (int i = 0; i < 40; i++) makeFrame(stream, STEREO_HEADER, i, PAYLOAD_MARK, i % 3 == 0);
+
+    for (size_t chunk : { 1, 7, 417, 1460, 65536 }) {
+        Mp3StreamDecoder decoder;
+        TEST_ASSERT_TRUE(decoder.begin());
+        std::vector<int> played = play(decoder, stream, chunk);
+        TEST_ASSERT_EQUAL(40, played.size());
+        for (int i = 0; i < 40; i++) TEST_ASSERT_EQUAL(i, played[i]);
+        TEST_ASSERT_EQUAL(40, decoder.framesDecoded());
+        TEST_ASSERT_EQUAL(0, decoder.decodeErrors());
+        TEST_ASSERT_EQUAL(0, decoder.bufferedBytes());
+        TEST_ASSERT_EQUAL(2, decoder.getFormat().channels);
+    }
+}
+
+void test_resyncs_after_garbage_and_bad_frames() {
+    std::vector<uint8_t> stream;
+    makeFrame(stream, MONO_HEADER, 0, PAYLOAD_RESERVOIR);    // Skipped quietly
+    makeFrame(stream, MONO_HEADER, 1);
+    const uint8_t garbage[] = { 0x00, 0xFF, 0xE0, 0x00, 0x12, 0xFF, 0xFF, 0xFB, 0xF0, 0x00, 0x33 };
+    stream.insert(stream.end(), garbage, garbage + sizeof(garbage));
+    makeFrame(stream, MONO_HEADER, 2);
+    makeFrame(stream, MONO_HEADER, 3, 0x00);                 // Fails to decode
+    makeFrame(stream, MONO_HEADER, 4);
+
+    Mp3StreamDecoder decoder;
+    TEST_ASSERT_TRUE(decoder.begin());
+    std::vector<int> played = play(decoder, stream, 64);
+    TEST_ASSERT_EQUAL(3, played.size());
+    TEST_ASSERT_EQUAL(1, played[0]);
+    TEST_ASSERT_EQUAL(2, played[1]);
+    TEST_ASSERT_EQUAL(4, played[2]);
+    TEST_ASSERT_EQUAL(1, decoder.decodeErrors());
+    TEST_ASSERT_EQUAL(1, decoder.getFormat().channels);
+    TEST_ASSERT_EQUAL(16000, decoder.getFormat().sampleRate);
+}
+
+void test_format_and_buffered_time_before_decoding() {
+    Mp3StreamDecoder decoder;
+    TEST_ASSERT_TRUE(decoder.begin());
+    TEST_ASSERT_FALSE(decoder.readFormat());
+    TEST_ASSERT_EQUAL(0, decoder.bufferedMillis());
+
+    std::vector<uint8_t> stream;
+    makeTag(stream, 20, false);
+    for (int i = 0; i < 10; i++) makeFrame(stream, MONO_HEADER, i);
+    decoder.feed(stream.data(), stream.size());
+    TEST_ASSERT_TRUE(decoder.readFormat());
+    TEST_ASSERT_EQUAL(32000, decoder.getFormat().bitrate);
+    TEST_ASSERT_EQUAL(0, decoder.framesDecoded());
+    // Ten 144-byte frames at 32 kbit/s: 36 ms each
+    TEST_ASSERT_EQUAL(10 * 144, decoder.bufferedBytes());
+    TEST_ASSERT_EQUAL(360, decoder.bufferedMillis());
+}
+
+void test_full_buffer_takes_more_after_a_frame_is_decoded() {
+    std::vector<uint8_t> stream;
+    for (int i = 0; stream.size() < AUDIO_STREAM_BUFFER + 1000; i++) makeFrame(stream, STEREO_HEADER, i);
+
+    Mp3StreamDecoder decoder;
+    TEST_ASSERT_TRUE(decoder.begin());
+    size_t taken = decoder.feed(stream.data(), stream.size());
+    TEST_ASSERT_EQUAL(AUDIO_STREAM_BUFFER, taken);
+    TEST_ASSERT_EQUAL(0, decoder.space());
+    TEST_ASSERT_EQUAL(0, decoder.feed(stream.data() + taken, 100));
+
+    TEST_ASSERT_EQUAL(1152, decoder.decodeFrame());
+    TEST_ASSERT_EQUAL(417, decoder.space());
+    // The undecoded bytes move to the front so the next frame stays contiguous
+    TEST_ASSERT_EQUAL(417, decoder.feed(stream.data() + taken, stream.size() - taken));
+    taken += 417;
+    int frames = 1;
+    while (decoder.decodeFrame() > 0) frames++;
+    TEST_ASSERT_EQUAL(taken / 417, frames);
+    TEST_ASSERT_EQUAL(taken % 417, decoder.bufferedBytes());
+}
+
+void test_short_tail_waits_until_finished() {
+    // A stream shorter than an ID3 header is only checked once no more is coming
+    std::vector<uint8_t> stream;
+    makeFrame(stream, MONO_HEADER, 7);
+    Mp3StreamDecoder decoder;
+    TEST_ASSERT_TRUE(decoder.begin());
+    decoder.feed(stream.data(), 6);
+    TEST_ASSERT_EQUAL(0, decoder.decodeFrame());
+    decoder.feed(stream.data() + 6, stream.size() - 7);
+    TEST_ASSERT_EQUAL(0, decoder.decodeFrame());
+    decoder.feed(stream.data() + stream.size() - 1, 1);
+    decoder.finish();
+    TEST_ASSERT_EQUAL(576, decoder.decodeFrame());
+    TEST_ASSERT_EQUAL(7, decoder.samples()[0] / 100);
+    TEST_ASSERT_EQUAL(0, decoder.decodeFrame());
+
+    decoder.end();
+    TEST_ASSERT_EQUAL(0, decoder.decodeFrame());
+    TEST_ASSERT_EQUAL(0, decoder.feed(stream.data(), stream.size()));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_header);
+    RUN_TEST(test_frames_decode_from_any_chunk_size);
+    RUN_TEST(test_resyncs_after_garbage_and_bad_frames);
+    RUN_TEST(test_format_and_buffered_time_before_decoding);
+    RUN_TEST(test_full_buffer_takes_more_after_a_frame_is_decoded);
+    RUN_TEST(test_short_tail_waits_until_finished);
+    return UNITY_END();
+}
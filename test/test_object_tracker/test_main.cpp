@@ -0,0 +1,233 @@
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "object_tracker.cpp"
+#include "host_runtime.h"
+
+static ResponseRegion square(uint8_t kind, float centreX, float centreY, float side) {
+    return { kind, centreX - side / 2, centreY - side / 2, side, side };
+}
+
+void setUp() {
+    objectTracker.reset();
+}
+
+void tearDown() {}
+
+void test_ids_follow_boxes_across_frames() {
+    // Two signs drifting apart; the second response lists them the other way round
+    ResponseRegion boxes[2] = { square(CASCADE_SIGN, 0.3f, 0.5f, 0.1f), square(CASCADE_SIGN, 0.7f, 0.5f, 0.1f) };
+    uint16_t first[2];
+    objectTracker.update(CASCADE_SIGN, boxes, 2, 1000, first);
+    TEST_ASSERT_NOT_EQUAL(0, first[0]);
+    TEST_ASSERT_NOT_EQUAL(first[0], first[1]);
+
+    ResponseRegion swapped[2] = { square(CASCADE_SIGN, 0.74f, 0.5f, 0.1f), square(CASCADE_SIGN, 0.26f, 0.5f, 0.1f) };
+    uint16_t second[2];
+    objectTracker.update(CASCADE_SIGN, swapped, 2, 2000, second);
+    TEST_ASSERT_EQUAL(first[1], second[0]);
+    TEST_ASSERT_EQUAL(first[0], second[1]);
+    TEST_ASSERT_EQUAL(2, objectTracker.trackCountOf(CASCADE_SIGN));
+}
+
+void test_kinds_are_tracked_apart() {
+    ResponseRegion text = square(CASCADE_TEXT, 0.5f, 0.5f, 0.2f);
+    ResponseRegion hazard = square(REGION_HAZARD, 0.5f, 0.5f, 0.2f);
+    uint16_t textId, hazardId;
+    objectTracker.update(CASCADE_TEXT, &text, 1, 1000, &textId);
+    objectTracker.update(REGION_HAZARD, &hazard, 1, 1000, &hazardId);
+    TEST_ASSERT_NOT_EQUAL(textId, hazardId);
+    TEST_ASSERT_EQUAL(1, objectTracker.trackCountOf(CASCADE_TEXT));
+    TEST_ASSERT_EQUAL(1, objectTracker.trackCountOf(REGION_HAZARD));
+}
+
+void test_track_is_dropped_after_misses() {
+    ResponseRegion box = square(CASCADE_TEXT, 0.5f, 0.5f, 0.2f);
+    objectTracker.update(CASCADE_TEXT, &box, 1, 1000);
+    for (int i = 1; i <= OBJECT_MAX_MISSES; i++) {
+        objectTracker.update(CASCADE_TEXT, nullptr, 0, 1000 + i * 1000);
+        TEST_ASSERT_EQUAL(1, objectTracker.trackCountOf(CASCADE_TEXT));
+    }
+    objectTracker.update(CASCADE_TEXT, nullptr, 0, 10000);
+    TEST_ASSERT_EQUAL(0, objectTracker.trackCountOf(CASCADE_TEXT));
+}
+
+void test_approaching_hazard_is_announced_once() {
+    // An obstacle 10 m away at 1.5 m/s, and a parked one that stays put
+    std::mt19937 rng(11);
+    std::normal_distribution<float> noise(0, 1);
+    uint16_t movingId = 0;
+    int announcements = 0;
+    for (int frame = 0; frame < 6; frame++) {
+        unsigned long now = 1000 + frame * 1000;
+        float distance = 10.0f - 1.5f * frame;
+        ResponseRegion boxes[2] = {
+            square(REGION_HAZARD, 0.3f + 0.005f * noise(rng), 0.5f, 0.5f / distance * (1 + 0.03f * noise(rng))),
+            square(REGION_HAZARD, 0.75f + 0.005f * noise(rng), 0.5f, 0.08f * (1 + 0.03f * noise(rng)))
+        };
+        uint16_t ids[2];
+        objectTracker.update(REGION_HAZARD, boxes, 2, now, ids);
+        if (frame > 0) TEST_ASSERT_EQUAL(movingId, ids[0]);
+        movingId = ids[0];
+        while (TrackedObject* track = objectTracker.nextApproaching(now)) {
+            TEST_ASSERT_EQUAL(movingId, track->id);
+            ObjectMotion motion = objectTracker.motion(*track);
+            TEST_ASSERT_TRUE(motion.timeToContact > 0 && motion.timeToContact < OBJECT_APPROACH_TTC);
+            announcements++;
+        }
+    }
+    TEST_ASSERT_EQUAL(1, announcements);
+}
+
+void test_follow_up_waits_for_growth() {
+    ResponseRegion box = square(CASCADE_TEXT, 0.5f, 0.5f, 0.1f);
+    objectTracker.update(CASCADE_TEXT, &box, 1, 1000);
+    TEST_ASSERT_TRUE(objectTracker.needsFollowUp(box));
+    objectTracker.markQueried(box);
+    TEST_ASSERT_FALSE(objectTracker.needsFollowUp(box));
+
+    // Slightly bigger is still the same read
+    box = square(CASCADE_TEXT, 0.5f, 0.5f, 0.12f);
+    objectTracker.update(CASCADE_TEXT, &box, 1, 2000);
+    TEST_ASSERT_FALSE(objectTracker.needsFollowUp(box));
+
+    // Walked up to it: worth reading again
+    for (int frame = 0; frame < 4; frame++) {
+        box = square(CASCADE_TEXT, 0.5f, 0.5f, 0.1f * OBJECT_REQUERY_GROWTH * (1.1f + 0.1f * frame));
+        objectTracker.update(CASCADE_TEXT, &box, 1, 3000 + frame * 1000);
+    }
+    TEST_ASSERT_TRUE(objectTracker.needsFollowUp(box));
+}
+
+// ===================
+// Benchmark: simulated walks
+// ===================
+
+// Hazard standing on the ground in front of the wearer, whose eyes are
+// CAMERA_HEIGHT up: `lateral` metres to the side and `depth` ahead, `size` metres
+// across and high, closing at `closing` m/s and crossing at `crossing` m/s
+static const float CAMERA_HEIGHT = 1.6f;
+
+struct SimulatedObject {
+    float lateral, depth, size;
+    float closing, crossing;
+    uint16_t lastId;
+    bool alerted;
+    bool cameNear;            // Seen with less than OBJECT_APPROACH_TTC to contact
+};
+
+// Prints ID switches, approach alerts, time to contact error and update time over
+// 400 runs of 1-4 objects at 1 s and 5 s capture intervals, with 5% box size noise,
+// 1% centre noise and 10% of the boxes missing from a response
+void test_benchmark_simulated_walks() {
+    std::mt19937 rng(43);
+    std::normal_distribution<float> noise(0, 1);
+    auto uniform = [&rng](float low, float high) { return low + (high - low) * (rng() % 10000) / 10000.0f; };
+    // Per run size: 1-2 objects, 3-4 objects
+    int boxes[2] = { 0, 0 }, switches[2] = { 0, 0 }, nearObjects[2] = { 0, 0 }, alerted[2] = { 0, 0 };
+    int falseAlerts[2] = { 0, 0 }, estimates = 0;
+    double ttcError = 0;
+
+    for (int run = 0; run < 400; run++) {
+        ObjectTracker tracker;
+        const int interval = run % 2 ? 5000 : 1000;
+        std::vector<SimulatedObject> objects(1 + rng() % 4);
+        const int crowd = objects.size() > 2;
+        for (SimulatedObject& object : objects) {
+            object = { uniform(-2, 2), uniform(6, 25), uniform(0.3f, 1.0f), 0, 0, 0, false, false };
+            switch (rng() % 3) {
+                case 0: object.closing = uniform(0.8f, 2.0f); break;    // Walking towards it
+                case 1: object.crossing = uniform(-1.5f, 1.5f); break;  // Someone crossing
+                default: break;                                       // Standing still
+            }
+        }
+
+        for (unsigned long now = 1000; now <= 41000; now += interval) {
+            float elapsed = (now - 1000) / 1000.0f;
+            std::vector<ResponseRegion> reported;
+            std::vector<int> owners;
+            for (int i = 0; i < (int)objects.size(); i++) {
+                SimulatedObject& object = objects[i];
+                float depth = object.depth - object.closing * elapsed;
+                float centreX = 0.5f + 0.5f * (object.lateral + object.crossing * elapsed) / depth;
+                float centreY = 0.5f + 0.5f * (CAMERA_HEIGHT - object.size / 2) / depth;
+                float side = 0.5f * object.size / depth;
+                if (depth < 0.5f || centreX < 0 || centreX > 1 || centreY > 1 || side > 0.9f) continue;
+                if (object.closing > 0 && depth / object.closing < OBJECT_APPROACH_TTC) object.cameNear = true;
+                if (rng() % 10 == 0) continue;
+                float noisySide = side * (1 + 0.05f * noise(rng));
+                reported.push_back(square(REGION_HAZARD, centreX + 0.01f * noise(rng), centreY + 0.01f * noise(rng), noisySide));
+                owners.push_back(i);
+            }
+            std::vector<uint16_t> ids(reported.size());
+            tracker.update(REGION_HAZARD, reported.data(), reported.size(), now, ids.data());
+            for (size_t b = 0; b < reported.size(); b++) {
+                SimulatedObject& object = objects[owners[b]];
+                boxes[crowd]++;
+                if (object.lastId && object.lastId != ids[b]) switches[crowd]++;
+                object.lastId = ids[b];
+
+                TrackedObject* track = tracker.findById(ids[b]);
+                if (object.closing > 0 && track && track->hits >= OBJECT_MIN_HITS) {
+                    float truth = (object.depth - object.closing * elapsed) / object.closing;
+                    ObjectMotion motion = tracker.motion(*track);
+                    if (truth < 2 * OBJECT_APPROACH_TTC) {
+                        ttcError += motion.timeToContact > 0 ? fabsf(motion.timeToContact - truth) / truth : 1.0;
+                        estimates++;
+                    }
+                }
+            }
+            while (TrackedObject* track = tracker.nextApproaching(now)) {
+                for (SimulatedObject& object : objects) {
+                    if (object.lastId != track->id || object.alerted) continue;
+                    object.alerted = true;
+                    if (object.closing == 0) falseAlerts[crowd]++;
+                }
+            }
+        }
+        for (const SimulatedObject& object : objects) {
+            nearObjects[crowd] += object.cameNear;
+            alerted[crowd] += object.cameNear && object.alerted;
+        }
+    }
+
+    // Worst case: a full set of tracks matched against four new boxes
+    const int repeats = 20000;
+    double micros = 0;
+    for (int r = 0; r < repeats; r++) {
+        ObjectTracker tracker;
+        ResponseRegion existing[12], incoming[4];
+        for (int i = 0; i < 12; i++) existing[i] = square(REGION_HAZARD, 0.05f + 0.08f * i, 0.5f, 0.06f);
+        for (int i = 0; i < 4; i++) incoming[i] = square(REGION_HAZARD, 0.1f + 0.25f * i, 0.52f, 0.07f);
+        tracker.update(REGION_HAZARD, existing, 12, 1000);
+        auto start = std::chrono::steady_clock::now();
+        tracker.update(REGION_HAZARD, incoming, 4, 2000);
+        micros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    char line[200];
+    const char* CROWDS[2] = { "1-2 objects", "3-4 objects" };
+    for (int crowd = 0; crowd < 2; crowd++) {
+        snprintf(line, sizeof(line), "%s: ID switches %d in %d boxes (%.1f%%); approach alerts %d of %d within %.0f s of contact, %d on objects not closing",
+                 CROWDS[crowd], switches[crowd], boxes[crowd], 100.0 * switches[crowd] / boxes[crowd], alerted[crowd],
+                 nearObjects[crowd], OBJECT_APPROACH_TTC, falseAlerts[crowd]);
+        TEST_MESSAGE(line);
+    }
+    snprintf(line, sizeof(line), "time to contact error %.0f%% on average under %.0f s", 100 * ttcError / estimates,
+             2 * OBJECT_APPROACH_TTC);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "update with 12 tracks and 4 boxes %.2f us", micros / repeats);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_ids_follow_boxes_across_frames);
+    RUN_TEST(test_kinds_are_tracked_apart);
+    RUN_TEST(test_track_is_dropped_after_misses);
+    RUN_TEST(test_approaching_hazard_is_announced_once);
+    RUN_TEST(test_follow_up_waits_for_growth);
+    RUN_TEST(test_benchmark_simulated_walks);
+    return UNITY_END();
+}
@@ -0,0 +1,35 @@
+// libjpeg encoder for the OCR benchmark's colour captures. jpeglib.h and the
+// Arduino stand-ins both define boolean, so this file includes no firmware headers.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <jpeglib.h>
+
+// 4:2:2 colour JPEG of an RGB image, like the camera's
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize) {
+    jpeg_compress_struct out;
+    jpeg_error_mgr errors;
+    out.err = jpeg_std_error(&errors);
+    jpeg_create_compress(&out);
+    unsigned char* buffer = nullptr;
+    unsigned long bufferSize = 0;
+    jpeg_mem_dest(&out, &buffer, &bufferSize);
+    out.image_width = width;
+    out.image_height = height;
+    out.input_components = 3;
+    out.in_color_space = JCS_RGB;
+    jpeg_set_defaults(&out);
+    jpeg_set_quality(&out, quality, TRUE);
+    out.comp_info[0].h_samp_factor = 2;
+    out.comp_info[0].v_samp_factor = 1;
+    jpeg_start_compress(&out, TRUE);
+    while (out.next_scanline < out.image_height) {
+        JSAMPROW row = (JSAMPROW)rgb + out.next_scanline * width * 3;
+        jpeg_write_scanlines(&out, &row, 1);
+    }
+    jpeg_finish_compress(&out);
+    jpeg_destroy_compress(&out);
+    *output = buffer;
+    *outputSize = bufferSize;
+    return true;
+}
@@ -0,0 +1,340 @@
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "ocr_preprocessor.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+static const int PAGE_WIDTH = 320;
+static const int PAGE_HEIGHT = 240;
+
+// Lines of text-like strokes at `degrees`, under light falling off from left to right
+static std::vector<uint8_t> renderPage(float degrees, std::vector<bool>* ink) {
+    std::vector<uint8_t> gray(PAGE_WIDTH * PAGE_HEIGHT);
+    if (ink) ink->assign(gray.size(), false);
+    float slope = tanf(degrees * M_PI / 180.0f);
+    for (int y = 0; y < PAGE_HEIGHT; y++) {
+        for (int x = 0; x < PAGE_WIDTH; x++) {
+            float light = 230 - 160.0f * x / PAGE_WIDTH;
+            float lineY = y - (x - PAGE_WIDTH / 2) * slope;
+            int line = (int)floorf(lineY / 24);
+            float inLine = lineY - line * 24;
+            bool stroke = line >= 1 && line <= 8 && inLine >= 8 && inLine < 16 &&
+                          x >= 20 && x < PAGE_WIDTH - 20 && x % 28 < 20 && x % 4 < 2;
+            gray[y * PAGE_WIDTH + x] = (uint8_t)(stroke ? light * 0.35f : light);
+            if (ink) (*ink)[y * PAGE_WIDTH + x] = stroke;
+        }
+    }
+    return gray;
+}
+
+static bool isBlack(const BilevelImage& image, int x, int y) {
+    return image.bits[y * image.stride + x / 8] & (0x80 >> (x & 7));
+}
+
+static int blackCount(const BilevelImage& image) {
+    int count = 0;
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) count += isBlack(image, x, y);
+    }
+    return count;
+}
+
+static uint32_t read32(const uint8_t* p) {
+    return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Value of a TIFF tag in the first IFD, 0 when absent
+static uint32_t tiffTag(const uint8_t* tiff, uint16_t tag) {
+    const uint8_t* ifd = tiff + read32(tiff + 4);
+    int count = ifd[0] | ifd[1] << 8;
+    for (int i = 0; i < count; i++) {
+        const uint8_t* entry = ifd + 2 + i * 12;
+        if ((entry[0] | entry[1] << 8) != tag) continue;
+        int type = entry[2] | entry[3] << 8;
+        return type == 3 ? entry[8] | entry[9] << 8 : read32(entry + 8);
+    }
+    return 0;
+}
+
+// Strip data libtiff writes for the 75x20 pattern in test_g4_matches_libtiff
+static const uint8_t LIBTIFF_G4_STRIP[] = {
+    0x26, 0xa8, 0xf2, 0x2e, 0x8f, 0x22, 0xe8, 0xba, 0x3c, 0x8b, 0xa3, 0xc8, 0xba, 0x2e, 0x8f, 0x22,
+    0xe8, 0xf2, 0x2e, 0x8b, 0xac, 0x46, 0x5d, 0x24, 0x39, 0x75, 0x12, 0x3e, 0x97, 0x43, 0x97, 0x0a,
+    0x08, 0x2d, 0x0e, 0x5d, 0x0e, 0xa5, 0xd0, 0xe5, 0xd2, 0x4f, 0xf2, 0xe8, 0x72, 0xe9, 0x27, 0xcb,
+    0xa4, 0x87, 0x08, 0xa1, 0xe9, 0x7c, 0xba, 0x48, 0x70, 0x8a, 0x1e, 0x90, 0xe5, 0xd0, 0xfe, 0xa7,
+    0x11, 0x74, 0x90, 0xe5, 0xd0, 0xec, 0xa7, 0x2b, 0xa5, 0xd0, 0xe5, 0xd2, 0x47, 0x91, 0x74, 0x39,
+    0x1d, 0x24, 0x39, 0x74, 0x28, 0x58, 0xe5, 0xd0, 0xe5, 0xd2, 0x11, 0x06, 0x39, 0x74, 0x94, 0x72,
+    0xe8, 0x70, 0x45, 0x3b, 0x1c, 0xba, 0x48, 0x72, 0xe9, 0x21, 0xe4, 0xd5, 0x0e, 0x5d, 0x24, 0x39,
+    0x74, 0x90, 0xe5, 0xd5, 0x0e, 0x5d, 0x0f, 0x2e, 0x92, 0x1c, 0xba, 0xa1, 0xcb, 0xa1, 0xd4, 0xba,
+    0x1c, 0x10, 0x51, 0x1c, 0xba, 0x1d, 0x14, 0xe5, 0x74, 0xba, 0x1c, 0xba, 0x48, 0x19, 0x4e, 0x57,
+    0x4b, 0xa4, 0x86, 0x5d, 0x0e, 0x5d, 0x24, 0xc7, 0x97, 0x49, 0x0e, 0x5d, 0x04, 0x24, 0xc7, 0x43,
+    0x97, 0x5c, 0xba, 0x48, 0x21, 0x27, 0x85, 0x3a, 0x48, 0x72, 0x38, 0x42, 0x3a, 0x2e, 0xb2, 0xe8,
+    0x50, 0x34, 0x87, 0xc8, 0xe9, 0x21, 0xcb, 0xa1, 0xc7, 0x2e, 0x87, 0x04, 0x53, 0xf2, 0xe8, 0x71,
+    0xcb, 0xa1, 0xc1, 0x14, 0xec, 0x72, 0xe9, 0x21, 0xc7, 0x04, 0x53, 0x95, 0xc1, 0x17, 0x43, 0x97,
+    0x49, 0x0c, 0xa7, 0x2b, 0xa5, 0xd2, 0x43, 0x97, 0x40, 0xd4, 0x9a, 0xa4, 0x86, 0x23, 0x2e, 0x92,
+    0x1c, 0xba, 0x89, 0x1f, 0x4b, 0xa1, 0xcb, 0x90, 0xe5, 0xd5, 0x0e, 0x5d, 0x0e, 0xa5, 0xd0, 0xe5,
+    0xd2, 0x4e, 0x08, 0x41, 0x97, 0x47, 0x91, 0x74, 0x31, 0x12, 0x9c, 0xa7, 0x2b, 0xa5, 0xd2, 0x41,
+    0x09, 0x3c, 0xf2, 0xe8, 0x72, 0xe9, 0x14, 0x3c, 0x72, 0xe9, 0x21, 0xf2, 0x3a, 0x50, 0x01, 0x00,
+    0x10
+};
+
+void setUp() {}
+void tearDown() {}
+
+void test_binarize_follows_uneven_light() {
+    std::vector<bool> ink;
+    std::vector<uint8_t> page = renderPage(0, &ink);
+    BilevelImage image;
+    TEST_ASSERT_TRUE(ocrPreprocessor.binarize(page.data(), PAGE_WIDTH, PAGE_HEIGHT, PAGE_WIDTH, &image));
+    TEST_ASSERT_EQUAL(PAGE_WIDTH / 8, image.stride);
+
+    int inkPixels = 0, inkFound = 0, paperPixels = 0, paperKept = 0;
+    for (int y = 0; y < PAGE_HEIGHT; y++) {
+        for (int x = 0; x < PAGE_WIDTH; x++) {
+            if (ink[y * PAGE_WIDTH + x]) {
+                inkPixels++;
+                inkFound += isBlack(image, x, y);
+            } else {
+                paperPixels++;
+                paperKept += !isBlack(image, x, y);
+            }
+        }
+    }
+    // The dimmest paper is darker than the brightest ink, so a global threshold would fail
+    TEST_ASSERT_GREATER_OR_EQUAL(inkPixels * 95 / 100, inkFound);
+    TEST_ASSERT_GREATER_OR_EQUAL(paperPixels * 99 / 100, paperKept);
+    free(image.bits);
+}
+
+void test_flat_regions_stay_white() {
+    std::vector<uint8_t> gray(100 * 50);
+    for (int i = 0; i < 100 * 50; i++) gray[i] = 60 + (i % 100) / 10 + (i * 7 % 5);
+    BilevelImage image;
+    TEST_ASSERT_TRUE(ocrPreprocessor.binarize(gray.data(), 100, 50, 100, &image));
+    TEST_ASSERT_EQUAL(13, image.stride);
+    TEST_ASSERT_EQUAL(0, blackCount(image));
+    free(image.bits);
+}
+
+void test_skew_is_estimated_and_removed() {
+    const float angles[] = { -6.0f, -2.5f, -0.25f, 0.0f, 1.0f, 4.0f, 7.5f };
+    for (float angle : angles) {
+        std::vector<uint8_t> page = renderPage(angle, nullptr);
+        BilevelImage image, rotated;
+        TEST_ASSERT_TRUE(ocrPreprocessor.binarize(page.data(), PAGE_WIDTH, PAGE_HEIGHT, PAGE_WIDTH, &image));
+        // Within the coarse sweep's step; the fine sweep only searches around its best angle
+        float skew = ocrPreprocessor.estimateSkew(image);
+        TEST_ASSERT_FLOAT_WITHIN(0.625f, angle, skew);
+
+        TEST_ASSERT_TRUE(ocrPreprocessor.rotate(image, skew, &rotated));
+        TEST_ASSERT_FLOAT_WITHIN(0.625f, 0.0f, ocrPreprocessor.estimateSkew(rotated));
+        // Nearest-neighbour rotation keeps the ink, less what turns out of the frame
+        TEST_ASSERT_INT_WITHIN(blackCount(image) / 10, blackCount(image), blackCount(rotated));
+        free(image.bits);
+        free(rotated.bits);
+    }
+}
+
+void test_g4_matches_libtiff() {
+    BilevelImage image = { nullptr, 75, 20, 10 };
+    image.bits = (uint8_t*)calloc(image.stride * image.height, 1);
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) {
+            bool black = (x * 7 + y * 3) % 23 < 5 || ((x / 10 + y / 6) % 3 == 0 && y % 5 != 0);
+            if (black) image.bits[y * image.stride + x / 8] |= 0x80 >> (x & 7);
+        }
+    }
+    uint8_t* tiff = nullptr;
+    size_t tiffSize = 0;
+    TEST_ASSERT_TRUE(ocrPreprocessor.encodeTiffG4(image, &tiff, &tiffSize));
+    free(image.bits);
+
+    TEST_ASSERT_EQUAL('I', tiff[0]);
+    TEST_ASSERT_EQUAL(42, tiff[2]);
+    TEST_ASSERT_EQUAL(75, tiffTag(tiff, 256));
+    TEST_ASSERT_EQUAL(20, tiffTag(tiff, 257));
+    TEST_ASSERT_EQUAL(4, tiffTag(tiff, 259));
+    TEST_ASSERT_EQUAL(0, tiffTag(tiff, 262));
+    uint32_t offset = tiffTag(tiff, 273);
+    uint32_t length = tiffTag(tiff, 279);
+    TEST_ASSERT_EQUAL(tiffSize, offset + length);
+    TEST_ASSERT_EQUAL(sizeof(LIBTIFF_G4_STRIP), length);
+    TEST_ASSERT_EQUAL_MEMORY(LIBTIFF_G4_STRIP, tiff + offset, length);
+    free(tiff);
+}
+
+void test_process_turns_a_capture_into_a_tiff() {
+    uint8_t* tiff = nullptr;
+    size_t tiffSize = 0;
+    TEST_ASSERT_TRUE(ocrPreprocessor.process(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &tiff, &tiffSize));
+    size_t firstSize = tiffSize;
+    TEST_ASSERT_EQUAL(160, tiffTag(tiff, 256));
+    TEST_ASSERT_EQUAL(120, tiffTag(tiff, 257));
+    TEST_ASSERT_LESS_THAN(TEST_SCENE_JPEG_LENGTH, tiffSize);
+    free(tiff);
+
+    TEST_ASSERT_FALSE(ocrPreprocessor.process(TEST_SCENE_JPEG, 100, &tiff, &tiffSize));
+    TEST_ASSERT_NULL(tiff);
+    OcrPreprocessStats stats = ocrPreprocessor.getStats();
+    TEST_ASSERT_EQUAL(1, stats.images);
+    TEST_ASSERT_EQUAL(1, stats.failures);
+    TEST_ASSERT_EQUAL(firstSize, stats.bytesOut);
+}
+
+// ===================
+// Benchmark: upload bytes against accuracy on generated document captures
+// ===================
+
+// Encoder in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize);
+
+static const int DOC_WIDTH = 1024;
+static const int DOC_HEIGHT = 768;
+
+// A page of 5x7 glyphs drawn at twice their size, rotated by `degrees` about the
+// centre, under light falling off towards one corner, with sensor noise. `ink`
+// is the glyph mask of the page, `upright` the same mask without the rotation.
+static std::vector<uint8_t> renderDocument(unsigned seed, float degrees, std::vector<bool>* ink,
+                                           std::vector<bool>* upright) {
+    std::mt19937 rng(seed);
+    uint8_t glyphs[40][7];
+    for (auto& glyph : glyphs) {
+        for (uint8_t& row : glyph) row = rng() & 0x1F;
+    }
+    // Glyph index per cell, -1 for spaces; cells are 12x18 px on 28 px lines
+    const int columns = (DOC_WIDTH - 120) / 12, lines = (DOC_HEIGHT - 120) / 28;
+    std::vector<int> cells(columns * lines);
+    for (int& cell : cells) cell = rng() % 6 == 0 ? -1 : rng() % 40;
+
+    auto inkAt = [&](float u, float v) {
+        int x = (int)floorf(u) - 60, y = (int)floorf(v) - 60;
+        if (x < 0 || y < 0 || x >= columns * 12 || y >= lines * 28) return false;
+        int cell = cells[(y / 28) * columns + x / 12];
+        int gx = (x % 12) / 2, gy = (y % 28) / 2;
+        return cell >= 0 && gx < 5 && gy < 7 && (glyphs[cell][gy] >> (4 - gx) & 1);
+    };
+
+    std::vector<uint8_t> rgb(DOC_WIDTH * DOC_HEIGHT * 3);
+    ink->assign(DOC_WIDTH * DOC_HEIGHT, false);
+    upright->assign(DOC_WIDTH * DOC_HEIGHT, false);
+    float c = cosf(degrees * M_PI / 180.0f), s = sinf(degrees * M_PI / 180.0f);
+    float cx = DOC_WIDTH / 2.0f, cy = DOC_HEIGHT / 2.0f;
+    for (int y = 0; y < DOC_HEIGHT; y++) {
+        for (int x = 0; x < DOC_WIDTH; x++) {
+            // Page coordinates of this pixel: the inverse of the page's rotation
+            float u = cx + (x - cx) * c + (y - cy) * s;
+            float v = cy - (x - cx) * s + (y - cy) * c;
+            bool black = inkAt(u, v);
+            (*ink)[y * DOC_WIDTH + x] = black;
+            (*upright)[y * DOC_WIDTH + x] = inkAt(x, y);
+            float light = 1.0f - 0.6f * (x + y) / (DOC_WIDTH + DOC_HEIGHT);
+            const float paper[3] = { 228, 222, 210 }, print[3] = { 96, 92, 104 };
+            for (int k = 0; k < 3; k++) {
+                int value = (int)((black ? print[k] : paper[k]) * light) + (int)(rng() % 21) - 10;
+                rgb[(y * DOC_WIDTH + x) * 3 + k] = constrain(value, 0, 255);
+            }
+        }
+    }
+    return rgb;
+}
+
+// F1 of a bilevel image against a mask; with `slack`, a black pixel next to ink
+// counts as found and ink next to a black pixel as recalled
+static float maskF1(const BilevelImage& image, const std::vector<bool>& mask, int slack) {
+    auto near = [&](int x, int y, bool wantImage) {
+        for (int dy = -slack; dy <= slack; dy++) {
+            for (int dx = -slack; dx <= slack; dx++) {
+                int nx = x + dx, ny = y + dy;
+                if (nx < 0 || ny < 0 || nx >= image.width || ny >= image.height) continue;
+                if (wantImage ? isBlack(image, nx, ny) : (bool)mask[ny * image.width + nx]) return true;
+            }
+        }
+        return false;
+    };
+    long truePositive = 0, black = 0, inkTotal = 0, recalled = 0;
+    for (int y = 0; y < image.height; y++) {
+        for (int x = 0; x < image.width; x++) {
+            if (isBlack(image, x, y)) {
+                black++;
+                truePositive += near(x, y, false);
+            }
+            if (mask[y * image.width + x]) {
+                inkTotal++;
+                recalled += near(x, y, true);
+            }
+        }
+    }
+    if (black == 0 || inkTotal == 0) return 0;
+    float precision = (float)truePositive / black, recall = (float)recalled / inkTotal;
+    return 2 * precision * recall / (precision + recall);
+}
+
+// Prints the TIFF size against the colour JPEG, the skew error and the text
+// mask F1 before and after deskewing for eight pages; nothing is asserted
+// beyond the output being produced
+void test_benchmark_bytes_against_accuracy() {
+    const float angles[] = { -6.5f, -3.0f, -1.2f, 0.0f, 0.8f, 2.2f, 4.5f, 7.0f };
+    size_t jpegTotal = 0, tiffTotal = 0;
+    float worstSkewError = 0, minF1 = 1, minDeskewedF1 = 1;
+    double totalMicros = 0;
+    int pages = 0;
+
+    for (float angle : angles) {
+        std::vector<bool> ink, upright;
+        std::vector<uint8_t> rgb = renderDocument(100 + pages, angle, &ink, &upright);
+        uint8_t* jpeg = nullptr;
+        size_t jpegSize = 0;
+        TEST_ASSERT_TRUE(libjpegEncodeRgb(rgb.data(), DOC_WIDTH, DOC_HEIGHT, 85, &jpeg, &jpegSize));
+
+        uint8_t* tiff = nullptr;
+        size_t tiffSize = 0;
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(ocrPreprocessor.process(jpeg, jpegSize, &tiff, &tiffSize));
+        totalMicros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        free(tiff);
+
+        // The same stages again, to score each one
+        JpegPlane luma;
+        BilevelImage image, deskewed;
+        TEST_ASSERT_TRUE(jpegTranscoder.decodePlanes(jpeg, jpegSize, JPEG_SCALE_FULL, &luma, 1));
+        TEST_ASSERT_TRUE(ocrPreprocessor.binarize(luma.data, luma.width, luma.height, luma.stride, &image));
+        free(luma.data);
+        float skew = ocrPreprocessor.estimateSkew(image);
+        TEST_ASSERT_TRUE(ocrPreprocessor.rotate(image, skew, &deskewed));
+        float f1 = maskF1(image, ink, 0);
+        float deskewedF1 = maskF1(deskewed, upright, 1);
+        free(image.bits);
+        free(deskewed.bits);
+
+        worstSkewError = std::max(worstSkewError, fabsf(skew - angle));
+        minF1 = std::min(minF1, f1);
+        minDeskewedF1 = std::min(minDeskewedF1, deskewedF1);
+        jpegTotal += jpegSize;
+        tiffTotal += tiffSize;
+        pages++;
+        char line[160];
+        snprintf(line, sizeof(line), "page %d at %+.1f deg: JPEG %u bytes, TIFF %u bytes, skew %+.2f, F1 %.4f, deskewed F1 %.4f",
+                 pages, angle, (unsigned)jpegSize, (unsigned)tiffSize, skew, f1, deskewedF1);
+        TEST_MESSAGE(line);
+        free(jpeg);
+    }
+
+    char line[160];
+    snprintf(line, sizeof(line), "%d pages: %.1fx smaller than the JPEG, skew within %.2f deg, F1 >= %.4f (deskewed >= %.4f), %.1f ms/page",
+             pages, (float)jpegTotal / tiffTotal, worstSkewError, minF1, minDeskewedF1, totalMicros / pages / 1000);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_binarize_follows_uneven_light);
+    RUN_TEST(test_flat_regions_stay_white);
+    RUN_TEST(test_skew_is_estimated_and_removed);
+    RUN_TEST(test_g4_matches_libtiff);
+    RUN_TEST(test_process_turns_a_capture_into_a_tiff);
+    RUN_TEST(test_benchmark_bytes_against_accuracy);
+    return UNITY_END();
+}
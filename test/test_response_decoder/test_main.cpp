@@ -0,0 +1,255 @@
+#include <unity.h>
+#include <ArduinoJson.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "response_decoder.cpp"
+#include "host_runtime.h"
+
+// Minimal CBOR encoder for building responses
+class Cbor {
+public:
+    std::vector<uint8_t> bytes;
+
+    Cbor& head(uint8_t major, uint64_t value) {
+        if (value < 24) {
+            bytes.push_back(major << 5 | value);
+        } else if (value < 0x100) {
+            bytes.push_back(major << 5 | 24);
+            bytes.push_back(value);
+        } else if (value < 0x10000) {
+            bytes.push_back(major << 5 | 25);
+            push(value, 2);
+        } else {
+            bytes.push_back(major << 5 | 26);
+            push(value, 4);
+        }
+        return *this;
+    }
+    Cbor& uint(uint64_t value) { return head(0, value); }
+    Cbor& negative(uint64_t value) { return head(1, value - 1); }
+    Cbor& text(const std::string& value) {
+        head(3, value.size());
+        bytes.insert(bytes.end(), value.begin(), value.end());
+        return *this;
+    }
+    Cbor& array(uint64_t count) { return head(4, count); }
+    Cbor& map(uint64_t count) { return head(5, count); }
+    Cbor& boolean(bool value) { bytes.push_back(value ? 0xF5 : 0xF4); return *this; }
+    Cbor& half(uint16_t bits) { bytes.push_back(0xF9); push(bits, 2); return *this; }
+    Cbor& single(float value) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        bytes.push_back(0xFA);
+        push(bits, 4);
+        return *this;
+    }
+
+private:
+    void push(uint64_t value, int size) {
+        for (int i = size - 1; i >= 0; i--) bytes.push_back(value >> (8 * i));
+    }
+};
+
+// A full response: hazard with distance, task confidences, two regions and audio
+static Cbor fullResponse() {
+    Cbor cbor;
+    cbor.map(12);
+    cbor.uint(0).uint(STRUCTURED_RESPONSE_VERSION);
+    cbor.uint(1).boolean(true);
+    cbor.uint(2).text("Open manhole ahead, slightly to the right.");
+    cbor.uint(4).single(0.92f);
+    cbor.uint(5).uint(HAZARD_DROP);
+    cbor.uint(6).uint(1);
+    cbor.uint(7).half(0x4100);                      // 2.5 as a half float
+    cbor.uint(8).array(4).single(0.92f).negative(1).negative(1).uint(0);
+    cbor.uint(9).array(2);
+    cbor.array(5).uint(CASCADE_TEXT).single(0.25f).single(0.5f).single(0.125f).single(0.0625f);
+    cbor.array(5).uint(CASCADE_SIGN).uint(0).uint(0).uint(1).uint(1);
+    cbor.uint(10).array(3).text("https://cdn.example.com/tts/1.mp3").text("mp3").uint(12345);
+    cbor.uint(42).map(1).text("later").array(2).uint(1).text("field");  // Unknown key, skipped
+    cbor.uint(3).text("");
+    return cbor;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_decodes_every_field() {
+    Cbor cbor = fullResponse();
+    StructuredResult result;
+    TEST_ASSERT_TRUE(responseDecoder.decode(cbor.bytes.data(), cbor.bytes.size(), &result));
+    TEST_ASSERT_EQUAL(STRUCTURED_RESPONSE_VERSION, result.version);
+    TEST_ASSERT_TRUE(result.success);
+    TEST_ASSERT_EQUAL_STRING("Open manhole ahead, slightly to the right.", result.text);
+    TEST_ASSERT_EQUAL_STRING("", result.error);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.92f, result.confidence);
+    TEST_ASSERT_EQUAL(HAZARD_DROP, result.hazardType);
+    TEST_ASSERT_EQUAL(1, result.direction);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 2.5f, result.distance);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.92f, result.taskConfidence[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, -1.0f, result.taskConfidence[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0f, result.taskConfidence[3]);
+    TEST_ASSERT_EQUAL(2, result.regionCount);
+    TEST_ASSERT_EQUAL(CASCADE_TEXT, result.regions[0].kind);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.25f, result.regions[0].x);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.0625f, result.regions[0].height);
+    TEST_ASSERT_EQUAL(CASCADE_SIGN, result.regions[1].kind);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0f, result.regions[1].width);
+    TEST_ASSERT_TRUE(result.hasAudio);
+    TEST_ASSERT_EQUAL_STRING("https://cdn.example.com/tts/1.mp3", result.audioUrl);
+    TEST_ASSERT_EQUAL_STRING("mp3", result.audioFormat);
+    TEST_ASSERT_EQUAL(12345, result.audioSize);
+}
+
+void test_out_of_range_hazard_type_is_clamped() {
+    Cbor cbor;
+    cbor.map(2).uint(0).uint(STRUCTURED_RESPONSE_VERSION).uint(5).uint(200);
+    StructuredResult result;
+    TEST_ASSERT_TRUE(responseDecoder.decode(cbor.bytes.data(), cbor.bytes.size(), &result));
+    TEST_ASSERT_EQUAL(HAZARD_OTHER, result.hazardType);
+}
+
+void test_long_text_is_truncated() {
+    Cbor cbor;
+    cbor.map(2).uint(0).uint(STRUCTURED_RESPONSE_VERSION).uint(2).text(std::string(1000, 'a'));
+    StructuredResult result;
+    TEST_ASSERT_TRUE(responseDecoder.decode(cbor.bytes.data(), cbor.bytes.size(), &result));
+    TEST_ASSERT_EQUAL(STRUCTURED_MAX_TEXT - 1, strlen(result.text));
+}
+
+void test_rejects_missing_version_and_json() {
+    Cbor cbor;
+    cbor.map(1).uint(1).boolean(true);
+    StructuredResult result;
+    TEST_ASSERT_FALSE(responseDecoder.decode(cbor.bytes.data(), cbor.bytes.size(), &result));
+
+    const char* json = "{\"success\":true,\"result\":\"Clear path ahead.\"}";
+    TEST_ASSERT_FALSE(responseDecoder.decode((const uint8_t*)json, strlen(json), &result));
+}
+
+void test_rejects_every_truncation() {
+    Cbor cbor = fullResponse();
+    for (size_t length = 0; length < cbor.bytes.size(); length++) {
+        StructuredResult result;
+        TEST_ASSERT_FALSE(responseDecoder.decode(cbor.bytes.data(), length, &result));
+    }
+}
+
+void test_survives_corrupted_bytes() {
+    // Each byte corrupted in turn must decode or fail without reading out of bounds
+    Cbor cbor = fullResponse();
+    for (size_t i = 0; i < cbor.bytes.size(); i++) {
+        for (uint8_t flip : { 0x01, 0x1F, 0x5A, 0xE0, 0xFF }) {
+            std::vector<uint8_t> corrupted(cbor.bytes);
+            corrupted[i] ^= flip;
+            StructuredResult result;
+            if (responseDecoder.decode(corrupted.data(), corrupted.size(), &result)) {
+                TEST_ASSERT_LESS_THAN(STRUCTURED_MAX_TEXT, strlen(result.text));
+                TEST_ASSERT_LESS_OR_EQUAL(API_MAX_REGIONS, result.regionCount);
+            }
+        }
+    }
+}
+
+// The same result as fullResponse() in the JSON the API sent before CBOR,
+// with the structured fields under names of their own
+static std::string fullJsonResponse() {
+    char json[640];
+    snprintf(json, sizeof(json),
+             "{\"success\":true,\"result\":\"Open manhole ahead, slightly to the right.\",\"error\":\"\","
+             "\"confidence\":0.92,\"hazard_type\":%d,\"direction\":1,\"distance\":2.5,"
+             "\"task_confidence\":[0.92,-1,-1,0],"
+             "\"regions\":[{\"type\":\"text\",\"box\":[0.25,0.5,0.125,0.0625]},"
+             "{\"type\":\"sign\",\"box\":[0,0,1,1]}],"
+             "\"has_audio\":true,\"audio_url\":\"https://cdn.example.com/tts/1.mp3\","
+             "\"audio_format\":\"mp3\",\"audio_size\":12345}",
+             HAZARD_DROP);
+    return json;
+}
+
+// The ArduinoJson path of GSMModule::parseAPIResponse(), filling the same struct
+static bool jsonDecode(const char* json, size_t length, StructuredResult* result) {
+    JsonDocument doc;
+    if (deserializeJson(doc, json, length)) return false;
+
+    memset(result, 0, sizeof(*result));
+    result->version = STRUCTURED_RESPONSE_VERSION;
+    result->success = doc["success"] | false;
+    snprintf(result->text, sizeof(result->text), "%s", doc["result"] | "");
+    snprintf(result->error, sizeof(result->error), "%s", doc["error"] | "");
+    result->confidence = doc["confidence"] | 0.0f;
+    result->hazardType = doc["hazard_type"] | 0;
+    result->direction = doc["direction"] | 0;
+    result->distance = doc["distance"] | 0.0f;
+    for (int i = 0; i < STRUCTURED_TASKS; i++) result->taskConfidence[i] = -1;
+    int task = 0;
+    for (JsonVariant confidence : doc["task_confidence"].as<JsonArray>()) {
+        if (task < STRUCTURED_TASKS) result->taskConfidence[task++] = confidence | -1.0f;
+    }
+    for (JsonObject region : doc["regions"].as<JsonArray>()) {
+        if (result->regionCount >= API_MAX_REGIONS) break;
+        const char* type = region["type"] | "";
+        JsonArray box = region["box"];
+        uint8_t kind = strcmp(type, "text") == 0 ? CASCADE_TEXT : (strcmp(type, "sign") == 0 ? CASCADE_SIGN : 0);
+        if (kind == 0 || box.size() != 4) continue;
+        ResponseRegion& r = result->regions[result->regionCount++];
+        r.kind = kind;
+        r.x = box[0] | 0.0f;
+        r.y = box[1] | 0.0f;
+        r.width = box[2] | 0.0f;
+        r.height = box[3] | 0.0f;
+    }
+    result->hasAudio = doc["has_audio"] | false;
+    snprintf(result->audioUrl, sizeof(result->audioUrl), "%s", doc["audio_url"] | "");
+    snprintf(result->audioFormat, sizeof(result->audioFormat), "%s", doc["audio_format"] | "mp3");
+    result->audioSize = doc["audio_size"] | 0;
+    return true;
+}
+
+// Prints size and decode time of both encodings; timings are not asserted
+void test_benchmark_against_json() {
+    Cbor cbor = fullResponse();
+    std::string json = fullJsonResponse();
+    const int runs = 5000;
+
+    StructuredResult fromCbor, fromJson;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        TEST_ASSERT_TRUE(responseDecoder.decode(cbor.bytes.data(), cbor.bytes.size(), &fromCbor));
+    }
+    double cborMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; i++) {
+        TEST_ASSERT_TRUE(jsonDecode(json.data(), json.size(), &fromJson));
+    }
+    double jsonMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL_STRING(fromCbor.text, fromJson.text);
+    TEST_ASSERT_EQUAL(fromCbor.hazardType, fromJson.hazardType);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, fromCbor.distance, fromJson.distance);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, fromCbor.taskConfidence[3], fromJson.taskConfidence[3]);
+    TEST_ASSERT_EQUAL(fromCbor.regionCount, fromJson.regionCount);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, fromCbor.regions[0].height, fromJson.regions[0].height);
+    TEST_ASSERT_EQUAL_STRING(fromCbor.audioUrl, fromJson.audioUrl);
+    TEST_ASSERT_EQUAL(fromCbor.audioSize, fromJson.audioSize);
+    TEST_ASSERT_LESS_THAN(json.size(), cbor.bytes.size());
+
+    char line[160];
+    snprintf(line, sizeof(line), "CBOR %u bytes, %.2f us per decode; JSON %u bytes, %.2f us per decode",
+             (unsigned)cbor.bytes.size(), cborMicros / runs, (unsigned)json.size(), jsonMicros / runs);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_decodes_every_field);
+    RUN_TEST(test_out_of_range_hazard_type_is_clamped);
+    RUN_TEST(test_long_text_is_truncated);
+    RUN_TEST(test_rejects_missing_version_and_json);
+    RUN_TEST(test_rejects_every_truncation);
+    RUN_TEST(test_survives_corrupted_bytes);
+    RUN_TEST(test_benchmark_against_json);
+    return UNITY_END();
+}
@@ -0,0 +1,457 @@
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "sign_prefilter.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+struct Ycc {
+    uint8_t y, cb, cr;
+};
+
+// JFIF RGB to YCbCr, as the camera's encoder does it
+static Ycc toYcc(int r, int g, int b) {
+    auto clamp = [](float v) { return (uint8_t)constrain((int)lroundf(v), 0, 255); };
+    return { clamp(0.299f * r + 0.587f * g + 0.114f * b),
+             clamp(128 - 0.168736f * r - 0.331264f * g + 0.5f * b),
+             clamp(128 + 0.5f * r - 0.418688f * g - 0.081312f * b) };
+}
+
+static uint8_t classify(int r, int g, int b) {
+    Ycc p = toYcc(r, g, b);
+    uint8_t classes;
+    SignPrefilter::classifyRowScalar(&p.y, &p.cb, &p.cr, &classes, 1);
+    return classes;
+}
+
+static const int PLANE_WIDTH = 160;
+static const int PLANE_HEIGHT = 120;
+
+// Y/Cb/Cr planes on one grid, filled with a grey wall
+class Planes {
+public:
+    std::vector<uint8_t> y, cb, cr;
+
+    Planes() : y(PLANE_WIDTH * PLANE_HEIGHT, 120), cb(PLANE_WIDTH * PLANE_HEIGHT, 128), cr(PLANE_WIDTH * PLANE_HEIGHT, 128) {}
+
+    void paint(int x, int yy, int r, int g, int b) {
+        Ycc p = toYcc(r, g, b);
+        int i = yy * PLANE_WIDTH + x;
+        y[i] = p.y;
+        cb[i] = p.cb;
+        cr[i] = p.cr;
+    }
+
+    void rect(int x0, int y0, int x1, int y1, int r, int g, int b) {
+        for (int yy = y0; yy < y1; yy++) {
+            for (int x = x0; x < x1; x++) paint(x, yy, r, g, b);
+        }
+    }
+
+    void ring(int cx, int cy, int outer, int inner, int r, int g, int b) {
+        for (int yy = cy - outer; yy <= cy + outer; yy++) {
+            for (int x = cx - outer; x <= cx + outer; x++) {
+                int d2 = (x - cx) * (x - cx) + (yy - cy) * (yy - cy);
+                if (d2 <= outer * outer && d2 >= inner * inner) paint(x, yy, r, g, b);
+            }
+        }
+    }
+
+    bool detect(SignCandidates* candidates, int scale = 1) {
+        return signPrefilter.detectPlanes(y.data(), cb.data(), cr.data(), PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH,
+                                          scale, candidates);
+    }
+};
+
+static const SignRegion* regionOf(const SignCandidates& candidates, SignColour colour) {
+    for (int i = 0; i < candidates.count; i++) {
+        if (candidates.regions[i].colour == colour) return &candidates.regions[i];
+    }
+    return nullptr;
+}
+
+static const SignRegion* regionAt(const SignCandidates& candidates, int x, int y) {
+    for (int i = 0; i < candidates.count; i++) {
+        const SignRegion& region = candidates.regions[i];
+        if (x >= region.x && x < region.x + region.width && y >= region.y && y < region.y + region.height) return &region;
+    }
+    return nullptr;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_packed_classification_matches_scalar_for_every_colour() {
+    // Every Cb/Cr pair at every luma, in rows whose length leaves a scalar tail
+    const int width = 65536 + 3;
+    std::vector<uint8_t> y(width), cb(width), cr(width), packed(width), scalar(width);
+    for (int i = 0; i < width; i++) {
+        cb[i] = i & 0xFF;
+        cr[i] = (i >> 8) & 0xFF;
+    }
+    for (int luma = 0; luma < 256; luma++) {
+        memset(y.data(), luma, width);
+        SignPrefilter::classifyRow(y.data(), cb.data(), cr.data(), packed.data(), width);
+        SignPrefilter::classifyRowScalar(y.data(), cb.data(), cr.data(), scalar.data(), width);
+        TEST_ASSERT_EQUAL_MEMORY(scalar.data(), packed.data(), width);
+    }
+    // Short rows are all tail
+    for (int shortWidth = 1; shortWidth < 8; shortWidth++) {
+        SignPrefilter::classifyRow(y.data() + 1, cb.data() + 1, cr.data() + 1, packed.data(), shortWidth);
+        SignPrefilter::classifyRowScalar(y.data() + 1, cb.data() + 1, cr.data() + 1, scalar.data(), shortWidth);
+        TEST_ASSERT_EQUAL_MEMORY(scalar.data(), packed.data(), shortWidth);
+    }
+}
+
+void test_sign_colours_are_classified() {
+    TEST_ASSERT_EQUAL(SIGN_COLOUR_RED, classify(200, 20, 30));        // Stop, prohibition ring
+    TEST_ASSERT_EQUAL(SIGN_COLOUR_YELLOW, classify(240, 200, 20));    // Warning
+    TEST_ASSERT_EQUAL(SIGN_COLOUR_BLUE, classify(20, 70, 200));       // Mandatory, information
+    TEST_ASSERT_EQUAL(0, classify(128, 128, 128));
+    TEST_ASSERT_EQUAL(0, classify(250, 250, 245));
+    TEST_ASSERT_EQUAL(0, classify(60, 5, 5));                         // Too dark to trust the chroma
+    TEST_ASSERT_EQUAL(0, classify(120, 150, 60));                     // Foliage
+}
+
+void test_sign_shaped_blobs_become_regions() {
+    Planes planes;
+    planes.ring(40, 40, 15, 11, 200, 20, 30);         // Prohibition ring
+    planes.rect(90, 20, 120, 50, 20, 70, 200);        // Blue square
+    planes.rect(20, 90, 40, 100, 240, 200, 20);       // Yellow plate, 2:1
+    SignCandidates candidates;
+    TEST_ASSERT_TRUE(planes.detect(&candidates, 4));
+    TEST_ASSERT_EQUAL(3, candidates.count);
+    TEST_ASSERT_EQUAL(PLANE_WIDTH * 4, candidates.sourceWidth);
+
+    const SignRegion* red = regionOf(candidates, SIGN_COLOUR_RED);
+    TEST_ASSERT_NOT_NULL(red);
+    TEST_ASSERT_EQUAL(25 * 4, red->x);
+    TEST_ASSERT_EQUAL(31 * 4, red->width);
+    TEST_ASSERT_TRUE(red->fill > SIGN_MIN_FILL && red->fill < 0.5f);
+    const SignRegion* blue = regionOf(candidates, SIGN_COLOUR_BLUE);
+    TEST_ASSERT_NOT_NULL(blue);
+    TEST_ASSERT_EQUAL(90 * 4, blue->x);
+    TEST_ASSERT_EQUAL(20 * 4, blue->y);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0f, blue->fill);
+    TEST_ASSERT_NOT_NULL(regionOf(candidates, SIGN_COLOUR_YELLOW));
+}
+
+void test_blobs_of_the_wrong_shape_are_dropped() {
+    Planes planes;
+    planes.rect(0, 0, PLANE_WIDTH, 60, 200, 20, 30);  // Red wall, half the frame
+    planes.rect(10, 80, 100, 86, 20, 70, 200);        // Blue stripe, 15:1
+    planes.rect(130, 90, 133, 93, 240, 200, 20);      // Yellow speck
+    planes.ring(130, 100, 12, 11, 20, 70, 200);       // Thin ring, mostly hole
+    SignCandidates candidates;
+    TEST_ASSERT_TRUE(planes.detect(&candidates));
+    TEST_ASSERT_EQUAL(0, candidates.count);
+}
+
+void test_detect_finds_the_scene_colours() {
+    SignCandidates candidates;
+    TEST_ASSERT_TRUE(signPrefilter.detect(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &candidates));
+    TEST_ASSERT_EQUAL(160, candidates.sourceWidth);
+    const SignRegion* red = regionAt(candidates, 45, 60);
+    TEST_ASSERT_NOT_NULL(red);
+    TEST_ASSERT_EQUAL(SIGN_COLOUR_RED, red->colour);
+    // The red rectangle at (20,30)-(70,90), within a chroma sample
+    TEST_ASSERT_INT_WITHIN(2, 20, red->x);
+    TEST_ASSERT_INT_WITHIN(2, 30, red->y);
+    TEST_ASSERT_INT_WITHIN(4, 50, red->width);
+    TEST_ASSERT_INT_WITHIN(4, 60, red->height);
+    // The blue disc centred at (120,45)
+    const SignRegion* blue = regionAt(candidates, 120, 45);
+    TEST_ASSERT_NOT_NULL(blue);
+    TEST_ASSERT_EQUAL(SIGN_COLOUR_BLUE, blue->colour);
+    TEST_ASSERT_INT_WITHIN(4, 120, blue->x + blue->width / 2);
+    TEST_ASSERT_INT_WITHIN(4, 45, blue->y + blue->height / 2);
+    // Nothing on the white panel with its black bars
+    TEST_ASSERT_NULL(regionAt(candidates, 120, 97));
+    TEST_ASSERT_EQUAL(1, signPrefilter.getStats().signFrames);
+
+    uint8_t* crop = nullptr;
+    size_t cropSize = 0;
+    TEST_ASSERT_TRUE(signPrefilter.cropToRegions(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, candidates, &crop, &cropSize));
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(crop, cropSize, &info));
+    TEST_ASSERT_LESS_OR_EQUAL(160, info.width);
+    TEST_ASSERT_GREATER_OR_EQUAL(red->height, info.height);
+    free(crop);
+}
+
+void test_grey_frame_has_no_candidates() {
+    Planes planes;
+    SignCandidates candidates;
+    TEST_ASSERT_TRUE(planes.detect(&candidates));
+    TEST_ASSERT_EQUAL(0, candidates.count);
+    uint8_t* crop = nullptr;
+    size_t cropSize = 0;
+    TEST_ASSERT_FALSE(signPrefilter.cropToRegions(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, candidates, &crop, &cropSize));
+}
+
+// ===================
+// Benchmarks: classifier and prefilter time at QVGA, recall on generated scenes
+// ===================
+
+// Encoder in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize);
+
+static double millisSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void report(const char* format, ...) {
+    char line[200];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    TEST_MESSAGE(line);
+}
+
+// Prints ms per QVGA frame for the packed and scalar classifiers and the whole
+// prefilter, on random pixels; timings are not asserted
+void test_benchmark_qvga_frame_time() {
+    const int width = 320, height = 240, runs = 200;
+    std::mt19937 rng(3);
+    std::vector<uint8_t> y(width * height), cb(width * height), cr(width * height), classes(width);
+    for (int i = 0; i < width * height; i++) {
+        y[i] = rng();
+        cb[i] = rng();
+        cr[i] = rng();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++) {
+        for (int row = 0; row < height; row++) {
+            SignPrefilter::classifyRow(&y[row * width], &cb[row * width], &cr[row * width], classes.data(), width);
+        }
+    }
+    double packed = millisSince(start) / runs;
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++) {
+        for (int row = 0; row < height; row++) {
+            SignPrefilter::classifyRowScalar(&y[row * width], &cb[row * width], &cr[row * width], classes.data(), width);
+        }
+    }
+    double scalar = millisSince(start) / runs;
+
+    SignCandidates candidates;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; r++) {
+        TEST_ASSERT_TRUE(signPrefilter.detectPlanes(y.data(), cb.data(), cr.data(), width, height, width, 1, &candidates));
+    }
+    double prefilter = millisSince(start) / runs;
+
+    report("QVGA classify: packed %.3f ms, scalar %.3f ms; prefilter with blobs %.3f ms", packed, scalar, prefilter);
+}
+
+static const int SIGN_SCENE_WIDTH = 1280;
+static const int SIGN_SCENE_HEIGHT = 1024;
+
+struct SignTruth {
+    int x0, y0, x1, y1;
+};
+
+// Street scene in RGB: sky, brick wall, pavement and people, with sign-coloured
+// shapes on top. Brick, skin and sky are the colours a prefilter is most likely
+// to confuse with red, yellow and blue signs.
+class SignScene {
+public:
+    std::vector<uint8_t> rgb;
+    std::vector<SignTruth> signs;
+    std::mt19937 rng;
+
+    int wall;                 // 0 brick, 1 render, 2 glass
+    bool people;
+
+    explicit SignScene(unsigned seed) : rgb(SIGN_SCENE_WIDTH * SIGN_SCENE_HEIGHT * 3), rng(seed) {
+        int skyline = random(SIGN_SCENE_HEIGHT / 5, SIGN_SCENE_HEIGHT / 3);
+        int pavement = random(SIGN_SCENE_HEIGHT * 2 / 3, SIGN_SCENE_HEIGHT * 4 / 5);
+        int course = random(16, 30);
+        wall = random(0, 2);
+        for (int y = 0; y < SIGN_SCENE_HEIGHT; y++) {
+            for (int x = 0; x < SIGN_SCENE_WIDTH; x++) {
+                int noise = (int)(rng() % 11) - 5;
+                if (y < skyline) {
+                    set(x, y, 135 + noise, 175 + noise, 225 + noise);            // Pale sky
+                } else if (y >= pavement) {
+                    set(x, y, 120 + noise, 118 + noise, 112 + noise);
+                } else if (wall == 0) {
+                    int row = (y - skyline) / course, shifted = x + (row % 2) * course;
+                    bool mortar = (y - skyline) % course < 3 || shifted % (2 * course) < 3;
+                    if (mortar) set(x, y, 190 + noise, 185 + noise, 175 + noise);
+                    else set(x, y, 150 + noise + (shifted / (2 * course) * 17) % 30, 75 + noise, 55 + noise);
+                } else if (wall == 1) {
+                    set(x, y, 200 + noise, 190 + noise, 165 + noise);            // Sandstone render
+                } else {
+                    bool frame = x % 160 < 10 || (y - skyline) % 120 < 10;
+                    if (frame) set(x, y, 60 + noise, 62 + noise, 66 + noise);
+                    else set(x, y, 95 + noise + y % 40, 120 + noise + y % 40, 140 + noise + y % 40);   // Sky reflected in glass
+                }
+            }
+        }
+        // People: skin-toned faces and arms
+        int count = random(0, 3);
+        people = count > 0;
+        for (int p = 0; p < count; p++) {
+            int cx = random(100, SIGN_SCENE_WIDTH - 100), cy = random(pavement - 300, pavement - 100);
+            int tone = random(0, 2);
+            const int skin[3][3] = { { 224, 172, 140 }, { 198, 134, 98 }, { 141, 85, 60 } };
+            ellipse(cx, cy, 28, 36, skin[tone][0], skin[tone][1], skin[tone][2]);
+            rect(cx - 40, cy + 40, cx + 40, cy + 200, 50, 50, 60);
+            rect(cx - 60, cy + 60, cx - 40, cy + 150, skin[tone][0], skin[tone][1], skin[tone][2]);
+        }
+    }
+
+    int random(int low, int high) { return low + (int)(rng() % (high - low + 1)); }
+
+    void set(int x, int y, int r, int g, int b) {
+        if (x < 0 || y < 0 || x >= SIGN_SCENE_WIDTH || y >= SIGN_SCENE_HEIGHT) return;
+        uint8_t* p = rgb.data() + (y * SIGN_SCENE_WIDTH + x) * 3;
+        p[0] = constrain(r, 0, 255);
+        p[1] = constrain(g, 0, 255);
+        p[2] = constrain(b, 0, 255);
+    }
+
+    void rect(int x0, int y0, int x1, int y1, int r, int g, int b) {
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) set(x, y, r, g, b);
+        }
+    }
+
+    void ellipse(int cx, int cy, int rx, int ry, int r, int g, int b) {
+        for (int y = -ry; y <= ry; y++) {
+            for (int x = -rx; x <= rx; x++) {
+                if (x * x * ry * ry + y * y * rx * rx <= rx * rx * ry * ry) set(cx + x, cy + y, r, g, b);
+            }
+        }
+    }
+
+    // Red prohibition ring, red octagon-like stop disc, yellow warning diamond,
+    // blue mandatory disc or blue information panel, `size` px across, lit by `light`
+    void sign(int cx, int cy, int size, float light) {
+        auto lit = [light](int v) { return (int)(v * light); };
+        int half = size / 2;
+        switch (random(0, 4)) {
+            case 0:
+                ellipse(cx, cy, half, half, lit(200), lit(25), lit(35));
+                ellipse(cx, cy, half * 7 / 10, half * 7 / 10, lit(235), lit(235), lit(235));
+                break;
+            case 1:
+                ellipse(cx, cy, half, half, lit(195), lit(20), lit(30));
+                rect(cx - half / 2, cy - half / 8, cx + half / 2, cy + half / 8, lit(240), lit(240), lit(240));
+                break;
+            case 2:
+                for (int y = -half; y <= half; y++) {
+                    for (int x = -half; x <= half; x++) {
+                        int d = abs(x) + abs(y);
+                        if (d <= half) set(cx + x, cy + y, d > half * 8 / 10 ? 20 : lit(240), d > half * 8 / 10 ? 20 : lit(200), 20);
+                    }
+                }
+                break;
+            case 3:
+                ellipse(cx, cy, half, half, lit(20), lit(70), lit(200));
+                break;
+            default:
+                rect(cx - half, cy - half * 2 / 3, cx + half, cy + half * 2 / 3, lit(20), lit(60), lit(170));
+                break;
+        }
+        signs.push_back({ cx - half, cy - half, cx + half + 1, cy + half + 1 });
+    }
+};
+
+// Prints signs inside the uploaded crop, sign-free frames skipped, crop bytes
+// and SXGA detection time over 60 scenes with 1-3 signs and 30 without
+void test_benchmark_scene_recall() {
+    const int withSigns = 60, withoutSigns = 30;
+    const char* WALLS[3] = { "brick", "render", "glass" };
+    int signs = 0, signsInCrop = 0, signFrames = 0, skipped = 0, cropped = 0;
+    int wallFrames[3] = { 0, 0, 0 }, wallSkipped[3] = { 0, 0, 0 }, peopleFrames = 0, peopleSkipped = 0;
+    double cropRatio = 0, detectMillis = 0;
+
+    for (int i = 0; i < withSigns + withoutSigns; i++) {
+        SignScene scene(900 + i);
+        if (i < withSigns) {
+            int count = scene.random(1, 3);
+            for (int s = 0; s < count; s++) {
+                int size = scene.random(24, 160);
+                scene.sign(scene.random(size, SIGN_SCENE_WIDTH - size), scene.random(size, SIGN_SCENE_HEIGHT - size),
+                           size, scene.random(60, 100) / 100.0f);
+            }
+        }
+
+        uint8_t* jpeg = nullptr;
+        size_t jpegSize = 0;
+        TEST_ASSERT_TRUE(libjpegEncodeRgb(scene.rgb.data(), SIGN_SCENE_WIDTH, SIGN_SCENE_HEIGHT, 80, &jpeg, &jpegSize));
+        SignCandidates candidates;
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(signPrefilter.detect(jpeg, jpegSize, &candidates));
+        detectMillis += millisSince(start);
+
+        if (i >= withSigns) {
+            skipped += candidates.count == 0;
+            wallFrames[scene.wall]++;
+            wallSkipped[scene.wall] += candidates.count == 0;
+            if (scene.wall != 0 && scene.people) {
+                peopleFrames++;
+                peopleSkipped += candidates.count == 0;
+            }
+        } else {
+            signs += scene.signs.size();
+            signFrames += candidates.count > 0;
+        }
+        if (i < withSigns && candidates.count > 0) {
+            uint8_t* crop = nullptr;
+            size_t cropSize = 0;
+            TEST_ASSERT_TRUE(signPrefilter.cropToRegions(jpeg, jpegSize, candidates, &crop, &cropSize));
+            cropRatio += (double)cropSize / jpegSize;
+            cropped++;
+            free(crop);
+
+            // The crop rectangle as cropToRegions() builds it
+            int minX = SIGN_SCENE_WIDTH, minY = SIGN_SCENE_HEIGHT, maxX = 0, maxY = 0;
+            for (int r = 0; r < candidates.count; r++) {
+                const SignRegion& region = candidates.regions[r];
+                minX = min(minX, (int)region.x);
+                minY = min(minY, (int)region.y);
+                maxX = max(maxX, region.x + region.width);
+                maxY = max(maxY, region.y + region.height);
+            }
+            JpegCropRect wanted = { (uint16_t)max(0, minX - SIGN_CROP_MARGIN), (uint16_t)max(0, minY - SIGN_CROP_MARGIN), 0, 0 };
+            wanted.width = min(SIGN_SCENE_WIDTH, maxX + SIGN_CROP_MARGIN) - wanted.x;
+            wanted.height = min(SIGN_SCENE_HEIGHT, maxY + SIGN_CROP_MARGIN) - wanted.y;
+            JpegCropRect aligned;
+            TEST_ASSERT_TRUE(jpegTranscoder.alignCropRect(jpeg, jpegSize, wanted, &aligned));
+            for (const SignTruth& sign : scene.signs) {
+                signsInCrop += sign.x0 >= aligned.x && sign.y0 >= aligned.y &&
+                               sign.x1 <= aligned.x + aligned.width && sign.y1 <= aligned.y + aligned.height;
+            }
+        }
+        free(jpeg);
+    }
+
+    report("%d scenes: signs inside the crop %d/%d (frames with candidates %d/%d), sign-free skipped %d/%d",
+           withSigns + withoutSigns, signsInCrop, signs, signFrames, withSigns, skipped, withoutSigns);
+    report("sign-free skipped by wall: %s %d/%d, %s %d/%d, %s %d/%d; with people, no brick %d/%d",
+           WALLS[0], wallSkipped[0], wallFrames[0], WALLS[1], wallSkipped[1], wallFrames[1],
+           WALLS[2], wallSkipped[2], wallFrames[2], peopleSkipped, peopleFrames);
+    report("crops %.0f%% of the frame bytes; SXGA detect with decode %.1f ms/frame",
+           cropped ? 100 * cropRatio / cropped : 0.0, detectMillis / (withSigns + withoutSigns));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_packed_classification_matches_scalar_for_every_colour);
+    RUN_TEST(test_sign_colours_are_classified);
+    RUN_TEST(test_sign_shaped_blobs_become_regions);
+    RUN_TEST(test_blobs_of_the_wrong_shape_are_dropped);
+    RUN_TEST(test_detect_finds_the_scene_colours);
+    RUN_TEST(test_grey_frame_has_no_candidates);
+    RUN_TEST(test_benchmark_qvga_frame_time);
+    RUN_TEST(test_benchmark_scene_recall);
+    return UNITY_END();
+}
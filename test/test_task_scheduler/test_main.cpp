@@ -0,0 +1,127 @@
+#include <unity.h>
+#include <vector>
+#include "task_scheduler.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+static const int THUMB_WIDTH = 80;
+static const int THUMB_HEIGHT = 60;
+
+static void fillScene(uint8_t* gray, int base) {
+    for (int i = 0; i < THUMB_WIDTH * THUMB_HEIGHT; i++) gray[i] = base + (i * 37) % 60;
+}
+
+// Runs one frame, each task taking `latency` ms; returns the tasks in run order
+static std::vector<int> runFrame(TaskScheduler& scheduler, unsigned long now, bool caption, bool sign, bool ocr,
+                                 unsigned long latency) {
+    scheduler.beginFrame(now);
+    scheduler.setTriggered(MODE_VISUAL_CAPTION, caption);
+    scheduler.setTriggered(MODE_SIGN_DETECTION, sign);
+    scheduler.setTriggered(MODE_OCR, ocr);
+    std::vector<int> ran;
+    int task;
+    while ((task = scheduler.nextTask()) >= 0) {
+        ran.push_back(task);
+        scheduler.recordRun(task, latency, true);
+    }
+    return ran;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_hazard_runs_first_and_alone_when_nothing_triggers() {
+    TaskScheduler scheduler;
+    std::vector<int> ran = runFrame(scheduler, 1000, false, false, false, 1500);
+    TEST_ASSERT_EQUAL(1, ran.size());
+    TEST_ASSERT_EQUAL(MODE_HAZARD_DETECTION, ran[0]);
+    TEST_ASSERT_EQUAL(1, scheduler.getTaskStats(MODE_OCR).idle);
+}
+
+void test_triggered_tasks_share_the_budget_without_starving() {
+    TaskScheduler scheduler;
+    int signRuns = 0, ocrRuns = 0;
+    for (int frame = 0; frame < 20; frame++) {
+        std::vector<int> ran = runFrame(scheduler, 1000 + frame * 5000, false, true, true, 1500);
+        TEST_ASSERT_EQUAL(MODE_HAZARD_DETECTION, ran[0]);
+        // Hazard plus at most what fits in SCHED_FRAME_BUDGET after the first optional task
+        TEST_ASSERT_LESS_OR_EQUAL(1 + SCHED_FRAME_BUDGET / 1500, ran.size());
+        for (int task : ran) {
+            if (task == MODE_SIGN_DETECTION) signRuns++;
+            if (task == MODE_OCR) ocrRuns++;
+        }
+    }
+    TEST_ASSERT_GREATER_OR_EQUAL(8, signRuns);
+    TEST_ASSERT_GREATER_OR_EQUAL(8, ocrRuns);
+    TEST_ASSERT_INT_WITHIN(2, signRuns, ocrRuns);
+}
+
+void test_caption_waits_for_its_interval() {
+    TaskScheduler scheduler;
+    std::vector<int> ran = runFrame(scheduler, 1000, true, false, false, 1500);
+    TEST_ASSERT_EQUAL(2, ran.size());
+    TEST_ASSERT_EQUAL(MODE_VISUAL_CAPTION, ran[1]);
+
+    ran = runFrame(scheduler, 1000 + SCHED_CAPTION_INTERVAL / 2, true, false, false, 1500);
+    TEST_ASSERT_EQUAL(1, ran.size());
+    TEST_ASSERT_EQUAL(1, scheduler.getTaskStats(MODE_VISUAL_CAPTION).tooSoon);
+
+    // A user request does not wait
+    scheduler.request(MODE_VISUAL_CAPTION);
+    ran = runFrame(scheduler, 2000 + SCHED_CAPTION_INTERVAL / 2, false, false, false, 1500);
+    TEST_ASSERT_EQUAL(2, ran.size());
+    TEST_ASSERT_EQUAL(MODE_VISUAL_CAPTION, ran[1]);
+}
+
+void test_scene_change_compares_with_the_captioned_frame() {
+    TaskScheduler scheduler;
+    uint8_t scene[THUMB_WIDTH * THUMB_HEIGHT];
+    fillScene(scene, 100);
+
+    // Nothing captioned yet
+    scheduler.beginFrame(1000);
+    TEST_ASSERT_TRUE(scheduler.sceneChangedLuma(scene, THUMB_WIDTH, THUMB_HEIGHT, THUMB_WIDTH));
+    scheduler.setTriggered(MODE_VISUAL_CAPTION, true);
+    int task;
+    while ((task = scheduler.nextTask()) >= 0) scheduler.recordRun(task, 1500, true);
+    TEST_ASSERT_EQUAL(1, scheduler.getTaskStats(MODE_VISUAL_CAPTION).runs);
+
+    // Same scene with sensor noise
+    uint8_t noisy[THUMB_WIDTH * THUMB_HEIGHT];
+    for (int i = 0; i < THUMB_WIDTH * THUMB_HEIGHT; i++) noisy[i] = scene[i] + (i % 7) - 3;
+    scheduler.beginFrame(30000);
+    TEST_ASSERT_FALSE(scheduler.sceneChangedLuma(noisy, THUMB_WIDTH, THUMB_HEIGHT, THUMB_WIDTH));
+
+    // Turned towards a brighter wall
+    fillScene(scene, 100 + SCHED_SCENE_CHANGE + 10);
+    scheduler.beginFrame(60000);
+    TEST_ASSERT_TRUE(scheduler.sceneChangedLuma(scene, THUMB_WIDTH, THUMB_HEIGHT, THUMB_WIDTH));
+}
+
+void test_scene_change_on_a_jpeg_thumbnail() {
+    // The auto-mode path: the pyramid thumbnail decoded at 1/4
+    TaskScheduler scheduler;
+    scheduler.beginFrame(1000);
+    TEST_ASSERT_TRUE(scheduler.sceneChanged(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_QUARTER));
+    scheduler.setTriggered(MODE_VISUAL_CAPTION, true);
+    int task;
+    while ((task = scheduler.nextTask()) >= 0) scheduler.recordRun(task, 1500, true);
+
+    scheduler.beginFrame(30000);
+    TEST_ASSERT_FALSE(scheduler.sceneChanged(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, JPEG_SCALE_QUARTER));
+
+    // An undecodable frame counts as a change rather than hiding one
+    scheduler.beginFrame(60000);
+    TEST_ASSERT_TRUE(scheduler.sceneChanged(TEST_SCENE_JPEG, 100, JPEG_SCALE_QUARTER));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_hazard_runs_first_and_alone_when_nothing_triggers);
+    RUN_TEST(test_triggered_tasks_share_the_budget_without_starving);
+    RUN_TEST(test_caption_waits_for_its_interval);
+    RUN_TEST(test_scene_change_compares_with_the_captioned_frame);
+    RUN_TEST(test_scene_change_on_a_jpeg_thumbnail);
+    return UNITY_END();
+}
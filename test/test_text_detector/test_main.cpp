@@ -0,0 +1,339 @@
+#include <unity.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "text_detector.cpp"
+#include "jpeg_transcoder.cpp"
+#include "host_runtime.h"
+#include "test_images.h"
+
+static const int PLANE_WIDTH = 320;
+static const int PLANE_HEIGHT = 240;
+
+// Wall with vertical posts (fence) or horizontal slats (blinds) of one width
+static std::vector<uint8_t> renderPattern(bool vertical, int period, int width) {
+    std::vector<uint8_t> gray(PLANE_WIDTH * PLANE_HEIGHT);
+    for (int y = 0; y < PLANE_HEIGHT; y++) {
+        for (int x = 0; x < PLANE_WIDTH; x++) {
+            int position = vertical ? x : y;
+            gray[y * PLANE_WIDTH + x] = position % period < width ? 50 : 180;
+        }
+    }
+    return gray;
+}
+
+static bool overlaps(const TextBox& box, int x0, int y0, int x1, int y1) {
+    return box.x < x1 && box.x + box.width > x0 && box.y < y1 && box.y + box.height > y0;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_finds_the_sign_and_not_the_fence() {
+    TextDetection detection;
+    TEST_ASSERT_TRUE(textDetector.detect(TEST_TEXT_JPEG, TEST_TEXT_JPEG_LENGTH, &detection));
+    TEST_ASSERT_TRUE(detection.hasText);
+    TEST_ASSERT_EQUAL(256, detection.sourceWidth);
+    TEST_ASSERT_EQUAL(160, detection.sourceHeight);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, detection.boxCount);
+    for (int i = 0; i < detection.boxCount; i++) {
+        const TextBox& box = detection.boxes[i];
+        // Within the sign, give or take a cell
+        TEST_ASSERT_GREATER_OR_EQUAL(100 - 8, box.x);
+        TEST_ASSERT_GREATER_OR_EQUAL(40 - 8, box.y);
+        TEST_ASSERT_LESS_OR_EQUAL(256, box.x + box.width);
+        TEST_ASSERT_LESS_OR_EQUAL(112 + 8, box.y + box.height);
+        TEST_ASSERT_FALSE(overlaps(box, 8, 20, 62, 150));
+    }
+    TEST_ASSERT_TRUE(overlaps(detection.boxes[0], 108, 46, 230, 70));
+    TEST_ASSERT_TRUE(detection.score > 0.5f);
+
+    TextDetectorStats stats = textDetector.getStats();
+    TEST_ASSERT_EQUAL(1, stats.frames);
+    TEST_ASSERT_EQUAL(1, stats.textFrames);
+}
+
+void test_shapes_and_bars_are_not_text() {
+    TextDetection detection;
+    TEST_ASSERT_TRUE(textDetector.detect(TEST_SCENE_JPEG, TEST_SCENE_JPEG_LENGTH, &detection));
+    TEST_ASSERT_FALSE(detection.hasText);
+    TEST_ASSERT_EQUAL(0, detection.boxCount);
+    TEST_ASSERT_EQUAL(0.0f, detection.score);
+}
+
+void test_regular_patterns_are_not_text() {
+    const int periods[] = { 6, 9, 14, 24 };
+    for (int period : periods) {
+        for (bool vertical : { true, false }) {
+            std::vector<uint8_t> gray = renderPattern(vertical, period, period / 3);
+            TextDetection detection;
+            TEST_ASSERT_TRUE(textDetector.detectLuma(gray.data(), PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH, 1, &detection));
+            TEST_ASSERT_FALSE(detection.hasText);
+        }
+    }
+
+    std::vector<uint8_t> flat(PLANE_WIDTH * PLANE_HEIGHT, 128);
+    TextDetection detection;
+    TEST_ASSERT_TRUE(textDetector.detectLuma(flat.data(), PLANE_WIDTH, PLANE_HEIGHT, PLANE_WIDTH, 2, &detection));
+    TEST_ASSERT_FALSE(detection.hasText);
+    TEST_ASSERT_EQUAL(2 * PLANE_WIDTH, detection.sourceWidth);
+}
+
+void test_crop_covers_the_text_with_a_margin() {
+    TextDetection detection;
+    TEST_ASSERT_TRUE(textDetector.detect(TEST_TEXT_JPEG, TEST_TEXT_JPEG_LENGTH, &detection));
+    uint8_t* crop = nullptr;
+    size_t cropSize = 0;
+    TEST_ASSERT_TRUE(textDetector.cropToText(TEST_TEXT_JPEG, TEST_TEXT_JPEG_LENGTH, detection, &crop, &cropSize));
+    TEST_ASSERT_LESS_THAN(TEST_TEXT_JPEG_LENGTH, cropSize);
+
+    const TextBox& box = detection.boxes[0];
+    JpegCropRect wanted = { (uint16_t)max(0, box.x - TEXT_CROP_MARGIN), (uint16_t)max(0, box.y - TEXT_CROP_MARGIN), 0, 0 };
+    wanted.width = min(256, box.x + box.width + TEXT_CROP_MARGIN) - wanted.x;
+    wanted.height = min(160, box.y + box.height + TEXT_CROP_MARGIN) - wanted.y;
+    JpegCropRect aligned;
+    TEST_ASSERT_TRUE(jpegTranscoder.alignCropRect(TEST_TEXT_JPEG, TEST_TEXT_JPEG_LENGTH, wanted, &aligned));
+    JpegInfo info;
+    TEST_ASSERT_TRUE(jpegTranscoder.getInfo(crop, cropSize, &info));
+    TEST_ASSERT_EQUAL(aligned.width, info.width);
+    TEST_ASSERT_EQUAL(aligned.height, info.height);
+    free(crop);
+
+    detection.boxCount = 0;
+    TEST_ASSERT_FALSE(textDetector.cropToText(TEST_TEXT_JPEG, TEST_TEXT_JPEG_LENGTH, detection, &crop, &cropSize));
+}
+
+void test_upload_accounting() {
+    textDetector.recordSkippedUpload();
+    textDetector.recordUpload(40000, 9000);
+    textDetector.recordUpload(30000, 30000);
+    TextDetectorStats stats = textDetector.getStats();
+    TEST_ASSERT_EQUAL(1, stats.uploadsSkipped);
+    TEST_ASSERT_EQUAL(70000, stats.bytesFull);
+    TEST_ASSERT_EQUAL(39000, stats.bytesSent);
+}
+
+// ===================
+// Benchmark: recall and skipped uploads on generated scenes
+// ===================
+
+// Encoder in libjpeg_reference.cpp, kept apart from the Arduino headers
+bool libjpegEncodeRgb(const uint8_t* rgb, int width, int height, int quality, uint8_t** output, size_t* outputSize);
+
+static const int SCENE_WIDTH = 1280;
+static const int SCENE_HEIGHT = 1024;
+
+struct SceneRect {
+    int x0, y0, x1, y1;
+};
+
+class Scene {
+public:
+    std::vector<uint8_t> rgb;
+    std::vector<SceneRect> text;      // Bounds of each block of text
+    std::mt19937 rng;
+
+    explicit Scene(unsigned seed) : rgb(SCENE_WIDTH * SCENE_HEIGHT * 3), rng(seed) {
+        // Wall or sky with a vertical gradient and noise
+        int base = 90 + rng() % 100;
+        for (int y = 0; y < SCENE_HEIGHT; y++) {
+            for (int x = 0; x < SCENE_WIDTH; x++) {
+                int v = base + 40 * y / SCENE_HEIGHT + (int)(rng() % 9) - 4;
+                set(x, y, v, v + 5, v - 5);
+            }
+        }
+    }
+
+    int random(int low, int high) { return low + (int)(rng() % (high - low + 1)); }
+
+    void set(int x, int y, int r, int g, int b) {
+        if (x < 0 || y < 0 || x >= SCENE_WIDTH || y >= SCENE_HEIGHT) return;
+        uint8_t* p = rgb.data() + (y * SCENE_WIDTH + x) * 3;
+        p[0] = constrain(r, 0, 255);
+        p[1] = constrain(g, 0, 255);
+        p[2] = constrain(b, 0, 255);
+    }
+
+    void fill(int x0, int y0, int x1, int y1, int r, int g, int b) {
+        for (int y = y0; y < y1; y++) {
+            for (int x = x0; x < x1; x++) set(x, y, r, g, b);
+        }
+    }
+
+    // Posts or slats of one width at a fixed period over a region
+    void stripes(const SceneRect& area, bool vertical, int period, int width) {
+        for (int y = area.y0; y < area.y1; y++) {
+            for (int x = area.x0; x < area.x1; x++) {
+                int position = vertical ? x - area.x0 : y - area.y0;
+                int v = position % period < width ? 60 : 170;
+                set(x, y, v + 10, v, v - 10);
+            }
+        }
+    }
+
+    void brick(const SceneRect& area, int rowHeight) {
+        for (int y = area.y0; y < area.y1; y++) {
+            int row = (y - area.y0) / rowHeight;
+            for (int x = area.x0; x < area.x1; x++) {
+                int shifted = x - area.x0 + (row % 2) * rowHeight;
+                bool mortar = (y - area.y0) % rowHeight < 3 || shifted % (2 * rowHeight) < 3;
+                if (mortar) set(x, y, 200, 195, 185);
+                else set(x, y, 150 + (row * 7 + shifted / (2 * rowHeight) * 13) % 30, 70, 50);
+            }
+        }
+    }
+
+    void windows(const SceneRect& area, int pitch) {
+        fill(area.x0, area.y0, area.x1, area.y1, 190, 185, 175);
+        for (int y = area.y0 + pitch / 5; y + pitch * 3 / 5 < area.y1; y += pitch) {
+            for (int x = area.x0 + pitch / 5; x + pitch * 3 / 5 < area.x1; x += pitch) {
+                fill(x, y, x + pitch * 3 / 5, y + pitch * 3 / 5, 45, 60, 80);
+            }
+        }
+    }
+
+    // Leaves: overlapping blobs of light and dark green, 3-15 px
+    void foliage(const SceneRect& area) {
+        int blobs = (area.x1 - area.x0) * (area.y1 - area.y0) / 60;
+        for (int i = 0; i < blobs; i++) {
+            int cx = random(area.x0, area.x1 - 1), cy = random(area.y0, area.y1 - 1);
+            int rx = random(2, 8), ry = random(2, 8), shade = random(30, 150);
+            for (int y = -ry; y <= ry; y++) {
+                for (int x = -rx; x <= rx; x++) {
+                    if (x * x * ry * ry + y * y * rx * rx > rx * rx * ry * ry) continue;
+                    if (cx + x < area.x0 || cx + x >= area.x1 || cy + y < area.y0 || cy + y >= area.y1) continue;
+                    set(cx + x, cy + y, shade / 2, shade, shade / 3);
+                }
+            }
+        }
+    }
+
+    // Draws a fence, blinds, brick, window grid or foliage and returns which (0-4)
+    int texture(const SceneRect& area) {
+        int kind = random(0, 4);
+        switch (kind) {
+            case 0: { int period = random(12, 40); stripes(area, true, period, period / 3); break; }
+            case 1: { int period = random(10, 30); stripes(area, false, period, period / 3); break; }
+            case 2: brick(area, random(16, 36)); break;
+            case 3: windows(area, random(40, 90)); break;
+            default: foliage(area); break;
+        }
+        return kind;
+    }
+
+    // A sign panel with lines of glyphs `height` px high, built from letter-like strokes
+    void sign(int x0, int y0, int height) {
+        int stroke = max(2, height / 7), glyphWidth = height * 3 / 5, gap = max(2, height / 5);
+        int glyphs = random(3, 8), lines = random(1, 3);
+        int width = glyphs * (glyphWidth + gap) - gap, blockHeight = lines * height + (lines - 1) * gap;
+        x0 = min(x0, SCENE_WIDTH - width - 2 * height);
+        y0 = min(y0, SCENE_HEIGHT - blockHeight - 2 * height);
+        bool dark = random(0, 1);
+        int panel = dark ? 40 : 225, ink = dark ? 235 : 30;
+        fill(x0, y0, x0 + width + 2 * height, y0 + blockHeight + 2 * height, panel, panel, panel + (dark ? 30 : -20));
+        int tx = x0 + height, ty = y0 + height;
+        for (int line = 0; line < lines; line++) {
+            for (int g = 0; g < glyphs; g++) {
+                int gx = tx + g * (glyphWidth + gap), gy = ty + line * (height + gap);
+                // Two or three of: left, middle, right stems; top, middle, bottom bars
+                int parts = 0;
+                while (__builtin_popcount(parts) < 2 || !(parts & 7)) parts |= 1 << random(0, 5);
+                if (parts & 1) fill(gx, gy, gx + stroke, gy + height, ink, ink, ink);
+                if (parts & 2) fill(gx + (glyphWidth - stroke) / 2, gy, gx + (glyphWidth + stroke) / 2, gy + height, ink, ink, ink);
+                if (parts & 4) fill(gx + glyphWidth - stroke, gy, gx + glyphWidth, gy + height, ink, ink, ink);
+                if (parts & 8) fill(gx, gy, gx + glyphWidth, gy + stroke, ink, ink, ink);
+                if (parts & 16) fill(gx, gy + (height - stroke) / 2, gx + glyphWidth, gy + (height + stroke) / 2, ink, ink, ink);
+                if (parts & 32) fill(gx, gy + height - stroke, gx + glyphWidth, gy + height, ink, ink, ink);
+            }
+        }
+        text.push_back({ tx, ty, tx + width, ty + blockHeight });
+    }
+};
+
+// Prints frame recall, skipped text-free frames, text kept in the crop, crop
+// bytes and time per frame over 40 scenes with signs and 40 without; the
+// text-free half is all fences, blinds, brick, window grids and foliage
+void test_benchmark_scene_recall() {
+    const int perHalf = 40;
+    int found = 0, skipped = 0, regions = 0, regionsInCrop = 0, cropped = 0;
+    int falsePositives[5] = { 0 };
+    double cropRatio = 0, totalMicros = 0;
+
+    for (int i = 0; i < 2 * perHalf; i++) {
+        bool withText = i < perHalf;
+        Scene scene(500 + i);
+        SceneRect area = { scene.random(0, SCENE_WIDTH / 3), scene.random(0, SCENE_HEIGHT / 3), 0, 0 };
+        area.x1 = min(SCENE_WIDTH, area.x0 + scene.random(SCENE_WIDTH / 2, SCENE_WIDTH));
+        area.y1 = min(SCENE_HEIGHT, area.y0 + scene.random(SCENE_HEIGHT / 2, SCENE_HEIGHT));
+        int kind = scene.texture(area);
+        if (withText) {
+            int signs = scene.random(1, 2);
+            for (int s = 0; s < signs; s++) {
+                scene.sign(scene.random(0, SCENE_WIDTH * 2 / 3), scene.random(0, SCENE_HEIGHT * 2 / 3), scene.random(14, 80));
+            }
+        }
+
+        uint8_t* jpeg = nullptr;
+        size_t jpegSize = 0;
+        TEST_ASSERT_TRUE(libjpegEncodeRgb(scene.rgb.data(), SCENE_WIDTH, SCENE_HEIGHT, 80, &jpeg, &jpegSize));
+        TextDetection detection;
+        auto start = std::chrono::steady_clock::now();
+        TEST_ASSERT_TRUE(textDetector.detect(jpeg, jpegSize, &detection));
+        totalMicros += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        if (!withText) {
+            skipped += !detection.hasText;
+            falsePositives[kind] += detection.hasText;
+        } else if (detection.hasText) {
+            found++;
+            uint8_t* crop = nullptr;
+            size_t cropSize = 0;
+            TEST_ASSERT_TRUE(textDetector.cropToText(jpeg, jpegSize, detection, &crop, &cropSize));
+            cropRatio += (double)cropSize / jpegSize;
+            cropped++;
+            free(crop);
+
+            // The crop rectangle as cropToText() builds it
+            int minX = SCENE_WIDTH, minY = SCENE_HEIGHT, maxX = 0, maxY = 0;
+            for (int b = 0; b < detection.boxCount; b++) {
+                const TextBox& box = detection.boxes[b];
+                minX = min(minX, (int)box.x);
+                minY = min(minY, (int)box.y);
+                maxX = max(maxX, box.x + box.width);
+                maxY = max(maxY, box.y + box.height);
+            }
+            JpegCropRect wanted = { (uint16_t)max(0, minX - TEXT_CROP_MARGIN), (uint16_t)max(0, minY - TEXT_CROP_MARGIN), 0, 0 };
+            wanted.width = min(SCENE_WIDTH, maxX + TEXT_CROP_MARGIN) - wanted.x;
+            wanted.height = min(SCENE_HEIGHT, maxY + TEXT_CROP_MARGIN) - wanted.y;
+            JpegCropRect aligned;
+            TEST_ASSERT_TRUE(jpegTranscoder.alignCropRect(jpeg, jpegSize, wanted, &aligned));
+            for (const SceneRect& text : scene.text) {
+                regionsInCrop += text.x0 >= aligned.x && text.y0 >= aligned.y &&
+                                 text.x1 <= aligned.x + aligned.width && text.y1 <= aligned.y + aligned.height;
+            }
+        }
+        if (withText) regions += scene.text.size();
+        free(jpeg);
+    }
+
+    char line[200];
+    snprintf(line, sizeof(line), "%d scenes: text frames found %d/%d, text-free skipped %d/%d, "
+             "text regions inside the uploaded crop %d/%d, crops %.0f%% of the frame bytes, %.1f ms/frame",
+             2 * perHalf, found, perHalf, skipped, perHalf, regionsInCrop, regions,
+             cropped ? 100 * cropRatio / cropped : 0.0, totalMicros / (2 * perHalf) / 1000);
+    TEST_MESSAGE(line);
+    snprintf(line, sizeof(line), "text-free frames taken for text: fence %d, blinds %d, brick %d, windows %d, foliage %d",
+             falsePositives[0], falsePositives[1], falsePositives[2], falsePositives[3], falsePositives[4]);
+    TEST_MESSAGE(line);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_finds_the_sign_and_not_the_fence);
+    RUN_TEST(test_shapes_and_bars_are_not_text);
+    RUN_TEST(test_regular_patterns_are_not_text);
+    RUN_TEST(test_crop_covers_the_text_with_a_margin);
+    RUN_TEST(test_upload_accounting);
+    RUN_TEST(test_benchmark_scene_recall);
+    return UNITY_END();
+}